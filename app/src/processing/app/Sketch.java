@@ -1374,50 +1374,30 @@ public class Sketch {
     // 1. concatenate all .pde files to the 'main' pde
     //    store line number for starting point of each code bit
 
-    StringBuffer bigCode = new StringBuffer();
+    ArrayList<String> pieces = new ArrayList<String>();
     int bigCount = 0;
     for (SketchCode sc : code) {
       if (sc.isExtension("ino") || sc.isExtension("pde")) {
         sc.setPreprocOffset(bigCount);
         String in = sc.getProgram();
         if(Base.getArch() == "cc3200emt" || Base.getArch() == "msp432" || Base.getArch() == "cc2600emt") {
-
-	        Pattern functionPattern  = Pattern.compile("\\s*void\\s+(loop)\\s*\\(\\s*(void)?\\s*\\)");
-	
-	//	    Pattern functionPattern  = Pattern.compile("\\s*void\\s+([a-zA-Z_]*[lL]oop\\w*)\\s*\\(\\s*(void)?\\s*\\)");
-	
-		    // Find all functions and generate prototypes for them
-		    ArrayList<String> loopMatches = new ArrayList<String>();
-		    ArrayList<String> setupMatches = new ArrayList<String>();
-		    	    
-		    Matcher functionMatcher = functionPattern.matcher(in);
-		    while (functionMatcher.find()) {
-		      loopMatches.add(functionMatcher.group(1));
-		    }
-	
-		    
-		    functionPattern  = Pattern.compile("\\s*void\\s+(setup)\\s*\\(\\s*(void)?\\s*\\)");
-	
-		    // Find all functions and generate prototypes for them
-		    functionMatcher = functionPattern.matcher(in);
-		    
-		    while (functionMatcher.find())
-		      setupMatches.add(functionMatcher.group(1));
-	        
+	    List<String> functions = SignatureScanner.scan(in).voidFunctions;
 	        
 	        // These #line directives help the compiler report errors with
 	        // correct the filename and line number (issue 281 & 907)
-		    bigCode.append("#line 1 \"" + sc.getFileName() + "\"\n");
-	        if(setupMatches.size() > 0 && loopMatches.size() > 0) {
+		    pieces.add("#line 1 \"" + sc.getFileName() + "\"\n");
+	        if(functions.contains("setup") && functions.contains("loop")) {
 	        	String sketchName = sc.getFileName().substring(0, sc.getFileName().length()-4);
-	        	bigCode.append("#undef setup\n#undef loop\n");
-	        	bigCode.append("#define setup setup" +  sketchName + "\n");
-	        	bigCode.append("#define loop loop" +  sketchName + "\n");
+	        	pieces.add("#undef setup\n#undef loop\n" +
+	        	           "#define setup setup" +  sketchName + "\n" +
+	        	           "#define loop loop" +  sketchName + "\n");
 	        }
         }
         
-        bigCode.append(sc.getProgram());
-        bigCode.append('\n');
+        // each tab a piece of its own, so that the preprocessor only
+        // scans the ones that have changed
+        pieces.add(in);
+        pieces.add("\n");
         bigCount += sc.getLineCount();
       }
     }
@@ -1427,7 +1407,7 @@ public class Sketch {
     int headerOffset = 0;
     //PdePreprocessor preprocessor = new PdePreprocessor();
     try {
-      headerOffset = preprocessor.writePrefix(bigCode.toString(),
+      headerOffset = preprocessor.writePrefix(pieces,
                                               buildPath,
                                               name,
                                               codeFolderPackages);
@@ -1756,57 +1736,6 @@ public class Sketch {
   	return tempBuildFolder.getAbsoluteFile();
   }
   
-  /**
-   * Replace all commented portions of a given String as spaces.
-   * Utility function used here and in the preprocessor.
-   */
-  static public String scrubComments(String what) {
-    char p[] = what.toCharArray();
-
-    int index = 0;
-    while (index < p.length) {
-      // for any double slash comments, ignore until the end of the line
-      if ((p[index] == '/') &&
-          (index < p.length - 1) &&
-          (p[index+1] == '/')) {
-        p[index++] = ' ';
-        p[index++] = ' ';
-        while ((index < p.length) &&
-               (p[index] != '\n')) {
-          p[index++] = ' ';
-        }
-
-        // check to see if this is the start of a new multiline comment.
-        // if it is, then make sure it's actually terminated somewhere.
-      } else if ((p[index] == '/') &&
-                 (index < p.length - 1) &&
-                 (p[index+1] == '*')) {
-        p[index++] = ' ';
-        p[index++] = ' ';
-        boolean endOfRainbow = false;
-        while (index < p.length - 1) {
-          if ((p[index] == '*') && (p[index+1] == '/')) {
-            p[index++] = ' ';
-            p[index++] = ' ';
-            endOfRainbow = true;
-            break;
-
-          } else {
-            // continue blanking this area
-            p[index++] = ' ';
-          }
-        }
-        if (!endOfRainbow) {
-          throw new RuntimeException(_("Missing the */ from the end of a " +
-                                       "/* comment */"));
-        }
-      } else {  // any old character, move along
-        index++;
-      }
-    }
-    return new String(p);
-  }
-
 
   public boolean exportApplicationPrompt() throws IOException, RunnerException {
     return false;
@@ -0,0 +1,284 @@
+/* -*- mode: java; c-basic-offset: 2; indent-tabs-mode: nil -*- */
+
+/*
+  BuildCache - compiled cores and libraries shared between sketches
+  Part of the Energia project - http://energia.nu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+package processing.app.debug;
+
+import java.io.*;
+import java.security.*;
+import java.util.*;
+
+import processing.app.Base;
+
+
+/**
+ * Files built by the compiler, kept in a folder of their own named for
+ * a Key: a digest of everything that went into them, the compiler
+ * command lines, the board preferences and the contents of the sources
+ * and headers. Another sketch that builds the same core or library for
+ * the same board with the same flags gets the same key, and copies the
+ * files instead of compiling them again.
+ * <P>
+ * An entry's folder is touched whenever it is restored, and storing one
+ * removes the least recently restored past MAX_ENTRIES, so the cache
+ * stays bounded as boards, flags and sources change.
+ */
+public class BuildCache {
+  // entries kept; each is a build of one core or library
+  static final int MAX_ENTRIES = 64;
+  // a partial entry this old was left by a build that was stopped
+  static final long PARTIAL_AGE = 24 * 60 * 60 * 1000L;
+
+  File folder;
+
+  // digests of the files read so far, by path, with the length and time
+  // they had when they were read
+  static private Map<String, String[]> fileDigests =
+    new HashMap<String, String[]>();
+
+
+  public BuildCache(File folder) {
+    this.folder = folder;
+  }
+
+
+  /**
+   * Copy the files stored under key into target, in the folders they had
+   * under the base given to store(). Returns the files as copied, or null
+   * if there is nothing stored under key.
+   */
+  public List<File> restore(String key, File target) {
+    File entry = new File(folder, key);
+    if (!entry.isDirectory()) return null;
+
+    List<File> files = new ArrayList<File>();
+    try {
+      restore(entry, target, files);
+    } catch (IOException e) {
+      // a partial copy is no copy; build it instead
+      return null;
+    }
+    entry.setLastModified(System.currentTimeMillis());
+    return files;
+  }
+
+
+  private void restore(File from, File to, List<File> files) throws IOException {
+    String[] names = from.list();
+    if (names == null) return;
+    Arrays.sort(names);
+    to.mkdirs();
+    for (String name : names) {
+      File source = new File(from, name);
+      File target = new File(to, name);
+      if (source.isDirectory()) {
+        restore(source, target, files);
+      } else {
+        Base.copyFile(source, target);
+        files.add(target);
+      }
+    }
+  }
+
+
+  /**
+   * Keep copies of files, all of them somewhere under base, under key.
+   * The copies go into a folder of their own first and are renamed into
+   * place once they are all there, so two builds storing the same key at
+   * once, or one stopped half way through, never leave half an entry.
+   */
+  public void store(String key, File base, List<File> files) {
+    File entry = new File(folder, key);
+    if (entry.isDirectory()) return;
+
+    File partial = new File(folder, key + "." + System.nanoTime() + ".tmp");
+    String basePath = base.getAbsolutePath() + File.separator;
+    try {
+      if (!partial.mkdirs()) throw new IOException(partial.getPath());
+      for (File file : files) {
+        String path = file.getAbsolutePath();
+        if (!path.startsWith(basePath)) throw new IOException(path);
+        File target = new File(partial, path.substring(basePath.length()));
+        target.getParentFile().mkdirs();
+        Base.copyFile(file, target);
+      }
+      if (partial.renameTo(entry)) {
+        entry.setLastModified(System.currentTimeMillis());
+        prune();
+        return;
+      }
+    } catch (IOException e) {
+      // not cached, then; the build itself is fine
+    }
+    Base.removeDir(partial);
+  }
+
+
+  /**
+   * Remove the least recently restored entries past MAX_ENTRIES, and
+   * partial ones left by builds that never finished storing them.
+   */
+  private void prune() {
+    File[] children = folder.listFiles();
+    if (children == null) return;
+
+    long now = System.currentTimeMillis();
+    List<File> entries = new ArrayList<File>();
+    for (File child : children) {
+      if (!child.isDirectory()) continue;
+      if (child.getName().endsWith(".tmp")) {
+        if (now - child.lastModified() > PARTIAL_AGE) Base.removeDir(child);
+      } else {
+        entries.add(child);
+      }
+    }
+    if (entries.size() <= MAX_ENTRIES) return;
+
+    Collections.sort(entries, new Comparator<File>() {
+      public int compare(File a, File b) {
+        long ta = a.lastModified(), tb = b.lastModified();
+        return ta < tb ? -1 : (ta > tb ? 1 : 0);
+      }
+    });
+    for (int i = 0; i < entries.size() - MAX_ENTRIES; i++) {
+      Base.removeDir(entries.get(i));
+    }
+  }
+
+
+  /**
+   * A SHA-1 digest of strings, preferences and file contents, in the
+   * order they were added. A key with a file that could not be read is
+   * not complete and must not be used.
+   */
+  static public class Key {
+    MessageDigest digest;
+    boolean complete = true;
+
+    public Key() {
+      digest = newDigest();
+    }
+
+    public Key add(String s) {
+      try {
+        digest.update(s.getBytes("UTF-8"));
+      } catch (UnsupportedEncodingException e) { }
+      digest.update((byte) 0);
+      return this;
+    }
+
+    public Key add(List strings) {
+      for (Object s : strings) add(String.valueOf(s));
+      return add("");
+    }
+
+    public Key add(Map<String, String> preferences) {
+      for (String name : new TreeSet<String>(preferences.keySet())) {
+        add(name);
+        add(String.valueOf(preferences.get(name)));
+      }
+      return add("");
+    }
+
+    /**
+     * The names and contents of the files in folder, and in the folders
+     * under it if recurse is set, but not of hidden ones.
+     */
+    public Key addFolder(File folder, boolean recurse) {
+      String[] names = folder.list();
+      if (names == null) return add("");
+      Arrays.sort(names);
+      for (String name : names) {
+        if (name.startsWith(".")) continue;
+        File file = new File(folder, name);
+        if (file.isDirectory()) {
+          if (!recurse) continue;
+          add(name + "/");
+          addFolder(file, true);
+        } else {
+          String fileDigest = fileDigest(file);
+          if (fileDigest == null) complete = false;
+          else add(name).add(fileDigest);
+        }
+      }
+      return add("");
+    }
+
+    public boolean isComplete() {
+      return complete;
+    }
+
+    public String toString() {
+      return hex(digest.digest());
+    }
+  }
+
+
+  static private MessageDigest newDigest() {
+    try {
+      return MessageDigest.getInstance("SHA-1");
+    } catch (NoSuchAlgorithmException e) {
+      // every Java platform has SHA-1
+      throw new RuntimeException(e);
+    }
+  }
+
+
+  static private String hex(byte[] bytes) {
+    StringBuffer s = new StringBuffer();
+    for (int i = 0; i < bytes.length; i++) {
+      s.append(Integer.toHexString((bytes[i] >> 4) & 0xF));
+      s.append(Integer.toHexString(bytes[i] & 0xF));
+    }
+    return s.toString();
+  }
+
+
+  /**
+   * The digest of a file's contents, read again only when its length or
+   * time has changed since the last time, or null if it cannot be read.
+   */
+  static private String fileDigest(File file) {
+    String path = file.getAbsolutePath();
+    String stamp = file.length() + ":" + file.lastModified();
+    synchronized (fileDigests) {
+      String[] known = fileDigests.get(path);
+      if (known != null && known[0].equals(stamp)) return known[1];
+    }
+
+    MessageDigest digest = newDigest();
+    try {
+      InputStream in = new BufferedInputStream(new FileInputStream(file));
+      byte[] buffer = new byte[16 * 1024];
+      int bytesRead;
+      while ((bytesRead = in.read(buffer)) != -1) {
+        digest.update(buffer, 0, bytesRead);
+      }
+      in.close();
+    } catch (IOException e) {
+      return null;
+    }
+    String result = hex(digest.digest());
+    synchronized (fileDigests) {
+      fileDigests.put(path, new String[] { stamp, result });
+    }
+    return result;
+  }
+}
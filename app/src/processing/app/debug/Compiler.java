@@ -33,6 +33,7 @@ import static processing.app.I18n._;
 
 import java.io.*;
 import java.util.*;
+import java.util.concurrent.*;
 import java.util.zip.*;
 
 public class Compiler implements MessageConsumer {
@@ -47,7 +48,8 @@ public class Compiler implements MessageConsumer {
   boolean verbose;
   boolean sketchIsCompiled;
 
-  RunnerException exception;
+  // compiler commands queued by compileFiles() for runCompileJobs()
+  List<List> compileJobs = new ArrayList<List>();
 
   public Compiler() { }
 
@@ -69,6 +71,7 @@ public class Compiler implements MessageConsumer {
     this.primaryClassName = primaryClassName;
     this.verbose = verbose;
     this.sketchIsCompiled = false;
+    long started = System.currentTimeMillis();
 
     // the pms object isn't used for anything but storage
     MessageStream pms = new MessageStream(this);
@@ -199,8 +202,35 @@ public class Compiler implements MessageConsumer {
                findFilesInPath(buildPath, "c", false),
                findFilesInPath(buildPath, "cpp", false),
                boardPreferences));
+   runCompileJobs();
    sketchIsCompiled = true;
 
+   // core.a and the libraries' objects come from the build cache when a
+   // sketch has already built them for this board from the same sources.
+   // Everything in the include paths goes into the keys: the core, the
+   // variant and all of the imported libraries.
+   BuildCache cache = null;
+   String sourcesKey = null;
+   List<String> cacheKeys = new ArrayList<String>();
+   List<File> cacheFolders = new ArrayList<File>();
+   List<List<File>> cacheFiles = new ArrayList<List<File>>();
+   if (Preferences.getBoolean("build.cache")) {
+     cache = new BuildCache(new File(Base.getSettingsFolder(), "cache"));
+     BuildCache.Key key = new BuildCache.Key()
+       .add(arch)
+       .add(Base.REVISION + "." + Base.EREVISION)
+       .add(boardPreferences)
+       .add("build.drvlib=" + Preferences.getBoolean("build.drvlib"))
+       .addFolder(new File(corePath), true);
+     if (variantPath != null) key.addFolder(new File(variantPath), true);
+     for (File file : sketch.getImportedLibraries()) {
+       key.addFolder(file, true);
+     }
+     // a source that cannot be read could be anything; build it all
+     if (key.isComplete()) sourcesKey = key.toString();
+     else cache = null;
+   }
+
    // 2. compile the libraries, outputting .o files to: <buildPath>/<library>/
 
    sketch.setCompilingProgress(40);
@@ -210,38 +240,60 @@ public class Compiler implements MessageConsumer {
      createFolder(outputFolder);
      // this library can use includes in its utility/ folder
      includePaths.add(utilityFolder.getAbsolutePath());
-     objectFiles.addAll(
+     String libraryKey = null;
+     if (cache != null) {
+       libraryKey = new BuildCache.Key()
+         .add(sourcesKey)
+         .add(libraryFolder.getName())
+         .add(compilerCommands(basePath, includePaths, boardPreferences))
+         .toString();
+       List<File> cached = cache.restore(libraryKey, outputFolder);
+       if (cached != null) {
+         if (verbose || Preferences.getBoolean("build.verbose")) {
+           System.out.println("  Using cached library: " + libraryFolder.getName());
+         }
+         objectFiles.addAll(cached);
+         includePaths.remove(includePaths.size() - 1);
+         continue;
+       }
+     }
+     List<File> libraryObjectFiles =
        compileFiles(basePath, outputFolder.getAbsolutePath(), includePaths,
                findFilesInFolder(libraryFolder, "S", false),
                findFilesInFolder(libraryFolder, "c", false),
                findFilesInFolder(libraryFolder, "cpp", false),
-               boardPreferences));
-     outputFolder = new File(outputFolder, "utility");
-     createFolder(outputFolder);
-     objectFiles.addAll(
-       compileFiles(basePath, outputFolder.getAbsolutePath(), includePaths,
+               boardPreferences);
+     File utilityOutputFolder = new File(outputFolder, "utility");
+     createFolder(utilityOutputFolder);
+     libraryObjectFiles.addAll(
+       compileFiles(basePath, utilityOutputFolder.getAbsolutePath(), includePaths,
                findFilesInFolder(utilityFolder, "S", false),
                findFilesInFolder(utilityFolder, "c", false),
                findFilesInFolder(utilityFolder, "cpp", false),
                boardPreferences));
+     objectFiles.addAll(libraryObjectFiles);
+     if (cache != null) {
+       cacheKeys.add(libraryKey);
+       cacheFolders.add(outputFolder);
+       cacheFiles.add(libraryObjectFiles);
+     }
      // other libraries should not see this library's utility/ folder
      includePaths.remove(includePaths.size() - 1);
    }
 
    // 3. compile the core, outputting .o files to <buildPath> and then
    // collecting them into the core.a library file.
-   List<File> coreObjectFiles;
+   sketch.setCompilingProgress(50);
+   includePaths.clear();
+   includePaths.add(corePath);  // include path for core only
+   if (rtsIncPath != null) includePaths.add(rtsIncPath);
+   if (variantPath != null) includePaths.add(variantPath);
    //For c2000 cores, includes only the necessary files for the specific core
+   String core_headersPath = corePath;
+   String core_commonPath = corePath; 
    if(arch == "c2000")
    {
-	  sketch.setCompilingProgress(50);
-	  includePaths.clear();
-	  includePaths.add(corePath);  // include path for core only
-	  if (rtsIncPath != null) includePaths.add(rtsIncPath);
-	  if (variantPath != null) includePaths.add(variantPath);
 	  //add specific header folders to paths
-	  String core_headersPath = corePath;
-	  String core_commonPath = corePath; 
 	  if( boardPreferences.get("build.mcu").equals("TMS320F28027"))
       {
 		  core_commonPath += "/f2802x_common";
@@ -260,6 +312,28 @@ public class Compiler implements MessageConsumer {
     	  core_headersPath += "/F2837xS_headers";
     	  includePaths.add(corePath + "/F2837xS_common/include");
       }
+   }
+
+   String runtimeLibraryName = buildPath + File.separator + "core.a";
+   String coreKey = null;
+   boolean coreIsCached = false;
+   if (cache != null) {
+     coreKey = new BuildCache.Key()
+       .add(sourcesKey)
+       .add("core.a")
+       .add(compilerCommands(basePath, includePaths, boardPreferences))
+       .toString();
+     coreIsCached = cache.restore(coreKey, new File(buildPath)) != null;
+   }
+
+   List<File> coreObjectFiles = new ArrayList<File>();
+   if (coreIsCached) {
+     if (verbose || Preferences.getBoolean("build.verbose")) {
+       System.out.println("  Using cached core: " + runtimeLibraryName);
+     }
+   }
+   else if(arch == "c2000")
+   {
 	  ArrayList<File> corePathfiles_S = findFilesInPath(corePath, "S", false);
 	  corePathfiles_S.addAll(findFilesInPath(core_commonPath, "S", true));
 	  corePathfiles_S.addAll(findFilesInPath(core_headersPath, "S", true));
@@ -279,11 +353,6 @@ public class Compiler implements MessageConsumer {
    //other cores do not have to worry about not including all the files in the core path
    else
    {
-   sketch.setCompilingProgress(50);
-  includePaths.clear();
-  includePaths.add(corePath);  // include path for core only
-  if (rtsIncPath != null) includePaths.add(rtsIncPath);
-  if (variantPath != null) includePaths.add(variantPath);
 	  coreObjectFiles =
     compileFiles(basePath, buildPath, includePaths,
               findFilesInPath(corePath, "S", true),
@@ -292,7 +361,10 @@ public class Compiler implements MessageConsumer {
               boardPreferences);
 
    }
-  String runtimeLibraryName = buildPath + File.separator + "core.a";
+
+   // the libraries and the core compile together
+   runCompileJobs();
+
   List baseCommandAR;
   if(arch == "msp430")  {
     baseCommandAR = new ArrayList(Arrays.asList(new String[] {
@@ -320,24 +392,33 @@ public class Compiler implements MessageConsumer {
     }));
   }
 
-//  if(arch != "c2000"){
-    if(arch == "c2000")
-    {
-  	  for(File file : coreObjectFiles) {
- 	     List commandAR = new ArrayList(baseCommandAR);
- 	     commandAR.add(file.getAbsolutePath());
- 	     execAsynchronouslyShell(commandAR);
- 	   }
+    if (!coreIsCached) {
+      // all of the core's objects in one ar, into a new core.a so that
+      // nothing is left in it from sources the core no longer has
+      List commandAR = new ArrayList(baseCommandAR);
+      for (File file : coreObjectFiles) {
+        commandAR.add(file.getAbsolutePath());
+      }
+      new File(runtimeLibraryName).delete();
+      if(arch == "c2000")
+      {
+        execAsynchronouslyShell(commandAR);
+      }
+      else
+      {
+        execAsynchronously(commandAR);
+      }
+      if (cache != null) {
+        cacheKeys.add(coreKey);
+        cacheFolders.add(new File(buildPath));
+        cacheFiles.add(Collections.singletonList(new File(runtimeLibraryName)));
+      }
     }
-    else
-    {
-	  for(File file : coreObjectFiles) {
-	     List commandAR = new ArrayList(baseCommandAR);
-	     commandAR.add(file.getAbsolutePath());
-	     execAsynchronously(commandAR);
-	   }
+
+    // everything built, keep what was not already cached
+    for (int i = 0; i < cacheKeys.size(); i++) {
+      cache.store(cacheKeys.get(i), cacheFolders.get(i), cacheFiles.get(i));
     }
-//  }
 
     // 4. link it all together into the .elf file
     // For atmega2560, need --relax linker option to link larger
@@ -565,11 +646,19 @@ public class Compiler implements MessageConsumer {
 	execAsynchronously(commandObjcopy);
     }
     sketch.setCompilingProgress(90);
-   
+
+    if (verbose || Preferences.getBoolean("build.verbose")) {
+      System.out.println(I18n.format(_("Build took {0} ms"),
+                                     String.valueOf(System.currentTimeMillis() - started)));
+    }
     return true;
   }
 
 
+  /**
+   * Queue the commands that compile the sources into buildPath, for
+   * runCompileJobs() to run, and return the objects they make.
+   */
   private List<File> compileFiles(String basePath,
                                   String buildPath, List<File> includePaths,
                                   List<File> sSources, 
@@ -578,54 +667,13 @@ public class Compiler implements MessageConsumer {
     throws RunnerException {
 
     List<File> objectPaths = new ArrayList<File>();
-	if(Base.getArch() == "c2000")
-	{
-	
-    
     for (File file : sSources) {
       String objectPath = buildPath + File.separator + file.getName() + ".o";
       objectPaths.add(new File(objectPath));
-	      execAsynchronouslyShell(getCommandCompilerS(basePath, includePaths,
-	                                             file.getAbsolutePath(),
-	                                             objectPath,
-	                                             boardPreferences));
-	    }
-	 		
-	    for (File file : cSources) {
-	        String objectPath = buildPath + File.separator + file.getName() + ".o";
-	        String dependPath = buildPath + File.separator + file.getName() + ".d";
-	        File objectFile = new File(objectPath);
-	        File dependFile = new File(dependPath);
-	        objectPaths.add(objectFile);
-	        if (is_already_compiled(file, objectFile, dependFile, boardPreferences)) continue;
-	        execAsynchronouslyShell(getCommandCompilerC(basePath, includePaths,
-	                                               file.getAbsolutePath(),
-	                                               objectPath,
-	                                               boardPreferences));
-	    }
-	
-	    for (File file : cppSources) {
-	        String objectPath = buildPath + File.separator + file.getName() + ".o";
-	        String dependPath = buildPath + File.separator + file.getName() + ".d";
-	        File objectFile = new File(objectPath);
-	        File dependFile = new File(dependPath);
-	        objectPaths.add(objectFile);
-	        if (is_already_compiled(file, objectFile, dependFile, boardPreferences)) continue;
-	        execAsynchronouslyShell(getCommandCompilerCPP(basePath, includePaths,
-	                                                 file.getAbsolutePath(),
-	                                                 objectPath,
-	                                                 boardPreferences));
-	    }
-	}
-	else
-	{
-	    for (File file : sSources) {
-	      String objectPath = buildPath + File.separator + file.getName() + ".o";
-	      objectPaths.add(new File(objectPath));
-      execAsynchronously(getCommandCompilerS(basePath, includePaths,
-                                             file.getAbsolutePath(),
-                                             objectPath,
-                                             boardPreferences));
+      compileJobs.add(getCommandCompilerS(basePath, includePaths,
+                                          file.getAbsolutePath(),
+                                          objectPath,
+                                          boardPreferences));
     }
  		
     for (File file : cSources) {
@@ -635,10 +683,10 @@ public class Compiler implements MessageConsumer {
         File dependFile = new File(dependPath);
         objectPaths.add(objectFile);
         if (is_already_compiled(file, objectFile, dependFile, boardPreferences)) continue;
-        execAsynchronously(getCommandCompilerC(basePath, includePaths,
-                                               file.getAbsolutePath(),
-                                               objectPath,
-                                               boardPreferences));
+        compileJobs.add(getCommandCompilerC(basePath, includePaths,
+                                            file.getAbsolutePath(),
+                                            objectPath,
+                                            boardPreferences));
     }
 
     for (File file : cppSources) {
@@ -648,15 +696,66 @@ public class Compiler implements MessageConsumer {
         File dependFile = new File(dependPath);
         objectPaths.add(objectFile);
         if (is_already_compiled(file, objectFile, dependFile, boardPreferences)) continue;
-        execAsynchronously(getCommandCompilerCPP(basePath, includePaths,
-                                                 file.getAbsolutePath(),
-                                                 objectPath,
-                                                 boardPreferences));
+        compileJobs.add(getCommandCompilerCPP(basePath, includePaths,
+                                              file.getAbsolutePath(),
+                                              objectPath,
+                                              boardPreferences));
     }
-	}
     return objectPaths;
   }
 
+  /**
+   * Run the commands compileFiles() queued, as many at once as there are
+   * processors (one at a time for c2000, whose compiler goes through the
+   * shell), and throw the first error. Commands not yet started when one
+   * fails are not started at all.
+   */
+  private void runCompileJobs() throws RunnerException {
+    if (compileJobs.isEmpty()) return;
+
+    final boolean shell = Base.getArch() == "c2000";
+    int threads = shell ? 1 : Runtime.getRuntime().availableProcessors();
+    ExecutorService pool =
+      Executors.newFixedThreadPool(Math.min(threads, compileJobs.size()));
+    List<Future<Object>> results = new ArrayList<Future<Object>>();
+    for (final List command : compileJobs) {
+      results.add(pool.submit(new Callable<Object>() {
+        public Object call() throws RunnerException {
+          if (shell) {
+            execAsynchronouslyShell(command);
+          } else {
+            execAsynchronously(command);
+          }
+          return null;
+        }
+      }));
+    }
+    compileJobs.clear();
+
+    RunnerException failure = null;
+    for (Future<Object> result : results) {
+      if (failure != null) {
+        result.cancel(false);
+        continue;
+      }
+      try {
+        result.get();
+      } catch (ExecutionException e) {
+        if (e.getCause() instanceof RunnerException) {
+          failure = (RunnerException) e.getCause();
+        } else {
+          failure = new RunnerException(e.getCause().toString());
+          failure.hideStackTrace();
+        }
+      } catch (InterruptedException e) {
+        failure = new RunnerException(_("Error compiling."));
+        failure.hideStackTrace();
+      }
+    }
+    pool.shutdown();
+    if (failure != null) throw failure;
+  }
+
   private boolean is_already_compiled(File src, File obj, File dep, Map<String, String> prefs) {
     boolean ret=true;
     try {
@@ -720,12 +819,22 @@ public class Compiler implements MessageConsumer {
     return ret;
   }
 
-  boolean firstErrorFound;
-  boolean secondErrorFound;
-
   /**
-   * Either succeeds or throws a RunnerException fit for public consumption.
+   * The output of one command, passed on to report(). It keeps the first
+   * error placed in the sketch for that command to throw, so commands
+   * running at the same time each throw their own.
    */
+  private class CommandErrors implements MessageConsumer {
+    RunnerException exception;
+
+    public void message(String s) {
+      RunnerException e = report(s);
+      synchronized (this) {
+        if (exception == null && e != null) exception = e;
+      }
+    }
+  }
+
   /**
    * Either succeeds or throws a RunnerException fit for public consumption.
    */
@@ -735,15 +844,14 @@ public class Compiler implements MessageConsumer {
     int result = 0;
 
     if (verbose || Preferences.getBoolean("build.verbose")) {
+      // a line at a time, as other compilers may be printing theirs
+      StringBuffer line = new StringBuffer();
       for(int j = 0; j < command.length; j++) {
-        System.out.print(command[j] + " ");
+        line.append(command[j] + " ");
       }
-      System.out.println();
+      System.out.println(line);
     }
 
-    firstErrorFound = false;  // haven't found any errors yet
-    secondErrorFound = false;
-
     Process process;
 
     try {
@@ -754,8 +862,9 @@ public class Compiler implements MessageConsumer {
       throw re;
     }
 
-    MessageSiphon in = new MessageSiphon(process.getInputStream(), this);
-    MessageSiphon err = new MessageSiphon(process.getErrorStream(), this);
+    CommandErrors errors = new CommandErrors();
+    MessageSiphon in = new MessageSiphon(process.getInputStream(), errors);
+    MessageSiphon err = new MessageSiphon(process.getErrorStream(), errors);
 
     // wait for the process to finish.  if interrupted
     // before waitFor returns, continue waiting
@@ -777,8 +886,8 @@ public class Compiler implements MessageConsumer {
     // discerning the imagery, consider how cows regurgitate their food
     // to digest it, and the fact that they have five stomaches.
     //
-    //System.out.println("throwing up " + exception);
-    if (exception != null) { throw exception; }
+    //System.out.println("throwing up " + errors.exception);
+    if (errors.exception != null) { throw errors.exception; }
 
     if (result > 1) {
       // a failure in the tool (e.g. unable to locate a sub-executable)
@@ -799,15 +908,15 @@ public class Compiler implements MessageConsumer {
     int result = 0;
     
     if (verbose || Preferences.getBoolean("build.verbose")) {
+      // a line at a time, as other compilers may be printing theirs
+      StringBuffer line = new StringBuffer();
       for(int j = 0; j < command.length; j++) {
-        System.out.print(command[j] + " ");
+        line.append(command[j] + " ");
       }
-      System.out.println();
+      System.out.println(line);
     }
     System.out.println(Arrays.toString(command));
 
-    firstErrorFound = false;  // haven't found any errors yet
-    secondErrorFound = false;
     Process process;
     try {
         	process = Runtime.getRuntime().exec(command);
@@ -818,8 +927,9 @@ public class Compiler implements MessageConsumer {
       throw re;
     }
 
-    MessageSiphon in = new MessageSiphon(process.getInputStream(), this);
-    MessageSiphon err = new MessageSiphon(process.getErrorStream(), this);
+    CommandErrors errors = new CommandErrors();
+    MessageSiphon in = new MessageSiphon(process.getInputStream(), errors);
+    MessageSiphon err = new MessageSiphon(process.getErrorStream(), errors);
 
     // wait for the process to finish.  if interrupted
     // before waitFor returns, continue waiting
@@ -841,8 +951,8 @@ public class Compiler implements MessageConsumer {
     // discerning the imagery, consider how cows regurgitate their food
     // to digest it, and the fact that they have five stomaches.
     //
-    //System.out.println("throwing up " + exception);
-    if (exception != null) { throw exception; }
+    //System.out.println("throwing up " + errors.exception);
+    if (errors.exception != null) { throw errors.exception; }
 
     if (result > 1) {
       // a failure in the tool (e.g. unable to locate a sub-executable)
@@ -867,14 +977,14 @@ public class Compiler implements MessageConsumer {
     int result = 0;
 
     if (verbose || Preferences.getBoolean("build.verbose")) {
+      // a line at a time, as other compilers may be printing theirs
+      StringBuffer line = new StringBuffer();
       for(int j = 0; j < command.length; j++) {
-        System.out.print(command[j] + " ");
+        line.append(command[j] + " ");
       }
-      System.out.println();
+      System.out.println(line);
     }
     System.out.println(Arrays.toString(command));   
-    firstErrorFound = false;  // haven't found any errors yet
-    secondErrorFound = false;
     Process process;
     try {
         if(arch == "c2000")
@@ -905,8 +1015,9 @@ public class Compiler implements MessageConsumer {
       throw re;
     }
 
-    MessageSiphon in = new MessageSiphon(process.getInputStream(), this);
-    MessageSiphon err = new MessageSiphon(process.getErrorStream(), this);
+    CommandErrors errors = new CommandErrors();
+    MessageSiphon in = new MessageSiphon(process.getInputStream(), errors);
+    MessageSiphon err = new MessageSiphon(process.getErrorStream(), errors);
 
     // wait for the process to finish.  if interrupted
     // before waitFor returns, continue waiting
@@ -928,8 +1039,8 @@ public class Compiler implements MessageConsumer {
     // discerning the imagery, consider how cows regurgitate their food
     // to digest it, and the fact that they have five stomaches.
     //
-    //System.out.println("throwing up " + exception);
-    if (exception != null) { throw exception; }
+    //System.out.println("throwing up " + errors.exception);
+    if (errors.exception != null) { throw errors.exception; }
 
     if (result > 1) {
       // a failure in the tool (e.g. unable to locate a sub-executable)
@@ -952,6 +1063,15 @@ public class Compiler implements MessageConsumer {
    * and line number, which is then reported back to Editor.
    */
   public void message(String s) {
+    report(s);
+  }
+
+  /**
+   * Print a line of compiler output, and return the error it reports
+   * placed in the sketch, or null. Synchronized so the lines of commands
+   * running at the same time don't interleave.
+   */
+  private synchronized RunnerException report(String s) {
     int i;
 
     // remove the build path so people only see the filename
@@ -967,6 +1087,7 @@ public class Compiler implements MessageConsumer {
     // and at least the first line of the error message
     String errorFormat = "([\\w\\d_]+.\\w+):(\\d+):\\s*error:\\s*(.*)\\s*";
     String[] pieces = PApplet.match(s, errorFormat);
+    RunnerException e = null;
 
 //    if (pieces != null && exception == null) {
 //      exception = sketch.placeException(pieces[3], pieces[1], PApplet.parseInt(pieces[2]) - 1);
@@ -1018,7 +1139,6 @@ public class Compiler implements MessageConsumer {
               "to Wire.read() for consistency with other libraries.\n\n");
       }
 
-      RunnerException e = null;
       if (!sketchIsCompiled) {
         // Place errors when compiling the sketch, but never while compiling libraries
         // or the core.  The user's sketch might contain the same filename!
@@ -1034,17 +1154,31 @@ public class Compiler implements MessageConsumer {
         s = fileName + ":" + lineNum + ": error: " + pieces[3] + msg;
       }
             
-      if (exception == null && e != null) {
-        exception = e;
-        exception.hideStackTrace();
-      }      
+      if (e != null) {
+        e.hideStackTrace();
+      }
     }
     
     System.err.print(s);
+    return e;
   }
 
   /////////////////////////////////////////////////////////////////////////////
 
+  /**
+   * The compiler command lines with no source or object in them, for the
+   * build cache's keys.
+   */
+  static private List compilerCommands(String basePath, List includePaths,
+                                       Map<String, String> boardPreferences) {
+    List commands = new ArrayList();
+    commands.addAll(getCommandCompilerS(basePath, includePaths, "", "", boardPreferences));
+    commands.addAll(getCommandCompilerC(basePath, includePaths, "", "", boardPreferences));
+    commands.addAll(getCommandCompilerCPP(basePath, includePaths, "", "", boardPreferences));
+    return commands;
+  }
+
+
   static private List getCommandCompilerS(String basePath, List includePaths,
     String sourceName, String objectName, Map<String, String> boardPreferences) {
     String arch = Base.getArch();
@@ -35,8 +35,6 @@ import processing.core.*;
 import java.io.*;
 import java.util.*;
 
-import java.util.regex.*;
-
 
 /**
  * Class that orchestrates Wiring syntax into straight C/C++.
@@ -157,6 +155,10 @@ public class PdePreprocessor {
 
   PrintStream stream;
   String program;
+  // where the prototypes go, after the first comments and directives
+  int prototypeInsertionPoint;
+  // what SignatureScanner found in each piece of the program
+  List<SignatureScanner.Result> scans;
   String buildPath;
   // starts as sketch name, ends as main class name
   String name;
@@ -182,34 +184,54 @@ public class PdePreprocessor {
    */
   public int writePrefix(String program, String buildPath,
                          String sketchName, String codeFolderPackages[]) throws FileNotFoundException {
+    return writePrefix(Collections.singletonList(program), buildPath,
+                       sketchName, codeFolderPackages);
+  }
+
+  /**
+   * Writes out the head of the c++ code generated for a sketch, whose code
+   * is the pieces one after the other: the tabs and anything put between
+   * them. A piece that was scanned for an earlier build is not scanned
+   * again, so pass each tab as a piece of its own.
+   */
+  public int writePrefix(List<String> pieces, String buildPath,
+                         String sketchName, String codeFolderPackages[]) throws FileNotFoundException {
     this.buildPath = buildPath;
     this.name = sketchName;
 
     // if the program ends with no CR or LF an OutOfMemoryError will happen.
     // not gonna track down the bug now, so here's a hack for it:
     // http://dev.processing.org/bugs/show_bug.cgi?id=5
-    program += "\n";
-
-    // if the program ends with an unterminated multi-line comment,
-    // an OutOfMemoryError or NullPointerException will happen.
-    // again, not gonna bother tracking this down, but here's a hack.
-    // http://dev.processing.org/bugs/show_bug.cgi?id=16
-    Sketch.scrubComments(program);
-    // If there are errors, an exception is thrown and this fxn exits.
-
-    if (Preferences.getBoolean("preproc.substitute_unicode")) {
-      program = substituteUnicode(program);
+    pieces = new ArrayList<String>(pieces);
+    pieces.add("\n");
+
+    boolean unicode = Preferences.getBoolean("preproc.substitute_unicode");
+    StringBuffer code = new StringBuffer();
+    scans = new ArrayList<SignatureScanner.Result>();
+    prototypeInsertionPoint = -1;
+    for (String piece : pieces) {
+      if (unicode) {
+        piece = substituteUnicode(piece);
+      }
+
+      // an unterminated multi-line comment throws here
+      // (http://dev.processing.org/bugs/show_bug.cgi?id=16)
+      SignatureScanner.Result scan = SignatureScanner.scan(piece);
+      scans.add(scan);
+      if (prototypeInsertionPoint < 0 && scan.firstStatement >= 0) {
+        prototypeInsertionPoint = code.length() + scan.firstStatement;
+      }
+      code.append(piece);
+    }
+    String program = code.toString();
+    if (prototypeInsertionPoint < 0) {
+      prototypeInsertionPoint = program.length();
     }
 
-    //String importRegexp = "(?:^|\\s|;)(import\\s+)(\\S+)(\\s*;)";
-    String importRegexp = "^\\s*#include\\s*[<\"](\\S+)[\">]";
     programImports = new ArrayList<String>();
-
-    String[][] pieces = matchAll(program, importRegexp);
-
-    if (pieces != null)
-      for (int i = 0; i < pieces.length; i++)
-        programImports.add(pieces[i][1]);  // the package name
+    for (SignatureScanner.Result scan : scans) {
+      programImports.addAll(scan.includes);  // the package name
+    }
 
     codeFolderImports = new ArrayList<String>();
 //    if (codeFolderPackages != null) {
@@ -218,7 +240,7 @@ public class PdePreprocessor {
 //      }
 //    }
 
-    prototypes = prototypes(program);
+    prototypes = SignatureScanner.prototypes(scans);
     
     // store # of prototypes so that line number reporting can be adjusted
     prototypeCount = prototypes.size();
@@ -303,7 +325,8 @@ public class PdePreprocessor {
   // Write the pde program to the cpp file
   protected void writeProgram(PrintStream out, String program, List<String> prototypes) {
     /* find appropriate location for the setup/loop declarations */
-    int prototypeInsertionPoint = firstStatement(program);
+    int prototypeInsertionPoint = program == this.program ?
+      this.prototypeInsertionPoint : firstStatement(program);
   
     /* output everything up to that point */
     out.print(program.substring(0, prototypeInsertionPoint));
@@ -399,7 +422,7 @@ public class PdePreprocessor {
       
       // 1. concatenate all .ino files to the 'main' .cpp
       //    store line number for starting point of each code bit
-      StringBuffer bigCode = new StringBuffer();
+      ArrayList<String> pieces = new ArrayList<String>();
       int curOffset = 0;
       for (InoCode isc : code) {
           String in = isc.getProgram();
@@ -407,42 +430,25 @@ public class PdePreprocessor {
           
           /* if EMT we need to handle multiple *Loop and *Setup functions */
           if (isEMT) {
-	
-              // Find all loop functions and generate prototypes for them
-              ArrayList<String> loopMatches = new ArrayList<String>();
-		    	    
-              Pattern functionPattern  = Pattern.compile("\\s*void\\s+(loop)\\s*\\(\\s*(void)?\\s*\\)");
-              Matcher functionMatcher = functionPattern.matcher(in);
-              while (functionMatcher.find()) {
-                  loopMatches.add(functionMatcher.group(1));
-              }
-	
-              // Find all setup functions and generate prototypes for them
-              ArrayList<String> setupMatches = new ArrayList<String>();
-
-              functionPattern = Pattern.compile("\\s*void\\s+(setup)\\s*\\(\\s*(void)?\\s*\\)");
-              functionMatcher = functionPattern.matcher(in);
-              while (functionMatcher.find()) {
-                  setupMatches.add(functionMatcher.group(1));
-              }
+              List<String> functions = SignatureScanner.scan(in).voidFunctions;
 	        
               // Add #line directives to help the compiler report errors with
               // correct the filename and line number (issue 281 & 907)
-              if (setupMatches.size() > 0 && loopMatches.size() > 0) {
+              if (functions.contains("setup") && functions.contains("loop")) {
                   /* map setup and loop to an .ino qualified name to allow
                    * blind copy existing .ino files, each with a setup/loop 
                    * pair, into a project
                    */
                   String inoName = isc.getFileName().substring(0, isc.getFileName().length()-4);
-                  bigCode.append("#undef setup\n#undef loop\n");
-                  bigCode.append("#define setup setup" +  inoName + "\n");
-                  bigCode.append("#define loop loop" +  inoName + "\n");
+                  pieces.add("#undef setup\n#undef loop\n" +
+                             "#define setup setup" +  inoName + "\n" +
+                             "#define loop loop" +  inoName + "\n");
               }
-              bigCode.append("#line 1 \"" + isc.getFullPath().replace("\\", "\\\\") + "\"\n");
+              pieces.add("#line 1 \"" + isc.getFullPath().replace("\\", "\\\\") + "\"\n");
           }
       
-          bigCode.append(in);
-          bigCode.append('\n');
+          pieces.add(in);
+          pieces.add("\n");
           curOffset += isc.getLineCount();
       }
 
@@ -452,7 +458,7 @@ public class PdePreprocessor {
       sketchName = aSketchName == null ? sketchName:aSketchName;
 
       try {
-          prefixLen = writePrefix(bigCode.toString(),
+          prefixLen = writePrefix(pieces,
                                    buildPath,
                                    sketchName,
                                    null);
@@ -503,151 +509,43 @@ public class PdePreprocessor {
    * or a pre-processor directive.
    */
   public int firstStatement(String in) {
-    // whitespace
-    String p = "\\s+";
-    
-    // multi-line and single-line comment
-    //p += "|" + "(//\\s*?$)|(/\\*\\s*?\\*/)";
-    p += "|(/\\*[^*]*(?:\\*(?!/)[^*]*)*\\*/)|(//.*?$)";
-
-    // pre-processor directive
-    p += "|(#(?:\\\\\\n|.)*)";
-    Pattern pattern = Pattern.compile(p, Pattern.MULTILINE);
-      
-    Matcher matcher = pattern.matcher(in);
-    int i = 0;
-    while (matcher.find()) {
-      if (matcher.start()!=i)
-        break;
-      i = matcher.end();
-    }
-    
-    return i;
+    int i = SignatureScanner.scan(in).firstStatement;
+    return i < 0 ? in.length() : i;
   }
-  
+
   /**
-   * Strips comments, pre-processor directives, single- and double-quoted
-   * strings from a string.
-   * @param in the String to strip
-   * @return the stripped String
+   * Prototypes for the functions defined in a program but not declared
+   * in it before.
    */
-  public String strip(String in) {
-    // XXX: doesn't properly handle special single-quoted characters
-    // single-quoted character
-    String p = "('.')";
-    
-    // double-quoted string
-    p += "|(\"(?:[^\"\\\\]|\\\\.)*\")";
-    
-    // single and multi-line comment
-    //p += "|" + "(//\\s*?$)|(/\\*\\s*?\\*/)";
-    p += "|(//.*?$)|(/\\*[^*]*(?:\\*(?!/)[^*]*)*\\*/)";
-    
-    // pre-processor directive
-    p += "|" + "(^\\s*#.*?$)";
-
-    Pattern pattern = Pattern.compile(p, Pattern.MULTILINE);
-    Matcher matcher = pattern.matcher(in);
-    return matcher.replaceAll(" ");
+  public ArrayList<String> prototypes(String in) {
+    return SignatureScanner.prototypes(
+      Collections.singletonList(SignatureScanner.scan(in)));
   }
   
   /**
-   * Removes the contents of all top-level curly brace pairs {}.
-   * @param in the String to collapse
-   * @return the collapsed String
+   * Whether a function is one of the main template's tasks: letters, then
+   * word with its first letter in either case ("blinkLoop", "loopRed"),
+   * then anything.
    */
-  private String collapseBraces(String in) {
-    StringBuffer buffer = new StringBuffer();
-    int nesting = 0;
-    int start = 0;
-    
-    // XXX: need to keep newlines inside braces so we can determine the line
-    // number of a prototype
-    for (int i = 0; i < in.length(); i++) {
-      if (in.charAt(i) == '{') {
-        if (nesting == 0) {
-          buffer.append(in.substring(start, i + 1));  // include the '{'
-        }
-        nesting++;
+  static private boolean isTaskFunction(String name, String word) {
+    for (int i = 0; i + word.length() <= name.length(); i++) {
+      if (Character.toLowerCase(name.charAt(i)) == word.charAt(0)
+          && name.startsWith(word.substring(1), i + 1)) {
+        return true;
       }
-      if (in.charAt(i) == '}') {
-        nesting--;
-        if (nesting == 0) {
-          start = i; // include the '}'
-        }
+      char c = name.charAt(i);
+      if (!(c >= 'a' && c <= 'z') && !(c >= 'A' && c <= 'Z') && c != '_') {
+        return false;
       }
     }
-    
-    buffer.append(in.substring(start));
-    
-    return buffer.toString();
-  }
-  
-  /**
-   * Find all matches of a regexp in the specified string
-   */
-  static private String[][] matchAll(String what, String regexp) {
-    Pattern p = Pattern.compile(regexp, Pattern.MULTILINE | Pattern.DOTALL);
-    Matcher m = p.matcher(what);
-    ArrayList<String[]> results = new ArrayList<String[]>();
-    int count = m.groupCount() + 1;
-    while (m.find()) {
-      String[] groups = new String[count];
-      for (int i = 0; i < count; i++) {
-        groups[i] = m.group(i);
-      }
-      results.add(groups);
-    }
-    if (results.isEmpty()) {
-      return null;
-    }
-    String[][] matches = new String[results.size()][count];
-    for (int i = 0; i < matches.length; i++) {
-      matches[i] = (String[]) results.get(i);
-    }
-    return matches;
+    return false;
   }
 
-  public ArrayList<String> prototypes(String in) {
-    in = collapseBraces(strip(in));
-    
-    // XXX: doesn't handle ... varargs
-    // XXX: doesn't handle function pointers
-    Pattern prototypePattern = Pattern.compile("[\\w\\[\\]\\*]+\\s+[&\\[\\]\\*\\w\\s]+\\([&,\\[\\]\\*\\w\\s]*\\)(?=\\s*;)");
-    Pattern functionPattern  = Pattern.compile("[\\w\\[\\]\\*]+\\s+[&\\[\\]\\*\\w\\s]+\\([&,\\[\\]\\*\\w\\s]*\\)(?=\\s*\\{)");
-    
-    // Find already declared prototypes
-    ArrayList<String> prototypeMatches = new ArrayList<String>();
-    Matcher prototypeMatcher = prototypePattern.matcher(in);
-    while (prototypeMatcher.find())
-      prototypeMatches.add(prototypeMatcher.group(0) + ";");
-    
-    // Find all functions and generate prototypes for them
-    ArrayList<String> functionMatches = new ArrayList<String>();
-    Matcher functionMatcher = functionPattern.matcher(in);
-    while (functionMatcher.find())
-      functionMatches.add(functionMatcher.group(0) + ";");
-    
-    // Remove generated prototypes that exactly match ones found in the source file
-    for (int functionIndex=functionMatches.size() - 1; functionIndex >= 0; functionIndex--) {
-      for (int prototypeIndex=0; prototypeIndex < prototypeMatches.size(); prototypeIndex++) {
-        if ((functionMatches.get(functionIndex)).equals(prototypeMatches.get(prototypeIndex))) {
-          functionMatches.remove(functionIndex);
-          break;
-        }
-      }
-    }
-    
-    return functionMatches;
-  }
-  
   /**
    * Generate main.cpp from optionally specified template file and 
    * write result into outDir
    */
   private void writemain(String outDir, String template) {
-      String _in = program;
-      String in = collapseBraces(strip(program));
       
       String content = "";
       try {
@@ -668,59 +566,41 @@ public class PdePreprocessor {
       int insertionPoint = content.indexOf("769d20fcd7a0eedaf64270f591438b01");
       insertionPoint = content.indexOf("\n", insertionPoint) + 1;
 
-      //Pattern functionPattern  = Pattern.compile("(?=([\\w\\[\\]\\*]+\\s+[&\\[\\]\\*\\w\\s])*)\\w*[Ll]oop(?=\\s*\\()");
-      Pattern functionPattern  = Pattern.compile("\\s*void\\s+([a-zA-Z_]*[lL]oop\\w*)\\s*\\(\\s*(void)?\\s*\\)");
-
       // Find all functions and generate prototypes for them
       ArrayList<String> loopMatches = new ArrayList<String>();
       ArrayList<String> setupMatches = new ArrayList<String>();
-      	    
-      Matcher functionMatcher = functionPattern.matcher(in);
 
-      // Leave setup alone since it is special
-      // It will be processed using the next regex
-      // See Sketch.java for the generation of the #define setupxxx
-      while (functionMatcher.find()) {
-      	String func = functionMatcher.group(1);
-      	if(func.equals("loop")) continue;
-      	loopMatches.add(functionMatcher.group(1));
+      // Leave setup and loop alone since they are special; they are
+      // renamed by the #defines Sketch.java generates for each tab
+      for (SignatureScanner.Result scan : scans) {
+          for (String func : scan.voidFunctions) {
+              if (!func.equals("loop") && isTaskFunction(func, "loop")) {
+                  loopMatches.add(func);
+              }
+          }
       }
-      
-      //functionPattern  = Pattern.compile("(?=([\\w\\[\\]\\*]+\\s+[&\\[\\]\\*\\w\\s])*)\\w*[Ss]etup(?=\\s*\\()");
-      functionPattern  = Pattern.compile("\\s*void\\s+([a-zA-Z_]*[sS]etup\\w*)\\s*\\(\\s*(void)?\\s*\\)");
-
-      // Find all functions and generate prototypes for them
-      functionMatcher = functionPattern.matcher(in);
-      
-      // Leave setup alone since it is special
-      // It will be processed using the next regex
-      // See Sketch.java for the generation of the #define setupxxx
-      while (functionMatcher.find()) {
-      	String func = functionMatcher.group(1);
-      	if(func.equals("setup")) continue;
-      	setupMatches.add(functionMatcher.group(1));
+      for (SignatureScanner.Result scan : scans) {
+          for (String func : scan.voidFunctions) {
+              if (!func.equals("setup") && isTaskFunction(func, "setup")) {
+                  setupMatches.add(func);
+              }
+          }
       }
-
-      functionPattern  = Pattern.compile("(#define setup\\s)([a-zA-Z_*]\\w*)");
-
-      // Find all functions and generate prototypes for them
-      functionMatcher = functionPattern.matcher(_in);
-      
-      while (functionMatcher.find()) {
-      	String func = functionMatcher.group(2);
-      	setupMatches.add(func);
+      for (SignatureScanner.Result scan : scans) {
+          for (String define : scan.defines) {
+              if (define.startsWith("setup ")) {
+                  setupMatches.add(define.substring("setup ".length()));
+              }
+          }
       }
-
-      functionPattern  = Pattern.compile("(#define loop\\s)([a-zA-Z_*]\\w*)");
-
-      // Find all functions and generate prototypes for them
-      functionMatcher = functionPattern.matcher(_in);
-      
-      while (functionMatcher.find()) {
-      	String func = functionMatcher.group(2);
-      	loopMatches.add(func);
+      for (SignatureScanner.Result scan : scans) {
+          for (String define : scan.defines) {
+              if (define.startsWith("loop ")) {
+                  loopMatches.add(define.substring("loop ".length()));
+              }
+          }
       }
-      
+
       if(setupMatches.size() != loopMatches.size()) {
       	System.out.println("The number of loop functions does not match the number of setup functions\n" +
       			"Missing a loop or a setup in your Sketches?");
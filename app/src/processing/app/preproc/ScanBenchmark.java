@@ -0,0 +1,268 @@
+/* -*- mode: java; c-basic-offset: 2; indent-tabs-mode: nil -*- */
+
+/*
+  ScanBenchmark - SignatureScanner against the old regular expressions
+  Part of the Energia project - http://energia.nu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+package processing.app.preproc;
+
+import java.io.*;
+import java.util.*;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+
+/**
+ * Times SignatureScanner against the regular expressions the preprocessor
+ * used before it, and checks that both find the same prototypes.
+ * <p/>
+ * <pre>
+ *   java -cp pde.jar processing.app.preproc.ScanBenchmark [file or folder ...]
+ * </pre>
+ * With no arguments it scans a generated sketch of 20000 lines; with
+ * them, every .ino and .pde file given or under a folder given, the
+ * examples for instance. Prototypes are compared with their whitespace
+ * made the same. The old expressions miss templates, default arguments
+ * and the like, so prototypes only the scanner finds are listed but are
+ * not a failure; one only the old expressions find is.
+ */
+public class ScanBenchmark {
+  static final int LINES = 20000;
+  static final int ROUNDS = 10;
+
+
+  static public void main(String[] args) throws IOException {
+    if (args.length == 0) {
+      String code = generate(LINES);
+      boolean same = compare("generated sketch", code);
+      time(code);
+      System.exit(same ? 0 : 1);
+    }
+
+    List<File> files = new ArrayList<File>();
+    for (String arg : args) {
+      find(new File(arg), files);
+    }
+    int differ = 0;
+    StringBuffer all = new StringBuffer();
+    for (File file : files) {
+      String code = read(file);
+      if (!compare(file.getPath(), code)) differ++;
+      all.append(code).append('\n');
+    }
+    System.out.println(files.size() + " files, " + differ + " differ");
+    time(all.toString());
+    System.exit(differ == 0 ? 0 : 1);
+  }
+
+
+  /**
+   * A sketch of lines lines, in blocks of 20: functions with comments,
+   * strings and characters around them that look like code but are not.
+   */
+  static String generate(int lines) {
+    StringBuffer s = new StringBuffer();
+    for (int n = 0; 20 * n < lines; n++) {
+      s.append("// block " + n + ", not a function: int notMe(int a) {\n");
+      s.append("/* nor this:\n");
+      s.append("   void alsoNotMe() { */\n");
+      s.append("#define LED_" + n + " 13\n");
+      s.append("int counter_" + n + " = 0;\n");
+      s.append("const char *name_" + n + " = \"void inString(int x) {\";\n");
+      s.append("char quote_" + n + " = '{';\n");
+      s.append("\n");
+      s.append("int add_" + n + "(int a, int b)\n");
+      s.append("{\n");
+      s.append("  if (a > b) {\n");
+      s.append("    return a - b;\n");
+      s.append("  }\n");
+      s.append("  return a + b;\n");
+      s.append("}\n");
+      s.append("\n");
+      s.append("void blink_" + n + "(unsigned long ms) {\n");
+      s.append("  digitalWrite(LED_" + n + ", HIGH);\n");
+      s.append("  delay(ms);\n");
+      s.append("}\n");
+    }
+    return s.toString();
+  }
+
+
+  /**
+   * Whether the scanner finds every prototype the old expressions do,
+   * printing the ones that differ.
+   */
+  static boolean compare(String name, String code) {
+    List<String> scanned = normalize(
+      SignatureScanner.prototypes(
+        Collections.singletonList(SignatureScanner.scan(code))));
+    List<String> matched = normalize(regexPrototypes(code));
+
+    List<String> missed = new ArrayList<String>(matched);
+    missed.removeAll(scanned);
+    List<String> extra = new ArrayList<String>(scanned);
+    extra.removeAll(matched);
+    if (!missed.isEmpty() || !extra.isEmpty()) {
+      System.out.println(name + ":");
+      for (String p : missed) System.out.println("  only old: " + p);
+      for (String p : extra) System.out.println("  only new: " + p);
+    }
+    return missed.isEmpty();
+  }
+
+
+  // a space only between two words
+  static List<String> normalize(List<String> prototypes) {
+    List<String> result = new ArrayList<String>();
+    for (String p : prototypes) {
+      result.add(p.replaceAll("\\s+", " ").replaceAll(" (?=\\W)|(?<=\\W) ", ""));
+    }
+    return result;
+  }
+
+
+  /**
+   * The milliseconds a scan of code takes, the best of ROUNDS, with the
+   * scanner's cache missed, then hit, and with the old expressions.
+   */
+  static void time(String code) {
+    long cold = Long.MAX_VALUE, warm = Long.MAX_VALUE, regex = Long.MAX_VALUE;
+    for (int round = 0; round < ROUNDS; round++) {
+      // a comment of its own so that the cache has not seen it
+      String fresh = code + "// " + round + "\n";
+      long start = System.nanoTime();
+      SignatureScanner.scan(fresh);
+      cold = Math.min(cold, System.nanoTime() - start);
+
+      start = System.nanoTime();
+      SignatureScanner.scan(fresh);
+      warm = Math.min(warm, System.nanoTime() - start);
+
+      start = System.nanoTime();
+      regexPrototypes(fresh);
+      regex = Math.min(regex, System.nanoTime() - start);
+    }
+    System.out.println(code.split("\n", -1).length + " lines, " +
+                       code.length() + " characters");
+    System.out.printf("  scanner %.2f ms, cached %.3f ms, regex %.2f ms\n",
+                      cold / 1e6, warm / 1e6, regex / 1e6);
+  }
+
+
+  static void find(File file, List<File> files) {
+    if (file.isDirectory()) {
+      String[] names = file.list();
+      if (names == null) return;
+      Arrays.sort(names);
+      for (String name : names) {
+        find(new File(file, name), files);
+      }
+    } else if (file.getName().endsWith(".ino") ||
+               file.getName().endsWith(".pde")) {
+      files.add(file);
+    }
+  }
+
+
+  static String read(File file) throws IOException {
+    StringBuffer s = new StringBuffer();
+    Reader in = new InputStreamReader(new FileInputStream(file), "UTF-8");
+    try {
+      char[] buffer = new char[16 * 1024];
+      int n;
+      while ((n = in.read(buffer)) != -1) s.append(buffer, 0, n);
+    } finally {
+      in.close();
+    }
+    return s.toString();
+  }
+
+
+  //
+  // The preprocessor's prototypes before SignatureScanner, as they were
+  //
+
+  static String strip(String in) {
+    // XXX: doesn't properly handle special single-quoted characters
+    // single-quoted character
+    String p = "('.')";
+
+    // double-quoted string
+    p += "|(\"(?:[^\"\\\\]|\\\\.)*\")";
+
+    // single and multi-line comment
+    p += "|(//.*?$)|(/\\*[^*]*(?:\\*(?!/)[^*]*)*\\*/)";
+
+    // pre-processor directive
+    p += "|" + "(^\\s*#.*?$)";
+
+    Pattern pattern = Pattern.compile(p, Pattern.MULTILINE);
+    Matcher matcher = pattern.matcher(in);
+    return matcher.replaceAll(" ");
+  }
+
+
+  static String collapseBraces(String in) {
+    StringBuffer buffer = new StringBuffer();
+    int nesting = 0;
+    int start = 0;
+
+    for (int i = 0; i < in.length(); i++) {
+      if (in.charAt(i) == '{') {
+        if (nesting == 0) {
+          buffer.append(in.substring(start, i + 1));  // include the '{'
+        }
+        nesting++;
+      }
+      if (in.charAt(i) == '}') {
+        nesting--;
+        if (nesting == 0) {
+          start = i; // include the '}'
+        }
+      }
+    }
+
+    buffer.append(in.substring(start));
+
+    return buffer.toString();
+  }
+
+
+  static ArrayList<String> regexPrototypes(String in) {
+    in = collapseBraces(strip(in));
+
+    Pattern prototypePattern = Pattern.compile("[\\w\\[\\]\\*]+\\s+[&\\[\\]\\*\\w\\s]+\\([&,\\[\\]\\*\\w\\s]*\\)(?=\\s*;)");
+    Pattern functionPattern  = Pattern.compile("[\\w\\[\\]\\*]+\\s+[&\\[\\]\\*\\w\\s]+\\([&,\\[\\]\\*\\w\\s]*\\)(?=\\s*\\{)");
+
+    // Find already declared prototypes
+    ArrayList<String> prototypeMatches = new ArrayList<String>();
+    Matcher prototypeMatcher = prototypePattern.matcher(in);
+    while (prototypeMatcher.find())
+      prototypeMatches.add(prototypeMatcher.group(0) + ";");
+
+    // Find all functions and generate prototypes for them
+    ArrayList<String> functionMatches = new ArrayList<String>();
+    Matcher functionMatcher = functionPattern.matcher(in);
+    while (functionMatcher.find())
+      functionMatches.add(functionMatcher.group(0) + ";");
+
+    // Remove generated prototypes that exactly match ones found in the source file
+    functionMatches.removeAll(prototypeMatches);
+    return functionMatches;
+  }
+}
@@ -0,0 +1,436 @@
+/* -*- mode: java; c-basic-offset: 2; indent-tabs-mode: nil -*- */
+
+/*
+  SignatureScanner - function signatures and includes in sketch code
+  Part of the Energia project - http://energia.nu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+package processing.app.preproc;
+
+import static processing.app.I18n._;
+
+import java.util.*;
+
+
+/**
+ * Reads sketch code once, a character at a time, for what the
+ * preprocessor needs to know about it: where the first statement is, the
+ * files it includes and the names it defines, and the signatures of the
+ * functions it declares and defines outside of any braces.
+ * <p/>
+ * Comments, string and character literals and preprocessor directives
+ * are skipped as they are met, so nothing in them is taken for code, and
+ * the code itself is never copied. A function's signature is the tokens
+ * of what comes before its opening brace: an optional template header,
+ * a return type, a name and the parameters, with their default values
+ * left out so that the prototype does not give them a second time.
+ * <p/>
+ * Scans are kept by the code they were of, so the tabs that have not
+ * changed since the last build are not read again.
+ */
+public class SignatureScanner {
+
+  /**
+   * What a piece of code has in it.
+   */
+  static public class Result {
+    // offset of the first character that's not whitespace, a comment or
+    // a pre-processor directive, or -1 if there is none
+    public int firstStatement = -1;
+
+    // the files in #include directives, without their quotes or brackets
+    public List<String> includes = new ArrayList<String>();
+
+    // the #define directives, the name and the value with single spaces
+    public List<String> defines = new ArrayList<String>();
+
+    // prototypes for the functions defined, "int f(int a);"
+    public List<String> definitions = new ArrayList<String>();
+
+    // prototypes for the functions only declared
+    public List<String> declarations = new ArrayList<String>();
+
+    // the names of the functions defined as void f() or void f(void)
+    public List<String> voidFunctions = new ArrayList<String>();
+  }
+
+  // the last scans, by the code they were of
+  static private final int CACHE_SIZE = 64;
+  static private Map<String, Result> cache =
+    new LinkedHashMap<String, Result>(CACHE_SIZE, 0.75f, true) {
+      protected boolean removeEldestEntry(Map.Entry<String, Result> eldest) {
+        return size() > CACHE_SIZE;
+      }
+    };
+
+  static private final Set<String> notNames = new HashSet<String>(
+    Arrays.asList(new String[] {
+      "if", "while", "for", "switch", "return", "sizeof", "operator",
+      "defined", "__attribute__", "__asm__", "asm"
+    }));
+
+
+  /**
+   * Scan code, or find its scan from before. Throws a RuntimeException
+   * for a comment that never ends.
+   */
+  static public Result scan(String code) {
+    synchronized (cache) {
+      Result result = cache.get(code);
+      if (result != null) return result;
+    }
+    Result result = scanCode(code);
+    synchronized (cache) {
+      cache.put(code, result);
+    }
+    return result;
+  }
+
+
+  /**
+   * The prototypes for the functions defined in all of the pieces but
+   * declared in none of them, in the order they were defined.
+   */
+  static public ArrayList<String> prototypes(List<Result> results) {
+    Set<String> declared = new HashSet<String>();
+    for (Result result : results) {
+      declared.addAll(result.declarations);
+    }
+    ArrayList<String> prototypes = new ArrayList<String>();
+    for (Result result : results) {
+      for (String prototype : result.definitions) {
+        if (!declared.contains(prototype)) prototypes.add(prototype);
+      }
+    }
+    return prototypes;
+  }
+
+
+  static private Result scanCode(String in) {
+    Result result = new Result();
+    // the tokens outside of braces since the last statement ended
+    List<String> tokens = new ArrayList<String>();
+    int length = in.length();
+    int depth = 0;
+    boolean lineStart = true;
+
+    int i = 0;
+    while (i < length) {
+      char c = in.charAt(i);
+      char next = i + 1 < length ? in.charAt(i + 1) : 0;
+
+      if (c == '\n') {
+        lineStart = true;
+        i++;
+      } else if (Character.isWhitespace(c)) {
+        i++;
+      } else if (c == '/' && next == '/') {
+        i = lineEnd(in, i);
+      } else if (c == '/' && next == '*') {
+        i = commentEnd(in, i);
+      } else if (c == '#' && lineStart) {
+        int end = directiveEnd(in, i);
+        directive(result, in, i + 1, end);
+        i = end;
+      } else {
+        if (result.firstStatement < 0) result.firstStatement = i;
+        lineStart = false;
+
+        if (c == '"' || c == '\'') {
+          if (depth == 0) tokens.add(String.valueOf(c));
+          i = quotedEnd(in, i);
+        } else if (isWord(c)) {
+          int end = i + 1;
+          while (end < length && isWord(in.charAt(end))) end++;
+          if (depth == 0) tokens.add(in.substring(i, end));
+          i = end;
+        } else if (c == '{') {
+          if (depth == 0) {
+            String prototype = signature(tokens);
+            if (prototype != null) {
+              result.definitions.add(prototype);
+              if (isVoidFunction(tokens)) {
+                result.voidFunctions.add(name(tokens));
+              }
+            }
+            tokens.clear();
+          }
+          depth++;
+          i++;
+        } else if (c == '}') {
+          if (depth > 0) depth--;
+          if (depth == 0) tokens.clear();
+          i++;
+        } else if (depth > 0) {
+          i++;
+        } else if (c == ';') {
+          String prototype = signature(tokens);
+          if (prototype != null) result.declarations.add(prototype);
+          tokens.clear();
+          i++;
+        } else if (c == ':' && next == ':') {
+          tokens.add("::");
+          i += 2;
+        } else {
+          tokens.add(String.valueOf(c));
+          i++;
+        }
+      }
+    }
+    return result;
+  }
+
+
+  static private boolean isWord(char c) {
+    return Character.isLetterOrDigit(c) || c == '_';
+  }
+
+
+  static private int lineEnd(String in, int i) {
+    int end = in.indexOf('\n', i);
+    return end < 0 ? in.length() : end;
+  }
+
+
+  static private int commentEnd(String in, int i) {
+    int end = in.indexOf("*/", i + 2);
+    if (end < 0) {
+      throw new RuntimeException(_("Missing the */ from the end of a " +
+                                   "/* comment */"));
+    }
+    return end + 2;
+  }
+
+
+  // a string or character literal ends at its closing quote, or where
+  // the line does if it has none
+  static private int quotedEnd(String in, int i) {
+    char quote = in.charAt(i);
+    for (i++; i < in.length(); i++) {
+      char c = in.charAt(i);
+      if (c == '\\') {
+        i++;
+      } else if (c == quote) {
+        return i + 1;
+      } else if (c == '\n') {
+        return i;
+      }
+    }
+    return in.length();
+  }
+
+
+  // a directive ends at the end of a line that is not continued with a
+  // backslash, and comments in it may run on past that
+  static private int directiveEnd(String in, int i) {
+    int length = in.length();
+    while (i < length) {
+      char c = in.charAt(i);
+      char next = i + 1 < length ? in.charAt(i + 1) : 0;
+      if (c == '\n') {
+        return i;
+      } else if (c == '\\' && (next == '\n' || next == '\r')) {
+        i = lineEnd(in, i + 1) + 1;
+      } else if (c == '/' && next == '/') {
+        return lineEnd(in, i);
+      } else if (c == '/' && next == '*') {
+        i = commentEnd(in, i);
+      } else {
+        i++;
+      }
+    }
+    return length;
+  }
+
+
+  static private void directive(Result result, String in, int start, int end) {
+    while (start < end && Character.isWhitespace(in.charAt(start))) start++;
+
+    if (in.startsWith("include", start)) {
+      int open = start + "include".length();
+      while (open < end && Character.isWhitespace(in.charAt(open))) open++;
+      if (open == end) return;
+      char close = in.charAt(open) == '<' ? '>' : in.charAt(open) == '"' ? '"' : 0;
+      if (close == 0) return;
+      int closing = in.indexOf(close, open + 1);
+      if (closing > open + 1 && closing < end) {
+        result.includes.add(in.substring(open + 1, closing));
+      }
+
+    } else if (in.startsWith("define", start)) {
+      StringBuffer define = new StringBuffer();
+      boolean space = false;
+      for (int i = start + "define".length(); i < end; i++) {
+        char c = in.charAt(i);
+        if (c == '\n' || c == '/') break;
+        if (Character.isWhitespace(c) || c == '\\') {
+          space = define.length() > 0;
+        } else {
+          if (space) define.append(' ');
+          define.append(c);
+          space = false;
+        }
+      }
+      result.defines.add(define.toString());
+    }
+  }
+
+
+  // where the parameters of the function in tokens start, the index of
+  // their '(', or -1 if tokens are not a function's signature
+  static private int parameters(List<String> tokens, int start) {
+    int n = tokens.size();
+    if (n - start < 4 || !tokens.get(n - 1).equals(")")) return -1;
+
+    int open = n - 1;
+    int parens = 0;
+    for (; open >= start; open--) {
+      String token = tokens.get(open);
+      if (token.equals(")")) {
+        parens++;
+      } else if (token.equals("(") && --parens == 0) {
+        break;
+      }
+    }
+    // a return type and a name before them
+    if (open - start < 2) return -1;
+
+    String name = tokens.get(open - 1);
+    if (!isWord(name.charAt(0)) || Character.isDigit(name.charAt(0)) ||
+        notNames.contains(name)) return -1;
+
+    // nothing in the return type but names, pointers, references and
+    // template arguments; a member's name or a variable's initializer
+    // has something else
+    for (int i = start; i < open - 1; i++) {
+      String token = tokens.get(i);
+      char c = token.charAt(0);
+      if (isWord(c)) continue;
+      if (token.equals("::") && i < open - 2) continue;
+      if ("*&<>,[]".indexOf(c) == -1) return -1;
+    }
+    for (int i = open + 1; i < n - 1; i++) {
+      String token = tokens.get(i);
+      if (token.equals("\"") || token.equals("'")) {
+        // a literal as a default is fine, as a parameter it is not one
+        if (!defaulted(tokens, open, i)) return -1;
+      }
+    }
+    return open;
+  }
+
+
+  // whether token i is in a default argument
+  static private boolean defaulted(List<String> tokens, int open, int i) {
+    for (i--; i > open; i--) {
+      String token = tokens.get(i);
+      if (token.equals("=")) return true;
+      if (token.equals(",")) return false;
+    }
+    return false;
+  }
+
+
+  // the start of what follows a template header, or -1 if its '>' is
+  // missing
+  static private int afterTemplate(List<String> tokens) {
+    if (tokens.isEmpty() || !tokens.get(0).equals("template")) return 0;
+    if (tokens.size() < 2 || !tokens.get(1).equals("<")) return -1;
+    int angles = 0;
+    for (int i = 1; i < tokens.size(); i++) {
+      String token = tokens.get(i);
+      if (token.equals("<")) {
+        angles++;
+      } else if (token.equals(">") && --angles == 0) {
+        return i + 1;
+      }
+    }
+    return -1;
+  }
+
+
+  /**
+   * The prototype for the function whose signature tokens are, or null if
+   * they are not one.
+   */
+  static private String signature(List<String> tokens) {
+    int start = afterTemplate(tokens);
+    if (start < 0) return null;
+    int open = parameters(tokens, start);
+    if (open < 0) return null;
+
+    StringBuffer prototype = new StringBuffer();
+    for (int i = 0; i <= open; i++) {
+      append(prototype, tokens.get(i));
+    }
+
+    // the parameters, but not their defaults
+    int nesting = 0;
+    boolean skipping = false;
+    for (int i = open + 1; i < tokens.size() - 1; i++) {
+      String token = tokens.get(i);
+      if (token.equals("(") || token.equals("[")) {
+        nesting++;
+      } else if (token.equals(")") || token.equals("]")) {
+        nesting--;
+      } else if (nesting == 0 && token.equals("=")) {
+        skipping = true;
+      } else if (nesting == 0 && token.equals(",")) {
+        skipping = false;
+      }
+      if (!skipping) append(prototype, token);
+    }
+    append(prototype, ")");
+    prototype.append(';');
+    return prototype.toString();
+  }
+
+
+  // tokens joined with a space between two words, after a comma and
+  // before a pointer or reference, and nowhere else
+  static private void append(StringBuffer s, String token) {
+    if (s.length() > 0) {
+      char last = s.charAt(s.length() - 1);
+      char first = token.charAt(0);
+      if (last == ',' ||
+          (isWord(last) && (isWord(first) || first == '*' || first == '&')) ||
+          (last == '>' && (isWord(first) || first == '>'))) {
+        s.append(' ');
+      }
+    }
+    s.append(token);
+  }
+
+
+  static private String name(List<String> tokens) {
+    return tokens.get(parameters(tokens, afterTemplate(tokens)) - 1);
+  }
+
+
+  // void f() or void f(void), with nothing but static or inline before
+  static private boolean isVoidFunction(List<String> tokens) {
+    int open = parameters(tokens, 0);
+    if (open < 0 || !tokens.get(open - 2).equals("void")) return false;
+    for (int i = 0; i < open - 2; i++) {
+      String token = tokens.get(i);
+      if (!token.equals("static") && !token.equals("inline")) return false;
+    }
+    int params = tokens.size() - open - 2;
+    return params == 0 ||
+      (params == 1 && tokens.get(open + 1).equals("void"));
+  }
+}
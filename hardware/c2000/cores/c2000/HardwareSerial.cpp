@@ -40,31 +40,8 @@
 
 HardwareSerial *SerialPtr;
 
-#define SERIAL_BUFFER_SIZE 16
-
-struct ring_buffer
-{
-	unsigned char buffer[SERIAL_BUFFER_SIZE];
-	volatile unsigned int head;
-	volatile unsigned int tail;
-};
-
-ring_buffer rx_buffer  =  { { 0 }, 0, 0 };
-ring_buffer tx_buffer  =  { { 0 }, 0, 0 };
-
-inline void store_char(unsigned char c, ring_buffer *buffer)
-{
-	unsigned int i = (unsigned int)(buffer->head + 1) % SERIAL_BUFFER_SIZE;
-
-	// if we should be storing the received character into the location
-	// just before the tail (meaning that the head would advance to the
-	// current location of the tail), we're about to overflow the buffer
-	// and so we don't write the character or advance the head.
-	if (i != buffer->tail) {
-		buffer->buffer[buffer->head] = c;
-		buffer->head = i;
-	}
-}
+ring_buffer rx_buffer;
+ring_buffer tx_buffer;
 
 void serialEvent();
 
@@ -193,9 +170,9 @@ void HardwareSerial::begin(unsigned long baud)
 void HardwareSerial::end()
 {
 	// wait for transmission of outgoing data
-	while (_tx_buffer->head != _tx_buffer->tail);
+	while (!_tx_buffer->empty());
 
-	_rx_buffer->head = _rx_buffer->tail;
+	_rx_buffer->clear();
 
 	// Disable the FIFO interrupts
 	SciaRegs.SCIFFTX.bit.TXFFIENA = 0;
@@ -205,7 +182,7 @@ void HardwareSerial::end()
 
 int HardwareSerial::available(void)
 {
-	return (unsigned int)(SERIAL_BUFFER_SIZE + _rx_buffer->head - _rx_buffer->tail) % SERIAL_BUFFER_SIZE;
+	return _rx_buffer->available();
 }
 
 HardwareSerial::operator bool()
@@ -215,41 +192,25 @@ HardwareSerial::operator bool()
 
 int HardwareSerial::peek(void)
 {
-	if (_rx_buffer->head == _rx_buffer->tail) {
-		return -1;
-	} else {
-		return _rx_buffer->buffer[_rx_buffer->tail];
-	}
+	return _rx_buffer->peek();
 }
 
 int HardwareSerial::read(void)
 {
-	// if the head isn't ahead of the tail, we don't have any characters
-	if (_rx_buffer->head == _rx_buffer->tail) {
-		return -1;
-	} else {
-		unsigned char c = _rx_buffer->buffer[_rx_buffer->tail];
-		_rx_buffer->tail = (unsigned int)(_rx_buffer->tail + 1) % SERIAL_BUFFER_SIZE;
-		return c;
-	}
+	return _rx_buffer->pop();
 }
 
 void HardwareSerial::flush()
 {
-	while (_tx_buffer->head != _tx_buffer->tail);
+	while (!_tx_buffer->empty());
 }
 
 size_t HardwareSerial::write(uint8_t c)
 {
-	unsigned int i = (_tx_buffer->head + 1) % SERIAL_BUFFER_SIZE;
-
 	// If the output buffer is full, there's nothing for it other than to
 	// wait for the interrupt handler to empty it a bit
 	// return 0 here instead?
-	while (i == _tx_buffer->tail);
-
-	_tx_buffer->buffer[_tx_buffer->head] = c;
-	_tx_buffer->head = i;
+	while (!_tx_buffer->push(c));
 
 	//SciaRegs.SCICTL2.bit.TXINTENA =1;
 	SciaRegs.SCIFFTX.bit.TXFFIENA = 1;
@@ -262,7 +223,8 @@ size_t HardwareSerial::write(uint8_t c)
 interrupt void uart_rx_isr(void)
 {
 	unsigned char c = SciaRegs.SCIRXBUF.all;
-	store_char(c, &rx_buffer);
+	// if the buffer is full the character is dropped
+	rx_buffer.push(c);
 
 	SciaRegs.SCIFFRX.bit.RXFFOVRCLR=1;   // Clear Overflow flag
     SciaRegs.SCIFFRX.bit.RXFFINTCLR=1;   // Clear Interrupt flag
@@ -273,7 +235,7 @@ interrupt void uart_rx_isr(void)
 
 interrupt void uart_tx_isr(void)
 {
-	if (tx_buffer.head == tx_buffer.tail) {
+	if (tx_buffer.empty()) {
 		// Buffer empty, so disable interrupts
 		//SciaRegs.SCICTL2.bit.TXINTENA =0;
 		SciaRegs.SCIFFTX.bit.TXFFIENA = 0;
@@ -282,8 +244,7 @@ interrupt void uart_tx_isr(void)
 		return;
 	}
 
-	unsigned char c = tx_buffer.buffer[tx_buffer.tail];
-	tx_buffer.tail = (tx_buffer.tail + 1) % SERIAL_BUFFER_SIZE;
+	unsigned char c = tx_buffer.pop();
 #ifdef TMS320F28377S
 	SciaRegs.SCITXBUF.all = c;
 #else
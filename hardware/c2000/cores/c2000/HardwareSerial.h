@@ -33,8 +33,11 @@
 #include <inttypes.h>
 
 #include "Stream.h"
+#include "RingBuffer.h"
 
-struct ring_buffer;
+#define SERIAL_BUFFER_SIZE 16
+
+typedef RingBuffer<SERIAL_BUFFER_SIZE> ring_buffer;
 
 class HardwareSerial : public Stream
 {
@@ -22,6 +22,7 @@
 
 #include <inttypes.h>
 #include <stdio.h> // for size_t
+#include <stdarg.h>
 
 #include "WString.h"
 #include "Printable.h"
@@ -82,6 +83,14 @@ class Print
     size_t println(double, int = 2);
     size_t println(const Printable&);
     size_t println(void);
+
+    // Formatted output without the C library's vfprintf. Supports the
+    // flags -, 0, + and space, width and precision (also as *), the h and
+    // l length modifiers, and the conversions d i u o x X p c s f F %.
+    // Others are printed as they are, their argument skipped.
+    // Floats are printed with at most 20 fraction digits.
+    size_t printf(const char *format, ...);
+    size_t vprintf(const char *format, va_list ap);
 };
 
 #endif
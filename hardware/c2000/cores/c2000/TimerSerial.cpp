@@ -32,8 +32,6 @@
 #include "Energia.h"
 #include "TimerSerial.h"
 
-#define SERIAL_BUFFER_SIZE 16
-
 #ifdef TMS320F28377S
 #define DISABLE_EXTERNAL1_INTERRUPT( )  XintRegs.XINT1CR.bit.ENABLE = 0
 #define ENABLE_EXTERNAL1_INTERRUPT( )   XintRegs.XINT1CR.bit.ENABLE = 1
@@ -43,12 +41,6 @@
 #endif
 #define ENABLE_TIMER_INTERRUPT( )       CpuTimer0Regs.TCR.bit.TIE = 1
 #define DISABLE_TIMER_INTERRUPT( )      CpuTimer0Regs.TCR.bit.TIE = 0
-struct ring_buffer_ts
-{
-    volatile unsigned int head;
-    volatile unsigned int tail;
-    unsigned char buffer[SERIAL_BUFFER_SIZE];
-};
 
 /**
  * uint8x2_t - optimized structure storage for ISR. Fits our static variables in one register
@@ -90,7 +82,7 @@ struct CPUTIMER_VARS CpuTimer0;
 #endif
 
 //static ring_buffer_ts timer_rx_buffer
-ring_buffer_ts timer_rx_buffer =  {  0, 0, { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 } }; //this rx_buffer is different as the one in the HardwareSerial
+ring_buffer_ts timer_rx_buffer; //this rx_buffer is different as the one in the HardwareSerial
  	 	 	 	 	 	 	 	 	 	 	 	 	 	 	 	 	 	 	 	   //in the Expressions window, the address should be 0x8c56
 
 #if NEEDS_BUFF_PTR
@@ -251,23 +243,12 @@ void TimerSerial::end()
 
 int TimerSerial::read()
 {
-    register uint16_t temp_tail=timer_rx_buffer.tail;
-
-    if (timer_rx_buffer.head != temp_tail) {
-        uint8_t c = timer_rx_buffer.buffer[temp_tail++];
-        timer_rx_buffer.tail = temp_tail % SERIAL_BUFFER_SIZE;
-        return c;
-    }
-    else {
-        return -1;
-    }
+    return timer_rx_buffer.pop();
 }
 
 int TimerSerial::available()
 {
-    unsigned cnt = (timer_rx_buffer.head - timer_rx_buffer.tail) % SERIAL_BUFFER_SIZE;
-
-    return cnt;
+    return timer_rx_buffer.available();
 }
 
 void TimerSerial::flush()
@@ -280,14 +261,7 @@ void TimerSerial::flush()
 
 int TimerSerial::peek()
 {
-    register uint16_t temp_tail=timer_rx_buffer.tail;
-
-    if (timer_rx_buffer.head != temp_tail) {
-        return timer_rx_buffer.buffer[temp_tail];
-    }
-    else {
-        return -1;
-    }
+    return timer_rx_buffer.peek();
 }
 
 size_t TimerSerial::write(uint8_t c)
@@ -310,15 +284,8 @@ size_t TimerSerial::write(uint8_t c)
 }
 
 
-#define store_rxchar(c) { \
-    register unsigned int next_head;\
-    next_head = timer_rx_buffer.head;\
-    timer_rx_buffer.buffer[next_head++]=c; \
-    next_head %= SERIAL_BUFFER_SIZE; \
-    if ( next_head != timer_rx_buffer.tail ) { \
-        timer_rx_buffer.head = next_head; \
-    } \
-}
+// a character arriving to a full buffer is dropped
+#define store_rxchar(c) timer_rx_buffer.push(c)
 
 
 interrupt void xint1_isr(void)
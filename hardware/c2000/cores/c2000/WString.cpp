@@ -51,6 +51,12 @@ String::String(StringSumHelper &&rval)
 }
 #endif
 
+String::String(StringSumHelper &rval)
+{
+	init();
+	move(rval);
+}
+
 String::String(char c)
 {
 	init();
@@ -105,7 +111,7 @@ String::String(unsigned long value, unsigned char base)
 
 String::~String()
 {
-	free(buffer);
+	if (buffer != sso) free(buffer);
 }
 
 /*********************************************/
@@ -122,7 +128,7 @@ inline void String::init(void)
 
 void String::invalidate(void)
 {
-	if (buffer) free(buffer);
+	if (buffer != sso) free(buffer);
 	buffer = NULL;
 	capacity = len = 0;
 }
@@ -139,14 +145,30 @@ unsigned char String::reserve(unsigned int size)
 
 unsigned char String::changeBuffer(unsigned int maxStrLen)
 {
-	//char *newbuffer = (char *)realloc(buffer, maxStrLen + 1);
-	char *newbuffer = (char *)malloc(maxStrLen + 1);
+	// Short strings stay in the object until they outgrow it
+	if (maxStrLen < STRING_SSO_SIZE && (!buffer || buffer == sso)) {
+		buffer = sso;
+		capacity = STRING_SSO_SIZE - 1;
+		return 1;
+	}
+
+	// Growing by half again makes repeated concat() amortized O(1); when
+	// memory is tight, fall back to the exact size
+	unsigned int size = maxStrLen;
+	if (buffer && size < capacity + capacity / 2) size = capacity + capacity / 2;
+	char *newbuffer = (char *)malloc(size + 1);
+	if (!newbuffer && size > maxStrLen) {
+		size = maxStrLen;
+		newbuffer = (char *)malloc(size + 1);
+	}
 
 	if (newbuffer) {
-		strncpy(newbuffer, buffer, len);
-		free(buffer);
+		if (buffer) {
+			memcpy(newbuffer, buffer, len + 1);
+			if (buffer != sso) free(buffer);
+		}
 		buffer = newbuffer;
-		capacity = maxStrLen;
+		capacity = size;
 		return 1;
 	}
 	return 0;
@@ -163,31 +185,24 @@ String & String::copy(const char *cstr, unsigned int length)
 		return *this;
 	}
 	len = length;
-	strcpy(buffer, cstr);
+	memcpy(buffer, cstr, length);
+	buffer[length] = 0;
 	return *this;
 }
 
-#ifdef __GXX_EXPERIMENTAL_CXX0X__
 void String::move(String &rhs)
 {
-	if (buffer) {
-		if (capacity >= rhs.len) {
-			strcpy(buffer, rhs.buffer);
-			len = rhs.len;
-			rhs.len = 0;
-			return;
-		} else {
-			free(buffer);
-		}
+	if (rhs.buffer == rhs.sso) {
+		// Nothing to take over, the characters live in rhs itself
+		copy(rhs.buffer, rhs.len);
+	} else {
+		if (buffer != sso) free(buffer);
+		buffer = rhs.buffer;
+		capacity = rhs.capacity;
+		len = rhs.len;
 	}
-	buffer = rhs.buffer;
-	capacity = rhs.capacity;
-	len = rhs.len;
-	rhs.buffer = NULL;
-	rhs.capacity = 0;
-	rhs.len = 0;
+	rhs.init();
 }
-#endif
 
 String & String::operator = (const String &rhs)
 {
@@ -213,6 +228,12 @@ String & String::operator = (StringSumHelper &&rval)
 }
 #endif
 
+String & String::operator = (StringSumHelper &rval)
+{
+	if (this != &rval) move(rval);
+	return *this;
+}
+
 String & String::operator = (const char *cstr)
 {
 	if (cstr) copy(cstr, strlen(cstr));
@@ -235,9 +256,17 @@ unsigned char String::concat(const char *cstr, unsigned int length)
 	unsigned int newlen = len + length;
 	if (!cstr) return 0;
 	if (length == 0) return 1;
-	if (!reserve(newlen)) return 0;
-	strcpy(buffer + len, cstr);
+	if (buffer && cstr >= buffer && cstr <= buffer + len) {
+		// Appending part of ourselves; the buffer may move
+		unsigned int offset = cstr - buffer;
+		if (!reserve(newlen)) return 0;
+		cstr = buffer + offset;
+	} else if (!reserve(newlen)) {
+		return 0;
+	}
+	memcpy(buffer + len, cstr, length);
 	len = newlen;
+	buffer[len] = 0;
 	return 1;
 }
 
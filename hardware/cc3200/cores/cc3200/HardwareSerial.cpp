@@ -48,11 +48,7 @@
 #include "driverlib/systick.h"
 #include "HardwareSerial.h"
 
-#define TX_BUFFER_EMPTY    (txReadIndex == txWriteIndex)
-#define TX_BUFFER_FULL     (((txWriteIndex + 1) % txBufferSize) == txReadIndex)
-
-#define RX_BUFFER_EMPTY    (rxReadIndex == rxWriteIndex)
-#define RX_BUFFER_FULL     (((rxWriteIndex + 1) % rxBufferSize) == rxReadIndex)
+#define TX_BUFFER_EMPTY    (txBuffer.empty())
 
 #define UART_BASE g_ulUARTBase[uartModule]
 
@@ -109,30 +105,12 @@ void (*g_UARTIntHandlers[2])(void) =
 // Constructors ////////////////////////////////////////////////////////////////
 HardwareSerial::HardwareSerial(void)
 {
-	txWriteIndex = 0;
-	txReadIndex = 0;
-	rxWriteIndex = 0;
-	rxReadIndex = 0;
 	uartModule = 0;
-
-//	txBuffer = (unsigned char *) 0xFFFFFFFF;
-//	rxBuffer = (unsigned char *) 0xFFFFFFFF;
-	txBufferSize = SERIAL_BUFFER_SIZE;
-	rxBufferSize = SERIAL_BUFFER_SIZE;
 }
 
 HardwareSerial::HardwareSerial(unsigned long module) 
 {
-	txWriteIndex = 0;
-	txReadIndex = 0;
-	rxWriteIndex = 0;
-	rxReadIndex = 0;
 	uartModule = module;
-
-	//txBuffer = (unsigned char *) 0xFFFFFFFF;
-	//rxBuffer = (unsigned char *) 0xFFFFFFFF;
-	txBufferSize = SERIAL_BUFFER_SIZE;
-	rxBufferSize = SERIAL_BUFFER_SIZE;
 }
 
 // Private Methods //////////////////////////////////////////////////////////////
@@ -142,12 +120,8 @@ HardwareSerial::flushAll(void)
 	/* wait for transmission of outgoing data */
 	while(!TX_BUFFER_EMPTY){}
 
-	txReadIndex = 0;
-	txWriteIndex = 0;
-
 	/* Flush the receive buffer. */
-	rxReadIndex = 0;
-	rxWriteIndex = 0;
+	rxBuffer.clear();
 }
 
 void
@@ -160,13 +134,11 @@ HardwareSerial::primeTransmit(unsigned long ulBase)
 		while(!TX_BUFFER_EMPTY){
 			if (MAP_UARTSpaceAvail(ulBase)) {
 				/* Disable TX IRQ while stuffing the FIFO to avoid a race condition
-				/* on the txReadIndex variable
+				/* on the read index of txBuffer
 				 */
 				MAP_UARTIntDisable(UART_BASE, UART_INT_TX);
 				while(MAP_UARTSpaceAvail(ulBase) && !TX_BUFFER_EMPTY){
-					MAP_UARTCharPutNonBlocking(ulBase, txBuffer[txReadIndex]);
-
-					txReadIndex = (txReadIndex + 1) % txBufferSize;
+					MAP_UARTCharPutNonBlocking(ulBase, txBuffer.pop());
 				}
 				MAP_UARTIntEnable(UART_BASE, UART_INT_TX);
 			}
@@ -232,33 +204,18 @@ void HardwareSerial::end()
 
 int HardwareSerial::available(void)
 {
-	return (rxWriteIndex >= rxReadIndex) ?
-		(rxWriteIndex - rxReadIndex) : rxBufferSize - (rxReadIndex - rxWriteIndex);
+	return rxBuffer.available();
 }
 
 int HardwareSerial::peek(void)
 {
-	unsigned char cChar = 0;
-
-	if(RX_BUFFER_EMPTY) {
-		return -1;
-	}
-
-	/* Read a character from the buffer. */
-	cChar = rxBuffer[rxReadIndex];
-
-	/* Return the character to the caller. */
-	return cChar;
+	/* Next character without removing it, or -1 if the buffer is empty. */
+	return rxBuffer.peek();
 }
 
 int HardwareSerial::read(void)
 {
-	int iChar = peek();
-	if (iChar < 0)
-		return iChar;
-
-	rxReadIndex = ((rxReadIndex) + 1) % rxBufferSize;
-	return iChar;
+	return rxBuffer.pop();
 }
 
 void HardwareSerial::flush()
@@ -279,10 +236,7 @@ size_t HardwareSerial::write(uint8_t c)
 	ASSERT(c != 0);
 
 	/* Send the character to the UART output. */
-	while (TX_BUFFER_FULL);
-
-	txBuffer[txWriteIndex] = c;
-	txWriteIndex = (txWriteIndex + 1) % txBufferSize;
+	while (!txBuffer.push(c));
 	numTransmit ++;
 
 	/* If we have anything in the buffer, make sure that the UART is set
@@ -324,11 +278,7 @@ void HardwareSerial::UARTIntHandler(void)
 
 			/* If there is space in the receive buffer, put the character
 			 * there, otherwise throw it away. */
-			uint8_t volatile full = RX_BUFFER_FULL;
-			if(full) break;
-
-			rxBuffer[rxWriteIndex] = (unsigned char)(lChar & 0xFF);
-			rxWriteIndex = ((rxWriteIndex) + 1) % rxBufferSize;
+			if(!rxBuffer.push((unsigned char)(lChar & 0xFF))) break;
 		}
 	}
 }
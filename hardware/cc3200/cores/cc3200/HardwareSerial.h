@@ -35,20 +35,15 @@
 
 #include <inttypes.h>
 #include "Stream.h"
+#include "RingBuffer.h"
 
 #define SERIAL_BUFFER_SIZE 256
 
 class HardwareSerial : public Stream
 {
 	private:
-		unsigned char txBuffer[SERIAL_BUFFER_SIZE];
-		unsigned long txBufferSize;
-		unsigned long txWriteIndex;
-		unsigned long txReadIndex;
-		unsigned char rxBuffer[SERIAL_BUFFER_SIZE];
-		unsigned long rxBufferSize;
-		unsigned long rxWriteIndex;
-		unsigned long rxReadIndex;
+		RingBuffer<SERIAL_BUFFER_SIZE> txBuffer;
+		RingBuffer<SERIAL_BUFFER_SIZE> rxBuffer;
 		unsigned long uartModule;
 		unsigned long baudRate;
 		void flushAll(void);
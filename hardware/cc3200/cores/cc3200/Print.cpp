@@ -23,10 +23,267 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <float.h>
 #include <math.h>
 #include "Energia.h"
 #include "Print.h"
 
+// Number formatting ///////////////////////////////////////////////////////////
+//
+// Numbers are rendered into a buffer on the stack and go out with a single
+// write(buf, len). Floats are converted from their binary representation
+// with integer arithmetic only, so the result is exact and correctly
+// rounded (halves away from zero) without any floating point operations.
+
+// An unsigned long in base 2, plus a sign
+#define NUMBER_BUFFER (CHAR_BIT * sizeof(long) + 1)
+// Fraction digits a float is printed with at most
+#define FLOAT_DIGITS 20
+// Sign, 10 integer digits, '.' and the fraction digits
+#define FLOAT_BUFFER (FLOAT_DIGITS + 12)
+
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Renders n right to left, ending just before end; returns the first digit
+static char *formatNumber(char *end, unsigned long n, uint8_t base)
+{
+    if (base == 10) {
+        // Two digits per division
+        while (n >= 100) {
+            unsigned long q = n / 100;
+            const char *pair = &digitPairs[2 * (unsigned int)(n - 100 * q)];
+
+            *--end = pair[1];
+            *--end = pair[0];
+            n = q;
+        }
+        if (n >= 10) {
+            *--end = digitPairs[2 * n + 1];
+            *--end = digitPairs[2 * n];
+        } else {
+            *--end = '0' + n;
+        }
+    } else if ((base & (base - 1)) == 0) {
+        // Powers of two need no division at all
+        unsigned int shift = 1;
+
+        while ((1U << shift) != base)
+            shift++;
+        do {
+            unsigned int c = n & (base - 1);
+
+            *--end = c < 10 ? c + '0' : c + 'A' - 10;
+            n >>= shift;
+        } while (n);
+    } else {
+        do {
+            unsigned long m = n;
+            n /= base;
+            unsigned int c = m - base * n;
+
+            *--end = c < 10 ? c + '0' : c + 'A' - 10;
+        } while (n);
+    }
+    return end;
+}
+
+enum FloatKind { FLOAT_FINITE, FLOAT_INFINITE, FLOAT_NAN };
+
+// Splits number into its sign and mantissa * 2^exponent
+static FloatKind splitFloat(float number, bool *negative,
+        uint64_t *mantissa, int *exponent)
+{
+    uint32_t bits;
+    unsigned int biased;
+
+    memcpy(&bits, &number, sizeof(bits));
+    biased = (bits >> 23) & 0xff;
+    *mantissa = bits & 0x7fffff;
+    *negative = (bits >> 31) && (biased || *mantissa);
+    if (biased == 0xff)
+        return *mantissa ? FLOAT_NAN : FLOAT_INFINITE;
+    if (biased) {
+        *mantissa |= 0x800000;
+        *exponent = (int)biased - 150;
+    } else {
+        *exponent = -149;
+    }
+    return FLOAT_FINITE;
+}
+
+static FloatKind splitFloat(double number, bool *negative,
+        uint64_t *mantissa, int *exponent)
+{
+#if DBL_MANT_DIG == FLT_MANT_DIG
+    return splitFloat((float)number, negative, mantissa, exponent);
+#else
+    uint64_t bits;
+    unsigned int biased;
+
+    memcpy(&bits, &number, sizeof(bits));
+    biased = (bits >> 52) & 0x7ff;
+    *mantissa = bits & 0xfffffffffffffULL;
+    *negative = (bits >> 63) && (biased || *mantissa);
+    if (biased == 0x7ff)
+        return *mantissa ? FLOAT_NAN : FLOAT_INFINITE;
+    if (biased) {
+        *mantissa |= 0x10000000000000ULL;
+        *exponent = (int)biased - 1075;
+    } else {
+        *exponent = -1074;
+    }
+    return FLOAT_FINITE;
+#endif
+}
+
+// Renders mantissa * 2^exponent with the given number of fraction digits;
+// returns the length. Integer parts beyond 32 bits print as "ovf".
+static size_t formatFloat(char *buf, FloatKind kind, bool negative,
+        uint64_t mantissa, int exponent, uint8_t digits)
+{
+    char *p = buf;
+    char *first;
+    uint32_t whole;
+    uint64_t fraction;      // in units of 2^-shift
+    uint64_t low = 0;       // the 64 bits below it once shift is 60
+    unsigned int shift;
+    bool roundUp = false;
+
+    if (kind != FLOAT_FINITE) {
+        memcpy(buf, kind == FLOAT_NAN ? "nan" : "inf", 3);
+        return 3;
+    }
+    if (digits > FLOAT_DIGITS)
+        digits = FLOAT_DIGITS;
+
+    if (exponent >= 0) {
+        if (exponent >= 32 || mantissa >> (32 - exponent))
+            goto overflow;
+        whole = (uint32_t)mantissa << exponent;
+        fraction = 0;
+        shift = 0;
+    } else {
+        shift = -exponent;
+        if (shift < 64) {
+            if (mantissa >> shift >> 32)
+                goto overflow;
+            whole = mantissa >> shift;
+            fraction = mantissa & ((1ULL << shift) - 1);
+        } else {
+            whole = 0;
+            fraction = mantissa;
+        }
+        // Keep four bits of headroom for the multiplications by ten. The
+        // bits shifted out go on in low, down to 2^-124; a value that has
+        // any below that is under 2^-72, which neither shows in FLOAT_DIGITS
+        // digits nor rounds them up.
+        if (shift > 60) {
+            unsigned int drop = shift - 60;
+
+            if (drop < 64) {
+                low = fraction << (64 - drop);
+                fraction >>= drop;
+            } else {
+                low = drop - 64 < 64 ? fraction >> (drop - 64) : 0;
+                fraction = 0;
+            }
+            shift = 60;
+        }
+    }
+
+    if (negative)
+        *p++ = '-';
+    first = p;
+    {
+        char digitBuf[10];
+        char *end = digitBuf + sizeof(digitBuf);
+        char *d = formatNumber(end, whole, 10);
+
+        memcpy(p, d, end - d);
+        p += end - d;
+    }
+    if (digits)
+        *p++ = '.';
+
+    // One digit per multiplication, in 32 bits while the fraction fits
+    if (shift <= 28) {
+        uint32_t f = (uint32_t)fraction;
+        uint32_t mask = (1UL << shift) - 1;
+
+        while (digits--) {
+            f *= 10;
+            *p++ = '0' + (f >> shift);
+            f &= mask;
+        }
+        roundUp = shift && f >> (shift - 1);
+    } else {
+        uint64_t f = fraction;
+        uint64_t mask = (1ULL << shift) - 1;
+
+        while (digits--) {
+            if (low) {
+                // Ten times low in 32 bit halves, carrying into f
+                uint64_t high = (low >> 32) * 10;
+                uint64_t part = (low & 0xffffffff) * 10;
+                uint64_t mid = (high & 0xffffffff) + (part >> 32);
+
+                low = mid << 32 | (part & 0xffffffff);
+                f = f * 10 + (high >> 32) + (mid >> 32);
+            } else {
+                f *= 10;
+            }
+            *p++ = '0' + (unsigned int)(f >> shift);
+            f &= mask;
+        }
+        roundUp = f >> (shift - 1) != 0;
+    }
+
+    if (roundUp) {
+        char *q = p;
+
+        while (q > first) {
+            if (*--q == '.')
+                continue;
+            if (*q != '9') {
+                (*q)++;
+                return p - buf;
+            }
+            *q = '0';
+        }
+        // Carried out of the integer part: 9.99 became 10.00
+        memmove(first + 1, first, p - first);
+        *first = '1';
+        p++;
+    }
+    return p - buf;
+
+overflow:
+    memcpy(buf, "ovf", 3);
+    return 3;
+}
+
+template <typename T>
+static size_t formatFloat(char *buf, T number, uint8_t digits)
+{
+    bool negative;
+    uint64_t mantissa;
+    int exponent = 0;
+    FloatKind kind = splitFloat(number, &negative, &mantissa, &exponent);
+
+    return formatFloat(buf, kind, negative, mantissa, exponent, digits);
+}
+
 // Public Methods //////////////////////////////////////////////////////////////
 
 /* default implementation: may be overridden */
@@ -78,13 +335,13 @@ size_t Print::print(long n, int base)
 {
     if (base == 0) {
         return write(n);
-    } else if (base == 10) {
-        if (n < 0) {
-            int t = print('-');
-            n = -n;
-            return printNumber(n, 10) + t;
-        }
-        return printNumber(n, 10);
+    } else if (base == 10 && n < 0) {
+        char buf[NUMBER_BUFFER];
+        char *end = buf + sizeof(buf);
+        char *str = formatNumber(end, 0UL - (unsigned long)n, 10);
+
+        *--str = '-';
+        return write((const uint8_t *)str, end - str);
     } else {
         return printNumber(n, base);
     }
@@ -202,103 +459,283 @@ size_t Print::println(const Printable& x)
     return n;
 }
 
-// Private Methods /////////////////////////////////////////////////////////////
-
-size_t Print::printNumber(unsigned long n, uint8_t base) {
-    char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
-    char *str = &buf[sizeof(buf) - 1];
-
-    *str = '\0';
+size_t Print::printf(const char *format, ...)
+{
+    va_list ap;
+    size_t n;
 
-    // prevent crash if called with base == 1
-    if (base < 2) base = 10;
+    va_start(ap, format);
+    n = vprintf(format, ap);
+    va_end(ap);
+    return n;
+}
 
-    do {
-        unsigned long m = n;
-        n /= base;
-        char c = m - base * n;
-        *--str = c < 10 ? c + '0' : c + 'A' - 10;
-    } while(n);
+// printf() output is collected here and sent in chunks
+struct PrintfBuffer
+{
+    Print *out;
+    size_t written;
+    size_t len;
+    char buf[32];
 
-    return write(str);
-}
+    void flush()
+    {
+        if (len)
+            written += out->write((const uint8_t *)buf, len);
+        len = 0;
+    }
 
-size_t Print::printFloat(double number, uint8_t digits) 
-{ 
-    size_t n = 0;
+    void put(const char *str, size_t n)
+    {
+        while (n) {
+            size_t chunk = sizeof(buf) - len;
+
+            if (chunk > n)
+                chunk = n;
+            memcpy(buf + len, str, chunk);
+            len += chunk;
+            str += chunk;
+            n -= chunk;
+            if (len == sizeof(buf))
+                flush();
+        }
+    }
 
-    // Handle negative numbers
-    if (number < 0.0)
+    void pad(char c, int n)
     {
-        n += print('-');
-        number = -number;
+        while (n-- > 0) {
+            buf[len++] = c;
+            if (len == sizeof(buf))
+                flush();
+        }
     }
+};
 
-    // Round correctly so that print(1.999, 2) prints as "2.00"
-    double rounding = 0.5;
-    for (uint8_t i=0; i<digits; ++i)
-        rounding /= 10.0;
+size_t Print::vprintf(const char *format, va_list ap)
+{
+    PrintfBuffer out;
+
+    out.out = this;
+    out.written = 0;
+    out.len = 0;
+
+    while (*format) {
+        const char *spec = format;
+
+        while (*format && *format != '%')
+            format++;
+        out.put(spec, format - spec);
+        if (!*format)
+            break;
+        spec = format++;
+
+        bool left = false, zero = false;
+        char sign = 0;
+        for (;; format++) {
+            if (*format == '-')
+                left = true;
+            else if (*format == '0')
+                zero = true;
+            else if (*format == '+')
+                sign = '+';
+            else if (*format == ' ' && !sign)
+                sign = ' ';
+            else
+                break;
+        }
 
-    number += rounding;
+        int width = 0;
+        if (*format == '*') {
+            width = va_arg(ap, int);
+            if (width < 0) {
+                left = true;
+                width = -width;
+            }
+            format++;
+        } else {
+            while (*format >= '0' && *format <= '9')
+                width = width * 10 + *format++ - '0';
+        }
 
-    // Extract the integer part of the number and print it
-    unsigned long int_part = (unsigned long)number;
-    double remainder = number - (double)int_part;
-    n += print(int_part);
+        int precision = -1;
+        if (*format == '.') {
+            format++;
+            precision = 0;
+            if (*format == '*') {
+                precision = va_arg(ap, int);
+                format++;
+            } else {
+                while (*format >= '0' && *format <= '9')
+                    precision = precision * 10 + *format++ - '0';
+            }
+        }
 
-    // Print the decimal point, but only if there are digits beyond
-    if (digits > 0) {
-        n += print(".");
-    }
+        bool isLong = false, isLongLong = false, isLongDouble = false;
+        while (*format == 'h')
+            format++;
+        if (*format == 'l') {
+            isLong = true;
+            format++;
+            if (*format == 'l') {
+                isLongLong = true;
+                format++;
+            }
+        } else if (*format == 'L') {
+            isLongDouble = true;
+            format++;
+        }
 
-    // Extract digits from the remainder one at a time
-    while (digits-- > 0)
-    {
-        remainder *= 10.0;
-        int toPrint = int(remainder);
-        n += print(toPrint);
-        remainder -= toPrint;
+        char buf[NUMBER_BUFFER > FLOAT_BUFFER ? NUMBER_BUFFER : FLOAT_BUFFER];
+        char *end = buf + sizeof(buf);
+        const char *body = 0;
+        size_t len = 0;
+        const char *prefix = "";
+        int zeros = 0;
+        bool number = true;
+
+        // long long and long double arguments go to the default case
+        switch (isLongLong || isLongDouble ? 0 : *format) {
+        case 'd':
+        case 'i': {
+            long v = isLong ? va_arg(ap, long) : va_arg(ap, int);
+            unsigned long u = v;
+
+            if (v < 0) {
+                u = 0UL - u;
+                prefix = "-";
+            } else if (sign) {
+                prefix = sign == '+' ? "+" : " ";
+            }
+            body = formatNumber(end, u, 10);
+            break;
+        }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'p': {
+            unsigned long u;
+            uint8_t base = *format == 'u' ? 10 : *format == 'o' ? 8 : 16;
+
+            if (*format == 'p') {
+                u = (uintptr_t)va_arg(ap, void *);
+                prefix = "0x";
+            } else {
+                u = isLong ? va_arg(ap, unsigned long) : va_arg(ap, unsigned int);
+            }
+            body = formatNumber(end, u, base);
+            if (*format == 'x' || *format == 'p') {
+                for (char *c = (char *)body; c < end; c++) {
+                    if (*c >= 'A')
+                        *c += 'a' - 'A';
+                }
+            }
+            break;
+        }
+        case 'f':
+        case 'F':
+            len = formatFloat(buf, va_arg(ap, double), precision < 0 ? 6 :
+                    precision > FLOAT_DIGITS ? FLOAT_DIGITS : precision);
+            body = buf;
+            if (*body == '-') {
+                prefix = "-";
+                body++;
+                len--;
+            } else if (sign) {
+                prefix = sign == '+' ? "+" : " ";
+            }
+            // No zero padding for "nan", "inf" and "ovf"
+            if (*body > '9')
+                zero = false;
+            precision = -1;
+            break;
+        case 'c':
+            buf[0] = (char)va_arg(ap, int);
+            body = buf;
+            len = 1;
+            number = false;
+            break;
+        case 's':
+            body = va_arg(ap, const char *);
+            if (!body)
+                body = "(null)";
+            for (len = 0; body[len] && (precision < 0 || (int)len < precision); len++)
+                ;
+            number = false;
+            break;
+        case '%':
+            out.put("%", 1);
+            format++;
+            continue;
+        default:
+            // Unsupported, printed as is. The argument of a conversion that
+            // takes one is still taken, so the ones after it line up.
+            if (*format && strchr("aAeEfFgG", *format)) {
+                if (isLongDouble)
+                    (void)va_arg(ap, long double);
+                else
+                    (void)va_arg(ap, double);
+            } else if (*format && strchr("diouxX", *format)) {
+                (void)va_arg(ap, long long);
+            } else if (*format == 'n') {
+                (void)va_arg(ap, void *);
+            }
+            if (*format)
+                format++;
+            out.put(spec, format - spec);
+            continue;
+        }
+        format++;
+
+        if (number && len == 0)
+            len = end - body;
+        // Integer precision is a minimum number of digits
+        if (number && precision >= 0) {
+            zeros = precision - (int)len;
+            zero = false;
+        }
+        int fill = width - (int)(strlen(prefix) + len) - (zeros > 0 ? zeros : 0);
+        if (zero && number && !left) {
+            zeros += fill;
+            fill = 0;
+        }
+        if (!left)
+            out.pad(' ', fill);
+        out.put(prefix, strlen(prefix));
+        out.pad('0', zeros);
+        out.put(body, len);
+        if (left)
+            out.pad(' ', fill);
     }
-
-    return n;
+    out.flush();
+    return out.written;
 }
 
-size_t Print::printFloat(float number, uint8_t digits)
-{
-    size_t n = 0;
+// Private Methods /////////////////////////////////////////////////////////////
 
-    // Handle negative numbers
-    if (number < 0.0)
-    {
-        n += print('-');
-        number = -number;
-    }
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+    char buf[NUMBER_BUFFER];
+    char *end = buf + sizeof(buf);
+    char *str;
 
-    // Round correctly so that print(1.999, 2) prints as "2.00"
-    float rounding = 0.5;
-    for (uint8_t i=0; i<digits; ++i)
-        rounding /= 10.0;
+    // prevent crash if called with base == 1
+    if (base < 2) base = 10;
 
-    number += rounding;
+    str = formatNumber(end, n, base);
+    return write((const uint8_t *)str, end - str);
+}
 
-    // Extract the integer part of the number and print it
-    unsigned long int_part = (unsigned long)number;
-    float remainder = number - (float)int_part;
-    n += print(int_part);
+size_t Print::printFloat(double number, uint8_t digits)
+{
+    char buf[FLOAT_BUFFER];
 
-    // Print the decimal point, but only if there are digits beyond
-    if (digits > 0) {
-        n += print(".");
-    }
+    return write((const uint8_t *)buf, formatFloat(buf, number, digits));
+}
 
-    // Extract digits from the remainder one at a time
-    while (digits-- > 0)
-    {
-        remainder *= 10.0;
-        int toPrint = int(remainder);
-        n += print(toPrint);
-        remainder -= toPrint;
-    }
+size_t Print::printFloat(float number, uint8_t digits)
+{
+    char buf[FLOAT_BUFFER];
 
-    return n;
+    return write((const uint8_t *)buf, formatFloat(buf, number, digits));
 }
@@ -0,0 +1,238 @@
+/*
+  RingBuffer.h - single producer / single consumer byte FIFO for the
+  serial drivers.
+
+  One side (typically an interrupt handler) only ever pushes, the other
+  only ever pops, so no locking is needed: each index is written by one
+  side only and the data is in place before the index that publishes it
+  moves. The indices run freely and are masked on access, which needs a
+  power-of-two size but no division and leaves all N bytes usable.
+
+  RingBuffer<N> holds its storage inline and has N fixed at compile time.
+  RingBuffer<0> works on storage handed to attach() at run time, whose
+  size is rounded down to a power of two.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef RingBuffer_h
+#define RingBuffer_h
+
+#include <string.h>
+
+// Keeps the compiler from moving buffer accesses across an index update
+#if defined(__GNUC__) && !defined(__TI_COMPILER_VERSION__)
+#define RINGBUFFER_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#else
+#define RINGBUFFER_BARRIER()
+#endif
+
+template <unsigned int N>
+class RingBufferStorage
+{
+	// Fails to compile unless N is a power of two
+	typedef char size_must_be_a_power_of_two[(N & (N - 1)) == 0 ? 1 : -1];
+
+	protected:
+		unsigned char _data[N];
+
+		unsigned char *data() { return _data; }
+		const unsigned char *data() const { return _data; }
+		static unsigned int size() { return N; }
+};
+
+template <>
+class RingBufferStorage<0>
+{
+	protected:
+		unsigned char *_data;
+		unsigned int _size;
+
+		RingBufferStorage() : _data(0), _size(0) {}
+
+		unsigned char *data() { return _data; }
+		const unsigned char *data() const { return _data; }
+		unsigned int size() const { return _size; }
+
+	public:
+		// Not safe against a running producer or consumer
+		void attach(unsigned char *storage, unsigned int len)
+		{
+			unsigned int size = len ? 1 : 0;
+
+			while (size && size <= len / 2)
+				size <<= 1;
+			_data = storage;
+			_size = size;
+		}
+};
+
+template <unsigned int N>
+class RingBuffer : public RingBufferStorage<N>
+{
+	public:
+		RingBuffer() : _head(0), _tail(0), _highWater(0) {}
+
+		unsigned int capacity() const { return this->size(); }
+		unsigned int available() const { return _head - _tail; }
+		unsigned int space() const { return this->size() - available(); }
+		bool empty() const { return _head == _tail; }
+		bool full() const { return available() == this->size(); }
+
+		// Most bytes ever held at once since the last resetHighWater()
+		unsigned int highWater() const { return _highWater; }
+		void resetHighWater() { _highWater = available(); }
+
+		//
+		// Producer side
+		//
+		bool push(unsigned char c)
+		{
+			unsigned int head = _head;
+
+			if (head - _tail == this->size())
+				return false;
+			this->data()[head & mask()] = c;
+			RINGBUFFER_BARRIER();
+			_head = head + 1;
+			updateHighWater(head + 1);
+			return true;
+		}
+
+		// Copies as much of buf as fits, in at most two pieces
+		unsigned int push(const unsigned char *buf, unsigned int len)
+		{
+			unsigned int head = _head;
+			unsigned int free = this->size() - (head - _tail);
+			unsigned int first;
+
+			if (len > free)
+				len = free;
+			first = this->size() - (head & mask());
+			if (first > len)
+				first = len;
+			memcpy(this->data() + (head & mask()), buf, first);
+			memcpy(this->data(), buf + first, len - first);
+			RINGBUFFER_BARRIER();
+			_head = head + len;
+			updateHighWater(head + len);
+			return len;
+		}
+
+		// Contiguous free space to fill in place; publish it with commit()
+		unsigned int writeSpan(unsigned char **span)
+		{
+			unsigned int head = _head;
+			unsigned int free = this->size() - (head - _tail);
+			unsigned int len = this->size() - (head & mask());
+
+			*span = this->data() + (head & mask());
+			return len < free ? len : free;
+		}
+
+		void commit(unsigned int len)
+		{
+			unsigned int head = _head + len;
+
+			RINGBUFFER_BARRIER();
+			_head = head;
+			updateHighWater(head);
+		}
+
+		//
+		// Consumer side
+		//
+		int peek() const
+		{
+			if (empty())
+				return -1;
+			return this->data()[_tail & mask()];
+		}
+
+		int pop()
+		{
+			unsigned int tail = _tail;
+			unsigned char c;
+
+			if (_head == tail)
+				return -1;
+			c = this->data()[tail & mask()];
+			RINGBUFFER_BARRIER();
+			_tail = tail + 1;
+			return c;
+		}
+
+		// Copies out up to len bytes, in at most two pieces
+		unsigned int pop(unsigned char *buf, unsigned int len)
+		{
+			unsigned int tail = _tail;
+			unsigned int used = _head - tail;
+			unsigned int first;
+
+			if (len > used)
+				len = used;
+			first = this->size() - (tail & mask());
+			if (first > len)
+				first = len;
+			memcpy(buf, this->data() + (tail & mask()), first);
+			memcpy(buf + first, this->data(), len - first);
+			RINGBUFFER_BARRIER();
+			_tail = tail + len;
+			return len;
+		}
+
+		// Contiguous queued bytes to read in place; release them with consume()
+		unsigned int readSpan(const unsigned char **span) const
+		{
+			unsigned int tail = _tail;
+			unsigned int used = _head - tail;
+			unsigned int len = this->size() - (tail & mask());
+
+			*span = this->data() + (tail & mask());
+			return len < used ? len : used;
+		}
+
+		void consume(unsigned int len)
+		{
+			RINGBUFFER_BARRIER();
+			_tail += len;
+		}
+
+		// Drops everything queued; consumer side only
+		void clear() { _tail = _head; }
+
+		// Empties the buffer and starts it over at the beginning of the
+		// storage, for a DMA engine filling it in place. Neither side may
+		// be running.
+		void reset() { _head = _tail = 0; _highWater = 0; }
+		unsigned char *buffer() { return this->data(); }
+
+	private:
+		volatile unsigned int _head;
+		volatile unsigned int _tail;
+		unsigned int _highWater;
+
+		unsigned int mask() const { return this->size() - 1; }
+
+		void updateHighWater(unsigned int head)
+		{
+			unsigned int used = head - _tail;
+
+			if (used > _highWater)
+				_highWater = used;
+		}
+};
+
+#endif
@@ -48,12 +48,49 @@ extern "C"{
 
 #define aJson_IsReference 128
 
+// aJsonPullParser events:
+#define aJson_Error -1
+#define aJson_End 0
+#define aJson_StartObject 1
+#define aJson_EndObject 2
+#define aJson_StartArray 3
+#define aJson_EndArray 4
+#define aJson_Key 5
+#define aJson_Value 6
+
+// aJsonPullParser limits: how deep objects and arrays may nest (at most
+// 32), and the longest path and key or string value it keeps, including
+// the terminating 0 (at most 255). Longer keys and strings are cut short.
+#ifndef aJson_MAX_DEPTH
+#define aJson_MAX_DEPTH 16
+#endif
+#ifndef aJson_PATH_SIZE
+#define aJson_PATH_SIZE 64
+#endif
+#ifndef aJson_TEXT_SIZE
+#define aJson_TEXT_SIZE 64
+#endif
+
+// Arrays and objects with at least this many items get a lookup index
+// the first time getArrayItem() or getObjectItem() has to walk that far,
+// so later ones no longer walk the list. The index is on the heap; 0
+// turns indexing off, as it is by default on MSP430.
+#ifndef aJson_INDEX_MIN
+#if defined(__MSP430__)
+#define aJson_INDEX_MIN 0
+#else
+#define aJson_INDEX_MIN 16
+#endif
+#endif
+
 #ifndef EOF
 #define EOF -1
 #endif
 
 #define PRINT_BUFFER_LEN 256
 
+struct aJsonIndex;
+
 // The aJson structure:
 typedef struct aJsonObject {
         char *name; // The item's name string, if this item is the child of, or is in the list of subitems of an object.
@@ -67,9 +104,42 @@ typedef struct aJsonObject {
 		char valuebool; //the items value for true & false
 		int valueint; // The item's value, if type==aJson_Int
 		double valuefloat; // The item's value, if type==aJson_Float
+		struct aJsonIndex *index; // The lookup index of an array or object, if it has one
 	};
 } aJsonObject;
 
+/* aJsonArena is a block of memory supplied by the caller that a parse can
+ * build its whole tree in, nodes and strings alike, instead of taking each
+ * one from the heap. Space is handed out in order from the start of the
+ * block and never given back piece by piece: reset() discards every tree
+ * parsed into the arena at once. A tree that lives in an arena must not be
+ * passed to aJson.deleteItem(), and items from the aJson.create*() calls
+ * attached to it are not freed by reset(). */
+class aJsonArena {
+public:
+	aJsonArena(void *buffer_, size_t size_)
+		: buffer((char *) buffer_), capacity(size_), top(0), high(0)
+		{}
+	/* Discard everything parsed into the arena. */
+	void reset() { top = 0; }
+	/* Bytes in use now, and the most ever in use since construction;
+	 * the latter is the size a buffer needs for the same documents. */
+	size_t used() { return top; }
+	size_t peak() { return high; }
+	size_t size() { return capacity; }
+
+private:
+	friend class aJsonStream;
+	friend class aJsonClass;
+	/* size bytes at the next multiple of align, NULL if they do not fit. */
+	void *allocate(size_t size, size_t align);
+
+	char *buffer;
+	size_t capacity;
+	size_t top;
+	size_t high;
+};
+
 /* aJsonStream is stream representation of aJson for its internal use;
  * it is meant to abstract out differences between Stream (e.g. serial
  * stream) and Client (which may or may not be connected) or provide even
@@ -77,7 +147,7 @@ typedef struct aJsonObject {
 class aJsonStream : public Print {
 public:
 	aJsonStream(Stream *stream_)
-		: stream_obj(stream_), bucket(EOF)
+		: stream_obj(stream_), bucket(EOF), arena(NULL)
 		{}
 	/* Use this to check if more data is available, as aJsonStream
 	 * can read some more data than really consumed and automatically
@@ -131,6 +201,15 @@ protected:
 	 * to be returned by next getch() - returned by a call
 	 * to ungetch(). */
 	int bucket;
+
+private:
+	friend class aJsonClass;
+	friend class aJsonPullParser;
+	/* New nodes for the tree being parsed: from the arena the stream is
+	 * parsing into, if any, otherwise from the heap. */
+	aJsonObject *newItem();
+
+	aJsonArena *arena;
 };
 
 /* JSON stream that consumes data from a connection (usually
@@ -171,6 +250,71 @@ private:
 	size_t inbuf_len, outbuf_len;
 };
 
+class aJsonPullParser;
+typedef void (*aJsonEventCallback)(aJsonPullParser *parser, int event, void *context);
+
+/* aJsonPullParser reads a JSON document from a stream one event at a time
+ * instead of building a tree of it: the start and end of every object and
+ * array, every key, and every other value. Its memory use is fixed by the
+ * limits above, so it reads documents of any size, as they arrive.
+ * Where in the document an event is comes from path(), e.g.
+ * "values[3].timestamp"; matches() compares it with a pattern in which
+ * a * stands for any key or index, e.g. "values[*].timestamp". */
+class aJsonPullParser {
+public:
+	aJsonPullParser(aJsonStream *stream_);
+
+	/* Read up to the next event and return it. aJson_End follows the
+	 * end of the top level value, aJson_Error malformed input or nesting
+	 * deeper than aJson_MAX_DEPTH; either is returned again from then on. */
+	int next();
+	/* Read the rest of the document, calling callback for every event.
+	 * Returns aJson_End or aJson_Error. */
+	int parse(aJsonEventCallback callback, void *context);
+	/* Whether the top level value has been read to its end. */
+	bool complete();
+
+	/* The path of the object or array an event starts or ends, of the
+	 * member whose key it is, or of the value. Members of the top level
+	 * object are "key", of nested objects ".key", array elements "[n]".
+	 * NULL if it does not fit aJson_PATH_SIZE. */
+	const char *path();
+	bool matches(const char *pattern);
+
+	/* The key of an aJson_Key event. */
+	const char *key() { return text; }
+	/* The value of an aJson_Value event: an aJson_String (its string cut
+	 * short to fit aJson_TEXT_SIZE), aJson_Int, aJson_Float,
+	 * aJson_Boolean or aJson_NULL item. Valid until the next event. */
+	aJsonObject *value() { return &item; }
+
+	/* The stream to read a network Client with, for the templates of
+	 * libraries that do not depend on aJson otherwise. */
+	typedef aJsonClientStream ClientStream;
+
+private:
+	int nextChar();
+	int readString();
+	bool push(bool array);
+	int pop(int ch);
+	void member(bool whole);
+
+	aJsonStream *stream;
+	aJsonObject item;
+	char state;
+	unsigned char depth;
+	/* Open arrays, a bit per level, and the path length and number of
+	 * members so far at each level. */
+	unsigned long arrays;
+	unsigned char level[aJson_MAX_DEPTH];
+	unsigned long count[aJson_MAX_DEPTH];
+	/* 0 while the path is whole, otherwise the depth it was cut at. */
+	unsigned char cut;
+	unsigned char path_len;
+	char path_buf[aJson_PATH_SIZE];
+	char text[aJson_TEXT_SIZE];
+};
+
 class aJsonClass {
 	/******************************************************************************
 	 * Constructors
@@ -184,6 +328,9 @@ public:
         aJsonObject* parse(aJsonStream* stream); //Reads from a stream
         aJsonObject* parse(aJsonStream* stream,char** filter_values); //Read from a file, but only return values include in the char* array filter_values
 	aJsonObject* parse(char *value); //Reads from a string
+	// The same, with the whole tree placed in arena rather than on the heap. Call arena.reset() instead of aJson.deleteItem when finished.
+	aJsonObject* parse(aJsonStream* stream, aJsonArena& arena, char** filter_values = NULL);
+	aJsonObject* parse(char *value, aJsonArena& arena);
 	// Render a aJsonObject entity to text for transfer/storage. Free the char* when finished.
 	int print(aJsonObject *item, aJsonStream* stream);
 	char* print(aJsonObject* item);
@@ -193,11 +340,15 @@ public:
 	void deleteItem(aJsonObject *c);
 
 	// Returns the number of items in an array (or object).
-	unsigned char getArraySize(aJsonObject *array);
+	unsigned int getArraySize(aJsonObject *array);
 	// Retrieve item number "item" from array "array". Returns NULL if unsuccessful.
-	aJsonObject* getArrayItem(aJsonObject *array, unsigned char item);
+	aJsonObject* getArrayItem(aJsonObject *array, unsigned int item);
 	// Get item "string" from object. Case insensitive.
 	aJsonObject* getObjectItem(aJsonObject *object, const char *string);
+	// Large arrays and objects are indexed on demand (see aJson_INDEX_MIN); the calls below keep the index up to date.
+	// An index only checks the ends of its list for changes made by hand: the first item, and nothing after the last.
+	// If you link or unlink items yourself, call this on the array or object afterwards.
+	void dropIndex(aJsonObject *container);
 
 	// These calls create a aJsonObject item of the appropriate type.
 	aJsonObject* createNull();
@@ -225,13 +376,13 @@ public:
 			aJsonObject *item);
 
 	// Remove/Detach items from Arrays/Objects.
-	aJsonObject* detachItemFromArray(aJsonObject *array, unsigned char which);
-	void deleteItemFromArray(aJsonObject *array, unsigned char which);
+	aJsonObject* detachItemFromArray(aJsonObject *array, unsigned int which);
+	void deleteItemFromArray(aJsonObject *array, unsigned int which);
 	aJsonObject* detachItemFromObject(aJsonObject *object, const char *string);
 	void deleteItemFromObject(aJsonObject *object, const char *string);
 
 	// Update array items.
-	void replaceItemInArray(aJsonObject *array, unsigned char which,
+	void replaceItemInArray(aJsonObject *array, unsigned int which,
 			aJsonObject *newitem);
 	void replaceItemInObject(aJsonObject *object, const char *string,
 			aJsonObject *newitem);
@@ -251,6 +402,12 @@ private:
 	void suffixObject(aJsonObject *prev, aJsonObject *item);
 
 	aJsonObject* createReference(aJsonObject *item);
+	aJsonObject* findItem(aJsonObject *array, unsigned int item, bool build);
+	aJsonObject* findItem(aJsonObject *object, const char *string, bool build);
+	aJsonIndex* findIndex(aJsonObject *container);
+	aJsonIndex* buildIndex(aJsonObject *container);
+	aJsonObject* detachItem(aJsonObject *array, aJsonObject *c);
+	void replaceItem(aJsonObject *array, aJsonObject *c, aJsonObject *newitem);
 };
 
 extern aJsonClass aJson;
@@ -0,0 +1,14 @@
+######################################
+# Host (Linux) build of the lm4f core against the simulated driverlib
+# in cores/host. Nothing here targets a board; VARIANT only selects which
+# lm4f pin map is simulated.
+VARIANT ?= stellarpad
+F_CPU ?= 80000000L
+CFLAGS := -O2 -DF_CPU=$(F_CPU) -g -w -Wall -ffunction-sections -fdata-sections -pthread -DARDUINO=101 -DENERGIA=12 $(EXTRA_CFLAGS)
+CPPFLAGS := $(CFLAGS) -fno-threadsafe-statics -fno-exceptions -fno-rtti
+LDFLAGS := -pthread -Wl,--gc-sections $(EXTRA_LDFLAGS)
+CC := gcc
+CXX := g++
+AR := ar
+SIZE := size
+######################################
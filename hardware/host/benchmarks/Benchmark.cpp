@@ -0,0 +1,259 @@
+/*
+ ************************************************************************
+ *	Benchmark.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Runner and main() for the benchmarks. Benchmarks that set the bytes
+ *	processed also report the CPU time spent per KB. Options:
+ *
+ *	    --filter=<substring>   only run benchmarks whose name contains it
+ *	    --min_time=<seconds>   minimum measured time per benchmark (0.2)
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Energia.h"
+#include "Benchmark.h"
+
+namespace benchmark {
+
+static Benchmark *benchmarks;
+static Benchmark **benchmarksTail = &benchmarks;
+
+State::State(uint64_t maxIterations, const int64_t *args) :
+	_maxIterations(maxIterations), _iterations(0),
+	_started(false), _paused(false),
+	_wallStart(0), _cpuStart(0), _wallNanos(0), _cpuNanos(0),
+	_bytes(0), _items(0), _label(0), _counters(0)
+{
+	for (int i = 0; i < BENCHMARK_MAX_ARGS; i++)
+		_args[i] = args[i];
+}
+
+bool State::KeepRunning()
+{
+	if (!_started) {
+		_started = true;
+		ResumeTiming();
+	}
+	if (_iterations < _maxIterations) {
+		_iterations++;
+		return true;
+	}
+	if (!_paused)
+		PauseTiming();
+	return false;
+}
+
+void State::PauseTiming()
+{
+	_wallNanos += HostNanos() - _wallStart;
+	_cpuNanos += HostThreadCPUNanos() - _cpuStart;
+	_paused = true;
+}
+
+void State::ResumeTiming()
+{
+	_paused = false;
+	_cpuStart = HostThreadCPUNanos();
+	_wallStart = HostNanos();
+}
+
+void State::SetCounter(const char *name, double value, bool total)
+{
+	int i;
+
+	for (i = 0; i < _counters; i++) {
+		if (!strcmp(_counterName[i], name))
+			break;
+	}
+	if (i == BENCHMARK_MAX_COUNTERS)
+		return;
+	if (i == _counters)
+		_counters++;
+	_counterName[i] = name;
+	_counterValue[i] = value;
+	_counterTotal[i] = total;
+}
+
+Benchmark::Benchmark(const char *name, Function fn) :
+	_name(name), _fn(fn), _runs(0), _fixedIterations(0), _next(0)
+{
+}
+
+Benchmark *Benchmark::Arg(int64_t a)
+{
+	if (_runs < 16) {
+		_args[_runs][0] = a;
+		_numArgs[_runs++] = 1;
+	}
+	return this;
+}
+
+Benchmark *Benchmark::Args(int64_t a, int64_t b)
+{
+	if (_runs < 16) {
+		_args[_runs][0] = a;
+		_args[_runs][1] = b;
+		_numArgs[_runs++] = 2;
+	}
+	return this;
+}
+
+Benchmark *Benchmark::Iterations(uint64_t n)
+{
+	_fixedIterations = n;
+	return this;
+}
+
+Benchmark *RegisterBenchmark(const char *name, Function fn)
+{
+	Benchmark *b = new Benchmark(name, fn);
+
+	*benchmarksTail = b;
+	benchmarksTail = &b->_next;
+	return b;
+}
+
+static void humanRate(char *buf, size_t len, double perSecond, const char *unit)
+{
+	static const char *prefix[] = { "", "k", "M", "G", "T" };
+	int i = 0;
+
+	while (perSecond >= 1000.0 && i < 4) {
+		perSecond /= 1000.0;
+		i++;
+	}
+	snprintf(buf, len, "%.4g %s%s/s", perSecond, prefix[i], unit);
+}
+
+class Runner
+{
+	public:
+		Runner() : filter(0), minTime(0.2) {}
+
+		const char *filter;
+		double minTime;
+
+		void run(Benchmark *b, int run);
+		void runAll();
+};
+
+void Runner::run(Benchmark *b, int run)
+{
+	static const int64_t noArgs[BENCHMARK_MAX_ARGS] = { 0 };
+	const int64_t *args = b->_runs ? b->_args[run] : noArgs;
+	char name[128];
+	int n;
+
+	n = snprintf(name, sizeof(name), "%s", b->_name);
+	if (b->_runs) {
+		for (int i = 0; i < b->_numArgs[run]; i++)
+			n += snprintf(name + n, sizeof(name) - n, "/%lld",
+					(long long)args[i]);
+	}
+	if (filter && !strstr(name, filter))
+		return;
+
+	uint64_t iterations = b->_fixedIterations ? b->_fixedIterations : 1;
+
+	for (;;) {
+		State state(iterations, args);
+
+		b->_fn(state);
+
+		double seconds = state._wallNanos / 1e9;
+		bool done = b->_fixedIterations || seconds >= minTime ||
+				iterations >= 1000000000ULL;
+
+		if (!done) {
+			// Aim 40% past the minimum, growing at most tenfold per round
+			double scale = seconds > 0 ? minTime * 1.4 / seconds : 10;
+			if (scale > 10)
+				scale = 10;
+			uint64_t next = (uint64_t)(iterations * scale);
+			iterations = next > iterations ? next : iterations + 1;
+			continue;
+		}
+
+		double it = (double)state._iterations;
+		char rate[32];
+
+		printf("%-40s %12.0f ns %12.0f ns %10llu", name,
+				state._wallNanos / it, state._cpuNanos / it,
+				(unsigned long long)state._iterations);
+		if (state._bytes && seconds > 0) {
+			humanRate(rate, sizeof(rate), state._bytes / seconds, "B");
+			printf(" %14s %8.0f ns/KB", rate,
+					state._cpuNanos * 1024.0 / state._bytes);
+		}
+		if (state._items && seconds > 0) {
+			humanRate(rate, sizeof(rate), state._items / seconds, "items");
+			printf(" %16s", rate);
+		}
+		for (int i = 0; i < state._counters; i++) {
+			double v = state._counterValue[i];
+			printf(" %s=%.4g", state._counterName[i],
+					state._counterTotal[i] ? v : v / it);
+		}
+		if (state._label)
+			printf(" %s", state._label);
+		printf("\n");
+		fflush(stdout);
+		return;
+	}
+}
+
+void Runner::runAll()
+{
+	printf("%-40s %15s %15s %10s\n", "Benchmark", "Time", "CPU", "Iterations");
+	printf("----------------------------------------"
+	       "------------------------------------------\n");
+
+	for (Benchmark *b = benchmarks; b; b = b->_next) {
+		int runs = b->_runs ? b->_runs : 1;
+
+		for (int r = 0; r < runs; r++)
+			run(b, r);
+	}
+}
+
+} // namespace benchmark
+
+int main(int argc, char **argv)
+{
+	benchmark::Runner runner;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strncmp(argv[i], "--filter=", 9)) {
+			runner.filter = argv[i] + 9;
+		} else if (!strncmp(argv[i], "--min_time=", 11)) {
+			runner.minTime = atof(argv[i] + 11);
+		} else {
+			fprintf(stderr, "usage: %s [--filter=<substring>] "
+					"[--min_time=<seconds>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	runner.runAll();
+	return 0;
+}
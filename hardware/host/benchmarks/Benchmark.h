@@ -0,0 +1,137 @@
+/*
+ ************************************************************************
+ *	Benchmark.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A small harness modelled on Google Benchmark:
+ *
+ *	    static void BM_SerialPrint(benchmark::State &state)
+ *	    {
+ *	        while (state.KeepRunning()) {
+ *	            Serial.print(...);
+ *	        }
+ *	        state.SetBytesProcessed(state.iterations() * n);
+ *	    }
+ *	    BENCHMARK(BM_SerialPrint)->Arg(64)->Arg(1024);
+ *
+ *	Every benchmark is run for an increasing number of iterations until it
+ *	takes at least --min_time seconds; wall time and CPU time of the
+ *	calling thread are reported per iteration, together with throughput
+ *	and any user counters.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef Benchmark_h
+#define Benchmark_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace benchmark {
+
+#define BENCHMARK_MAX_ARGS      2
+#define BENCHMARK_MAX_COUNTERS  8
+
+class State
+{
+	public:
+		State(uint64_t maxIterations, const int64_t *args);
+
+		bool KeepRunning();
+		void PauseTiming();
+		void ResumeTiming();
+
+		int64_t range(int i = 0) const { return _args[i]; }
+		uint64_t iterations() const { return _iterations; }
+
+		void SetBytesProcessed(int64_t bytes) { _bytes = bytes; }
+		void SetItemsProcessed(int64_t items) { _items = items; }
+		void SetLabel(const char *label) { _label = label; }
+		// Reported as value per iteration unless total is set
+		void SetCounter(const char *name, double value, bool total = false);
+
+	private:
+		friend class Runner;
+
+		uint64_t _maxIterations;
+		uint64_t _iterations;
+		bool _started;
+		bool _paused;
+		int64_t _args[BENCHMARK_MAX_ARGS];
+
+		uint64_t _wallStart, _cpuStart;
+		uint64_t _wallNanos, _cpuNanos;
+
+		int64_t _bytes;
+		int64_t _items;
+		const char *_label;
+
+		const char *_counterName[BENCHMARK_MAX_COUNTERS];
+		double _counterValue[BENCHMARK_MAX_COUNTERS];
+		bool _counterTotal[BENCHMARK_MAX_COUNTERS];
+		int _counters;
+};
+
+typedef void (*Function)(State &);
+
+class Benchmark
+{
+	public:
+		Benchmark(const char *name, Function fn);
+
+		Benchmark *Arg(int64_t a);
+		Benchmark *Args(int64_t a, int64_t b);
+		Benchmark *Iterations(uint64_t n);
+
+	private:
+		friend class Runner;
+		friend Benchmark *RegisterBenchmark(const char *name, Function fn);
+
+		const char *_name;
+		Function _fn;
+		int64_t _args[16][BENCHMARK_MAX_ARGS];
+		int _numArgs[16];
+		int _runs;
+		uint64_t _fixedIterations;
+		Benchmark *_next;
+};
+
+Benchmark *RegisterBenchmark(const char *name, Function fn);
+
+// Keeps the compiler from optimising away a value or a store to memory.
+template <class T>
+inline void DoNotOptimize(T const &value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory()
+{
+	asm volatile("" : : : "memory");
+}
+
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+#define BENCHMARK(fn) \
+	static benchmark::Benchmark *BENCHMARK_CONCAT(_benchmark_, __LINE__) \
+		__attribute__((unused)) = benchmark::RegisterBenchmark(#fn, fn)
+
+#endif
@@ -0,0 +1,309 @@
+/*
+ ************************************************************************
+ *	ajson.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	aJson parse cost, every node and string from the heap against the
+ *	whole tree in an arena. The documents are the size the M2X and PubNub
+ *	libraries receive: an M2X stream values listing and a PubNub history
+ *	reply, with the number of entries as the argument. Each iteration
+ *	parses the document and frees the tree again, with deleteItem() or
+ *	reset().
+ *
+ *	"allocs" counts heap calls per parse, made by wrapping the C library's
+ *	allocator. "peak" is the most memory the tree held: the heap chunks,
+ *	each rounded up and with its header as malloc_usable_size() reports
+ *	it, or the arena's high water mark.
+ *
+ *	Lookups in a parsed object and array with the argument's number of
+ *	items, against the list walks they replaced, kept here as the "Legacy"
+ *	variants. Lookup finds every key of the object once, in a shuffled
+ *	order; Iterate reads an array by index the way the examples do, with
+ *	getArraySize() in the loop condition. Objects and arrays of
+ *	aJson_INDEX_MIN items or more build their index on the first lookup
+ *	that walks that far, which the "allocs" counter shows.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aJSON.h"
+#include "Benchmark.h"
+
+static uint64_t allocations;
+static size_t heap, heapPeak;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+static size_t footprint(void *ptr)
+{
+	return ptr ? malloc_usable_size(ptr) + sizeof(size_t) : 0;
+}
+
+static void *track(void *ptr)
+{
+	allocations++;
+	heap += footprint(ptr);
+	if (heap > heapPeak)
+		heapPeak = heap;
+	return ptr;
+}
+
+void *malloc(size_t size)
+{
+	return track(__libc_malloc(size));
+}
+
+// The compiler turns malloc() and memset() into calloc()
+void *calloc(size_t count, size_t size)
+{
+	return track(__libc_calloc(count, size));
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	heap -= footprint(ptr);
+	return track(__libc_realloc(ptr, size));
+}
+
+void free(void *ptr)
+{
+	heap -= footprint(ptr);
+	__libc_free(ptr);
+}
+}
+
+static char *m2xValues(int count)
+{
+	char *doc = (char *)malloc(100 + count * 64);
+	int n = sprintf(doc, "{\"start\":\"2014-09-09T19:15:00.000Z\","
+			"\"end\":\"2014-09-09T20:15:00.000Z\",\"limit\":%d,\"values\":[",
+			count);
+
+	for (int i = 0; i < count; i++)
+		n += sprintf(doc + n, "%s{\"timestamp\":\"2014-09-09T19:%02d:%02d.%03dZ\","
+				"\"value\":%d.%d}", i ? "," : "", 15 + i / 60 % 45, i % 60,
+				i * 7 % 1000, 20 + i % 7, i % 10);
+	strcpy(doc + n, "]}");
+	return doc;
+}
+
+static char *pubnubHistory(int count)
+{
+	char *doc = (char *)malloc(100 + count * 96);
+	int n = sprintf(doc, "[[");
+
+	for (int i = 0; i < count; i++)
+		n += sprintf(doc + n, "%s{\"device\":\"sensor-%02d\",\"temp\":%d.%d,"
+				"\"rh\":%d,\"door\":%s,\"text\":\"reading %d\"}", i ? "," : "",
+				i % 16, 18 + i % 9, i % 10, 40 + i % 30,
+				i & 1 ? "true" : "false", i);
+	strcpy(doc + n, "],14106303483557127,14106303512839461]");
+	return doc;
+}
+
+static void parse(benchmark::State &state, char *doc, bool arena)
+{
+	static char storage[64 * 1024];
+	aJsonArena pool(storage, sizeof(storage));
+	uint64_t start = allocations;
+	size_t startHeap = heap;
+	bool bad = false;
+
+	heapPeak = heap;
+	while (state.KeepRunning()) {
+		aJsonObject *root;
+
+		if (arena) {
+			root = aJson.parse(doc, pool);
+			pool.reset();
+		} else {
+			root = aJson.parse(doc);
+			aJson.deleteItem(root);
+		}
+		bad |= root == NULL;
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(state.iterations() * strlen(doc));
+	state.SetCounter("allocs", (double)(allocations - start) /
+			state.iterations(), true);
+	state.SetCounter("peak", arena ? pool.peak() : heapPeak - startHeap,
+			true);
+	if (bad)
+		state.SetLabel("PARSE FAILED");
+	free(doc);
+}
+
+static void BM_aJsonM2X(benchmark::State &state)
+{
+	parse(state, m2xValues(state.range(0)), false);
+}
+BENCHMARK(BM_aJsonM2X)->Arg(10)->Arg(100);
+
+static void BM_aJsonM2XArena(benchmark::State &state)
+{
+	parse(state, m2xValues(state.range(0)), true);
+}
+BENCHMARK(BM_aJsonM2XArena)->Arg(10)->Arg(100);
+
+static void BM_aJsonPubNub(benchmark::State &state)
+{
+	parse(state, pubnubHistory(state.range(0)), false);
+}
+BENCHMARK(BM_aJsonPubNub)->Arg(10)->Arg(100);
+
+static void BM_aJsonPubNubArena(benchmark::State &state)
+{
+	parse(state, pubnubHistory(state.range(0)), true);
+}
+BENCHMARK(BM_aJsonPubNubArena)->Arg(10)->Arg(100);
+
+static char *gatewayConfig(int count)
+{
+	char *doc = (char *)malloc(100 + count * 64);
+	int n = sprintf(doc, "{");
+
+	for (int i = 0; i < count; i++)
+		n += sprintf(doc + n, "%s\"node-%04d\":{\"addr\":%d,\"rate\":%d}",
+				i ? "," : "", i, i * 7 % 253, 100 + i % 5);
+	strcpy(doc + n, "}");
+	return doc;
+}
+
+static char *readings(int count)
+{
+	char *doc = (char *)malloc(100 + count * 16);
+	int n = sprintf(doc, "[");
+
+	for (int i = 0; i < count; i++)
+		n += sprintf(doc + n, "%s%d.%d", i ? "," : "", 20 + i % 7, i % 10);
+	strcpy(doc + n, "]");
+	return doc;
+}
+
+// The lookups before the index
+static aJsonObject *legacyObjectItem(aJsonObject *object, const char *string)
+{
+	aJsonObject *c = object->child;
+
+	while (c && strcasecmp(c->name, string))
+		c = c->next;
+	return c;
+}
+
+static aJsonObject *legacyArrayItem(aJsonObject *array, unsigned int item)
+{
+	aJsonObject *c = array->child;
+
+	while (c && item > 0)
+		item--, c = c->next;
+	return c;
+}
+
+static unsigned int legacyArraySize(aJsonObject *array)
+{
+	aJsonObject *c = array->child;
+	unsigned int i = 0;
+
+	while (c)
+		i++, c = c->next;
+	return i;
+}
+
+static void lookup(benchmark::State &state, bool legacy)
+{
+	int count = state.range(0);
+	char *doc = gatewayConfig(count);
+	aJsonObject *root = aJson.parse(doc);
+	char (*keys)[16] = new char[count][16];
+	bool bad = root == NULL;
+	uint64_t start = allocations;
+
+	for (int i = 0; i < count; i++)
+		sprintf(keys[i], "NODE-%04d", i * 7919 % count);
+	while (state.KeepRunning()) {
+		for (int i = 0; i < count; i++) {
+			aJsonObject *item = legacy ? legacyObjectItem(root, keys[i]) :
+					aJson.getObjectItem(root, keys[i]);
+
+			bad |= item == NULL;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+	state.SetCounter("allocs", allocations - start, true);
+	if (bad)
+		state.SetLabel("NOT FOUND");
+	delete[] keys;
+	aJson.deleteItem(root);
+	free(doc);
+}
+
+static void iterate(benchmark::State &state, bool legacy)
+{
+	int count = state.range(0);
+	char *doc = readings(count);
+	aJsonObject *root = aJson.parse(doc);
+	double sum = 0;
+	uint64_t start = allocations;
+
+	while (state.KeepRunning()) {
+		if (legacy) {
+			for (unsigned int i = 0; i < legacyArraySize(root); i++)
+				sum += legacyArrayItem(root, i)->valuefloat;
+		} else {
+			for (unsigned int i = 0; i < aJson.getArraySize(root); i++)
+				sum += aJson.getArrayItem(root, i)->valuefloat;
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations() * count);
+	state.SetCounter("allocs", allocations - start, true);
+	aJson.deleteItem(root);
+	free(doc);
+}
+
+static void BM_aJsonLookup(benchmark::State &state)
+{
+	lookup(state, false);
+}
+BENCHMARK(BM_aJsonLookup)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_aJsonLookupLegacy(benchmark::State &state)
+{
+	lookup(state, true);
+}
+BENCHMARK(BM_aJsonLookupLegacy)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_aJsonIterate(benchmark::State &state)
+{
+	iterate(state, false);
+}
+BENCHMARK(BM_aJsonIterate)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_aJsonIterateLegacy(benchmark::State &state)
+{
+	iterate(state, true);
+}
+BENCHMARK(BM_aJsonIterateLegacy)->Arg(10)->Arg(100)->Arg(1000);
@@ -0,0 +1,150 @@
+/*
+ ************************************************************************
+ *	firmata.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Firmata taking a recorded session of a host program driving
+ *	StandardFirmata, about 20 KB of pin modes, digital and analog writes
+ *	and Sysex messages, from a loopback Stream that hands it over the
+ *	argument's bytes at a time, as a UART's receive buffer fills between
+ *	two loop()s. Bytes goes through it the way the examples did, with
+ *	available() and processInput() for each byte; Available with
+ *	processAvailable(), and Runs with processInput() on each run of bytes
+ *	as it came, the Stream left out.
+ *
+ *	Report sends the argument's analog pins and two digital ports for a
+ *	sampling interval, without a report and then in one. Items are bytes
+ *	received, or intervals for Report; "reads" counts Stream reads a
+ *	byte, "messages" the callbacks for the session and "writes" Stream
+ *	writes an interval.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Firmata.h"
+#include "FirmataLoopback.h"
+#include "Benchmark.h"
+
+static uint8_t session[32768];
+static size_t sessionLen;
+static unsigned long handled;
+
+static void analogCallback(byte pin, int value) { handled++; }
+static void pinModeCallback(byte pin, int mode) { handled++; }
+static void stringCallback(char *s) { handled++; }
+static void sysexCallback(byte command, byte argc, byte *argv) { handled++; }
+
+static void setup(FirmataClass &firmata, FirmataLoopback &stream, size_t segment)
+{
+	if (!sessionLen)
+		sessionLen = firmataSession(session, sizeof(session), 500);
+	firmata.attach(ANALOG_MESSAGE, analogCallback);
+	firmata.attach(DIGITAL_MESSAGE, analogCallback);
+	firmata.attach(REPORT_ANALOG, analogCallback);
+	firmata.attach(REPORT_DIGITAL, analogCallback);
+	firmata.attach(SET_PIN_MODE, pinModeCallback);
+	firmata.attach(STRING_DATA, stringCallback);
+	firmata.attach(START_SYSEX, sysexCallback);
+	firmata.begin(stream);
+	stream.segment = segment;
+	stream.clear();
+	handled = 0;
+}
+
+static void report(benchmark::State &state, FirmataLoopback &stream)
+{
+	uint64_t bytes = state.iterations() * sessionLen;
+
+	state.SetItemsProcessed(bytes);
+	state.SetBytesProcessed(bytes);
+	state.SetCounter("reads", (double)stream.reads / bytes, true);
+	state.SetCounter("messages", handled);
+}
+
+static void BM_FirmataBytes(benchmark::State &state)
+{
+	FirmataClass firmata;
+	FirmataLoopback stream;
+
+	setup(firmata, stream, state.range(0));
+	while (state.KeepRunning()) {
+		stream.replay(session, sessionLen);
+		while (firmata.available())
+			firmata.processInput();
+	}
+	report(state, stream);
+}
+BENCHMARK(BM_FirmataBytes)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_FirmataAvailable(benchmark::State &state)
+{
+	FirmataClass firmata;
+	FirmataLoopback stream;
+
+	setup(firmata, stream, state.range(0));
+	while (state.KeepRunning()) {
+		stream.replay(session, sessionLen);
+		firmata.processAvailable();
+	}
+	report(state, stream);
+}
+BENCHMARK(BM_FirmataAvailable)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_FirmataRuns(benchmark::State &state)
+{
+	FirmataClass firmata;
+	FirmataLoopback stream;
+	size_t segment = state.range(0);
+
+	setup(firmata, stream, segment);
+	while (state.KeepRunning()) {
+		for (size_t pos = 0; pos < sessionLen; pos += segment) {
+			size_t n = sessionLen - pos < segment ? sessionLen - pos : segment;
+
+			firmata.processInput(session + pos, n);
+		}
+	}
+	report(state, stream);
+}
+BENCHMARK(BM_FirmataRuns)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_FirmataReport(benchmark::State &state)
+{
+	FirmataClass firmata;
+	FirmataLoopback stream;
+	int pins = state.range(0);
+	bool batched = state.range(1);
+
+	setup(firmata, stream, 64);
+	while (state.KeepRunning()) {
+		if (batched)
+			firmata.startReport();
+		for (int pin = 0; pin < pins; pin++)
+			firmata.sendAnalog(pin, pin * 64);
+		firmata.sendDigitalPort(0, 0x55);
+		firmata.sendDigitalPort(1, 0x2A);
+		if (batched)
+			firmata.endReport();
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(stream.written);
+	state.SetCounter("writes", (double)stream.writes / state.iterations(), true);
+}
+BENCHMARK(BM_FirmataReport)->Args(4, 0)->Args(4, 1)->Args(12, 0)->Args(12, 1);
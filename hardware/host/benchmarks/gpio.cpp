@@ -0,0 +1,161 @@
+/*
+ ************************************************************************
+ *	gpio.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	shiftOut() and shiftIn() a byte at a time on two pins of port B, and
+ *	a pin written or toggled, through PinHandle and, as the "Legacy"
+ *	variants, through digitalWrite()/digitalRead() the way wiring_shift.c
+ *	did before. Items are bytes shifted or pin writes; "reads" and
+ *	"writes" count register accesses an item in the simulated register
+ *	file. Times are mostly the GPIO model's: on the target a handle's
+ *	access is a single load or store where digitalWrite() looks the pin
+ *	up in three tables and calls into ROM.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include "Energia.h"
+#include "Benchmark.h"
+
+#define DATA_PIN PB_5
+#define CLOCK_PIN PB_0
+
+static void setup(bool output)
+{
+	pinMode(DATA_PIN, output ? OUTPUT : INPUT);
+	pinMode(CLOCK_PIN, OUTPUT);
+	HostRegStatsReset();
+}
+
+static void report(benchmark::State &state)
+{
+	state.SetItemsProcessed(state.iterations());
+	state.SetCounter("reads", g_sHostRegStats.reads);
+	state.SetCounter("writes", g_sHostRegStats.writes);
+}
+
+//
+// shiftOut() and shiftIn() as they were
+//
+static void legacyShiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder,
+		uint8_t val)
+{
+	for (uint8_t i = 0; i < 8; i++) {
+		if (bitOrder == LSBFIRST)
+			digitalWrite(dataPin, !!(val & (1 << i)));
+		else
+			digitalWrite(dataPin, !!(val & (1 << (7 - i))));
+		digitalWrite(clockPin, HIGH);
+		digitalWrite(clockPin, LOW);
+	}
+}
+
+static uint8_t legacyShiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder)
+{
+	uint8_t value = 0;
+
+	for (uint8_t i = 0; i < 8; ++i) {
+		digitalWrite(clockPin, HIGH);
+		if (bitOrder == LSBFIRST)
+			value |= digitalRead(dataPin) << i;
+		else
+			value |= digitalRead(dataPin) << (7 - i);
+		digitalWrite(clockPin, LOW);
+	}
+	return value;
+}
+
+static void BM_ShiftOutLegacy(benchmark::State &state)
+{
+	uint8_t val = 0;
+
+	setup(true);
+	while (state.KeepRunning())
+		legacyShiftOut(DATA_PIN, CLOCK_PIN, MSBFIRST, val++);
+	report(state);
+}
+BENCHMARK(BM_ShiftOutLegacy);
+
+static void BM_ShiftOut(benchmark::State &state)
+{
+	uint8_t val = 0;
+
+	setup(true);
+	while (state.KeepRunning())
+		shiftOut(DATA_PIN, CLOCK_PIN, MSBFIRST, val++);
+	report(state);
+}
+BENCHMARK(BM_ShiftOut);
+
+static void BM_ShiftInLegacy(benchmark::State &state)
+{
+	setup(false);
+	while (state.KeepRunning())
+		benchmark::DoNotOptimize(legacyShiftIn(DATA_PIN, CLOCK_PIN, MSBFIRST));
+	report(state);
+}
+BENCHMARK(BM_ShiftInLegacy);
+
+static void BM_ShiftIn(benchmark::State &state)
+{
+	setup(false);
+	while (state.KeepRunning())
+		benchmark::DoNotOptimize(shiftIn(DATA_PIN, CLOCK_PIN, MSBFIRST));
+	report(state);
+}
+BENCHMARK(BM_ShiftIn);
+
+static void BM_DigitalWriteLegacy(benchmark::State &state)
+{
+	uint8_t level = LOW;
+
+	setup(true);
+	while (state.KeepRunning()) {
+		level = !level;
+		digitalWrite(CLOCK_PIN, level);
+	}
+	report(state);
+}
+BENCHMARK(BM_DigitalWriteLegacy);
+
+static void BM_FastWrite(benchmark::State &state)
+{
+	PinHandle clock = pinHandle(CLOCK_PIN);
+	uint8_t level = LOW;
+
+	setup(true);
+	while (state.KeepRunning()) {
+		level = !level;
+		fastWrite(clock, level);
+	}
+	report(state);
+}
+BENCHMARK(BM_FastWrite);
+
+static void BM_FastToggle(benchmark::State &state)
+{
+	PinHandle clock = pinHandle(CLOCK_PIN);
+
+	setup(true);
+	while (state.KeepRunning())
+		fastToggle(clock);
+	report(state);
+}
+BENCHMARK(BM_FastToggle);
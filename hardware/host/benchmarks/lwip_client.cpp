@@ -0,0 +1,197 @@
+/*
+ ************************************************************************
+ *	lwip_client.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A download of 64 KB through the lwIP EthernetClient of the TM4C129
+ *	boards from a peer on the same stack, over an LwipLink, the
+ *	lwIP stack running in the Ethernet interrupt as on the board. Read
+ *	takes the response a byte at a time with read(), ReadBuffer with
+ *	read(buf, n) for the argument's n, and PeekSegment a segment at a
+ *	time in place, with peekSegment() and consume(). Each adds the bytes
+ *	up, as a sketch would look at them.
+ *
+ *	Write sends 64 KB to the peer with write(), a chunk of the argument's
+ *	size at a time, and WriteNoCopy with writeNoCopy(), each waiting for
+ *	the last of it to be acknowledged.
+ *
+ *	Items are bytes; "frames" counts the packets on the link a KB, both
+ *	ways, and "poolMax" the most PBUF_POOL buffers ever in use.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "Ethernet.h"
+#include "LwipLink.h"
+#include "LwipPeer.h"
+#include "Benchmark.h"
+
+#define BODY_SIZE (64L << 10)
+#define PORT 80
+
+static const IPAddress local(192, 168, 1, 177);
+static const IPAddress server(192, 168, 1, 1);
+static uint8_t body[BODY_SIZE];
+static LwipLink *link;
+static LwipPeer *peer;
+static volatile uint32_t sum;
+
+static void begin(void)
+{
+	if (!link) {
+		link = new LwipLink();
+		peer = new LwipPeer(PORT);
+		Ethernet.begin(local, IPAddress(192, 168, 1, 1),
+				IPAddress(192, 168, 1, 1), IPAddress(255, 255, 255, 0));
+		for (long i = 0; i < BODY_SIZE; i++)
+			body[i] = i * 7;
+		peer->begin();
+	}
+	peer->serve(body, BODY_SIZE);
+	peer->keep(0, 0);
+	link->clear();
+}
+
+static void report(benchmark::State &state, uint64_t bytes)
+{
+	state.SetItemsProcessed(bytes);
+	state.SetBytesProcessed(bytes);
+	state.SetCounter("frames", (double)link->frames * 1024 / bytes, true);
+	state.SetCounter("poolMax", lwip_stats.memp[MEMP_PBUF_POOL].max, true);
+}
+
+static void BM_Read(benchmark::State &state)
+{
+	uint64_t bytes = 0;
+	uint32_t s = 0;
+	int c;
+
+	begin();
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		for (long got = 0; got < BODY_SIZE && client.connected(); ) {
+			if ((c = client.read()) >= 0) {
+				s += c;
+				got++;
+			}
+		}
+		bytes += BODY_SIZE;
+		client.stop();
+	}
+	sum = s;
+	report(state, bytes);
+}
+BENCHMARK(BM_Read);
+
+static void BM_ReadBuffer(benchmark::State &state)
+{
+	uint8_t buf[4096];
+	size_t size = state.range(0);
+	uint64_t bytes = 0;
+	uint32_t s = 0;
+	int n;
+
+	begin();
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		for (long got = 0; got < BODY_SIZE && client.connected(); ) {
+			if ((n = client.read(buf, size)) > 0) {
+				for (int i = 0; i < n; i++)
+					s += buf[i];
+				got += n;
+			}
+		}
+		bytes += BODY_SIZE;
+		client.stop();
+	}
+	sum = s;
+	report(state, bytes);
+}
+BENCHMARK(BM_ReadBuffer)->Arg(16)->Arg(256)->Arg(1460)->Arg(4096);
+
+static void BM_PeekSegment(benchmark::State &state)
+{
+	const uint8_t *data;
+	uint64_t bytes = 0;
+	uint32_t s = 0;
+	size_t n;
+
+	begin();
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		for (long got = 0; got < BODY_SIZE && client.connected(); ) {
+			if ((n = client.peekSegment(&data)) > 0) {
+				for (size_t i = 0; i < n; i++)
+					s += data[i];
+				client.consume(n);
+				got += n;
+			}
+		}
+		bytes += BODY_SIZE;
+		client.stop();
+	}
+	sum = s;
+	report(state, bytes);
+}
+BENCHMARK(BM_PeekSegment);
+
+static void drain(EthernetClient &client)
+{
+	while (client.unacked())
+		;
+	client.stop();
+}
+
+static void BM_Write(benchmark::State &state)
+{
+	size_t chunk = state.range(0);
+
+	begin();
+	peer->serve(0, 0);
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		for (long i = 0; i < BODY_SIZE; i += chunk)
+			client.write(body + i, chunk);
+		drain(client);
+	}
+	report(state, state.iterations() * BODY_SIZE);
+}
+BENCHMARK(BM_Write)->Arg(64)->Arg(1024)->Arg(BODY_SIZE);
+
+static void BM_WriteNoCopy(benchmark::State &state)
+{
+	begin();
+	peer->serve(0, 0);
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		client.writeNoCopy(body, BODY_SIZE);
+		drain(client);
+	}
+	report(state, state.iterations() * BODY_SIZE);
+}
+BENCHMARK(BM_WriteNoCopy);
@@ -0,0 +1,201 @@
+/*
+ ************************************************************************
+ *	lwip_stack.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The lwIP Ethernet library of the TM4C129 boards against peers on the
+ *	same stack, over an LwipLink, for the sizes in lwipopts.h; the
+ *	Makefile builds it again for each of its profiles of them.
+ *
+ *	Download reads 64 KB from a peer through an EthernetClient with
+ *	read(buf, 1460), and Upload writes as much to it with write(); each
+ *	opens a connection of its own. ServerWrite writes 64 KB through the
+ *	EthernetServer to a peer connected to it. Items are bytes.
+ *
+ *	RequestResponse sends a request of 64 bytes over one connection and
+ *	reads the peer's reply of the argument's size, as a sketch polling a
+ *	server would; UdpEcho sends a datagram of the argument's size to a
+ *	peer that echoes it, and reads it back. Items are round trips, the
+ *	time one of them took the latency.
+ *
+ *	"txFrames" counts the packets the board sent a round trip, or a KB
+ *	of the bulk ones, "frames" those on the link both ways; "poolMax",
+ *	"pbufMax" and "segMax" are the most PBUF_POOL buffers, pbuf headers
+ *	and TCP segments ever in use, and "heapMax" the most bytes of the
+ *	lwIP heap.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "Ethernet.h"
+#include "EthernetUdp.h"
+#include "LwipLink.h"
+#include "LwipPeer.h"
+#include "Benchmark.h"
+
+#define BODY_SIZE (64L << 10)
+#define REQUEST_SIZE 64
+#define PORT 80
+#define SERVER_PORT 23
+#define LOCAL_PORT 8888
+#define ECHO_PORT 7
+
+static const IPAddress local(192, 168, 1, 177);
+static const IPAddress server(192, 168, 1, 1);
+static uint8_t body[BODY_SIZE];
+static LwipLink *link;
+static LwipPeer *peer, *remote;
+static EthernetServer board(SERVER_PORT);
+static EthernetUDP udp;
+
+static void begin(void)
+{
+	if (!link) {
+		link = new LwipLink();
+		peer = new LwipPeer(PORT);
+		remote = new LwipPeer(0);
+		Ethernet.begin(local, server, server, IPAddress(255, 255, 255, 0));
+		for (long i = 0; i < BODY_SIZE; i++)
+			body[i] = i * 7;
+		peer->begin();
+		peer->echo(ECHO_PORT);
+		board.begin();
+		udp.begin(LOCAL_PORT);
+	}
+	peer->keep(0, 0);
+	link->clear();
+}
+
+static void report(benchmark::State &state, uint64_t items, unsigned int per = 1)
+{
+	state.SetItemsProcessed(items);
+	state.SetCounter("txFrames", (double)link->txFrames * per / items, true);
+	state.SetCounter("frames", (double)link->frames * per / items, true);
+	state.SetCounter("poolMax", lwip_stats.memp[MEMP_PBUF_POOL].max, true);
+	state.SetCounter("pbufMax", lwip_stats.memp[MEMP_PBUF].max, true);
+	state.SetCounter("segMax", lwip_stats.memp[MEMP_TCP_SEG].max, true);
+	state.SetCounter("heapMax", lwip_stats.mem.max, true);
+}
+
+static void BM_Download(benchmark::State &state)
+{
+	uint8_t buf[1460];
+	int n;
+
+	begin();
+	peer->serve(body, BODY_SIZE);
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		for (long got = 0; got < BODY_SIZE && client.connected(); )
+			if ((n = client.read(buf, sizeof(buf))) > 0)
+				got += n;
+		client.stop();
+	}
+	state.SetBytesProcessed(state.iterations() * BODY_SIZE);
+	report(state, state.iterations() * BODY_SIZE, 1024);
+}
+BENCHMARK(BM_Download);
+
+static void BM_Upload(benchmark::State &state)
+{
+	begin();
+	peer->serve(0, 0);
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		client.connect(server, PORT);
+		client.write(body, BODY_SIZE);
+		while (client.unacked())
+			;
+		client.stop();
+	}
+	state.SetBytesProcessed(state.iterations() * BODY_SIZE);
+	report(state, state.iterations() * BODY_SIZE, 1024);
+}
+BENCHMARK(BM_Upload);
+
+static void BM_ServerWrite(benchmark::State &state)
+{
+	EthernetClient client;
+	size_t expected = 0;
+
+	begin();
+	remote->serve(0, 0, false);
+	remote->keep(0, 0);
+	remote->connect(SERVER_PORT);
+	while (!(client = board.available()))
+		;
+	while (state.KeepRunning()) {
+		client.write(body, BODY_SIZE);
+		expected += BODY_SIZE;
+		while (remote->receivedLen < expected && remote->connected)
+			;
+	}
+	remote->close();
+	state.SetBytesProcessed(state.iterations() * BODY_SIZE);
+	report(state, state.iterations() * BODY_SIZE, 1024);
+}
+BENCHMARK(BM_ServerWrite);
+
+static void BM_RequestResponse(benchmark::State &state)
+{
+	EthernetClient client;
+	uint8_t buf[1460];
+	long size = state.range(0);
+	int n;
+
+	begin();
+	peer->answer(body, size, REQUEST_SIZE);
+	client.connect(server, PORT);
+	while (state.KeepRunning()) {
+		client.write(body, REQUEST_SIZE);
+		for (long got = 0; got < size && client.connected(); )
+			if ((n = client.read(buf, sizeof(buf))) > 0)
+				got += n;
+	}
+	client.stop();
+	report(state, state.iterations());
+}
+BENCHMARK(BM_RequestResponse)->Arg(64)->Arg(1460)->Arg(8192);
+
+static void BM_UdpEcho(benchmark::State &state)
+{
+	uint8_t buf[1460];
+	size_t size = state.range(0);
+	unsigned long lost = 0;
+
+	begin();
+	while (state.KeepRunning()) {
+		unsigned long start = millis();
+
+		udp.beginPacket(server, ECHO_PORT);
+		udp.write(body, size);
+		udp.endPacket();
+		while (!udp.parsePacket())
+			if (millis() - start > 100) {
+				lost++;
+				break;
+			}
+		udp.read(buf, size);
+	}
+	state.SetCounter("lost", lost, true);
+	report(state, state.iterations());
+}
+BENCHMARK(BM_UdpEcho)->Arg(64)->Arg(1024);
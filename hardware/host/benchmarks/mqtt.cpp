@@ -0,0 +1,216 @@
+/*
+ ************************************************************************
+ *	mqtt.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	MQTT message dispatch. A recorded stream of 100000 PUBLISH packets
+ *	from a gateway (8 sites of 32 devices, each reporting a few topics,
+ *	with the odd $SYS message) is replayed with the argument's number of
+ *	subscriptions, a mix of exact filters and ones with + and #.
+ *
+ *	Dispatch and DispatchLegacy take the packets apart and find the
+ *	matching subscriptions, with the topic trie and with the scan of every
+ *	filter it replaced, kept here as the "Legacy" variant. Replay puts the
+ *	stream through MQTT::Client::yield() over a loopback network, which
+ *	is the whole receive path. "calls" counts handler calls per packet.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MQTTLoopback.h"
+#include "Benchmark.h"
+
+#define PACKETS 100000
+#define MAX_HANDLERS 64
+
+static unsigned char *capture;
+static size_t captureLen;
+static char filters[MAX_HANDLERS][40];
+static uint64_t calls;
+
+static void record(void)
+{
+	static const char *metrics[] = { "temp", "rh", "status", "cmd/ack" };
+	uint32_t rng = 1;
+
+	if (capture)
+		return;
+	capture = (unsigned char *)malloc(PACKETS * 64);
+	for (int i = 0; i < PACKETS; i++) {
+		MQTTString name = MQTTString_initializer;
+		char topic[48];
+		char payload[16];
+
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		if (rng % 50 == 0)
+			strcpy(topic, "$SYS/broker/load/1min");
+		else
+			sprintf(topic, "gw/site%u/dev%02u/%s", rng % 8, rng / 8 % 32,
+					metrics[rng / 256 % 4]);
+		int n = sprintf(payload, "%u.%u", 15 + rng % 20, rng / 20 % 10);
+		name.cstring = topic;
+		captureLen += MQTTSerialize_publish(capture + captureLen, 64, 0, 0, 0, 0,
+				name, (unsigned char *)payload, n);
+	}
+}
+
+static void makeFilters(int count)
+{
+	for (int i = 0; i < count; i++) {
+		unsigned int site = i % 8, dev = i * 7 % 32;
+
+		switch (i % 8) {
+		case 4:
+			sprintf(filters[i], "gw/+/dev%02u/status", dev);
+			break;
+		case 5:
+			sprintf(filters[i], "gw/site%u/#", site);
+			break;
+		case 6:
+			sprintf(filters[i], "gw/+/+/cmd/%s", i & 8 ? "ack" : "nak");
+			break;
+		case 7:
+			sprintf(filters[i], "gw/site%u/dev%02u/+", site, dev);
+			break;
+		default:
+			sprintf(filters[i], "gw/site%u/dev%02u/temp", site, dev);
+			break;
+		}
+	}
+}
+
+// The matching before the trie
+static bool legacyTopicMatched(char *topicFilter, MQTTString &topicName)
+{
+	char *curf = topicFilter;
+	char *curn = topicName.lenstring.data;
+	char *curn_end = curn + topicName.lenstring.len;
+
+	while (*curf && curn < curn_end) {
+		if (*curn == '/' && *curf != '/')
+			break;
+		if (*curf != '+' && *curf != '#' && *curf != *curn)
+			break;
+		if (*curf == '+') {
+			char *nextpos = curn + 1;
+
+			while (nextpos < curn_end && *nextpos != '/')
+				nextpos = ++curn + 1;
+		} else if (*curf == '#')
+			curn = curn_end - 1;
+		curf++;
+		curn++;
+	}
+	return (curn == curn_end) && (*curf == '\0');
+}
+
+static void dispatch(benchmark::State &state, bool legacy)
+{
+	int count = state.range(0);
+	MQTT::TopicTrie<MAX_HANDLERS, MAX_HANDLERS * MQTTCLIENT_TOPIC_LEVELS + 1> trie;
+	short matched[MAX_HANDLERS];
+
+	record();
+	makeFilters(count);
+	for (int i = 0; i < count; i++)
+		trie.add(filters[i]);
+	calls = 0;
+	while (state.KeepRunning()) {
+		unsigned char *p = capture, *end = capture + captureLen;
+
+		while (p < end) {
+			MQTTString topicName = MQTTString_initializer;
+			unsigned char dup, retained;
+			unsigned short id;
+			int qos, len, remaining;
+			unsigned char *payload;
+
+			int header = 1 + MQTTPacket_decodeBuf(p + 1, &remaining);
+			MQTTDeserialize_publish(&dup, &qos, &retained, &id, &topicName,
+					&payload, &len, p, header + remaining);
+			p += header + remaining;
+			if (legacy) {
+				for (int i = 0; i < count; i++) {
+					if (MQTTPacket_equals(&topicName, filters[i]) ||
+							legacyTopicMatched(filters[i], topicName))
+						calls++;
+				}
+			} else {
+				calls += trie.match(topicName, matched);
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * PACKETS);
+	state.SetBytesProcessed(state.iterations() * captureLen);
+	state.SetCounter("calls", (double)calls / (state.iterations() * PACKETS),
+			true);
+}
+
+static void BM_MQTTDispatch(benchmark::State &state)
+{
+	dispatch(state, false);
+}
+BENCHMARK(BM_MQTTDispatch)->Arg(5)->Arg(40);
+
+static void BM_MQTTDispatchLegacy(benchmark::State &state)
+{
+	dispatch(state, true);
+}
+BENCHMARK(BM_MQTTDispatchLegacy)->Arg(5)->Arg(40);
+
+static void onMessage(MQTT::MessageData &md)
+{
+	calls++;
+}
+
+typedef MQTT::Client<MQTTLoopback, MQTTLoopbackTimer, 128, MAX_HANDLERS>
+		ReplayClient;
+
+static void BM_MQTTReplay(benchmark::State &state)
+{
+	int count = state.range(0);
+	MQTTLoopback network;
+	ReplayClient *client = new ReplayClient(network);
+	MQTTPacket_connectData options = MQTTPacket_connectData_initializer;
+	bool bad;
+
+	record();
+	makeFilters(count);
+	options.keepAliveInterval = 0;
+	bad = client->connect(options) != 0;
+	for (int i = 0; i < count; i++)
+		bad |= client->subscribe(filters[i], MQTT::QOS0, onMessage) != 0;
+	calls = 0;
+	while (state.KeepRunning()) {
+		network.replay(capture, captureLen);
+		client->yield();
+	}
+	state.SetItemsProcessed(state.iterations() * PACKETS);
+	state.SetBytesProcessed(state.iterations() * captureLen);
+	state.SetCounter("calls", (double)calls / (state.iterations() * PACKETS),
+			true);
+	if (bad)
+		state.SetLabel("SUBSCRIBE FAILED");
+	delete client;
+}
+BENCHMARK(BM_MQTTReplay)->Arg(5)->Arg(40);
@@ -0,0 +1,251 @@
+/*
+ ************************************************************************
+ *	print.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Print number formatting against the implementation it replaced, kept
+ *	here as the "Legacy" variants: integers rendered with one division per
+ *	digit, floats with a double multiply, convert and print() per digit.
+ *	Output goes to a Print that only counts, so the numbers are the cost
+ *	of formatting plus the write() calls, which "writes" counts per call.
+ *	"cycles" is the time stamp counter per call where the host has one.
+ *
+ *	The host has an FPU, so the float comparison understates the gain on
+ *	the MSP430 and C2000, where every double operation the old code did
+ *	is a library call.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Print.h"
+#include "Benchmark.h"
+
+class CountingPrint : public Print
+{
+	public:
+		uint64_t bytes;
+		uint64_t writes;
+
+		CountingPrint() : bytes(0), writes(0) {}
+
+		virtual size_t write(uint8_t c)
+		{
+			benchmark::DoNotOptimize(c);
+			bytes++;
+			writes++;
+			return 1;
+		}
+
+		virtual size_t write(const uint8_t *buf, size_t size)
+		{
+			benchmark::DoNotOptimize(buf);
+			bytes += size;
+			writes++;
+			return size;
+		}
+};
+
+static uint64_t cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
+//
+// The implementation before the formatting engine
+//
+static size_t legacyNumber(Print &out, unsigned long n, uint8_t base)
+{
+	char buf[8 * sizeof(long) + 1];
+	char *str = &buf[sizeof(buf) - 1];
+
+	*str = '\0';
+	if (base < 2) base = 10;
+	do {
+		unsigned long m = n;
+		n /= base;
+		char c = m - base * n;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while (n);
+	return out.write(str);
+}
+
+static size_t legacyLong(Print &out, long n)
+{
+	if (n < 0) {
+		int t = out.print('-');
+		n = -n;
+		return legacyNumber(out, n, 10) + t;
+	}
+	return legacyNumber(out, n, 10);
+}
+
+static size_t legacyFloat(Print &out, double number, uint8_t digits)
+{
+	size_t n = 0;
+
+	if (number < 0.0) {
+		n += out.print('-');
+		number = -number;
+	}
+	double rounding = 0.5;
+	for (uint8_t i = 0; i < digits; ++i)
+		rounding /= 10.0;
+	number += rounding;
+	unsigned long int_part = (unsigned long)number;
+	double remainder = number - (double)int_part;
+	n += legacyNumber(out, int_part, 10);
+	if (digits > 0)
+		n += out.write(".");
+	while (digits-- > 0) {
+		remainder *= 10.0;
+		int toPrint = int(remainder);
+		n += legacyLong(out, toPrint);
+		remainder -= toPrint;
+	}
+	return n;
+}
+
+static const long longs[] = {
+	0, 7, -42, 1234, -56789, 1000000, -31415926, 2147483647,
+};
+static const double doubles[] = {
+	0.0, 3.14159, -2.71828, 123.456, -0.001, 98765.4321, 1.999, -42.5,
+};
+#define VALUES 8
+
+enum Kind { NEW, LEGACY, SNPRINTF };
+
+static void report(benchmark::State &state, CountingPrint &out, uint64_t start)
+{
+	uint64_t calls = state.iterations() * VALUES;
+
+	state.SetItemsProcessed(calls);
+	state.SetCounter("writes", (double)out.writes / calls, true);
+	state.SetCounter("cycles", (double)(cycles() - start) / calls, true);
+}
+
+static void printLongs(benchmark::State &state, Kind kind, uint8_t base)
+{
+	CountingPrint out;
+	uint64_t start = cycles();
+
+	while (state.KeepRunning()) {
+		for (int i = 0; i < VALUES; i++) {
+			if (kind == LEGACY)
+				base == 10 ? legacyLong(out, longs[i]) :
+						legacyNumber(out, longs[i], base);
+			else
+				out.print(longs[i], base);
+		}
+	}
+	report(state, out, start);
+}
+
+static void printDoubles(benchmark::State &state, Kind kind)
+{
+	CountingPrint out;
+	int digits = state.range(0);
+	uint64_t start = cycles();
+
+	while (state.KeepRunning()) {
+		for (int i = 0; i < VALUES; i++) {
+			if (kind == LEGACY)
+				legacyFloat(out, doubles[i], digits);
+			else
+				out.print(doubles[i], digits);
+		}
+	}
+	report(state, out, start);
+}
+
+static void BM_PrintLong(benchmark::State &state)
+{
+	printLongs(state, NEW, DEC);
+}
+BENCHMARK(BM_PrintLong);
+
+static void BM_PrintLongLegacy(benchmark::State &state)
+{
+	printLongs(state, LEGACY, DEC);
+}
+BENCHMARK(BM_PrintLongLegacy);
+
+static void BM_PrintHex(benchmark::State &state)
+{
+	printLongs(state, NEW, HEX);
+}
+BENCHMARK(BM_PrintHex);
+
+static void BM_PrintHexLegacy(benchmark::State &state)
+{
+	printLongs(state, LEGACY, HEX);
+}
+BENCHMARK(BM_PrintHexLegacy);
+
+static void BM_PrintDouble(benchmark::State &state)
+{
+	printDoubles(state, NEW);
+}
+BENCHMARK(BM_PrintDouble)->Arg(2)->Arg(6);
+
+static void BM_PrintDoubleLegacy(benchmark::State &state)
+{
+	printDoubles(state, LEGACY);
+}
+BENCHMARK(BM_PrintDoubleLegacy)->Arg(2)->Arg(6);
+
+// A typical log line, through Print::printf and through the C library
+static void printLine(benchmark::State &state, Kind kind)
+{
+	CountingPrint out;
+	uint64_t start = cycles();
+	char buf[80];
+
+	while (state.KeepRunning()) {
+		for (int i = 0; i < VALUES; i++) {
+			if (kind == SNPRINTF) {
+				int n = snprintf(buf, sizeof(buf), "t=%lu adc=%4d v=%.3f\r\n",
+						(unsigned long)i * 1000, (int)longs[i] & 0xfff,
+						doubles[i]);
+				out.write((const uint8_t *)buf, n);
+			} else {
+				out.printf("t=%lu adc=%4d v=%.3f\r\n", (unsigned long)i * 1000,
+						(int)longs[i] & 0xfff, doubles[i]);
+			}
+		}
+	}
+	report(state, out, start);
+}
+
+static void BM_Printf(benchmark::State &state)
+{
+	printLine(state, NEW);
+}
+BENCHMARK(BM_Printf);
+
+static void BM_PrintfSnprintf(benchmark::State &state)
+{
+	printLine(state, SNPRINTF);
+}
+BENCHMARK(BM_PrintfSnprintf);
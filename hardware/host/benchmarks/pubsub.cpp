@@ -0,0 +1,227 @@
+/*
+ ************************************************************************
+ *	pubsub.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	PubSubClient receiving a recorded stream of about 4 MB of PUBLISH
+ *	packets, with the first argument's payload size, from a loopback
+ *	Client handing it over in segments of 1460 bytes. The second argument
+ *	is the buffer given with setBuffer(), 0 for the built-in 128 bytes
+ *	with a chunk callback taking the payloads that do not fit.
+ *
+ *	Items are messages. "poll_us" is the time 99.9% of poll() calls came
+ *	in under, "max_poll_us" the longest any took, mostly the host's own
+ *	doing, and "reads" counts Client reads per message. PollLegacy is the
+ *	receive path poll() had before, a byte at a time until the packet is
+ *	complete, kept here as the "Legacy" variant; it drops payloads that
+ *	do not fit.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PubSubLoopback.h"
+#include "Benchmark.h"
+
+#define STREAM_BYTES (4 << 20)
+
+static uint8_t *capture;
+static size_t captureLen, capturePayload;
+static long messages;
+static uint64_t received;
+
+// poll() times in 50 ns steps, the last step for anything longer
+#define POLL_STEPS 4096
+static uint64_t pollTimes[POLL_STEPS];
+static uint64_t maxPoll;
+
+static void timePoll(uint64_t nanos)
+{
+	pollTimes[nanos / 50 < POLL_STEPS ? nanos / 50 : POLL_STEPS - 1]++;
+	if (nanos > maxPoll)
+		maxPoll = nanos;
+}
+
+static double pollPercentile(double fraction)
+{
+	uint64_t total = 0, seen = 0;
+	int i;
+
+	for (i = 0; i < POLL_STEPS; i++)
+		total += pollTimes[i];
+	for (i = 0; i < POLL_STEPS - 1; i++) {
+		seen += pollTimes[i];
+		if (seen >= total * fraction)
+			break;
+	}
+	return (i + 1) * 0.05;
+}
+
+static void record(size_t payloadLen)
+{
+	uint8_t payload[2048];
+
+	if (capture && capturePayload == payloadLen)
+		return;
+	if (!capture)
+		capture = (uint8_t *)malloc(STREAM_BYTES + 4096);
+	for (size_t i = 0; i < payloadLen; i++)
+		payload[i] = '0' + i % 10;
+	captureLen = 0;
+	messages = 0;
+	while (captureLen < STREAM_BYTES) {
+		char topic[32];
+
+		sprintf(topic, "sensors/node%02ld/temp", messages % 64);
+		captureLen += pubSubPacket(capture + captureLen, topic, payload,
+				payloadLen);
+		messages++;
+	}
+	capturePayload = payloadLen;
+}
+
+static void onMessage(char *topic, uint8_t *payload, unsigned int len)
+{
+	received += len;
+}
+
+static void onChunk(char *topic, uint8_t *data, unsigned int len,
+		unsigned long offset, unsigned long total)
+{
+	received += len;
+}
+
+static void report(benchmark::State &state, PubSubLoopback &net)
+{
+	state.SetItemsProcessed(state.iterations() * messages);
+	state.SetBytesProcessed(state.iterations() * captureLen);
+	state.SetCounter("poll_us", pollPercentile(0.999), true);
+	state.SetCounter("max_poll_us", maxPoll / 1000.0, true);
+	state.SetCounter("reads", (double)net.reads / (state.iterations() * messages),
+			true);
+	if (received != state.iterations() * messages * capturePayload)
+		state.SetLabel("PAYLOAD DROPPED");
+}
+
+static void BM_PubSubPoll(benchmark::State &state)
+{
+	PubSubLoopback net;
+	PubSubClient client((char *)"broker", 1883, onMessage, net);
+	uint8_t *buffer = 0;
+
+	record(state.range(0));
+	if (state.range(1)) {
+		buffer = (uint8_t *)malloc(state.range(1));
+		client.setBuffer(buffer, state.range(1));
+	} else {
+		client.setChunkCallback(onChunk);
+	}
+	client.connect((char *)"energia");
+	net.reads = 0;
+	received = 0;
+	memset(pollTimes, 0, sizeof(pollTimes));
+	maxPoll = 0;
+	while (state.KeepRunning()) {
+		net.replay(capture, captureLen);
+		while (!net.done()) {
+			uint64_t start = HostNanos();
+
+			client.poll();
+			timePoll(HostNanos() - start);
+		}
+	}
+	report(state, net);
+	free(buffer);
+}
+BENCHMARK(BM_PubSubPoll)->Args(32, 0)->Args(1024, 0)->Args(1024, 2048);
+
+//
+// The receive path before, without its keepalive handling
+//
+static uint8_t legacyReadByte(Client &client)
+{
+	while (!client.available())
+		;
+	return client.read();
+}
+
+static uint16_t legacyReadPacket(Client &client, uint8_t *buffer)
+{
+	uint16_t len = 0;
+	buffer[len++] = legacyReadByte(client);
+	uint8_t multiplier = 1;
+	uint16_t length = 0;
+	uint8_t digit = 0;
+	do {
+		digit = legacyReadByte(client);
+		buffer[len++] = digit;
+		length += (digit & 127) * multiplier;
+		multiplier *= 128;
+	} while ((digit & 128) != 0);
+
+	for (uint16_t i = 0; i < length; i++) {
+		if (len < MQTT_MAX_PACKET_SIZE) {
+			buffer[len++] = legacyReadByte(client);
+		} else {
+			legacyReadByte(client);
+			len = 0;
+		}
+	}
+	return len;
+}
+
+static void legacyPoll(Client &client, uint8_t *buffer)
+{
+	if (client.available()) {
+		uint16_t len = legacyReadPacket(client, buffer);
+		if (len > 0 && (buffer[0] & 0xF0) == MQTTPUBLISH) {
+			uint16_t tl = (buffer[2] << 8) + buffer[3];
+			char topic[tl + 1];
+			for (uint16_t i = 0; i < tl; i++)
+				topic[i] = buffer[4 + i];
+			topic[tl] = 0;
+			onMessage(topic, buffer + 4 + tl, len - 4 - tl);
+		}
+	}
+}
+
+static void BM_PubSubPollLegacy(benchmark::State &state)
+{
+	PubSubLoopback net;
+	uint8_t buffer[MQTT_MAX_PACKET_SIZE];
+
+	record(state.range(0));
+	net.connect("broker", 1883);
+	net.reads = 0;
+	received = 0;
+	memset(pollTimes, 0, sizeof(pollTimes));
+	maxPoll = 0;
+	while (state.KeepRunning()) {
+		net.replay(capture, captureLen);
+		while (!net.done()) {
+			uint64_t start = HostNanos();
+
+			legacyPoll(net, buffer);
+			timePoll(HostNanos() - start);
+		}
+	}
+	report(state, net);
+}
+BENCHMARK(BM_PubSubPollLegacy)->Arg(32)->Arg(1024);
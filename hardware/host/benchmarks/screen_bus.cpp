@@ -0,0 +1,150 @@
+/*
+ ************************************************************************
+ *	screen_bus.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The screen of the LCD_screen library it is built against, Kentec 3.5"
+ *	(SSD2119) or Educational BoosterPack MKII (HX8353E), on a ScreenBus on
+ *	SSI2, drawing each of its primitives: Clear fills the screen, Line
+ *	draws a shallow and a steep diagonal, Circle the outline of a circle
+ *	of the argument's radius and CircleSolid a disc of it. Text writes
+ *	a line of 16 characters on a solid background, TextTransparent
+ *	without one and TextScaled twice the size.
+ *
+ *	Items are primitives, or characters for the Text ones; "transactions"
+ *	counts the chip select frames an item, "commands" those of them that
+ *	were commands and "bytes" the bytes sent in them.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#if __has_include("Screen_K35_SPI.h")
+#include "Screen_K35_SPI.h"
+#define SCREEN Screen_K35_SPI
+#define PIN_DC 8
+#else
+#include "Screen_HX8353E.h"
+#define SCREEN Screen_HX8353E
+#define PIN_DC 31
+#endif
+#include "ScreenBus.h"
+#include "Benchmark.h"
+
+#define PIN_CS 13
+#define TEXT "Temperature 21C"
+
+static ScreenBus *bus;
+static SCREEN *screen;
+
+static void begin(void)
+{
+	if (!bus) {
+		bus = new ScreenBus(PIN_CS, PIN_DC);
+		screen = new SCREEN();
+		screen->begin();
+		screen->setFontSize(0);
+	}
+	screen->setPenSolid(false);
+	screen->setFontSolid(true);
+	bus->clear();
+}
+
+static void report(benchmark::State &state, uint64_t items)
+{
+	state.SetItemsProcessed(items);
+	state.SetCounter("transactions", (double)bus->transactions / items, true);
+	state.SetCounter("commands", (double)bus->commands / items, true);
+	state.SetCounter("bytes", (double)bus->bytes / items, true);
+}
+
+static void BM_Clear(benchmark::State &state)
+{
+	begin();
+	while (state.KeepRunning())
+		screen->clear(blueColour);
+	report(state, state.iterations());
+}
+BENCHMARK(BM_Clear);
+
+static void BM_Line(benchmark::State &state)
+{
+	uint16_t w, h;
+
+	begin();
+	w = screen->screenSizeX();
+	h = screen->screenSizeY();
+	while (state.KeepRunning()) {
+		screen->line(0, 0, w - 1, h / 4, redColour);
+		screen->line(0, 0, w / 4, h - 1, greenColour);
+	}
+	report(state, state.iterations() * 2);
+}
+BENCHMARK(BM_Line);
+
+static void BM_Circle(benchmark::State &state)
+{
+	uint16_t r = state.range(0);
+
+	begin();
+	while (state.KeepRunning())
+		screen->circle(screen->screenSizeX() / 2, screen->screenSizeY() / 2, r, yellowColour);
+	report(state, state.iterations());
+}
+BENCHMARK(BM_Circle)->Arg(10)->Arg(50);
+
+static void BM_CircleSolid(benchmark::State &state)
+{
+	uint16_t r = state.range(0);
+
+	begin();
+	while (state.KeepRunning()) {
+		screen->setPenSolid(true);
+		screen->circle(screen->screenSizeX() / 2, screen->screenSizeY() / 2, r, yellowColour);
+	}
+	report(state, state.iterations());
+}
+BENCHMARK(BM_CircleSolid)->Arg(10)->Arg(50);
+
+static void text(benchmark::State &state, uint8_t scale)
+{
+	while (state.KeepRunning())
+		screen->gText(0, 10, TEXT, whiteColour, blackColour, scale, scale);
+	report(state, state.iterations() * (sizeof(TEXT) - 1));
+}
+
+static void BM_Text(benchmark::State &state)
+{
+	begin();
+	text(state, 1);
+}
+BENCHMARK(BM_Text);
+
+static void BM_TextTransparent(benchmark::State &state)
+{
+	begin();
+	screen->setFontSolid(false);
+	text(state, 1);
+}
+BENCHMARK(BM_TextTransparent);
+
+static void BM_TextScaled(benchmark::State &state)
+{
+	begin();
+	text(state, 2);
+}
+BENCHMARK(BM_TextScaled);
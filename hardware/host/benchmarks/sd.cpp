@@ -0,0 +1,375 @@
+/*
+ ************************************************************************
+ *	sd.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The SD library's File API on a mapped disk image, FAT16 of 64 MB or
+ *	FAT32 of 256 MB as the benchmark's last argument says, both with 2 KB
+ *	clusters. Append writes records of the first argument's size to a
+ *	log, with a flush every 16, and Log does the same with a log from
+ *	SD.openLog(); RandomRead reads that many bytes at random places in a
+ *	file of 4 MB; OpenNested opens and closes a file
+ *	the argument's number of directories down; DirScan lists a directory
+ *	of that many files with openNextFile(), and DirRead goes through
+ *	the same entries with readDir(). Seek reads 64 bytes at random places
+ *	in a file of the first argument's size in MB, on a FAT32 image of
+ *	512 MB where the files are in runs of 2 MB, following the FAT or,
+ *	with a second argument of 1, with an extent map.
+ *
+ *	The counters are per item: "reads" and "writes" are blocks read and
+ *	written and "commands" the commands a card would have been sent.
+ *	They depend on SD_CACHE_BLOCKS, the blocks SdVolume caches; build
+ *	with "make clean all EXTRA_CFLAGS=-DSD_CACHE_BLOCKS=1" for the counts
+ *	with the one block an AVR or MSP430 has.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SD.h"
+#include "SdImageCard.h"
+#include "FatImage.h"
+#include "Benchmark.h"
+
+#define LOG_LIMIT (8L << 20)
+#define BIG_SIZE (4L << 20)
+
+static char image[] = "/tmp/sd_benchXXXXXX";
+static SdImageCard *card;
+static int fatType;
+static uint32_t fatBlocks;
+static bool ready;
+
+static void removeImage(void)
+{
+	unlink(image);
+}
+
+// A freshly formatted image of the given FAT type, of the default size
+// for the type unless blocks is given
+static bool mount(int type, uint32_t blocks = 0)
+{
+	FILE *f;
+
+	if (!blocks)
+		blocks = type == 16 ? 131072 : 524288;
+	if (type == fatType && blocks == fatBlocks)
+		return ready;
+	if (!card) {
+		int fd = mkstemp(image);
+
+		if (fd < 0)
+			return false;
+		close(fd);
+		atexit(removeImage);
+	}
+	delete card;
+	// start from an empty file so that it stays sparse
+	if (truncate(image, 0) != 0)
+		return false;
+	card = new SdImageCard(image, blocks);
+	f = fopen(image, "r+b");
+	// there is no SD.end(), a new SD forgets the last root directory
+	SD = SDClass();
+	ready = card->ok() && f && fatFormat(fileno(f), blocks, 4) == type &&
+			SD.begin();
+	if (f)
+		fclose(f);
+	fatType = type;
+	fatBlocks = blocks;
+	return ready;
+}
+
+static void report(benchmark::State &state, uint64_t items)
+{
+	unsigned long reads = card->blocksRead, writes = card->blocksWritten;
+	unsigned long commands = card->totalCommands();
+
+	state.SetItemsProcessed(items);
+	state.SetCounter("reads", (double)reads / items, true);
+	state.SetCounter("writes", (double)writes / items, true);
+	state.SetCounter("commands", (double)commands / items, true);
+	if (!ready)
+		state.SetLabel("NO CARD");
+}
+
+static void BM_SdAppend(benchmark::State &state)
+{
+	size_t size = state.range(0);
+	uint8_t record[512];
+	uint64_t records = 0;
+	File log;
+
+	memset(record, 'x', sizeof(record));
+	if (mount(state.range(1))) {
+		SD.remove((char *)"APPEND.LOG");
+		log = SD.open("APPEND.LOG", FILE_WRITE);
+	}
+	card->clear();
+	while (state.KeepRunning()) {
+		log.write(record, size);
+		if (++records % 16 == 0)
+			log.flush();
+		if (log.position() >= LOG_LIMIT) {
+			// start again, the counts left as they were
+			unsigned long commands[64];
+			unsigned long reads = card->blocksRead;
+			unsigned long writes = card->blocksWritten;
+
+			state.PauseTiming();
+			memcpy(commands, card->commands, sizeof(commands));
+			log.close();
+			SD.remove((char *)"APPEND.LOG");
+			log = SD.open("APPEND.LOG", FILE_WRITE);
+			memcpy(card->commands, commands, sizeof(commands));
+			card->blocksRead = reads;
+			card->blocksWritten = writes;
+			state.ResumeTiming();
+		}
+	}
+	log.close();
+	state.SetBytesProcessed(records * size);
+	report(state, records);
+}
+BENCHMARK(BM_SdAppend)->Args(32, 16)->Args(32, 32)->Args(512, 32);
+
+static void BM_SdLog(benchmark::State &state)
+{
+	size_t size = state.range(0);
+	uint8_t record[512];
+	uint64_t records = 0;
+	File log;
+
+	memset(record, 'x', sizeof(record));
+	if (mount(state.range(1)))
+		log = SD.openLog("DATA.LOG", LOG_LIMIT);
+	card->clear();
+	while (state.KeepRunning()) {
+		log.write(record, size);
+		if (++records % 16 == 0)
+			log.flush();
+		if (log.position() >= LOG_LIMIT) {
+			// start again, the counts left as they were
+			unsigned long commands[64];
+			unsigned long reads = card->blocksRead;
+			unsigned long writes = card->blocksWritten;
+
+			state.PauseTiming();
+			memcpy(commands, card->commands, sizeof(commands));
+			log.close();
+			log = SD.openLog("DATA.LOG", LOG_LIMIT);
+			memcpy(card->commands, commands, sizeof(commands));
+			card->blocksRead = reads;
+			card->blocksWritten = writes;
+			state.ResumeTiming();
+		}
+	}
+	if (log.lostRecords())
+		state.SetLabel("RECORDS LOST");
+	log.close();
+	state.SetBytesProcessed(records * size);
+	report(state, records);
+}
+BENCHMARK(BM_SdLog)->Args(32, 16)->Args(32, 32)->Args(512, 32);
+
+static void BM_SdRandomRead(benchmark::State &state)
+{
+	size_t size = state.range(0);
+	static uint8_t buf[8192];
+	uint32_t rng = 1;
+	File big;
+
+	if (mount(state.range(1))) {
+		if (!SD.exists((char *)"BIG.BIN")) {
+			File f = SD.open("BIG.BIN", FILE_WRITE);
+
+			for (long n = 0; n < BIG_SIZE; n += sizeof(buf))
+				f.write(buf, sizeof(buf));
+			f.close();
+		}
+		big = SD.open("BIG.BIN");
+	}
+	card->clear();
+	while (state.KeepRunning()) {
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		big.seek(rng % (BIG_SIZE - size));
+		big.read(buf, size);
+	}
+	big.close();
+	state.SetBytesProcessed(state.iterations() * size);
+	report(state, state.iterations());
+}
+BENCHMARK(BM_SdRandomRead)->Args(64, 16)->Args(64, 32)->Args(4096, 32);
+
+static void BM_SdOpenNested(benchmark::State &state)
+{
+	int depth = state.range(0);
+	char path[128];
+	int len = 0;
+
+	for (int i = 0; i < depth; i++)
+		len += sprintf(path + len, "D%d/", i);
+	if (mount(state.range(1))) {
+		path[len - 1] = 0;
+		SD.mkdir(path);
+		strcpy(path + len - 1, "/FILE.TXT");
+		SD.open(path, FILE_WRITE).close();
+	}
+	card->clear();
+	while (state.KeepRunning()) {
+		File f = SD.open(path);
+
+		f.close();
+	}
+	report(state, state.iterations());
+}
+BENCHMARK(BM_SdOpenNested)->Args(1, 16)->Args(4, 16)->Args(8, 32);
+
+// A directory of count files, made once for each count
+static const char *directory(int count)
+{
+	static char name[16];
+	char path[32];
+
+	sprintf(name, "DIR%d", count);
+	if (!SD.exists(name)) {
+		SD.mkdir(name);
+		for (int i = 0; i < count; i++) {
+			sprintf(path, "%s/F%d.TXT", name, i);
+			SD.open(path, FILE_WRITE).close();
+		}
+	}
+	return name;
+}
+
+static void BM_SdDirScan(benchmark::State &state)
+{
+	uint64_t files = 0;
+
+	if (mount(state.range(1)))
+		directory(state.range(0));
+	card->clear();
+	while (state.KeepRunning()) {
+		File dir = SD.open(directory(state.range(0)));
+
+		for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+			files++;
+			f.close();
+		}
+		dir.close();
+	}
+	report(state, files);
+	if (files != state.iterations() * state.range(0))
+		state.SetLabel("FILES MISSING");
+}
+BENCHMARK(BM_SdDirScan)->Args(256, 16)->Args(2048, 16)->Args(2048, 32);
+
+static void BM_SdDirRead(benchmark::State &state)
+{
+	uint64_t files = 0;
+	Sd2Card sd;
+	SdVolume volume;
+	SdFile root, dir;
+	dir_t entry;
+
+	// the volume SD has, but where the directory can be had as an SdFile
+	if (mount(state.range(1))) {
+		directory(state.range(0));
+		sd.init();
+		volume.init(&sd);
+		root.openRoot(&volume);
+		dir.open(&root, directory(state.range(0)), O_READ);
+	}
+	card->clear();
+	while (state.KeepRunning()) {
+		dir.rewind();
+		while (dir.readDir(&entry) > 0 && entry.name[0] != DIR_NAME_FREE) {
+			if (DIR_IS_FILE(&entry))
+				files++;
+		}
+	}
+	dir.close();
+	report(state, files);
+	if (files != state.iterations() * state.range(0))
+		state.SetLabel("FILES MISSING");
+}
+BENCHMARK(BM_SdDirRead)->Args(256, 16)->Args(2048, 16)->Args(2048, 32);
+
+// A file of size MB in runs of 2 MB, with a cluster of GAPS.BIN after each
+static const char *fragmented(long size)
+{
+	static char name[16];
+	static uint8_t buf[8192];
+
+	sprintf(name, "SEEK%ld.BIN", size);
+	if (!SD.exists(name)) {
+		File f = SD.open(name, FILE_WRITE);
+		File gaps = SD.open("GAPS.BIN", FILE_WRITE);
+
+		for (long n = 1; n <= (size << 20) / (long)sizeof(buf); n++) {
+			f.write(buf, sizeof(buf));
+			if (n % ((2L << 20) / sizeof(buf)) == 0)
+				gaps.write(buf, 2048);
+		}
+		gaps.close();
+		f.close();
+	}
+	return name;
+}
+
+static void BM_SdSeek(benchmark::State &state)
+{
+	uint32_t size = state.range(0) << 20;
+	static fat_extent_t map[256];
+	uint8_t buf[64];
+	uint32_t rng = 1;
+	Sd2Card sd;
+	SdVolume volume;
+	SdFile root, file;
+
+	if (mount(32, 1048576)) {
+		const char *name = fragmented(state.range(0));
+
+		sd.init();
+		volume.init(&sd);
+		root.openRoot(&volume);
+		file.open(&root, name, O_READ);
+		if (state.range(1))
+			file.setExtentMap(map, 256);
+	}
+	card->clear();
+	while (state.KeepRunning()) {
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		file.seekSet(rng % (size - sizeof(buf)));
+		file.read(buf, sizeof(buf));
+	}
+	state.SetBytesProcessed(state.iterations() * sizeof(buf));
+	report(state, state.iterations());
+	state.SetCounter("extents", file.extentCount(), true);
+	if (file.fileSize() != size)
+		state.SetLabel("NO FILE");
+	file.close();
+}
+BENCHMARK(BM_SdSeek)->Args(1, 0)->Args(1, 1)->Args(16, 0)->Args(16, 1)
+		->Args(256, 0)->Args(256, 1);
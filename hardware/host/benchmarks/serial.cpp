@@ -0,0 +1,225 @@
+/*
+ ************************************************************************
+ *	serial.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	HardwareSerial TX throughput. Serial is begun on the simulated UART0
+ *	with its output counted and discarded; every iteration writes a block
+ *	and waits for it to leave the UART. "Unpaced" runs drain the FIFO as
+ *	fast as the simulator can, "paced" runs model a 1 MB/s line so the CPU
+ *	time per KB shows what the driver costs while the line is the limit.
+ *	Blocks up to 255 bytes fit the default 256 byte TX buffer.
+ *
+ *	RX throughput, interrupt driven (begin) against uDMA (beginDMA): every
+ *	iteration puts a block on the wire and reads it back. Interrupt
+ *	handlers run on the simulator thread, so besides the reader's CPU time
+ *	"irqs" counts handler runs and "sim_ns" the CPU the rest of the process
+ *	spent per iteration.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include "Energia.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "Benchmark.h"
+
+static volatile uint64_t sinkBytes;
+static uint32_t irqStart;
+static int serialMode = -1;
+
+static void countingSink(uint32_t base, const uint8_t *data, size_t len,
+		void *arg)
+{
+	sinkBytes += len;
+}
+
+static void serialBegin(bool dma)
+{
+	if (serialMode != dma) {
+		if (dma)
+			Serial.beginDMA(115200);
+		else
+			Serial.begin(115200);
+		serialMode = dma;
+	}
+}
+
+static void serialSetup(uint32_t lineRate)
+{
+	if (serialMode < 0)
+		serialBegin(false);
+	Serial.flush();
+	HostUARTSetSink(UART0_BASE, countingSink, 0);
+	HostUARTSetLineRate(UART0_BASE, lineRate);
+	irqStart = HostIntCount(INT_UART0);
+	sinkBytes = 0;
+}
+
+static void serialReport(benchmark::State &state, size_t len)
+{
+	state.SetBytesProcessed(state.iterations() * len);
+	state.SetCounter("irqs", HostIntCount(INT_UART0) - irqStart);
+	if (sinkBytes != state.iterations() * len)
+		state.SetLabel("LOST BYTES");
+}
+
+// With a paced line only the write is timed: the CPU cost of handing data
+// to the driver, not of waiting for the wire.
+static void writeBlock(benchmark::State &state, uint32_t lineRate, bool bytewise)
+{
+	size_t len = state.range(0);
+	uint8_t *buf = (uint8_t *)malloc(len);
+
+	for (size_t i = 0; i < len; i++)
+		buf[i] = 'A' + i % 26;
+
+	serialSetup(lineRate);
+	while (state.KeepRunning()) {
+		if (bytewise) {
+			for (size_t i = 0; i < len; i++)
+				Serial.write(buf[i]);
+		} else {
+			Serial.write(buf, len);
+		}
+		if (lineRate) {
+			// Leave the drain to the TX interrupt
+			state.PauseTiming();
+			while (sinkBytes < state.iterations() * len)
+				sched_yield();
+			state.ResumeTiming();
+		} else {
+			Serial.flush();
+		}
+	}
+	serialReport(state, len);
+	free(buf);
+}
+
+static void BM_SerialWrite(benchmark::State &state)
+{
+	writeBlock(state, 0, false);
+}
+BENCHMARK(BM_SerialWrite)->Arg(16)->Arg(64)->Arg(1024)->Arg(4096);
+
+static void BM_SerialWritePaced(benchmark::State &state)
+{
+	writeBlock(state, 1000000, false);
+}
+BENCHMARK(BM_SerialWritePaced)->Arg(64)->Arg(255)->Arg(1024);
+
+// The same data one write(uint8_t) at a time
+static void BM_SerialWriteBytes(benchmark::State &state)
+{
+	writeBlock(state, 0, true);
+}
+BENCHMARK(BM_SerialWriteBytes)->Arg(1024);
+
+static void BM_SerialWriteBytesPaced(benchmark::State &state)
+{
+	writeBlock(state, 1000000, true);
+}
+BENCHMARK(BM_SerialWriteBytesPaced)->Arg(255);
+
+static void BM_SerialPrint(benchmark::State &state)
+{
+	static const char line[] = "The quick brown fox jumps over the lazy dog";
+
+	serialSetup(0);
+	while (state.KeepRunning()) {
+		Serial.println(line);
+		Serial.flush();
+	}
+	serialReport(state, sizeof(line) + 1);
+}
+BENCHMARK(BM_SerialPrint);
+
+static uint64_t processCPUNanos(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void readBlock(benchmark::State &state, uint32_t lineRate, bool dma)
+{
+	size_t len = state.range(0);
+	uint8_t *buf = (uint8_t *)malloc(len);
+	uint64_t cpuStart, threadStart;
+	bool bad = false;
+
+	for (size_t i = 0; i < len; i++)
+		buf[i] = 'A' + i % 26;
+
+	serialBegin(dma);
+	HostUARTSetLineRate(UART0_BASE, lineRate);
+	while (Serial.read() >= 0)
+		;
+	irqStart = HostIntCount(INT_UART0);
+	cpuStart = processCPUNanos();
+	threadStart = HostThreadCPUNanos();
+	while (state.KeepRunning()) {
+		HostUARTReceive(UART0_BASE, buf, len);
+		for (size_t i = 0; i < len; ) {
+			int c = Serial.read();
+
+			if (c < 0) {
+				sched_yield();
+				continue;
+			}
+			bad |= c != buf[i++];
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * len);
+	state.SetCounter("irqs", HostIntCount(INT_UART0) - irqStart);
+	state.SetCounter("sim_ns", (processCPUNanos() - cpuStart) -
+			(HostThreadCPUNanos() - threadStart));
+	if (bad)
+		state.SetLabel("BAD DATA");
+	HostUARTSetLineRate(UART0_BASE, 0);
+	free(buf);
+}
+
+static void BM_SerialRead(benchmark::State &state)
+{
+	readBlock(state, 0, false);
+}
+BENCHMARK(BM_SerialRead)->Arg(64)->Arg(1024);
+
+static void BM_SerialReadDMA(benchmark::State &state)
+{
+	readBlock(state, 0, true);
+}
+BENCHMARK(BM_SerialReadDMA)->Arg(64)->Arg(1024);
+
+// 92 kB/s, a 921600 baud line
+static void BM_SerialReadPaced(benchmark::State &state)
+{
+	readBlock(state, 92160, false);
+}
+BENCHMARK(BM_SerialReadPaced)->Arg(1024);
+
+static void BM_SerialReadPacedDMA(benchmark::State &state)
+{
+	readBlock(state, 92160, true);
+}
+BENCHMARK(BM_SerialReadPacedDMA)->Arg(1024);
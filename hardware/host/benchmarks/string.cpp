@@ -0,0 +1,194 @@
+/*
+ ************************************************************************
+ *	string.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	String heap behaviour. "allocs" counts malloc() and realloc() calls
+ *	per iteration, made by wrapping the C library's allocator.
+ *
+ *	Concat builds a string one character at a time, Sum formats a typical
+ *	sensor report with operator+, Short makes and compares the short
+ *	numeric strings sketches use most.
+ *
+ *	Fragmentation runs 10000 random operations (assign, append, substring,
+ *	replace, remove) on 32 live strings and then reports the heap as the C
+ *	library sees it: its size, the bytes the strings hold, the free bytes
+ *	left behind in between, and the number of free chunks.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <malloc.h>
+#include <stdlib.h>
+#include "WString.h"
+#include "Benchmark.h"
+
+static uint64_t allocations;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+}
+
+static void reportAllocations(benchmark::State &state, uint64_t start)
+{
+	state.SetCounter("allocs", (double)(allocations - start) /
+			state.iterations(), true);
+}
+
+static void BM_StringConcat(benchmark::State &state)
+{
+	int len = state.range(0);
+	uint64_t start = allocations;
+
+	while (state.KeepRunning()) {
+		String s;
+
+		for (int i = 0; i < len; i++)
+			s += (char)('a' + i % 26);
+		benchmark::DoNotOptimize(s.c_str());
+	}
+	state.SetBytesProcessed(state.iterations() * len);
+	reportAllocations(state, start);
+}
+BENCHMARK(BM_StringConcat)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_StringSum(benchmark::State &state)
+{
+	String id("node-7");
+	int t = 0;
+	uint64_t start = allocations;
+
+	while (state.KeepRunning()) {
+		String line = "id=" + id + " t=" + t + " temp=" + (t % 40) +
+				" rh=" + (t % 100) + " status=" + (t & 1 ? "ok" : "warn");
+
+		benchmark::DoNotOptimize(line.c_str());
+		t++;
+	}
+	state.SetItemsProcessed(state.iterations());
+	reportAllocations(state, start);
+}
+BENCHMARK(BM_StringSum);
+
+static void BM_StringShort(benchmark::State &state)
+{
+	long n = 0;
+	uint64_t start = allocations;
+
+	while (state.KeepRunning()) {
+		String a(n);
+		String b(n & 0xff, 16);
+		String c = a;
+
+		c += 'C';
+		benchmark::DoNotOptimize(c == b);
+		n += 37;
+	}
+	state.SetItemsProcessed(state.iterations());
+	reportAllocations(state, start);
+}
+BENCHMARK(BM_StringShort);
+
+#define POOL 32
+#define OPERATIONS 10000
+
+static uint32_t rng = 1;
+
+static uint32_t random32(void)
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static void mixedOperations(String *pool)
+{
+	static const char text[] = "The quick brown fox jumps over the lazy dog "
+			"while the five boxing wizards jump quickly";
+
+	for (int op = 0; op < OPERATIONS; op++) {
+		unsigned int i = random32() % POOL;
+		String &s = pool[i];
+		// Some string other than s
+		String &other = pool[(i + 1 + random32() % (POOL - 1)) % POOL];
+		unsigned int n = random32() % (sizeof(text) - 1);
+
+		switch (random32() % 6) {
+		case 0:
+			s = text + n;
+			break;
+		case 1:
+			s += (long)random32();
+			break;
+		case 2:
+			s += other;
+			if (s.length() > 1000)
+				s = "";
+			break;
+		case 3:
+			s = other.substring(n % 8, n);
+			break;
+		case 4:
+			s.replace("o", "00");
+			break;
+		case 5:
+			s.remove(n % 4, n % 16);
+			break;
+		}
+	}
+}
+
+static void BM_StringFragmentation(benchmark::State &state)
+{
+	uint64_t start = allocations;
+	struct mallinfo2 base = mallinfo2();
+	struct mallinfo2 heap = base;
+
+	while (state.KeepRunning()) {
+		String *pool = new String[POOL];
+
+		rng = 1;
+		mixedOperations(pool);
+		state.PauseTiming();
+		heap = mallinfo2();
+		state.ResumeTiming();
+		delete[] pool;
+	}
+	state.SetItemsProcessed(state.iterations() * OPERATIONS);
+	reportAllocations(state, start);
+	state.SetCounter("heap_kb", heap.arena / 1024.0, true);
+	state.SetCounter("used_kb", (heap.uordblks - base.uordblks) / 1024.0,
+			true);
+	state.SetCounter("free_kb", heap.fordblks / 1024.0, true);
+	state.SetCounter("free_chunks", heap.ordblks, true);
+}
+BENCHMARK(BM_StringFragmentation);
@@ -0,0 +1,193 @@
+/*
+ ************************************************************************
+ *	w5100.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	An HTTP download of 64 KB through the Ethernet library from a model
+ *	of a W5100 on SSI2, the server sending segments of 1460 bytes. Get
+ *	connects, sends the request and reads the response a byte at a time
+ *	with EthernetClient::read(), served from the socket's receive cache,
+ *	or, as GetLegacy, the way read() did before: a size check, a one byte
+ *	read and a RECV command for every byte. GetBuffer reads it with
+ *	read(buf, n) for the argument's n.
+ *
+ *	Read takes 2 KB of a socket buffer in frames of four bytes sent as
+ *	one SPI.transfer(buf, 4) burst, ReadLegacy with four transfer()s
+ *	each, as W5100Class::read() did.
+ *
+ *	Items are bytes of the response or of the buffer; "frames" counts
+ *	the frames the chip took a byte and "regs" the SSI and GPIO register
+ *	accesses a byte.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "SPI.h"
+#include "Ethernet.h"
+#include "W5100Model.h"
+#include "Benchmark.h"
+
+#define BODY_SIZE (64L << 10)
+
+static uint8_t response[BODY_SIZE + 128];
+static size_t responseLen;
+static W5100Model *w5100;
+
+static void begin(void)
+{
+	static uint8_t mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
+
+	if (!w5100) {
+		w5100 = new W5100Model();
+		Ethernet.begin(mac, IPAddress(192, 168, 1, 177));
+		responseLen = snprintf((char *)response, sizeof(response),
+				"HTTP/1.1 200 OK\r\nContent-Length: %ld\r\n"
+				"Connection: close\r\n\r\n", BODY_SIZE);
+		for (long i = 0; i < BODY_SIZE; i++)
+			response[responseLen++] = i * 7;
+		w5100->serve(response, responseLen);
+	}
+	w5100->clear();
+	HostRegStatsReset();
+}
+
+static void report(benchmark::State &state, uint64_t bytes)
+{
+	state.SetItemsProcessed(bytes);
+	state.SetBytesProcessed(bytes);
+	state.SetCounter("frames", (double)w5100->frames / bytes, true);
+	state.SetCounter("regs", (double)(g_sHostRegStats.reads +
+			g_sHostRegStats.writes) / bytes, true);
+}
+
+static void request(EthernetClient &client)
+{
+	client.connect(IPAddress(192, 168, 1, 1), 80);
+	client.print("GET /download HTTP/1.1\r\nHost: 192.168.1.1\r\n\r\n");
+}
+
+//
+// EthernetClient::read() as it was
+//
+static int legacyRead(SOCKET s)
+{
+	uint8_t b;
+	int16_t ret = W5100.getRXReceivedSize(s);
+
+	if (ret == 0)
+		return -1;
+	W5100.recv_data_processing(s, &b, 1);
+	W5100.execCmdSn(s, Sock_RECV);
+	return b;
+}
+
+static void BM_GetLegacy(benchmark::State &state)
+{
+	uint64_t bytes = 0;
+
+	begin();
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		request(client);
+		while (legacyRead(0) >= 0)
+			bytes++;
+		client.stop();
+	}
+	report(state, bytes);
+}
+BENCHMARK(BM_GetLegacy);
+
+static void BM_Get(benchmark::State &state)
+{
+	uint64_t bytes = 0;
+
+	begin();
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		request(client);
+		while (client.read() >= 0)
+			bytes++;
+		client.stop();
+	}
+	report(state, bytes);
+}
+BENCHMARK(BM_Get);
+
+static void BM_GetBuffer(benchmark::State &state)
+{
+	uint8_t buf[2048];
+	size_t size = state.range(0);
+	uint64_t bytes = 0;
+	int n;
+
+	begin();
+	while (state.KeepRunning()) {
+		EthernetClient client;
+
+		request(client);
+		while ((n = client.read(buf, size)) > 0)
+			bytes += n;
+		client.stop();
+	}
+	report(state, bytes);
+}
+BENCHMARK(BM_GetBuffer)->Arg(16)->Arg(256)->Arg(2048);
+
+//
+// W5100Class::read(addr, buf, len) as it was
+//
+static void legacyReadBuffer(PinHandle ss, uint16_t addr, uint8_t *buf,
+		uint16_t len)
+{
+	for (uint16_t i = 0; i < len; i++) {
+		fastWrite(ss, LOW);
+		SPI.transfer(0x0F);
+		SPI.transfer(addr >> 8);
+		SPI.transfer(addr & 0xFF);
+		addr++;
+		buf[i] = SPI.transfer(0);
+		fastWrite(ss, HIGH);
+	}
+}
+
+static void BM_ReadLegacy(benchmark::State &state)
+{
+	PinHandle ss = pinHandle(W5100_SS);
+	uint8_t buf[2048];
+
+	begin();
+	while (state.KeepRunning())
+		legacyReadBuffer(ss, 0x6000, buf, sizeof(buf));
+	report(state, state.iterations() * sizeof(buf));
+}
+BENCHMARK(BM_ReadLegacy);
+
+static void BM_Read(benchmark::State &state)
+{
+	uint8_t buf[2048];
+
+	begin();
+	while (state.KeepRunning())
+		W5100.read_data(0, 0, buf, sizeof(buf));
+	report(state, state.iterations() * sizeof(buf));
+}
+BENCHMARK(BM_Read);
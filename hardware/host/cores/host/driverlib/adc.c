@@ -0,0 +1,138 @@
+//*****************************************************************************
+//
+// adc.c - Host model of the ADC.
+//
+// A processor trigger converts every configured step of the sequence at
+// once: each step reads the value the host set for its channel with
+// HostADCSet() into the sequence FIFO and raises the sequence's raw
+// interrupt if the step has ADC_CTL_IE.
+//
+//*****************************************************************************
+
+#include "inc/hw_types.h"
+#include "inc/hw_adc.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/adc.h"
+#include "host.h"
+
+#define ADC_SEQ_NUM             4
+#define ADC_SEQ_DEPTH           8
+#define ADC_CHANNELS            32
+
+typedef struct
+{
+    uint32_t pui32Step[ADC_SEQ_DEPTH];
+    unsigned int uiSteps;
+    uint32_t pui32Fifo[ADC_SEQ_DEPTH];
+    unsigned int uiCount;
+}
+tHostADCSeq;
+
+static tHostADCSeq g_psHostADCSeq[2][ADC_SEQ_NUM];
+
+//
+// ADC_CTL_CH16 and up carry the channel's upper bit in bit 8.
+//
+#define ADC_CTL_CHANNEL(c)      ((((c) >> 4) & 0x10) | ((c) & 0x0F))
+static uint32_t g_pui32HostADCValue[ADC_CHANNELS];
+
+static tHostADCSeq *
+HostADCSeq(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    return &g_psHostADCSeq[ui32Base == ADC1_BASE][ui32SequenceNum & 3];
+}
+
+void
+HostADCSet(uint32_t ui32Channel, uint32_t ui32Value)
+{
+    g_pui32HostADCValue[ui32Channel % ADC_CHANNELS] = ui32Value & 0xFFF;
+}
+
+void
+ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                     uint32_t ui32Trigger, uint32_t ui32Priority)
+{
+    HostADCSeq(ui32Base, ui32SequenceNum)->uiSteps = 0;
+}
+
+void
+ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                         uint32_t ui32Step, uint32_t ui32Config)
+{
+    tHostADCSeq *psSeq = HostADCSeq(ui32Base, ui32SequenceNum);
+
+    g_sHostRegStats.writes++;
+    psSeq->pui32Step[ui32Step % ADC_SEQ_DEPTH] = ui32Config;
+    if(ui32Step >= psSeq->uiSteps)
+    {
+        psSeq->uiSteps = ui32Step + 1;
+    }
+}
+
+void
+ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    HostRegWrite(ui32Base + ADC_O_ACTSS,
+                 HWREG(ui32Base + ADC_O_ACTSS) | (1 << ui32SequenceNum));
+}
+
+void
+ADCSequenceDisable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    HostRegWrite(ui32Base + ADC_O_ACTSS,
+                 HWREG(ui32Base + ADC_O_ACTSS) & ~(1 << ui32SequenceNum));
+}
+
+void
+ADCProcessorTrigger(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    tHostADCSeq *psSeq = HostADCSeq(ui32Base, ui32SequenceNum);
+    unsigned int i;
+    uint32_t ui32Config;
+
+    g_sHostRegStats.writes++;
+    psSeq->uiCount = 0;
+    for(i = 0; i < psSeq->uiSteps; i++)
+    {
+        ui32Config = psSeq->pui32Step[i];
+        psSeq->pui32Fifo[psSeq->uiCount++] =
+            g_pui32HostADCValue[ADC_CTL_CHANNEL(ui32Config)];
+        if(ui32Config & ADC_CTL_IE)
+        {
+            HWREG(ui32Base + ADC_O_RIS) |= 1 << (ui32SequenceNum & 3);
+        }
+        if(ui32Config & ADC_CTL_END)
+        {
+            break;
+        }
+    }
+}
+
+uint32_t
+ADCIntStatus(uint32_t ui32Base, uint32_t ui32SequenceNum, bool bMasked)
+{
+    return HostRegRead(ui32Base + ADC_O_RIS) & (1 << (ui32SequenceNum & 3));
+}
+
+void
+ADCIntClear(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    HostRegWrite(ui32Base + ADC_O_RIS,
+                 HWREG(ui32Base + ADC_O_RIS) & ~(1 << (ui32SequenceNum & 3)));
+}
+
+int32_t
+ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                   uint32_t *pui32Buffer)
+{
+    tHostADCSeq *psSeq = HostADCSeq(ui32Base, ui32SequenceNum);
+    unsigned int i;
+
+    for(i = 0; i < psSeq->uiCount; i++)
+    {
+        g_sHostRegStats.reads++;
+        pui32Buffer[i] = psSeq->pui32Fifo[i];
+    }
+    psSeq->uiCount = 0;
+    return i;
+}
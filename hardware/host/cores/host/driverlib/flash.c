@@ -0,0 +1,30 @@
+//*****************************************************************************
+//
+// flash.c - Host model of the Flash memory controller.
+//
+// Only the user registers are modelled; the TM4C129 boards keep their MAC
+// address in them. They live in the simulated register file, so a test can
+// program them with FlashUserSet() before the code under test reads them.
+//
+//*****************************************************************************
+
+#include "inc/hw_flash.h"
+#include "inc/hw_types.h"
+#include "driverlib/flash.h"
+#include "host.h"
+
+int32_t
+FlashUserGet(uint32_t *pui32User0, uint32_t *pui32User1)
+{
+    *pui32User0 = HostRegRead(FLASH_USERREG0);
+    *pui32User1 = HostRegRead(FLASH_USERREG1);
+    return 0;
+}
+
+int32_t
+FlashUserSet(uint32_t ui32User0, uint32_t ui32User1)
+{
+    HostRegWrite(FLASH_USERREG0, ui32User0);
+    HostRegWrite(FLASH_USERREG1, ui32User1);
+    return 0;
+}
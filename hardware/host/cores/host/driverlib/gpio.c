@@ -0,0 +1,277 @@
+//*****************************************************************************
+//
+// gpio.c - Host model of the GPIO ports.
+//
+// Port registers live in the simulated register file at their target
+// offsets. The output latch is the fully unmasked DATA address
+// (GPIO_O_DATA + 0x3FC); input levels are driven from the host with
+// HostGPIOInputSet() and read back through pins configured as inputs.
+// Masked DATA accesses of the core's pin handles come through
+// HostGPIODataRead()/HostGPIODataWrite(). Interrupt registers are kept but
+// edges are not generated.
+//
+//*****************************************************************************
+
+#include "inc/hw_types.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "host.h"
+
+#define GPIO_DATA_ALL           (GPIO_O_DATA + (0xFF << 2))
+
+static uint8_t g_pui8HostGPIOInput[256];
+static HostGPIOWatch g_pfnHostGPIOWatch;
+
+static uint8_t *
+HostGPIOInput(uint32_t ui32Port)
+{
+    return &g_pui8HostGPIOInput[(ui32Port >> 12) & 0xFF];
+}
+
+static void
+HostGPIOModify(uint32_t ui32Addr, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint32_t ui32Reg = HostRegRead(ui32Addr);
+
+    HostRegWrite(ui32Addr, (ui32Reg & ~ui8Pins) | (ui8Val & ui8Pins));
+}
+
+void
+HostGPIOInputSet(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint8_t *pui8Input = HostGPIOInput(ui32Port);
+
+    *pui8Input = (*pui8Input & ~ui8Pins) | (ui8Val & ui8Pins);
+}
+
+uint8_t
+HostGPIOOutputGet(uint32_t ui32Port)
+{
+    return HWREG(ui32Port + GPIO_DATA_ALL) & HWREG(ui32Port + GPIO_O_DIR);
+}
+
+void
+HostGPIOSetWatch(HostGPIOWatch pfnWatch)
+{
+    g_pfnHostGPIOWatch = pfnWatch;
+}
+
+static void
+HostGPIOLatch(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint32_t ui32Reg = HWREG(ui32Port + GPIO_DATA_ALL);
+    uint32_t ui32New = (ui32Reg & ~ui8Pins) | (ui8Val & ui8Pins);
+
+    HostRegWrite(ui32Port + GPIO_DATA_ALL, ui32New);
+    if(g_pfnHostGPIOWatch)
+    {
+        g_pfnHostGPIOWatch(ui32Port, ui32Reg, ui32New);
+    }
+}
+
+//
+// A handle's address is DATA + (pins << 2) of a port, or a word of the
+// core's own for a pin that is not one
+//
+static bool
+HostGPIOData(volatile uint32_t *pui32Addr, uint32_t *pui32Port,
+             uint8_t *pui8Pins)
+{
+    uintptr_t addr = (uintptr_t)pui32Addr;
+
+    if(addr < GPIO_PORTA_BASE || addr >= GPIO_PORTA_BASE + 0x80000 ||
+       (addr & 0xC03) != GPIO_O_DATA)
+    {
+        return false;
+    }
+    *pui32Port = addr & ~0xFFF;
+    *pui8Pins = (addr >> 2) & 0xFF;
+    return true;
+}
+
+uint32_t
+HostGPIODataRead(volatile uint32_t *pui32Addr)
+{
+    uint32_t ui32Port;
+    uint8_t ui8Pins;
+
+    if(!HostGPIOData(pui32Addr, &ui32Port, &ui8Pins))
+    {
+        return *pui32Addr;
+    }
+    return GPIOPinRead(ui32Port, ui8Pins);
+}
+
+void
+HostGPIODataWrite(volatile uint32_t *pui32Addr, uint32_t ui32Value)
+{
+    uint32_t ui32Port;
+    uint8_t ui8Pins;
+
+    if(!HostGPIOData(pui32Addr, &ui32Port, &ui8Pins))
+    {
+        *pui32Addr = ui32Value;
+        return;
+    }
+    HostGPIOLatch(ui32Port, ui8Pins, ui32Value);
+}
+
+void
+GPIODirModeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32PinIO)
+{
+    HostGPIOModify(ui32Port + GPIO_O_DIR, ui8Pins,
+                   (ui32PinIO & 1) ? 0xFF : 0x00);
+    HostGPIOModify(ui32Port + GPIO_O_AFSEL, ui8Pins,
+                   (ui32PinIO & 2) ? 0xFF : 0x00);
+}
+
+uint32_t
+GPIODirModeGet(uint32_t ui32Port, uint8_t ui8Pin)
+{
+    uint8_t ui8Bit = 1 << ui8Pin;
+
+    return (((HostRegRead(ui32Port + GPIO_O_DIR) & ui8Bit) ? 1 : 0) |
+            ((HostRegRead(ui32Port + GPIO_O_AFSEL) & ui8Bit) ? 2 : 0));
+}
+
+void
+GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType)
+{
+    HostGPIOModify(ui32Port + GPIO_O_IBE, ui8Pins,
+                   (ui32IntType & 1) ? 0xFF : 0x00);
+    HostGPIOModify(ui32Port + GPIO_O_IS, ui8Pins,
+                   (ui32IntType & 2) ? 0xFF : 0x00);
+    HostGPIOModify(ui32Port + GPIO_O_IEV, ui8Pins,
+                   (ui32IntType & 4) ? 0xFF : 0x00);
+}
+
+void
+GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength,
+                 uint32_t ui32PinType)
+{
+    HostGPIOModify(ui32Port + GPIO_O_DEN, ui8Pins, 0xFF);
+}
+
+void
+GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    HostGPIOModify(ui32Port + GPIO_O_IM, ui32IntFlags, 0xFF);
+}
+
+void
+GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    HostGPIOModify(ui32Port + GPIO_O_IM, ui32IntFlags, 0x00);
+}
+
+uint32_t
+GPIOIntStatus(uint32_t ui32Port, bool bMasked)
+{
+    return HostRegRead(ui32Port + (bMasked ? GPIO_O_MIS : GPIO_O_RIS));
+}
+
+void
+GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    HostGPIOModify(ui32Port + GPIO_O_RIS, ui32IntFlags, 0x00);
+    HostGPIOModify(ui32Port + GPIO_O_MIS, ui32IntFlags, 0x00);
+}
+
+int32_t
+GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    uint32_t ui32Dir = HWREG(ui32Port + GPIO_O_DIR);
+    uint32_t ui32Data = HostRegRead(ui32Port + GPIO_DATA_ALL);
+
+    return ((ui32Data & ui32Dir) | (*HostGPIOInput(ui32Port) & ~ui32Dir)) &
+           ui8Pins;
+}
+
+void
+GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    //
+    // The target does this in a single masked store to DATA + (pins << 2);
+    // the model counts it as one write.
+    //
+    HostGPIOLatch(ui32Port, ui8Pins, ui8Val);
+}
+
+void
+GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+}
+
+static void
+HostGPIOPinType(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32PinIO)
+{
+    GPIODirModeSet(ui32Port, ui8Pins, ui32PinIO);
+    GPIOPadConfigSet(ui32Port, ui8Pins, 0, 0);
+}
+
+void
+GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_IN);
+}
+
+void
+GPIOPinTypeEthernetLED(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_IN);
+}
+
+void
+GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_OUT);
+}
+
+void
+GPIOPinTypeGPIOOutputOD(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_OUT);
+}
+
+void
+GPIOPinTypeI2C(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypeI2CSCL(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypePWM(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypeSSI(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypeTimer(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostGPIOPinType(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
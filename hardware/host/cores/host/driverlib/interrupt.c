@@ -0,0 +1,257 @@
+//*****************************************************************************
+//
+// interrupt.c - Host model of the NVIC Interrupt Controller.
+//
+// Handlers are looked up in a vector table laid out like the one in
+// startup_gcc.c and run on the simulator thread. A recursive lock is held
+// for the duration of a handler; IntDisable() and IntMasterDisable() take it
+// too so they return only once no handler is in flight.
+//
+//*****************************************************************************
+
+#include <pthread.h>
+#include "Energia.h"
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "host.h"
+
+//*****************************************************************************
+//
+// The handlers referenced by the host vector table. As in startup_gcc.c,
+// handlers of peripherals that are not linked in fall back to a stub.
+//
+//*****************************************************************************
+__attribute__((weak)) void UARTIntHandler(void) {}
+__attribute__((weak)) void UARTIntHandler1(void) {}
+__attribute__((weak)) void UARTIntHandler2(void) {}
+__attribute__((weak)) void UARTIntHandler3(void) {}
+__attribute__((weak)) void UARTIntHandler4(void) {}
+__attribute__((weak)) void UARTIntHandler5(void) {}
+__attribute__((weak)) void UARTIntHandler6(void) {}
+__attribute__((weak)) void UARTIntHandler7(void) {}
+__attribute__((weak)) void GPIOAIntHandler(void) {}
+__attribute__((weak)) void GPIOBIntHandler(void) {}
+__attribute__((weak)) void GPIOCIntHandler(void) {}
+__attribute__((weak)) void GPIODIntHandler(void) {}
+__attribute__((weak)) void GPIOEIntHandler(void) {}
+__attribute__((weak)) void GPIOFIntHandler(void) {}
+__attribute__((weak)) void ToneIntHandler(void) {}
+__attribute__((weak)) void SysTickIntHandler(void) {}
+
+static void (*g_pfnHostVectors[NUM_INTERRUPTS])(void) =
+{
+    [FAULT_SYSTICK] = SysTickIntHandler,
+    [INT_GPIOA] = GPIOAIntHandler,
+    [INT_GPIOB] = GPIOBIntHandler,
+    [INT_GPIOC] = GPIOCIntHandler,
+    [INT_GPIOD] = GPIODIntHandler,
+    [INT_GPIOE] = GPIOEIntHandler,
+    [INT_GPIOF] = GPIOFIntHandler,
+    [INT_UART0] = UARTIntHandler,
+    [INT_UART1] = UARTIntHandler1,
+    [INT_UART2] = UARTIntHandler2,
+    [INT_UART3] = UARTIntHandler3,
+    [INT_UART4] = UARTIntHandler4,
+    [INT_UART5] = UARTIntHandler5,
+    [INT_UART6] = UARTIntHandler6,
+    [INT_UART7] = UARTIntHandler7,
+    [INT_TIMER4A] = ToneIntHandler,
+};
+
+static pthread_mutex_t g_sIntMutex;
+static pthread_once_t g_sIntOnce = PTHREAD_ONCE_INIT;
+static __thread bool g_bInHandler;
+
+static volatile bool g_bMasterDisabled;
+static volatile bool g_pbEnabled[NUM_INTERRUPTS];
+static volatile bool g_pbPending[NUM_INTERRUPTS];
+static volatile uint32_t g_pui32Count[NUM_INTERRUPTS];
+
+static void
+HostIntInit(void)
+{
+    pthread_mutexattr_t sAttr;
+
+    pthread_mutexattr_init(&sAttr);
+    pthread_mutexattr_settype(&sAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&g_sIntMutex, &sAttr);
+    pthread_mutexattr_destroy(&sAttr);
+}
+
+static void
+HostIntLock(void)
+{
+    pthread_once(&g_sIntOnce, HostIntInit);
+    pthread_mutex_lock(&g_sIntMutex);
+}
+
+static void
+HostIntUnlock(void)
+{
+    pthread_mutex_unlock(&g_sIntMutex);
+}
+
+//*****************************************************************************
+//
+// Runs every pending, enabled handler. Called from the simulator thread.
+//
+//*****************************************************************************
+void
+HostIntService(void)
+{
+    uint32_t ui32Int;
+
+    for(ui32Int = 0; ui32Int < NUM_INTERRUPTS; ui32Int++)
+    {
+        if(!g_pbPending[ui32Int] || !g_pbEnabled[ui32Int] || g_bMasterDisabled)
+        {
+            continue;
+        }
+
+        HostIntLock();
+        if(g_pbPending[ui32Int] && g_pbEnabled[ui32Int] && !g_bMasterDisabled)
+        {
+            g_pbPending[ui32Int] = false;
+            g_pui32Count[ui32Int]++;
+            if(g_pfnHostVectors[ui32Int])
+            {
+                g_bInHandler = true;
+                g_pfnHostVectors[ui32Int]();
+                g_bInHandler = false;
+            }
+        }
+        HostIntUnlock();
+    }
+}
+
+void
+HostIntTrigger(uint32_t ui32Interrupt)
+{
+    g_pbPending[ui32Interrupt] = true;
+}
+
+bool
+HostIntInHandler(void)
+{
+    return g_bInHandler;
+}
+
+uint32_t
+HostIntCount(uint32_t ui32Interrupt)
+{
+    return g_pui32Count[ui32Interrupt];
+}
+
+bool
+IntMasterEnable(void)
+{
+    bool bRet = g_bMasterDisabled;
+
+    g_bMasterDisabled = false;
+    HostSimKick();
+    return bRet;
+}
+
+bool
+IntMasterDisable(void)
+{
+    bool bRet;
+
+    HostIntLock();
+    bRet = g_bMasterDisabled;
+    g_bMasterDisabled = true;
+    HostIntUnlock();
+    return bRet;
+}
+
+void
+IntRegister(uint32_t ui32Interrupt, void (*pfnHandler)(void))
+{
+    HostIntLock();
+    g_pfnHostVectors[ui32Interrupt] = pfnHandler;
+    HostIntUnlock();
+}
+
+void
+IntUnregister(uint32_t ui32Interrupt)
+{
+    HostIntLock();
+    g_pfnHostVectors[ui32Interrupt] = 0;
+    HostIntUnlock();
+}
+
+void
+IntPriorityGroupingSet(uint32_t ui32Bits)
+{
+}
+
+uint32_t
+IntPriorityGroupingGet(void)
+{
+    return 0;
+}
+
+void
+IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority)
+{
+}
+
+int32_t
+IntPriorityGet(uint32_t ui32Interrupt)
+{
+    return 0;
+}
+
+void
+IntEnable(uint32_t ui32Interrupt)
+{
+    g_pbEnabled[ui32Interrupt] = true;
+    if(g_pbPending[ui32Interrupt])
+    {
+        HostSimKick();
+    }
+}
+
+void
+IntDisable(uint32_t ui32Interrupt)
+{
+    HostIntLock();
+    g_pbEnabled[ui32Interrupt] = false;
+    HostIntUnlock();
+}
+
+uint32_t
+IntIsEnabled(uint32_t ui32Interrupt)
+{
+    return g_pbEnabled[ui32Interrupt];
+}
+
+void
+IntPendSet(uint32_t ui32Interrupt)
+{
+    g_pbPending[ui32Interrupt] = true;
+    HostSimKick();
+}
+
+void
+IntPendClear(uint32_t ui32Interrupt)
+{
+    g_pbPending[ui32Interrupt] = false;
+}
+
+void
+IntPriorityMaskSet(uint32_t ui32PriorityMask)
+{
+}
+
+uint32_t
+IntPriorityMaskGet(void)
+{
+    return 0;
+}
+
+void
+IntTrigger(uint32_t ui32Interrupt)
+{
+    IntPendSet(ui32Interrupt);
+}
@@ -0,0 +1,228 @@
+//*****************************************************************************
+//
+// ssi.c - Host model of the SSI modules.
+//
+// A master with the 8 entry TX and RX FIFOs of the Tiva parts. A frame
+// written to the TX FIFO is exchanged with the device attached to the
+// module at once, on the calling thread, and the byte the device returns
+// enters the RX FIFO; with nothing attached the data line reads back all
+// ones. The TX FIFO is therefore always empty and the module never busy,
+// but the RX FIFO fills like the hardware's does: a frame that arrives to
+// a full RX FIFO is an overrun and is lost, so code that keeps several
+// frames in flight has to read them back in time.
+//
+// Register accesses are counted as the driverlib makes them: a status
+// read for every put or get, a data write or read, and a status read for
+// every SSIBusy() poll.
+//
+//*****************************************************************************
+
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_types.h"
+#include "driverlib/ssi.h"
+#include "host.h"
+
+#define SSI_FIFO_DEPTH          8
+#define SSI_NUM                 4
+
+typedef struct
+{
+    bool bEnabled;
+    uint8_t pui8RxFifo[SSI_FIFO_DEPTH];
+    unsigned int uiRxHead;
+    unsigned int uiRxCount;
+
+    HostSSIDevice pfnDevice;
+    void *pvDeviceArg;
+    HostSSIStats sStats;
+}
+tHostSSI;
+
+static tHostSSI g_psHostSSI[SSI_NUM];
+
+static tHostSSI *
+HostSSIGet(uint32_t ui32Base)
+{
+    return &g_psHostSSI[((ui32Base - SSI0_BASE) >> 12) & (SSI_NUM - 1)];
+}
+
+//*****************************************************************************
+//
+// Exchanges a frame with the device and queues the byte it returned.
+//
+//*****************************************************************************
+static void
+HostSSIExchange(uint32_t ui32Base, tHostSSI *psSSI, uint8_t ui8Out)
+{
+    uint8_t ui8In = 0xFF;
+
+    if(psSSI->pfnDevice)
+    {
+        ui8In = psSSI->pfnDevice(ui32Base, ui8Out, psSSI->pvDeviceArg);
+    }
+    psSSI->sStats.frames++;
+    if(psSSI->uiRxCount == SSI_FIFO_DEPTH)
+    {
+        psSSI->sStats.overruns++;
+        HWREG(ui32Base + SSI_O_RIS) |= SSI_RIS_RORRIS;
+        return;
+    }
+    psSSI->pui8RxFifo[(psSSI->uiRxHead + psSSI->uiRxCount) %
+                      SSI_FIFO_DEPTH] = ui8In;
+    psSSI->uiRxCount++;
+}
+
+static uint8_t
+HostSSIPop(tHostSSI *psSSI)
+{
+    uint8_t ui8In = psSSI->pui8RxFifo[psSSI->uiRxHead];
+
+    psSSI->uiRxHead = (psSSI->uiRxHead + 1) % SSI_FIFO_DEPTH;
+    psSSI->uiRxCount--;
+    return ui8In;
+}
+
+void
+HostSSISetDevice(uint32_t ui32Base, HostSSIDevice pfnDevice, void *pvArg)
+{
+    tHostSSI *psSSI = HostSSIGet(ui32Base);
+
+    psSSI->pfnDevice = pfnDevice;
+    psSSI->pvDeviceArg = pvArg;
+}
+
+void
+HostSSIStatsGet(uint32_t ui32Base, HostSSIStats *psStats)
+{
+    *psStats = HostSSIGet(ui32Base)->sStats;
+}
+
+void
+HostSSIStatsReset(uint32_t ui32Base)
+{
+    memset(&HostSSIGet(ui32Base)->sStats, 0, sizeof(HostSSIStats));
+}
+
+//*****************************************************************************
+//
+// driverlib API
+//
+//*****************************************************************************
+void
+SSIConfigSetExpClk(uint32_t ui32Base, uint32_t ui32SSIClk,
+                   uint32_t ui32Protocol, uint32_t ui32Mode,
+                   uint32_t ui32BitRate, uint32_t ui32DataWidth)
+{
+    HostRegWrite(ui32Base + SSI_O_CR0, ui32Protocol | (ui32DataWidth - 1));
+    HostRegWrite(ui32Base + SSI_O_CPSR, 2);
+}
+
+void
+SSIEnable(uint32_t ui32Base)
+{
+    HostSSIGet(ui32Base)->bEnabled = true;
+    HostRegWrite(ui32Base + SSI_O_CR1, HWREG(ui32Base + SSI_O_CR1) | SSI_CR1_SSE);
+}
+
+void
+SSIDisable(uint32_t ui32Base)
+{
+    HostSSIGet(ui32Base)->bEnabled = false;
+    HostRegWrite(ui32Base + SSI_O_CR1, HWREG(ui32Base + SSI_O_CR1) & ~SSI_CR1_SSE);
+}
+
+void
+SSIClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+    HostRegWrite(ui32Base + SSI_O_CC, ui32Source);
+}
+
+uint32_t
+SSIClockSourceGet(uint32_t ui32Base)
+{
+    return HostRegRead(ui32Base + SSI_O_CC);
+}
+
+void
+SSIDataPut(uint32_t ui32Base, uint32_t ui32Data)
+{
+    tHostSSI *psSSI = HostSSIGet(ui32Base);
+
+    g_sHostRegStats.reads++;
+    g_sHostRegStats.writes++;
+    if(psSSI->bEnabled)
+    {
+        HostSSIExchange(ui32Base, psSSI, ui32Data);
+    }
+}
+
+int32_t
+SSIDataPutNonBlocking(uint32_t ui32Base, uint32_t ui32Data)
+{
+    SSIDataPut(ui32Base, ui32Data);
+    return 1;
+}
+
+void
+SSIDataGet(uint32_t ui32Base, uint32_t *pui32Data)
+{
+    tHostSSI *psSSI = HostSSIGet(ui32Base);
+
+    g_sHostRegStats.reads += 2;
+
+    //
+    // Nothing is ever on its way in, so waiting for it would hang; the
+    // hardware would return whatever the data register last held
+    //
+    *pui32Data = psSSI->uiRxCount ? HostSSIPop(psSSI) : 0;
+}
+
+int32_t
+SSIDataGetNonBlocking(uint32_t ui32Base, uint32_t *pui32Data)
+{
+    tHostSSI *psSSI = HostSSIGet(ui32Base);
+
+    g_sHostRegStats.reads++;
+    if(!psSSI->uiRxCount)
+    {
+        return 0;
+    }
+    g_sHostRegStats.reads++;
+    *pui32Data = HostSSIPop(psSSI);
+    return 1;
+}
+
+bool
+SSIBusy(uint32_t ui32Base)
+{
+    g_sHostRegStats.reads++;
+    return false;
+}
+
+void
+SSIIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostRegWrite(ui32Base + SSI_O_IM, HWREG(ui32Base + SSI_O_IM) | ui32IntFlags);
+}
+
+void
+SSIIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostRegWrite(ui32Base + SSI_O_IM, HWREG(ui32Base + SSI_O_IM) & ~ui32IntFlags);
+}
+
+uint32_t
+SSIIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    uint32_t ui32Raw = HostRegRead(ui32Base + SSI_O_RIS);
+
+    return bMasked ? ui32Raw & HWREG(ui32Base + SSI_O_IM) : ui32Raw;
+}
+
+void
+SSIIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostRegWrite(ui32Base + SSI_O_RIS, HWREG(ui32Base + SSI_O_RIS) & ~ui32IntFlags);
+}
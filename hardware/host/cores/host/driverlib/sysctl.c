@@ -0,0 +1,91 @@
+//*****************************************************************************
+//
+// sysctl.c - Host model of the System Control module.
+//
+// Clocks are always running and peripherals are always ready. SysCtlDelay()
+// burns roughly the time it would take at F_CPU (three cycles per loop).
+//
+//*****************************************************************************
+
+#include "driverlib/sysctl.h"
+#include "host.h"
+
+void
+SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+}
+
+void
+SysCtlPeripheralDisable(uint32_t ui32Peripheral)
+{
+}
+
+void
+SysCtlPeripheralReset(uint32_t ui32Peripheral)
+{
+}
+
+bool
+SysCtlPeripheralReady(uint32_t ui32Peripheral)
+{
+    return true;
+}
+
+bool
+SysCtlPeripheralPresent(uint32_t ui32Peripheral)
+{
+    return true;
+}
+
+void
+SysCtlPeripheralSleepEnable(uint32_t ui32Peripheral)
+{
+}
+
+void
+SysCtlPeripheralDeepSleepEnable(uint32_t ui32Peripheral)
+{
+}
+
+void
+SysCtlDelay(uint32_t ui32Count)
+{
+    uint64_t ui64End = HostNanos() + (uint64_t)ui32Count * 3000000000ULL / F_CPU;
+
+    while(HostNanos() < ui64End)
+    {
+    }
+}
+
+void
+SysCtlClockSet(uint32_t ui32Config)
+{
+}
+
+uint32_t
+SysCtlClockGet(void)
+{
+    return F_CPU;
+}
+
+uint32_t
+SysCtlClockFreqSet(uint32_t ui32Config, uint32_t ui32SysClock)
+{
+    return F_CPU;
+}
+
+void
+SysCtlDeepSleepClockSet(uint32_t ui32Config)
+{
+}
+
+void
+SysCtlDeepSleepClockConfigSet(uint32_t ui32Div, uint32_t ui32Config)
+{
+}
+
+uint32_t
+SysCtlPIOSCCalibrate(uint32_t ui32Type)
+{
+    return 1;
+}
@@ -0,0 +1,164 @@
+//*****************************************************************************
+//
+// timer.c - Host model of the General Purpose Timers.
+//
+// Configuration is written to the simulated register file so that it can
+// be inspected; the timers themselves do not count.
+//
+//*****************************************************************************
+
+#include "Energia.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_timer.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
+#include "host.h"
+
+//
+// Interrupts of the 16/32-bit timers, A and B halves
+//
+static const uint32_t g_ppui32HostTimerInt[6][2] =
+{
+    { INT_TIMER0A, INT_TIMER0B }, { INT_TIMER1A, INT_TIMER1B },
+    { INT_TIMER2A, INT_TIMER2B }, { INT_TIMER3A, INT_TIMER3B },
+    { INT_TIMER4A, INT_TIMER4B }, { INT_TIMER5A, INT_TIMER5B }
+};
+
+static void
+HostTimerIntSet(uint32_t ui32Base, uint32_t ui32Timer,
+                void (*pfnHandler)(void))
+{
+    uint32_t ui32Index = (ui32Base - TIMER0_BASE) >> 12;
+
+    if(ui32Index >= 6)
+    {
+        return;
+    }
+    if(ui32Timer & TIMER_A)
+    {
+        IntRegister(g_ppui32HostTimerInt[ui32Index][0], pfnHandler);
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        IntRegister(g_ppui32HostTimerInt[ui32Index][1], pfnHandler);
+    }
+}
+
+void
+TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    HostRegWrite(ui32Base + TIMER_O_CTL,
+                 HWREG(ui32Base + TIMER_O_CTL) |
+                 (ui32Timer & (TIMER_CTL_TAEN | TIMER_CTL_TBEN)));
+}
+
+void
+TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    HostRegWrite(ui32Base + TIMER_O_CTL,
+                 HWREG(ui32Base + TIMER_O_CTL) &
+                 ~(ui32Timer & (TIMER_CTL_TAEN | TIMER_CTL_TBEN)));
+}
+
+void
+TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+    HostRegWrite(ui32Base + TIMER_O_CFG, ui32Config >> 24);
+    HostRegWrite(ui32Base + TIMER_O_TAMR, ui32Config & 0xFF);
+    HostRegWrite(ui32Base + TIMER_O_TBMR, (ui32Config >> 8) & 0xFF);
+}
+
+void
+TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    if(ui32Timer & TIMER_A)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TAILR, ui32Value);
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TBILR, ui32Value);
+    }
+}
+
+void
+TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    if(ui32Timer & TIMER_A)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TAMATCHR, ui32Value);
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TBMATCHR, ui32Value);
+    }
+}
+
+void
+TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    if(ui32Timer & TIMER_A)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TAPR, ui32Value);
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TBPR, ui32Value);
+    }
+}
+
+void
+TimerPrescaleMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                      uint32_t ui32Value)
+{
+    if(ui32Timer & TIMER_A)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TAPMR, ui32Value);
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        HostRegWrite(ui32Base + TIMER_O_TBPMR, ui32Value);
+    }
+}
+
+void
+TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostRegWrite(ui32Base + TIMER_O_IMR,
+                 HWREG(ui32Base + TIMER_O_IMR) | ui32IntFlags);
+}
+
+void
+TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostRegWrite(ui32Base + TIMER_O_IMR,
+                 HWREG(ui32Base + TIMER_O_IMR) & ~ui32IntFlags);
+}
+
+uint32_t
+TimerIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    return HostRegRead(ui32Base + (bMasked ? TIMER_O_MIS : TIMER_O_RIS));
+}
+
+void
+TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostRegWrite(ui32Base + TIMER_O_RIS,
+                 HWREG(ui32Base + TIMER_O_RIS) & ~ui32IntFlags);
+}
+
+void
+TimerIntRegister(uint32_t ui32Base, uint32_t ui32Timer,
+                 void (*pfnHandler)(void))
+{
+    HostTimerIntSet(ui32Base, ui32Timer, pfnHandler);
+}
+
+void
+TimerIntUnregister(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    HostTimerIntSet(ui32Base, ui32Timer, 0);
+}
@@ -0,0 +1,647 @@
+//*****************************************************************************
+//
+// uart.c - Host model of the UART.
+//
+// Each UART has the 16 entry TX and RX FIFOs of the Tiva parts. The
+// simulator thread shifts TX bytes out to a sink and RX bytes in from a
+// host supplied "wire" buffer, optionally paced at a fixed line rate, and
+// latches the TX level, RX level and receive timeout interrupts the same
+// way the hardware does: TX on the FIFO falling through its trigger level,
+// RX on the FIFO reaching its trigger level and RT once the line goes idle
+// with data still in the FIFO.
+//
+// With receive DMA enabled the FIFO raises uDMA requests instead, a burst
+// while it is at or above the RX trigger level and a single request below
+// it, and a completed transfer raises the UART interrupt with DMARX latched.
+// A channel taking single requests drains the FIFO long before the CPU can
+// look at it again, so status reads serve those first.
+//
+// An unpaced TX line has no time to model, so bytes written to it leave
+// the FIFO immediately on the calling thread. Status reads that a polling
+// loop would spin on (FIFO full, busy, nothing received) yield the CPU so
+// the simulator thread can make progress on a single core host.
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Energia.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/udma.h"
+#include "driverlib/uart.h"
+#include "host.h"
+
+#define UART_FIFO_DEPTH         16
+#define UART_NUM                8
+
+typedef struct
+{
+    bool bEnabled;
+    uint32_t ui32IntMask;
+    uint32_t ui32RawInt;
+    uint32_t ui32RxError;
+    uint32_t ui32DMA;
+    unsigned int uiTxTrigger;
+    unsigned int uiRxTrigger;
+
+    uint8_t pui8TxFifo[UART_FIFO_DEPTH];
+    unsigned int uiTxHead;
+    unsigned int uiTxCount;
+    uint8_t pui8RxFifo[UART_FIFO_DEPTH];
+    unsigned int uiRxHead;
+    unsigned int uiRxCount;
+    bool bRxTimeoutArmed;
+
+    uint8_t *pui8Wire;
+    size_t szWireHead;
+    size_t szWireLen;
+    size_t szWireSize;
+
+    uint32_t ui32LineRate;
+    uint64_t ui64TxDue;
+    uint64_t ui64RxDue;
+
+    HostUARTSink pfnSink;
+    void *pvSinkArg;
+    HostUARTStats sStats;
+}
+tHostUART;
+
+static tHostUART g_psHostUART[UART_NUM];
+
+static const uint32_t g_pui32HostUARTInt[UART_NUM] =
+{
+    INT_UART0, INT_UART1, INT_UART2, INT_UART3,
+    INT_UART4, INT_UART5, INT_UART6, INT_UART7
+};
+
+static const uint32_t g_pui32HostUARTRxDMA[UART_NUM] =
+{
+    UDMA_CH8_UART0RX, UDMA_CH22_UART1RX, UDMA_CH12_UART2RX, UDMA_CH16_UART3RX,
+    UDMA_CH18_UART4RX, UDMA_CH6_UART5RX, UDMA_CH10_UART6RX, UDMA_CH20_UART7RX
+};
+
+static const unsigned int g_puiFifoTrigger[5] = { 2, 4, 8, 12, 14 };
+
+static void
+HostUARTStdout(uint32_t ui32Base, const uint8_t *pui8Data, size_t len,
+               void *pvArg)
+{
+    fwrite(pui8Data, 1, len, stdout);
+    fflush(stdout);
+}
+
+static unsigned int
+HostUARTIndex(uint32_t ui32Base)
+{
+    return (ui32Base - UART0_BASE) >> 12;
+}
+
+static tHostUART *
+HostUARTGet(uint32_t ui32Base)
+{
+    return &g_psHostUART[HostUARTIndex(ui32Base)];
+}
+
+//*****************************************************************************
+//
+// Returns how many bytes may cross the line now, given the line rate.
+//
+//*****************************************************************************
+static unsigned int
+HostUARTDue(tHostUART *psUART, uint64_t *pui64Due, uint64_t ui64Now,
+            unsigned int uiWant)
+{
+    uint64_t ui64Period;
+    unsigned int uiCount = 0;
+
+    if(psUART->ui32LineRate == 0)
+    {
+        return uiWant;
+    }
+
+    ui64Period = 1000000000ULL / psUART->ui32LineRate;
+    if(*pui64Due + ui64Period * UART_FIFO_DEPTH < ui64Now)
+    {
+        // Line was idle, do not bank the idle time
+        *pui64Due = ui64Now - ui64Period;
+    }
+    while((uiCount < uiWant) && (*pui64Due + ui64Period <= ui64Now))
+    {
+        *pui64Due += ui64Period;
+        uiCount++;
+    }
+    return uiCount;
+}
+
+//*****************************************************************************
+//
+// Hands the RX FIFO to the uDMA for as long as it keeps taking requests.
+// Called with the simulator lock held.
+//
+//*****************************************************************************
+static void
+HostUARTDMAReceive(tHostUART *psUART, unsigned int uiIdx)
+{
+    uint8_t pui8In[UART_FIFO_DEPTH];
+    unsigned int uiMoved, i;
+    bool bBurst, bDone;
+
+    if(!(psUART->ui32DMA & UART_DMA_RX))
+    {
+        return;
+    }
+
+    while(psUART->uiRxCount)
+    {
+        bBurst = psUART->uiRxCount >= psUART->uiRxTrigger;
+        for(i = 0; i < psUART->uiRxCount; i++)
+        {
+            pui8In[i] = psUART->pui8RxFifo[(psUART->uiRxHead + i) %
+                                           UART_FIFO_DEPTH];
+        }
+        uiMoved = HostUDMARequest(g_pui32HostUARTRxDMA[uiIdx], bBurst, pui8In,
+                                  psUART->uiRxCount, &bDone);
+        if(!uiMoved)
+        {
+            break;
+        }
+        psUART->uiRxHead = (psUART->uiRxHead + uiMoved) % UART_FIFO_DEPTH;
+        psUART->uiRxCount -= uiMoved;
+        if(bDone)
+        {
+            //
+            // Interrupts whether or not DMARX is masked in, as on the
+            // TM4C123 parts which do not have that bit.
+            //
+            psUART->ui32RawInt |= UART_INT_DMARX;
+            psUART->sStats.interrupts++;
+            HostIntTrigger(g_pui32HostUARTInt[uiIdx]);
+        }
+    }
+    if(psUART->uiRxCount < psUART->uiRxTrigger)
+    {
+        psUART->ui32RawInt &= ~UART_INT_RX;
+    }
+}
+
+static bool
+HostUARTStep(void)
+{
+    uint8_t pui8Out[UART_FIFO_DEPTH];
+    unsigned int uiIdx, uiCount, i;
+    uint64_t ui64Now = HostNanos();
+    bool bBusy = false;
+    tHostUART *psUART;
+
+    HostSimLock();
+    for(uiIdx = 0; uiIdx < UART_NUM; uiIdx++)
+    {
+        psUART = &g_psHostUART[uiIdx];
+        if(!psUART->bEnabled)
+        {
+            continue;
+        }
+
+        //
+        // Transmit
+        //
+        uiCount = HostUARTDue(psUART, &psUART->ui64TxDue, ui64Now,
+                              psUART->uiTxCount);
+        if(uiCount)
+        {
+            bool bAbove = psUART->uiTxCount > psUART->uiTxTrigger;
+
+            for(i = 0; i < uiCount; i++)
+            {
+                pui8Out[i] = psUART->pui8TxFifo[psUART->uiTxHead];
+                psUART->uiTxHead = (psUART->uiTxHead + 1) % UART_FIFO_DEPTH;
+            }
+            psUART->uiTxCount -= uiCount;
+            psUART->sStats.txBytes += uiCount;
+            if(bAbove && (psUART->uiTxCount <= psUART->uiTxTrigger))
+            {
+                psUART->ui32RawInt |= UART_INT_TX;
+            }
+            if(psUART->pfnSink)
+            {
+                psUART->pfnSink(UART0_BASE + (uiIdx << 12), pui8Out, uiCount,
+                                psUART->pvSinkArg);
+            }
+            bBusy = true;
+        }
+
+        //
+        // Receive
+        //
+        uiCount = HostUARTDue(psUART, &psUART->ui64RxDue, ui64Now,
+                              psUART->szWireLen - psUART->szWireHead);
+        for(i = 0; i < uiCount; i++)
+        {
+            if(psUART->uiRxCount == UART_FIFO_DEPTH)
+            {
+                HostUARTDMAReceive(psUART, uiIdx);
+            }
+            if(psUART->uiRxCount == UART_FIFO_DEPTH)
+            {
+                if(psUART->ui32LineRate == 0)
+                {
+                    // An unpaced line simply waits for the FIFO to drain
+                    break;
+                }
+                psUART->ui32RxError |= UART_INT_OE >> 8;
+                psUART->ui32RawInt |= UART_INT_OE;
+                psUART->sStats.rxOverruns++;
+            }
+            else
+            {
+                psUART->pui8RxFifo[(psUART->uiRxHead + psUART->uiRxCount) %
+                                   UART_FIFO_DEPTH] =
+                    psUART->pui8Wire[psUART->szWireHead];
+                psUART->uiRxCount++;
+                psUART->sStats.rxBytes++;
+                psUART->bRxTimeoutArmed = true;
+            }
+            psUART->szWireHead++;
+            bBusy = true;
+        }
+        HostUARTDMAReceive(psUART, uiIdx);
+        if(psUART->uiRxCount && (psUART->uiRxCount >= psUART->uiRxTrigger))
+        {
+            psUART->ui32RawInt |= UART_INT_RX;
+        }
+        if((psUART->szWireHead == psUART->szWireLen) &&
+           psUART->bRxTimeoutArmed && psUART->uiRxCount)
+        {
+            psUART->ui32RawInt |= UART_INT_RT;
+            psUART->bRxTimeoutArmed = false;
+        }
+
+        if(psUART->ui32RawInt & psUART->ui32IntMask)
+        {
+            psUART->sStats.interrupts++;
+            HostIntTrigger(g_pui32HostUARTInt[uiIdx]);
+        }
+
+        //
+        // Keep the simulator polling while a paced line is still shifting.
+        //
+        if(psUART->uiTxCount || (psUART->szWireHead != psUART->szWireLen))
+        {
+            bBusy = true;
+        }
+    }
+    HostSimUnlock();
+
+    return bBusy;
+}
+
+//*****************************************************************************
+//
+// Host side API, see host.h.
+//
+//*****************************************************************************
+void
+HostUARTSetSink(uint32_t ui32Base, HostUARTSink pfnSink, void *pvArg)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+
+    HostSimLock();
+    psUART->pfnSink = pfnSink;
+    psUART->pvSinkArg = pvArg;
+    HostSimUnlock();
+}
+
+void
+HostUARTSetLineRate(uint32_t ui32Base, uint32_t ui32BytesPerSecond)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+
+    HostSimLock();
+    psUART->ui32LineRate = ui32BytesPerSecond;
+    psUART->ui64TxDue = psUART->ui64RxDue = HostNanos();
+    HostSimUnlock();
+}
+
+size_t
+HostUARTReceive(uint32_t ui32Base, const uint8_t *pui8Data, size_t len)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+    size_t szPending;
+
+    HostSimLock();
+    szPending = psUART->szWireLen - psUART->szWireHead;
+    if(psUART->szWireHead)
+    {
+        memmove(psUART->pui8Wire, psUART->pui8Wire + psUART->szWireHead,
+                szPending);
+        psUART->szWireHead = 0;
+        psUART->szWireLen = szPending;
+    }
+    if(szPending + len > psUART->szWireSize)
+    {
+        psUART->szWireSize = (szPending + len) * 2;
+        psUART->pui8Wire = realloc(psUART->pui8Wire, psUART->szWireSize);
+    }
+    memcpy(psUART->pui8Wire + psUART->szWireLen, pui8Data, len);
+    psUART->szWireLen += len;
+    HostSimUnlock();
+
+    HostSimKick();
+    return len;
+}
+
+bool
+HostUARTIdle(uint32_t ui32Base)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+    bool bIdle;
+
+    HostSimLock();
+    bIdle = (psUART->uiTxCount == 0) &&
+            (psUART->szWireHead == psUART->szWireLen);
+    HostSimUnlock();
+    return bIdle;
+}
+
+void
+HostUARTStatsGet(uint32_t ui32Base, HostUARTStats *psStats)
+{
+    HostSimLock();
+    *psStats = HostUARTGet(ui32Base)->sStats;
+    HostSimUnlock();
+}
+
+void
+HostUARTStatsReset(uint32_t ui32Base)
+{
+    HostSimLock();
+    memset(&HostUARTGet(ui32Base)->sStats, 0, sizeof(HostUARTStats));
+    HostSimUnlock();
+}
+
+//*****************************************************************************
+//
+// driverlib API
+//
+//*****************************************************************************
+void
+UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                 uint32_t ui32RxLevel)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+
+    HostSimLock();
+    psUART->uiTxTrigger = g_puiFifoTrigger[ui32TxLevel];
+    psUART->uiRxTrigger = g_puiFifoTrigger[ui32RxLevel >> 3];
+    HostSimUnlock();
+}
+
+void
+UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                    uint32_t ui32Baud, uint32_t ui32Config)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+
+    HostSimLock();
+    if(!psUART->pfnSink && (ui32Base == UART0_BASE))
+    {
+        psUART->pfnSink = HostUARTStdout;
+    }
+    HostSimUnlock();
+}
+
+void
+UARTEnable(uint32_t ui32Base)
+{
+    HostUARTGet(ui32Base)->bEnabled = true;
+    HostSimRegister(HostUARTStep);
+}
+
+void
+UARTDisable(uint32_t ui32Base)
+{
+    HostUARTGet(ui32Base)->bEnabled = false;
+}
+
+void
+UARTFIFOEnable(uint32_t ui32Base)
+{
+}
+
+void
+UARTFIFODisable(uint32_t ui32Base)
+{
+}
+
+bool
+UARTCharsAvail(uint32_t ui32Base)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+    bool bRet;
+
+    g_sHostRegStats.reads++;
+    if(psUART->ui32DMA & UART_DMA_RX)
+    {
+        HostSimLock();
+        HostUARTDMAReceive(psUART, HostUARTIndex(ui32Base));
+        HostSimUnlock();
+    }
+    bRet = psUART->uiRxCount != 0;
+    if(!bRet)
+    {
+        HostSimYield();
+    }
+    return bRet;
+}
+
+bool
+UARTSpaceAvail(uint32_t ui32Base)
+{
+    bool bRet;
+
+    g_sHostRegStats.reads++;
+    bRet = HostUARTGet(ui32Base)->uiTxCount < UART_FIFO_DEPTH;
+    if(!bRet)
+    {
+        HostSimYield();
+    }
+    return bRet;
+}
+
+int32_t
+UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+    int32_t i32Ret = -1;
+
+    g_sHostRegStats.reads += 2;
+    HostSimLock();
+    if(psUART->uiRxCount)
+    {
+        i32Ret = psUART->pui8RxFifo[psUART->uiRxHead];
+        psUART->uiRxHead = (psUART->uiRxHead + 1) % UART_FIFO_DEPTH;
+        psUART->uiRxCount--;
+        if(psUART->uiRxCount < psUART->uiRxTrigger)
+        {
+            psUART->ui32RawInt &= ~UART_INT_RX;
+        }
+    }
+    HostSimUnlock();
+
+    if((i32Ret >= 0) && (psUART->szWireHead != psUART->szWireLen))
+    {
+        HostSimKick();
+    }
+    return i32Ret;
+}
+
+int32_t
+UARTCharGet(uint32_t ui32Base)
+{
+    int32_t i32Ret;
+
+    while((i32Ret = UARTCharGetNonBlocking(ui32Base)) < 0)
+    {
+    }
+    return i32Ret;
+}
+
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+    bool bRet = false;
+
+    g_sHostRegStats.reads++;
+    HostSimLock();
+    if((psUART->ui32LineRate == 0) && (psUART->uiTxCount == 0))
+    {
+        //
+        // Straight out on an unpaced line.
+        //
+        psUART->sStats.txBytes++;
+        if(psUART->pfnSink)
+        {
+            psUART->pfnSink(ui32Base, &ucData, 1, psUART->pvSinkArg);
+        }
+        g_sHostRegStats.writes++;
+        HostSimUnlock();
+        return true;
+    }
+    if(psUART->uiTxCount < UART_FIFO_DEPTH)
+    {
+        psUART->pui8TxFifo[(psUART->uiTxHead + psUART->uiTxCount) %
+                           UART_FIFO_DEPTH] = ucData;
+        psUART->uiTxCount++;
+        g_sHostRegStats.writes++;
+        bRet = true;
+    }
+    HostSimUnlock();
+
+    if(bRet)
+    {
+        HostSimKick();
+    }
+    return bRet;
+}
+
+void
+UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    while(!UARTCharPutNonBlocking(ui32Base, ucData))
+    {
+    }
+}
+
+bool
+UARTBusy(uint32_t ui32Base)
+{
+    bool bRet;
+
+    g_sHostRegStats.reads++;
+    bRet = HostUARTGet(ui32Base)->uiTxCount != 0;
+    if(bRet)
+    {
+        HostSimYield();
+    }
+    return bRet;
+}
+
+void
+UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sHostRegStats.reads++;
+    g_sHostRegStats.writes++;
+    HostSimLock();
+    HostUARTGet(ui32Base)->ui32IntMask |= ui32IntFlags;
+    HostSimUnlock();
+    HostSimKick();
+}
+
+void
+UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sHostRegStats.reads++;
+    g_sHostRegStats.writes++;
+    HostSimLock();
+    HostUARTGet(ui32Base)->ui32IntMask &= ~ui32IntFlags;
+    HostSimUnlock();
+}
+
+uint32_t
+UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    tHostUART *psUART = HostUARTGet(ui32Base);
+    uint32_t ui32Ret;
+
+    g_sHostRegStats.reads++;
+    HostSimLock();
+    ui32Ret = psUART->ui32RawInt;
+    if(bMasked)
+    {
+        ui32Ret &= psUART->ui32IntMask;
+    }
+    HostSimUnlock();
+    return ui32Ret;
+}
+
+void
+UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sHostRegStats.writes++;
+    HostSimLock();
+    HostUARTGet(ui32Base)->ui32RawInt &= ~ui32IntFlags;
+    HostSimUnlock();
+}
+
+void
+UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    HostSimLock();
+    HostUARTGet(ui32Base)->ui32DMA |= ui32DMAFlags;
+    HostSimUnlock();
+    HostSimKick();
+}
+
+void
+UARTDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    HostSimLock();
+    HostUARTGet(ui32Base)->ui32DMA &= ~ui32DMAFlags;
+    HostSimUnlock();
+}
+
+uint32_t
+UARTRxErrorGet(uint32_t ui32Base)
+{
+    return HostUARTGet(ui32Base)->ui32RxError;
+}
+
+void
+UARTRxErrorClear(uint32_t ui32Base)
+{
+    HostUARTGet(ui32Base)->ui32RxError = 0;
+}
@@ -0,0 +1,453 @@
+//*****************************************************************************
+//
+// udma.c - Host model of the uDMA controller.
+//
+// The channel control structures live in the table handed to
+// uDMAControlBaseSet() and are interpreted the way the controller does:
+// the control word holds the mode and the number of items left minus one,
+// the end pointers stay put and the current address is derived from them.
+// Basic and ping-pong peripheral transfers of 8 bit items are modelled; a
+// structure that runs out drops to the stop mode and, in ping-pong mode, the
+// channel carries on with the other structure or disables itself if that
+// one is stopped too.
+//
+// Peripheral models raise requests with HostUDMARequest() while holding the
+// simulator lock. The table itself is host memory, so on a 64 bit host a
+// tDMAControlTable entry is larger than on the target; only code going
+// through the driverlib API, as all of Energia does, sees the model.
+//
+//*****************************************************************************
+
+#include <string.h>
+#include "Energia.h"
+#include "inc/hw_udma.h"
+#include "driverlib/udma.h"
+#include "host.h"
+
+#define UDMA_NUM_CHANNELS       32
+
+static tDMAControlTable *g_psHostUDMATable;
+static bool g_bHostUDMAEnabled;
+static uint32_t g_ui32HostUDMAEnable;
+static uint32_t g_ui32HostUDMAUseBurst;
+static uint32_t g_ui32HostUDMAAltSelect;
+static uint32_t g_ui32HostUDMAReqMask;
+static uint32_t g_ui32HostUDMAPriority;
+static uint32_t g_ui32HostUDMAIntStatus;
+static uint8_t g_pui8HostUDMAMap[UDMA_NUM_CHANNELS];
+static HostUDMAStats g_psHostUDMAStats[UDMA_NUM_CHANNELS];
+
+static unsigned int
+HostUDMAItemsLeft(uint32_t ui32Control)
+{
+    if((ui32Control & UDMA_CHCTL_XFERMODE_M) == UDMA_MODE_STOP)
+    {
+        return 0;
+    }
+    return ((ui32Control & UDMA_CHCTL_XFERSIZE_M) >> 4) + 1;
+}
+
+//*****************************************************************************
+//
+// Serves one request: a burst moves up to an arbitration's worth of the
+// uiCount items offered, a single request one item. Returns the number of
+// items moved; *pbDone is set when a structure completed, which the caller
+// signals on its interrupt line.
+//
+//*****************************************************************************
+unsigned int
+HostUDMARequest(uint32_t ui32Mapping, bool bBurst, const uint8_t *pui8Src,
+                unsigned int uiCount, bool *pbDone)
+{
+    uint32_t ui32Channel = ui32Mapping & 0x1f;
+    uint32_t ui32Bit = 1 << ui32Channel;
+    tDMAControlTable *psEntry;
+    uint32_t ui32Control;
+    unsigned int uiLeft, uiArb;
+    uint8_t *pui8Dst;
+
+    *pbDone = false;
+    if(!g_bHostUDMAEnabled || !g_psHostUDMATable || !uiCount ||
+       !(g_ui32HostUDMAEnable & ui32Bit) ||
+       (g_ui32HostUDMAReqMask & ui32Bit) ||
+       (g_pui8HostUDMAMap[ui32Channel] != (ui32Mapping >> 16)))
+    {
+        return 0;
+    }
+
+    psEntry = &g_psHostUDMATable[ui32Channel |
+        ((g_ui32HostUDMAAltSelect & ui32Bit) ? UDMA_ALT_SELECT : 0)];
+    ui32Control = psEntry->ui32Control;
+    uiLeft = HostUDMAItemsLeft(ui32Control);
+    if(!uiLeft)
+    {
+        return 0;
+    }
+
+    if(bBurst)
+    {
+        uiArb = 1 << ((ui32Control & UDMA_CHCTL_ARBSIZE_M) >> 14);
+        if(uiCount > uiArb)
+        {
+            uiCount = uiArb;
+        }
+    }
+    else if(g_ui32HostUDMAUseBurst & ui32Bit)
+    {
+        //
+        // Single requests are ignored by a channel set to use bursts only.
+        //
+        return 0;
+    }
+    else
+    {
+        uiCount = 1;
+    }
+    if(uiCount > uiLeft)
+    {
+        uiCount = uiLeft;
+    }
+
+    pui8Dst = (uint8_t *)psEntry->pvDstEndAddr;
+    if((ui32Control & UDMA_CHCTL_DSTINC_M) != UDMA_DST_INC_NONE)
+    {
+        memcpy(pui8Dst - (uiLeft - 1), pui8Src, uiCount);
+    }
+    else
+    {
+        *pui8Dst = pui8Src[uiCount - 1];
+    }
+    uiLeft -= uiCount;
+    g_psHostUDMAStats[ui32Channel].items += uiCount;
+
+    if(uiLeft)
+    {
+        psEntry->ui32Control = (ui32Control & ~UDMA_CHCTL_XFERSIZE_M) |
+                               ((uiLeft - 1) << 4);
+        return uiCount;
+    }
+
+    //
+    // The structure is done. Ping-pong goes on with the other one.
+    //
+    psEntry->ui32Control = ui32Control &
+                           ~(UDMA_CHCTL_XFERSIZE_M | UDMA_CHCTL_XFERMODE_M);
+    g_psHostUDMAStats[ui32Channel].completions++;
+    g_ui32HostUDMAIntStatus |= ui32Bit;
+    *pbDone = true;
+    if((ui32Control & UDMA_CHCTL_XFERMODE_M) == UDMA_MODE_PINGPONG)
+    {
+        g_ui32HostUDMAAltSelect ^= ui32Bit;
+        psEntry = &g_psHostUDMATable[ui32Channel |
+            ((g_ui32HostUDMAAltSelect & ui32Bit) ? UDMA_ALT_SELECT : 0)];
+        if(HostUDMAItemsLeft(psEntry->ui32Control))
+        {
+            return uiCount;
+        }
+
+        //
+        // Neither structure is armed; the channel ran dry.
+        //
+        g_psHostUDMAStats[ui32Channel].stalls++;
+    }
+    g_ui32HostUDMAEnable &= ~ui32Bit;
+
+    return uiCount;
+}
+
+//*****************************************************************************
+//
+// Host side API, see host.h.
+//
+//*****************************************************************************
+void
+HostUDMAStatsGet(uint32_t ui32Channel, HostUDMAStats *psStats)
+{
+    HostSimLock();
+    *psStats = g_psHostUDMAStats[ui32Channel & 0x1f];
+    HostSimUnlock();
+}
+
+void
+HostUDMAStatsReset(uint32_t ui32Channel)
+{
+    HostSimLock();
+    memset(&g_psHostUDMAStats[ui32Channel & 0x1f], 0, sizeof(HostUDMAStats));
+    HostSimUnlock();
+}
+
+//*****************************************************************************
+//
+// driverlib API
+//
+//*****************************************************************************
+void
+uDMAEnable(void)
+{
+    g_bHostUDMAEnabled = true;
+}
+
+void
+uDMADisable(void)
+{
+    g_bHostUDMAEnabled = false;
+}
+
+uint32_t
+uDMAErrorStatusGet(void)
+{
+    return 0;
+}
+
+void
+uDMAErrorStatusClear(void)
+{
+}
+
+void
+uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+    HostSimLock();
+    g_ui32HostUDMAEnable |= 1 << (ui32ChannelNum & 0x1f);
+    HostSimUnlock();
+    HostSimKick();
+}
+
+void
+uDMAChannelDisable(uint32_t ui32ChannelNum)
+{
+    HostSimLock();
+    g_ui32HostUDMAEnable &= ~(1 << (ui32ChannelNum & 0x1f));
+    HostSimUnlock();
+}
+
+bool
+uDMAChannelIsEnabled(uint32_t ui32ChannelNum)
+{
+    return (g_ui32HostUDMAEnable >> (ui32ChannelNum & 0x1f)) & 1;
+}
+
+void
+uDMAControlBaseSet(void *pControlTable)
+{
+    g_psHostUDMATable = (tDMAControlTable *)pControlTable;
+}
+
+void *
+uDMAControlBaseGet(void)
+{
+    return g_psHostUDMATable;
+}
+
+void *
+uDMAControlAlternateBaseGet(void)
+{
+    return g_psHostUDMATable ? g_psHostUDMATable + UDMA_NUM_CHANNELS : 0;
+}
+
+void
+uDMAChannelRequest(uint32_t ui32ChannelNum)
+{
+}
+
+void
+uDMAChannelAttributeEnable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    uint32_t ui32Bit = 1 << (ui32ChannelNum & 0x1f);
+
+    HostSimLock();
+    if(ui32Attr & UDMA_ATTR_USEBURST)
+    {
+        g_ui32HostUDMAUseBurst |= ui32Bit;
+    }
+    if(ui32Attr & UDMA_ATTR_ALTSELECT)
+    {
+        g_ui32HostUDMAAltSelect |= ui32Bit;
+    }
+    if(ui32Attr & UDMA_ATTR_HIGH_PRIORITY)
+    {
+        g_ui32HostUDMAPriority |= ui32Bit;
+    }
+    if(ui32Attr & UDMA_ATTR_REQMASK)
+    {
+        g_ui32HostUDMAReqMask |= ui32Bit;
+    }
+    HostSimUnlock();
+}
+
+void
+uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    uint32_t ui32Bit = 1 << (ui32ChannelNum & 0x1f);
+
+    HostSimLock();
+    if(ui32Attr & UDMA_ATTR_USEBURST)
+    {
+        g_ui32HostUDMAUseBurst &= ~ui32Bit;
+    }
+    if(ui32Attr & UDMA_ATTR_ALTSELECT)
+    {
+        g_ui32HostUDMAAltSelect &= ~ui32Bit;
+    }
+    if(ui32Attr & UDMA_ATTR_HIGH_PRIORITY)
+    {
+        g_ui32HostUDMAPriority &= ~ui32Bit;
+    }
+    if(ui32Attr & UDMA_ATTR_REQMASK)
+    {
+        g_ui32HostUDMAReqMask &= ~ui32Bit;
+    }
+    HostSimUnlock();
+    HostSimKick();
+}
+
+uint32_t
+uDMAChannelAttributeGet(uint32_t ui32ChannelNum)
+{
+    uint32_t ui32Bit = 1 << (ui32ChannelNum & 0x1f);
+    uint32_t ui32Attr = 0;
+
+    if(g_ui32HostUDMAUseBurst & ui32Bit)
+    {
+        ui32Attr |= UDMA_ATTR_USEBURST;
+    }
+    if(g_ui32HostUDMAAltSelect & ui32Bit)
+    {
+        ui32Attr |= UDMA_ATTR_ALTSELECT;
+    }
+    if(g_ui32HostUDMAPriority & ui32Bit)
+    {
+        ui32Attr |= UDMA_ATTR_HIGH_PRIORITY;
+    }
+    if(g_ui32HostUDMAReqMask & ui32Bit)
+    {
+        ui32Attr |= UDMA_ATTR_REQMASK;
+    }
+    return ui32Attr;
+}
+
+void
+uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+    tDMAControlTable *psEntry = &g_psHostUDMATable[ui32ChannelStructIndex & 0x3f];
+
+    HostSimLock();
+    psEntry->ui32Control = (psEntry->ui32Control &
+                            ~(UDMA_CHCTL_DSTINC_M | UDMA_CHCTL_DSTSIZE_M |
+                              UDMA_CHCTL_SRCINC_M | UDMA_CHCTL_SRCSIZE_M |
+                              UDMA_CHCTL_ARBSIZE_M | UDMA_CHCTL_NXTUSEBURST)) |
+                           ui32Control;
+    HostSimUnlock();
+}
+
+void
+uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                       void *pvSrcAddr, void *pvDstAddr,
+                       uint32_t ui32TransferSize)
+{
+    tDMAControlTable *psEntry = &g_psHostUDMATable[ui32ChannelStructIndex & 0x3f];
+    uint32_t ui32Control;
+    uint32_t ui32Inc;
+
+    HostSimLock();
+    ui32Control = (psEntry->ui32Control &
+                   ~(UDMA_CHCTL_XFERSIZE_M | UDMA_CHCTL_XFERMODE_M)) |
+                  ui32Mode | ((ui32TransferSize - 1) << 4);
+
+    ui32Inc = ui32Control & UDMA_CHCTL_SRCINC_M;
+    if(ui32Inc != UDMA_SRC_INC_NONE)
+    {
+        pvSrcAddr = (uint8_t *)pvSrcAddr +
+                    (ui32TransferSize << (ui32Inc >> 26)) - 1;
+    }
+    psEntry->pvSrcEndAddr = pvSrcAddr;
+
+    ui32Inc = ui32Control & UDMA_CHCTL_DSTINC_M;
+    if(ui32Inc != UDMA_DST_INC_NONE)
+    {
+        pvDstAddr = (uint8_t *)pvDstAddr +
+                    (ui32TransferSize << (ui32Inc >> 30)) - 1;
+    }
+    psEntry->pvDstEndAddr = pvDstAddr;
+
+    //
+    // The control word goes last, it is what arms the structure.
+    //
+    psEntry->ui32Control = ui32Control;
+    HostSimUnlock();
+    HostSimKick();
+}
+
+uint32_t
+uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex)
+{
+    uint32_t ui32Control;
+
+    g_sHostRegStats.reads++;
+    ui32Control = g_psHostUDMATable[ui32ChannelStructIndex & 0x3f].ui32Control;
+    return HostUDMAItemsLeft(ui32Control);
+}
+
+uint32_t
+uDMAChannelModeGet(uint32_t ui32ChannelStructIndex)
+{
+    uint32_t ui32Control;
+
+    g_sHostRegStats.reads++;
+    ui32Control = g_psHostUDMATable[ui32ChannelStructIndex & 0x3f].ui32Control &
+                  UDMA_CHCTL_XFERMODE_M;
+    if((ui32Control == UDMA_MODE_MEM_SCATTER_GATHER + UDMA_MODE_ALT_SELECT) ||
+       (ui32Control == UDMA_MODE_PER_SCATTER_GATHER + UDMA_MODE_ALT_SELECT))
+    {
+        ui32Control &= ~UDMA_MODE_ALT_SELECT;
+    }
+    return ui32Control;
+}
+
+void
+uDMAChannelAssign(uint32_t ui32Mapping)
+{
+    g_pui8HostUDMAMap[ui32Mapping & 0x1f] = ui32Mapping >> 16;
+}
+
+void
+uDMAChannelSelectDefault(uint32_t ui32DefPeriphs)
+{
+    unsigned int i;
+
+    for(i = 0; i < UDMA_NUM_CHANNELS; i++)
+    {
+        if(ui32DefPeriphs & (1 << i))
+        {
+            g_pui8HostUDMAMap[i] = 0;
+        }
+    }
+}
+
+void
+uDMAChannelSelectSecondary(uint32_t ui32SecPeriphs)
+{
+    unsigned int i;
+
+    for(i = 0; i < UDMA_NUM_CHANNELS; i++)
+    {
+        if(ui32SecPeriphs & (1 << i))
+        {
+            g_pui8HostUDMAMap[i] = 1;
+        }
+    }
+}
+
+uint32_t
+uDMAIntStatus(void)
+{
+    return g_ui32HostUDMAIntStatus;
+}
+
+void
+uDMAIntClear(uint32_t ui32ChanMask)
+{
+    HostSimLock();
+    g_ui32HostUDMAIntStatus &= ~ui32ChanMask;
+    HostSimUnlock();
+}
@@ -0,0 +1,200 @@
+/*
+ ************************************************************************
+ *	host.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Force-included (-include host.h) ahead of every translation unit of a
+ *	host build so that the lm4f core and the portable libraries compile
+ *	unmodified against the simulated driverlib in this directory.
+ *
+ *	The peripheral address space (0x40000000 - 0x400FFFFF and the NVIC
+ *	block at 0xE000E000) is backed by host memory, so direct HWREG()
+ *	accesses in the core behave like plain registers. UART, uDMA, SSI, GPIO,
+ *	ADC and NVIC behaviour is modelled by the driverlib replacements; a simulator
+ *	thread plays the role of the hardware and runs interrupt handlers.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef host_h
+#define host_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Must be seen before Energia.h defines TARGET_IS_*, see host_rom.h
+#include "driverlib/rom.h"
+#include "host_rom.h"
+
+#define ENERGIA_HOST 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Register file
+//
+// Counted accessors used by the simulated driverlib. Direct HWREG()
+// accesses from the core go straight to memory and are not counted.
+//
+typedef struct
+{
+    uint32_t reads;
+    uint32_t writes;
+} HostRegStats;
+
+extern HostRegStats g_sHostRegStats;
+
+uint32_t HostRegRead(uint32_t addr);
+void HostRegWrite(uint32_t addr, uint32_t value);
+void HostRegStatsReset(void);
+
+//
+// Simulator
+//
+// HostSimStart() is called lazily by the first peripheral that needs the
+// simulator thread. HostSimKick() wakes it after the CPU side changed state
+// that may need servicing (FIFO written, interrupt re-enabled, ...).
+// HostSimYield() is called by status reads that the CPU side polls on, so
+// busy-wait loops let the simulator run even on a single core host.
+//
+void HostSimStart(void);
+void HostSimStop(void);
+void HostSimKick(void);
+void HostSimYield(void);
+void HostSimLock(void);
+void HostSimUnlock(void);
+void HostSimRegister(bool (*step)(void));
+
+//
+// NVIC
+//
+// Handlers run on the simulator thread while the interrupt lock is held;
+// IntDisable()/IntMasterDisable() take the same lock so that once they
+// return no handler is running, just like on the target.
+//
+void HostIntTrigger(uint32_t ui32Interrupt);
+bool HostIntInHandler(void);
+uint32_t HostIntCount(uint32_t ui32Interrupt);
+
+//
+// UART
+//
+// TX bytes leave the FIFO at the configured line rate (0 = unlimited) and
+// are passed to the sink; the default sink of UART0 is stdout, the others
+// discard. RX bytes are queued on the "wire" and enter the RX FIFO at the
+// line rate; a byte arriving to a full FIFO is an overrun. With receive
+// DMA enabled the FIFO is emptied through the uDMA model: burst requests
+// once it reaches the trigger level, single requests below it.
+//
+typedef void (*HostUARTSink)(uint32_t ui32Base, const uint8_t *pui8Data,
+                             size_t len, void *pvArg);
+
+typedef struct
+{
+    uint32_t txBytes;
+    uint32_t rxBytes;
+    uint32_t rxOverruns;
+    uint32_t interrupts;
+} HostUARTStats;
+
+void HostUARTSetSink(uint32_t ui32Base, HostUARTSink pfnSink, void *pvArg);
+void HostUARTSetLineRate(uint32_t ui32Base, uint32_t ui32BytesPerSecond);
+size_t HostUARTReceive(uint32_t ui32Base, const uint8_t *pui8Data, size_t len);
+bool HostUARTIdle(uint32_t ui32Base);
+void HostUARTStatsGet(uint32_t ui32Base, HostUARTStats *psStats);
+void HostUARTStatsReset(uint32_t ui32Base);
+
+//
+// uDMA
+//
+// A peripheral model with DMA enabled raises a burst or single request
+// through HostUDMARequest() with the simulator lock held; the channel is
+// picked by its UDMA_CHn_xxx mapping and only served while that mapping is
+// assigned. *pbDone reports a completed control structure, which the
+// peripheral signals on its own interrupt like the hardware does.
+//
+typedef struct
+{
+    uint32_t items;
+    uint32_t completions;
+    uint32_t stalls;
+} HostUDMAStats;
+
+unsigned int HostUDMARequest(uint32_t ui32Mapping, bool bBurst,
+                             const uint8_t *pui8Src, unsigned int uiCount,
+                             bool *pbDone);
+void HostUDMAStatsGet(uint32_t ui32Channel, HostUDMAStats *psStats);
+void HostUDMAStatsReset(uint32_t ui32Channel);
+
+//
+// SSI
+//
+// Each frame written is exchanged with the device attached to the module
+// on the calling thread, and the byte it returns queued in the RX FIFO; a
+// module without a device reads 0xFF. A device that needs to see its
+// chip select watches the pin through HostGPIOSetWatch().
+//
+typedef uint8_t (*HostSSIDevice)(uint32_t ui32Base, uint8_t ui8Out,
+                                 void *pvArg);
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t overruns;
+} HostSSIStats;
+
+void HostSSISetDevice(uint32_t ui32Base, HostSSIDevice pfnDevice, void *pvArg);
+void HostSSIStatsGet(uint32_t ui32Base, HostSSIStats *psStats);
+void HostSSIStatsReset(uint32_t ui32Base);
+
+//
+// GPIO / ADC
+//
+// The core's PinHandle accesses, a load or store at DATA + (pins << 2) on
+// the target, go through HostGPIODataRead()/HostGPIODataWrite() so that
+// the model sees them and counts each as one register access. A watch
+// function is called after every write of a port's output latch, by
+// GPIOPinWrite() or a handle, to model a device on the pins.
+//
+typedef void (*HostGPIOWatch)(uint32_t ui32Port, uint8_t ui8Before,
+                              uint8_t ui8After);
+
+void HostGPIOInputSet(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+uint8_t HostGPIOOutputGet(uint32_t ui32Port);
+uint32_t HostGPIODataRead(volatile uint32_t *pui32Addr);
+void HostGPIODataWrite(volatile uint32_t *pui32Addr, uint32_t ui32Value);
+void HostGPIOSetWatch(HostGPIOWatch pfnWatch);
+void HostADCSet(uint32_t ui32Channel, uint32_t ui32Value);
+
+#define pinDataRead(A)          HostGPIODataRead(A)
+#define pinDataWrite(A, V)      HostGPIODataWrite(A, V)
+
+//
+// Time
+//
+uint64_t HostNanos(void);
+uint64_t HostThreadCPUNanos(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
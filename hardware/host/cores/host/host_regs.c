@@ -0,0 +1,90 @@
+/*
+ ************************************************************************
+ *	host_regs.c
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Backs the peripheral and private peripheral address windows with
+ *	anonymous host memory mapped at their target addresses so that
+ *	HWREG() in the core dereferences something real.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "host.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE MAP_FIXED
+#endif
+
+static const struct
+{
+    uintptr_t base;
+    size_t size;
+}
+g_sHostRegWindows[] =
+{
+    { 0x40000000, 0x00100000 },     // APB/AHB peripherals, SysCtl
+    { 0xE000E000, 0x00001000 },     // NVIC, SysTick, SCB
+};
+
+HostRegStats g_sHostRegStats;
+
+__attribute__((constructor(101)))
+static void HostRegInit(void)
+{
+    unsigned int i;
+
+    for(i = 0; i < sizeof(g_sHostRegWindows) / sizeof(g_sHostRegWindows[0]); i++)
+    {
+        void *p = mmap((void *)g_sHostRegWindows[i].base,
+                       g_sHostRegWindows[i].size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                       -1, 0);
+
+        if(p != (void *)g_sHostRegWindows[i].base)
+        {
+            fprintf(stderr, "host: cannot map register window at 0x%08lx\n",
+                    (unsigned long)g_sHostRegWindows[i].base);
+            abort();
+        }
+    }
+}
+
+uint32_t
+HostRegRead(uint32_t addr)
+{
+    g_sHostRegStats.reads++;
+    return *(volatile uint32_t *)(uintptr_t)addr;
+}
+
+void
+HostRegWrite(uint32_t addr, uint32_t value)
+{
+    g_sHostRegStats.writes++;
+    *(volatile uint32_t *)(uintptr_t)addr = value;
+}
+
+void
+HostRegStatsReset(void)
+{
+    g_sHostRegStats.reads = 0;
+    g_sHostRegStats.writes = 0;
+}
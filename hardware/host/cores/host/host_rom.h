@@ -0,0 +1,1036 @@
+/*
+ ************************************************************************
+ *	host_rom.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The ROM_ macros in driverlib/rom.h call through the on-chip ROM API
+ *	tables at fixed addresses. On the host no TARGET_IS_* is defined when
+ *	rom.h is first seen (see host.h) so rom.h is left empty and every
+ *	ROM_ call is routed to the simulated driverlib instead.
+ *
+ *	Generated from hardware/lm4f/cores/lm4f/driverlib/rom.h
+ ***********************************************************************
+*/
+
+#ifndef host_rom_h
+#define host_rom_h
+
+// On the chip rom.h casts the table entries and needs no prototypes; on
+// the host the driverlib ones must be seen by files that only use ROM_
+#include "driverlib/interrupt.h"
+
+#define ROM_ADCBusy                              ADCBusy
+#define ROM_ADCComparatorConfigure               ADCComparatorConfigure
+#define ROM_ADCComparatorIntClear                ADCComparatorIntClear
+#define ROM_ADCComparatorIntDisable              ADCComparatorIntDisable
+#define ROM_ADCComparatorIntEnable               ADCComparatorIntEnable
+#define ROM_ADCComparatorIntStatus               ADCComparatorIntStatus
+#define ROM_ADCComparatorRegionSet               ADCComparatorRegionSet
+#define ROM_ADCComparatorReset                   ADCComparatorReset
+#define ROM_ADCHardwareOversampleConfigure       ADCHardwareOversampleConfigure
+#define ROM_ADCIntClear                          ADCIntClear
+#define ROM_ADCIntClearEx                        ADCIntClearEx
+#define ROM_ADCIntDisable                        ADCIntDisable
+#define ROM_ADCIntDisableEx                      ADCIntDisableEx
+#define ROM_ADCIntEnable                         ADCIntEnable
+#define ROM_ADCIntEnableEx                       ADCIntEnableEx
+#define ROM_ADCIntStatus                         ADCIntStatus
+#define ROM_ADCIntStatusEx                       ADCIntStatusEx
+#define ROM_ADCPhaseDelayGet                     ADCPhaseDelayGet
+#define ROM_ADCPhaseDelaySet                     ADCPhaseDelaySet
+#define ROM_ADCProcessorTrigger                  ADCProcessorTrigger
+#define ROM_ADCReferenceGet                      ADCReferenceGet
+#define ROM_ADCReferenceSet                      ADCReferenceSet
+#define ROM_ADCSequenceConfigure                 ADCSequenceConfigure
+#define ROM_ADCSequenceDMADisable                ADCSequenceDMADisable
+#define ROM_ADCSequenceDMAEnable                 ADCSequenceDMAEnable
+#define ROM_ADCSequenceDataGet                   ADCSequenceDataGet
+#define ROM_ADCSequenceDisable                   ADCSequenceDisable
+#define ROM_ADCSequenceEnable                    ADCSequenceEnable
+#define ROM_ADCSequenceOverflow                  ADCSequenceOverflow
+#define ROM_ADCSequenceOverflowClear             ADCSequenceOverflowClear
+#define ROM_ADCSequenceStepConfigure             ADCSequenceStepConfigure
+#define ROM_ADCSequenceUnderflow                 ADCSequenceUnderflow
+#define ROM_ADCSequenceUnderflowClear            ADCSequenceUnderflowClear
+#define ROM_AESAuthLengthSet                     AESAuthLengthSet
+#define ROM_AESConfigSet                         AESConfigSet
+#define ROM_AESDMADisable                        AESDMADisable
+#define ROM_AESDMAEnable                         AESDMAEnable
+#define ROM_AESDataAuth                          AESDataAuth
+#define ROM_AESDataProcess                       AESDataProcess
+#define ROM_AESDataProcessAuth                   AESDataProcessAuth
+#define ROM_AESDataRead                          AESDataRead
+#define ROM_AESDataReadNonBlocking               AESDataReadNonBlocking
+#define ROM_AESDataWrite                         AESDataWrite
+#define ROM_AESDataWriteNonBlocking              AESDataWriteNonBlocking
+#define ROM_AESIVSet                             AESIVSet
+#define ROM_AESIntClear                          AESIntClear
+#define ROM_AESIntDisable                        AESIntDisable
+#define ROM_AESIntEnable                         AESIntEnable
+#define ROM_AESIntStatus                         AESIntStatus
+#define ROM_AESKey1Set                           AESKey1Set
+#define ROM_AESKey2Set                           AESKey2Set
+#define ROM_AESKey3Set                           AESKey3Set
+#define ROM_AESLengthSet                         AESLengthSet
+#define ROM_AESReset                             AESReset
+#define ROM_AESTagRead                           AESTagRead
+#define ROM_CANBitRateSet                        CANBitRateSet
+#define ROM_CANBitTimingGet                      CANBitTimingGet
+#define ROM_CANBitTimingSet                      CANBitTimingSet
+#define ROM_CANDisable                           CANDisable
+#define ROM_CANEnable                            CANEnable
+#define ROM_CANErrCntrGet                        CANErrCntrGet
+#define ROM_CANInit                              CANInit
+#define ROM_CANIntClear                          CANIntClear
+#define ROM_CANIntDisable                        CANIntDisable
+#define ROM_CANIntEnable                         CANIntEnable
+#define ROM_CANIntStatus                         CANIntStatus
+#define ROM_CANMessageClear                      CANMessageClear
+#define ROM_CANMessageGet                        CANMessageGet
+#define ROM_CANMessageSet                        CANMessageSet
+#define ROM_CANRetryGet                          CANRetryGet
+#define ROM_CANRetrySet                          CANRetrySet
+#define ROM_CANStatusGet                         CANStatusGet
+#define ROM_CIRConfigGet                         CIRConfigGet
+#define ROM_CIRConfigSet                         CIRConfigSet
+#define ROM_CIRIntClear                          CIRIntClear
+#define ROM_CIRIntDisable                        CIRIntDisable
+#define ROM_CIRIntEnable                         CIRIntEnable
+#define ROM_CIRIntStatus                         CIRIntStatus
+#define ROM_CIRRxCountGet                        CIRRxCountGet
+#define ROM_CIRRxDisable                         CIRRxDisable
+#define ROM_CIRRxEnable                          CIRRxEnable
+#define ROM_CIRRxMinMaxSet                       CIRRxMinMaxSet
+#define ROM_CIRRxStatusGet                       CIRRxStatusGet
+#define ROM_CIRRxWaitForOutput                   CIRRxWaitForOutput
+#define ROM_CIRTxCountSet                        CIRTxCountSet
+#define ROM_CIRTxDisable                         CIRTxDisable
+#define ROM_CIRTxEnable                          CIRTxEnable
+#define ROM_CIRTxStatusGet                       CIRTxStatusGet
+#define ROM_CRCConfigSet                         CRCConfigSet
+#define ROM_CRCDataProcess                       CRCDataProcess
+#define ROM_CRCDataWrite                         CRCDataWrite
+#define ROM_CRCResultRead                        CRCResultRead
+#define ROM_CRCSeedSet                           CRCSeedSet
+#define ROM_ComparatorConfigure                  ComparatorConfigure
+#define ROM_ComparatorIntClear                   ComparatorIntClear
+#define ROM_ComparatorIntDisable                 ComparatorIntDisable
+#define ROM_ComparatorIntEnable                  ComparatorIntEnable
+#define ROM_ComparatorIntStatus                  ComparatorIntStatus
+#define ROM_ComparatorRefSet                     ComparatorRefSet
+#define ROM_ComparatorValueGet                   ComparatorValueGet
+#define ROM_Crc16                                Crc16
+#define ROM_Crc16Array                           Crc16Array
+#define ROM_Crc16Array3                          Crc16Array3
+#define ROM_Crc32                                Crc32
+#define ROM_Crc8CCITT                            Crc8CCITT
+#define ROM_DESConfigSet                         DESConfigSet
+#define ROM_DESDMADisable                        DESDMADisable
+#define ROM_DESDMAEnable                         DESDMAEnable
+#define ROM_DESDataProcess                       DESDataProcess
+#define ROM_DESDataRead                          DESDataRead
+#define ROM_DESDataReadNonBlocking               DESDataReadNonBlocking
+#define ROM_DESDataWrite                         DESDataWrite
+#define ROM_DESDataWriteNonBlocking              DESDataWriteNonBlocking
+#define ROM_DESIVSet                             DESIVSet
+#define ROM_DESIntClear                          DESIntClear
+#define ROM_DESIntDisable                        DESIntDisable
+#define ROM_DESIntEnable                         DESIntEnable
+#define ROM_DESIntStatus                         DESIntStatus
+#define ROM_DESKeySet                            DESKeySet
+#define ROM_DESLengthSet                         DESLengthSet
+#define ROM_DESReset                             DESReset
+#define ROM_EEPROMBlockCountGet                  EEPROMBlockCountGet
+#define ROM_EEPROMBlockHide                      EEPROMBlockHide
+#define ROM_EEPROMBlockLock                      EEPROMBlockLock
+#define ROM_EEPROMBlockPasswordSet               EEPROMBlockPasswordSet
+#define ROM_EEPROMBlockProtectGet                EEPROMBlockProtectGet
+#define ROM_EEPROMBlockProtectSet                EEPROMBlockProtectSet
+#define ROM_EEPROMBlockUnlock                    EEPROMBlockUnlock
+#define ROM_EEPROMInit                           EEPROMInit
+#define ROM_EEPROMIntClear                       EEPROMIntClear
+#define ROM_EEPROMIntDisable                     EEPROMIntDisable
+#define ROM_EEPROMIntEnable                      EEPROMIntEnable
+#define ROM_EEPROMIntStatus                      EEPROMIntStatus
+#define ROM_EEPROMMassErase                      EEPROMMassErase
+#define ROM_EEPROMProgram                        EEPROMProgram
+#define ROM_EEPROMProgramNonBlocking             EEPROMProgramNonBlocking
+#define ROM_EEPROMRead                           EEPROMRead
+#define ROM_EEPROMSizeGet                        EEPROMSizeGet
+#define ROM_EEPROMStatusGet                      EEPROMStatusGet
+#define ROM_EMACAddrGet                          EMACAddrGet
+#define ROM_EMACAddrSet                          EMACAddrSet
+#define ROM_EMACConfigGet                        EMACConfigGet
+#define ROM_EMACConfigSet                        EMACConfigSet
+#define ROM_EMACDMAStateGet                      EMACDMAStateGet
+#define ROM_EMACFrameFilterGet                   EMACFrameFilterGet
+#define ROM_EMACFrameFilterSet                   EMACFrameFilterSet
+#define ROM_EMACHashFilterSet                    EMACHashFilterSet
+#define ROM_EMACInit                             EMACInit
+#define ROM_EMACIntClear                         EMACIntClear
+#define ROM_EMACIntDisable                       EMACIntDisable
+#define ROM_EMACIntEnable                        EMACIntEnable
+#define ROM_EMACIntStatus                        EMACIntStatus
+#define ROM_EMACPHYConfigSet                     EMACPHYConfigSet
+#define ROM_EMACPHYPowerOff                      EMACPHYPowerOff
+#define ROM_EMACPHYPowerOn                       EMACPHYPowerOn
+#define ROM_EMACPHYRead                          EMACPHYRead
+#define ROM_EMACPHYWrite                         EMACPHYWrite
+#define ROM_EMACReset                            EMACReset
+#define ROM_EMACRxDMACurrentBufferGet            EMACRxDMACurrentBufferGet
+#define ROM_EMACRxDMACurrentDescriptorGet        EMACRxDMACurrentDescriptorGet
+#define ROM_EMACRxDMADescriptorListGet           EMACRxDMADescriptorListGet
+#define ROM_EMACRxDMADescriptorListSet           EMACRxDMADescriptorListSet
+#define ROM_EMACRxDMAPollDemand                  EMACRxDMAPollDemand
+#define ROM_EMACRxDisable                        EMACRxDisable
+#define ROM_EMACRxEnable                         EMACRxEnable
+#define ROM_EMACRxWatchdogTimerSet               EMACRxWatchdogTimerSet
+#define ROM_EMACStatusGet                        EMACStatusGet
+#define ROM_EMACTxDMACurrentBufferGet            EMACTxDMACurrentBufferGet
+#define ROM_EMACTxDMACurrentDescriptorGet        EMACTxDMACurrentDescriptorGet
+#define ROM_EMACTxDMADescriptorListGet           EMACTxDMADescriptorListGet
+#define ROM_EMACTxDMADescriptorListSet           EMACTxDMADescriptorListSet
+#define ROM_EMACTxDMAPollDemand                  EMACTxDMAPollDemand
+#define ROM_EMACTxDisable                        EMACTxDisable
+#define ROM_EMACTxEnable                         EMACTxEnable
+#define ROM_EMACTxFlush                          EMACTxFlush
+#define ROM_EPIAddressMapSet                     EPIAddressMapSet
+#define ROM_EPIConfigGPModeSet                   EPIConfigGPModeSet
+#define ROM_EPIConfigHB16CSSet                   EPIConfigHB16CSSet
+#define ROM_EPIConfigHB16Set                     EPIConfigHB16Set
+#define ROM_EPIConfigHB16TimingSet               EPIConfigHB16TimingSet
+#define ROM_EPIConfigHB8CSSet                    EPIConfigHB8CSSet
+#define ROM_EPIConfigHB8Set                      EPIConfigHB8Set
+#define ROM_EPIConfigHB8TimingSet                EPIConfigHB8TimingSet
+#define ROM_EPIConfigSDRAMSet                    EPIConfigSDRAMSet
+#define ROM_EPIDMATxCount                        EPIDMATxCount
+#define ROM_EPIDividerCSSet                      EPIDividerCSSet
+#define ROM_EPIDividerSet                        EPIDividerSet
+#define ROM_EPIFIFOConfig                        EPIFIFOConfig
+#define ROM_EPIIntDisable                        EPIIntDisable
+#define ROM_EPIIntEnable                         EPIIntEnable
+#define ROM_EPIIntErrorClear                     EPIIntErrorClear
+#define ROM_EPIIntErrorStatus                    EPIIntErrorStatus
+#define ROM_EPIIntStatus                         EPIIntStatus
+#define ROM_EPIModeSet                           EPIModeSet
+#define ROM_EPINonBlockingReadAvail              EPINonBlockingReadAvail
+#define ROM_EPINonBlockingReadConfigure          EPINonBlockingReadConfigure
+#define ROM_EPINonBlockingReadCount              EPINonBlockingReadCount
+#define ROM_EPINonBlockingReadGet16              EPINonBlockingReadGet16
+#define ROM_EPINonBlockingReadGet32              EPINonBlockingReadGet32
+#define ROM_EPINonBlockingReadGet8               EPINonBlockingReadGet8
+#define ROM_EPINonBlockingReadStart              EPINonBlockingReadStart
+#define ROM_EPINonBlockingReadStop               EPINonBlockingReadStop
+#define ROM_EPIPSRAMConfigRegGet                 EPIPSRAMConfigRegGet
+#define ROM_EPIPSRAMConfigRegGetNonBlocking      EPIPSRAMConfigRegGetNonBlocking
+#define ROM_EPIPSRAMConfigRegRead                EPIPSRAMConfigRegRead
+#define ROM_EPIPSRAMConfigRegSet                 EPIPSRAMConfigRegSet
+#define ROM_EPIWriteFIFOCountGet                 EPIWriteFIFOCountGet
+#define ROM_FPUDisable                           FPUDisable
+#define ROM_FPUEnable                            FPUEnable
+#define ROM_FPUFlushToZeroModeSet                FPUFlushToZeroModeSet
+#define ROM_FPUHalfPrecisionModeSet              FPUHalfPrecisionModeSet
+#define ROM_FPULazyStackingEnable                FPULazyStackingEnable
+#define ROM_FPUNaNModeSet                        FPUNaNModeSet
+#define ROM_FPURoundingModeSet                   FPURoundingModeSet
+#define ROM_FPUStackingDisable                   FPUStackingDisable
+#define ROM_FPUStackingEnable                    FPUStackingEnable
+#define ROM_FanChannelConfigAuto                 FanChannelConfigAuto
+#define ROM_FanChannelConfigManual               FanChannelConfigManual
+#define ROM_FanChannelDisable                    FanChannelDisable
+#define ROM_FanChannelDutyGet                    FanChannelDutyGet
+#define ROM_FanChannelDutySet                    FanChannelDutySet
+#define ROM_FanChannelEnable                     FanChannelEnable
+#define ROM_FanChannelRPMGet                     FanChannelRPMGet
+#define ROM_FanChannelRPMSet                     FanChannelRPMSet
+#define ROM_FanChannelStatus                     FanChannelStatus
+#define ROM_FanChannelsGet                       FanChannelsGet
+#define ROM_FanFractionalRPMDisable              FanFractionalRPMDisable
+#define ROM_FanFractionalRPMEnable               FanFractionalRPMEnable
+#define ROM_FanIntClear                          FanIntClear
+#define ROM_FanIntDisable                        FanIntDisable
+#define ROM_FanIntEnable                         FanIntEnable
+#define ROM_FanIntStatus                         FanIntStatus
+#define ROM_FlashErase                           FlashErase
+#define ROM_FlashIntClear                        FlashIntClear
+#define ROM_FlashIntDisable                      FlashIntDisable
+#define ROM_FlashIntEnable                       FlashIntEnable
+#define ROM_FlashIntStatus                       FlashIntStatus
+#define ROM_FlashProgram                         FlashProgram
+#define ROM_FlashProtectGet                      FlashProtectGet
+#define ROM_FlashProtectSave                     FlashProtectSave
+#define ROM_FlashProtectSet                      FlashProtectSet
+#define ROM_FlashUserGet                         FlashUserGet
+#define ROM_FlashUserSave                        FlashUserSave
+#define ROM_FlashUserSet                         FlashUserSet
+#define ROM_GPIOADCTriggerDisable                GPIOADCTriggerDisable
+#define ROM_GPIOADCTriggerEnable                 GPIOADCTriggerEnable
+#define ROM_GPIODMATriggerDisable                GPIODMATriggerDisable
+#define ROM_GPIODMATriggerEnable                 GPIODMATriggerEnable
+#define ROM_GPIODirModeGet                       GPIODirModeGet
+#define ROM_GPIODirModeSet                       GPIODirModeSet
+#define ROM_GPIOIntClear                         GPIOIntClear
+#define ROM_GPIOIntDisable                       GPIOIntDisable
+#define ROM_GPIOIntEnable                        GPIOIntEnable
+#define ROM_GPIOIntStatus                        GPIOIntStatus
+#define ROM_GPIOIntTypeGet                       GPIOIntTypeGet
+#define ROM_GPIOIntTypeSet                       GPIOIntTypeSet
+#define ROM_GPIOPadConfigGet                     GPIOPadConfigGet
+#define ROM_GPIOPadConfigSet                     GPIOPadConfigSet
+#define ROM_GPIOPinConfigure                     GPIOPinConfigure
+#define ROM_GPIOPinRead                          GPIOPinRead
+#define ROM_GPIOPinTypeADC                       GPIOPinTypeADC
+#define ROM_GPIOPinTypeCAN                       GPIOPinTypeCAN
+#define ROM_GPIOPinTypeCIR                       GPIOPinTypeCIR
+#define ROM_GPIOPinTypeComparator                GPIOPinTypeComparator
+#define ROM_GPIOPinTypeEPI                       GPIOPinTypeEPI
+#define ROM_GPIOPinTypeFan                       GPIOPinTypeFan
+#define ROM_GPIOPinTypeGPIOInput                 GPIOPinTypeGPIOInput
+#define ROM_GPIOPinTypeGPIOOutput                GPIOPinTypeGPIOOutput
+#define ROM_GPIOPinTypeGPIOOutputOD              GPIOPinTypeGPIOOutputOD
+#define ROM_GPIOPinTypeI2C                       GPIOPinTypeI2C
+#define ROM_GPIOPinTypeI2CSCL                    GPIOPinTypeI2CSCL
+#define ROM_GPIOPinTypeKBColumn                  GPIOPinTypeKBColumn
+#define ROM_GPIOPinTypeKBRow                     GPIOPinTypeKBRow
+#define ROM_GPIOPinTypeLCD                       GPIOPinTypeLCD
+#define ROM_GPIOPinTypeLEDSeq                    GPIOPinTypeLEDSeq
+#define ROM_GPIOPinTypeLPC                       GPIOPinTypeLPC
+#define ROM_GPIOPinTypeOneWire                   GPIOPinTypeOneWire
+#define ROM_GPIOPinTypePECIAnalog                GPIOPinTypePECIAnalog
+#define ROM_GPIOPinTypePECIRx                    GPIOPinTypePECIRx
+#define ROM_GPIOPinTypePECITx                    GPIOPinTypePECITx
+#define ROM_GPIOPinTypePS2                       GPIOPinTypePS2
+#define ROM_GPIOPinTypePWM                       GPIOPinTypePWM
+#define ROM_GPIOPinTypeQEI                       GPIOPinTypeQEI
+#define ROM_GPIOPinTypeSSI                       GPIOPinTypeSSI
+#define ROM_GPIOPinTypeTimer                     GPIOPinTypeTimer
+#define ROM_GPIOPinTypeUART                      GPIOPinTypeUART
+#define ROM_GPIOPinTypeUSBAnalog                 GPIOPinTypeUSBAnalog
+#define ROM_GPIOPinTypeUSBDigital                GPIOPinTypeUSBDigital
+#define ROM_GPIOPinTypeWakeHigh                  GPIOPinTypeWakeHigh
+#define ROM_GPIOPinTypeWakeLow                   GPIOPinTypeWakeLow
+#define ROM_GPIOPinWakeStatus                    GPIOPinWakeStatus
+#define ROM_GPIOPinWrite                         GPIOPinWrite
+#define ROM_HibernateBatCheckDone                HibernateBatCheckDone
+#define ROM_HibernateBatCheckStart               HibernateBatCheckStart
+#define ROM_HibernateCalendarGet                 HibernateCalendarGet
+#define ROM_HibernateCalendarMatchGet            HibernateCalendarMatchGet
+#define ROM_HibernateCalendarMatchSet            HibernateCalendarMatchSet
+#define ROM_HibernateCalendarSet                 HibernateCalendarSet
+#define ROM_HibernateClockConfig                 HibernateClockConfig
+#define ROM_HibernateCounterMode                 HibernateCounterMode
+#define ROM_HibernateDataGet                     HibernateDataGet
+#define ROM_HibernateDataSet                     HibernateDataSet
+#define ROM_HibernateDisable                     HibernateDisable
+#define ROM_HibernateEnableExpClk                HibernateEnableExpClk
+#define ROM_HibernateGPIORetentionDisable        HibernateGPIORetentionDisable
+#define ROM_HibernateGPIORetentionEnable         HibernateGPIORetentionEnable
+#define ROM_HibernateGPIORetentionGet            HibernateGPIORetentionGet
+#define ROM_HibernateIntClear                    HibernateIntClear
+#define ROM_HibernateIntDisable                  HibernateIntDisable
+#define ROM_HibernateIntEnable                   HibernateIntEnable
+#define ROM_HibernateIntStatus                   HibernateIntStatus
+#define ROM_HibernateIsActive                    HibernateIsActive
+#define ROM_HibernateLowBatGet                   HibernateLowBatGet
+#define ROM_HibernateLowBatSet                   HibernateLowBatSet
+#define ROM_HibernateRTCDisable                  HibernateRTCDisable
+#define ROM_HibernateRTCEnable                   HibernateRTCEnable
+#define ROM_HibernateRTCGet                      HibernateRTCGet
+#define ROM_HibernateRTCSSGet                    HibernateRTCSSGet
+#define ROM_HibernateRTCSSMatchGet               HibernateRTCSSMatchGet
+#define ROM_HibernateRTCSet                      HibernateRTCSet
+#define ROM_HibernateRTCTrimGet                  HibernateRTCTrimGet
+#define ROM_HibernateRTCTrimSet                  HibernateRTCTrimSet
+#define ROM_HibernateRequest                     HibernateRequest
+#define ROM_HibernateTamperDisable               HibernateTamperDisable
+#define ROM_HibernateTamperEnable                HibernateTamperEnable
+#define ROM_HibernateTamperEventsClear           HibernateTamperEventsClear
+#define ROM_HibernateTamperEventsConfig          HibernateTamperEventsConfig
+#define ROM_HibernateTamperEventsGet             HibernateTamperEventsGet
+#define ROM_HibernateTamperExtOscRecover         HibernateTamperExtOscRecover
+#define ROM_HibernateTamperExtOscValid           HibernateTamperExtOscValid
+#define ROM_HibernateTamperIODisable             HibernateTamperIODisable
+#define ROM_HibernateTamperIOEnable              HibernateTamperIOEnable
+#define ROM_HibernateTamperStatusGet             HibernateTamperStatusGet
+#define ROM_HibernateWakeGet                     HibernateWakeGet
+#define ROM_HibernateWakeSet                     HibernateWakeSet
+#define ROM_I2CFIFODataGet                       I2CFIFODataGet
+#define ROM_I2CFIFODataGetNonBlocking            I2CFIFODataGetNonBlocking
+#define ROM_I2CFIFODataPut                       I2CFIFODataPut
+#define ROM_I2CFIFODataPutNonBlocking            I2CFIFODataPutNonBlocking
+#define ROM_I2CFIFOStatus                        I2CFIFOStatus
+#define ROM_I2CMasterBurstCountGet               I2CMasterBurstCountGet
+#define ROM_I2CMasterBurstLengthSet              I2CMasterBurstLengthSet
+#define ROM_I2CMasterBusBusy                     I2CMasterBusBusy
+#define ROM_I2CMasterBusy                        I2CMasterBusy
+#define ROM_I2CMasterControl                     I2CMasterControl
+#define ROM_I2CMasterDataGet                     I2CMasterDataGet
+#define ROM_I2CMasterDataPut                     I2CMasterDataPut
+#define ROM_I2CMasterDisable                     I2CMasterDisable
+#define ROM_I2CMasterEnable                      I2CMasterEnable
+#define ROM_I2CMasterErr                         I2CMasterErr
+#define ROM_I2CMasterGlitchFilterConfigSet       I2CMasterGlitchFilterConfigSet
+#define ROM_I2CMasterInitExpClk                  I2CMasterInitExpClk
+#define ROM_I2CMasterIntClear                    I2CMasterIntClear
+#define ROM_I2CMasterIntClearEx                  I2CMasterIntClearEx
+#define ROM_I2CMasterIntDisable                  I2CMasterIntDisable
+#define ROM_I2CMasterIntDisableEx                I2CMasterIntDisableEx
+#define ROM_I2CMasterIntEnable                   I2CMasterIntEnable
+#define ROM_I2CMasterIntEnableEx                 I2CMasterIntEnableEx
+#define ROM_I2CMasterIntStatus                   I2CMasterIntStatus
+#define ROM_I2CMasterIntStatusEx                 I2CMasterIntStatusEx
+#define ROM_I2CMasterLineStateGet                I2CMasterLineStateGet
+#define ROM_I2CMasterSlaveAddrSet                I2CMasterSlaveAddrSet
+#define ROM_I2CMasterTimeoutSet                  I2CMasterTimeoutSet
+#define ROM_I2CRxFIFOConfigSet                   I2CRxFIFOConfigSet
+#define ROM_I2CRxFIFOFlush                       I2CRxFIFOFlush
+#define ROM_I2CTxFIFOConfigSet                   I2CTxFIFOConfigSet
+#define ROM_I2CTxFIFOFlush                       I2CTxFIFOFlush
+#define ROM_IntDisable                           IntDisable
+#define ROM_IntEnable                            IntEnable
+#define ROM_IntIsEnabled                         IntIsEnabled
+#define ROM_IntMasterDisable                     IntMasterDisable
+#define ROM_IntMasterEnable                      IntMasterEnable
+#define ROM_IntPendClear                         IntPendClear
+#define ROM_IntPendSet                           IntPendSet
+#define ROM_IntPriorityGet                       IntPriorityGet
+#define ROM_IntPriorityGroupingGet               IntPriorityGroupingGet
+#define ROM_IntPriorityGroupingSet               IntPriorityGroupingSet
+#define ROM_IntPriorityMaskGet                   IntPriorityMaskGet
+#define ROM_IntPriorityMaskSet                   IntPriorityMaskSet
+#define ROM_IntPrioritySet                       IntPrioritySet
+#define ROM_KBScanConfigGet                      KBScanConfigGet
+#define ROM_KBScanConfigSet                      KBScanConfigSet
+#define ROM_KBScanDisable                        KBScanDisable
+#define ROM_KBScanEnable                         KBScanEnable
+#define ROM_KBScanIntClear                       KBScanIntClear
+#define ROM_KBScanIntDisable                     KBScanIntDisable
+#define ROM_KBScanIntEnable                      KBScanIntEnable
+#define ROM_KBScanIntStatus                      KBScanIntStatus
+#define ROM_KBScanStatusGet                      KBScanStatusGet
+#define ROM_KBScanTrigger                        KBScanTrigger
+#define ROM_LCDClockReset                        LCDClockReset
+#define ROM_LCDDMAConfigSet                      LCDDMAConfigSet
+#define ROM_LCDIDDCommandWrite                   LCDIDDCommandWrite
+#define ROM_LCDIDDConfigSet                      LCDIDDConfigSet
+#define ROM_LCDIDDDMADisable                     LCDIDDDMADisable
+#define ROM_LCDIDDDMAWrite                       LCDIDDDMAWrite
+#define ROM_LCDIDDDataRead                       LCDIDDDataRead
+#define ROM_LCDIDDDataWrite                      LCDIDDDataWrite
+#define ROM_LCDIDDIndexedRead                    LCDIDDIndexedRead
+#define ROM_LCDIDDIndexedWrite                   LCDIDDIndexedWrite
+#define ROM_LCDIDDStatusRead                     LCDIDDStatusRead
+#define ROM_LCDIDDTimingSet                      LCDIDDTimingSet
+#define ROM_LCDIntClear                          LCDIntClear
+#define ROM_LCDIntDisable                        LCDIntDisable
+#define ROM_LCDIntEnable                         LCDIntEnable
+#define ROM_LCDIntStatus                         LCDIntStatus
+#define ROM_LCDModeSet                           LCDModeSet
+#define ROM_LCDRasterACBiasIntCountSet           LCDRasterACBiasIntCountSet
+#define ROM_LCDRasterConfigSet                   LCDRasterConfigSet
+#define ROM_LCDRasterDisable                     LCDRasterDisable
+#define ROM_LCDRasterEnable                      LCDRasterEnable
+#define ROM_LCDRasterFrameBufferSet              LCDRasterFrameBufferSet
+#define ROM_LCDRasterPaletteSet                  LCDRasterPaletteSet
+#define ROM_LCDRasterSubPanelConfigSet           LCDRasterSubPanelConfigSet
+#define ROM_LCDRasterSubPanelDisable             LCDRasterSubPanelDisable
+#define ROM_LCDRasterSubPanelEnable              LCDRasterSubPanelEnable
+#define ROM_LCDRasterTimingSet                   LCDRasterTimingSet
+#define ROM_LEDSeqConfigGet                      LEDSeqConfigGet
+#define ROM_LEDSeqConfigSet                      LEDSeqConfigSet
+#define ROM_LEDSeqDisable                        LEDSeqDisable
+#define ROM_LEDSeqEnable                         LEDSeqEnable
+#define ROM_LEDSeqIntClear                       LEDSeqIntClear
+#define ROM_LEDSeqIntDisable                     LEDSeqIntDisable
+#define ROM_LEDSeqIntEnable                      LEDSeqIntEnable
+#define ROM_LEDSeqIntStatus                      LEDSeqIntStatus
+#define ROM_LEDSeqSequenceGet                    LEDSeqSequenceGet
+#define ROM_LEDSeqSequenceSet                    LEDSeqSequenceSet
+#define ROM_LPCBByteRead                         LPCBByteRead
+#define ROM_LPCBByteWrite                        LPCBByteWrite
+#define ROM_LPCBCOMCTSSet                        LPCBCOMCTSSet
+#define ROM_LPCBCOMDSRSet                        LPCBCOMDSRSet
+#define ROM_LPCBCOMIntDisable                    LPCBCOMIntDisable
+#define ROM_LPCBCOMIntEnable                     LPCBCOMIntEnable
+#define ROM_LPCBCOMInterceptRXFIFOWrite          LPCBCOMInterceptRXFIFOWrite
+#define ROM_LPCBCOMInterceptTXFIFORead           LPCBCOMInterceptTXFIFORead
+#define ROM_LPCBCOMStatusGet                     LPCBCOMStatusGet
+#define ROM_LPCBChannelConfigCOMGet              LPCBChannelConfigCOMGet
+#define ROM_LPCBChannelConfigCOMSet              LPCBChannelConfigCOMSet
+#define ROM_LPCBChannelConfigCOMxSet             LPCBChannelConfigCOMxSet
+#define ROM_LPCBChannelConfigEPSet               LPCBChannelConfigEPSet
+#define ROM_LPCBChannelConfigGet                 LPCBChannelConfigGet
+#define ROM_LPCBChannelConfigMBSet               LPCBChannelConfigMBSet
+#define ROM_LPCBChannelDMAConfigGet              LPCBChannelDMAConfigGet
+#define ROM_LPCBChannelDMAConfigSet              LPCBChannelDMAConfigSet
+#define ROM_LPCBChannelDisable                   LPCBChannelDisable
+#define ROM_LPCBChannelEnable                    LPCBChannelEnable
+#define ROM_LPCBChannelPoolAddressGet            LPCBChannelPoolAddressGet
+#define ROM_LPCBChannelStallClear                LPCBChannelStallClear
+#define ROM_LPCBChannelStatusClear               LPCBChannelStatusClear
+#define ROM_LPCBChannelStatusGet                 LPCBChannelStatusGet
+#define ROM_LPCBChannelStatusSet                 LPCBChannelStatusSet
+#define ROM_LPCBConfigGet                        LPCBConfigGet
+#define ROM_LPCBConfigSet                        LPCBConfigSet
+#define ROM_LPCBHalfWordRead                     LPCBHalfWordRead
+#define ROM_LPCBHalfWordWrite                    LPCBHalfWordWrite
+#define ROM_LPCBIRQClear                         LPCBIRQClear
+#define ROM_LPCBIRQConfig                        LPCBIRQConfig
+#define ROM_LPCBIRQGet                           LPCBIRQGet
+#define ROM_LPCBIRQSend                          LPCBIRQSend
+#define ROM_LPCBIRQSet                           LPCBIRQSet
+#define ROM_LPCBIntClear                         LPCBIntClear
+#define ROM_LPCBIntDisable                       LPCBIntDisable
+#define ROM_LPCBIntEnable                        LPCBIntEnable
+#define ROM_LPCBIntStatus                        LPCBIntStatus
+#define ROM_LPCBRTCAddressSet                    LPCBRTCAddressSet
+#define ROM_LPCBSCIAssert                        LPCBSCIAssert
+#define ROM_LPCBStatusBlockAddressGet            LPCBStatusBlockAddressGet
+#define ROM_LPCBStatusBlockAddressSet            LPCBStatusBlockAddressSet
+#define ROM_LPCBStatusGet                        LPCBStatusGet
+#define ROM_LPCBWordRead                         LPCBWordRead
+#define ROM_LPCBWordWrite                        LPCBWordWrite
+#define ROM_LPCByteRead                          LPCByteRead
+#define ROM_LPCByteWrite                         LPCByteWrite
+#define ROM_LPCCOMxIntClear                      LPCCOMxIntClear
+#define ROM_LPCCOMxIntDisable                    LPCCOMxIntDisable
+#define ROM_LPCCOMxIntEnable                     LPCCOMxIntEnable
+#define ROM_LPCCOMxIntStatus                     LPCCOMxIntStatus
+#define ROM_LPCChannelConfigCOMxSet              LPCChannelConfigCOMxSet
+#define ROM_LPCChannelConfigEPSet                LPCChannelConfigEPSet
+#define ROM_LPCChannelConfigGet                  LPCChannelConfigGet
+#define ROM_LPCChannelConfigMBSet                LPCChannelConfigMBSet
+#define ROM_LPCChannelDMAConfigGet               LPCChannelDMAConfigGet
+#define ROM_LPCChannelDMAConfigSet               LPCChannelDMAConfigSet
+#define ROM_LPCChannelDisable                    LPCChannelDisable
+#define ROM_LPCChannelEnable                     LPCChannelEnable
+#define ROM_LPCChannelPoolAddressGet             LPCChannelPoolAddressGet
+#define ROM_LPCChannelStatusClear                LPCChannelStatusClear
+#define ROM_LPCChannelStatusGet                  LPCChannelStatusGet
+#define ROM_LPCChannelStatusSet                  LPCChannelStatusSet
+#define ROM_LPCConfigGet                         LPCConfigGet
+#define ROM_LPCConfigSet                         LPCConfigSet
+#define ROM_LPCHalfWordRead                      LPCHalfWordRead
+#define ROM_LPCHalfWordWrite                     LPCHalfWordWrite
+#define ROM_LPCIRQClear                          LPCIRQClear
+#define ROM_LPCIRQConfig                         LPCIRQConfig
+#define ROM_LPCIRQGet                            LPCIRQGet
+#define ROM_LPCIRQSend                           LPCIRQSend
+#define ROM_LPCIRQSet                            LPCIRQSet
+#define ROM_LPCIntClear                          LPCIntClear
+#define ROM_LPCIntDisable                        LPCIntDisable
+#define ROM_LPCIntEnable                         LPCIntEnable
+#define ROM_LPCIntStatus                         LPCIntStatus
+#define ROM_LPCSCIAssert                         LPCSCIAssert
+#define ROM_LPCStatusBlockAddressGet             LPCStatusBlockAddressGet
+#define ROM_LPCStatusBlockAddressSet             LPCStatusBlockAddressSet
+#define ROM_LPCStatusGet                         LPCStatusGet
+#define ROM_LPCWordRead                          LPCWordRead
+#define ROM_LPCWordWrite                         LPCWordWrite
+#define ROM_MPUDisable                           MPUDisable
+#define ROM_MPUEnable                            MPUEnable
+#define ROM_MPURegionCountGet                    MPURegionCountGet
+#define ROM_MPURegionDisable                     MPURegionDisable
+#define ROM_MPURegionEnable                      MPURegionEnable
+#define ROM_MPURegionGet                         MPURegionGet
+#define ROM_MPURegionSet                         MPURegionSet
+#define ROM_OneWireBusReset                      OneWireBusReset
+#define ROM_OneWireBusStatus                     OneWireBusStatus
+#define ROM_OneWireDMADisable                    OneWireDMADisable
+#define ROM_OneWireDMAEnable                     OneWireDMAEnable
+#define ROM_OneWireDataGet                       OneWireDataGet
+#define ROM_OneWireDataGetNonBlocking            OneWireDataGetNonBlocking
+#define ROM_OneWireInit                          OneWireInit
+#define ROM_OneWireIntClear                      OneWireIntClear
+#define ROM_OneWireIntDisable                    OneWireIntDisable
+#define ROM_OneWireIntEnable                     OneWireIntEnable
+#define ROM_OneWireIntStatus                     OneWireIntStatus
+#define ROM_OneWireTransaction                   OneWireTransaction
+#define ROM_PECIAdvCmdSend                       PECIAdvCmdSend
+#define ROM_PECIAdvCmdSendNonBlocking            PECIAdvCmdSendNonBlocking
+#define ROM_PECIAdvCmdStatusGet                  PECIAdvCmdStatusGet
+#define ROM_PECIBaudGet                          PECIBaudGet
+#define ROM_PECIBypassDisable                    PECIBypassDisable
+#define ROM_PECIBypassEnable                     PECIBypassEnable
+#define ROM_PECIConfigGet                        PECIConfigGet
+#define ROM_PECIConfigSet                        PECIConfigSet
+#define ROM_PECIDomainAverageConfigGet           PECIDomainAverageConfigGet
+#define ROM_PECIDomainAverageConfigSet           PECIDomainAverageConfigSet
+#define ROM_PECIDomainAverageGet                 PECIDomainAverageGet
+#define ROM_PECIDomainConfigGet                  PECIDomainConfigGet
+#define ROM_PECIDomainConfigSet                  PECIDomainConfigSet
+#define ROM_PECIDomainDisable                    PECIDomainDisable
+#define ROM_PECIDomainEnable                     PECIDomainEnable
+#define ROM_PECIDomainMaxReadClear               PECIDomainMaxReadClear
+#define ROM_PECIDomainMaxReadGet                 PECIDomainMaxReadGet
+#define ROM_PECIDomainValueClear                 PECIDomainValueClear
+#define ROM_PECIDomainValueGet                   PECIDomainValueGet
+#define ROM_PECIIntClear                         PECIIntClear
+#define ROM_PECIIntDisable                       PECIIntDisable
+#define ROM_PECIIntEnable                        PECIIntEnable
+#define ROM_PECIIntStatus                        PECIIntStatus
+#define ROM_PS2CommandWrite                      PS2CommandWrite
+#define ROM_PS2ConfigGet                         PS2ConfigGet
+#define ROM_PS2ConfigSet                         PS2ConfigSet
+#define ROM_PS2DataRead                          PS2DataRead
+#define ROM_PS2Disable                           PS2Disable
+#define ROM_PS2Enable                            PS2Enable
+#define ROM_PS2InhibitClear                      PS2InhibitClear
+#define ROM_PS2InhibitSet                        PS2InhibitSet
+#define ROM_PS2IntClear                          PS2IntClear
+#define ROM_PS2IntDisable                        PS2IntDisable
+#define ROM_PS2IntEnable                         PS2IntEnable
+#define ROM_PS2IntStatus                         PS2IntStatus
+#define ROM_PS2StatusGet                         PS2StatusGet
+#define ROM_PWMClockGet                          PWMClockGet
+#define ROM_PWMClockSet                          PWMClockSet
+#define ROM_PWMDeadBandDisable                   PWMDeadBandDisable
+#define ROM_PWMDeadBandEnable                    PWMDeadBandEnable
+#define ROM_PWMFaultIntClear                     PWMFaultIntClear
+#define ROM_PWMFaultIntClearExt                  PWMFaultIntClearExt
+#define ROM_PWMGenConfigure                      PWMGenConfigure
+#define ROM_PWMGenDisable                        PWMGenDisable
+#define ROM_PWMGenEnable                         PWMGenEnable
+#define ROM_PWMGenFaultClear                     PWMGenFaultClear
+#define ROM_PWMGenFaultConfigure                 PWMGenFaultConfigure
+#define ROM_PWMGenFaultStatus                    PWMGenFaultStatus
+#define ROM_PWMGenFaultTriggerGet                PWMGenFaultTriggerGet
+#define ROM_PWMGenFaultTriggerSet                PWMGenFaultTriggerSet
+#define ROM_PWMGenIntClear                       PWMGenIntClear
+#define ROM_PWMGenIntStatus                      PWMGenIntStatus
+#define ROM_PWMGenIntTrigDisable                 PWMGenIntTrigDisable
+#define ROM_PWMGenIntTrigEnable                  PWMGenIntTrigEnable
+#define ROM_PWMGenPeriodGet                      PWMGenPeriodGet
+#define ROM_PWMGenPeriodSet                      PWMGenPeriodSet
+#define ROM_PWMIntDisable                        PWMIntDisable
+#define ROM_PWMIntEnable                         PWMIntEnable
+#define ROM_PWMIntStatus                         PWMIntStatus
+#define ROM_PWMOutputFault                       PWMOutputFault
+#define ROM_PWMOutputFaultLevel                  PWMOutputFaultLevel
+#define ROM_PWMOutputInvert                      PWMOutputInvert
+#define ROM_PWMOutputState                       PWMOutputState
+#define ROM_PWMOutputUpdateMode                  PWMOutputUpdateMode
+#define ROM_PWMPulseWidthGet                     PWMPulseWidthGet
+#define ROM_PWMPulseWidthSet                     PWMPulseWidthSet
+#define ROM_PWMSyncTimeBase                      PWMSyncTimeBase
+#define ROM_PWMSyncUpdate                        PWMSyncUpdate
+#define ROM_Port80Config                         Port80Config
+#define ROM_Port80DataWrite                      Port80DataWrite
+#define ROM_QEIConfigure                         QEIConfigure
+#define ROM_QEIDirectionGet                      QEIDirectionGet
+#define ROM_QEIDisable                           QEIDisable
+#define ROM_QEIEnable                            QEIEnable
+#define ROM_QEIErrorGet                          QEIErrorGet
+#define ROM_QEIIntClear                          QEIIntClear
+#define ROM_QEIIntDisable                        QEIIntDisable
+#define ROM_QEIIntEnable                         QEIIntEnable
+#define ROM_QEIIntStatus                         QEIIntStatus
+#define ROM_QEIPositionGet                       QEIPositionGet
+#define ROM_QEIPositionSet                       QEIPositionSet
+#define ROM_QEIVelocityConfigure                 QEIVelocityConfigure
+#define ROM_QEIVelocityDisable                   QEIVelocityDisable
+#define ROM_QEIVelocityEnable                    QEIVelocityEnable
+#define ROM_QEIVelocityGet                       QEIVelocityGet
+#define ROM_SHAMD5ConfigSet                      SHAMD5ConfigSet
+#define ROM_SHAMD5DMADisable                     SHAMD5DMADisable
+#define ROM_SHAMD5DMAEnable                      SHAMD5DMAEnable
+#define ROM_SHAMD5DataProcess                    SHAMD5DataProcess
+#define ROM_SHAMD5DataWrite                      SHAMD5DataWrite
+#define ROM_SHAMD5DataWriteNonBlocking           SHAMD5DataWriteNonBlocking
+#define ROM_SHAMD5HMACKeySet                     SHAMD5HMACKeySet
+#define ROM_SHAMD5HMACPPKeyGenerate              SHAMD5HMACPPKeyGenerate
+#define ROM_SHAMD5HMACPPKeySet                   SHAMD5HMACPPKeySet
+#define ROM_SHAMD5HMACProcess                    SHAMD5HMACProcess
+#define ROM_SHAMD5HashLengthSet                  SHAMD5HashLengthSet
+#define ROM_SHAMD5IntClear                       SHAMD5IntClear
+#define ROM_SHAMD5IntDisable                     SHAMD5IntDisable
+#define ROM_SHAMD5IntEnable                      SHAMD5IntEnable
+#define ROM_SHAMD5IntStatus                      SHAMD5IntStatus
+#define ROM_SHAMD5Reset                          SHAMD5Reset
+#define ROM_SHAMD5ResultRead                     SHAMD5ResultRead
+#define ROM_SMBusARPDisable                      SMBusARPDisable
+#define ROM_SMBusARPEnable                       SMBusARPEnable
+#define ROM_SMBusARPUDIDPacketDecode             SMBusARPUDIDPacketDecode
+#define ROM_SMBusARPUDIDPacketEncode             SMBusARPUDIDPacketEncode
+#define ROM_SMBusDMADisable                      SMBusDMADisable
+#define ROM_SMBusDMAEnable                       SMBusDMAEnable
+#define ROM_SMBusFIFODisable                     SMBusFIFODisable
+#define ROM_SMBusFIFOEnable                      SMBusFIFOEnable
+#define ROM_SMBusMasterARPAssignAddress          SMBusMasterARPAssignAddress
+#define ROM_SMBusMasterARPGetUDIDDir             SMBusMasterARPGetUDIDDir
+#define ROM_SMBusMasterARPGetUDIDGen             SMBusMasterARPGetUDIDGen
+#define ROM_SMBusMasterARPNotifyMaster           SMBusMasterARPNotifyMaster
+#define ROM_SMBusMasterARPPrepareToARP           SMBusMasterARPPrepareToARP
+#define ROM_SMBusMasterARPResetDeviceDir         SMBusMasterARPResetDeviceDir
+#define ROM_SMBusMasterARPResetDeviceGen         SMBusMasterARPResetDeviceGen
+#define ROM_SMBusMasterBlockProcessCall          SMBusMasterBlockProcessCall
+#define ROM_SMBusMasterBlockRead                 SMBusMasterBlockRead
+#define ROM_SMBusMasterBlockWrite                SMBusMasterBlockWrite
+#define ROM_SMBusMasterByteReceive               SMBusMasterByteReceive
+#define ROM_SMBusMasterByteSend                  SMBusMasterByteSend
+#define ROM_SMBusMasterByteWordRead              SMBusMasterByteWordRead
+#define ROM_SMBusMasterByteWordWrite             SMBusMasterByteWordWrite
+#define ROM_SMBusMasterHostNotify                SMBusMasterHostNotify
+#define ROM_SMBusMasterI2CRead                   SMBusMasterI2CRead
+#define ROM_SMBusMasterI2CWrite                  SMBusMasterI2CWrite
+#define ROM_SMBusMasterI2CWriteRead              SMBusMasterI2CWriteRead
+#define ROM_SMBusMasterInit                      SMBusMasterInit
+#define ROM_SMBusMasterIntEnable                 SMBusMasterIntEnable
+#define ROM_SMBusMasterIntProcess                SMBusMasterIntProcess
+#define ROM_SMBusMasterProcessCall               SMBusMasterProcessCall
+#define ROM_SMBusMasterQuickCommand              SMBusMasterQuickCommand
+#define ROM_SMBusPECDisable                      SMBusPECDisable
+#define ROM_SMBusPECEnable                       SMBusPECEnable
+#define ROM_SMBusRxPacketSizeGet                 SMBusRxPacketSizeGet
+#define ROM_SMBusSlaveACKSend                    SMBusSlaveACKSend
+#define ROM_SMBusSlaveARPFlagARGet               SMBusSlaveARPFlagARGet
+#define ROM_SMBusSlaveARPFlagARSet               SMBusSlaveARPFlagARSet
+#define ROM_SMBusSlaveARPFlagAVGet               SMBusSlaveARPFlagAVGet
+#define ROM_SMBusSlaveARPFlagAVSet               SMBusSlaveARPFlagAVSet
+#define ROM_SMBusSlaveAddressSet                 SMBusSlaveAddressSet
+#define ROM_SMBusSlaveBlockTransferDisable       SMBusSlaveBlockTransferDisable
+#define ROM_SMBusSlaveBlockTransferEnable        SMBusSlaveBlockTransferEnable
+#define ROM_SMBusSlaveCommandGet                 SMBusSlaveCommandGet
+#define ROM_SMBusSlaveDataSend                   SMBusSlaveDataSend
+#define ROM_SMBusSlaveI2CDisable                 SMBusSlaveI2CDisable
+#define ROM_SMBusSlaveI2CEnable                  SMBusSlaveI2CEnable
+#define ROM_SMBusSlaveInit                       SMBusSlaveInit
+#define ROM_SMBusSlaveIntAddressGet              SMBusSlaveIntAddressGet
+#define ROM_SMBusSlaveIntEnable                  SMBusSlaveIntEnable
+#define ROM_SMBusSlaveIntProcess                 SMBusSlaveIntProcess
+#define ROM_SMBusSlaveManualACKDisable           SMBusSlaveManualACKDisable
+#define ROM_SMBusSlaveManualACKEnable            SMBusSlaveManualACKEnable
+#define ROM_SMBusSlaveManualACKStatusGet         SMBusSlaveManualACKStatusGet
+#define ROM_SMBusSlaveProcessCallDisable         SMBusSlaveProcessCallDisable
+#define ROM_SMBusSlaveProcessCallEnable          SMBusSlaveProcessCallEnable
+#define ROM_SMBusSlaveRxBufferSet                SMBusSlaveRxBufferSet
+#define ROM_SMBusSlaveTransferInit               SMBusSlaveTransferInit
+#define ROM_SMBusSlaveTxBufferSet                SMBusSlaveTxBufferSet
+#define ROM_SMBusSlaveUDIDSet                    SMBusSlaveUDIDSet
+#define ROM_SMBusStatusGet                       SMBusStatusGet
+#define ROM_SPIFlashBlockErase32                 SPIFlashBlockErase32
+#define ROM_SPIFlashBlockErase64                 SPIFlashBlockErase64
+#define ROM_SPIFlashChipErase                    SPIFlashChipErase
+#define ROM_SPIFlashDualRead                     SPIFlashDualRead
+#define ROM_SPIFlashDualReadNonBlocking          SPIFlashDualReadNonBlocking
+#define ROM_SPIFlashFastRead                     SPIFlashFastRead
+#define ROM_SPIFlashFastReadNonBlocking          SPIFlashFastReadNonBlocking
+#define ROM_SPIFlashInit                         SPIFlashInit
+#define ROM_SPIFlashIntHandler                   SPIFlashIntHandler
+#define ROM_SPIFlashPageProgram                  SPIFlashPageProgram
+#define ROM_SPIFlashPageProgramNonBlocking       SPIFlashPageProgramNonBlocking
+#define ROM_SPIFlashQuadRead                     SPIFlashQuadRead
+#define ROM_SPIFlashQuadReadNonBlocking          SPIFlashQuadReadNonBlocking
+#define ROM_SPIFlashRead                         SPIFlashRead
+#define ROM_SPIFlashReadID                       SPIFlashReadID
+#define ROM_SPIFlashReadNonBlocking              SPIFlashReadNonBlocking
+#define ROM_SPIFlashReadStatus                   SPIFlashReadStatus
+#define ROM_SPIFlashSectorErase                  SPIFlashSectorErase
+#define ROM_SPIFlashWriteDisable                 SPIFlashWriteDisable
+#define ROM_SPIFlashWriteEnable                  SPIFlashWriteEnable
+#define ROM_SPIFlashWriteStatus                  SPIFlashWriteStatus
+#define ROM_SSIAdvDataPutFrameEnd                SSIAdvDataPutFrameEnd
+#define ROM_SSIAdvDataPutFrameEndNonBlocking     SSIAdvDataPutFrameEndNonBlocking
+#define ROM_SSIAdvFrameHoldDisable               SSIAdvFrameHoldDisable
+#define ROM_SSIAdvFrameHoldEnable                SSIAdvFrameHoldEnable
+#define ROM_SSIAdvModeSet                        SSIAdvModeSet
+#define ROM_SSIBusy                              SSIBusy
+#define ROM_SSIClockSourceGet                    SSIClockSourceGet
+#define ROM_SSIClockSourceSet                    SSIClockSourceSet
+#define ROM_SSIConfigSetExpClk                   SSIConfigSetExpClk
+#define ROM_SSIDMADisable                        SSIDMADisable
+#define ROM_SSIDMAEnable                         SSIDMAEnable
+#define ROM_SSIDataGet                           SSIDataGet
+#define ROM_SSIDataGetNonBlocking                SSIDataGetNonBlocking
+#define ROM_SSIDataPut                           SSIDataPut
+#define ROM_SSIDataPutNonBlocking                SSIDataPutNonBlocking
+#define ROM_SSIDisable                           SSIDisable
+#define ROM_SSIEnable                            SSIEnable
+#define ROM_SSIIntClear                          SSIIntClear
+#define ROM_SSIIntDisable                        SSIIntDisable
+#define ROM_SSIIntEnable                         SSIIntEnable
+#define ROM_SSIIntStatus                         SSIIntStatus
+#define ROM_SysCtlADCSpeedGet                    SysCtlADCSpeedGet
+#define ROM_SysCtlADCSpeedSet                    SysCtlADCSpeedSet
+#define ROM_SysCtlAltClkConfig                   SysCtlAltClkConfig
+#define ROM_SysCtlBrownOutConfigSet              SysCtlBrownOutConfigSet
+#define ROM_SysCtlClockFreqSet                   SysCtlClockFreqSet
+#define ROM_SysCtlClockGet                       SysCtlClockGet
+#define ROM_SysCtlClockOutConfig                 SysCtlClockOutConfig
+#define ROM_SysCtlClockSet                       SysCtlClockSet
+#define ROM_SysCtlDeepSleep                      SysCtlDeepSleep
+#define ROM_SysCtlDeepSleepClockConfigSet        SysCtlDeepSleepClockConfigSet
+#define ROM_SysCtlDeepSleepClockSet              SysCtlDeepSleepClockSet
+#define ROM_SysCtlDelay                          SysCtlDelay
+#define ROM_SysCtlFlashSectorSizeGet             SysCtlFlashSectorSizeGet
+#define ROM_SysCtlFlashSizeGet                   SysCtlFlashSizeGet
+#define ROM_SysCtlIntClear                       SysCtlIntClear
+#define ROM_SysCtlIntDisable                     SysCtlIntDisable
+#define ROM_SysCtlIntEnable                      SysCtlIntEnable
+#define ROM_SysCtlIntStatus                      SysCtlIntStatus
+#define ROM_SysCtlLDOConfigSet                   SysCtlLDOConfigSet
+#define ROM_SysCtlLPCLowPowerConfigSet           SysCtlLPCLowPowerConfigSet
+#define ROM_SysCtlLPCLowPowerStatusGet           SysCtlLPCLowPowerStatusGet
+#define ROM_SysCtlMOSCConfigSet                  SysCtlMOSCConfigSet
+#define ROM_SysCtlNMIClear                       SysCtlNMIClear
+#define ROM_SysCtlNMIStatus                      SysCtlNMIStatus
+#define ROM_SysCtlPIOSCCalibrate                 SysCtlPIOSCCalibrate
+#define ROM_SysCtlPWMClockGet                    SysCtlPWMClockGet
+#define ROM_SysCtlPWMClockSet                    SysCtlPWMClockSet
+#define ROM_SysCtlPeripheralClockGating          SysCtlPeripheralClockGating
+#define ROM_SysCtlPeripheralDeepSleepDisable     SysCtlPeripheralDeepSleepDisable
+#define ROM_SysCtlPeripheralDeepSleepEnable      SysCtlPeripheralDeepSleepEnable
+#define ROM_SysCtlPeripheralDisable              SysCtlPeripheralDisable
+#define ROM_SysCtlPeripheralEnable               SysCtlPeripheralEnable
+#define ROM_SysCtlPeripheralPowerOff             SysCtlPeripheralPowerOff
+#define ROM_SysCtlPeripheralPowerOn              SysCtlPeripheralPowerOn
+#define ROM_SysCtlPeripheralPresent              SysCtlPeripheralPresent
+#define ROM_SysCtlPeripheralReady                SysCtlPeripheralReady
+#define ROM_SysCtlPeripheralReset                SysCtlPeripheralReset
+#define ROM_SysCtlPeripheralSleepDisable         SysCtlPeripheralSleepDisable
+#define ROM_SysCtlPeripheralSleepEnable          SysCtlPeripheralSleepEnable
+#define ROM_SysCtlReset                          SysCtlReset
+#define ROM_SysCtlResetBehaviorGet               SysCtlResetBehaviorGet
+#define ROM_SysCtlResetBehaviorSet               SysCtlResetBehaviorSet
+#define ROM_SysCtlResetCauseClear                SysCtlResetCauseClear
+#define ROM_SysCtlResetCauseGet                  SysCtlResetCauseGet
+#define ROM_SysCtlSRAMSizeGet                    SysCtlSRAMSizeGet
+#define ROM_SysCtlSleep                          SysCtlSleep
+#define ROM_SysCtlUSBPLLDisable                  SysCtlUSBPLLDisable
+#define ROM_SysCtlUSBPLLEnable                   SysCtlUSBPLLEnable
+#define ROM_SysCtlVoltageEventClear              SysCtlVoltageEventClear
+#define ROM_SysCtlVoltageEventConfig             SysCtlVoltageEventConfig
+#define ROM_SysCtlVoltageEventStatus             SysCtlVoltageEventStatus
+#define ROM_SysExcIntClear                       SysExcIntClear
+#define ROM_SysExcIntDisable                     SysExcIntDisable
+#define ROM_SysExcIntEnable                      SysExcIntEnable
+#define ROM_SysExcIntStatus                      SysExcIntStatus
+#define ROM_SysTickDisable                       SysTickDisable
+#define ROM_SysTickEnable                        SysTickEnable
+#define ROM_SysTickIntDisable                    SysTickIntDisable
+#define ROM_SysTickIntEnable                     SysTickIntEnable
+#define ROM_SysTickPeriodGet                     SysTickPeriodGet
+#define ROM_SysTickPeriodSet                     SysTickPeriodSet
+#define ROM_SysTickValueGet                      SysTickValueGet
+#define ROM_TimerADCEventGet                     TimerADCEventGet
+#define ROM_TimerADCEventSet                     TimerADCEventSet
+#define ROM_TimerClockSourceGet                  TimerClockSourceGet
+#define ROM_TimerClockSourceSet                  TimerClockSourceSet
+#define ROM_TimerConfigure                       TimerConfigure
+#define ROM_TimerControlEvent                    TimerControlEvent
+#define ROM_TimerControlLevel                    TimerControlLevel
+#define ROM_TimerControlStall                    TimerControlStall
+#define ROM_TimerControlTrigger                  TimerControlTrigger
+#define ROM_TimerControlWaitOnTrigger            TimerControlWaitOnTrigger
+#define ROM_TimerDMAEventGet                     TimerDMAEventGet
+#define ROM_TimerDMAEventSet                     TimerDMAEventSet
+#define ROM_TimerDisable                         TimerDisable
+#define ROM_TimerEnable                          TimerEnable
+#define ROM_TimerIntClear                        TimerIntClear
+#define ROM_TimerIntDisable                      TimerIntDisable
+#define ROM_TimerIntEnable                       TimerIntEnable
+#define ROM_TimerIntStatus                       TimerIntStatus
+#define ROM_TimerLoadGet                         TimerLoadGet
+#define ROM_TimerLoadGet64                       TimerLoadGet64
+#define ROM_TimerLoadSet                         TimerLoadSet
+#define ROM_TimerLoadSet64                       TimerLoadSet64
+#define ROM_TimerMatchGet                        TimerMatchGet
+#define ROM_TimerMatchGet64                      TimerMatchGet64
+#define ROM_TimerMatchSet                        TimerMatchSet
+#define ROM_TimerMatchSet64                      TimerMatchSet64
+#define ROM_TimerPrescaleGet                     TimerPrescaleGet
+#define ROM_TimerPrescaleMatchGet                TimerPrescaleMatchGet
+#define ROM_TimerPrescaleMatchSet                TimerPrescaleMatchSet
+#define ROM_TimerPrescaleSet                     TimerPrescaleSet
+#define ROM_TimerRTCDisable                      TimerRTCDisable
+#define ROM_TimerRTCEnable                       TimerRTCEnable
+#define ROM_TimerSynchronize                     TimerSynchronize
+#define ROM_TimerValueGet                        TimerValueGet
+#define ROM_TimerValueGet64                      TimerValueGet64
+#define ROM_UART9BitAddrSend                     UART9BitAddrSend
+#define ROM_UART9BitAddrSet                      UART9BitAddrSet
+#define ROM_UART9BitDisable                      UART9BitDisable
+#define ROM_UART9BitEnable                       UART9BitEnable
+#define ROM_UARTBreakCtl                         UARTBreakCtl
+#define ROM_UARTBusy                             UARTBusy
+#define ROM_UARTCharGet                          UARTCharGet
+#define ROM_UARTCharGetNonBlocking               UARTCharGetNonBlocking
+#define ROM_UARTCharPut                          UARTCharPut
+#define ROM_UARTCharPutNonBlocking               UARTCharPutNonBlocking
+#define ROM_UARTCharsAvail                       UARTCharsAvail
+#define ROM_UARTClockSourceGet                   UARTClockSourceGet
+#define ROM_UARTClockSourceSet                   UARTClockSourceSet
+#define ROM_UARTConfigGetExpClk                  UARTConfigGetExpClk
+#define ROM_UARTConfigSetExpClk                  UARTConfigSetExpClk
+#define ROM_UARTDMADisable                       UARTDMADisable
+#define ROM_UARTDMAEnable                        UARTDMAEnable
+#define ROM_UARTDisable                          UARTDisable
+#define ROM_UARTDisableSIR                       UARTDisableSIR
+#define ROM_UARTEnable                           UARTEnable
+#define ROM_UARTEnableSIR                        UARTEnableSIR
+#define ROM_UARTFIFODisable                      UARTFIFODisable
+#define ROM_UARTFIFOEnable                       UARTFIFOEnable
+#define ROM_UARTFIFOLevelGet                     UARTFIFOLevelGet
+#define ROM_UARTFIFOLevelSet                     UARTFIFOLevelSet
+#define ROM_UARTFlowControlGet                   UARTFlowControlGet
+#define ROM_UARTFlowControlSet                   UARTFlowControlSet
+#define ROM_UARTIntClear                         UARTIntClear
+#define ROM_UARTIntDisable                       UARTIntDisable
+#define ROM_UARTIntEnable                        UARTIntEnable
+#define ROM_UARTIntStatus                        UARTIntStatus
+#define ROM_UARTModemControlClear                UARTModemControlClear
+#define ROM_UARTModemControlGet                  UARTModemControlGet
+#define ROM_UARTModemControlSet                  UARTModemControlSet
+#define ROM_UARTModemStatusGet                   UARTModemStatusGet
+#define ROM_UARTParityModeGet                    UARTParityModeGet
+#define ROM_UARTParityModeSet                    UARTParityModeSet
+#define ROM_UARTRxErrorClear                     UARTRxErrorClear
+#define ROM_UARTRxErrorGet                       UARTRxErrorGet
+#define ROM_UARTSmartCardDisable                 UARTSmartCardDisable
+#define ROM_UARTSmartCardEnable                  UARTSmartCardEnable
+#define ROM_UARTSpaceAvail                       UARTSpaceAvail
+#define ROM_UARTTxIntModeGet                     UARTTxIntModeGet
+#define ROM_UARTTxIntModeSet                     UARTTxIntModeSet
+#define ROM_USBClockDisable                      USBClockDisable
+#define ROM_USBClockEnable                       USBClockEnable
+#define ROM_USBControllerVersion                 USBControllerVersion
+#define ROM_USBDMAChannelAddressGet              USBDMAChannelAddressGet
+#define ROM_USBDMAChannelAddressSet              USBDMAChannelAddressSet
+#define ROM_USBDMAChannelConfigSet               USBDMAChannelConfigSet
+#define ROM_USBDMAChannelCountGet                USBDMAChannelCountGet
+#define ROM_USBDMAChannelCountSet                USBDMAChannelCountSet
+#define ROM_USBDMAChannelDisable                 USBDMAChannelDisable
+#define ROM_USBDMAChannelEnable                  USBDMAChannelEnable
+#define ROM_USBDMAChannelIntDisable              USBDMAChannelIntDisable
+#define ROM_USBDMAChannelIntEnable               USBDMAChannelIntEnable
+#define ROM_USBDMAChannelIntStatus               USBDMAChannelIntStatus
+#define ROM_USBDMAChannelStatus                  USBDMAChannelStatus
+#define ROM_USBDMAChannelStatusClear             USBDMAChannelStatusClear
+#define ROM_USBDevAddrGet                        USBDevAddrGet
+#define ROM_USBDevAddrSet                        USBDevAddrSet
+#define ROM_USBDevConnect                        USBDevConnect
+#define ROM_USBDevDisconnect                     USBDevDisconnect
+#define ROM_USBDevEndpointConfigGet              USBDevEndpointConfigGet
+#define ROM_USBDevEndpointConfigSet              USBDevEndpointConfigSet
+#define ROM_USBDevEndpointDataAck                USBDevEndpointDataAck
+#define ROM_USBDevEndpointStall                  USBDevEndpointStall
+#define ROM_USBDevEndpointStallClear             USBDevEndpointStallClear
+#define ROM_USBDevEndpointStatusClear            USBDevEndpointStatusClear
+#define ROM_USBDevLPMConfig                      USBDevLPMConfig
+#define ROM_USBDevLPMDisable                     USBDevLPMDisable
+#define ROM_USBDevLPMEnable                      USBDevLPMEnable
+#define ROM_USBDevLPMRemoteWake                  USBDevLPMRemoteWake
+#define ROM_USBDevMode                           USBDevMode
+#define ROM_USBDevSpeedGet                       USBDevSpeedGet
+#define ROM_USBEndpointDMAChannel                USBEndpointDMAChannel
+#define ROM_USBEndpointDMADisable                USBEndpointDMADisable
+#define ROM_USBEndpointDMAEnable                 USBEndpointDMAEnable
+#define ROM_USBEndpointDataAvail                 USBEndpointDataAvail
+#define ROM_USBEndpointDataGet                   USBEndpointDataGet
+#define ROM_USBEndpointDataPut                   USBEndpointDataPut
+#define ROM_USBEndpointDataSend                  USBEndpointDataSend
+#define ROM_USBEndpointDataToggleClear           USBEndpointDataToggleClear
+#define ROM_USBEndpointPacketCountSet            USBEndpointPacketCountSet
+#define ROM_USBEndpointStatus                    USBEndpointStatus
+#define ROM_USBFIFOAddrGet                       USBFIFOAddrGet
+#define ROM_USBFIFOConfigGet                     USBFIFOConfigGet
+#define ROM_USBFIFOConfigSet                     USBFIFOConfigSet
+#define ROM_USBFIFOFlush                         USBFIFOFlush
+#define ROM_USBFrameNumberGet                    USBFrameNumberGet
+#define ROM_USBHighSpeed                         USBHighSpeed
+#define ROM_USBHostAddrGet                       USBHostAddrGet
+#define ROM_USBHostAddrSet                       USBHostAddrSet
+#define ROM_USBHostEndpointConfig                USBHostEndpointConfig
+#define ROM_USBHostEndpointDataAck               USBHostEndpointDataAck
+#define ROM_USBHostEndpointDataToggle            USBHostEndpointDataToggle
+#define ROM_USBHostEndpointPing                  USBHostEndpointPing
+#define ROM_USBHostEndpointSpeed                 USBHostEndpointSpeed
+#define ROM_USBHostEndpointStatusClear           USBHostEndpointStatusClear
+#define ROM_USBHostHubAddrGet                    USBHostHubAddrGet
+#define ROM_USBHostHubAddrSet                    USBHostHubAddrSet
+#define ROM_USBHostLPMConfig                     USBHostLPMConfig
+#define ROM_USBHostLPMResume                     USBHostLPMResume
+#define ROM_USBHostLPMSend                       USBHostLPMSend
+#define ROM_USBHostMode                          USBHostMode
+#define ROM_USBHostPwrConfig                     USBHostPwrConfig
+#define ROM_USBHostPwrDisable                    USBHostPwrDisable
+#define ROM_USBHostPwrEnable                     USBHostPwrEnable
+#define ROM_USBHostPwrFaultDisable               USBHostPwrFaultDisable
+#define ROM_USBHostPwrFaultEnable                USBHostPwrFaultEnable
+#define ROM_USBHostRequestIN                     USBHostRequestIN
+#define ROM_USBHostRequestINClear                USBHostRequestINClear
+#define ROM_USBHostRequestStatus                 USBHostRequestStatus
+#define ROM_USBHostReset                         USBHostReset
+#define ROM_USBHostResume                        USBHostResume
+#define ROM_USBHostSpeedGet                      USBHostSpeedGet
+#define ROM_USBHostSuspend                       USBHostSuspend
+#define ROM_USBIntDisableControl                 USBIntDisableControl
+#define ROM_USBIntDisableEndpoint                USBIntDisableEndpoint
+#define ROM_USBIntEnableControl                  USBIntEnableControl
+#define ROM_USBIntEnableEndpoint                 USBIntEnableEndpoint
+#define ROM_USBIntStatusControl                  USBIntStatusControl
+#define ROM_USBIntStatusEndpoint                 USBIntStatusEndpoint
+#define ROM_USBLPMIntDisable                     USBLPMIntDisable
+#define ROM_USBLPMIntEnable                      USBLPMIntEnable
+#define ROM_USBLPMIntStatus                      USBLPMIntStatus
+#define ROM_USBLPMLinkStateGet                   USBLPMLinkStateGet
+#define ROM_USBModeConfig                        USBModeConfig
+#define ROM_USBModeGet                           USBModeGet
+#define ROM_USBNumEndpointsGet                   USBNumEndpointsGet
+#define ROM_USBOTGMode                           USBOTGMode
+#define ROM_USBOTGSessionRequest                 USBOTGSessionRequest
+#define ROM_USBPHYPowerOff                       USBPHYPowerOff
+#define ROM_USBPHYPowerOn                        USBPHYPowerOn
+#define ROM_USBULPIConfig                        USBULPIConfig
+#define ROM_USBULPIDisable                       USBULPIDisable
+#define ROM_USBULPIEnable                        USBULPIEnable
+#define ROM_USBULPIRegRead                       USBULPIRegRead
+#define ROM_USBULPIRegWrite                      USBULPIRegWrite
+#define ROM_UpdateI2C                            UpdateI2C
+#define ROM_UpdateSSI                            UpdateSSI
+#define ROM_UpdateUART                           UpdateUART
+#define ROM_UpdateUSB                            UpdateUSB
+#define ROM_WatchdogEnable                       WatchdogEnable
+#define ROM_WatchdogIntClear                     WatchdogIntClear
+#define ROM_WatchdogIntEnable                    WatchdogIntEnable
+#define ROM_WatchdogIntStatus                    WatchdogIntStatus
+#define ROM_WatchdogIntTypeSet                   WatchdogIntTypeSet
+#define ROM_WatchdogLock                         WatchdogLock
+#define ROM_WatchdogLockState                    WatchdogLockState
+#define ROM_WatchdogReloadGet                    WatchdogReloadGet
+#define ROM_WatchdogReloadSet                    WatchdogReloadSet
+#define ROM_WatchdogResetDisable                 WatchdogResetDisable
+#define ROM_WatchdogResetEnable                  WatchdogResetEnable
+#define ROM_WatchdogRunning                      WatchdogRunning
+#define ROM_WatchdogStallDisable                 WatchdogStallDisable
+#define ROM_WatchdogStallEnable                  WatchdogStallEnable
+#define ROM_WatchdogUnlock                       WatchdogUnlock
+#define ROM_WatchdogValueGet                     WatchdogValueGet
+#define ROM_pvAESTable                           pvAESTable
+#define ROM_uDMAChannelAssign                    uDMAChannelAssign
+#define ROM_uDMAChannelAttributeDisable          uDMAChannelAttributeDisable
+#define ROM_uDMAChannelAttributeEnable           uDMAChannelAttributeEnable
+#define ROM_uDMAChannelAttributeGet              uDMAChannelAttributeGet
+#define ROM_uDMAChannelControlSet                uDMAChannelControlSet
+#define ROM_uDMAChannelDisable                   uDMAChannelDisable
+#define ROM_uDMAChannelEnable                    uDMAChannelEnable
+#define ROM_uDMAChannelIsEnabled                 uDMAChannelIsEnabled
+#define ROM_uDMAChannelModeGet                   uDMAChannelModeGet
+#define ROM_uDMAChannelRequest                   uDMAChannelRequest
+#define ROM_uDMAChannelScatterGatherSet          uDMAChannelScatterGatherSet
+#define ROM_uDMAChannelSelectDefault             uDMAChannelSelectDefault
+#define ROM_uDMAChannelSelectSecondary           uDMAChannelSelectSecondary
+#define ROM_uDMAChannelSizeGet                   uDMAChannelSizeGet
+#define ROM_uDMAChannelTransferSet               uDMAChannelTransferSet
+#define ROM_uDMAControlAlternateBaseGet          uDMAControlAlternateBaseGet
+#define ROM_uDMAControlBaseGet                   uDMAControlBaseGet
+#define ROM_uDMAControlBaseSet                   uDMAControlBaseSet
+#define ROM_uDMADisable                          uDMADisable
+#define ROM_uDMAEnable                           uDMAEnable
+#define ROM_uDMAErrorStatusClear                 uDMAErrorStatusClear
+#define ROM_uDMAErrorStatusGet                   uDMAErrorStatusGet
+#define ROM_uDMAIntClear                         uDMAIntClear
+#define ROM_uDMAIntStatus                        uDMAIntStatus
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ ************************************************************************
+ *	host_sim.c
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The simulator thread stands in for the peripherals: every registered
+ *	step function advances one peripheral model (shift bytes out of a
+ *	FIFO, latch an interrupt, ...) and pending interrupts are then
+ *	dispatched to their handlers, see driverlib/interrupt.c.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+#include "host.h"
+
+#define HOST_SIM_MAX_STEPS      16
+#define HOST_SIM_IDLE_NS        50000
+#define HOST_SIM_YIELD_POLLS    16
+
+extern void HostIntService(void);
+
+static pthread_mutex_t g_sSimMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t g_sKickMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_sKickCond = PTHREAD_COND_INITIALIZER;
+static pthread_t g_sSimThread;
+static volatile bool g_bSimRunning;
+static bool g_bKicked;
+
+static bool (*g_pfnSteps[HOST_SIM_MAX_STEPS])(void);
+static unsigned int g_uiNumSteps;
+
+uint64_t
+HostNanos(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t
+HostThreadCPUNanos(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void
+HostSimLock(void)
+{
+    pthread_mutex_lock(&g_sSimMutex);
+}
+
+void
+HostSimUnlock(void)
+{
+    pthread_mutex_unlock(&g_sSimMutex);
+}
+
+static void *
+HostSimThread(void *pvArg)
+{
+    unsigned int i;
+    bool bBusy;
+    struct timespec ts;
+
+    (void)pvArg;
+
+    while(g_bSimRunning)
+    {
+        bBusy = false;
+        for(i = 0; i < g_uiNumSteps; i++)
+        {
+            bBusy |= g_pfnSteps[i]();
+        }
+
+        HostIntService();
+
+        if(bBusy)
+        {
+            sched_yield();
+            continue;
+        }
+
+        //
+        // Nothing moved; sleep until kicked or until a paced peripheral
+        // may have something due.
+        //
+        pthread_mutex_lock(&g_sKickMutex);
+        if(!g_bKicked)
+        {
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += HOST_SIM_IDLE_NS;
+            if(ts.tv_nsec >= 1000000000L)
+            {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&g_sKickCond, &g_sKickMutex, &ts);
+        }
+        g_bKicked = false;
+        pthread_mutex_unlock(&g_sKickMutex);
+    }
+
+    return 0;
+}
+
+void
+HostSimRegister(bool (*step)(void))
+{
+    unsigned int i;
+
+    HostSimLock();
+    for(i = 0; i < g_uiNumSteps; i++)
+    {
+        if(g_pfnSteps[i] == step)
+        {
+            break;
+        }
+    }
+    if((i == g_uiNumSteps) && (g_uiNumSteps < HOST_SIM_MAX_STEPS))
+    {
+        g_pfnSteps[g_uiNumSteps++] = step;
+    }
+    HostSimUnlock();
+
+    HostSimStart();
+}
+
+void
+HostSimStart(void)
+{
+    if(g_bSimRunning)
+    {
+        return;
+    }
+
+    g_bSimRunning = true;
+    pthread_create(&g_sSimThread, 0, HostSimThread, 0);
+    atexit(HostSimStop);
+}
+
+void
+HostSimStop(void)
+{
+    if(!g_bSimRunning)
+    {
+        return;
+    }
+
+    g_bSimRunning = false;
+    HostSimKick();
+    pthread_join(g_sSimThread, 0);
+}
+
+void
+HostSimKick(void)
+{
+    pthread_mutex_lock(&g_sKickMutex);
+    g_bKicked = true;
+    pthread_cond_signal(&g_sKickCond);
+    pthread_mutex_unlock(&g_sKickMutex);
+}
+
+void
+HostSimYield(void)
+{
+    static __thread unsigned int uiPolls;
+
+    //
+    // A status read that comes back "not ready" once is usually just
+    // checked and acted upon; only a loop that keeps polling has to give
+    // the simulator the CPU.
+    //
+    if(HostIntInHandler() || (++uiPolls % HOST_SIM_YIELD_POLLS))
+    {
+        return;
+    }
+    HostSimKick();
+    sched_yield();
+}
@@ -0,0 +1,112 @@
+/*
+ ************************************************************************
+ *	wiring.c
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Replaces hardware/lm4f/cores/lm4f/wiring.c: time comes from the host
+ *	monotonic clock instead of SysTick, and the low power modes just wait.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <time.h>
+#include "Energia.h"
+
+static void (*SysTickCbFuncs[8])(uint32_t ui32TimeMS);
+static uint64_t startNanos;
+
+volatile boolean stay_asleep = false;
+
+__attribute__((constructor))
+static void timerStart(void)
+{
+	startNanos = HostNanos();
+}
+
+void timerInit()
+{
+}
+
+unsigned long micros(void)
+{
+	return (HostNanos() - startNanos) / 1000;
+}
+
+unsigned long millis(void)
+{
+	return (HostNanos() - startNanos) / 1000000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	uint64_t end = HostNanos() + (uint64_t)us * 1000;
+
+	while (HostNanos() < end)
+		;
+}
+
+void delay(uint32_t ms)
+{
+	struct timespec ts;
+
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (ms % 1000) * 1000000L;
+	nanosleep(&ts, 0);
+}
+
+void sleep(uint32_t ms)
+{
+	uint64_t end = HostNanos() + (uint64_t)ms * 1000000;
+
+	stay_asleep = true;
+	while (stay_asleep && HostNanos() < end)
+		delay(1);
+	stay_asleep = false;
+}
+
+void sleepSeconds(uint32_t seconds)
+{
+	sleep(seconds * 1000);
+}
+
+void suspend(void)
+{
+	stay_asleep = true;
+	while (stay_asleep)
+		delay(1);
+}
+
+void registerSysTickCb(void (*userFunc)(uint32_t))
+{
+	uint8_t i;
+	for (i=0; i<8; i++) {
+		if(!SysTickCbFuncs[i]) {
+			SysTickCbFuncs[i] = userFunc;
+			break;
+		}
+	}
+}
+
+void SysTickIntHandler(void)
+{
+	uint8_t i;
+	for (i=0; i<8; i++) {
+		if (SysTickCbFuncs[i])
+			SysTickCbFuncs[i](1);
+	}
+}
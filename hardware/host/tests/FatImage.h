@@ -0,0 +1,138 @@
+/*
+ ************************************************************************
+ *	FatImage.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Formats a disk image in a file for the SD library: a super floppy,
+ *	the boot sector in block 0 with no partition table, and two FATs.
+ *	FAT16 with a 512 entry root directory when the clusters come to fewer
+ *	than 65525, FAT32 with the root directory in cluster 2 otherwise.
+ *	Only the blocks holding something are written, so a big image stays
+ *	a sparse file.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef FatImage_h
+#define FatImage_h
+
+#include <string.h>
+// Energia.h has a sleep() of its own
+#define sleep posixSleep
+#include <unistd.h>
+#undef sleep
+#include "FatStructs.h"
+
+// Formats the blocks 512 byte blocks of the image open as fd, with
+// clusters of blocksPerCluster blocks. Returns the FAT type, 16 or 32,
+// or 0 if the image is too small or could not be written.
+static int fatFormat(int fd, uint32_t blocks, uint8_t blocksPerCluster)
+{
+	uint8_t block[512];
+	fbs_t *boot = (fbs_t *)block;
+	bpb_t *bpb = &boot->bpb;
+	uint32_t clusters, fatBlocks, dataBlocks;
+	uint16_t reserved, rootBlocks;
+	int type = 16;
+
+	// FAT16 first, FAT32 if that comes to too many clusters
+	for (;;) {
+		reserved = type == 16 ? 1 : 32;
+		rootBlocks = type == 16 ? 32 : 0;
+		dataBlocks = blocks - reserved - rootBlocks;
+		fatBlocks = 0;
+		// the FATs take some of the blocks the clusters would have had
+		for (int i = 0; i < 4; i++) {
+			clusters = (dataBlocks - 2 * fatBlocks) / blocksPerCluster;
+			fatBlocks = ((clusters + 2) * (type / 8) + 511) / 512;
+		}
+		clusters = (dataBlocks - 2 * fatBlocks) / blocksPerCluster;
+		if (type == 32 || clusters < 65525)
+			break;
+		type = 32;
+	}
+	if (blocks < 1024 || clusters < 4085)
+		return 0;
+
+	memset(block, 0, sizeof(block));
+	boot->jmpToBootCode[0] = 0xEB;
+	boot->jmpToBootCode[1] = 0x3C;
+	boot->jmpToBootCode[2] = 0x90;
+	memcpy(boot->oemName, "ENERGIA ", 8);
+	bpb->bytesPerSector = 512;
+	bpb->sectorsPerCluster = blocksPerCluster;
+	bpb->reservedSectorCount = reserved;
+	bpb->fatCount = 2;
+	bpb->rootDirEntryCount = rootBlocks * 16;
+	bpb->mediaType = 0xF8;
+	bpb->sectorsPerTrtack = 63;
+	bpb->headCount = 255;
+	if (blocks < 65536)
+		bpb->totalSectors16 = blocks;
+	else
+		bpb->totalSectors32 = blocks;
+	if (type == 16) {
+		bpb->sectorsPerFat16 = fatBlocks;
+	} else {
+		bpb->sectorsPerFat32 = fatBlocks;
+		bpb->fat32RootCluster = 2;
+		bpb->fat32FSInfo = 1;
+		bpb->fat32BackBootBlock = 6;
+	}
+	boot->driveNumber = 0x80;
+	boot->bootSignature = 0x29;
+	boot->volumeSerialNumber = 0x12345678;
+	memcpy(boot->volumeLabel, "NO NAME    ", 11);
+	memcpy(boot->fileSystemType, type == 16 ? "FAT16   " : "FAT32   ", 8);
+	boot->bootSectorSig0 = BOOTSIG0;
+	boot->bootSectorSig1 = BOOTSIG1;
+	if (pwrite(fd, block, 512, 0) != 512)
+		return 0;
+
+	// clear the FATs and the root directory, then start the FATs
+	uint32_t clear = type == 16 ? rootBlocks : blocksPerCluster;
+	uint32_t rootStart = reserved + 2 * fatBlocks;
+
+	memset(block, 0, sizeof(block));
+	for (uint32_t n = reserved; n < rootStart + clear; n++) {
+		if (pwrite(fd, block, 512, (off_t)n * 512) != 512)
+			return 0;
+	}
+	if (type == 16) {
+		uint16_t *fat = (uint16_t *)block;
+
+		fat[0] = 0xFFF8;
+		fat[1] = 0xFFFF;
+	} else {
+		uint32_t *fat = (uint32_t *)block;
+
+		fat[0] = 0x0FFFFFF8;
+		fat[1] = 0x0FFFFFFF;
+		// the root directory
+		fat[2] = 0x0FFFFFFF;
+	}
+	for (int i = 0; i < 2; i++) {
+		off_t at = (off_t)(reserved + i * fatBlocks) * 512;
+
+		if (pwrite(fd, block, 512, at) != 512)
+			return 0;
+	}
+	return type;
+}
+
+#endif
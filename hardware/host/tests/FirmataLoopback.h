@@ -0,0 +1,179 @@
+/*
+ ************************************************************************
+ *	FirmataLoopback.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A Stream for Firmata with a host program behind it. A recorded
+ *	stream of messages given to replay() comes in segment bytes at a
+ *	time, the way a UART's receive buffer fills between two loop()s:
+ *	available() only reports the next segment once the last has been
+ *	read. reads counts the calls to read(), writes the calls to write()
+ *	of either kind and written the bytes; sent keeps the first bytes
+ *	written since clear().
+ *
+ *	firmataSession() makes the recording: what a host program sends
+ *	StandardFirmata, the version and capability queries, pin modes and
+ *	report enables when it starts, then rounds of digital and analog
+ *	writes, extended analog writes, pin state queries and now and then
+ *	a string or a new sampling interval.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef FirmataLoopback_h
+#define FirmataLoopback_h
+
+#include <string.h>
+#include "Firmata.h"
+
+class FirmataLoopback : public Stream
+{
+	public:
+		size_t segment;
+		unsigned long reads, writes, written;
+		uint8_t sent[256];
+		size_t sentLen;
+
+		FirmataLoopback() : segment(64), reads(0), writes(0), written(0),
+				sentLen(0), stream(0), streamLen(0), streamPos(0), arrived(0) {}
+
+		void replay(const uint8_t *messages, size_t len)
+		{
+			stream = messages;
+			streamLen = len;
+			streamPos = 0;
+			arrived = 0;
+		}
+
+		// Whether all of the stream has been read
+		bool done() { return streamPos == streamLen; }
+
+		void clear()
+		{
+			reads = writes = written = 0;
+			sentLen = 0;
+		}
+
+		virtual int available()
+		{
+			if (arrived == 0) {
+				arrived = streamLen - streamPos;
+				if (arrived > segment)
+					arrived = segment;
+			}
+			return arrived;
+		}
+		virtual int peek() { return available() ? stream[streamPos] : -1; }
+		virtual int read()
+		{
+			reads++;
+			if (available() == 0)
+				return -1;
+			arrived--;
+			return stream[streamPos++];
+		}
+		virtual void flush() {}
+		virtual size_t write(uint8_t c) { return write(&c, 1); }
+		virtual size_t write(const uint8_t *buf, size_t size)
+		{
+			size_t room = sizeof(sent) - sentLen;
+
+			writes++;
+			written += size;
+			memcpy(sent + sentLen, buf, size < room ? size : room);
+			sentLen += size < room ? size : room;
+			return size;
+		}
+
+	private:
+		const uint8_t *stream;
+		size_t streamLen, streamPos, arrived;
+};
+
+// The 14 bit value as two 7 bit bytes
+static inline uint8_t *firmataValue(uint8_t *p, int value)
+{
+	*p++ = value & 0x7F;
+	*p++ = value >> 7 & 0x7F;
+	return p;
+}
+
+// A host program's messages to StandardFirmata: the start, then rounds of
+// what it sends while it runs; returns the length, no more than size
+static size_t firmataSession(uint8_t *buf, size_t size, int rounds)
+{
+	uint8_t msg[128];
+	size_t len = 0;
+
+	for (int round = -1; round < rounds; round++) {
+		uint8_t *p = msg;
+
+		if (round < 0) {
+			*p++ = REPORT_VERSION;
+			*p++ = START_SYSEX; *p++ = REPORT_FIRMWARE; *p++ = END_SYSEX;
+			*p++ = START_SYSEX; *p++ = CAPABILITY_QUERY; *p++ = END_SYSEX;
+			*p++ = START_SYSEX; *p++ = ANALOG_MAPPING_QUERY; *p++ = END_SYSEX;
+			// 2-7 digital out, 8-9 PWM, 10-13 in; A0-A3 reported, both ports
+			for (int pin = 2; pin < 14; pin++) {
+				*p++ = SET_PIN_MODE;
+				*p++ = pin;
+				*p++ = pin < 8 ? OUTPUT : pin < 10 ? PWM : INPUT;
+			}
+			for (int pin = 0; pin < 4; pin++) {
+				*p++ = REPORT_ANALOG | pin;
+				*p++ = 1;
+			}
+			*p++ = REPORT_DIGITAL | 0; *p++ = 1;
+			*p++ = REPORT_DIGITAL | 1; *p++ = 1;
+			*p++ = START_SYSEX; *p++ = SAMPLING_INTERVAL;
+			p = firmataValue(p, 19);
+			*p++ = END_SYSEX;
+		} else {
+			*p++ = DIGITAL_MESSAGE | 0;
+			p = firmataValue(p, (round * 4) & 0xFC);
+			*p++ = ANALOG_MESSAGE | 8;
+			p = firmataValue(p, round * 7 & 0xFF);
+			*p++ = ANALOG_MESSAGE | 9;
+			p = firmataValue(p, 255 - (round * 7 & 0xFF));
+			// a servo angle past pin 15
+			*p++ = START_SYSEX; *p++ = EXTENDED_ANALOG; *p++ = 20;
+			p = firmataValue(p, round % 180);
+			*p++ = END_SYSEX;
+			*p++ = START_SYSEX; *p++ = PIN_STATE_QUERY; *p++ = 2 + round % 12;
+			*p++ = END_SYSEX;
+			if (round % 16 == 0) {
+				*p++ = START_SYSEX; *p++ = STRING_DATA;
+				for (const char *s = "status?"; *s; s++)
+					p = firmataValue(p, *s);
+				*p++ = END_SYSEX;
+			}
+			if (round % 64 == 63) {
+				*p++ = START_SYSEX; *p++ = SAMPLING_INTERVAL;
+				p = firmataValue(p, 10 + round % 50);
+				*p++ = END_SYSEX;
+			}
+		}
+		if (len + (p - msg) > size)
+			break;
+		memcpy(buf + len, msg, p - msg);
+		len += p - msg;
+	}
+	return len;
+}
+
+#endif
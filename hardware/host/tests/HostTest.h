@@ -0,0 +1,50 @@
+/*
+ ************************************************************************
+ *	HostTest.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Minimal checks for the host tests. CHECK() reports a failed condition
+ *	and carries on; main() returns testResult() so that "make test" stops
+ *	at the first test executable with a failure.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <stdio.h>
+
+static unsigned int testChecks, testFailures;
+
+#define CHECK(cond) do { \
+		testChecks++; \
+		if (!(cond)) { \
+			testFailures++; \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", \
+					__FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+static inline int testResult(void)
+{
+	printf("%u checks, %u failed\n", testChecks, testFailures);
+	return testFailures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ ************************************************************************
+ *	LwipLink.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The lwiplib.c API the lwIP Ethernet library is built on, for the
+ *	host: lwIPInit() brings up lwIP on an in-process link in place of the
+ *	EMAC, a pair of netifs, one with the board's address and one with the
+ *	peer's, the gateway's unless given. A peer written against the raw
+ *	lwIP API in the same program, on the peer's address, stands in for
+ *	the far end; LwipPeer is one.
+ *
+ *	lwIP being a single stack, it may send out of either netif; the link
+ *	hands each packet to the netif of its destination, and counts it as
+ *	sent by the board unless it is for the board's address. A packet is
+ *	copied into pbufs from PBUF_POOL, as the EMAC driver receives into
+ *	them, queued and handed to ip_input() by the Ethernet interrupt
+ *	handler; a packet that finds the pool or the queue empty is dropped,
+ *	as a frame would be with no receive descriptor free. The
+ *	handler also runs the lwIP timers, which lwIPTimer() moves forward as
+ *	it does on the board; on the host they are moved from the simulator
+ *	thread, a tick a millisecond. Everything lwIP does therefore runs on
+ *	the simulator thread as the handler, and code that calls into it
+ *	from the sketch side has to mask interrupts, as on the board.
+ *
+ *	frames and bytes count the packets the link carried, txFrames and
+ *	txBytes those the board sent, drops those it lost, and queueMax the
+ *	most it ever held. clear() also restarts the high-water marks of
+ *	lwIP's pools and heap, in lwip_stats.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef LwipLink_h
+#define LwipLink_h
+
+#include <string.h>
+#include "Energia.h"
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "Ethernet.h"
+#include "lwip/init.h"
+#include "lwip/dns.h"
+#include "lwip/stats.h"
+
+#define LWIP_LINK_QUEUE 64
+
+extern "C" uint32_t g_ui32LocalTimer;
+uint32_t g_ui32LocalTimer;
+
+class LwipLink
+{
+	public:
+		static LwipLink *active;
+		unsigned long frames, bytes, txFrames, txBytes, drops;
+		unsigned int queueMax;
+		struct netif netif, peer;
+
+		LwipLink(IPAddress peerIP = IPAddress(0, 0, 0, 0)) : peerIP(peerIP), up(false),
+				head(0), count(0), last(0), tcpTimer(0), dnsTimer(0)
+		{
+			memset(&netif, 0, sizeof(netif));
+			memset(&peer, 0, sizeof(peer));
+			clear();
+			active = this;
+		}
+
+		void clear()
+		{
+			frames = bytes = txFrames = txBytes = drops = 0;
+			queueMax = count;
+			for (int i = 0; i < MEMP_MAX; i++)
+				lwip_stats.memp[i].max = lwip_stats.memp[i].used;
+			lwip_stats.mem.max = lwip_stats.mem.used;
+		}
+
+		// lwIPInit() of a static address
+		void begin(uint32_t ip, uint32_t netmask, uint32_t gw)
+		{
+			ip_addr_t addr, mask, gateway, far;
+
+			addr.addr = htonl(ip);
+			mask.addr = htonl(netmask);
+			gateway.addr = htonl(gw);
+			far.addr = (uint32_t)peerIP ? (uint32_t)peerIP : gateway.addr;
+			if (up) {
+				netif_set_addr(&netif, &addr, &mask, &gateway);
+				netif_set_addr(&peer, &far, &mask, &addr);
+				return;
+			}
+			lwip_init();
+			// the board's netif last, to be first in netif_list
+			netif_add(&peer, &far, &mask, &addr, this, init, ip_input);
+			netif_add(&netif, &addr, &mask, &gateway, this, init, ip_input);
+			netif_set_default(&netif);
+			netif_set_up(&peer);
+			netif_set_up(&netif);
+			up = true;
+			last = millis();
+			IntRegister(INT_EMAC0, lwIPEthernetIntHandler);
+			IntEnable(INT_EMAC0);
+			HostSimRegister(step);
+		}
+
+		// The Ethernet interrupt: what the link carried, then the timers
+		void service()
+		{
+			// only what is queued now; what that sends waits for the next
+			for (unsigned int n = count; n; n--) {
+				struct pbuf *p = queue[head];
+				struct netif *to = queueTo[head];
+
+				head = (head + 1) % LWIP_LINK_QUEUE;
+				count--;
+				if (to->input(p, to) != ERR_OK)
+					pbuf_free(p);
+			}
+			if (count)
+				HostIntTrigger(INT_EMAC0);
+
+			if (g_ui32LocalTimer - tcpTimer >= TCP_TMR_INTERVAL) {
+				tcpTimer = g_ui32LocalTimer;
+				tcp_tmr();
+			}
+			if (g_ui32LocalTimer - dnsTimer >= DNS_TMR_INTERVAL) {
+				dnsTimer = g_ui32LocalTimer;
+				dns_tmr();
+			}
+		}
+
+	private:
+		IPAddress peerIP;
+		bool up;
+		struct pbuf *queue[LWIP_LINK_QUEUE];
+		struct netif *queueTo[LWIP_LINK_QUEUE];
+		unsigned int head, count;
+		unsigned long last;
+		uint32_t tcpTimer, dnsTimer;
+
+		static err_t init(struct netif *netif)
+		{
+			LwipLink *link = (LwipLink *)netif->state;
+
+			netif->name[0] = netif == &link->peer ? 'p' : 'e';
+			netif->name[1] = netif == &link->peer ? 'e' : 'n';
+			netif->output = output;
+			netif->mtu = 1500;
+			netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_LINK_UP;
+			return ERR_OK;
+		}
+
+		static err_t output(struct netif *netif, struct pbuf *p, ip_addr_t *dest)
+		{
+			LwipLink *link = (LwipLink *)netif->state;
+			bool toBoard = ip_addr_cmp(dest, &link->netif.ip_addr);
+			unsigned int tail = (link->head + link->count) % LWIP_LINK_QUEUE;
+			struct pbuf *q;
+
+			if (link->count == LWIP_LINK_QUEUE ||
+					!(q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_POOL))) {
+				link->drops++;
+				return ERR_OK;
+			}
+			pbuf_copy(q, p);
+			link->queue[tail] = q;
+			link->queueTo[tail] = toBoard ? &link->netif : &link->peer;
+			if (++link->count > link->queueMax)
+				link->queueMax = link->count;
+			link->frames++;
+			link->bytes += p->tot_len;
+			if (!toBoard) {
+				link->txFrames++;
+				link->txBytes += p->tot_len;
+			}
+			HostIntTrigger(INT_EMAC0);
+			return ERR_OK;
+		}
+
+		// SysTick, as far as lwIP is concerned
+		static bool step(void)
+		{
+			LwipLink *link = active;
+			unsigned long now = millis();
+
+			if (link && now != link->last) {
+				lwIPTimer(now - link->last);
+				link->last = now;
+			}
+			return false;
+		}
+};
+
+LwipLink *LwipLink::active;
+
+//
+// lwiplib.c
+//
+extern "C" {
+
+void lwIPInit(uint32_t ui32SysClkHz, const uint8_t *pui8MAC, uint32_t ui32IPAddr,
+		uint32_t ui32NetMask, uint32_t ui32GWAddr, uint32_t ui32IPMode)
+{
+	if (LwipLink::active)
+		LwipLink::active->begin(ui32IPAddr, ui32NetMask, ui32GWAddr);
+}
+
+void lwIPTimer(uint32_t ui32TimeMS)
+{
+	g_ui32LocalTimer += ui32TimeMS;
+	HostIntTrigger(INT_EMAC0);
+}
+
+void lwIPEthernetIntHandler(void)
+{
+	if (LwipLink::active)
+		LwipLink::active->service();
+}
+
+uint32_t lwIPLocalIPAddrGet(void)
+{
+	return LwipLink::active->netif.ip_addr.addr;
+}
+
+uint32_t lwIPLocalNetMaskGet(void)
+{
+	return LwipLink::active->netif.netmask.addr;
+}
+
+uint32_t lwIPLocalGWAddrGet(void)
+{
+	return LwipLink::active->netif.gw.addr;
+}
+
+void lwIPDNSAddrSet(uint32_t dns_server)
+{
+	dns_setserver(0, (ip_addr_t *)&dns_server);
+}
+
+uint32_t lwIPDNSAddrGet(void)
+{
+	ip_addr_t addr = dns_getserver(0);
+
+	return addr.addr;
+}
+
+// The link has no DHCP server
+bool lwIPDHCPWaitLeaseValid(void)
+{
+	return false;
+}
+
+}
+
+#endif
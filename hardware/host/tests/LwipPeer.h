@@ -0,0 +1,266 @@
+/*
+ ************************************************************************
+ *	LwipPeer.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The far end of a connection, for the lwIP Ethernet library on an
+ *	LwipLink: a server on the raw lwIP API, listening on port of the
+ *	link's peer address, or a client of the board with connect(). Each
+ *	connection is sent response, from where it is without a copy, as fast
+ *	as the window lets it through: with serve(), once, as it opens, and
+ *	then closed once the last byte is acknowledged if asked to; with
+ *	answer(), again for every so many bytes that come in, as to a
+ *	request. What the connection brings in is kept in sink, as much as it
+ *	holds, and counted in receivedLen. echo() sends the datagrams that
+ *	come to a UDP port back where they came from.
+ *
+ *	All of it runs in the Ethernet interrupt handler, as the stack's own
+ *	callbacks; what is called from the sketch side masks interrupts.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef LwipPeer_h
+#define LwipPeer_h
+
+#include "LwipLink.h"
+#include "lwip/udp.h"
+
+class LwipPeer
+{
+	public:
+		const uint8_t *response;
+		size_t responseLen;
+		uint8_t *sink;
+		size_t sinkSize;
+		volatile size_t receivedLen;
+		volatile unsigned long accepted, responses, datagrams;
+		volatile bool connected;
+
+		LwipPeer(uint16_t port) : response(0), responseLen(0), sink(0),
+				sinkSize(0), receivedLen(0), accepted(0), responses(0),
+				datagrams(0), connected(false), port(port), pcb(0), sent(0),
+				pending(0), every(0), partial(0), closing(true)
+		{
+		}
+
+		void begin()
+		{
+			bool masked = IntMasterDisable();
+			struct tcp_pcb *listener = tcp_new();
+
+			tcp_bind(listener, &LwipLink::active->peer.ip_addr, port);
+			listener = tcp_listen(listener);
+			tcp_arg(listener, this);
+			tcp_accept(listener, accept);
+			if (!masked)
+				IntMasterEnable();
+		}
+
+		// Open a connection to the board's port; connected says when it is
+		bool connect(uint16_t boardPort)
+		{
+			bool masked = IntMasterDisable();
+			struct tcp_pcb *client = tcp_new();
+			err_t err = ERR_MEM;
+
+			if (client) {
+				tcp_bind(client, &LwipLink::active->peer.ip_addr, 0);
+				tcp_arg(client, this);
+				err = tcp_connect(client, &LwipLink::active->netif.ip_addr,
+						boardPort, accept);
+			}
+			if (!masked)
+				IntMasterEnable();
+			return err == ERR_OK;
+		}
+
+		// Close the connection from this end
+		void close()
+		{
+			bool masked = IntMasterDisable();
+
+			if (pcb)
+				shut(pcb);
+			if (!masked)
+				IntMasterEnable();
+		}
+
+		// Send len bytes of data to each connection, closing it after when close
+		void serve(const uint8_t *data, size_t len, bool close = true)
+		{
+			response = data;
+			responseLen = len;
+			every = 0;
+			closing = close;
+		}
+
+		// Send len bytes of data for every n bytes received, as a reply
+		void answer(const uint8_t *data, size_t len, size_t n)
+		{
+			response = data;
+			responseLen = len;
+			every = n;
+		}
+
+		// Keep what comes in, up to size bytes of it, in buf
+		void keep(uint8_t *buf, size_t size)
+		{
+			sink = buf;
+			sinkSize = size;
+			receivedLen = 0;
+		}
+
+		// Send the datagrams that come to udpPort back
+		void echo(uint16_t udpPort)
+		{
+			bool masked = IntMasterDisable();
+			struct udp_pcb *udp = udp_new();
+
+			udp_bind(udp, &LwipLink::active->peer.ip_addr, udpPort);
+			udp_recv(udp, echoRecv, this);
+			if (!masked)
+				IntMasterEnable();
+		}
+
+	private:
+		uint16_t port;
+		struct tcp_pcb *pcb;
+		size_t sent, pending, every, partial;
+		bool closing;
+
+		// Accepted, or connected to the board
+		static err_t accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+		{
+			LwipPeer *peer = (LwipPeer *)arg;
+
+			peer->pcb = newpcb;
+			peer->sent = 0;
+			peer->pending = peer->every ? 0 : 1;
+			peer->partial = 0;
+			peer->receivedLen = 0;
+			peer->accepted++;
+			peer->connected = true;
+			tcp_arg(newpcb, peer);
+			tcp_recv(newpcb, recv);
+			tcp_sent(newpcb, sentCb);
+			tcp_err(newpcb, errCb);
+			peer->push();
+			return ERR_OK;
+		}
+
+		static err_t recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+		{
+			LwipPeer *peer = (LwipPeer *)arg;
+
+			if (!p) {
+				peer->shut(tpcb);
+				return ERR_OK;
+			}
+			if (peer->receivedLen < peer->sinkSize)
+				pbuf_copy_partial(p, peer->sink + peer->receivedLen,
+						peer->sinkSize - peer->receivedLen, 0);
+			peer->receivedLen += p->tot_len;
+			if (peer->pcb == tpcb && peer->every) {
+				peer->partial += p->tot_len;
+				peer->pending += peer->partial / peer->every;
+				peer->partial %= peer->every;
+			}
+			tcp_recved(tpcb, p->tot_len);
+			pbuf_free(p);
+			// no delayed acknowledgements, as a desktop's stack would
+			tcp_ack_now(tpcb);
+			if (peer->pcb == tpcb)
+				peer->push();
+			else
+				tcp_output(tpcb);
+			return ERR_OK;
+		}
+
+		static err_t sentCb(void *arg, struct tcp_pcb *tpcb, u16_t len)
+		{
+			LwipPeer *peer = (LwipPeer *)arg;
+
+			if (peer->pcb == tpcb)
+				peer->push();
+			return ERR_OK;
+		}
+
+		// The stack has freed the pcb
+		static void errCb(void *arg, err_t err)
+		{
+			LwipPeer *peer = (LwipPeer *)arg;
+
+			peer->pcb = 0;
+			peer->connected = false;
+		}
+
+		static void echoRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
+				ip_addr_t *addr, u16_t port)
+		{
+			LwipPeer *peer = (LwipPeer *)arg;
+
+			peer->datagrams++;
+			// out of the peer's netif, as the route to the board is the board's
+			udp_sendto_if(upcb, p, addr, port, &LwipLink::active->peer);
+			pbuf_free(p);
+		}
+
+		void shut(struct tcp_pcb *tpcb)
+		{
+			if (pcb == tpcb) {
+				pcb = 0;
+				connected = false;
+			}
+			tcp_arg(tpcb, 0);
+			tcp_recv(tpcb, 0);
+			tcp_sent(tpcb, 0);
+			tcp_err(tpcb, 0);
+			tcp_close(tpcb);
+		}
+
+		// As much of the responses due as the send buffer takes
+		void push()
+		{
+			while (pending && responseLen && tcp_sndbuf(pcb)) {
+				size_t n = responseLen - sent;
+
+				if (n > tcp_sndbuf(pcb))
+					n = tcp_sndbuf(pcb);
+				if (tcp_write(pcb, response + sent, n,
+						sent + n < responseLen || pending > 1 ?
+						TCP_WRITE_FLAG_MORE : 0) != ERR_OK)
+					break;
+				sent += n;
+				if (sent == responseLen) {
+					sent = 0;
+					pending--;
+					responses++;
+				}
+			}
+			tcp_output(pcb);
+			// a FIN sent into a closed window would wait for a retransmission;
+			// once the far end has closed, recv() closes instead, as a close
+			// here would free the pcb under tcp_input()
+			if (closing && !every && responseLen && !pending && !pcb->unsent &&
+					!pcb->unacked && pcb->state == ESTABLISHED)
+				shut(pcb);
+		}
+};
+
+#endif
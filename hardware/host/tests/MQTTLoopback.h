@@ -0,0 +1,136 @@
+/*
+ ************************************************************************
+ *	MQTTLoopback.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A Network and a Timer for MQTT::Client with a broker stand-in behind
+ *	them. CONNECT, SUBSCRIBE, UNSUBSCRIBE and PINGREQ are answered at
+ *	once; besides the answers, read() hands out a recorded stream of
+ *	packets given to replay(), in place. A Timer expires once a read has
+ *	found nothing left, so yield() returns when the stream is used up,
+ *	and every new Timer starts afresh. Connect with keepAliveInterval 0,
+ *	or every expiry sends a ping.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef MQTTLoopback_h
+#define MQTTLoopback_h
+
+#include <string.h>
+#include "MQTTClient.h"
+
+class MQTTLoopback
+{
+	public:
+		static MQTTLoopback *active;
+		unsigned long written;
+		bool starved;
+
+		MQTTLoopback() : written(0), starved(false), stream(0), streamLen(0),
+				streamPos(0), answerLen(0), answerPos(0)
+		{
+			active = this;
+		}
+
+		void replay(const unsigned char *packets, size_t len)
+		{
+			stream = packets;
+			streamLen = len;
+			streamPos = 0;
+		}
+
+		int read(unsigned char *buffer, int len, int timeout)
+		{
+			int n = 0;
+
+			while (n < len && answerPos < answerLen)
+				buffer[n++] = answer[answerPos++];
+			if (n < len && streamPos < streamLen) {
+				size_t more = len - n;
+
+				if (more > streamLen - streamPos)
+					more = streamLen - streamPos;
+				memcpy(buffer + n, stream + streamPos, more);
+				streamPos += more;
+				n += more;
+			}
+			starved = n < len;
+			return n;
+		}
+
+		int write(unsigned char *buffer, int len, int timeout)
+		{
+			unsigned char *p = buffer + 1;
+
+			written++;
+			// the packet id follows a remaining length of one byte
+			switch (buffer[0] >> 4) {
+			case CONNECT:
+				answerWith(CONNACK << 4, 0, 0);
+				break;
+			case SUBSCRIBE:
+				answerWith(SUBACK << 4, p[1], p[2], true);
+				break;
+			case UNSUBSCRIBE:
+				answerWith(UNSUBACK << 4, p[1], p[2]);
+				break;
+			case PINGREQ:
+				answerWith(PINGRESP << 4, -1, -1);
+				break;
+			}
+			return len;
+		}
+
+	private:
+		const unsigned char *stream;
+		size_t streamLen, streamPos;
+		unsigned char answer[16];
+		int answerLen, answerPos;
+
+		// QoS 0 granted for a subscription
+		void answerWith(unsigned char header, int a, int b, bool qos = false)
+		{
+			if (answerPos == answerLen)
+				answerLen = answerPos = 0;
+			answer[answerLen++] = header;
+			answer[answerLen++] = a < 0 ? 0 : qos ? 3 : 2;
+			if (a >= 0) {
+				answer[answerLen++] = a;
+				answer[answerLen++] = b;
+			}
+			if (qos)
+				answer[answerLen++] = 0;
+		}
+};
+
+MQTTLoopback *MQTTLoopback::active;
+
+class MQTTLoopbackTimer
+{
+	public:
+		MQTTLoopbackTimer() { MQTTLoopback::active->starved = false; }
+		MQTTLoopbackTimer(int ms) { MQTTLoopback::active->starved = false; }
+
+		bool expired() { return MQTTLoopback::active->starved; }
+		void countdown_ms(unsigned long ms) {}
+		void countdown(int seconds) {}
+		int left_ms() { return 1000; }
+};
+
+#endif
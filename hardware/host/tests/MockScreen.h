@@ -0,0 +1,136 @@
+/*
+ ************************************************************************
+ *	MockScreen.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A screen of the LCD_screen libraries with no bus: the pixels the
+ *	library draws land in a frame buffer, for a test to compare with the
+ *	ones it should have drawn. A window fills row by row from its top
+ *	left, as the controllers do.
+ *
+ *	points, fills, windows and buffers count the calls to _setPoint,
+ *	_fastFill, _setWindow and _writeDataBuffer, data the pixels written
+ *	with _writeData88 and buffered those of them that came in a buffer;
+ *	errors counts pixels off the screen or past the end of a window.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef MockScreen_h
+#define MockScreen_h
+
+#include "LCD_screen_font.h"
+
+#define MOCK_WIDTH 160
+#define MOCK_HEIGHT 128
+
+class MockScreen : public LCD_screen_font
+{
+	public:
+		uint16_t pixels[MOCK_HEIGHT][MOCK_WIDTH];
+		unsigned long points, fills, windows, buffers, data, buffered, errors;
+
+		MockScreen()
+		{
+			clearCounts();
+		}
+
+		void begin()
+		{
+			_screenWidth = MOCK_WIDTH;
+			_screenHeigth = MOCK_HEIGHT;
+			_orientation = 0;
+			setFontSize(0);
+			paint(blackColour);
+		}
+		String WhoAmI()
+		{
+			return "Mock screen";
+		}
+
+		// Sets the frame buffer without drawing
+		void paint(uint16_t colour)
+		{
+			for (int y = 0; y < MOCK_HEIGHT; y++)
+				for (int x = 0; x < MOCK_WIDTH; x++)
+					pixels[y][x] = colour;
+		}
+		void clearCounts()
+		{
+			points = fills = windows = buffers = data = buffered = errors = 0;
+		}
+
+	protected:
+		uint16_t wx1, wy1, wx2, wy2, cx, cy;
+
+		void plot(uint16_t x, uint16_t y, uint16_t colour)
+		{
+			if (x >= MOCK_WIDTH || y >= MOCK_HEIGHT)
+				errors++;
+			else
+				pixels[y][x] = colour;
+		}
+
+		void _fastFill(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t colour)
+		{
+			fills++;
+			if (x1 > x2) _swap(x1, x2);
+			if (y1 > y2) _swap(y1, y2);
+			for (uint16_t y = y1; y <= y2; y++)
+				for (uint16_t x = x1; x <= x2; x++)
+					plot(x, y, colour);
+		}
+		void _setPoint(uint16_t x1, uint16_t y1, uint16_t colour)
+		{
+			points++;
+			plot(x1, y1, colour);
+		}
+		void _getRawTouch(uint16_t &x0, uint16_t &y0, uint16_t &z0)
+		{
+			x0 = y0 = z0 = 0;
+		}
+		void _setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+		{
+			windows++;
+			wx1 = cx = x0;
+			wy1 = cy = y0;
+			wx2 = x1;
+			wy2 = y1;
+		}
+		void _writeData88(uint8_t dataHigh8, uint8_t dataLow8)
+		{
+			data++;
+			if (cy > wy2) {
+				errors++;
+				return;
+			}
+			plot(cx, cy, dataHigh8 << 8 | dataLow8);
+			if (cx++ == wx2) {
+				cx = wx1;
+				cy++;
+			}
+		}
+		void _writeDataBuffer(const uint16_t * data16, uint32_t count)
+		{
+			buffers++;
+			buffered += count;
+			LCD_screen_font::_writeDataBuffer(data16, count);
+		}
+};
+
+#endif
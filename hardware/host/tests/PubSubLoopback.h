@@ -0,0 +1,184 @@
+/*
+ ************************************************************************
+ *	PubSubLoopback.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A Client for PubSubClient with a broker stand-in behind it. CONNECT,
+ *	SUBSCRIBE and PINGREQ are answered at once; besides the answers, a
+ *	recorded stream of packets given to replay() comes in segment bytes
+ *	at a time, the way TCP hands it over: available() only reports the
+ *	next segment once the last has been read. reads counts the calls to
+ *	read() of either kind, and sent keeps the start of the last packet
+ *	written.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef PubSubLoopback_h
+#define PubSubLoopback_h
+
+#include <string.h>
+#include "PubSubClient.h"
+
+class PubSubLoopback : public Client
+{
+	public:
+		size_t segment;
+		unsigned long reads, written;
+		uint8_t sent[64];
+		size_t sentLen;
+
+		PubSubLoopback() : segment(1460), reads(0), written(0), sentLen(0),
+				open(false), stream(0), streamLen(0), streamPos(0), arrived(0),
+				answerLen(0), answerPos(0) {}
+
+		void replay(const uint8_t *packets, size_t len)
+		{
+			stream = packets;
+			streamLen = len;
+			streamPos = 0;
+			arrived = 0;
+		}
+
+		// Whether all of the stream has been read
+		bool done() { return streamPos == streamLen; }
+
+		virtual int connect(IPAddress ip, uint16_t port) { return connect("", port); }
+		virtual int connect(const char *host, uint16_t port)
+		{
+			open = true;
+			answerLen = answerPos = 0;
+			return 1;
+		}
+		virtual size_t write(uint8_t c) { return write(&c, 1); }
+		virtual size_t write(const uint8_t *buf, size_t size)
+		{
+			if (size == 0)
+				return 0;
+			written++;
+			sentLen = size < sizeof(sent) ? size : sizeof(sent);
+			memcpy(sent, buf, sentLen);
+			switch (buf[0] & 0xF0) {
+			case MQTTCONNECT:
+				answerWith(MQTTCONNACK, 0x00, 0x00);
+				break;
+			case MQTTSUBSCRIBE:
+				// the packet id follows a remaining length of one byte
+				if (size >= 4)
+					answerWith(MQTTSUBACK, buf[2], buf[3], true);
+				break;
+			case MQTTPINGREQ:
+				answerWith(MQTTPINGRESP, -1, -1);
+				break;
+			}
+			return size;
+		}
+		virtual int available()
+		{
+			if (answerPos < answerLen)
+				return answerLen - answerPos;
+			if (arrived == 0) {
+				arrived = streamLen - streamPos;
+				if (arrived > segment)
+					arrived = segment;
+			}
+			return arrived;
+		}
+		virtual int read()
+		{
+			uint8_t c;
+
+			return read(&c, 1) == 1 ? c : -1;
+		}
+		virtual int read(uint8_t *buf, size_t size)
+		{
+			reads++;
+			if (answerPos < answerLen) {
+				if (size > (size_t)(answerLen - answerPos))
+					size = answerLen - answerPos;
+				memcpy(buf, answer + answerPos, size);
+				answerPos += size;
+				return size;
+			}
+			if (available() == 0)
+				return -1;
+			if (size > arrived)
+				size = arrived;
+			memcpy(buf, stream + streamPos, size);
+			streamPos += size;
+			arrived -= size;
+			return size;
+		}
+		virtual int peek() { return -1; }
+		virtual void flush() {}
+		virtual void stop() { open = false; }
+		virtual uint8_t connected() { return open; }
+		virtual operator bool() { return open; }
+
+	private:
+		bool open;
+		const uint8_t *stream;
+		size_t streamLen, streamPos, arrived;
+		uint8_t answer[16];
+		int answerLen, answerPos;
+
+		// QoS 0 granted for a subscription
+		void answerWith(uint8_t header, int a, int b, bool qos = false)
+		{
+			if (answerPos == answerLen)
+				answerLen = answerPos = 0;
+			answer[answerLen++] = header;
+			answer[answerLen++] = a < 0 ? 0 : qos ? 3 : 2;
+			if (a >= 0) {
+				answer[answerLen++] = a;
+				answer[answerLen++] = b;
+			}
+			if (qos)
+				answer[answerLen++] = 0;
+		}
+};
+
+// A PUBLISH packet for the stream, at QoS 1 with an id if qos is set.
+// Returns its length.
+static size_t pubSubPacket(uint8_t *buf, const char *topic,
+		const uint8_t *payload, size_t len, bool qos = false)
+{
+	size_t tl = strlen(topic), n = 0;
+	size_t remaining = 2 + tl + (qos ? 2 : 0) + len;
+
+	buf[n++] = MQTTPUBLISH | (qos ? MQTTQOS1 : 0);
+	do {
+		buf[n] = remaining % 128;
+		remaining /= 128;
+		if (remaining)
+			buf[n] |= 0x80;
+		n++;
+	} while (remaining);
+	buf[n++] = tl >> 8;
+	buf[n++] = tl & 0xFF;
+	memcpy(buf + n, topic, tl);
+	n += tl;
+	if (qos) {
+		buf[n++] = 0x12;
+		buf[n++] = 0x34;
+	}
+	memcpy(buf + n, payload, len);
+	return n + len;
+}
+
+#endif
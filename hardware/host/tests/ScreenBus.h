@@ -0,0 +1,101 @@
+/*
+ ************************************************************************
+ *	ScreenBus.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The SPI bus of a screen of the LCD_screen libraries, on an SSI module:
+ *	a transaction is the frames sent while the chip select pin is low, a
+ *	command one those sent with the data/command pin low. Both pins are
+ *	watched on their GPIO ports; the screen itself is not modelled, it
+ *	reads 0xFF.
+ *
+ *	transactions counts the transactions, commands those that were
+ *	commands, and bytes the frames sent in all of them.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef ScreenBus_h
+#define ScreenBus_h
+
+#include "Energia.h"
+#include "inc/hw_memmap.h"
+
+class ScreenBus
+{
+	public:
+		static ScreenBus *active;
+		unsigned long transactions, commands, bytes;
+
+		ScreenBus(uint8_t csPin, uint8_t dcPin, uint32_t ssi = SSI2_BASE) :
+				ssi(ssi), selected(false)
+		{
+			csPort = port_to_base[digitalPinToPort(csPin)];
+			cs = digitalPinToBitMask(csPin);
+			dcPort = port_to_base[digitalPinToPort(dcPin)];
+			dc = digitalPinToBitMask(dcPin);
+			clear();
+			active = this;
+			HostSSISetDevice(ssi, transfer, this);
+			HostGPIOSetWatch(watch);
+		}
+		~ScreenBus()
+		{
+			HostSSISetDevice(ssi, 0, 0);
+			HostGPIOSetWatch(0);
+			if (active == this)
+				active = 0;
+		}
+
+		void clear()
+		{
+			transactions = commands = bytes = 0;
+		}
+
+	private:
+		uint32_t ssi, csPort, dcPort;
+		uint8_t cs, dc;
+		bool selected;
+
+		static uint8_t transfer(uint32_t base, uint8_t out, void *arg)
+		{
+			ScreenBus *b = (ScreenBus *)arg;
+
+			if (b->selected)
+				b->bytes++;
+			return 0xFF;
+		}
+
+		static void watch(uint32_t port, uint8_t before, uint8_t after)
+		{
+			ScreenBus *b = active;
+
+			if (!b || port != b->csPort || !((before ^ after) & b->cs))
+				return;
+			b->selected = !(after & b->cs);
+			if (!b->selected)
+				return;
+			b->transactions++;
+			if (!(HostGPIOOutputGet(b->dcPort) & b->dc))
+				b->commands++;
+		}
+};
+
+ScreenBus *ScreenBus::active;
+
+#endif
@@ -0,0 +1,413 @@
+/*
+ ************************************************************************
+ *	SdCardEmulator.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	An SD card on the SPI bus, kept in a file, for the SD library. It
+ *	supplies the sdSpi*() hooks from SdSpi.h and answers the SPI mode
+ *	commands Sd2Card uses: start up as an SDHC card, or as a byte
+ *	addressed SD2 card with sdhc cleared, the CSD and CID, single and
+ *	multiple block reads and writes, and erase. latency is the number of
+ *	0xFF bytes before the data token after a command, the access time,
+ *	gap the number between the blocks of a multiple block read, which
+ *	cards keep short by reading ahead, and busy the number of busy bytes
+ *	after a write, a stop or an erase. A card that stops now and then to
+ *	erase is had with stall, busy bytes added after every stallEvery
+ *	blocks written.
+ *
+ *	Every byte clocked either way is counted in clocked, the bytes that
+ *	went through the block hooks in blockBytes, each command in
+ *	commands[] by its index (ACMD41 and ACMD23 included) and each block
+ *	read or written. The chip select line is left to the core and not
+ *	looked at. tick, if set, is called after each byte, as a timer
+ *	interrupt would be; the card is ready for the next byte by then, so
+ *	it may use the card itself.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SdCardEmulator_h
+#define SdCardEmulator_h
+
+#include <stdio.h>
+#include <string.h>
+// Energia.h has a sleep() of its own
+#define sleep posixSleep
+#include <unistd.h>
+#undef sleep
+#include "Sd2Card.h"
+#include "SdSpi.h"
+
+class SdCardEmulator
+{
+	public:
+		static SdCardEmulator *active;
+		bool sdhc;
+		int latency, gap, busy;
+		int stall;
+		unsigned long stallEvery;
+		void (*tick)(void);
+		unsigned long commands[64];
+		unsigned long clocked, blockBytes, blocksRead, blocksWritten;
+
+		// A card of blocks 512 byte blocks in the file at path, which is
+		// created or made that size
+		SdCardEmulator(const char *path, uint32_t blocks) : sdhc(true),
+				latency(40), gap(2), busy(4), stall(0), stallEvery(0), tick(0),
+				blocks(blocks), idle(true), appCmd(false), frameLen(0), outLen(0),
+				outPos(0), stalling(0), multiRead(false), receiving(0)
+		{
+			// no fcntl.h, its O_ flags are not the ones SdFat.h has
+			image = fopen(path, "r+b");
+			if (!image)
+				image = fopen(path, "w+b");
+			fd = image ? fileno(image) : -1;
+			if (fd >= 0 && ftruncate(fd, (off_t)blocks * 512) != 0)
+				fd = -1;
+			clear();
+			active = this;
+		}
+		~SdCardEmulator()
+		{
+			if (image)
+				fclose(image);
+			if (active == this)
+				active = 0;
+		}
+
+		bool ok() { return fd >= 0; }
+		int file() { return fd; }
+
+		void clear()
+		{
+			memset(commands, 0, sizeof(commands));
+			clocked = blockBytes = blocksRead = blocksWritten = 0;
+		}
+
+		// One byte each way
+		uint8_t transfer(uint8_t in)
+		{
+			uint8_t out = 0xFF;
+
+			clocked++;
+			if (outPos == outLen && multiRead)
+				queueBlock(readAddress++, gap);
+			if (outPos < outLen) {
+				out = this->out[outPos++];
+			} else if (stalling) {
+				out = 0x00;
+				stalling--;
+			}
+			if (receiving)
+				receive(in);
+			else if (frameLen || (in & 0xC0) == 0x40)
+				command(in);
+			if (tick)
+				tick();
+			return out;
+		}
+
+	private:
+		FILE *image;
+		int fd;
+		uint32_t blocks;
+		bool idle, appCmd;
+		uint8_t frame[6];
+		int frameLen;
+		uint8_t out[1024];
+		int outLen, outPos;
+		// busy bytes of a stall, after the ones in out
+		int stalling;
+		bool multiRead;
+		uint32_t readAddress;
+		// the token expected, then the block coming in for a write
+		uint8_t receiving;
+		uint32_t writeAddress;
+		uint8_t block[514];
+		int blockLen;
+		uint32_t eraseStart, eraseEnd;
+
+		void put(uint8_t b) { out[outLen++] = b; }
+
+		void respond(uint8_t r1)
+		{
+			outLen = outPos = 0;
+			put(0xFF);
+			put(r1);
+		}
+
+		void putBusy()
+		{
+			for (int i = 0; i < busy; i++)
+				put(0x00);
+		}
+
+		void putData(const uint8_t *data, int len, int wait)
+		{
+			for (int i = 0; i < wait; i++)
+				put(0xFF);
+			put(0xFE);
+			memcpy(out + outLen, data, len);
+			outLen += len;
+			put(0xFF);
+			put(0xFF);
+		}
+
+		// block number from a command argument
+		uint32_t address(uint32_t arg) { return sdhc ? arg : arg >> 9; }
+
+		void queueBlock(uint32_t n, int wait)
+		{
+			uint8_t data[512];
+
+			if (outPos == outLen)
+				outLen = outPos = 0;
+			if (n >= blocks || pread(fd, data, 512, (off_t)n * 512) != 512) {
+				// out of range error token
+				put(0x08);
+				multiRead = false;
+				return;
+			}
+			blocksRead++;
+			putData(data, 512, wait);
+		}
+
+		void command(uint8_t in)
+		{
+			uint32_t arg;
+			uint8_t cmd, r1;
+			bool acmd = appCmd;
+
+			frame[frameLen++] = in;
+			if (frameLen < 6)
+				return;
+			frameLen = 0;
+			cmd = frame[0] & 0x3F;
+			arg = (uint32_t)frame[1] << 24 | frame[2] << 16 | frame[3] << 8 |
+					frame[4];
+			commands[cmd]++;
+			appCmd = false;
+			r1 = idle ? R1_IDLE_STATE : R1_READY_STATE;
+			if (cmd != CMD12)
+				multiRead = false;
+
+			switch (cmd) {
+			case CMD0:
+				idle = true;
+				respond(R1_IDLE_STATE);
+				break;
+			case CMD8:
+				respond(r1);
+				put(0x00);
+				put(0x00);
+				put(0x01);
+				put(arg & 0xFF);
+				break;
+			case CMD55:
+				appCmd = true;
+				respond(r1);
+				break;
+			case ACMD41:
+				// ready on the second try
+				if (acmd) {
+					respond(r1);
+					idle = false;
+				} else {
+					respond(r1 | R1_ILLEGAL_COMMAND);
+				}
+				break;
+			case CMD58:
+				respond(r1);
+				put(sdhc ? 0xC0 : 0x80);
+				put(0xFF);
+				put(0x80);
+				put(0x00);
+				break;
+			case CMD9:
+			case CMD10:
+				respond(r1);
+				putRegister(cmd);
+				break;
+			case CMD12:
+				// a stuff byte that fails the stop if taken for the response
+				outLen = outPos = 0;
+				put(0x7F);
+				put(multiRead ? R1_READY_STATE : R1_ILLEGAL_COMMAND);
+				putBusy();
+				multiRead = false;
+				break;
+			case CMD13:
+				respond(r1);
+				put(0x00);
+				break;
+			case CMD17:
+				respond(r1);
+				queueBlock(address(arg), latency);
+				break;
+			case CMD18:
+				respond(r1);
+				readAddress = address(arg);
+				multiRead = true;
+				queueBlock(readAddress++, latency);
+				break;
+			case ACMD23:
+				respond(acmd ? r1 : r1 | R1_ILLEGAL_COMMAND);
+				break;
+			case CMD24:
+			case CMD25:
+				respond(r1);
+				writeAddress = address(arg);
+				receiving = cmd == CMD24 ? DATA_START_BLOCK : WRITE_MULTIPLE_TOKEN;
+				blockLen = -1;
+				break;
+			case CMD32:
+				respond(r1);
+				eraseStart = address(arg);
+				break;
+			case CMD33:
+				respond(r1);
+				eraseEnd = address(arg);
+				break;
+			case CMD38:
+				respond(r1);
+				erase();
+				putBusy();
+				break;
+			default:
+				respond(r1 | R1_ILLEGAL_COMMAND);
+				break;
+			}
+		}
+
+		void putRegister(uint8_t cmd)
+		{
+			uint8_t reg[16];
+
+			memset(reg, 0, sizeof(reg));
+			if (cmd == CMD10) {
+				reg[0] = 0x03;
+				memcpy(reg + 3, "SDEMU", 5);
+			} else if (sdhc) {
+				uint32_t cSize = blocks / 1024 - 1;
+
+				reg[0] = 0x40;
+				reg[5] = 0x09;
+				reg[7] = cSize >> 16 & 0x3F;
+				reg[8] = cSize >> 8;
+				reg[9] = cSize;
+				reg[10] = 0x7F;
+			} else {
+				// c_size_mult 7 and read_bl_len 9, 512 blocks per c_size
+				uint32_t cSize = blocks / 512 - 1;
+
+				reg[5] = 0x09;
+				reg[6] = cSize >> 10 & 0x03;
+				reg[7] = cSize >> 2;
+				reg[8] = cSize << 6;
+				reg[9] = 0x03;
+				reg[10] = 0xFF;
+			}
+			reg[15] = 0x01;
+			putData(reg, 16, latency);
+		}
+
+		// the bytes sent after CMD24 or CMD25
+		void receive(uint8_t in)
+		{
+			if (blockLen < 0) {
+				if (in == receiving) {
+					blockLen = 0;
+				} else if (in == STOP_TRAN_TOKEN && receiving == WRITE_MULTIPLE_TOKEN) {
+					receiving = 0;
+					outLen = outPos = 0;
+					put(0xFF);
+					putBusy();
+				}
+				return;
+			}
+			block[blockLen++] = in;
+			if (blockLen < 514)
+				return;
+			blockLen = -1;
+			outLen = outPos = 0;
+			if (writeAddress < blocks &&
+					pwrite(fd, block, 512, (off_t)writeAddress * 512) == 512) {
+				blocksWritten++;
+				put(0xE0 | DATA_RES_ACCEPTED);
+				if (stall && blocksWritten % stallEvery == 0)
+					stalling = stall;
+			} else {
+				// write error
+				put(0xED);
+				receiving = 0;
+			}
+			putBusy();
+			writeAddress++;
+			if (receiving == DATA_START_BLOCK)
+				receiving = 0;
+		}
+
+		void erase()
+		{
+			uint8_t zeros[512];
+
+			memset(zeros, 0, sizeof(zeros));
+			for (uint32_t n = eraseStart; n <= eraseEnd && n < blocks; n++)
+				if (pwrite(fd, zeros, 512, (off_t)n * 512) != 512)
+					break;
+		}
+};
+
+SdCardEmulator *SdCardEmulator::active;
+
+void sdSpiBegin(void) {}
+void sdSpiSetSckRate(uint8_t sckRateID) {}
+
+void sdSpiSend(uint8_t b)
+{
+	SdCardEmulator::active->transfer(b);
+}
+
+uint8_t sdSpiRec(void)
+{
+	return SdCardEmulator::active->transfer(0xFF);
+}
+
+void sdSpiSendBlock(const uint8_t *src, uint16_t n)
+{
+	SdCardEmulator *card = SdCardEmulator::active;
+
+	card->blockBytes += n;
+	for (uint16_t i = 0; i < n; i++)
+		card->transfer(src[i]);
+}
+
+void sdSpiRecBlock(uint8_t *dst, uint16_t n)
+{
+	SdCardEmulator *card = SdCardEmulator::active;
+
+	card->blockBytes += n;
+	for (uint16_t i = 0; i < n; i++) {
+		uint8_t b = card->transfer(0xFF);
+
+		if (dst)
+			dst[i] = b;
+	}
+}
+
+#endif
@@ -0,0 +1,397 @@
+/*
+ ************************************************************************
+ *	SdImageCard.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Sd2Card without the SPI bus: a disk image in a file, mapped with
+ *	mmap, read and written a block at a time. The Sd2Card members are
+ *	defined here, so a program including this header links them in
+ *	place of the library's Sd2Card.cpp; they must not both end up in
+ *	one program.
+ *
+ *	Each block read or written is counted, and recorded in trace while
+ *	there is room, and each command is counted in commands[] by its
+ *	index, the ones the real Sd2Card would send: CMD17 for a read, CMD24
+ *	and CMD13 for a write, CMD18 and CMD12 around a multiple block read,
+ *	ACMD23 and CMD25 to start a multiple block write, and so on. As on
+ *	the card, another command ends a multiple block read or write.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SdImageCard_h
+#define SdImageCard_h
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+// Energia.h has a sleep() of its own
+#define sleep posixSleep
+#include <unistd.h>
+#undef sleep
+#include "Sd2Card.h"
+
+class SdImageCard
+{
+	public:
+		static SdImageCard *active;
+
+		// A block read or written, in the order they happened
+		struct Access {
+			uint32_t block;
+			bool write;
+		};
+
+		uint8_t *blocks;
+		uint32_t blockCount;
+		unsigned long commands[64];
+		unsigned long blocksRead, blocksWritten;
+		Access *trace;
+		size_t traceSize, traced;
+
+		// The image of blockCount blocks in the file at path, which is
+		// created or made that size
+		SdImageCard(const char *path, uint32_t blockCount) : blocks(0),
+				blockCount(blockCount), trace(0), traceSize(0)
+		{
+			// no fcntl.h, its O_ flags are not the ones SdFat.h has
+			FILE *image = fopen(path, "r+b");
+			size_t size = (size_t)blockCount * 512;
+
+			if (!image)
+				image = fopen(path, "w+b");
+			if (image && ftruncate(fileno(image), size) == 0) {
+				void *p = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+						fileno(image), 0);
+
+				if (p != MAP_FAILED)
+					blocks = (uint8_t *)p;
+			}
+			if (image)
+				fclose(image);
+			clear();
+			active = this;
+		}
+		~SdImageCard()
+		{
+			if (blocks)
+				munmap(blocks, (size_t)blockCount * 512);
+			if (active == this)
+				active = 0;
+		}
+
+		bool ok() { return blocks != 0; }
+
+		// Keeps the next size accesses in trace
+		void record(Access *buf, size_t size)
+		{
+			trace = buf;
+			traceSize = size;
+			traced = 0;
+		}
+
+		void clear()
+		{
+			memset(commands, 0, sizeof(commands));
+			blocksRead = blocksWritten = 0;
+			traced = 0;
+		}
+
+		unsigned long totalCommands()
+		{
+			unsigned long n = 0;
+
+			for (int i = 0; i < 64; i++)
+				n += commands[i];
+			return n;
+		}
+
+		uint8_t *read(uint32_t block)
+		{
+			if (block >= blockCount)
+				return 0;
+			blocksRead++;
+			access(block, false);
+			return blocks + (size_t)block * 512;
+		}
+
+		bool write(uint32_t block, const uint8_t *src)
+		{
+			if (block >= blockCount)
+				return false;
+			blocksWritten++;
+			access(block, true);
+			memcpy(blocks + (size_t)block * 512, src, 512);
+			return true;
+		}
+
+	private:
+		// one mapping, unmapped once
+		SdImageCard(const SdImageCard &);
+		SdImageCard &operator=(const SdImageCard &);
+
+		void access(uint32_t block, bool write)
+		{
+			if (traced < traceSize) {
+				trace[traced].block = block;
+				trace[traced].write = write;
+				traced++;
+			}
+		}
+};
+
+SdImageCard *SdImageCard::active;
+
+//
+// Sd2Card on the image. block_ is the next block of a multiple block read
+// or write, offset_ how far a partial block read has got.
+//
+uint32_t Sd2Card::cardSize(void)
+{
+	SdImageCard::active->commands[CMD9]++;
+	return SdImageCard::active->blockCount;
+}
+
+uint8_t Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock)
+{
+	SdImageCard *card = SdImageCard::active;
+	uint8_t zeros[512];
+
+	if (inMultiWrite_)
+		writeStop();
+	card->commands[CMD9]++;
+	card->commands[CMD32]++;
+	card->commands[CMD33]++;
+	card->commands[CMD38]++;
+	if (lastBlock >= card->blockCount || firstBlock > lastBlock) {
+		error(SD_CARD_ERROR_ERASE);
+		return false;
+	}
+	memset(zeros, 0, sizeof(zeros));
+	for (uint32_t n = firstBlock; n <= lastBlock; n++)
+		memcpy(card->blocks + (size_t)n * 512, zeros, 512);
+	return true;
+}
+
+uint8_t Sd2Card::eraseSingleBlockEnable(void)
+{
+	SdImageCard::active->commands[CMD9]++;
+	return true;
+}
+
+uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin)
+{
+	SdImageCard *card = SdImageCard::active;
+
+	errorCode_ = inBlock_ = inMultiRead_ = inMultiWrite_ = 0;
+	partialBlockRead_ = type_ = 0;
+	chipSelectPin_ = chipSelectPin;
+	if (!card || !card->ok()) {
+		error(SD_CARD_ERROR_CMD0);
+		return false;
+	}
+	card->commands[CMD0]++;
+	card->commands[CMD8]++;
+	card->commands[CMD55]++;
+	card->commands[ACMD41]++;
+	card->commands[CMD58]++;
+	type(SD_CARD_TYPE_SDHC);
+	return setSckRate(sckRateID);
+}
+
+void Sd2Card::partialBlockRead(uint8_t value)
+{
+	readEnd();
+	partialBlockRead_ = value;
+}
+
+uint8_t Sd2Card::readBlock(uint32_t block, uint8_t *dst)
+{
+	return readData(block, 0, 512, dst);
+}
+
+uint8_t Sd2Card::readData(uint32_t block, uint16_t offset, uint16_t count,
+		uint8_t *dst)
+{
+	SdImageCard *card = SdImageCard::active;
+	uint8_t *src;
+
+	if (count == 0)
+		return true;
+	if (count + offset > 512)
+		return false;
+	if (inMultiRead_)
+		readStop();
+	if (inMultiWrite_)
+		writeStop();
+	if (!inBlock_ || block != block_ || offset < offset_) {
+		readEnd();
+		card->commands[CMD17]++;
+		if (!card->read(block)) {
+			error(SD_CARD_ERROR_CMD17);
+			return false;
+		}
+		block_ = block;
+		offset_ = 0;
+		inBlock_ = 1;
+	}
+	src = card->blocks + (size_t)block_ * 512;
+	memcpy(dst, src + offset, count);
+	offset_ = offset + count;
+	if (!partialBlockRead_ || offset_ >= 512)
+		readEnd();
+	return true;
+}
+
+uint8_t Sd2Card::readData(uint8_t *dst)
+{
+	uint8_t *src;
+
+	if (!inMultiRead_) {
+		error(SD_CARD_ERROR_READ);
+		return false;
+	}
+	src = SdImageCard::active->read(block_);
+	if (!src) {
+		error(SD_CARD_ERROR_READ);
+		return false;
+	}
+	memcpy(dst, src, 512);
+	block_++;
+	return true;
+}
+
+void Sd2Card::readEnd(void)
+{
+	inBlock_ = 0;
+}
+
+uint8_t Sd2Card::readRegister(uint8_t cmd, void *buf)
+{
+	uint8_t *dst = reinterpret_cast<uint8_t *>(buf);
+	uint32_t cSize = SdImageCard::active->blockCount / 1024 - 1;
+
+	SdImageCard::active->commands[cmd]++;
+	memset(dst, 0, 16);
+	if (cmd == CMD9) {
+		// CSD version 2 with erase_blk_en set
+		dst[0] = 0x40;
+		dst[5] = 0x09;
+		dst[7] = cSize >> 16 & 0x3F;
+		dst[8] = cSize >> 8;
+		dst[9] = cSize;
+		dst[10] = 0x7F;
+	}
+	dst[15] = 0x01;
+	return true;
+}
+
+uint8_t Sd2Card::readStart(uint32_t blockNumber)
+{
+	readEnd();
+	if (inMultiRead_)
+		readStop();
+	if (inMultiWrite_)
+		writeStop();
+	SdImageCard::active->commands[CMD18]++;
+	if (blockNumber >= SdImageCard::active->blockCount) {
+		error(SD_CARD_ERROR_CMD18);
+		return false;
+	}
+	block_ = blockNumber;
+	inMultiRead_ = 1;
+	return true;
+}
+
+uint8_t Sd2Card::readStop(void)
+{
+	SdImageCard::active->commands[CMD12]++;
+	if (!inMultiRead_) {
+		error(SD_CARD_ERROR_CMD12);
+		return false;
+	}
+	inMultiRead_ = 0;
+	return true;
+}
+
+uint8_t Sd2Card::setSckRate(uint8_t sckRateID)
+{
+	if (sckRateID > 6) {
+		error(SD_CARD_ERROR_SCK_RATE);
+		return false;
+	}
+	return true;
+}
+
+uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t *src)
+{
+	SdImageCard *card = SdImageCard::active;
+
+	readEnd();
+	if (inMultiRead_)
+		readStop();
+	if (inMultiWrite_)
+		writeStop();
+	card->commands[CMD24]++;
+	if (!card->write(blockNumber, src)) {
+		error(SD_CARD_ERROR_CMD24);
+		return false;
+	}
+	card->commands[CMD13]++;
+	return true;
+}
+
+uint8_t Sd2Card::writeData(const uint8_t *src)
+{
+	if (!inMultiWrite_ || !SdImageCard::active->write(block_, src)) {
+		error(SD_CARD_ERROR_WRITE_MULTIPLE);
+		return false;
+	}
+	block_++;
+	return true;
+}
+
+uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount)
+{
+	SdImageCard *card = SdImageCard::active;
+
+	readEnd();
+	if (inMultiRead_)
+		readStop();
+	if (inMultiWrite_)
+		writeStop();
+	card->commands[CMD55]++;
+	card->commands[ACMD23]++;
+	card->commands[CMD25]++;
+	if (blockNumber >= card->blockCount) {
+		error(SD_CARD_ERROR_CMD25);
+		return false;
+	}
+	block_ = blockNumber;
+	inMultiWrite_ = 1;
+	return true;
+}
+
+// the stop token is not a command, nothing to count
+uint8_t Sd2Card::writeStop(void)
+{
+	inMultiWrite_ = 0;
+	return true;
+}
+
+#endif
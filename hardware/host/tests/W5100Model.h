@@ -0,0 +1,295 @@
+/*
+ ************************************************************************
+ *	W5100Model.h
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	A W5100 on an SSI module, for the Ethernet library: the 32 KB address
+ *	space of common and socket registers and the 2 KB socket buffers,
+ *	reached through four byte frames of an opcode, the address and the
+ *	data while the chip select pin is low. The chip select is watched on
+ *	its GPIO port; a frame cut short by it is dropped, the way the chip
+ *	drops it.
+ *
+ *	The peer is a web server. A TCP socket connects at once, and what is
+ *	sent on it is kept in request; once that holds a blank line the
+ *	server answers with response, in segments of at most segment bytes
+ *	as the receive buffer has room for them, the way a window would let
+ *	them through, and closes its side after the last one. RX_RSR moves as
+ *	segments arrive and as RECV commands free their room.
+ *
+ *	frames counts the frames the chip took, commands[] the socket
+ *	commands by their value.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef W5100Model_h
+#define W5100Model_h
+
+#include <string.h>
+#include "Energia.h"
+#include "inc/hw_memmap.h"
+#include "w5100.h"
+
+class W5100Model
+{
+	public:
+		static W5100Model *active;
+		const uint8_t *response;
+		size_t responseLen, segment;
+		char request[4096];
+		size_t requestLen;
+		unsigned long frames, commands[256];
+		uint8_t mem[0x8000];
+
+		W5100Model(uint32_t ssi = SSI2_BASE, uint8_t csPin = W5100_SS) :
+				response(0), responseLen(0), segment(1460), requestLen(0),
+				ssi(ssi), selected(false), pos(0)
+		{
+			port = port_to_base[digitalPinToPort(csPin)];
+			cs = digitalPinToBitMask(csPin);
+			reset();
+			clear();
+			active = this;
+			HostSSISetDevice(ssi, transfer, this);
+			HostGPIOSetWatch(watch);
+		}
+		~W5100Model()
+		{
+			HostSSISetDevice(ssi, 0, 0);
+			HostGPIOSetWatch(0);
+			if (active == this)
+				active = 0;
+		}
+
+		void clear()
+		{
+			frames = 0;
+			memset(commands, 0, sizeof(commands));
+		}
+
+		// Serve len bytes of data to the next request
+		void serve(const uint8_t *data, size_t len)
+		{
+			response = data;
+			responseLen = len;
+		}
+
+		uint16_t reg16(uint16_t addr)
+		{
+			return mem[addr] << 8 | mem[addr + 1];
+		}
+
+		uint16_t sockReg16(int s, uint16_t reg)
+		{
+			return reg16(SOCK_BASE + s * SOCK_SIZE + reg);
+		}
+
+		uint8_t sockReg(int s, uint16_t reg)
+		{
+			return mem[SOCK_BASE + s * SOCK_SIZE + reg];
+		}
+
+	private:
+		enum {
+			SOCK_BASE = 0x0400, SOCK_SIZE = 0x0100,
+			TX_BASE = 0x4000, RX_BASE = 0x6000, BUF_SIZE = 0x0800,
+			Sn_MR = 0x00, Sn_CR = 0x01, Sn_IR = 0x02, Sn_SR = 0x03,
+			Sn_TX_FSR = 0x20, Sn_TX_RD = 0x22, Sn_TX_WR = 0x24,
+			Sn_RX_RSR = 0x26, Sn_RX_RD = 0x28, Sn_RX_WR = 0x2A
+		};
+
+		uint32_t ssi, port;
+		uint8_t cs;
+		bool selected;
+		int pos;
+		uint8_t frame[3];
+		struct {
+			uint16_t rxWr, rxRd;
+			size_t sent;
+			bool answering;
+		} sock[MAX_SOCK_NUM];
+
+		static uint8_t transfer(uint32_t base, uint8_t out, void *arg)
+		{
+			return ((W5100Model *)arg)->exchange(out);
+		}
+
+		static void watch(uint32_t port, uint8_t before, uint8_t after)
+		{
+			W5100Model *m = active;
+
+			if (!m || port != m->port || !((before ^ after) & m->cs))
+				return;
+			m->selected = !(after & m->cs);
+			m->pos = 0;
+		}
+
+		uint8_t exchange(uint8_t out)
+		{
+			uint16_t addr;
+
+			if (!selected)
+				return 0xFF;
+			if (pos < 3) {
+				frame[pos] = out;
+				return pos++;
+			}
+			if (pos++ > 3)
+				return 0xFF;
+			frames++;
+			addr = (frame[1] << 8 | frame[2]) & 0x7FFF;
+			if (frame[0] == 0x0F)
+				return mem[addr];
+			if (frame[0] == 0xF0)
+				write(addr, out);
+			return 3;
+		}
+
+		void setReg16(uint16_t addr, uint16_t v)
+		{
+			mem[addr] = v >> 8;
+			mem[addr + 1] = v;
+		}
+
+		void reset()
+		{
+			memset(mem, 0, sizeof(mem));
+			memset(sock, 0, sizeof(sock));
+			setReg16(0x0017, 2000);
+			mem[0x0019] = 8;
+			mem[0x001A] = mem[0x001B] = 0x55;
+		}
+
+		void write(uint16_t addr, uint8_t v)
+		{
+			uint16_t reg;
+			int s;
+
+			if (addr == 0x0000 && (v & 0x80)) {
+				reset();
+				return;
+			}
+			if (addr < SOCK_BASE || addr >= SOCK_BASE + MAX_SOCK_NUM * SOCK_SIZE) {
+				mem[addr] = v;
+				return;
+			}
+			s = (addr - SOCK_BASE) / SOCK_SIZE;
+			reg = addr & (SOCK_SIZE - 1);
+			if (reg == Sn_CR)
+				command(s, v);
+			else if (reg == Sn_IR)
+				mem[addr] &= ~v;
+			else if (reg != Sn_SR && reg != Sn_TX_FSR && reg != Sn_TX_FSR + 1 &&
+					reg != Sn_RX_RSR && reg != Sn_RX_RSR + 1)
+				mem[addr] = v;
+		}
+
+		uint8_t *sockMem(int s)
+		{
+			return &mem[SOCK_BASE + s * SOCK_SIZE];
+		}
+
+		void command(int s, uint8_t cmd)
+		{
+			uint8_t *r = sockMem(s);
+			uint16_t base = SOCK_BASE + s * SOCK_SIZE;
+
+			commands[cmd]++;
+			switch (cmd) {
+			case Sock_OPEN:
+				r[Sn_SR] = (r[Sn_MR] & 0x0F) == SnMR::TCP ? SnSR::INIT :
+						(r[Sn_MR] & 0x0F) == SnMR::UDP ? SnSR::UDP : SnSR::CLOSED;
+				memset(&sock[s], 0, sizeof(sock[s]));
+				for (int i = Sn_TX_RD; i < Sn_RX_WR + 2; i++)
+					r[i] = 0;
+				setReg16(base + Sn_TX_FSR, BUF_SIZE);
+				requestLen = 0;
+				break;
+			case Sock_LISTEN:
+				r[Sn_SR] = SnSR::LISTEN;
+				break;
+			case Sock_CONNECT:
+				r[Sn_SR] = SnSR::ESTABLISHED;
+				r[Sn_IR] |= SnIR::CON;
+				break;
+			case Sock_DISCON:
+			case Sock_CLOSE:
+				r[Sn_SR] = SnSR::CLOSED;
+				sock[s].answering = false;
+				break;
+			case Sock_SEND:
+				send(s);
+				break;
+			case Sock_RECV:
+				sock[s].rxRd = reg16(base + Sn_RX_RD);
+				deliver(s);
+				break;
+			}
+		}
+
+		void send(int s)
+		{
+			uint16_t base = SOCK_BASE + s * SOCK_SIZE;
+			uint16_t rd = reg16(base + Sn_TX_RD), wr = reg16(base + Sn_TX_WR);
+
+			for (; rd != wr; rd++) {
+				if (requestLen < sizeof(request) - 1)
+					request[requestLen++] = mem[TX_BASE + s * BUF_SIZE + (rd & (BUF_SIZE - 1))];
+			}
+			request[requestLen] = 0;
+			setReg16(base + Sn_TX_RD, rd);
+			mem[base + Sn_IR] |= SnIR::SEND_OK;
+			if (!sock[s].answering && strstr(request, "\r\n\r\n")) {
+				sock[s].answering = true;
+				sock[s].sent = 0;
+				deliver(s);
+			}
+		}
+
+		// Segments of the response, as many as the receive buffer has room for
+		void deliver(int s)
+		{
+			uint16_t base = SOCK_BASE + s * SOCK_SIZE;
+
+			while (sock[s].answering && sock[s].sent < responseLen) {
+				size_t room = BUF_SIZE - (uint16_t)(sock[s].rxWr - sock[s].rxRd);
+				size_t n = responseLen - sock[s].sent;
+
+				if (n > segment)
+					n = segment;
+				if (n > room)
+					n = room;
+				if (!n)
+					break;
+				for (size_t i = 0; i < n; i++, sock[s].rxWr++)
+					mem[RX_BASE + s * BUF_SIZE + (sock[s].rxWr & (BUF_SIZE - 1))] =
+							response[sock[s].sent + i];
+				sock[s].sent += n;
+				mem[base + Sn_IR] |= SnIR::RECV;
+			}
+			if (sock[s].answering && sock[s].sent == responseLen)
+				mem[base + Sn_SR] = SnSR::CLOSE_WAIT;
+			setReg16(base + Sn_RX_WR, sock[s].rxWr);
+			setReg16(base + Sn_RX_RSR, sock[s].rxWr - sock[s].rxRd);
+		}
+};
+
+W5100Model *W5100Model::active;
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ ************************************************************************
+ *	ajson_arena.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	aJson parsing into an arena: the tree matches a heap parse and prints
+ *	the same, no heap call is made, nodes are aligned whatever the buffer,
+ *	strings are not cut at the heap parser's 255 characters, and a failed
+ *	or too large parse gives back everything it took. Heap calls are
+ *	counted by wrapping the C library's allocator.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "aJSON.h"
+#include "HostTest.h"
+
+static unsigned long allocations;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_calloc(size_t count, size_t size);
+
+void *malloc(size_t size)
+{
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+
+// The compiler turns malloc() and memset() into calloc()
+void *calloc(size_t count, size_t size)
+{
+	allocations++;
+	return __libc_calloc(count, size);
+}
+}
+
+static const char document[] =
+	"{\"id\":\"9a3f\",\"name\":\"Weather \\\"roof\\\"\",\"count\":3,"
+	"\"values\":[{\"timestamp\":\"2014-09-09T19:15:00.624Z\",\"value\":21.5},"
+	"{\"timestamp\":\"2014-09-09T19:16:00.624Z\",\"value\":-3},"
+	"{\"timestamp\":\"2014-09-09T19:17:00.624Z\",\"value\":true}],"
+	"\"tags\":[],\"meta\":{},\"unit\":null}";
+
+static char storage[4096 + 1];
+
+// Render a tree, to compare two of them
+static void render(aJsonObject *item, char *out, size_t size)
+{
+	aJsonStringStream stream(NULL, out, size);
+
+	aJson.print(item, &stream);
+}
+
+static bool aligned(aJsonObject *item)
+{
+	for (; item; item = item->next) {
+		if ((size_t)item % __alignof__(aJsonObject))
+			return false;
+		if (item->child && !aligned(item->child))
+			return false;
+	}
+	return true;
+}
+
+static void sameTree(void)
+{
+	char text[sizeof(document)];
+	char heapOut[512], arenaOut[512];
+
+	memcpy(text, document, sizeof(document));
+	aJsonObject *heap = aJson.parse(text);
+	CHECK(heap != NULL);
+	render(heap, heapOut, sizeof(heapOut));
+
+	// Start the arena on an odd address
+	aJsonArena arena(storage + 1, sizeof(storage) - 1);
+	unsigned long start = allocations;
+
+	memcpy(text, document, sizeof(document));
+	aJsonObject *root = aJson.parse(text, arena);
+	CHECK(allocations == start);
+	CHECK(root != NULL && aligned(root));
+	render(root, arenaOut, sizeof(arenaOut));
+	CHECK(strcmp(heapOut, arenaOut) == 0);
+
+	aJsonObject *values = aJson.getObjectItem(root, "values");
+	aJsonObject *first = aJson.getArrayItem(values, 0);
+	CHECK(aJson.getArraySize(values) == 3);
+	CHECK(aJson.getObjectItem(first, "value")->valuefloat == 21.5);
+	CHECK(strcmp(aJson.getObjectItem(root, "name")->valuestring,
+			"Weather \"roof\"") == 0);
+	CHECK(aJson.getObjectItem(root, "unit")->type == aJson_NULL);
+
+	// Everything is in the buffer, and reset() makes all of it reusable
+	size_t used = arena.used();
+	CHECK(used > 0 && used <= arena.size() && arena.peak() == used);
+	CHECK((char *)root >= storage + 1 && (char *)root < storage + 1 + used);
+	arena.reset();
+	CHECK(arena.used() == 0);
+	memcpy(text, document, sizeof(document));
+	CHECK(aJson.parse(text, arena) == root && arena.used() == used);
+	CHECK(allocations == start);
+
+	aJson.deleteItem(heap);
+}
+
+static void streams(void)
+{
+	char text[sizeof(document)];
+	aJsonArena arena(storage, sizeof(storage));
+
+	// A stream goes back to the heap after an arena parse
+	memcpy(text, "[1,\"a\"] [2,\"b\"]", 16);
+	aJsonStringStream stream(text);
+	aJsonObject *root = aJson.parse(&stream, arena);
+	CHECK(root != NULL && root->child->valueint == 1);
+	size_t used = arena.used();
+
+	unsigned long start = allocations;
+	aJsonObject *heap = aJson.parse(&stream);
+	CHECK(heap != NULL && heap->child->valueint == 2);
+	CHECK(allocations > start && arena.used() == used);
+	aJson.deleteItem(heap);
+}
+
+static void longStrings(void)
+{
+	static char text[1200];
+	aJsonArena arena(storage, sizeof(storage));
+
+	text[0] = '"';
+	for (int i = 1; i <= 1000; i++)
+		text[i] = 'a' + i % 26;
+	text[1001] = '"';
+	text[1002] = 0;
+
+	aJsonObject *item = aJson.parse(text, arena);
+	CHECK(item && item->type == aJson_String &&
+			strlen(item->valuestring) == 1000);
+	CHECK(item->valuestring[999] == 'a' + 1000 % 26);
+}
+
+static void failures(void)
+{
+	char text[sizeof(document)];
+	char bad[] = "{\"a\":[1,2,{\"b\":\"c\"}";
+	aJsonArena arena(storage, sizeof(storage));
+
+	memcpy(text, document, sizeof(document));
+	aJsonObject *root = aJson.parse(text, arena);
+	size_t used = arena.used();
+	unsigned long start = allocations;
+
+	// A malformed document leaves the earlier tree and nothing else
+	CHECK(aJson.parse(bad, arena) == NULL);
+	CHECK(arena.used() == used && arena.peak() > used);
+	CHECK(aJson.getObjectItem(root, "count")->valueint == 3);
+
+	// So does one that does not fit, whether a node or a string fails
+	size_t size;
+	for (size = 0; size < used; size++) {
+		aJsonArena small(storage, size);
+
+		memcpy(text, document, sizeof(document));
+		if (aJson.parse(text, small) != NULL || small.used() != 0)
+			break;
+	}
+	CHECK(size == used);
+	aJsonArena exact(storage, used);
+	memcpy(text, document, sizeof(document));
+	CHECK(aJson.parse(text, exact) != NULL && exact.used() == used);
+	CHECK(allocations == start);
+}
+
+int main()
+{
+	sameTree();
+	streams();
+	longStrings();
+	failures();
+
+	return testResult();
+}
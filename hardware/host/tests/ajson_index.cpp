@@ -0,0 +1,223 @@
+/*
+ ************************************************************************
+ *	ajson_index.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	aJson lookup indexes: lookups in large objects and arrays give what a
+ *	walk of the list gives, duplicate and differently cased names included,
+ *	the index is built once and follows every change made through the
+ *	API, one left behind by a change made by hand is noticed, and trees in
+ *	an arena are never indexed. Heap calls are counted by wrapping the C
+ *	library's allocator.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aJSON.h"
+#include "HostTest.h"
+
+static unsigned long allocations;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_calloc(size_t count, size_t size);
+
+void *malloc(size_t size)
+{
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+
+// The compiler turns malloc() and memset() into calloc()
+void *calloc(size_t count, size_t size)
+{
+	allocations++;
+	return __libc_calloc(count, size);
+}
+}
+
+// An object of count items named "key<n>" with the value n
+static char *objectText(int count)
+{
+	char *doc = (char *)malloc(16 + count * 20);
+	int n = sprintf(doc, "{");
+
+	for (int i = 0; i < count; i++)
+		n += sprintf(doc + n, "%s\"key%d\":%d", i ? "," : "", i, i);
+	strcpy(doc + n, "}");
+	return doc;
+}
+
+static aJsonObject *walk(aJsonObject *c, const char *name)
+{
+	while (c && strcasecmp(c->name, name))
+		c = c->next;
+	return c;
+}
+
+static void objects(void)
+{
+	char *doc = objectText(300);
+	aJsonObject *root = aJson.parse(doc);
+	char name[16];
+	bool same = true;
+
+	CHECK(aJson.getArraySize(root) == 300);
+	unsigned long start = allocations;
+	for (int i = 0; i < 310; i++) {
+		sprintf(name, i & 1 ? "KEY%d" : "key%d", i);
+		same &= aJson.getObjectItem(root, name) == walk(root->child, name);
+	}
+	CHECK(same && aJson.getObjectItem(root, "key299")->valueint == 299);
+	CHECK(aJson.getObjectItem(root, "key") == NULL);
+	// One index, made by the first lookup that walked far enough
+	CHECK(allocations == start + 1);
+
+	// Through the API the index follows every change
+	aJson.addNumberToObject(root, "late", 7);
+	CHECK(aJson.getObjectItem(root, "LATE")->valueint == 7);
+	aJson.deleteItemFromObject(root, "key150");
+	CHECK(aJson.getObjectItem(root, "key150") == NULL);
+	CHECK(aJson.getObjectItem(root, "key151")->valueint == 151);
+	aJson.replaceItemInObject(root, "key0", aJson.createItem("zero"));
+	CHECK(strcmp(aJson.getObjectItem(root, "key0")->valuestring, "zero") == 0);
+	CHECK(root->child->valuestring == aJson.getObjectItem(root, "key0")->valuestring);
+	aJsonObject *item = aJson.detachItemFromObject(root, "key299");
+	CHECK(item && item->valueint == 299 && !aJson.getObjectItem(root, "key299"));
+	aJson.deleteItem(item);
+	CHECK(aJson.getArraySize(root) == 299);
+
+	// The first of two items with the same name is found, as before
+	aJson.addNumberToObject(root, "Key10", -10);
+	CHECK(aJson.getObjectItem(root, "key10")->valueint == 10);
+	aJson.deleteItemFromObject(root, "key10");
+	CHECK(aJson.getObjectItem(root, "key10")->valueint == -10);
+
+	// Items linked in by hand, then dropIndex()
+	aJsonObject *last = aJson.getArrayItem(root, aJson.getArraySize(root) - 1);
+	aJsonObject *extra = aJson.createItem(1);
+	extra->name = strdup("extra");
+	last->next = extra;
+	extra->prev = last;
+	CHECK(aJson.getObjectItem(root, "extra") == extra);
+	aJsonObject *front = aJson.createItem(2);
+	front->name = strdup("front");
+	front->next = root->child;
+	root->child->prev = front;
+	root->child = front;
+	CHECK(aJson.getObjectItem(root, "front") == front);
+	aJsonObject *middle = aJson.getObjectItem(root, "key100");
+	middle->prev->next = middle->next;
+	middle->next->prev = middle->prev;
+	middle->next = middle->prev = NULL;
+	aJson.dropIndex(root);
+	CHECK(aJson.getObjectItem(root, "key100") == NULL);
+	aJson.deleteItem(middle);
+
+	aJson.deleteItem(root);
+	free(doc);
+}
+
+static void arrays(void)
+{
+	aJsonObject *array = aJson.createArray();
+	bool same = true;
+
+	// More items than the old unsigned char sizes could count
+	for (int i = 0; i < 1000; i++)
+		aJson.addItemToArray(array, aJson.createItem(i));
+	unsigned long start = allocations;
+	// Counting alone builds nothing
+	CHECK(aJson.getArraySize(array) == 1000);
+	CHECK(allocations == start);
+	for (unsigned int i = 0; i < aJson.getArraySize(array); i++)
+		same &= aJson.getArrayItem(array, i)->valueint == (int)i;
+	CHECK(same && aJson.getArrayItem(array, 1000) == NULL);
+	CHECK(allocations == start + 1);
+
+	aJson.deleteItemFromArray(array, 500);
+	CHECK(aJson.getArraySize(array) == 999);
+	CHECK(aJson.getArrayItem(array, 500)->valueint == 501);
+	aJson.replaceItemInArray(array, 0, aJson.createItem(-1));
+	CHECK(aJson.getArrayItem(array, 0)->valueint == -1);
+	aJson.addItemToArray(array, aJson.createItem(1000));
+	CHECK(aJson.getArrayItem(array, 999)->valueint == 1000);
+	aJsonObject *item = aJson.detachItemFromArray(array, 998);
+	CHECK(item->valueint == 999 && aJson.getArraySize(array) == 999);
+	aJson.deleteItem(item);
+
+	// A reference has an index of its own
+	aJsonObject *holder = aJson.createArray();
+	aJson.addItemReferenceToArray(holder, array);
+	aJsonObject *ref = aJson.getArrayItem(holder, 0);
+	CHECK(aJson.getArrayItem(ref, 998)->valueint == 1000);
+	aJson.deleteItem(holder);
+	CHECK(aJson.getArrayItem(array, 998)->valueint == 1000);
+
+	// Small arrays are only ever walked
+	aJsonObject *small = aJson.createArray();
+	for (int i = 0; i < aJson_INDEX_MIN - 1; i++)
+		aJson.addItemToArray(small, aJson.createItem(i));
+	start = allocations;
+	CHECK(aJson.getArraySize(small) == aJson_INDEX_MIN - 1);
+	CHECK(aJson.getArrayItem(small, aJson_INDEX_MIN - 2)->valueint ==
+			aJson_INDEX_MIN - 2);
+	CHECK(allocations == start);
+
+	aJson.deleteItem(small);
+	aJson.deleteItem(array);
+}
+
+static void arenas(void)
+{
+	static char memory[32768];
+	aJsonArena arena(memory, sizeof(memory));
+	char *doc = objectText(500);
+	char name[16];
+	bool found = true;
+
+	aJsonObject *root = aJson.parse(doc, arena);
+	unsigned long start = allocations;
+	CHECK(root && aJson.getArraySize(root) == 500);
+	for (int i = 0; i < 500; i++) {
+		sprintf(name, "key%d", i);
+		found &= aJson.getObjectItem(root, name)->valueint == i;
+	}
+	CHECK(found && allocations == start);
+	arena.reset();
+	free(doc);
+}
+
+int main()
+{
+	objects();
+	arrays();
+	arenas();
+
+	return testResult();
+}
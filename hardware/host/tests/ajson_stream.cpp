@@ -0,0 +1,430 @@
+/*
+ ************************************************************************
+ *	ajson_stream.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	aJsonPullParser: the events and paths of a document, string escapes,
+ *	strings, keys and paths that do not fit, nesting limits, malformed
+ *	input, and path patterns. Then M2XStreamClient::listStreamValues
+ *	reads a 6 MB reply from a simulated server through a callback,
+ *	without a single heap call. Heap calls are counted by wrapping the C
+ *	library's allocator.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aJSON.h"
+#include "M2XStreamClient.h"
+#include "HostTest.h"
+
+static unsigned long allocations;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_calloc(size_t count, size_t size);
+
+void *malloc(size_t size)
+{
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	allocations++;
+	return __libc_calloc(count, size);
+}
+}
+
+// One line per event: its name, path and the key or value
+static void trace(char *out, size_t size, char *json)
+{
+	static const char *names[] = {
+		"end", "{", "}", "[", "]", "key", "value",
+	};
+	aJsonStringStream stream(json);
+	aJsonPullParser parser(&stream);
+	size_t len = 0;
+	int event;
+
+	out[0] = 0;
+	do {
+		event = parser.next();
+		const char *path = parser.path();
+		char detail[80] = "";
+
+		if (event == aJson_Key)
+			snprintf(detail, sizeof(detail), " %s", parser.key());
+		if (event == aJson_Value) {
+			aJsonObject *v = parser.value();
+
+			if (v->type == aJson_String)
+				snprintf(detail, sizeof(detail), " \"%s\"", v->valuestring);
+			else if (v->type == aJson_Int)
+				snprintf(detail, sizeof(detail), " %d", v->valueint);
+			else if (v->type == aJson_Float)
+				snprintf(detail, sizeof(detail), " %g", v->valuefloat);
+			else
+				snprintf(detail, sizeof(detail), " %s", v->type == aJson_NULL ?
+						"null" : v->type == aJson_True ? "true" : "false");
+		}
+		len += snprintf(out + len, size - len, "%s %s%s\n",
+				event == aJson_Error ? "error" : names[event],
+				path ? path : "(cut)", detail);
+	} while (event > aJson_End && len < size);
+}
+
+#define CHECK_TRACE(json, expected) do { \
+		char text[] = json; \
+		char out[1024]; \
+		trace(out, sizeof(out), text); \
+		CHECK(strcmp(out, expected) == 0); \
+		if (strcmp(out, expected)) \
+			fprintf(stderr, "%s\n---- expected\n%s\n", out, expected); \
+	} while (0)
+
+static void events(void)
+{
+	CHECK_TRACE("{\"a\":1, \"b\":[true,false,null,{\"c\":-2.5}], \"d\":{}, "
+			"\"e\":[], \"f\":\"x\"}",
+		"{ \n"
+		"key a a\n"
+		"value a 1\n"
+		"key b b\n"
+		"[ b\n"
+		"value b[0] true\n"
+		"value b[1] false\n"
+		"value b[2] null\n"
+		"{ b[3]\n"
+		"key b[3].c c\n"
+		"value b[3].c -2.5\n"
+		"} b[3]\n"
+		"] b\n"
+		"key d d\n"
+		"{ d\n"
+		"} d\n"
+		"key e e\n"
+		"[ e\n"
+		"] e\n"
+		"key f f\n"
+		"value f \"x\"\n"
+		"} \n"
+		"end \n");
+	CHECK_TRACE("[[1,[2]],[]]",
+		"[ \n"
+		"[ [0]\n"
+		"value [0][0] 1\n"
+		"[ [0][1]\n"
+		"value [0][1][0] 2\n"
+		"] [0][1]\n"
+		"] [0]\n"
+		"[ [1]\n"
+		"] [1]\n"
+		"] \n"
+		"end \n");
+	CHECK_TRACE("  42 ", "value  42\nend \n");
+	CHECK_TRACE("\"a\\\"b\\\\c\\/\\n\\u0041\\u00e9\\u20ac\"",
+		"value  \"a\"b\\c/\nA\xc3\xa9\xe2\x82\xac\"\nend \n");
+}
+
+static void limits(void)
+{
+	char text[4096];
+	char out[4096];
+
+	// Strings keep whole characters up to aJson_TEXT_SIZE - 1 bytes
+	strcpy(text, "[\"");
+	for (int i = 0; i < 40; i++)
+		strcat(text, "\\u00e9");
+	strcat(text, "\", 1]");
+	aJsonStringStream stream(text);
+	aJsonPullParser parser(&stream);
+	CHECK(parser.next() == aJson_StartArray && parser.next() == aJson_Value);
+	CHECK(strlen(parser.value()->valuestring) == 62);
+	CHECK(parser.next() == aJson_Value && parser.value()->valueint == 1);
+
+	// A key too long for the path cuts it until the next member
+	char key[63];
+	memset(key, 'k', 62);
+	key[62] = 0;
+	snprintf(text, sizeof(text), "{\"a\":{\"%s\":{\"x\":1},\"b\":2}}", key);
+	snprintf(out, sizeof(out), "{ \nkey a a\n{ a\nkey (cut) %s\n{ (cut)\n"
+			"key (cut) x\nvalue (cut) 1\n} (cut)\nkey a.b b\nvalue a.b 2\n"
+			"} a\n} \nend \n", key);
+	char result[4096];
+	trace(result, sizeof(result), text);
+	CHECK(strcmp(result, out) == 0);
+
+	// aJson_MAX_DEPTH levels, and not one more
+	memset(text, '[', aJson_MAX_DEPTH);
+	memset(text + aJson_MAX_DEPTH, ']', aJson_MAX_DEPTH);
+	text[2 * aJson_MAX_DEPTH] = 0;
+	aJsonStringStream deep(text);
+	aJsonPullParser deepParser(&deep);
+	int events = 0, event;
+	while ((event = deepParser.next()) > aJson_End)
+		events++;
+	CHECK(event == aJson_End && events == 2 * aJson_MAX_DEPTH);
+
+	memset(text, '[', aJson_MAX_DEPTH + 1);
+	memset(text + aJson_MAX_DEPTH + 1, ']', aJson_MAX_DEPTH + 1);
+	text[2 * aJson_MAX_DEPTH + 2] = 0;
+	aJsonStringStream deeper(text);
+	aJsonPullParser deeperParser(&deeper);
+	while ((event = deeperParser.next()) > aJson_End)
+		;
+	CHECK(event == aJson_Error && deeperParser.next() == aJson_Error);
+}
+
+static bool fails(const char *json)
+{
+	char text[64];
+	strcpy(text, json);
+	aJsonStringStream stream(text);
+	aJsonPullParser parser(&stream);
+	int event;
+
+	while ((event = parser.next()) > aJson_End)
+		;
+	return event == aJson_Error && parser.next() == aJson_Error &&
+			!parser.complete();
+}
+
+static void malformed(void)
+{
+	CHECK(fails("{\"a\":1,}"));
+	CHECK(fails("[1,]"));
+	CHECK(fails("{\"a\" 1}"));
+	CHECK(fails("[1 2]"));
+	CHECK(fails("{\"a\":[1}"));
+	CHECK(fails("{a:1}"));
+	CHECK(fails("[tru]"));
+	CHECK(fails("{\"a\":[1,2"));
+	CHECK(fails("[\"\\u12x4\"]"));
+	CHECK(fails(""));
+}
+
+static bool matches(const char *json, int skip, const char *pattern)
+{
+	static char text[128];
+	strcpy(text, json);
+	aJsonStringStream stream(text);
+	aJsonPullParser parser(&stream);
+
+	while (skip-- > 0)
+		parser.next();
+	return parser.matches(pattern);
+}
+
+static void patterns(void)
+{
+	const char *doc = "{\"values\":[{\"at\":1,\"value\":2}]}";
+
+	// after the events up to values[0].value
+	CHECK(matches(doc, 7, "values[*].value"));
+	CHECK(matches(doc, 7, "values[0].value"));
+	CHECK(matches(doc, 7, "*[*].*"));
+	CHECK(matches(doc, 7, "values[*].val*"));
+	CHECK(!matches(doc, 7, "values[1].value"));
+	CHECK(!matches(doc, 7, "values[*]"));
+	CHECK(!matches(doc, 7, "*.value"));
+	CHECK(!matches(doc, 7, "values.value"));
+	CHECK(matches(doc, 4, "values[*]"));
+	CHECK(matches(doc, 1, ""));
+}
+
+//
+// An M2X server with a long list of values for one stream
+//
+#define VALUES 100000
+
+class M2XServer : public Client
+{
+	public:
+		char request[512];
+		size_t requestLen;
+		long produced, bytes;
+		bool open;
+
+		M2XServer() : requestLen(0), produced(-1), bytes(0), open(false) {}
+
+		virtual int connect(IPAddress ip, uint16_t port) { return 0; }
+		virtual int connect(const char *host, uint16_t port)
+		{
+			open = true;
+			produced = -1;
+			chunkLen = chunkPos = 0;
+			return 1;
+		}
+		virtual size_t write(uint8_t c) { return write(&c, 1); }
+		virtual size_t write(const uint8_t *buf, size_t size)
+		{
+			if (size > sizeof(request) - 1 - requestLen)
+				size = sizeof(request) - 1 - requestLen;
+			memcpy(request + requestLen, buf, size);
+			requestLen += size;
+			request[requestLen] = 0;
+			return size;
+		}
+		virtual int available() { return refill() ? chunkLen - chunkPos : 0; }
+		virtual int read()
+		{
+			if (!refill())
+				return -1;
+			bytes++;
+			return (uint8_t)chunk[chunkPos++];
+		}
+		virtual int read(uint8_t *buf, size_t size) { return -1; }
+		virtual int peek() { return refill() ? chunk[chunkPos] : -1; }
+		virtual void flush() {}
+		virtual void stop() { open = false; }
+		virtual uint8_t connected() { return open && refill(); }
+		virtual operator bool() { return open; }
+
+	private:
+		char chunk[256];
+		int chunkLen, chunkPos;
+
+		// The reply is made up a value at a time as it is read
+		bool refill()
+		{
+			if (chunkPos < chunkLen)
+				return true;
+			if (!open || produced > VALUES)
+				return false;
+			chunkPos = 0;
+			if (produced < 0)
+				chunkLen = sprintf(chunk, "HTTP/1.0 200 OK\r\n"
+						"Content-Type: application/json\r\n\r\n"
+						"{\"limit\":%d,\"end\":\"2014-09-10T00:00:00.000Z\",\"values\":[",
+						VALUES);
+			else if (produced == VALUES)
+				chunkLen = sprintf(chunk, "]}");
+			else
+				chunkLen = valueText(chunk, produced);
+			produced++;
+			return true;
+		}
+
+		int valueText(char *out, long i)
+		{
+			char at[32], value[32];
+			int n = 0;
+
+			timestamp(at, i);
+			switch (i % 3) {
+			case 0: sprintf(value, "%ld", i); break;
+			case 1: sprintf(value, "%ld.5", i); break;
+			case 2: sprintf(value, "\"s%ld\"", i); break;
+			}
+			if (i)
+				out[n++] = ',';
+			// Some with the value first, some with more in them
+			if (i % 4 == 1)
+				n += sprintf(out + n, "{\"value\":%s, \"timestamp\":\"%s\"}",
+						value, at);
+			else if (i % 4 == 2)
+				n += sprintf(out + n, "{\"timestamp\":\"%s\",\"meta\":{\"value\":[1,"
+						"{\"timestamp\":0}]},\"value\":%s}", at, value);
+			else
+				n += sprintf(out + n, "{\"timestamp\":\"%s\",\"value\":%s}",
+						at, value);
+			return n;
+		}
+
+	public:
+		static void timestamp(char *out, long i)
+		{
+			sprintf(out, "2014-09-%02ldT%02ld:%02ld:%02ld.000Z", 1 + i / 86400,
+					i / 3600 % 24, i / 60 % 60, i % 60);
+		}
+};
+
+struct Received {
+	long count;
+	long bad;
+};
+
+static void onValue(const char *at, aJsonObject *value, int index,
+		void *context)
+{
+	Received *received = (Received *)context;
+	char expected[32];
+	bool good;
+
+	M2XServer::timestamp(expected, index);
+	good = index == received->count && strcmp(at, expected) == 0;
+	switch (index % 3) {
+	case 0:
+		good &= value->type == aJson_Int && value->valueint == index;
+		break;
+	case 1:
+		good &= value->type == aJson_Float &&
+				value->valuefloat == index + 0.5;
+		break;
+	case 2:
+		sprintf(expected, "s%d", index);
+		good &= value->type == aJson_String &&
+				strcmp(value->valuestring, expected) == 0;
+		break;
+	}
+	received->bad += !good;
+	received->count++;
+}
+
+static void m2x(void)
+{
+	M2XServer server;
+	M2XStreamClient m2x(&server, "key");
+	Received received = { 0, 0 };
+	unsigned long start = allocations;
+
+	int status = m2x.listStreamValues("dev 1", "temp", onValue, &received,
+			"limit=100000");
+	CHECK(status == 200);
+	CHECK(allocations == start);
+	CHECK(received.count == VALUES && received.bad == 0);
+	CHECK(server.bytes > 6000000 && !server.open);
+	CHECK(strncmp(server.request,
+			"GET /v2/devices/dev%201/streams/temp/values?limit=100000 HTTP/1.0",
+			64) == 0);
+	fprintf(stderr, "  %ld values, %ld bytes, parser state %zu bytes\n",
+			received.count, server.bytes, sizeof(aJsonPullParser));
+	CHECK(sizeof(aJsonPullParser) <= 384);
+}
+
+int main()
+{
+	events();
+	limits();
+	malformed();
+	patterns();
+	m2x();
+
+	return testResult();
+}
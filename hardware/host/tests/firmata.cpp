@@ -0,0 +1,338 @@
+/*
+ ************************************************************************
+ *	firmata.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Firmata's input: a recorded session handled a byte at a time with
+ *	processInput(), with processAvailable() and with processInput() on
+ *	runs of bytes split anywhere, the callbacks the same each way; the
+ *	values decoded, strings terminated, a Sysex message too long for the
+ *	buffer dropped with the messages after it still handled, and no data
+ *	left alone. Firmata's output: a message a write, and all of a report
+ *	in as few writes as the buffer allows.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Firmata.h"
+#include "FirmataLoopback.h"
+#include "HostTest.h"
+
+//
+// The callbacks, as a log of what they were given
+//
+static uint32_t events[8192];
+static size_t eventCount;
+static char lastString[64];
+
+static void event(uint8_t type, uint32_t a, uint32_t b)
+{
+	if (eventCount < sizeof(events) / sizeof(events[0]))
+		events[eventCount++] = (uint32_t)type << 24 ^ a << 16 ^ b;
+}
+
+static void analogCallback(byte pin, int value) { event(1, pin, value); }
+static void digitalCallback(byte port, int value) { event(2, port, value); }
+static void reportAnalogCallback(byte pin, int on) { event(3, pin, on); }
+static void reportDigitalCallback(byte port, int on) { event(4, port, on); }
+static void pinModeCallback(byte pin, int mode) { event(5, pin, mode); }
+
+static void stringCallback(char *s)
+{
+	strncpy(lastString, s, sizeof(lastString) - 1);
+	event(6, strlen(s), s[0]);
+}
+
+static void sysexCallback(byte command, byte argc, byte *argv)
+{
+	uint32_t sum = 0;
+
+	for (int i = 0; i < argc; i++)
+		sum = sum * 31 + argv[i];
+	event(7, command, argc);
+	event(8, 0, sum & 0xFFFF);
+}
+
+static void attach(FirmataClass &firmata)
+{
+	firmata.attach(ANALOG_MESSAGE, analogCallback);
+	firmata.attach(DIGITAL_MESSAGE, digitalCallback);
+	firmata.attach(REPORT_ANALOG, reportAnalogCallback);
+	firmata.attach(REPORT_DIGITAL, reportDigitalCallback);
+	firmata.attach(SET_PIN_MODE, pinModeCallback);
+	firmata.attach(STRING_DATA, stringCallback);
+	firmata.attach(START_SYSEX, sysexCallback);
+}
+
+static uint8_t session[65536];
+static size_t sessionLen;
+
+enum { BYTES, AVAILABLE, RUNS };
+
+// The session through a new FirmataClass, segment bytes arriving at a
+// time; the callbacks land in events and the replies in stream.sent
+static void run(FirmataLoopback &stream, int how, size_t segment)
+{
+	FirmataClass firmata;
+
+	attach(firmata);
+	firmata.setFirmwareNameAndVersion("tests/firmata.cpp", 2, 3);
+	firmata.begin(stream);
+	stream.clear();
+	stream.replay(session, sessionLen);
+	stream.segment = segment;
+	eventCount = 0;
+	switch (how) {
+	case BYTES:
+		while (firmata.available())
+			firmata.processInput();
+		break;
+	case AVAILABLE:
+		CHECK(firmata.processAvailable() == (int)sessionLen);
+		break;
+	case RUNS:
+		for (size_t pos = 0; pos < sessionLen; pos += segment) {
+			size_t n = sessionLen - pos < segment ? sessionLen - pos : segment;
+
+			firmata.processInput(session + pos, n);
+		}
+		stream.replay(0, 0);
+		break;
+	}
+	CHECK(stream.done());
+}
+
+static void sameEachWay(void)
+{
+	static uint32_t want[8192];
+	FirmataLoopback stream;
+	static const size_t segments[] = { 1, 2, 3, 7, 16, 64, 1000 };
+
+	sessionLen = firmataSession(session, sizeof(session), 500);
+	run(stream, BYTES, 1);
+	size_t wantCount = eventCount;
+	memcpy(want, events, sizeof(want));
+	uint8_t wantSent[256];
+	size_t wantSentLen = stream.sentLen;
+	memcpy(wantSent, stream.sent, sizeof(wantSent));
+
+	// the pin modes, report enables and 3 Sysex at the start, 3 messages
+	// and 2 Sysex a round, a string every 16 rounds and a sampling
+	// interval every 64; a Sysex is two events
+	CHECK(wantCount == 12 + 4 + 2 + 3 * 2 + 500 * (3 + 2 * 2) + 32 + 7 * 2);
+	// REPORT_VERSION and REPORT_FIRMWARE answered
+	CHECK(wantSentLen > 3 && wantSent[0] == REPORT_VERSION &&
+			wantSent[3] == START_SYSEX && wantSent[4] == REPORT_FIRMWARE);
+
+	for (int how = BYTES; how <= RUNS; how++) {
+		for (size_t i = 0; i < sizeof(segments) / sizeof(segments[0]); i++) {
+			run(stream, how, segments[i]);
+			CHECK(eventCount == wantCount);
+			CHECK(memcmp(events, want, wantCount * sizeof(want[0])) == 0);
+			CHECK(stream.sentLen == wantSentLen);
+			CHECK(memcmp(stream.sent, wantSent, wantSentLen) == 0);
+		}
+	}
+
+	// processAvailable() reads each byte once, and only those there are
+	run(stream, AVAILABLE, 64);
+	CHECK(stream.reads == sessionLen);
+}
+
+static void values(void)
+{
+	FirmataClass firmata;
+	static const uint8_t input[] = {
+		ANALOG_MESSAGE | 3, 0x7F, 0x01,
+		DIGITAL_MESSAGE | 1, 0x05, 0x01,
+		SET_PIN_MODE, 13, PWM,
+		REPORT_ANALOG | 2, 1,
+		REPORT_DIGITAL | 1, 0,
+		// a stray data byte, and a message cut short by another
+		0x55, ANALOG_MESSAGE | 4, 0x10, REPORT_ANALOG | 5, 0,
+	};
+
+	attach(firmata);
+	eventCount = 0;
+	firmata.processInput(input, sizeof(input));
+	CHECK(eventCount == 6);
+	CHECK(events[0] == (1u << 24 ^ 3 << 16 ^ 255));
+	CHECK(events[1] == (2u << 24 ^ 1 << 16 ^ 133));
+	CHECK(events[2] == (5u << 24 ^ 13 << 16 ^ PWM));
+	CHECK(events[3] == (3u << 24 ^ 2 << 16 ^ 1));
+	CHECK(events[4] == (4u << 24 ^ 1 << 16 ^ 0));
+	CHECK(events[5] == (3u << 24 ^ 5 << 16 ^ 0));
+}
+
+static void sysex(void)
+{
+	FirmataClass firmata;
+	uint8_t input[128], *p;
+
+	attach(firmata);
+
+	// a command and 31 bytes fit, one more does not
+	for (int extra = 0; extra <= 1; extra++) {
+		p = input;
+		*p++ = START_SYSEX;
+		*p++ = SERVO_CONFIG;
+		for (int i = 0; i < MAX_DATA_BYTES - 1 + extra; i++)
+			*p++ = i;
+		*p++ = END_SYSEX;
+		*p++ = ANALOG_MESSAGE | 1;
+		p = firmataValue(p, 1000);
+		eventCount = 0;
+		firmata.processInput(input, p - input);
+		CHECK(eventCount == (extra ? 1u : 3u));
+		CHECK(events[eventCount - 1] == (1u << 24 ^ 1 << 16 ^ 1000));
+		if (!extra)
+			CHECK(events[0] == (7u << 24 ^ SERVO_CONFIG << 16 ^ (MAX_DATA_BYTES - 1)));
+	}
+
+	// far too long, a byte at a time
+	p = input;
+	*p++ = START_SYSEX;
+	*p++ = I2C_REQUEST;
+	for (int i = 0; i < 100; i++)
+		*p++ = i;
+	*p++ = END_SYSEX;
+	*p++ = START_SYSEX;
+	*p++ = REPORT_FIRMWARE + 1;
+	*p++ = END_SYSEX;
+	eventCount = 0;
+	for (uint8_t *q = input; q < p; q++)
+		firmata.processInput(q, 1);
+	CHECK(eventCount == 2 && events[0] == (7u << 24 ^ (REPORT_FIRMWARE + 1) << 16 ^ 0));
+
+	// an empty one is ignored
+	input[0] = START_SYSEX;
+	input[1] = END_SYSEX;
+	eventCount = 0;
+	firmata.processInput(input, 2);
+	CHECK(eventCount == 0);
+}
+
+static void strings(void)
+{
+	FirmataClass firmata;
+	uint8_t input[64], *p;
+	const char *longest = "fifteen chars!!";
+
+	attach(firmata);
+	for (int n = 0; n < 2; n++) {
+		const char *s = n ? longest : "Energia";
+
+		p = input;
+		*p++ = START_SYSEX;
+		*p++ = STRING_DATA;
+		for (const char *c = s; *c; c++)
+			p = firmataValue(p, *c);
+		*p++ = END_SYSEX;
+		memset(lastString, 'x', sizeof(lastString));
+		lastString[sizeof(lastString) - 1] = 0;
+		firmata.processInput(input, p - input);
+		CHECK(strcmp(lastString, s) == 0);
+	}
+}
+
+// No data is no byte, and does not start a Sysex message
+static void noData(void)
+{
+	FirmataClass firmata;
+	FirmataLoopback stream;
+	static const uint8_t input[] = { ANALOG_MESSAGE | 1, 0x10, 0x00 };
+
+	attach(firmata);
+	firmata.begin(stream);
+	stream.replay(input, 0);
+	firmata.processInput();
+	CHECK(firmata.processAvailable() == 0);
+	stream.replay(input, sizeof(input));
+	eventCount = 0;
+	CHECK(firmata.processAvailable() == 3);
+	CHECK(eventCount == 1 && events[0] == (1u << 24 ^ 1 << 16 ^ 16));
+}
+
+static void reports(void)
+{
+	FirmataClass firmata;
+	FirmataLoopback stream;
+	uint8_t want[256], *p = want;
+
+	firmata.setFirmwareNameAndVersion("tests/firmata.cpp", 2, 3);
+	firmata.begin(stream);
+	// version and firmware name, a write each
+	CHECK(stream.writes == 2 && stream.written == 3 + 4 + 7 * 2 + 1);
+
+	// a message a write without a report
+	stream.clear();
+	for (int pin = 0; pin < 6; pin++)
+		firmata.sendAnalog(pin, pin * 100);
+	firmata.sendDigitalPort(1, 0x55);
+	CHECK(stream.writes == 7 && stream.written == 21);
+
+	// one write for the whole of it in one
+	stream.clear();
+	firmata.startReport();
+	for (int pin = 0; pin < 6; pin++) {
+		firmata.sendAnalog(pin, pin * 100);
+		*p++ = ANALOG_MESSAGE | pin;
+		p = firmataValue(p, pin * 100);
+	}
+	firmata.sendDigitalPort(1, 0x55);
+	*p++ = DIGITAL_MESSAGE | 1;
+	*p++ = 0x55;
+	*p++ = 0;
+	CHECK(stream.writes == 0);
+	firmata.endReport();
+	CHECK(stream.writes == 1 && stream.written == 21);
+	CHECK(stream.sentLen == 21 && memcmp(stream.sent, want, 21) == 0);
+
+	// a report longer than the buffer, in order and in as few writes
+	stream.clear();
+	p = want;
+	firmata.startReport();
+	for (int i = 0; i < 60; i++) {
+		firmata.sendAnalog(i & 0x0F, i * 50);
+		*p++ = ANALOG_MESSAGE | (i & 0x0F);
+		p = firmataValue(p, i * 50);
+	}
+	firmata.endReport();
+	CHECK(stream.written == 180);
+	CHECK(stream.writes == (180 + FIRMATA_REPORT_BYTES - 1) / FIRMATA_REPORT_BYTES);
+	CHECK(stream.sentLen == 180 && memcmp(stream.sent, want, 180) == 0);
+
+	// and back to a write a message after it
+	stream.clear();
+	firmata.sendAnalog(0, 1);
+	CHECK(stream.writes == 1);
+}
+
+int main()
+{
+	sameEachWay();
+	values();
+	sysex();
+	strings();
+	noData();
+	reports();
+
+	return testResult();
+}
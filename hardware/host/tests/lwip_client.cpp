@@ -0,0 +1,180 @@
+/*
+ ************************************************************************
+ *	lwip_client.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The lwIP EthernetClient of the TM4C129 boards against a peer on the
+ *	same stack, over an LwipLink: the address set up from the
+ *	flash user registers and begin(), a response read back through
+ *	read(), peek(), short and long read(buf)s and peekSegment() with
+ *	consume(), the window opened by no more than what was read, and a
+ *	long request written with write() and with writeNoCopy(), whose
+ *	buffer is acknowledged in full before unacked() comes back to 0.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "driverlib/flash.h"
+#include "Ethernet.h"
+#include "LwipLink.h"
+#include "LwipPeer.h"
+#include "HostTest.h"
+
+#define PORT 80
+
+static const IPAddress local(192, 168, 1, 177);
+static const IPAddress server(192, 168, 1, 1);
+static uint8_t body[20000];
+static uint8_t request[30000], received[30000];
+
+static uint8_t pattern(size_t i)
+{
+	return i * 7 + (i >> 8);
+}
+
+static void setup(LwipPeer &peer)
+{
+	uint8_t mac[6];
+
+	// 24/24 split, as the boards are programmed
+	FlashUserSet(0x1A0800, 0xEFBE28);
+	Ethernet.begin(local, IPAddress(192, 168, 1, 1), IPAddress(192, 168, 1, 1),
+			IPAddress(255, 255, 255, 0));
+	Ethernet.macAddress(mac);
+	CHECK(mac[0] == 0x00 && mac[2] == 0x1A && mac[3] == 0x28 && mac[5] == 0xEF);
+	CHECK(Ethernet.localIP() == local);
+	CHECK(Ethernet.subnetMask() == IPAddress(255, 255, 255, 0));
+	CHECK(Ethernet.gatewayIP() == IPAddress(192, 168, 1, 1));
+	CHECK(Ethernet.dnsServerIP() == IPAddress(192, 168, 1, 1));
+
+	for (size_t i = 0; i < sizeof(body); i++)
+		body[i] = pattern(i);
+	peer.begin();
+}
+
+// Waits for the client to have want bytes, or for the stack to settle
+static void settle(EthernetClient &client, int want)
+{
+	unsigned long start = millis();
+
+	while (client.available() < want && millis() - start < 50)
+		delay(1);
+}
+
+static void receive(LwipPeer &peer)
+{
+	EthernetClient client;
+	uint8_t buf[1500];
+	unsigned long start;
+	size_t got = 0;
+	bool ok = true;
+
+	peer.serve(body, sizeof(body));
+	CHECK(client.connect(server, PORT));
+	CHECK(client.connected());
+
+	// a byte at a time, with a peek between
+	settle(client, 100);
+	while (got < 100) {
+		int c = client.peek();
+
+		ok &= c == body[got];
+		ok &= client.read() == body[got];
+		got++;
+	}
+	CHECK(ok);
+
+	// the window only opens by what was read
+	settle(client, 0x7FFF);
+	CHECK(client.available() > 0 && client.available() <= TCP_WND);
+
+	// short and long reads and whole segments in place, as they come
+	while (got < sizeof(body) && client.connected()) {
+		const uint8_t *data;
+		int n = 0;
+
+		switch (got % 3) {
+		case 0:
+			n = client.read(buf, 5);
+			break;
+		case 1:
+			n = client.read(buf, sizeof(buf));
+			break;
+		case 2:
+			n = client.peekSegment(&data);
+			if (n > 0) {
+				memcpy(buf, data, n);
+				client.consume(n);
+			}
+			break;
+		}
+		if (n > 0) {
+			ok &= memcmp(buf, body + got, n) == 0;
+			got += n;
+		}
+	}
+	CHECK(ok && got == sizeof(body));
+	CHECK(client.read() == -1 && client.available() == 0);
+
+	// closed by the peer once the last of it is acknowledged
+	start = millis();
+	while (client.connected() && millis() - start < 1000)
+		delay(1);
+	CHECK(!client.connected());
+	client.stop();
+}
+
+static void transmit(LwipPeer &peer, bool copy)
+{
+	EthernetClient client;
+	unsigned long start;
+
+	peer.serve(0, 0);
+	peer.keep(received, sizeof(received));
+	for (size_t i = 0; i < sizeof(request); i++)
+		request[i] = pattern(i + copy);
+	CHECK(client.connect(server, PORT));
+	if (copy)
+		CHECK(client.write(request, sizeof(request)) == sizeof(request));
+	else
+		CHECK(client.writeNoCopy(request, sizeof(request)) == sizeof(request));
+
+	start = millis();
+	while (client.unacked() && millis() - start < 1000)
+		delay(1);
+	CHECK(client.unacked() == 0);
+	CHECK(peer.receivedLen == sizeof(request));
+	CHECK(memcmp(received, request, sizeof(request)) == 0);
+	client.stop();
+}
+
+int main()
+{
+	LwipLink link;
+	LwipPeer peer(PORT);
+
+	setup(peer);
+	receive(peer);
+	transmit(peer, true);
+	transmit(peer, false);
+	CHECK(peer.accepted == 3);
+	CHECK(link.drops == 0);
+
+	return testResult();
+}
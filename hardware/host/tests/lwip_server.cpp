@@ -0,0 +1,126 @@
+/*
+ ************************************************************************
+ *	lwip_server.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The lwIP EthernetServer of the TM4C129 boards, with peers on the same
+ *	stack connecting to it over an LwipLink: a request read through the
+ *	client available() hands out, the reply written back reaching the
+ *	peer without waiting for a delayed acknowledgement, a write() to the
+ *	server going to every client, and a client gone from available()
+ *	once its peer closes.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "Ethernet.h"
+#include "LwipLink.h"
+#include "LwipPeer.h"
+#include "HostTest.h"
+
+#define PORT 23
+
+static const IPAddress local(192, 168, 1, 177);
+static const uint8_t request[] = "GET /status HTTP/1.1\r\n\r\n";
+static uint8_t reply[3000];
+static uint8_t received[2][sizeof(reply)];
+
+// Waits up to ms for cond
+#define WAIT(cond, ms) do { \
+	unsigned long start = millis(); \
+	while (!(cond) && millis() - start < (ms)) \
+		delay(1); \
+} while (0)
+
+static void exchange(EthernetServer &server, LwipPeer &peer)
+{
+	EthernetClient client;
+	uint8_t buf[sizeof(request)];
+	unsigned long start;
+
+	peer.serve(request, sizeof(request), false);
+	peer.keep(received[0], sizeof(received[0]));
+	CHECK(peer.connect(PORT));
+	WAIT(peer.connected, 100);
+	CHECK(peer.connected);
+
+	// the request, as the sketch would take it
+	WAIT((client = server.available()) && client.available() >= (int)sizeof(request), 100);
+	CHECK(client && client.available() == sizeof(request));
+	CHECK(client.read(buf, sizeof(buf)) == sizeof(buf));
+	CHECK(memcmp(buf, request, sizeof(request)) == 0);
+	CHECK(client.read() == -1);
+
+	// the reply is sent as it is written, not with the next delayed ACK
+	for (size_t i = 0; i < sizeof(reply); i++)
+		reply[i] = i * 13;
+	start = millis();
+	CHECK(client.write(reply, sizeof(reply)) == sizeof(reply));
+	WAIT(peer.receivedLen == sizeof(reply), 1000);
+	CHECK(peer.receivedLen == sizeof(reply));
+	CHECK(millis() - start < 100);
+	CHECK(memcmp(received[0], reply, sizeof(reply)) == 0);
+}
+
+static void broadcast(EthernetServer &server, LwipPeer &peer, LwipPeer &other)
+{
+	static const uint8_t news[] = "to all";
+
+	other.serve(0, 0, false);
+	other.keep(received[1], sizeof(received[1]));
+	CHECK(other.connect(PORT));
+	WAIT(other.connected, 100);
+	CHECK(other.connected);
+	delay(10);
+
+	peer.keep(received[0], sizeof(received[0]));
+	CHECK(server.write(news, sizeof(news)) == 2 * sizeof(news));
+	WAIT(peer.receivedLen == sizeof(news) && other.receivedLen == sizeof(news), 100);
+	CHECK(peer.receivedLen == sizeof(news) && other.receivedLen == sizeof(news));
+	CHECK(memcmp(received[0], news, sizeof(news)) == 0);
+	CHECK(memcmp(received[1], news, sizeof(news)) == 0);
+}
+
+static void hangUp(EthernetServer &server, LwipPeer &peer, LwipPeer &other)
+{
+	EthernetClient client;
+
+	peer.close();
+	other.close();
+	WAIT(!(client = server.available()), 100);
+	CHECK(!client);
+}
+
+int main()
+{
+	LwipLink link;
+	LwipPeer peer(0), other(0);
+	EthernetServer server(PORT);
+
+	Ethernet.begin(local, IPAddress(192, 168, 1, 1), IPAddress(192, 168, 1, 1),
+			IPAddress(255, 255, 255, 0));
+	server.begin();
+
+	exchange(server, peer);
+	broadcast(server, peer, other);
+	hangUp(server, peer, other);
+	CHECK(link.drops == 0);
+
+	return testResult();
+}
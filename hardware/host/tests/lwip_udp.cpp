@@ -0,0 +1,146 @@
+/*
+ ************************************************************************
+ *	lwip_udp.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The lwIP EthernetUDP of the TM4C129 boards against a peer on the same
+ *	stack echoing what it is sent, over an LwipLink: a datagram written
+ *	in pieces coming back whole, with the peer's address and port, a
+ *	burst of them coming back in order, and one longer than a pool
+ *	buffer read back with read(buf) and a byte at a time.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "Ethernet.h"
+#include "EthernetUdp.h"
+#include "LwipLink.h"
+#include "LwipPeer.h"
+#include "HostTest.h"
+
+#define LOCAL_PORT 8888
+#define ECHO_PORT 7
+#define BURST 10
+
+static const IPAddress local(192, 168, 1, 177);
+static const IPAddress server(192, 168, 1, 1);
+
+// Waits up to 100 ms for a datagram
+static int next(EthernetUDP &udp)
+{
+	unsigned long start = millis();
+	int len;
+
+	while (!(len = udp.parsePacket()) && millis() - start < 100)
+		delay(1);
+	return len;
+}
+
+static void pieces(EthernetUDP &udp)
+{
+	char buf[32];
+
+	CHECK(udp.beginPacket(server, ECHO_PORT));
+	udp.print("hello ");
+	udp.print(12345);
+	udp.write('!');
+	CHECK(udp.endPacket());
+
+	CHECK(next(udp) == 12);
+	CHECK(udp.remoteIP() == server);
+	CHECK(udp.remotePort() == ECHO_PORT);
+	CHECK(udp.destIP() == local);
+	CHECK(udp.peek() == 'h');
+	CHECK(udp.read(buf, sizeof(buf)) == 12);
+	CHECK(memcmp(buf, "hello 12345!", 12) == 0);
+	CHECK(udp.available() == 0);
+}
+
+static void burst(EthernetUDP &udp)
+{
+	bool ok = true;
+
+	for (uint8_t i = 0; i < BURST; i++) {
+		udp.beginPacket(server, ECHO_PORT);
+		for (uint8_t j = 0; j <= i; j++)
+			udp.write(i);
+		ok &= udp.endPacket();
+	}
+	CHECK(ok);
+	for (uint8_t i = 0; i < BURST; i++) {
+		ok &= next(udp) == i + 1;
+		while (udp.available())
+			ok &= udp.read() == i;
+	}
+	CHECK(ok);
+	CHECK(udp.parsePacket() == 0);
+}
+
+static void chained(EthernetUDP &udp)
+{
+	uint8_t data[1400], buf[sizeof(data)];
+	bool ok = true;
+
+	for (size_t i = 0; i < sizeof(data); i++)
+		data[i] = i * 7;
+	udp.beginPacket(server, ECHO_PORT);
+	CHECK(udp.write(data, 700) == 700);
+	CHECK(udp.write(data + 700, 700) == 700);
+	CHECK(udp.endPacket());
+
+	CHECK(next(udp) == sizeof(data));
+	CHECK(udp.read(buf, 600) == 600);
+	for (size_t i = 600; i < sizeof(data); i++)
+		buf[i] = udp.read();
+	CHECK(memcmp(buf, data, sizeof(data)) == 0);
+	CHECK(udp.read() == -1);
+
+	// what is left of one is dropped by the next
+	udp.beginPacket(server, ECHO_PORT);
+	udp.write(data, sizeof(data));
+	udp.endPacket();
+	udp.beginPacket(server, ECHO_PORT);
+	udp.write(data, 3);
+	udp.endPacket();
+	CHECK(next(udp) == sizeof(data));
+	udp.read();
+	CHECK(next(udp) == 3);
+	ok &= udp.read() == data[0];
+	CHECK(ok);
+}
+
+int main()
+{
+	LwipLink link;
+	LwipPeer peer(0);
+	EthernetUDP udp;
+
+	Ethernet.begin(local, server, server, IPAddress(255, 255, 255, 0));
+	peer.echo(ECHO_PORT);
+	CHECK(udp.begin(LOCAL_PORT));
+
+	pieces(udp);
+	burst(udp);
+	chained(udp);
+	CHECK(peer.datagrams == 1 + BURST + 3);
+	CHECK(link.drops == 0);
+	udp.stop();
+
+	return testResult();
+}
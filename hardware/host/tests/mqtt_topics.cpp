@@ -0,0 +1,205 @@
+/*
+ ************************************************************************
+ *	mqtt_topics.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	MQTT topic filter matching through the TopicTrie: exact levels, + and
+ *	# as the MQTT specification has them, $ topics, filters added more
+ *	than once, removal giving back every node, shared levels outliving the
+ *	filter that added them, and a full trie taking all of a filter or
+ *	none. Then MQTT::Client subscribing, receiving and unsubscribing over
+ *	a loopback network.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "MQTTLoopback.h"
+#include "HostTest.h"
+
+typedef MQTT::TopicTrie<8, 16> Trie;
+
+// Whether topic matches filter, alone in a trie
+static bool matches(const char *filter, const char *topic)
+{
+	Trie trie;
+	MQTTString name = MQTTString_initializer;
+	short slots[8];
+
+	name.cstring = (char *)topic;
+	return trie.add(filter) == 0 && trie.match(name, slots) == 1;
+}
+
+static void wildcards(void)
+{
+	CHECK(matches("a/b/c", "a/b/c"));
+	CHECK(!matches("a/b/c", "a/b"));
+	CHECK(!matches("a/b", "a/b/c"));
+	CHECK(!matches("a/b/c", "a/b/cd"));
+	CHECK(matches("a/+/c", "a/b/c"));
+	CHECK(matches("a/+/c", "a//c"));
+	CHECK(!matches("a/+/c", "a/b/d/c"));
+	CHECK(matches("+/+", "/x"));
+	CHECK(matches("+", "a"));
+	CHECK(!matches("+", "a/b"));
+	CHECK(matches("a/#", "a/b/c"));
+	CHECK(matches("a/#", "a"));
+	CHECK(matches("a/#", "a/"));
+	CHECK(!matches("a/#", "ab"));
+	CHECK(matches("#", "a/b"));
+	CHECK(matches("+/b/#", "x/b"));
+	CHECK(matches("", ""));
+	CHECK(matches("a/", "a/"));
+	CHECK(!matches("a/", "a"));
+	// Wildcards at the first level leave $ topics alone
+	CHECK(!matches("#", "$SYS/load"));
+	CHECK(!matches("+/load", "$SYS/load"));
+	CHECK(matches("$SYS/#", "$SYS/load"));
+	CHECK(matches("$SYS/+", "$SYS/load"));
+}
+
+static void slots(void)
+{
+	Trie trie;
+	MQTTString name = MQTTString_initializer;
+	short found[8];
+
+	CHECK(trie.add("home/+/temp") == 0);
+	CHECK(trie.add("home/#") == 1);
+	CHECK(trie.add("home/kitchen/temp") == 2);
+	CHECK(trie.add("home/+/temp") == 3);
+
+	// A received topic is a length and data, not terminated
+	char packet[] = "home/kitchen/tempXYZ";
+	name.lenstring.data = packet;
+	name.lenstring.len = 17;
+	int count = trie.match(name, found);
+	CHECK(count == 4);
+	bool seen[4] = { false, false, false, false };
+	for (int i = 0; i < count; i++)
+		seen[found[i]] = true;
+	CHECK(seen[0] && seen[1] && seen[2] && seen[3]);
+
+	// One removal per call, the same text will do
+	char copy[] = "home/+/temp";
+	CHECK(trie.remove(copy) == 0);
+	CHECK(trie.match(name, found) == 3);
+	CHECK(trie.remove(copy) == 3);
+	CHECK(trie.remove(copy) == -1);
+	CHECK(trie.remove("home/kitchen") == -1);
+	CHECK(trie.match(name, found) == 2 && trie.filter(0) == 0);
+	CHECK(trie.add("x") == 0);
+}
+
+static void nodes(void)
+{
+	// 16 nodes: the root and 15 levels
+	Trie trie;
+	MQTTString name = MQTTString_initializer;
+	short found[8];
+
+	// A level added by a filter that is then removed and overwritten
+	char first[] = "shared/level/one";
+	CHECK(trie.add(first) == 0);
+	CHECK(trie.add("shared/level/two") == 1);
+	CHECK(trie.remove(first) == 0);
+	memset(first, 'x', sizeof(first) - 1);
+	name.cstring = (char *)"shared/level/two";
+	CHECK(trie.match(name, found) == 1 && found[0] == 1);
+	CHECK(trie.remove("shared/level/two") == 1);
+
+	// Removing everything gives back every node
+	for (int round = 0; round < 3; round++) {
+		CHECK(trie.add("a/b/c/d/e/f/g/h") == 0);
+		CHECK(trie.add("a/b/c/d/x/y/z/+") == 1);
+		CHECK(trie.add("p/q/r/s") == -1);
+		CHECK(trie.add("a/b/c/d/e/f/g/h/#") == 2);
+		CHECK(trie.remove("a/b/c/d/e/f/g/h") == 0);
+		CHECK(trie.remove("a/b/c/d/x/y/z/+") == 1);
+		CHECK(trie.remove("a/b/c/d/e/f/g/h/#") == 2);
+	}
+	// A filter that does not fit leaves nothing behind
+	CHECK(trie.add("1/2/3/4/5/6/7/8/9/10/11/12/13/14/15/16") == -1);
+	CHECK(trie.add("1/2/3/4/5/6/7/8/9/10/11/12/13/14/15") == 0);
+	name.cstring = (char *)"1/2/3/4/5/6/7/8/9/10/11/12/13/14/15";
+	CHECK(trie.match(name, found) == 1);
+}
+
+static int received[3];
+
+static void onKitchen(MQTT::MessageData &md)
+{
+	received[0]++;
+}
+
+static void onHome(MQTT::MessageData &md)
+{
+	received[1]++;
+}
+
+static void onOther(MQTT::MessageData &md)
+{
+	received[2]++;
+}
+
+static size_t publish(unsigned char *buf, const char *topic)
+{
+	MQTTString name = MQTTString_initializer;
+
+	name.cstring = (char *)topic;
+	return MQTTSerialize_publish(buf, 64, 0, 0, 0, 0, name,
+			(unsigned char *)"21.5", 4);
+}
+
+static void client(void)
+{
+	MQTTLoopback network;
+	MQTT::Client<MQTTLoopback, MQTTLoopbackTimer, 128, 4> client(network);
+	MQTTPacket_connectData options = MQTTPacket_connectData_initializer;
+	unsigned char packets[256];
+	size_t len = 0;
+
+	options.keepAliveInterval = 0;
+	CHECK(client.connect(options) == 0);
+	CHECK(client.subscribe("home/kitchen/temp", MQTT::QOS0, onKitchen) == 0);
+	CHECK(client.subscribe("home/#", MQTT::QOS0, onHome) == 0);
+	client.setDefaultMessageHandler(onOther);
+
+	len += publish(packets + len, "home/kitchen/temp");
+	len += publish(packets + len, "home/hall/temp");
+	len += publish(packets + len, "garden/temp");
+	network.replay(packets, len);
+	client.yield();
+	CHECK(received[0] == 1 && received[1] == 2 && received[2] == 1);
+
+	CHECK(client.unsubscribe("home/#") == 0);
+	network.replay(packets, len);
+	client.yield();
+	CHECK(received[0] == 2 && received[1] == 2 && received[2] == 3);
+}
+
+int main()
+{
+	wildcards();
+	slots();
+	nodes();
+	client();
+
+	return testResult();
+}
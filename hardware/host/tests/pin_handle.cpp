@@ -0,0 +1,188 @@
+/*
+ ************************************************************************
+ *	pin_handle.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	PinHandle: fastWrite(), fastRead() and fastToggle() reaching only
+ *	their pin, one register access each, and a handle for a pin that is
+ *	not one going nowhere. shiftOut() into a model of a 74HC595 and
+ *	shiftIn() from one of a 74HC165, both bit orders, with the data and
+ *	clock on one port and on two, and the register accesses a byte takes.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include "Energia.h"
+#include "HostTest.h"
+
+static uint32_t portOf(uint8_t pin)
+{
+	return port_to_base[digitalPinToPort(pin)];
+}
+
+//
+// A shift register on the pins: the '595 takes the data pin's level at
+// each rising clock edge, the '165 puts the next bit of its byte on the
+// data pin at each falling one
+//
+static uint8_t dataPin, clockPin;
+static uint8_t shifted, clocks;
+static uint8_t parallel, presented;
+
+static void present(void)
+{
+	uint8_t bit = digitalPinToBitMask(dataPin);
+
+	HostGPIOInputSet(portOf(dataPin), bit,
+			parallel >> (7 - presented) & 1 ? 0xFF : 0);
+}
+
+static void shiftRegister(uint32_t port, uint8_t before, uint8_t after)
+{
+	uint8_t clock = digitalPinToBitMask(clockPin);
+
+	if (port != portOf(clockPin) || !((before ^ after) & clock))
+		return;
+	if (after & clock) {
+		uint8_t data = HostGPIOOutputGet(portOf(dataPin)) &
+				digitalPinToBitMask(dataPin);
+
+		shifted = shifted << 1 | (data ? 1 : 0);
+		clocks++;
+	} else if (presented < 7) {
+		presented++;
+		present();
+	}
+}
+
+static void attach(uint8_t data, uint8_t clock, bool output)
+{
+	dataPin = data;
+	clockPin = clock;
+	pinMode(data, output ? OUTPUT : INPUT);
+	pinMode(clock, OUTPUT);
+	digitalWrite(clock, LOW);
+	shifted = clocks = 0;
+	HostGPIOSetWatch(shiftRegister);
+}
+
+static uint8_t reversed(uint8_t v)
+{
+	uint8_t r = 0;
+
+	for (int i = 0; i < 8; i++)
+		r |= (v >> i & 1) << (7 - i);
+	return r;
+}
+
+static void handles(void)
+{
+	PinHandle led = pinHandle(PB_5), other = pinHandle(PB_0);
+	PinHandle input = pinHandle(PA_5);
+	uint32_t portB = portOf(PB_5);
+
+	pinMode(PB_5, OUTPUT);
+	pinMode(PB_0, OUTPUT);
+	pinMode(PA_5, INPUT);
+	digitalWrite(PB_0, HIGH);
+
+	HostRegStatsReset();
+	fastWrite(led, HIGH);
+	CHECK(g_sHostRegStats.writes == 1 && g_sHostRegStats.reads == 0);
+	CHECK(HostGPIOOutputGet(portB) == (GPIO_PIN_5 | GPIO_PIN_0));
+	CHECK(fastRead(led) == HIGH && digitalRead(PB_5) == HIGH);
+	fastWrite(led, LOW);
+	CHECK(HostGPIOOutputGet(portB) == GPIO_PIN_0);
+	CHECK(fastRead(led) == LOW && fastRead(other) == HIGH);
+
+	HostRegStatsReset();
+	fastToggle(led);
+	CHECK(g_sHostRegStats.writes == 1 && g_sHostRegStats.reads == 1);
+	CHECK(HostGPIOOutputGet(portB) == (GPIO_PIN_5 | GPIO_PIN_0));
+	fastToggle(led);
+	fastToggle(other);
+	CHECK(HostGPIOOutputGet(portB) == 0);
+
+	// An input reads the pin, whatever was written
+	HostGPIOInputSet(portOf(PA_5), GPIO_PIN_5, 0xFF);
+	fastWrite(input, LOW);
+	CHECK(fastRead(input) == HIGH);
+	HostGPIOInputSet(portOf(PA_5), GPIO_PIN_5, 0);
+	CHECK(fastRead(input) == LOW && digitalRead(PA_5) == LOW);
+
+	// Pin 1 is 3.3V
+	PinHandle none = pinHandle(1);
+	HostRegStatsReset();
+	fastWrite(none, HIGH);
+	fastToggle(none);
+	CHECK(g_sHostRegStats.writes == 0 && HostGPIOOutputGet(portB) == 0);
+}
+
+static void shifting(uint8_t data, uint8_t clock)
+{
+	static const uint8_t values[] = { 0x00, 0xFF, 0x01, 0x80, 0x55, 0xC3 };
+	bool ok = true;
+
+	attach(data, clock, true);
+	for (size_t i = 0; i < sizeof(values); i++) {
+		shiftOut(data, clock, MSBFIRST, values[i]);
+		ok &= shifted == values[i];
+		shiftOut(data, clock, LSBFIRST, values[i]);
+		ok &= shifted == reversed(values[i]);
+	}
+	CHECK(ok && clocks == 16 * sizeof(values));
+	CHECK(digitalRead(clock) == LOW);
+
+	// the clock twice a bit, the data pin only when it changes
+	HostRegStatsReset();
+	shiftOut(data, clock, MSBFIRST, 0x00);
+	CHECK(g_sHostRegStats.writes == 17 && g_sHostRegStats.reads == 0);
+	HostRegStatsReset();
+	shiftOut(data, clock, MSBFIRST, 0x55);
+	CHECK(g_sHostRegStats.writes == 24);
+
+	attach(data, clock, false);
+	ok = true;
+	for (size_t i = 0; i < sizeof(values); i++) {
+		parallel = values[i];
+		presented = 0;
+		present();
+		ok &= shiftIn(data, clock, MSBFIRST) == values[i];
+		presented = 0;
+		present();
+		ok &= shiftIn(data, clock, LSBFIRST) == reversed(values[i]);
+	}
+	CHECK(ok);
+	HostRegStatsReset();
+	presented = 0;
+	present();
+	shiftIn(data, clock, MSBFIRST);
+	CHECK(g_sHostRegStats.writes == 16 && g_sHostRegStats.reads == 8);
+	HostGPIOSetWatch(0);
+}
+
+int main()
+{
+	handles();
+	// one port, then the data on port A and the clock on port B
+	shifting(PB_5, PB_0);
+	shifting(PA_5, PB_4);
+
+	return testResult();
+}
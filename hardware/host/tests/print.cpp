@@ -0,0 +1,249 @@
+/*
+ ************************************************************************
+ *	print.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	Print number formatting: integers in every base, floats checked digit
+ *	for digit against the C library on a million random values, down to
+ *	2^-80 and at every precision Print has, the rounding and overflow
+ *	corner cases, printf(), and that every number goes out in a single
+ *	write().
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "Print.h"
+#include "HostTest.h"
+
+// The most fraction digits Print gives a float
+#define FLOAT_DIGITS 20
+
+// Collects everything printed
+class StringPrint : public Print
+{
+	public:
+		char text[512];
+		size_t len;
+		unsigned int writes;
+
+		StringPrint() { reset(); }
+		void reset() { len = 0; writes = 0; text[0] = 0; }
+
+		virtual size_t write(uint8_t c) { return write(&c, 1); }
+		virtual size_t write(const uint8_t *buf, size_t size)
+		{
+			if (size > sizeof(text) - 1 - len)
+				size = sizeof(text) - 1 - len;
+			memcpy(text + len, buf, size);
+			len += size;
+			text[len] = 0;
+			writes++;
+			return size;
+		}
+};
+
+static StringPrint out;
+
+#define CHECK_PRINT(expr, expected) do { \
+		out.reset(); \
+		size_t n = out.expr; \
+		CHECK(strcmp(out.text, expected) == 0 && n == strlen(expected)); \
+		if (strcmp(out.text, expected)) \
+			fprintf(stderr, "  %s: \"%s\", expected \"%s\"\n", \
+					#expr, out.text, expected); \
+	} while (0)
+
+static uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t random64(void)
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 7;
+	rng ^= rng << 17;
+	return rng;
+}
+
+static void integers(void)
+{
+	char expected[80];
+
+	CHECK_PRINT(print(0), "0");
+	CHECK_PRINT(print(-1), "-1");
+	CHECK_PRINT(print(LONG_MIN), "-9223372036854775808");
+	CHECK_PRINT(print(4294967295UL), "4294967295");
+	CHECK_PRINT(print(255, HEX), "FF");
+	CHECK_PRINT(print(255, OCT), "377");
+	CHECK_PRINT(print(5, BIN), "101");
+	CHECK_PRINT(print(35, 36), "Z");
+	CHECK_PRINT(print(10, 1), "10");
+	CHECK_PRINT(print(-1, HEX), "FFFFFFFFFFFFFFFF");
+	CHECK_PRINT(print((unsigned char)200), "200");
+	CHECK_PRINT(print(65L, 0), "A");
+	CHECK_PRINT(println(12), "12\r\n");
+
+	for (int i = 0; i < 100000; i++) {
+		unsigned long u = random64() >> (random64() & 63);
+		long l = (long)u;
+
+		out.reset();
+		out.print(u);
+		snprintf(expected, sizeof(expected), "%lu", u);
+		if (strcmp(out.text, expected) || out.writes != 1)
+			break;
+		out.reset();
+		out.print(l);
+		snprintf(expected, sizeof(expected), "%ld", l);
+		if (strcmp(out.text, expected) || out.writes != 1)
+			break;
+		out.reset();
+		out.print(u, HEX);
+		snprintf(expected, sizeof(expected), "%lX", u);
+		if (strcmp(out.text, expected))
+			break;
+		out.reset();
+		out.print(u, 7);
+		if (strtoul(out.text, 0, 7) != u)
+			break;
+	}
+	CHECK(strcmp(out.text, expected) == 0 && out.writes == 1);
+}
+
+// Same digits as printf unless the value is an exact tie, which Print
+// rounds away from zero and printf to even
+static bool sameAsPrintf(double value, int digits, bool isFloat)
+{
+	char expected[80];
+
+	out.reset();
+	if (isFloat)
+		out.print((float)value, digits);
+	else
+		out.print(value, digits);
+	if (out.writes != 1)
+		return false;
+	if (fabs(value) >= 4294967296.0)
+		return strcmp(out.text, "ovf") == 0;
+	snprintf(expected, sizeof(expected), "%.*f", digits, value);
+	// Print drops the sign of a negative zero
+	if (value == 0 && expected[0] == '-')
+		memmove(expected, expected + 1, strlen(expected));
+	if (strcmp(out.text, expected) == 0)
+		return true;
+	// A tie: the exact expansion has a 5 right after the last digit
+	// printed and nothing beyond
+	char exact[1200];
+	char *dot;
+
+	snprintf(exact, sizeof(exact), "%.1100f", value);
+	dot = strchr(exact, '.');
+	return dot[digits + 1] == '5' &&
+			strspn(dot + digits + 2, "0") == strlen(dot + digits + 2);
+}
+
+static void floats(void)
+{
+	CHECK_PRINT(print(1.999, 2), "2.00");
+	CHECK_PRINT(print(3.14159), "3.14");
+	CHECK_PRINT(print(-3.14159, 4), "-3.1416");
+	CHECK_PRINT(print(2.5, 0), "3");
+	CHECK_PRINT(print(0.125, 2), "0.13");
+	CHECK_PRINT(print(-0.0), "0.00");
+	CHECK_PRINT(print(-0.001), "-0.00");
+	CHECK_PRINT(print(9.996, 2), "10.00");
+	CHECK_PRINT(print(999999999.9, 0), "1000000000");
+	CHECK_PRINT(print(4294967295.0, 1), "4294967295.0");
+	CHECK_PRINT(print(4294967296.0), "ovf");
+	CHECK_PRINT(print(1e300), "ovf");
+	CHECK_PRINT(print(NAN), "nan");
+	CHECK_PRINT(print(-INFINITY), "inf");
+	CHECK_PRINT(print(5e-324, 20), "0.00000000000000000000");
+	CHECK_PRINT(print(0.1, 20), "0.10000000000000000555");
+	CHECK_PRINT(print(0.1, 30), "0.10000000000000000555");
+	CHECK_PRINT(print(0.1f, 10), "0.1000000015");
+	CHECK_PRINT(print(16777217.0f, 1), "16777216.0");
+	CHECK_PRINT(print(0.0001234567891234567, 18), "0.000123456789123457");
+	CHECK_PRINT(println(1.5, 1), "1.5\r\n");
+
+	int bad = 0;
+	for (int i = 0; i < 1000000 && bad < 5; i++) {
+		uint64_t bits = random64();
+		int digits = random64() % (FLOAT_DIGITS + 1);
+		double value;
+
+		// Exponents from 2^-80 to 2^34, either sign
+		bits = (bits & 0x800fffffffffffffULL) |
+				(uint64_t)(1023 - 80 + random64() % 115) << 52;
+		memcpy(&value, &bits, sizeof(value));
+		if (!sameAsPrintf(value, digits, false) ||
+				!sameAsPrintf((float)value, digits, true)) {
+			fprintf(stderr, "  %.17g, %d digits: \"%s\"\n", value, digits,
+					out.text);
+			bad++;
+		}
+	}
+	CHECK(bad == 0);
+}
+
+static void formatted(void)
+{
+	CHECK_PRINT(printf("plain"), "plain");
+	CHECK_PRINT(printf("%d %i %u", -12, 34, 56u), "-12 34 56");
+	CHECK_PRINT(printf("%ld %lu", -1234567890L, 4000000000UL),
+			"-1234567890 4000000000");
+	CHECK_PRINT(printf("%x %X %o %lx", 255, 255, 8, 0xdeadbeefUL),
+			"ff FF 10 deadbeef");
+	CHECK_PRINT(printf("[%5d|%-5d|%05d|%+d|% d]", 42, 42, -42, 42, 42),
+			"[   42|42   |-0042|+42| 42]");
+	CHECK_PRINT(printf("[%.3d|%6.3d|%*d|%-*d]", 7, 7, 4, 1, 3, 2),
+			"[007|   007|   1|2  ]");
+	CHECK_PRINT(printf("%c%c%%", 'o', 'k'), "ok%");
+	CHECK_PRINT(printf("[%s|%8s|%-4s|%.2s]", "abc", "abc", "ab", "xyz"),
+			"[abc|     abc|ab  |xy]");
+	CHECK_PRINT(printf("%s", (const char *)0), "(null)");
+	CHECK_PRINT(printf("%f %.2f %.0f %F", 3.14159, -2.0051, 2.5, 1e-7),
+			"3.141590 -2.01 3 0.000000");
+	CHECK_PRINT(printf("[%8.3f|%-8.1f|%08.2f|%+.1f|%06f]", 3.14159, 2.25,
+			-1.5, 1.0, (double)NAN), "[   3.142|2.3     |-0001.50|+1.0|   nan]");
+	CHECK_PRINT(printf("%p", (void *)0x1234), "0x1234");
+	CHECK_PRINT(printf("%hd %hhu", 5, 6), "5 6");
+	// unsupported conversions still take their argument
+	CHECK_PRINT(printf("%e|%g|%lld|%Lf|%q|%s", 1.5, 2.5, 3LL,
+			(long double)4, "ok"), "%e|%g|%lld|%Lf|%q|ok");
+	CHECK_PRINT(printf("%.3G %llx %d", 1e300, 1LL << 40, 7), "%.3G %llx 7");
+
+	// Long output goes out in buffer sized chunks
+	out.reset();
+	CHECK(out.printf("%s%s", "0123456789012345678901234567890123456789",
+			"0123456789") == 50);
+	CHECK(out.len == 50 && out.writes == 2);
+	out.reset();
+	CHECK(out.printf("%d", 1) == 1 && out.writes == 1);
+}
+
+int main()
+{
+	integers();
+	floats();
+	formatted();
+
+	return testResult();
+}
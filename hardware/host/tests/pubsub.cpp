@@ -0,0 +1,288 @@
+/*
+ ************************************************************************
+ *	pubsub.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	PubSubClient receiving over a loopback Client: packets arriving a few
+ *	bytes at a time, poll() reading only what has arrived, QoS 1 and
+ *	multi-byte lengths, a PUBLISH too big for the buffer going to the
+ *	chunk callback or being dropped, oversized packets of other kinds
+ *	skipped, pings answered, and publishing from a callback, from the
+ *	chunk callback and while a packet is half in.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "PubSubLoopback.h"
+#include "HostTest.h"
+
+// What the callbacks were given, as "topic=payload;" for each message
+static char received[4096];
+static size_t receivedLen;
+static PubSubClient *echo;
+
+static void onMessage(char *topic, uint8_t *payload, unsigned int len)
+{
+	receivedLen += sprintf(received + receivedLen, "%s=", topic);
+	memcpy(received + receivedLen, payload, len);
+	receivedLen += len;
+	received[receivedLen++] = ';';
+	received[receivedLen] = 0;
+	if (echo)
+		echo->publish(topic, payload, len);
+}
+
+static uint8_t chunked[2048];
+static unsigned long chunkTotal, chunkNext, chunkCalls;
+static bool chunkInOrder;
+
+static void onChunk(char *topic, uint8_t *data, unsigned int len,
+		unsigned long offset, unsigned long total)
+{
+	chunkInOrder &= offset == chunkNext && offset + len <= total &&
+			strcmp(topic, "big/one") == 0;
+	memcpy(chunked + offset, data, len);
+	chunkNext = offset + len;
+	chunkTotal = total;
+	chunkCalls++;
+	if (echo)
+		echo->publish((char *)"piece", data, len > 16 ? 16 : len);
+}
+
+static void reset(void)
+{
+	receivedLen = 0;
+	received[0] = 0;
+	chunkTotal = chunkNext = chunkCalls = 0;
+	chunkInOrder = true;
+}
+
+static void connecting(void)
+{
+	PubSubLoopback net;
+	PubSubClient client((char *)"broker", 1883, onMessage, net);
+
+	CHECK(!client.poll());
+	CHECK(client.connect((char *)"energia"));
+	CHECK(net.sent[0] == MQTTCONNECT && client.connected());
+	CHECK(client.subscribe((char *)"a/b"));
+	// The packet id comes before the topic
+	CHECK(net.sent[0] == (MQTTSUBSCRIBE | MQTTQOS1) && net.sent[1] == 8);
+	CHECK(net.sent[2] == 0 && net.sent[3] == 2 && net.sent[5] == 3);
+	CHECK(client.poll());
+}
+
+// Messages of many sizes, whatever the segment size
+static void segments(void)
+{
+	static const size_t sizes[] = { 1, 2, 3, 7, 64, 1460 };
+	uint8_t stream[2048], payload[300];
+	char expect[4096];
+	size_t len = 0, expectLen = 0;
+
+	for (size_t i = 0; i < sizeof(payload); i++)
+		payload[i] = 'a' + i % 26;
+	for (int i = 0; i < 12; i++) {
+		char topic[16];
+		size_t n = i * 23 % 110;
+
+		sprintf(topic, "t/%d", i);
+		len += pubSubPacket(stream + len, topic, payload, n, i % 3 == 0);
+		expectLen += sprintf(expect + expectLen, "%s=%.*s;", topic, (int)n,
+				(char *)payload);
+	}
+	// Two length bytes, with a buffer big enough for it
+	len += pubSubPacket(stream + len, "long", payload, 300);
+	expectLen += sprintf(expect + expectLen, "long=%.*s;", 300, (char *)payload);
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		PubSubLoopback net;
+		PubSubClient client((char *)"broker", 1883, onMessage, net);
+		uint8_t big[512];
+		int polls = 0;
+
+		client.setBuffer(big, sizeof(big));
+		client.connect((char *)"energia");
+		reset();
+		net.segment = sizes[s];
+		net.replay(stream, len);
+		while (!net.done() && polls++ < 10000)
+			client.poll();
+		CHECK(receivedLen == expectLen && memcmp(received, expect, expectLen) == 0);
+		if (sizes[s] == 1460)
+			CHECK(polls == 1 && net.reads < 13 * 4);
+	}
+}
+
+static void nonBlocking(void)
+{
+	PubSubLoopback net;
+	PubSubClient client((char *)"broker", 1883, onMessage, net);
+	uint8_t stream[128], payload[128];
+	size_t len;
+
+	memset(payload, 'x', sizeof(payload));
+	len = pubSubPacket(stream, "slow", payload, 60);
+	client.connect((char *)"energia");
+	reset();
+	net.segment = 10;
+	net.replay(stream, len);
+
+	// Each poll() takes the one segment there is and returns: the header,
+	// the length and the start of the body, then more of the body
+	unsigned long reads = net.reads;
+	CHECK(client.poll() && net.reads == reads + 3 && receivedLen == 0);
+	CHECK(client.poll() && net.reads == reads + 4 && receivedLen == 0);
+
+	// Publishing meanwhile leaves the packet coming in alone
+	CHECK(client.publish((char *)"out", (char *)"hi"));
+	CHECK(net.sent[0] == MQTTPUBLISH && net.sent[1] == 7);
+	CHECK(memcmp(net.sent + 2, "\0\3outhi", 7) == 0);
+	for (int i = 0; i < 10; i++)
+		client.poll();
+	CHECK(net.done() && receivedLen == 66 && memcmp(received, "slow=xxxx", 9) == 0);
+
+	// There is no room for this one after the packet half in
+	net.replay(stream, len);
+	client.poll();
+	CHECK(!client.publish((char *)"out", payload, 115));
+	CHECK(client.publish((char *)"out", payload, 40));
+}
+
+static void oversized(void)
+{
+	PubSubLoopback net;
+	PubSubClient client((char *)"broker", 1883, onMessage, net);
+	static uint8_t stream[4096];
+	uint8_t payload[1500], junk[300];
+	size_t len = 0;
+
+	for (size_t i = 0; i < sizeof(payload); i++)
+		payload[i] = i * 7;
+	memset(junk, 0, sizeof(junk));
+	len += pubSubPacket(stream + len, "big/one", payload, 1500, true);
+	len += pubSubPacket(stream + len, "after", (uint8_t *)"1", 1);
+	// A SUBACK for many topics
+	stream[len++] = MQTTSUBACK;
+	stream[len++] = 0x80 | (200 % 128);
+	stream[len++] = 200 / 128;
+	memcpy(stream + len, junk, 200);
+	len += 200;
+	len += pubSubPacket(stream + len, "last", (uint8_t *)"2", 1);
+
+	client.connect((char *)"energia");
+	for (int withChunks = 0; withChunks < 2; withChunks++) {
+		reset();
+		if (withChunks)
+			client.setChunkCallback(onChunk);
+		net.segment = 333;
+		net.replay(stream, len);
+		while (!net.done())
+			client.poll();
+		CHECK(strcmp(received, "after=1;last=2;") == 0);
+		if (withChunks) {
+			// 128 bytes less the topic and its terminator at a time
+			CHECK(chunkTotal == 1500 && chunkInOrder);
+			CHECK(chunkCalls >= 1500 / 120 && chunkCalls < 1500 / 60);
+			CHECK(memcmp(chunked, payload, 1500) == 0);
+		} else {
+			CHECK(chunkCalls == 0);
+		}
+	}
+
+	// A topic that leaves no room for any of the payload is dropped
+	char topic[130];
+	memset(topic, 't', 129);
+	topic[129] = 0;
+	reset();
+	len = pubSubPacket(stream, topic, payload, 200);
+	len += pubSubPacket(stream + len, "after", (uint8_t *)"1", 1);
+	net.replay(stream, len);
+	while (!net.done())
+		client.poll();
+	CHECK(chunkCalls == 0 && strcmp(received, "after=1;") == 0);
+}
+
+static void pings(void)
+{
+	PubSubLoopback net;
+	PubSubClient client((char *)"broker", 1883, onMessage, net);
+	uint8_t stream[] = { MQTTPINGREQ, 0 };
+
+	client.connect((char *)"energia");
+	net.replay(stream, 2);
+	unsigned long written = net.written;
+	CHECK(client.poll() && net.written == written + 1);
+	CHECK(net.sent[0] == MQTTPINGRESP && net.sent[1] == 0);
+}
+
+// A callback publishing its own topic and payload back
+static void echoing(void)
+{
+	PubSubLoopback net;
+	PubSubClient client((char *)"broker", 1883, onMessage, net);
+	uint8_t stream[128], expect[64];
+	size_t len, expectLen;
+
+	len = pubSubPacket(stream, "echo/me", (uint8_t *)"payload!", 8, true);
+	expectLen = pubSubPacket(expect, "echo/me", (uint8_t *)"payload!", 8);
+	client.connect((char *)"energia");
+	reset();
+	echo = &client;
+	net.replay(stream, len);
+	client.poll();
+	echo = 0;
+	CHECK(strcmp(received, "echo/me=payload!;") == 0);
+	CHECK(net.sentLen == expectLen && memcmp(net.sent, expect, expectLen) == 0);
+
+	// From the chunk callback, with the piece filling the buffer
+	uint8_t payload[600];
+	static uint8_t big[700];
+
+	for (size_t i = 0; i < sizeof(payload); i++)
+		payload[i] = i * 3;
+	len = pubSubPacket(big, "big/one", payload, sizeof(payload));
+	// 120 byte pieces, the last at 480
+	expectLen = pubSubPacket(expect, "piece", payload + 480, 16);
+	reset();
+	client.setChunkCallback(onChunk);
+	unsigned long written = net.written;
+	echo = &client;
+	net.replay(big, len);
+	while (!net.done())
+		client.poll();
+	echo = 0;
+	CHECK(chunkTotal == sizeof(payload) && chunkInOrder);
+	CHECK(memcmp(chunked, payload, sizeof(payload)) == 0);
+	CHECK(chunkCalls == 5 && net.written == written + 5);
+	CHECK(net.sentLen == expectLen && memcmp(net.sent, expect, expectLen) == 0);
+}
+
+int main()
+{
+	connecting();
+	segments();
+	nonBlocking();
+	oversized();
+	pings();
+	echoing();
+
+	return testResult();
+}
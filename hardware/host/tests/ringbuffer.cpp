@@ -0,0 +1,219 @@
+/*
+ ************************************************************************
+ *	ringbuffer.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	RingBuffer stress test: a producer and a consumer thread move a
+ *	numbered byte stream through the buffer with every mix of single and
+ *	bulk operations, and the consumer checks that nothing is lost,
+ *	duplicated or reordered. Both the fixed size and the attached storage
+ *	variants are covered.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "RingBuffer.h"
+#include "HostTest.h"
+
+#define STREAM_LENGTH 2000000
+
+enum Mode { SINGLE, BULK, SPAN };
+
+template <unsigned int N>
+struct Stress
+{
+	RingBuffer<N> *ring;
+	Mode producer;
+	Mode consumer;
+	unsigned long errors;
+};
+
+static unsigned int chunk(unsigned long i)
+{
+	// Deterministic but irregular burst sizes, 1..37
+	return 1 + (i * 2654435761UL >> 7) % 37;
+}
+
+template <unsigned int N>
+static void *producer(void *arg)
+{
+	Stress<N> *s = (Stress<N> *)arg;
+	unsigned long sent = 0, round = 0;
+	unsigned char buf[64];
+
+	while (sent < STREAM_LENGTH) {
+		unsigned int len = chunk(round++), n = 0, i;
+
+		if (len > STREAM_LENGTH - sent)
+			len = STREAM_LENGTH - sent;
+		switch (s->producer) {
+		case SINGLE:
+			for (n = 0; n < len && s->ring->push((unsigned char)(sent + n)); n++)
+				;
+			break;
+		case BULK:
+			for (i = 0; i < len; i++)
+				buf[i] = (unsigned char)(sent + i);
+			n = s->ring->push(buf, len);
+			break;
+		case SPAN: {
+			unsigned char *span;
+
+			n = s->ring->writeSpan(&span);
+			if (n > len)
+				n = len;
+			for (i = 0; i < n; i++)
+				span[i] = (unsigned char)(sent + i);
+			s->ring->commit(n);
+			break;
+		}
+		}
+		sent += n;
+		if (!n)
+			sched_yield();
+	}
+	return 0;
+}
+
+template <unsigned int N>
+static void *consumer(void *arg)
+{
+	Stress<N> *s = (Stress<N> *)arg;
+	unsigned long received = 0, round = 0;
+	unsigned char buf[64];
+
+	while (received < STREAM_LENGTH) {
+		unsigned int len = chunk(round++ + 17), n = 0, i;
+
+		switch (s->consumer) {
+		case SINGLE:
+			for (; n < len; n++) {
+				int c = s->ring->pop();
+
+				if (c < 0)
+					break;
+				buf[n] = c;
+			}
+			break;
+		case BULK:
+			n = s->ring->pop(buf, len);
+			break;
+		case SPAN: {
+			const unsigned char *span;
+
+			n = s->ring->readSpan(&span);
+			if (n > len)
+				n = len;
+			for (i = 0; i < n; i++)
+				buf[i] = span[i];
+			s->ring->consume(n);
+			break;
+		}
+		}
+		for (i = 0; i < n; i++) {
+			if (buf[i] != (unsigned char)(received + i))
+				s->errors++;
+		}
+		received += n;
+		if (!n)
+			sched_yield();
+	}
+	return 0;
+}
+
+template <unsigned int N>
+static void stress(RingBuffer<N> &ring, const char *name)
+{
+	static const char *modes[] = { "single", "bulk", "span" };
+
+	for (int p = SINGLE; p <= SPAN; p++) {
+		for (int c = SINGLE; c <= SPAN; c++) {
+			Stress<N> s = { &ring, (Mode)p, (Mode)c, 0 };
+			pthread_t tp, tc;
+
+			ring.clear();
+			ring.resetHighWater();
+			pthread_create(&tc, 0, consumer<N>, &s);
+			pthread_create(&tp, 0, producer<N>, &s);
+			pthread_join(tp, 0);
+			pthread_join(tc, 0);
+
+			printf("  %s %s -> %s: high water %u/%u\n", name,
+					modes[p], modes[c], ring.highWater(), ring.capacity());
+			CHECK(s.errors == 0);
+			CHECK(ring.empty());
+			CHECK(ring.highWater() <= ring.capacity());
+			CHECK(ring.highWater() > 0);
+		}
+	}
+}
+
+static void basics()
+{
+	RingBuffer<8> ring;
+	unsigned char out[8];
+
+	CHECK(ring.empty() && ring.capacity() == 8 && ring.space() == 8);
+	CHECK(ring.pop() == -1 && ring.peek() == -1);
+
+	// All N bytes are usable
+	for (int i = 0; i < 8; i++)
+		CHECK(ring.push(i));
+	CHECK(ring.full() && !ring.push(8));
+	CHECK(ring.peek() == 0 && ring.available() == 8);
+
+	// Bulk operations wrap around the end of the storage
+	CHECK(ring.pop(out, 5) == 5 && out[4] == 4);
+	const unsigned char in[] = { 10, 11, 12, 13, 14, 15 };
+	CHECK(ring.push(in, 6) == 5);
+	CHECK(ring.pop(out, 8) == 8);
+	CHECK(out[0] == 5 && out[2] == 7 && out[3] == 10 && out[7] == 14);
+	CHECK(ring.highWater() == 8);
+
+	// A span never crosses the end of the storage
+	unsigned char *span;
+	CHECK(ring.writeSpan(&span) == 3);
+
+	// Attached storage is rounded down to a power of two
+	static unsigned char storage[100];
+	RingBuffer<0> dynamic;
+	CHECK(dynamic.capacity() == 0 && !dynamic.push(1));
+	dynamic.attach(storage, sizeof(storage));
+	CHECK(dynamic.capacity() == 64);
+}
+
+int main()
+{
+	static RingBuffer<16> small;
+	static RingBuffer<256> large;
+	static unsigned char storage[1000];
+	static RingBuffer<0> dynamic;
+
+	basics();
+
+	dynamic.attach(storage, sizeof(storage));
+	stress(small, "RingBuffer<16>");
+	stress(large, "RingBuffer<256>");
+	stress(dynamic, "RingBuffer<0>(512)");
+
+	return testResult();
+}
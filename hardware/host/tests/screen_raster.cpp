@@ -0,0 +1,259 @@
+/*
+ ************************************************************************
+ *	screen_raster.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The drawing of the LCD_screen library it is built against, on a
+ *	MockScreen: diagonal lines of every octant and outline circles, some
+ *	of them partly off the screen, put the same pixels as plotting them
+ *	a point at a time, in a span a call; text in the smallest font,
+ *	solid, transparent and scaled, puts the pixels of its characters,
+ *	the solid one a window and a buffer a character.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include "MockScreen.h"
+#include "HostTest.h"
+
+#define PAPER 0x1234
+#define TEXT "Hello, 21C!"
+
+static uint16_t expected[MOCK_HEIGHT][MOCK_WIDTH];
+
+static void paint(MockScreen &screen)
+{
+	screen.paint(PAPER);
+	memcpy(expected, screen.pixels, sizeof(expected));
+	screen.clearCounts();
+}
+
+static void plot(int x, int y, uint16_t colour)
+{
+	if (x >= 0 && x < MOCK_WIDTH && y >= 0 && y < MOCK_HEIGHT)
+		expected[y][x] = colour;
+}
+
+static bool drawn(MockScreen &screen)
+{
+	return memcmp(screen.pixels, expected, sizeof(expected)) == 0 && screen.errors == 0;
+}
+
+// Bresenham, a point a step
+static int referenceLine(int x1, int y1, int x2, int y2, uint16_t colour)
+{
+	bool steep = abs(y2 - y1) > abs(x2 - x1);
+	int n = 0;
+
+	if (steep) {
+		int t;
+		t = x1; x1 = y1; y1 = t;
+		t = x2; x2 = y2; y2 = t;
+	}
+	if (x1 > x2) {
+		int t;
+		t = x1; x1 = x2; x2 = t;
+		t = y1; y1 = y2; y2 = t;
+	}
+	int dx = x2 - x1, dy = abs(y2 - y1), err = dx / 2;
+	int ystep = y1 < y2 ? 1 : -1;
+
+	for (; x1 <= x2; x1++, n++) {
+		if (steep)
+			plot(y1, x1, colour);
+		else
+			plot(x1, y1, colour);
+		err -= dy;
+		if (err < 0) {
+			y1 += ystep;
+			err += dx;
+		}
+	}
+	return n;
+}
+
+// The midpoint circle, eight points a step
+static int referenceCircle(int x0, int y0, int r, uint16_t colour)
+{
+	int f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, n = 4;
+
+	plot(x0, y0 + r, colour);
+	plot(x0, y0 - r, colour);
+	plot(x0 + r, y0, colour);
+	plot(x0 - r, y0, colour);
+	while (x < y) {
+		if (f >= 0) {
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+		plot(x0 + x, y0 + y, colour);
+		plot(x0 - x, y0 + y, colour);
+		plot(x0 + x, y0 - y, colour);
+		plot(x0 - x, y0 - y, colour);
+		plot(x0 + y, y0 + x, colour);
+		plot(x0 - y, y0 + x, colour);
+		plot(x0 + y, y0 - x, colour);
+		plot(x0 - y, y0 - x, colour);
+		n += 8;
+	}
+	return n;
+}
+
+static void referenceText(int x0, int y0, const char *s, uint16_t textColour,
+		uint16_t backColour, bool solid, int ix, int iy)
+{
+	for (int k = 0; s[k]; k++)
+		for (int i = 0; i < 6; i++) {
+			uint8_t column = Terminal6x8e[s[k] - ' '][i];
+
+			for (int j = 0; j < 8; j++) {
+				if (!(column >> j & 1) && !solid)
+					continue;
+				for (int v = 0; v < iy; v++)
+					for (int u = 0; u < ix; u++)
+						plot(x0 + (6 * k + i) * ix + u, y0 + j * iy + v,
+								column >> j & 1 ? textColour : backColour);
+			}
+		}
+}
+
+static void lines(MockScreen &screen)
+{
+	static const int16_t ends[][4] = {
+		{ 0, 0, 99, 9 },	// shallow
+		{ 99, 9, 0, 0 },	// and backwards
+		{ 10, 100, 150, 20 },	// shallow, rising
+		{ 5, 5, 25, 120 },	// steep
+		{ 60, 120, 40, 3 },	// steep, backwards
+		{ 10, 10, 60, 60 },	// diagonal
+		{ 120, 20, 30, 21 },	// nearly flat
+		{ 140, 100, 200, 130 },	// off the bottom right
+	};
+	bool ok = true;
+
+	for (size_t i = 0; i < sizeof(ends) / sizeof(ends[0]); i++) {
+		const int16_t *e = ends[i];
+
+		paint(screen);
+		referenceLine(e[0], e[1], e[2], e[3], redColour);
+		screen.line(e[0], e[1], e[2], e[3], redColour);
+		ok &= drawn(screen);
+	}
+	CHECK(ok);
+
+	// a span for each row it crosses, not a point a column
+	paint(screen);
+	screen.line(0, 0, 99, 9, redColour);
+	CHECK(screen.points + screen.fills == 10);
+	paint(screen);
+	screen.line(5, 5, 25, 120, redColour);
+	CHECK(screen.points + screen.fills == 21);
+}
+
+static void circles(MockScreen &screen)
+{
+	static const int16_t circles[][3] = {
+		{ 80, 64, 0 },
+		{ 80, 64, 1 },
+		{ 80, 64, 5 },
+		{ 80, 64, 20 },
+		{ 80, 64, 40 },
+		{ 80, 64, 63 },
+		{ 10, 12, 20 },		// off the top left
+		{ 150, 120, 30 },	// off the bottom right
+	};
+	bool ok = true;
+
+	screen.setPenSolid(false);
+	for (size_t i = 0; i < sizeof(circles) / sizeof(circles[0]); i++) {
+		const int16_t *c = circles[i];
+
+		paint(screen);
+		referenceCircle(c[0], c[1], c[2], greenColour);
+		screen.circle(c[0], c[1], c[2], greenColour);
+		ok &= drawn(screen);
+	}
+	CHECK(ok);
+
+	// a span for each row or column of an octant
+	paint(screen);
+	int n = referenceCircle(80, 64, 40, greenColour);
+	screen.circle(80, 64, 40, greenColour);
+	CHECK(screen.points + screen.fills < n * 3 / 4);
+}
+
+static void text(MockScreen &screen)
+{
+	int n = strlen(TEXT);
+
+	// solid: a window and a buffer a character, no pixel on its own
+	paint(screen);
+	screen.setFontSolid(true);
+	referenceText(3, 7, TEXT, whiteColour, blueColour, true, 1, 1);
+	screen.gText(3, 7, TEXT, whiteColour, blueColour);
+	CHECK(drawn(screen));
+	CHECK(screen.windows == n && screen.buffers == n);
+	CHECK(screen.buffered == n * 6 * 8 && screen.data == screen.buffered);
+	CHECK(screen.points == 0 && screen.fills == 0);
+
+	// transparent: the paper shows between the strokes
+	paint(screen);
+	screen.setFontSolid(false);
+	referenceText(3, 30, TEXT, yellowColour, blueColour, false, 1, 1);
+	screen.gText(3, 30, TEXT, yellowColour, blueColour);
+	CHECK(drawn(screen));
+	CHECK(screen.windows == 0 && screen.data == 0);
+
+	// scaled, solid and transparent
+	paint(screen);
+	screen.setFontSolid(true);
+	referenceText(2, 50, TEXT, whiteColour, redColour, true, 2, 3);
+	screen.gText(2, 50, TEXT, whiteColour, redColour, 2, 3);
+	CHECK(drawn(screen));
+	CHECK(screen.points + screen.fills < n * 6 * 8);
+	paint(screen);
+	screen.setFontSolid(false);
+	referenceText(2, 80, TEXT, whiteColour, redColour, false, 2, 3);
+	screen.gText(2, 80, TEXT, whiteColour, redColour, 2, 3);
+	CHECK(drawn(screen));
+
+	// running off the right of the screen
+	paint(screen);
+	referenceText(120, 100, TEXT, whiteColour, redColour, false, 2, 2);
+	screen.gText(120, 100, TEXT, whiteColour, redColour, 2, 2);
+	CHECK(drawn(screen));
+}
+
+// static, the frame buffer is too big for some stacks
+static MockScreen screen;
+
+int main()
+{
+	screen.begin();
+	lines(screen);
+	circles(screen);
+	text(screen);
+
+	return testResult();
+}
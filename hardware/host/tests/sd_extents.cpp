@@ -0,0 +1,229 @@
+/*
+ ************************************************************************
+ *	sd_extents.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	SdFile's extent map on a mapped FAT16 image: a file of 2000 clusters
+ *	in 8 runs, seeks looked up in the map without reading the FAT, a map
+ *	too small for the file, clusters appended to the map, truncate()
+ *	building it again, and contiguousRange() for each extent with and
+ *	without a map.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SdFat.h"
+#include "SdImageCard.h"
+#include "FatImage.h"
+#include "HostTest.h"
+
+// 64 MB, FAT16 with 2 KB clusters
+#define CARD_BLOCKS 131072
+#define CLUSTER 2048
+// 8 runs of 250 clusters, a cluster of another file between each
+#define RUN 250
+#define RUNS 8
+#define FILE_SIZE ((uint32_t)RUN * RUNS * CLUSTER)
+
+static char image[] = "/tmp/sd_extentsXXXXXX";
+static Sd2Card card;
+static SdVolume volume;
+static SdFile root;
+
+// The byte at pos in the big file
+static uint8_t at(uint32_t pos)
+{
+	return (pos * 2654435761u) >> 24;
+}
+
+static void fill(uint8_t *p, uint32_t pos, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+		p[i] = at(pos + i);
+}
+
+static bool readAt(SdFile &file, uint32_t pos)
+{
+	uint8_t buf[100], want[100];
+
+	fill(want, pos, sizeof(want));
+	return file.seekSet(pos) && file.read(buf, sizeof(buf)) == sizeof(buf) &&
+			memcmp(buf, want, sizeof(buf)) == 0;
+}
+
+static void making(SdImageCard &image)
+{
+	SdFile big, gaps;
+	uint8_t buf[CLUSTER];
+	bool written = true;
+
+	CHECK(big.open(&root, "BIG.BIN", O_RDWR | O_CREAT | O_TRUNC));
+	CHECK(gaps.open(&root, "GAPS.BIN", O_RDWR | O_CREAT | O_TRUNC));
+	for (uint32_t pos = 0; pos < FILE_SIZE; pos += CLUSTER) {
+		fill(buf, pos, CLUSTER);
+		written &= big.write(buf, CLUSTER) == CLUSTER;
+		if ((pos / CLUSTER + 1) % RUN == 0)
+			written &= gaps.write(buf, CLUSTER) == CLUSTER;
+	}
+	CHECK(written);
+	CHECK(big.close() && gaps.close());
+}
+
+// The extents without a map, from the FAT
+static void ranges(SdImageCard &image)
+{
+	SdFile big;
+	uint32_t bgn, end, last = 0;
+
+	CHECK(big.open(&root, "BIG.BIN", O_READ));
+	CHECK(!big.contiguousRange(&bgn, &end));
+	for (uint16_t i = 0; i < RUNS; i++) {
+		CHECK(big.contiguousRange(i, &bgn, &end));
+		CHECK(end - bgn + 1 == RUN * CLUSTER / 512);
+		// a cluster of GAPS.BIN between each
+		CHECK(i == 0 || bgn == last + 1 + CLUSTER / 512);
+		last = end;
+	}
+	CHECK(!big.contiguousRange(RUNS, &bgn, &end));
+	CHECK(big.extentCount() == 0);
+	big.close();
+}
+
+static void seeking(SdImageCard &image)
+{
+	SdFile big;
+	fat_extent_t map[16];
+	uint32_t bgn, end;
+
+	// Back to the start from the end follows 2000 clusters of FAT, more
+	// FAT blocks than the cache holds
+	CHECK(big.open(&root, "BIG.BIN", O_READ));
+	CHECK(readAt(big, FILE_SIZE - 100));
+	image.clear();
+	CHECK(big.seekSet(100) && big.seekSet(FILE_SIZE - 100));
+	CHECK(image.blocksRead > SD_CACHE_BLOCKS);
+
+	// With a map, once it is built, seeks read nothing
+	CHECK(big.setExtentMap(map, 16));
+	CHECK(big.seekSet(100));
+	CHECK(big.extentCount() == RUNS);
+	CHECK(map[0].index == 0 && map[1].index == RUN && map[7].index == 7 * RUN);
+	image.clear();
+	CHECK(big.seekSet(FILE_SIZE - 100) && big.seekSet(100));
+	CHECK(big.seekSet(5 * RUN * CLUSTER) && big.seekSet(3 * RUN * CLUSTER + 1));
+	CHECK(image.blocksRead == 0);
+
+	// and land where following the FAT does
+	for (uint32_t pos = 1; pos < FILE_SIZE - 100; pos += 99991)
+		CHECK(readAt(big, pos));
+	for (int i = 0; i < RUNS; i++) {
+		CHECK(readAt(big, i * RUN * CLUSTER + 1));
+		CHECK(readAt(big, (i + 1) * RUN * CLUSTER - 100));
+	}
+
+	// The ranges from the map
+	image.clear();
+	CHECK(big.contiguousRange(7, &bgn, &end));
+	CHECK(end - bgn + 1 == RUN * CLUSTER / 512);
+	CHECK(!big.contiguousRange(8, &bgn, &end));
+	CHECK(image.blocksRead == 0);
+	big.close();
+
+	// A map with room for 3: the rest found from the end of the map
+	CHECK(big.open(&root, "BIG.BIN", O_READ));
+	CHECK(big.setExtentMap(map, 3));
+	CHECK(readAt(big, FILE_SIZE - 100) && big.extentCount() == 3);
+	CHECK(readAt(big, 5 * RUN * CLUSTER + 7) && readAt(big, 2 * RUN * CLUSTER));
+	CHECK(big.contiguousRange(2, &bgn, &end) && big.contiguousRange(6, &bgn, &end));
+	CHECK(end - bgn + 1 == RUN * CLUSTER / 512);
+	big.close();
+
+	CHECK(!root.setExtentMap(map, 16));
+}
+
+static void growing(SdImageCard &image)
+{
+	SdFile big, gaps, log;
+	fat_extent_t map[16];
+	uint8_t buf[CLUSTER];
+
+	// A cluster on the end, after another of GAPS.BIN, is a new extent
+	CHECK(big.open(&root, "BIG.BIN", O_RDWR));
+	CHECK(big.setExtentMap(map, 16) && big.seekEnd());
+	CHECK(big.extentCount() == RUNS);
+	CHECK(gaps.open(&root, "GAPS.BIN", O_RDWR | O_APPEND));
+	CHECK(gaps.write(buf, CLUSTER) == CLUSTER && gaps.close());
+	fill(buf, FILE_SIZE, CLUSTER);
+	CHECK(big.write(buf, CLUSTER) == CLUSTER);
+	CHECK(big.extentCount() == RUNS + 1);
+	CHECK(readAt(big, FILE_SIZE + 1000) && readAt(big, 1000));
+
+	// Cut back into the third run
+	CHECK(big.truncate(2 * RUN * CLUSTER + 5000));
+	CHECK(readAt(big, 2 * RUN * CLUSTER + 4000));
+	CHECK(big.extentCount() == 3);
+	CHECK(big.close());
+
+	// A new file's map grows with it once it is built
+	CHECK(log.open(&root, "LOG.BIN", O_RDWR | O_CREAT | O_TRUNC));
+	CHECK(log.setExtentMap(map, 16));
+	fill(buf, 0, CLUSTER);
+	CHECK(log.write(buf, CLUSTER) == CLUSTER);
+	CHECK(readAt(log, 10) && log.extentCount() == 1);
+	CHECK(log.seekEnd());
+	for (int i = 1; i < 3; i++) {
+		fill(buf, i * CLUSTER, CLUSTER);
+		CHECK(log.write(buf, CLUSTER) == CLUSTER);
+	}
+	image.clear();
+	CHECK(log.seekSet(10) && log.seekSet(2 * CLUSTER + 10));
+	CHECK(image.blocksRead == 0);
+	CHECK(readAt(log, 10) && readAt(log, 2 * CLUSTER + 10));
+	CHECK(log.extentCount() == 1 && log.close());
+}
+
+int main()
+{
+	int fd = mkstemp(image);
+
+	if (fd < 0) {
+		perror(image);
+		return 1;
+	}
+	close(fd);
+	{
+		SdImageCard sd(image, CARD_BLOCKS);
+		FILE *f = fopen(image, "r+b");
+
+		CHECK(sd.ok() && f);
+		CHECK(fatFormat(fileno(f), CARD_BLOCKS, CLUSTER / 512) == 16);
+		fclose(f);
+		CHECK(card.init() && volume.init(&card) && root.openRoot(&volume));
+		making(sd);
+		ranges(sd);
+		seeking(sd);
+		growing(sd);
+		root.close();
+	}
+	unlink(image);
+
+	return testResult();
+}
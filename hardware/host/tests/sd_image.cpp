@@ -0,0 +1,259 @@
+/*
+ ************************************************************************
+ *	sd_image.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The SD library's File API on mapped FAT16 and FAT32 images: nested
+ *	directories made, written to, read back and listed, the blocks an
+ *	append and a flush cost, as the image card records them, and the
+ *	mirror FAT only written at a flush, for just the FAT blocks that
+ *	changed.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SD.h"
+#include "SdImageCard.h"
+#include "FatImage.h"
+#include "HostTest.h"
+
+// 64 MB and 256 MB, with 2 KB clusters
+#define FAT16_BLOCKS 131072
+#define FAT32_BLOCKS 524288
+
+static char image[] = "/tmp/sd_imageXXXXXX";
+
+static void paths(SdImageCard &card)
+{
+	char line[32];
+
+	CHECK(SD.mkdir((char *)"LOGS/2015/JAN"));
+	CHECK(SD.exists((char *)"LOGS/2015"));
+	CHECK(!SD.exists((char *)"LOGS/2016"));
+
+	File f = SD.open("LOGS/2015/JAN/DAY01.TXT", FILE_WRITE);
+	CHECK(f);
+	for (int i = 0; i < 100; i++)
+		f.println(i);
+	f.close();
+
+	f = SD.open("LOGS/2015/JAN/DAY01.TXT");
+	CHECK(f && f.size() == 10 * 3 + 90 * 4);
+	CHECK(f.read(line, 6) == 6 && memcmp(line, "0\r\n1\r\n", 6) == 0);
+	f.close();
+
+	CHECK(SD.remove((char *)"LOGS/2015/JAN/DAY01.TXT"));
+	CHECK(!SD.exists((char *)"LOGS/2015/JAN/DAY01.TXT"));
+}
+
+static void listing(SdImageCard &card)
+{
+	char name[16];
+	int files = 0, sum = 0;
+
+	CHECK(SD.mkdir((char *)"LIST"));
+	for (int i = 0; i < 40; i++) {
+		sprintf(name, "LIST/F%d.TXT", i);
+		File f = SD.open(name, FILE_WRITE);
+		f.print(i);
+		f.close();
+	}
+
+	File dir = SD.open("LIST");
+	CHECK(dir && dir.isDirectory());
+	for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+		files++;
+		sum += atoi(f.name() + 1);
+		f.close();
+	}
+	dir.close();
+	CHECK(files == 40 && sum == 39 * 40 / 2);
+}
+
+// What an append of a short record and a flush write to the card
+static void appending(SdImageCard &card)
+{
+	SdImageCard::Access trace[16];
+	char record[64];
+
+	memset(record, 'r', sizeof(record));
+	File f = SD.open("APPEND.LOG", FILE_WRITE);
+	CHECK(f);
+	f.write((uint8_t *)record, sizeof(record));
+	f.flush();
+
+	// The data block and the block with the directory entry both stay in
+	// the cache, so the flush only writes them
+	card.clear();
+	card.record(trace, 16);
+	f.write((uint8_t *)record, sizeof(record));
+	f.flush();
+	CHECK(card.traced == 2 && card.blocksRead == 0);
+	CHECK(trace[0].write && trace[1].write && trace[0].block != trace[1].block);
+	CHECK(card.commands[CMD24] == 2 && card.commands[CMD13] == 2);
+
+	// The record lands in the image
+	int landed = 0;
+	for (int i = 0; i < 2; i++) {
+		uint8_t *block = card.blocks + (size_t)trace[i].block * 512;
+
+		landed += memcmp(block + 64, record, sizeof(record)) == 0;
+	}
+	CHECK(landed == 1);
+
+	// Nothing written without a flush, until the block changes
+	card.clear();
+	f.write((uint8_t *)record, sizeof(record));
+	CHECK(card.blocksWritten == 0);
+	f.close();
+	CHECK(card.blocksWritten == 2);
+	card.record(0, 0);
+}
+
+// FAT changes reach the mirror FAT at a sync and not before, and the FAT
+// block stays in the cache while the data blocks go past it
+static void mirroring(SdImageCard &card)
+{
+	static SdImageCard::Access trace[256];
+	bpb_t *bpb = &((fbs_t *)card.blocks)->bpb;
+	uint32_t fat = bpb->reservedSectorCount;
+	uint32_t fatBlocks = bpb->sectorsPerFat16 ? bpb->sectorsPerFat16 :
+			bpb->sectorsPerFat32;
+	uint8_t chunk[100];
+	int fatWrites = 0, mirrorWrites = 0;
+
+	memset(chunk, 'm', sizeof(chunk));
+	File f = SD.open("MIRROR.BIN", FILE_WRITE);
+	CHECK(f);
+	card.clear();
+	card.record(trace, 256);
+	// 5 clusters
+	for (int i = 0; i < 100; i++)
+		f.write(chunk, sizeof(chunk));
+	CHECK(card.traced < 256);
+	for (size_t i = 0; i < card.traced; i++) {
+		fatWrites += trace[i].block >= fat && trace[i].block < fat + fatBlocks;
+		mirrorWrites += trace[i].block >= fat + fatBlocks &&
+				trace[i].block < fat + 2 * fatBlocks;
+	}
+	CHECK(fatWrites == 0 && mirrorWrites == 0);
+
+	card.clear();
+	f.flush();
+	for (size_t i = 0; i < card.traced; i++) {
+		fatWrites += trace[i].write && trace[i].block >= fat &&
+				trace[i].block < fat + fatBlocks;
+		mirrorWrites += trace[i].write && trace[i].block >= fat + fatBlocks &&
+				trace[i].block < fat + 2 * fatBlocks;
+	}
+	CHECK(fatWrites == 1 && mirrorWrites == 1);
+	CHECK(memcmp(card.blocks + (size_t)fat * 512,
+			card.blocks + (size_t)(fat + fatBlocks) * 512,
+			(size_t)fatBlocks * 512) == 0);
+	f.close();
+	card.record(0, 0);
+
+	f = SD.open("MIRROR.BIN");
+	CHECK(f && f.size() == 10000);
+	f.close();
+}
+
+// Two FAT blocks far apart changed before one sync, an append at the end
+// of a long file and a file removed at the start of the FAT: the mirror
+// gets those two blocks and none between them
+static void scattered(SdImageCard &card)
+{
+	static SdImageCard::Access trace[256];
+	static uint8_t chunk[2048];
+	bpb_t *bpb = &((fbs_t *)card.blocks)->bpb;
+	uint32_t fat = bpb->reservedSectorCount;
+	uint32_t fatBlocks = bpb->sectorsPerFat16 ? bpb->sectorsPerFat16 :
+			bpb->sectorsPerFat32;
+	uint32_t first = 0XFFFFFFFF, last = 0;
+	int fatWrites = 0, mirrorWrites = 0, fatReads = 0;
+
+	memset(chunk, 's', sizeof(chunk));
+	// 1200 clusters, past the fourth FAT block of either type
+	File f = SD.open("SPREAD.BIN", FILE_WRITE);
+	CHECK(f);
+	for (int i = 0; i < 1200; i++)
+		f.write(chunk, sizeof(chunk));
+	f.flush();
+
+	card.clear();
+	card.record(trace, 256);
+	f.write(chunk, sizeof(chunk));
+	CHECK(SD.remove((char *)"LIST/F0.TXT"));
+	f.close();
+	CHECK(card.traced < 256);
+	for (size_t i = 0; i < card.traced; i++) {
+		uint32_t block = trace[i].block;
+
+		if (block >= fat && block < fat + fatBlocks) {
+			if (trace[i].write) {
+				fatWrites++;
+				if (block < first) first = block;
+				if (block > last) last = block;
+			} else {
+				fatReads++;
+			}
+		}
+		mirrorWrites += trace[i].write && block >= fat + fatBlocks &&
+				block < fat + 2 * fatBlocks;
+	}
+	CHECK(last - first >= 3);
+	CHECK(fatWrites == 2 && mirrorWrites == 2 && fatReads <= 2);
+	CHECK(memcmp(card.blocks + (size_t)fat * 512,
+			card.blocks + (size_t)(fat + fatBlocks) * 512,
+			(size_t)fatBlocks * 512) == 0);
+	card.record(0, 0);
+}
+
+int main()
+{
+	int fd = mkstemp(image);
+
+	if (fd < 0) {
+		perror(image);
+		return 1;
+	}
+	close(fd);
+	for (int type = 16; type <= 32; type += 16) {
+		uint32_t blocks = type == 16 ? FAT16_BLOCKS : FAT32_BLOCKS;
+		SdImageCard card(image, blocks);
+		FILE *f = fopen(image, "r+b");
+
+		CHECK(card.ok() && f);
+		CHECK(fatFormat(fileno(f), blocks, 4) == type);
+		fclose(f);
+		// there is no SD.end(), a new SD forgets the last root directory
+		SD = SDClass();
+		CHECK(SD.begin());
+		paths(card);
+		listing(card);
+		appending(card);
+		mirroring(card);
+		scattered(card);
+	}
+	unlink(image);
+
+	return testResult();
+}
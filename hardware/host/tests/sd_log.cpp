@@ -0,0 +1,333 @@
+/*
+ ************************************************************************
+ *	sd_log.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	SD.openLog() on the emulated card: records going out as one multiple
+ *	block write with nothing else written until a flush, the partial
+ *	block and the directory entry at the flush, the clusters past the
+ *	last record given back at close, and the records that do not fit
+ *	counted as lost. Then records from a timer interrupt, the emulator's
+ *	tick, into a deferred log drained by the main loop, at a few rates
+ *	and on a card that stalls now and then, where no record may be lost
+ *	but the ones counted; and the bytes clocked for a record against an
+ *	ordinary file. Sd2Card's multiple block write is checked directly.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SD.h"
+#include "SdCardEmulator.h"
+#include "FatImage.h"
+#include "HostTest.h"
+
+// 16 MB, FAT16 with 2 KB clusters
+#define CARD_BLOCKS 32768
+#define RECORD 32
+
+static char image[] = "/tmp/sd_logXXXXXX";
+
+// A record of size bytes holding its number
+static void record(uint8_t *rec, size_t size, uint32_t n)
+{
+	memset(rec, n & 0xFF, size);
+	memcpy(rec, &n, sizeof(n));
+}
+
+// Clusters in use in the first FAT
+static int clustersUsed(SdCardEmulator &emu)
+{
+	uint8_t block[512];
+	bpb_t *bpb = &((fbs_t *)block)->bpb;
+	int used = 0;
+
+	if (pread(emu.file(), block, 512, 0) != 512)
+		return -1;
+	uint32_t fat = bpb->reservedSectorCount, count = bpb->sectorsPerFat16;
+
+	for (uint32_t n = 0; n < count; n++) {
+		uint16_t *entry = (uint16_t *)block;
+
+		if (pread(emu.file(), block, 512, (off_t)(fat + n) * 512) != 512)
+			return -1;
+		for (int i = 0; i < 256; i++)
+			used += entry[i] != 0;
+	}
+	return used;
+}
+
+// Reads the file back, records of size bytes numbered from zero, some
+// perhaps missing; returns how many there are, or -1 if one is wrong
+// or out of order
+static long readBack(const char *name, size_t size)
+{
+	uint8_t rec[512], want[512];
+	long count = 0;
+	uint32_t last = 0;
+	File f = SD.open(name);
+
+	if (!f || f.size() % size)
+		return -1;
+	while (f.read(rec, size) == (int)size) {
+		uint32_t n;
+
+		memcpy(&n, rec, sizeof(n));
+		record(want, size, n);
+		if (memcmp(rec, want, size) != 0 || (count && n <= last)) {
+			count = -1;
+			break;
+		}
+		last = n;
+		count++;
+	}
+	f.close();
+	return count;
+}
+
+static void streaming(SdCardEmulator &emu)
+{
+	uint8_t rec[24];
+	int used = clustersUsed(emu);
+
+	File log = SD.openLog("DATA.LOG", 65536);
+	CHECK(log);
+	CHECK(clustersUsed(emu) == used + 32);
+
+	// 46 whole blocks, one command, and nothing else written
+	emu.clear();
+	bool ok = true;
+	for (uint32_t n = 0; n < 1000; n++) {
+		record(rec, sizeof(rec), n);
+		ok &= log.write(rec, sizeof(rec)) == sizeof(rec);
+	}
+	CHECK(ok && log.lostRecords() == 0 && log.position() == 24000);
+	CHECK(emu.commands[CMD25] == 1 && emu.commands[CMD24] == 0);
+	CHECK(emu.blocksWritten == 46 && emu.blocksRead == 0);
+	CHECK(log.size() == 0);
+
+	// The partial block and the directory entry
+	emu.clear();
+	log.flush();
+	CHECK(emu.commands[CMD24] == 2 && emu.blocksWritten == 2);
+	CHECK(log.size() == 24000);
+	CHECK(readBack("DATA.LOG", sizeof(rec)) == 1000);
+
+	// The block the flush wrote goes again when it fills, with a new
+	// multiple block write
+	emu.clear();
+	for (uint32_t n = 1000; n < 1100; n++) {
+		record(rec, sizeof(rec), n);
+		ok &= log.write(rec, sizeof(rec)) == sizeof(rec);
+	}
+	CHECK(ok && emu.commands[CMD25] == 1 && emu.blocksWritten == 5);
+	log.close();
+
+	// 13 clusters hold 26400 bytes
+	CHECK(readBack("DATA.LOG", sizeof(rec)) == 1100);
+	CHECK(clustersUsed(emu) == used + 13);
+
+	// Opening it again starts afresh
+	log = SD.openLog("DATA.LOG", 4096);
+	CHECK(log && log.size() == 0);
+	log.close();
+	CHECK(readBack("DATA.LOG", sizeof(rec)) == 0);
+	CHECK(clustersUsed(emu) == used);
+}
+
+// More records than the file has room for
+static void overflow(SdCardEmulator &emu)
+{
+	uint8_t rec[RECORD];
+	int accepted = 0;
+
+	// a cluster, however little is asked for
+	File log = SD.openLog("FULL.LOG", 1000);
+	CHECK(log);
+	for (uint32_t n = 0; n < 100; n++) {
+		record(rec, sizeof(rec), n);
+		accepted += log.write(rec, sizeof(rec)) == sizeof(rec);
+	}
+	CHECK(accepted == 64 && log.lostRecords() == 36);
+	CHECK(!log.getWriteError());
+	log.close();
+	CHECK(readBack("FULL.LOG", RECORD) == 64);
+	CHECK(SD.remove((char *)"FULL.LOG"));
+}
+
+//
+// Records from an interrupt every period bytes clocked
+//
+static File isrLog;
+static unsigned long period, ticks, produced;
+
+static void sensor(void)
+{
+	uint8_t rec[RECORD];
+
+	if (++ticks % period)
+		return;
+	record(rec, sizeof(rec), produced++);
+	isrLog.write(rec, sizeof(rec));
+}
+
+// Logs a record every period bytes clocked until count have come, the
+// main loop draining the log; returns the records lost
+static unsigned long sample(SdCardEmulator &emu, unsigned long every,
+		unsigned long count)
+{
+	bool ok = true;
+
+	isrLog = SD.openLog("ISR.LOG", count * RECORD, true);
+	CHECK(isrLog);
+	period = every;
+	ticks = produced = 0;
+	emu.clear();
+	emu.tick = sensor;
+	while (produced < count) {
+		ok &= isrLog.drainLog();
+		// idle
+		sdSpiRec();
+	}
+	emu.tick = 0;
+	CHECK(ok);
+
+	unsigned long lost = isrLog.lostRecords();
+	double busy = 100.0 * emu.blockBytes / emu.clocked;
+
+	isrLog.close();
+	long written = readBack("ISR.LOG", RECORD);
+	CHECK(written >= 0 && (unsigned long)written + lost == produced);
+	printf("  one per %lu bytes, stall %d: %ld written, %lu lost, "
+			"%.0f%% of the bytes data\n", every, emu.stall, written, lost, busy);
+	return lost;
+}
+
+static void sampling(SdCardEmulator &emu)
+{
+	// A block of 16 records takes about 530 bytes clocked, so the card
+	// keeps up with one record every 40 bytes but not every 30
+	CHECK(sample(emu, 200, 4000) == 0);
+	CHECK(sample(emu, 40, 4000) == 0);
+	CHECK(sample(emu, 30, 4000) > 0);
+
+	// A stall shorter than a buffer takes to fill loses nothing
+	emu.stall = 1000;
+	emu.stallEvery = 32;
+	CHECK(sample(emu, 200, 4000) == 0);
+
+	// one longer loses some records in each stall, the rest all there
+	emu.stall = 8000;
+	CHECK(sample(emu, 200, 4000) > 0);
+	emu.stall = 0;
+}
+
+// The bytes clocked for a record, through the log and as an ordinary
+// file with a flush every 16 records
+static void throughput(SdCardEmulator &emu)
+{
+	uint8_t rec[RECORD];
+	bool ok = true;
+
+	File log = SD.openLog("FAST.LOG", 64 * 1024);
+	emu.clear();
+	for (uint32_t n = 0; n < 2048; n++) {
+		record(rec, sizeof(rec), n);
+		ok &= log.write(rec, sizeof(rec)) == sizeof(rec);
+	}
+	log.close();
+	unsigned long logged = emu.clocked;
+
+	SD.remove((char *)"SLOW.LOG");
+	File file = SD.open("SLOW.LOG", FILE_WRITE);
+	emu.clear();
+	for (uint32_t n = 0; n < 2048; n++) {
+		record(rec, sizeof(rec), n);
+		ok &= file.write(rec, sizeof(rec)) == sizeof(rec);
+		if (n % 16 == 15)
+			file.flush();
+	}
+	file.close();
+	unsigned long written = emu.clocked;
+
+	CHECK(ok);
+	CHECK(readBack("FAST.LOG", RECORD) == 2048);
+	CHECK(readBack("SLOW.LOG", RECORD) == 2048);
+	printf("  bytes clocked per record: log %.1f, file %.1f\n",
+			logged / 2048.0, written / 2048.0);
+	CHECK(logged * 2 < written);
+}
+
+static void direct(SdCardEmulator &emu)
+{
+	uint8_t a[512], b[512], buf[512];
+	Sd2Card card;
+
+	memset(a, 'a', sizeof(a));
+	memset(b, 'b', sizeof(b));
+	// the host's pin map has no SS to default to
+	CHECK(!card.init() && card.errorCode() == SD_CARD_ERROR_CHIP_SELECT);
+	for (int sdhc = 1; sdhc >= 0; sdhc--) {
+		emu.sdhc = sdhc;
+		CHECK(card.init(SPI_FULL_SPEED, 8));
+		CHECK(card.multiWriteBlock() == 0xFFFFFFFF);
+		CHECK(!card.writeData(a));
+		CHECK(card.errorCode() == SD_CARD_ERROR_WRITE_MULTIPLE);
+
+		emu.clear();
+		CHECK(card.writeStart(CARD_BLOCKS - 4, 2));
+		CHECK(card.multiWriteBlock() == CARD_BLOCKS - 4);
+		CHECK(card.writeData(a) && card.writeData(b));
+		CHECK(card.multiWriteBlock() == CARD_BLOCKS - 2);
+		CHECK(emu.commands[CMD25] == 1 && emu.blocksWritten == 2);
+
+		// Another command stops the write first
+		CHECK(card.readBlock(CARD_BLOCKS - 3, buf) && memcmp(buf, b, 512) == 0);
+		CHECK(card.multiWriteBlock() == 0xFFFFFFFF && !card.writeData(a));
+		CHECK(card.readBlock(CARD_BLOCKS - 4, buf) && memcmp(buf, a, 512) == 0);
+	}
+	emu.sdhc = true;
+}
+
+int main()
+{
+	int fd = mkstemp(image);
+
+	if (fd < 0) {
+		perror(image);
+		return 1;
+	}
+	close(fd);
+	{
+		SdCardEmulator emu(image, CARD_BLOCKS);
+
+		CHECK(emu.ok());
+		CHECK(fatFormat(emu.file(), CARD_BLOCKS, 4) == 16);
+		CHECK(SD.begin(8));
+		streaming(emu);
+		overflow(emu);
+		sampling(emu);
+		throughput(emu);
+		direct(emu);
+	}
+	unlink(image);
+
+	return testResult();
+}
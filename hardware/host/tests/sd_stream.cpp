@@ -0,0 +1,233 @@
+/*
+ ************************************************************************
+ *	sd_stream.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The SD library on the emulated card: SdFile::read() taking runs of
+ *	contiguous clusters with one multiple block read each, in a
+ *	contiguous file, a fragmented one and from the middle of a block,
+ *	on SDHC and byte addressed cards; readStart()/readData()/readStop()
+ *	used directly, and another command stopping a read that was left
+ *	going. Fewer bytes are clocked than with a read per block.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SdFat.h"
+#include "SdCardEmulator.h"
+#include "FatImage.h"
+#include "HostTest.h"
+
+// 16 MB, FAT16 with 2 KB clusters
+#define CARD_BLOCKS 32768
+#define CLUSTER 2048
+
+static char image[] = "/tmp/sd_streamXXXXXX";
+static Sd2Card card;
+static SdVolume volume;
+static SdFile root;
+static uint8_t data[65536], buf[65536];
+
+static void fill(uint8_t *p, size_t len, uint32_t seed)
+{
+	for (size_t i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		p[i] = seed >> 16;
+	}
+}
+
+static bool mount(SdCardEmulator &emu)
+{
+	root.close();
+	return card.init(SPI_FULL_SPEED, 8) && volume.init(&card) &&
+			root.openRoot(&volume);
+}
+
+static void formatting(SdCardEmulator &emu)
+{
+	CHECK(fatFormat(emu.file(), CARD_BLOCKS, CLUSTER / 512) == 16);
+	CHECK(mount(emu));
+	CHECK(card.type() == SD_CARD_TYPE_SDHC);
+	CHECK(card.cardSize() == CARD_BLOCKS);
+	CHECK(volume.fatType() == 16 && volume.blocksPerCluster() == 4);
+}
+
+// Reads len bytes at pos in one call, no more than read() can return
+static bool readAt(SdFile &file, uint32_t pos, uint16_t len)
+{
+	memset(buf, 0, len);
+	return file.seekSet(pos) && file.read(buf, len) == len;
+}
+
+static void contiguous(SdCardEmulator &emu)
+{
+	SdFile file;
+
+	fill(data, sizeof(data), 1);
+	CHECK(file.createContiguous(&root, "CONTIG.BIN", 60000));
+	CHECK(file.write(data, 60000) == 60000 && file.sync());
+
+	// 60 blocks a block at a time, the FAT still in the cache from writing
+	emu.clear();
+	CHECK(file.seekSet(0));
+	for (int i = 0; i < 60; i++)
+		CHECK(file.read(buf + i * 512, 512) == 512);
+	CHECK(memcmp(buf, data, 30720) == 0);
+	CHECK(emu.commands[CMD17] == 60 && emu.commands[CMD18] == 0);
+	unsigned long clocked = emu.clocked;
+
+	// and with one command, the FAT already in the cache, without the
+	// command, the response and the access time for each block
+	emu.clear();
+	CHECK(readAt(file, 0, 30720) && memcmp(buf, data, 30720) == 0);
+	CHECK(emu.commands[CMD18] == 1 && emu.commands[CMD12] == 1);
+	CHECK(emu.commands[CMD17] == 0);
+	CHECK(emu.blockBytes >= 60 * 512);
+	CHECK(emu.clocked < clocked - 59 * (6 + 2 + emu.latency - emu.gap));
+
+	// From the middle of a block to the end of the file: the first block
+	// through the cache, the whole blocks streamed, then the last part
+	// with the FAT read again for it
+	emu.clear();
+	CHECK(file.seekSet(30100) && file.read(buf, 30000) == 29900);
+	CHECK(memcmp(buf, data + 30100, 29900) == 0);
+	CHECK(emu.commands[CMD18] == 1 && emu.commands[CMD17] <= 3);
+
+	// Less than two blocks is left to the cache
+	emu.clear();
+	CHECK(readAt(file, 4096, 1000) && memcmp(buf, data + 4096, 1000) == 0);
+	CHECK(emu.commands[CMD18] == 0);
+	file.close();
+}
+
+// Two files written a few clusters at a time in turn, so neither is in
+// one piece: a run of 3 clusters of A, then 1 of B, and so on
+static void fragmented(SdCardEmulator &emu)
+{
+	SdFile a, b;
+
+	fill(data, sizeof(data), 2);
+	CHECK(a.open(&root, "A.BIN", O_RDWR | O_CREAT | O_TRUNC));
+	CHECK(b.open(&root, "B.BIN", O_RDWR | O_CREAT | O_TRUNC));
+	for (uint32_t pos = 0; pos < 8 * 3 * CLUSTER; pos += 3 * CLUSTER) {
+		CHECK(a.write(data + pos, 3 * CLUSTER) == 3 * CLUSTER);
+		CHECK(b.write(data, CLUSTER) == CLUSTER);
+	}
+	CHECK(a.sync() && b.sync());
+
+	// 4 runs of A from the start, or 3 from a cluster in
+	emu.clear();
+	CHECK(readAt(a, 0, 4 * 3 * CLUSTER));
+	CHECK(memcmp(buf, data, 4 * 3 * CLUSTER) == 0);
+	CHECK(emu.commands[CMD18] == 4 && emu.commands[CMD17] <= 1);
+	emu.clear();
+	CHECK(readAt(a, CLUSTER, 6 * CLUSTER));
+	CHECK(memcmp(buf, data + CLUSTER, 6 * CLUSTER) == 0);
+	CHECK(emu.commands[CMD18] == 3);
+
+	// B's clusters are all apart, one multiple block read each
+	emu.clear();
+	CHECK(readAt(b, 0, 8 * CLUSTER));
+	for (int i = 0; i < 8; i++)
+		CHECK(memcmp(buf + i * CLUSTER, data, CLUSTER) == 0);
+	CHECK(emu.commands[CMD18] == 8);
+	a.close();
+	b.close();
+}
+
+static void direct(SdCardEmulator &emu)
+{
+	uint8_t block[512];
+
+	// The boot sector and the FATs after it
+	emu.clear();
+	CHECK(card.readStart(0));
+	for (int i = 0; i < 4; i++)
+		CHECK(card.readData(buf + i * 512));
+	CHECK(card.readStop());
+	CHECK(pread(emu.file(), data, 4 * 512, 0) == 4 * 512);
+	CHECK(memcmp(buf, data, 4 * 512) == 0);
+	CHECK(emu.commands[CMD18] == 1 && emu.commands[CMD12] == 1);
+	CHECK(emu.blocksRead >= 4);
+	CHECK(!card.readData(buf));
+
+	// Another command stops a read left going first
+	emu.clear();
+	CHECK(card.readStart(1) && card.readData(buf));
+	CHECK(card.readBlock(0, block) && memcmp(block, data, 512) == 0);
+	CHECK(emu.commands[CMD12] == 1 && emu.commands[CMD17] == 1);
+	CHECK(!card.readData(buf));
+	CHECK(card.errorCode() == SD_CARD_ERROR_READ);
+
+	// Stopping when nothing is going is an error from the card
+	CHECK(!card.readStop() && card.errorCode() == SD_CARD_ERROR_CMD12);
+
+	// Writes go through the block hook too
+	emu.clear();
+	fill(block, 512, 3);
+	CHECK(card.writeBlock(CARD_BLOCKS - 1, block));
+	CHECK(card.readBlock(CARD_BLOCKS - 1, buf) && memcmp(buf, block, 512) == 0);
+	CHECK(emu.blocksWritten == 1 && emu.blockBytes >= 1024);
+}
+
+// A card with byte addresses, the same file read back
+static void byteAddressed(SdCardEmulator &emu)
+{
+	SdFile file;
+
+	emu.sdhc = false;
+	CHECK(mount(emu));
+	CHECK(card.type() == SD_CARD_TYPE_SD2);
+	CHECK(card.cardSize() == CARD_BLOCKS);
+	fill(data, sizeof(data), 1);
+	CHECK(file.open(&root, "CONTIG.BIN", O_READ));
+	emu.clear();
+	CHECK(readAt(file, 2048, 16384) && memcmp(buf, data + 2048, 16384) == 0);
+	CHECK(emu.commands[CMD18] == 1);
+	file.close();
+	emu.sdhc = true;
+	CHECK(mount(emu));
+}
+
+int main()
+{
+	int fd = mkstemp(image);
+
+	if (fd < 0) {
+		perror(image);
+		return 1;
+	}
+	close(fd);
+	{
+		SdCardEmulator emu(image, CARD_BLOCKS);
+
+		CHECK(emu.ok());
+		formatting(emu);
+		contiguous(emu);
+		fragmented(emu);
+		direct(emu);
+		byteAddressed(emu);
+		root.close();
+	}
+	unlink(image);
+
+	return testResult();
+}
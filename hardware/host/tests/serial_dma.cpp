@@ -0,0 +1,220 @@
+/*
+ ************************************************************************
+ *	serial_dma.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	HardwareSerial::beginDMA() receive path: ping-pong transfers into the
+ *	ring buffer, the receive timeout publishing a partly filled half, the
+ *	uDMA running dry when the reader falls a buffer behind, overrun
+ *	accounting, and recovery once the reader catches up. The uDMA model
+ *	itself is checked first.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <sched.h>
+#include <string.h>
+#include "Energia.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/udma.h"
+#include "driverlib/uart.h"
+#include "HostTest.h"
+
+#define TIMEOUT_NS      2000000000ULL
+#define DMA_CHANNEL     (UDMA_CH8_UART0RX & 0xff)
+
+static uint8_t pattern(unsigned long i)
+{
+	return (uint8_t)(i * 7 + (i >> 8));
+}
+
+static void send(unsigned long first, unsigned long len)
+{
+	uint8_t buf[256];
+
+	while (len) {
+		unsigned long n = len < sizeof(buf) ? len : sizeof(buf);
+
+		for (unsigned long i = 0; i < n; i++)
+			buf[i] = pattern(first + i);
+		HostUARTReceive(UART0_BASE, buf, n);
+		first += n;
+		len -= n;
+	}
+}
+
+// Reads len bytes, checking them against the pattern from first on
+static unsigned long receive(unsigned long first, unsigned long len)
+{
+	uint64_t deadline = HostNanos() + TIMEOUT_NS;
+	unsigned long got = 0, bad = 0;
+
+	while (got < len && HostNanos() < deadline) {
+		int c = Serial.read();
+
+		if (c < 0) {
+			sched_yield();
+			continue;
+		}
+		if (c != pattern(first + got))
+			bad++;
+		got++;
+	}
+	CHECK(bad == 0);
+	return got;
+}
+
+static void waitIdle(void)
+{
+	uint64_t deadline = HostNanos() + TIMEOUT_NS;
+
+	while (!HostUARTIdle(UART0_BASE) && HostNanos() < deadline)
+		sched_yield();
+	// Let the receive timeout and the handler run
+	deadline = HostNanos() + 5000000;
+	while (HostNanos() < deadline)
+		sched_yield();
+}
+
+static void udmaModel(void)
+{
+	static tDMAControlTable table[64] __attribute__ ((aligned(1024)));
+	static uint8_t dst[8];
+	const uint8_t src[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	uint32_t mapping = UDMA_CH30_SW;
+	uint32_t ch = mapping & 0xff;
+	unsigned int n;
+	bool done;
+
+	uDMAEnable();
+	if (!uDMAControlBaseGet())
+		uDMAControlBaseSet(table);
+	uDMAChannelAssign(mapping);
+	uDMAChannelAttributeDisable(ch, UDMA_ATTR_ALL);
+	uDMAChannelControlSet(ch | UDMA_PRI_SELECT, UDMA_SIZE_8 |
+			UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_2);
+	uDMAChannelControlSet(ch | UDMA_ALT_SELECT, UDMA_SIZE_8 |
+			UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_2);
+	uDMAChannelTransferSet(ch | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+			0, dst, 3);
+	uDMAChannelTransferSet(ch | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+			0, dst + 3, 3);
+	uDMAChannelEnable(ch);
+
+	HostSimLock();
+	// A burst moves one arbitration's worth
+	n = HostUDMARequest(mapping, true, src, 8, &done);
+	CHECK(n == 2 && !done);
+	// A single request moves one item and completes the primary
+	n = HostUDMARequest(mapping, false, src + 2, 6, &done);
+	CHECK(n == 1 && done);
+	CHECK(uDMAChannelModeGet(ch | UDMA_PRI_SELECT) == UDMA_MODE_STOP);
+	CHECK(uDMAChannelSizeGet(ch | UDMA_ALT_SELECT) == 3);
+	// The alternate carries on, then the channel runs dry
+	n = HostUDMARequest(mapping, true, src + 3, 5, &done);
+	CHECK(n == 2 && !done);
+	n = HostUDMARequest(mapping, true, src + 5, 3, &done);
+	CHECK(n == 1 && done);
+	CHECK(!uDMAChannelIsEnabled(ch));
+	CHECK(HostUDMARequest(mapping, true, src, 8, &done) == 0);
+	HostSimUnlock();
+	CHECK(memcmp(dst, src, 6) == 0 && dst[6] == 0);
+
+	// Single requests are ignored with USEBURST
+	uDMAChannelTransferSet(ch | UDMA_PRI_SELECT, UDMA_MODE_BASIC, 0, dst, 4);
+	uDMAChannelAttributeEnable(ch, UDMA_ATTR_USEBURST);
+	uDMAChannelAttributeDisable(ch, UDMA_ATTR_ALTSELECT);
+	uDMAChannelEnable(ch);
+	HostSimLock();
+	CHECK(HostUDMARequest(mapping, false, src, 1, &done) == 0);
+	CHECK(HostUDMARequest(mapping, true, src, 1, &done) == 1);
+	HostSimUnlock();
+
+	HostUDMAStats stats;
+	HostUDMAStatsGet(ch, &stats);
+	CHECK(stats.items == 7 && stats.completions == 2 && stats.stalls == 1);
+	uDMAChannelDisable(ch);
+}
+
+int main()
+{
+	HostUARTStats uart;
+	HostUDMAStats dma;
+	unsigned long got;
+
+	udmaModel();
+
+	Serial.setBufferSize(256, 256);
+	Serial.beginDMA(115200);
+	HostUDMAStatsReset(DMA_CHANNEL);
+
+	// A stream that is not a whole number of halves: the tail end is
+	// published by the receive timeout.
+	send(0, 10000);
+	got = receive(0, 10000);
+	CHECK(got == 10000);
+	HostUDMAStatsGet(DMA_CHANNEL, &dma);
+	printf("  stream: %lu bytes, %u transfers, %u irqs\n", got,
+			dma.completions, HostIntCount(INT_UART0));
+	CHECK(dma.items == 10000 && dma.completions == 10000 / 128);
+
+	// A short message well inside a half
+	send(10000, 5);
+	got = receive(10000, 5);
+	CHECK(got == 5 && Serial.available() == 0);
+
+	// The reader stops while a paced line keeps sending: the rest of the
+	// current half, the other half and the FIFO fill up, everything after
+	// that is lost to overruns.
+	unsigned long room = 256 - 10005 % 128;
+
+	HostUARTSetLineRate(UART0_BASE, 1000000);
+	HostUARTStatsReset(UART0_BASE);
+	HostUDMAStatsReset(DMA_CHANNEL);
+	send(0, 1000);
+	waitIdle();
+	HostUARTStatsGet(UART0_BASE, &uart);
+	HostUDMAStatsGet(DMA_CHANNEL, &dma);
+	printf("  overrun: %u bytes lost, %lu overrun interrupts\n",
+			uart.rxOverruns, Serial.rxOverruns());
+	CHECK(Serial.available() == (int)room);
+	CHECK(dma.stalls == 1);
+	CHECK(uart.rxOverruns == 1000 - room - 16);
+	CHECK(Serial.rxOverruns() > 0);
+
+	// Catching up restarts the uDMA, which picks up what waited in the FIFO
+	got = receive(0, room + 16);
+	CHECK(got == room + 16 && Serial.available() == 0);
+
+	// and reception carries on as before
+	HostUARTSetLineRate(UART0_BASE, 0);
+	send(20000, 3000);
+	got = receive(20000, 3000);
+	CHECK(got == 3000 && Serial.available() == 0);
+
+	// begin() goes back to the interrupt driven receiver
+	Serial.begin(115200);
+	HostUDMAStatsReset(DMA_CHANNEL);
+	send(30000, 1000);
+	got = receive(30000, 1000);
+	HostUDMAStatsGet(DMA_CHANNEL, &dma);
+	CHECK(got == 1000 && dma.items == 0);
+
+	return testResult();
+}
@@ -0,0 +1,280 @@
+/*
+ ************************************************************************
+ *	sharp_lcd.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	LCD_SharpBoosterPack_SPI against a model of the Sharp memory display
+ *	on the BoosterPack SSI, which takes the clear, VCOM and multiple line
+ *	write commands while its chip select is high and keeps the panel they
+ *	leave. The bytes each flush() sends, for the updates a sketch makes:
+ *	the first screen of text, a clock digit changing, a single pixel,
+ *	nothing changed, the buffer cleared and drawn again the same, and a
+ *	reverseFlush() of the whole screen; after each the panel is what the
+ *	buffer holds.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+#include "Energia.h"
+#include "inc/hw_memmap.h"
+#include "LCD_SharpBoosterPack_SPI.h"
+#include "HostTest.h"
+
+#define PIN_CS 6
+#define PIN_DISP 5
+#define PIN_VCC 2
+#define LINE_BYTES (LCD_HORIZONTAL_MAX / 8)
+// the command, address, data and trailer of every line, and the last trailer
+#define FULL_FRAME (1 + LCD_VERTICAL_MAX * (LINE_BYTES + 2) + 1)
+
+extern unsigned char DisplayBuffer[LCD_VERTICAL_MAX][LCD_HORIZONTAL_MAX / 8];
+
+//
+// The display: a transfer starts with a command byte once the chip select
+// goes high. A write is followed by lines of an address, the data and a
+// trailer, and ends with a trailer where an address would be.
+//
+static struct {
+	uint32_t port;
+	uint8_t cs;
+	bool selected;
+	int pos, line;
+	uint8_t command;
+	uint8_t panel[LCD_VERTICAL_MAX][LINE_BYTES];
+	unsigned long bytes, writeBytes, lines, clears, vcoms, errors;
+} display;
+
+static uint8_t reverseBits(uint8_t b)
+{
+	uint8_t r = 0;
+
+	for (int i = 0; i < 8; i++)
+		r |= (b >> i & 1) << (7 - i);
+	return r;
+}
+
+static uint8_t displayTransfer(uint32_t base, uint8_t out, void *arg)
+{
+	if (!display.selected)
+		return 0xFF;
+	display.bytes++;
+	if (display.pos++ == 0) {
+		display.command = out;
+		if (out & 0x80)
+			display.writeBytes++;
+		else if (out & 0x20)
+			display.clears++;
+		else
+			display.vcoms++;
+		display.line = -1;
+		return 0;
+	}
+	if (!(display.command & 0x80))
+		return 0;
+	display.writeBytes++;
+
+	// 0: address or last trailer, 1..LINE_BYTES: data, then the trailer
+	int at = (display.pos - 2) % (LINE_BYTES + 2);
+
+	if (at == 0) {
+		display.line = out ? reverseBits(out) - 1 : -1;
+		if (display.line >= LCD_VERTICAL_MAX)
+			display.errors++;
+	} else if (at <= LINE_BYTES) {
+		if (display.line >= 0 && display.line < LCD_VERTICAL_MAX)
+			display.panel[display.line][at - 1] = out;
+		else
+			display.errors++;
+	} else {
+		if (out != 0)
+			display.errors++;
+		display.lines++;
+	}
+	return 0;
+}
+
+static void displayWatch(uint32_t port, uint8_t before, uint8_t after)
+{
+	if (port != display.port || !((before ^ after) & display.cs))
+		return;
+	display.selected = after & display.cs;
+	display.pos = 0;
+	if (!display.selected && (display.command & 0xA0) == 0x20)
+		memset(display.panel, 0xFF, sizeof(display.panel));
+}
+
+static void attach(void)
+{
+	display.port = port_to_base[digitalPinToPort(PIN_CS)];
+	display.cs = digitalPinToBitMask(PIN_CS);
+	memset(display.panel, 0, sizeof(display.panel));
+	HostSSISetDevice(SSI2_BASE, displayTransfer, 0);
+	HostGPIOSetWatch(displayWatch);
+}
+
+static void startCount(void)
+{
+	display.bytes = display.writeBytes = display.lines = 0;
+	display.clears = display.vcoms = 0;
+}
+
+static bool shown(void)
+{
+	return memcmp(display.panel, DisplayBuffer, sizeof(display.panel)) == 0;
+}
+
+// Lines of the buffer that differ from before
+static int changedLines(const uint8_t before[LCD_VERTICAL_MAX][LINE_BYTES])
+{
+	int n = 0;
+
+	for (int y = 0; y < LCD_VERTICAL_MAX; y++)
+		n += memcmp(before[y], DisplayBuffer[y], LINE_BYTES) != 0;
+	return n;
+}
+
+static void begin(LCD_SharpBoosterPack_SPI &lcd)
+{
+	startCount();
+	lcd.begin();
+	// the clear and the VCOM toggle after it, the buffer already shown
+	CHECK(display.clears == 1 && display.vcoms == 1);
+	CHECK(display.bytes == 4 && display.writeBytes == 0);
+	CHECK(shown());
+
+	// a flush with nothing drawn only toggles VCOM
+	startCount();
+	lcd.flush();
+	CHECK(display.writeBytes == 0 && display.vcoms == 1);
+}
+
+static void clock(LCD_SharpBoosterPack_SPI &lcd)
+{
+	uint8_t before[LCD_VERTICAL_MAX][LINE_BYTES];
+	int changed;
+
+	// the first screen: a title and the time, their lines only
+	memcpy(before, DisplayBuffer, sizeof(before));
+	lcd.setFont(0);
+	lcd.text(10, 10, "Clock");
+	lcd.setFont(1);
+	lcd.text(10, 40, "12:34");
+	changed = changedLines(before);
+	CHECK(changed > 0 && changed <= 8 + 16);
+	startCount();
+	lcd.flush();
+	CHECK(display.lines == changed);
+	CHECK(display.writeBytes == 2 + changed * (LINE_BYTES + 2));
+	CHECK(display.vcoms == 1);
+	CHECK(shown());
+
+	// a digit of the time changing, drawn over the old one
+	memcpy(before, DisplayBuffer, sizeof(before));
+	lcd.text(10, 40, "12:35");
+	changed = changedLines(before);
+	CHECK(changed > 0 && changed <= 16);
+	startCount();
+	lcd.flush();
+	CHECK(display.lines == changed);
+	CHECK(display.writeBytes == 2 + changed * (LINE_BYTES + 2));
+	CHECK(display.writeBytes < FULL_FRAME / 5);
+	CHECK(shown());
+
+	// the same again changes nothing
+	lcd.text(10, 40, "12:35");
+	startCount();
+	lcd.flush();
+	CHECK(display.writeBytes == 0);
+	CHECK(shown());
+}
+
+static void pixel(LCD_SharpBoosterPack_SPI &lcd)
+{
+	lcd.setXY(80, 90, 1);
+	startCount();
+	lcd.flush();
+	CHECK(display.lines == 1);
+	CHECK(display.writeBytes == 2 + LINE_BYTES + 2);
+	CHECK(shown());
+
+	// off the screen is not drawn, nor does it dirty a line
+	lcd.setXY(50, LCD_VERTICAL_MAX, 1);
+	lcd.setXY(LCD_HORIZONTAL_MAX, 50, 1);
+	startCount();
+	lcd.flush();
+	CHECK(display.writeBytes == 0);
+}
+
+static void redraw(LCD_SharpBoosterPack_SPI &lcd)
+{
+	uint8_t before[LCD_VERTICAL_MAX][LINE_BYTES];
+
+	// a sketch drawing each screen from a cleared buffer: the lines with
+	// something on them go again, the blank ones do not
+	memcpy(before, DisplayBuffer, sizeof(before));
+	lcd.clearBuffer();
+	lcd.setFont(0);
+	lcd.text(10, 10, "Clock");
+	lcd.setFont(1);
+	lcd.text(10, 40, "12:35");
+	CHECK(changedLines(before) == 1);
+	startCount();
+	lcd.flush();
+	CHECK(display.lines > 0 && display.lines <= 8 + 16 + 1);
+	CHECK(display.writeBytes == 2 + display.lines * (LINE_BYTES + 2));
+	CHECK(shown());
+}
+
+static void reversed(LCD_SharpBoosterPack_SPI &lcd)
+{
+	startCount();
+	lcd.reverseFlush();
+	CHECK(display.lines == LCD_VERTICAL_MAX);
+	CHECK(display.writeBytes == FULL_FRAME);
+	CHECK(shown());
+
+	// cleared in reverse, the white screen differs from every line
+	lcd.setReverse(true);
+	lcd.clear();
+	startCount();
+	lcd.flush();
+	CHECK(display.writeBytes == FULL_FRAME);
+	CHECK(shown());
+	lcd.setReverse(false);
+	lcd.clear();
+	startCount();
+	lcd.flush();
+	CHECK(display.writeBytes == 0);
+	CHECK(shown());
+}
+
+int main()
+{
+	LCD_SharpBoosterPack_SPI lcd(PIN_CS, PIN_DISP, PIN_VCC, false);
+
+	attach();
+	begin(lcd);
+	clock(lcd);
+	pixel(lcd);
+	redraw(lcd);
+	reversed(lcd);
+	CHECK(display.errors == 0);
+
+	return testResult();
+}
@@ -0,0 +1,186 @@
+/*
+ ************************************************************************
+ *	string.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	String storage: short strings kept inside the object, the switch to
+ *	the heap and the growth policy, concatenation results and temporaries
+ *	being taken over instead of copied, appending a string to itself, and
+ *	invalid strings. Heap calls are counted by wrapping the C library's
+ *	allocator.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "WString.h"
+#include "HostTest.h"
+
+static unsigned long allocations;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+}
+
+// Both the characters and the length agree with expected
+static bool same(const String &s, const char *expected)
+{
+	return s.c_str() && strcmp(s.c_str(), expected) == 0 &&
+			s.length() == strlen(expected);
+}
+
+static void shortStrings(void)
+{
+	unsigned long start = allocations;
+
+	{
+		String empty;
+		String c('x');
+		String n(-12345);
+		String h(0xbeefUL, 16);
+		String longest("0123456789abcde");
+
+		CHECK(same(empty, "") && empty);
+		CHECK(same(c, "x") && same(n, "-12345") && same(h, "beef"));
+		CHECK(same(longest, "0123456789abcde"));
+
+		String copy(longest);
+		copy = n;
+		copy += 'y';
+		CHECK(same(copy, "-12345y"));
+		CHECK(n == "-12345" && n < copy && copy.startsWith(n));
+	}
+	CHECK(allocations == start);
+
+	// One more character moves to the heap, and back never
+	String s("0123456789abcde");
+	s += 'f';
+	CHECK(allocations == start + 1 && same(s, "0123456789abcdef"));
+	s = "a";
+	CHECK(allocations == start + 1 && same(s, "a"));
+}
+
+static void growth(void)
+{
+	String s;
+	unsigned long start = allocations;
+
+	for (int i = 0; i < 10000; i++)
+		s += (char)('a' + i % 26);
+	CHECK(s.length() == 10000 && s[9999] == 'a' + 9999 % 26);
+	// Half again each time: 16 * 1.5^n passes 10000 after 16 steps
+	CHECK(allocations - start <= 17);
+
+	// An explicit reserve() is honoured and concat() stays within it
+	String r;
+	start = allocations;
+	CHECK(r.reserve(5000));
+	for (int i = 0; i < 5000; i++)
+		r += 'z';
+	CHECK(allocations - start == 1 && r.length() == 5000);
+}
+
+static void moves(void)
+{
+	String a("The quick brown fox ");
+	String b("jumps over the lazy dog");
+	unsigned long start = allocations;
+
+	// One temporary, grown in place and then taken over: a copy of a,
+	// two reallocations and no copy of the result
+	String sum = a + b + ", " + 42;
+	CHECK(same(sum, "The quick brown fox jumps over the lazy dog, 42"));
+	CHECK(allocations - start == 3);
+
+	start = allocations;
+	sum = a + b;
+	CHECK(same(sum, "The quick brown fox jumps over the lazy dog"));
+	CHECK(allocations - start == 2);
+
+	// Short results are copied out of the temporary
+	String small = String("ab") + "cd";
+	CHECK(same(small, "abcd"));
+
+	String taken(static_cast<String &&>(sum));
+	CHECK(same(taken, "The quick brown fox jumps over the lazy dog"));
+	CHECK(!sum && sum.length() == 0);
+	sum = static_cast<String &&>(small);
+	CHECK(same(sum, "abcd") && !small);
+
+	// reserve() makes an invalid string valid again
+	String invalid((const char *)0);
+	CHECK(!invalid && invalid.length() == 0);
+	CHECK(invalid.reserve(0) && same(invalid, ""));
+}
+
+static void aliasing(void)
+{
+	String s("abc");
+
+	// Each append crosses into, or reallocates, the heap buffer
+	for (int i = 0; i < 6; i++)
+		s += s;
+	CHECK(s.length() == 3 * 64);
+	CHECK(s.indexOf("cab") == 2 && s.lastIndexOf("abc") == 189);
+
+	String t("0123456789abcd");
+	t += t.c_str() + 10;
+	CHECK(same(t, "0123456789abcdabcd"));
+}
+
+static void operations(void)
+{
+	String s("  Hello, World  ");
+
+	s.trim();
+	CHECK(same(s, "Hello, World"));
+	s.replace("World", "wonderful world");
+	CHECK(same(s, "Hello, wonderful world"));
+	s.replace("wonderful ", "");
+	s.toUpperCase();
+	CHECK(same(s, "HELLO, WORLD"));
+	s.remove(5, 2);
+	CHECK(same(s, "HELLOWORLD") && same(s.substring(5), "WORLD"));
+	CHECK(same(s.substring(2, 4), "LL"));
+	CHECK(String("123").toInt() == 123);
+}
+
+int main()
+{
+	shortStrings();
+	growth();
+	moves();
+	aliasing();
+	operations();
+
+	return testResult();
+}
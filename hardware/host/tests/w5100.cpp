@@ -0,0 +1,221 @@
+/*
+ ************************************************************************
+ *	w5100.cpp
+ *
+ *	Host simulation of the Tiva-C HAL
+ *
+ *	The Ethernet library on a model of a W5100: the addresses written
+ *	through the buffer frames, a request sent around the end of the
+ *	transmit buffer, and a response read back through read(), peek(),
+ *	short and long read(buf)s across many turns of the receive buffer,
+ *	with the frames a byte costs once reads are served from the cache.
+ *	A stopped client leaves nothing cached for the next connection.
+ *	SPI.transfer(buf, count) in both bit orders, with no frame lost to
+ *	the RX FIFO.
+ *
+ ***********************************************************************
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "SPI.h"
+#include "Ethernet.h"
+#include "W5100Model.h"
+#include "HostTest.h"
+
+static uint8_t mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
+static uint8_t body[10000];
+
+static uint8_t pattern(size_t i)
+{
+	return i * 7 + (i >> 8);
+}
+
+static void setup(W5100Model &w5100)
+{
+	uint8_t ip[4] = { 192, 168, 1, 177 };
+
+	Ethernet.begin(mac, IPAddress(ip));
+	CHECK(memcmp(&w5100.mem[0x0009], mac, 6) == 0);
+	CHECK(memcmp(&w5100.mem[0x000F], ip, 4) == 0);
+	CHECK(Ethernet.localIP() == IPAddress(ip));
+
+	for (size_t i = 0; i < sizeof(body); i++)
+		body[i] = pattern(i);
+	w5100.serve(body, sizeof(body));
+}
+
+// The bytes of the request sent, or 0 if the client did not connect
+static size_t connect(EthernetClient &client, W5100Model &w5100, size_t padding)
+{
+	char header[96];
+	size_t sent;
+
+	if (!client.connect(IPAddress(192, 168, 1, 1), 80))
+		return 0;
+	sent = client.print("GET /data HTTP/1.1\r\n");
+	// long enough to take the transmit pointer around the buffer's end
+	for (size_t i = 0; i < padding; i++) {
+		snprintf(header, sizeof(header), "X-Padding-%u: %060u\r\n",
+				(unsigned)i, (unsigned)i);
+		sent += client.print(header);
+	}
+	return sent + client.print("\r\n");
+}
+
+static void transmit(W5100Model &w5100)
+{
+	EthernetClient client;
+	size_t sent = connect(client, w5100, 40);
+
+	CHECK(sent > 2048 && w5100.requestLen == sent);
+	CHECK(strncmp(w5100.request, "GET /data HTTP/1.1\r\n", 20) == 0);
+	CHECK(strstr(w5100.request, "X-Padding-39: ") != 0);
+	CHECK(w5100.sockReg16(0, 0x24) == w5100.requestLen);
+	client.stop();
+}
+
+static void receive(W5100Model &w5100)
+{
+	EthernetClient client;
+	uint8_t buf[1500];
+	size_t got = 0;
+	bool ok = true;
+
+	CHECK(connect(client, w5100, 0));
+	CHECK(client.connected() && client.available() == 2048);
+
+	// a byte at a time, with a peek between
+	while (got < 100) {
+		int c = client.peek();
+
+		ok &= c == body[got];
+		ok &= client.read() == body[got];
+		got++;
+	}
+	CHECK(ok);
+
+	// a byte at a time is a byte of frames and a little
+	w5100.clear();
+	for (int i = 0; i < 640; i++)
+		ok &= client.read() == body[got++];
+	CHECK(ok);
+	CHECK(w5100.frames < 640 * 5 / 4);
+	CHECK(w5100.commands[Sock_RECV] == 10);
+
+	// short reads from what is cached, long ones straight from the chip
+	while (got < sizeof(body)) {
+		size_t want = got % 3 ? 5 : sizeof(buf);
+		int n = client.read(buf, want);
+
+		if (n <= 0) {
+			ok = false;
+			break;
+		}
+		ok &= memcmp(buf, body + got, n) == 0;
+		got += n;
+	}
+	CHECK(ok && got == sizeof(body));
+	CHECK(client.read() == -1 && client.available() == 0);
+	CHECK(!client.connected());
+	client.stop();
+}
+
+static void reconnect(W5100Model &w5100)
+{
+	EthernetClient client;
+	uint8_t buf[3];
+
+	// leave most of a cache's worth unread
+	CHECK(connect(client, w5100, 0));
+	CHECK(client.read(buf, sizeof(buf)) == 3 && buf[2] == body[2]);
+	CHECK(client.available() > 2000);
+	client.stop();
+	CHECK(connect(client, w5100, 0));
+	CHECK(client.peek() == body[0] && client.read() == body[0]);
+	CHECK(client.read() == body[1]);
+	client.stop();
+}
+
+//
+// A device that hands back the byte before, to see what went out
+//
+static uint8_t last, seen[8];
+static int count;
+
+static uint8_t echo(uint32_t base, uint8_t out, void *arg)
+{
+	uint8_t in = last;
+
+	if (count < 8)
+		seen[count++] = out;
+	last = out;
+	return in;
+}
+
+static void transfers(void)
+{
+	uint8_t buf[20];
+	HostSSIStats stats;
+	bool ok = true;
+
+	HostSSISetDevice(SSI2_BASE, echo, 0);
+	HostSSIStatsReset(SSI2_BASE);
+	last = 0xA5;
+	for (size_t i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 13;
+	SPI.transfer(buf, sizeof(buf));
+	CHECK(buf[0] == 0xA5);
+	for (size_t i = 1; i < sizeof(buf); i++)
+		ok &= buf[i] == (uint8_t)((i - 1) * 13);
+	CHECK(ok);
+	HostSSIStatsGet(SSI2_BASE, &stats);
+	CHECK(stats.frames == sizeof(buf) && stats.overruns == 0);
+
+	SPI.setBitOrder(LSBFIRST);
+	count = 0;
+	last = 0x80;
+	buf[0] = 0x01;
+	buf[1] = 0x0F;
+	SPI.transfer(buf, 2);
+	CHECK(seen[0] == 0x80 && seen[1] == 0xF0);
+	CHECK(buf[0] == 0x01 && buf[1] == 0x01);
+	CHECK(SPI.transfer(0x03) == 0x0F && last == 0xC0);
+	SPI.setBitOrder(MSBFIRST);
+	HostSSISetDevice(SSI2_BASE, 0, 0);
+}
+
+int main()
+{
+	HostSSIStats stats;
+
+	{
+		W5100Model w5100;
+
+		setup(w5100);
+		HostSSIStatsReset(SSI2_BASE);
+		w5100.clear();
+		transmit(w5100);
+		receive(w5100);
+		reconnect(w5100);
+		HostSSIStatsGet(SSI2_BASE, &stats);
+		CHECK(stats.overruns == 0);
+	}
+	transfers();
+
+	return testResult();
+}
@@ -290,6 +290,37 @@ extern const uint32_t digital_pin_to_analog_in[];
 #define portCellID2Register(P)    ((volatile uint32_t *)( port_to_base[P] + 0xFF8 ))
 #define portCellID3Register(P)    ((volatile uint32_t *)( port_to_base[P] + 0xFFC ))
 
+// A pin looked up once for fastWrite(), fastRead() and fastToggle(): the
+// address in its port's DATA register that sees only its bit, DATA +
+// (bit << 2), so that each is a single load or store with no call, no
+// table lookup and no read-modify-write. Implemented in wiring_digital.c
+typedef struct {
+    volatile uint32_t *data;
+} PinHandle;
+
+PinHandle pinHandle(uint8_t pin);
+
+// DATA register accesses of the handles, which a host build replaces
+#ifndef pinDataWrite
+#define pinDataWrite(A, V)        (*(A) = (V))
+#define pinDataRead(A)            (*(A))
+#endif
+
+static inline void fastWrite(PinHandle pin, uint8_t val)
+{
+    pinDataWrite(pin.data, val ? 0xFF : 0);
+}
+
+static inline int fastRead(PinHandle pin)
+{
+    return pinDataRead(pin.data) ? HIGH : LOW;
+}
+
+static inline void fastToggle(PinHandle pin)
+{
+    pinDataWrite(pin.data, ~pinDataRead(pin.data));
+}
+
 // Implemented in wiring.c
 void delayMicroseconds(unsigned int us);
 unsigned long micros();
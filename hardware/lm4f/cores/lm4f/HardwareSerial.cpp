@@ -50,15 +50,30 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
+#include "driverlib/udma.h"
 #include "HardwareSerial.h"
 
-#define TX_BUFFER_EMPTY    (txReadIndex == txWriteIndex)
-#define TX_BUFFER_FULL     (((txWriteIndex + 1) % txBufferSize) == txReadIndex)
-
-#define RX_BUFFER_EMPTY    (rxReadIndex == rxWriteIndex)
-#define RX_BUFFER_FULL     (((rxWriteIndex + 1) % rxBufferSize) == rxReadIndex)
+#define TX_BUFFER_EMPTY    (txBuffer.empty())
 
 #define UART_BASE g_ulUARTBase[uartModule]
+#define UART_RX_DMA_CHANNEL (g_ulUARTRxDMA[uartModule] & 0xff)
+
+//
+// DMA receive: the UART asks for a burst once its FIFO is half full (8
+// bytes) and the uDMA moves RX_DMA_BURST of them. Taking less than the
+// trigger level always leaves something in the FIFO, so the receive
+// timeout fires once the line goes idle. Each half of the receive buffer
+// is one uDMA transfer.
+//
+#define RX_DMA_BURST        4
+#define RX_DMA_MAX_TRANSFER 1024
+
+#if defined(PART_TM4C129XNCZAD) || defined(PART_TM4C1294NCPDT)
+// These parts signal a finished receive transfer only with DMARX unmasked
+#define UART_INT_RX_DMA     (UART_INT_RT | UART_INT_OE | UART_INT_DMARX)
+#else
+#define UART_INT_RX_DMA     (UART_INT_RT | UART_INT_OE)
+#endif
 
 static const unsigned long g_ulUARTBase[8] =
 {
@@ -88,6 +103,25 @@ static const unsigned long g_ulUARTPeriph[8] =
 	SYSCTL_PERIPH_UART3, SYSCTL_PERIPH_UART4, SYSCTL_PERIPH_UART5,
 	SYSCTL_PERIPH_UART6, SYSCTL_PERIPH_UART7
 };
+//*****************************************************************************
+//
+// The list of uDMA channel mappings for the UART receivers.
+//
+//*****************************************************************************
+static const unsigned long g_ulUARTRxDMA[8] =
+{
+    UDMA_CH8_UART0RX, UDMA_CH22_UART1RX, UDMA_CH12_UART2RX, UDMA_CH16_UART3RX,
+    UDMA_CH18_UART4RX, UDMA_CH6_UART5RX, UDMA_CH10_UART6RX, UDMA_CH20_UART7RX
+};
+
+//*****************************************************************************
+//
+// The uDMA channel control table, used by beginDMA() unless something else
+// has already set one up.
+//
+//*****************************************************************************
+static tDMAControlTable g_sDMAControlTable[64] __attribute__ ((aligned(1024)));
+
 //*****************************************************************************
 //
 // The list of UART GPIO configurations.
@@ -157,30 +191,28 @@ static const unsigned long g_ulUARTPins[8] =
 // Constructors ////////////////////////////////////////////////////////////////
 HardwareSerial::HardwareSerial(void)
 {
-    txWriteIndex = 0;
-    txReadIndex = 0;
-    rxWriteIndex = 0;
-    rxReadIndex = 0;
     uartModule = 0;
 
-    txBuffer = (unsigned char *) 0xFFFFFFFF;
-    rxBuffer = (unsigned char *) 0xFFFFFFFF;
+    txStorage = 0;
+    rxStorage = 0;
     txBufferSize = SERIAL_BUFFER_SIZE;
     rxBufferSize = SERIAL_BUFFER_SIZE;
+    rxDma = false;
+    rxDmaWaiting = false;
+    rxOverrunCount = 0;
 }
 
 HardwareSerial::HardwareSerial(unsigned long module) 
 {
-    txWriteIndex = 0;
-    txReadIndex = 0;
-    rxWriteIndex = 0;
-    rxReadIndex = 0;
     uartModule = module;
 
-    txBuffer = (unsigned char *) 0xFFFFFFFF;
-    rxBuffer = (unsigned char *) 0xFFFFFFFF;
+    txStorage = 0;
+    rxStorage = 0;
     txBufferSize = SERIAL_BUFFER_SIZE;
     rxBufferSize = SERIAL_BUFFER_SIZE;
+    rxDma = false;
+    rxDmaWaiting = false;
+    rxOverrunCount = 0;
 }
 // Private Methods //////////////////////////////////////////////////////////////
 void
@@ -189,16 +221,14 @@ HardwareSerial::flushAll(void)
     // wait for transmission of outgoing data
     while(!TX_BUFFER_EMPTY)
     {
+        primeTransmit(UART_BASE);
     }
     while (ROM_UARTBusy(UART_BASE)) ;
-    txReadIndex = 0;
-    txWriteIndex = 0;
 
     //
     // Flush the receive buffer.
     //
-    rxReadIndex = 0;
-    rxWriteIndex = 0;
+    rxBuffer.clear();
 }
 
 void
@@ -215,17 +245,12 @@ HardwareSerial::primeTransmit(unsigned long ulBase)
         //
         ROM_IntDisable(g_ulUARTInt[uartModule]);
         //
-        // Yes - take some characters out of the transmit buffer and feed
-        // them to the UART transmit FIFO.
+        // Yes - fill whatever space the transmit FIFO has. Anything left in
+        // the buffer is moved by the TX interrupt as the FIFO drains.
         //
-        while(!TX_BUFFER_EMPTY)
+        while(!TX_BUFFER_EMPTY && ROM_UARTSpaceAvail(ulBase))
         {
-            while(ROM_UARTSpaceAvail(ulBase) && !TX_BUFFER_EMPTY){
-                ROM_UARTCharPutNonBlocking(ulBase,
-                                       txBuffer[txReadIndex]);
-
-                txReadIndex = (txReadIndex + 1) % txBufferSize;
-            }
+            ROM_UARTCharPutNonBlocking(ulBase, txBuffer.pop());
         }
 
         //
@@ -235,12 +260,170 @@ HardwareSerial::primeTransmit(unsigned long ulBase)
     }
 }
 
+//
+// DMA receive
+//
+// The receive buffer is split in two halves which the uDMA fills in
+// ping-pong mode, the primary control structure always the first half and
+// the alternate one the second, straight into the ring buffer's storage.
+// The interrupt handler only moves the ring's write index: to the end of a
+// half once its transfer completes, and to wherever the current transfer
+// has got to when the receive timeout says the line went idle. A finished
+// half is handed back to the uDMA once everything in it has been read; if
+// the reader falls behind by a whole buffer the uDMA runs dry, the FIFO
+// fills and the UART counts overruns.
+//
+void
+HardwareSerial::rxDmaStop(void)
+{
+    if(!rxDma)
+        return;
+
+    ROM_UARTDMADisable(UART_BASE, UART_DMA_RX);
+    ROM_uDMAChannelDisable(UART_RX_DMA_CHANNEL);
+    rxDma = false;
+    rxDmaWaiting = false;
+}
+
+void
+HardwareSerial::rxDmaArm(unsigned int half)
+{
+    unsigned int size = rxBuffer.capacity() / 2;
+
+    ROM_uDMAChannelTransferSet(UART_RX_DMA_CHANNEL |
+                               (half ? UDMA_ALT_SELECT : UDMA_PRI_SELECT),
+                               UDMA_MODE_PINGPONG,
+                               (void *)(UART_BASE + UART_O_DR),
+                               rxBuffer.buffer() + half * size, size);
+    rxDmaArmed |= 1 << half;
+}
+
+void
+HardwareSerial::rxDmaPublish(unsigned int head)
+{
+    if((int)(head - rxDmaHead) > 0)
+    {
+        rxBuffer.commit(head - rxDmaHead);
+        rxDmaHead = head;
+    }
+}
+
+void
+HardwareSerial::rxDmaRetire(void)
+{
+    unsigned long ulChannel = UART_RX_DMA_CHANNEL;
+
+    //
+    // Publish every half the uDMA has finished, in the order it filled them.
+    //
+    while((rxDmaArmed & (1 << rxDmaFill)) &&
+          ROM_uDMAChannelModeGet(ulChannel | (rxDmaFill ? UDMA_ALT_SELECT :
+                                              UDMA_PRI_SELECT)) ==
+          UDMA_MODE_STOP)
+    {
+        rxDmaArmed &= ~(1 << rxDmaFill);
+        rxDmaFill ^= 1;
+        rxDmaStart += rxBuffer.capacity() / 2;
+        rxDmaPublish(rxDmaStart);
+    }
+}
+
+void
+HardwareSerial::rxDmaFlush(void)
+{
+    unsigned long ulChannel = UART_RX_DMA_CHANNEL;
+    unsigned long ulLeft;
+
+    //
+    // Less than a burst is left in the FIFO. Let the uDMA take single bytes
+    // until it is empty, then publish what the current transfer has landed.
+    //
+    ROM_uDMAChannelAttributeDisable(ulChannel, UDMA_ATTR_USEBURST);
+    while(ROM_UARTCharsAvail(UART_BASE) && ROM_uDMAChannelIsEnabled(ulChannel))
+        ;
+    ROM_uDMAChannelAttributeEnable(ulChannel, UDMA_ATTR_USEBURST);
+
+    rxDmaRetire();
+    if(rxDmaArmed & (1 << rxDmaFill))
+    {
+        ulLeft = ROM_uDMAChannelSizeGet(ulChannel | (rxDmaFill ?
+                                        UDMA_ALT_SELECT : UDMA_PRI_SELECT));
+        rxDmaPublish(rxDmaStart + rxBuffer.capacity() / 2 - ulLeft);
+    }
+}
+
+void
+HardwareSerial::rxDmaReload(void)
+{
+    unsigned long ulChannel = UART_RX_DMA_CHANNEL;
+    unsigned int size = rxBuffer.capacity() / 2;
+    unsigned int tail = rxDmaHead - rxBuffer.available();
+    unsigned int start = rxDmaStart;
+    unsigned int half, i;
+
+    //
+    // Re-arm the idle halves in the order they are due, each only once the
+    // data it held from its previous transfer has been read.
+    //
+    for(i = 0; i < 2; i++, start += size)
+    {
+        half = rxDmaFill ^ i;
+        if(rxDmaArmed & (1 << half))
+            continue;
+        if((int)(tail - (start - size)) < 0)
+        {
+            rxDmaResumeAt = start - size;
+            break;
+        }
+        rxDmaArm(half);
+    }
+    rxDmaWaiting = (rxDmaArmed != 3);
+
+    //
+    // Having run dry the uDMA disabled the channel; restart it on the half
+    // due next.
+    //
+    if((rxDmaArmed & (1 << rxDmaFill)) && !ROM_uDMAChannelIsEnabled(ulChannel))
+    {
+        if(rxDmaFill)
+            ROM_uDMAChannelAttributeEnable(ulChannel, UDMA_ATTR_ALTSELECT);
+        else
+            ROM_uDMAChannelAttributeDisable(ulChannel, UDMA_ATTR_ALTSELECT);
+        ROM_uDMAChannelEnable(ulChannel);
+
+        //
+        // Whatever waited in the FIFO meanwhile will not see another
+        // receive timeout.
+        //
+        rxDmaFlush();
+    }
+}
+
+void
+HardwareSerial::rxDmaResume(void)
+{
+    unsigned int head = rxDmaHead;
+
+    //
+    // Called by the reader; cheap until it has caught up with the half
+    // waiting to be re-armed.
+    //
+    if((int)(head - rxBuffer.available() - rxDmaResumeAt) < 0)
+        return;
+
+    ROM_IntDisable(g_ulUARTInt[uartModule]);
+    if(rxDmaWaiting)
+        rxDmaReload();
+    ROM_IntEnable(g_ulUARTInt[uartModule]);
+}
+
 // Public Methods //////////////////////////////////////////////////////////////
 
 void
 HardwareSerial::begin(unsigned long baud)
 {
 	baudRate = baud;
+    rxDmaStop();
     //
     // Initialize the UART.
     //
@@ -270,17 +453,72 @@ HardwareSerial::begin(unsigned long baud)
     //
     ROM_UARTEnable(UART_BASE);
 
-    // Allocate TX & RX buffers
-    if (txBuffer != (unsigned char *)0xFFFFFFFF)  // Catch attempts to re-init this Serial instance by freeing old buffer first
-        free(txBuffer);
-    if (rxBuffer != (unsigned char *)0xFFFFFFFF)  // Catch attempts to re-init this Serial instance by freeing old buffer first
-        free(rxBuffer);
-    txBuffer = (unsigned char *) malloc(txBufferSize);
-    rxBuffer = (unsigned char *) malloc(rxBufferSize);
+    // Allocate TX & RX buffers, freeing the old ones if this Serial
+    // instance is being re-initialised. The ring buffers use the largest
+    // power of two that fits the requested size.
+    free(txStorage);
+    free(rxStorage);
+    txStorage = (unsigned char *) malloc(txBufferSize);
+    rxStorage = (unsigned char *) malloc(rxBufferSize);
+    txBuffer.attach(txStorage, txStorage ? txBufferSize : 0);
+    rxBuffer.attach(rxStorage, rxStorage ? rxBufferSize : 0);
 
     SysCtlDelay(100);
 }
 
+//
+// Like begin(), but received bytes are moved into the buffer by the uDMA
+// and the CPU is only interrupted once per half buffer or when the line
+// goes idle. Falls back to begin() if the receive buffer is too small to
+// split; halves are limited to the uDMA's 1024 byte transfers.
+//
+void
+HardwareSerial::beginDMA(unsigned long baud)
+{
+    unsigned long ulChannel = UART_RX_DMA_CHANNEL;
+
+    begin(baud);
+    if(rxBuffer.capacity() < 4 * RX_DMA_BURST)
+        return;
+    if(rxBuffer.capacity() > 2 * RX_DMA_MAX_TRANSFER)
+        rxBuffer.attach(rxStorage, 2 * RX_DMA_MAX_TRANSFER);
+
+    ROM_IntDisable(g_ulUARTInt[uartModule]);
+    ROM_UARTIntDisable(UART_BASE, UART_INT_RX | UART_INT_RT);
+
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    ROM_uDMAEnable();
+    if(!ROM_uDMAControlBaseGet())
+        ROM_uDMAControlBaseSet(g_sDMAControlTable);
+
+    ROM_uDMAChannelAssign(g_ulUARTRxDMA[uartModule]);
+    ROM_uDMAChannelAttributeDisable(ulChannel, UDMA_ATTR_ALL);
+    ROM_uDMAChannelAttributeEnable(ulChannel, UDMA_ATTR_USEBURST);
+    ROM_uDMAChannelControlSet(ulChannel | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_NONE |
+                              UDMA_DST_INC_8 | UDMA_ARB_4);
+    ROM_uDMAChannelControlSet(ulChannel | UDMA_ALT_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_NONE |
+                              UDMA_DST_INC_8 | UDMA_ARB_4);
+
+    rxBuffer.reset();
+    rxDmaHead = 0;
+    rxDmaStart = 0;
+    rxDmaFill = 0;
+    rxDmaArmed = 0;
+    rxDmaArm(0);
+    rxDmaArm(1);
+    rxDmaWaiting = false;
+    rxOverrunCount = 0;
+    rxDma = true;
+
+    ROM_UARTFIFOLevelSet(UART_BASE, UART_FIFO_TX1_8, UART_FIFO_RX4_8);
+    ROM_UARTDMAEnable(UART_BASE, UART_DMA_RX);
+    ROM_uDMAChannelEnable(ulChannel);
+    ROM_UARTIntEnable(UART_BASE, UART_INT_RX_DMA);
+    ROM_IntEnable(g_ulUARTInt[uartModule]);
+}
+
 void
 HardwareSerial::setBufferSize(unsigned long txsize, unsigned long rxsize)
 {
@@ -295,6 +533,7 @@ HardwareSerial::setModule(unsigned long module)
 {
     ROM_UARTIntDisable(UART_BASE, UART_INT_RX | UART_INT_RT);
     ROM_IntDisable(g_ulUARTInt[uartModule]);
+    rxDmaStop();
 	uartModule = module;
 	begin(baudRate);
 
@@ -338,58 +577,48 @@ void HardwareSerial::end()
     }
 
     ROM_IntDisable(g_ulUARTInt[uartModule]);
-    ROM_UARTIntDisable(UART_BASE, UART_INT_RX | UART_INT_RT);
+    ROM_UARTIntDisable(UART_BASE, UART_INT_RX | UART_INT_RT | UART_INT_RX_DMA);
+    rxDmaStop();
 }
 
 int HardwareSerial::available(void)
 {
-    return((rxWriteIndex >= rxReadIndex) ?
-		(rxWriteIndex - rxReadIndex) : rxBufferSize - (rxReadIndex - rxWriteIndex));
+    return rxBuffer.available();
 }
 
 int HardwareSerial::peek(void)
 {
-    unsigned char cChar = 0;
-
     //
-    // Wait for a character to be received.
+    // Return the next character without removing it, or -1 if the buffer
+    // is empty.
     //
-    if(RX_BUFFER_EMPTY)
-    {
-    	return -1;
-    	//
-        // Block waiting for a character to be received (if the buffer is
-        // currently empty).
-        //
-    }
+    return rxBuffer.peek();
+}
 
+int HardwareSerial::read(void)
+{
     //
-    // Read a character from the buffer.
-    //
-    cChar = rxBuffer[rxReadIndex];
-    //
-    // Return the character to the caller.
+    // Read a character from the buffer, or -1 if it is empty.
     //
-    return(cChar);
+    int c = rxBuffer.pop();
+
+    if(rxDmaWaiting)
+        rxDmaResume();
+    return c;
 }
 
-int HardwareSerial::read(void)
+unsigned long HardwareSerial::rxOverruns(void)
 {
-    if(RX_BUFFER_EMPTY) {
-    	return -1;
-    }
-
     //
-    // Read a character from the buffer.
+    // Receive FIFO overruns seen since beginDMA().
     //
-    unsigned char cChar = rxBuffer[rxReadIndex];
-	rxReadIndex = ((rxReadIndex) + 1) % rxBufferSize;
-	return cChar;
+    return rxOverrunCount;
 }
 
 void HardwareSerial::flush()
 {
-    while(!TX_BUFFER_EMPTY);
+    while(!TX_BUFFER_EMPTY)
+        primeTransmit(UART_BASE);
     while (ROM_UARTBusy(UART_BASE)) ;
 }
 
@@ -413,18 +642,18 @@ size_t HardwareSerial::write(uint8_t c)
 
     if(c == '\n')
     {
-        while (TX_BUFFER_FULL);
-        txBuffer[txWriteIndex] = '\r';
-		txWriteIndex = (txWriteIndex + 1) % txBufferSize;
+        while (!txBuffer.push('\r'));
         numTransmit ++;
     }
 */
     //
-    // Send the character to the UART output.
+    // Send the character to the UART output. If the buffer is full, keep
+    // feeding the FIFO ourselves in case the TX interrupt cannot run.
     //
-    while (TX_BUFFER_FULL);
-    txBuffer[txWriteIndex] = c;
-    txWriteIndex = (txWriteIndex + 1) % txBufferSize;
+    if (!txBuffer.capacity())
+        return 0;
+    while (!txBuffer.push(c))
+        primeTransmit(UART_BASE);
     numTransmit ++;
 
     //
@@ -443,6 +672,39 @@ size_t HardwareSerial::write(uint8_t c)
     return(numTransmit);
 }
 
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+
+    if (!txBuffer.capacity())
+        return 0;
+
+    while (written < size)
+    {
+        //
+        // Copy as much as fits in one go, straight from the caller's buffer.
+        //
+        written += txBuffer.push(buffer + written, size - written);
+
+        if (written < size)
+        {
+            //
+            // Buffer full: let the FIFO and the TX interrupt drain it.
+            //
+            primeTransmit(UART_BASE);
+            ROM_UARTIntEnable(UART_BASE, UART_INT_TX);
+        }
+    }
+
+    if (!TX_BUFFER_EMPTY)
+    {
+        primeTransmit(UART_BASE);
+        ROM_UARTIntEnable(UART_BASE, UART_INT_TX);
+    }
+
+    return written;
+}
+
 void HardwareSerial::UARTIntHandler(void){
     unsigned long ulInts;
     long lChar;
@@ -468,7 +730,23 @@ void HardwareSerial::UARTIntHandler(void){
             ROM_UARTIntDisable(UART_BASE, UART_INT_TX);
         }
     }
-    if(ulInts & (UART_INT_RX | UART_INT_RT))
+    if(rxDma)
+    {
+        //
+        // A finished transfer shows up as an interrupt of its own on the
+        // TM4C123 parts, so check the transfers whatever the status says.
+        //
+        if(ulInts & UART_INT_OE)
+        {
+            rxOverrunCount++;
+            ROM_UARTRxErrorClear(UART_BASE);
+        }
+        rxDmaRetire();
+        if(ulInts & UART_INT_RT)
+            rxDmaFlush();
+        rxDmaReload();
+    }
+    else if(ulInts & (UART_INT_RX | UART_INT_RT))
     {
         while(ROM_UARTCharsAvail(UART_BASE))
             {
@@ -481,12 +759,7 @@ void HardwareSerial::UARTIntHandler(void){
             // If there is space in the receive buffer, put the character
             // there, otherwise throw it away.
             //
-            uint8_t volatile full = RX_BUFFER_FULL;
-            if(full) break;
-
-            rxBuffer[rxWriteIndex] =
-                (unsigned char)(lChar & 0xFF);
-            rxWriteIndex = ((rxWriteIndex) + 1) % rxBufferSize;
+            if(!rxBuffer.push((unsigned char)(lChar & 0xFF))) break;
 
             //
             // If we wrote anything to the transmit buffer, make sure it actually
@@ -35,6 +35,7 @@
 
 #include <inttypes.h>
 #include "Stream.h"
+#include "RingBuffer.h"
 
 #define SERIAL_BUFFER_SIZE     256
 
@@ -45,23 +46,37 @@ class HardwareSerial : public Stream
 {
 
 	private:
-		unsigned char *txBuffer;
+		RingBuffer<0> txBuffer;
+		unsigned char *txStorage;
 		unsigned long txBufferSize;
-		unsigned long txWriteIndex;
-		unsigned long txReadIndex;
-		unsigned char *rxBuffer;
+		RingBuffer<0> rxBuffer;
+		unsigned char *rxStorage;
 		unsigned long rxBufferSize;
-		unsigned long rxWriteIndex;
-		unsigned long rxReadIndex;
 		unsigned long uartModule;
 		unsigned long baudRate;
+		bool rxDma;
+		volatile unsigned int rxDmaHead;
+		unsigned int rxDmaStart;
+		unsigned int rxDmaResumeAt;
+		unsigned char rxDmaFill;
+		unsigned char rxDmaArmed;
+		volatile bool rxDmaWaiting;
+		volatile unsigned long rxOverrunCount;
 		void flushAll(void);
 		void primeTransmit(unsigned long ulBase);
+		void rxDmaStop(void);
+		void rxDmaArm(unsigned int half);
+		void rxDmaPublish(unsigned int head);
+		void rxDmaRetire(void);
+		void rxDmaFlush(void);
+		void rxDmaReload(void);
+		void rxDmaResume(void);
 
 	public:
 		HardwareSerial(void);
 		HardwareSerial(unsigned long);
 		void begin(unsigned long);
+		void beginDMA(unsigned long);
 		void setBufferSize(unsigned long, unsigned long);
 		void setModule(unsigned long);
 		void setPins(unsigned long);
@@ -71,9 +86,11 @@ class HardwareSerial : public Stream
 		virtual int read(void);
 		virtual void flush(void);
 		void UARTIntHandler(void);
+		unsigned long rxOverruns(void);
 		virtual size_t write(uint8_t c);
+		virtual size_t write(const uint8_t *buffer, size_t size);
 		operator bool();
-		using Print::write; // pull in write(str) and write(buf, size) from Print
+		using Print::write; // pull in write(str) from Print
         
 };
 
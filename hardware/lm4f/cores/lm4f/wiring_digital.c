@@ -93,3 +93,20 @@ void digitalWrite(uint8_t pin, uint8_t val)
 
     ROM_GPIOPinWrite(portBase, bit, mask);
 }
+
+// Where the handle of a pin that is not one points
+static volatile uint32_t notAPinData;
+
+PinHandle pinHandle(uint8_t pin)
+{
+    uint8_t bit = digitalPinToBitMask(pin);
+    uint8_t port = digitalPinToPort(pin);
+    PinHandle handle;
+
+    if (port == NOT_A_PORT) {
+        handle.data = &notAPinData;
+    } else {
+        handle.data = (volatile uint32_t *)(port_to_base[port] + (bit << 2));
+    }
+    return handle;
+}
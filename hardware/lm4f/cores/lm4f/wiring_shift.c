@@ -33,31 +33,41 @@
 #include "wiring_private.h"
 
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
+    PinHandle data = pinHandle(dataPin);
+    PinHandle clock = pinHandle(clockPin);
     uint8_t value = 0;
     uint8_t i;
 
     for (i = 0; i < 8; ++i) {
-        digitalWrite(clockPin, HIGH);
+        fastWrite(clock, HIGH);
         if (bitOrder == LSBFIRST)
-            value |= digitalRead(dataPin) << i;
+            value |= fastRead(data) << i;
         else
-            value |= digitalRead(dataPin) << (7 - i);
-        digitalWrite(clockPin, LOW);
+            value |= fastRead(data) << (7 - i);
+        fastWrite(clock, LOW);
     }
     return value;
 }
 
 void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val)
 {
+    PinHandle data = pinHandle(dataPin);
+    PinHandle clock = pinHandle(clockPin);
+    uint8_t level, last = 2;
     uint8_t i;
 
     for (i = 0; i < 8; i++)  {
         if (bitOrder == LSBFIRST)
-            digitalWrite(dataPin, !!(val & (1 << i)));
+            level = !!(val & (1 << i));
         else
-            digitalWrite(dataPin, !!(val & (1 << (7 - i))));
+            level = !!(val & (1 << (7 - i)));
 
-        digitalWrite(clockPin, HIGH);
-        digitalWrite(clockPin, LOW);
+        // the data pin is only written when the bit differs from the last
+        if (level != last) {
+            fastWrite(data, level);
+            last = level;
+        }
+        fastWrite(clock, HIGH);
+        fastWrite(clock, LOW);
     }
 }
@@ -172,15 +172,7 @@ void Screen_HX8353E::_fastFill(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y
     if (x1 > x2) _swap(x1, x2);
     if (y1 > y2) _swap(y1, y2);
     _setWindow(x1, y1, x2, y2);
-    digitalWrite(_pinDataCommand, HIGH);
-    digitalWrite(_pinChipSelect, LOW);
-    uint8_t hi = highByte(colour);
-    uint8_t lo = lowByte(colour);
-    for (uint32_t t=(uint32_t)(y2-y1+1)*(x2-x1+1); t>0; t--) {
-        SPI.transfer(hi);
-        SPI.transfer(lo);
-    }
-    digitalWrite(_pinChipSelect, HIGH);
+    _writePixels(NULL, colour, (uint32_t)(y2-y1+1)*(x2-x1+1));
 }
 void Screen_HX8353E::_setPoint(uint16_t x1, uint16_t y1, uint16_t colour)
 {
@@ -261,6 +253,36 @@ void Screen_HX8353E::_writeData88(uint8_t dataHigh8, uint8_t dataLow8)
     SPI.transfer(dataLow8);
     digitalWrite(_pinChipSelect, HIGH);
 }
+void Screen_HX8353E::_writeDataBuffer(const uint16_t * data16, uint32_t count)
+{
+    _writePixels(data16, 0, count);
+}
+// count pixels in one transaction, from data16 or, without it, all of colour
+void Screen_HX8353E::_writePixels(const uint16_t * data16, uint16_t colour, uint32_t count)
+{
+    digitalWrite(_pinDataCommand, HIGH);
+    digitalWrite(_pinChipSelect, LOW);
+#ifdef SPI_HAS_TRANSFER_BUF
+    uint8_t buffer[64];
+    while (count > 0) {
+        uint32_t n = (count < sizeof(buffer)/2) ? count : sizeof(buffer)/2;
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t pixel = data16 ? *data16++ : colour;
+            buffer[2*i]   = highByte(pixel);
+            buffer[2*i+1] = lowByte(pixel);
+        }
+        SPI.transfer(buffer, 2*n);
+        count -= n;
+    }
+#else
+    for (; count > 0; count--) {
+        uint16_t pixel = data16 ? *data16++ : colour;
+        SPI.transfer(highByte(pixel));
+        SPI.transfer(lowByte(pixel));
+    }
+#endif
+    digitalWrite(_pinChipSelect, HIGH);
+}
 void Screen_HX8353E::_writeData8888(uint8_t dataHigh8, uint8_t dataLow8, uint8_t data8_3, uint8_t data8_4)
 {
     _writeData(dataHigh8);
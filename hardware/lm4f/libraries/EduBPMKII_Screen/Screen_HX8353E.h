@@ -58,6 +58,8 @@ private:
     void _writeData(uint8_t data8);
     void _writeData16(uint16_t data16);
     void _writeData88(uint8_t dataHigh8, uint8_t dataLow8);
+    void _writeDataBuffer(const uint16_t * data16, uint32_t count);
+    void _writePixels(const uint16_t * data16, uint16_t colour, uint32_t count);
     void _writeData8888(uint8_t dataHigh8, uint8_t dataLow8, uint8_t data8_3, uint8_t data8_4);
     void _fastFill(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t colour);
     void _getRawTouch(uint16_t &x, uint16_t &y, uint16_t &z);
@@ -1,6 +1,8 @@
 #include <Energia.h>
 #include <Ethernet.h>
 #include <inc/hw_ints.h>
+#include <driverlib/flash.h>
+#include <driverlib/interrupt.h>
 #include <lwip/inet.h>
 #include <IPAddress.h>
 
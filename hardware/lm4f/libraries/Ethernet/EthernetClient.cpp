@@ -3,16 +3,7 @@
 #include "Ethernet.h"
 #include "EthernetClient.h"
 #include "EthernetServer.h"
-
-#include "driverlib/interrupt.h"
-
-/* directives for disabling and enabling interrupts */
-#define INT_PROTECT_INIT(x)    int x = 0
-#define INT_PROTECT(x)         x=IntMasterDisable()
-#define INT_UNPROTECT(x)       do{if(!x)IntMasterEnable();}while(0)
-
-/* SYNC_FETCH_AND_NULL: atomic{ tmp=*x; *x=NULL; return tmp; } */
-#define SYNC_FETCH_AND_NULL(x)   (__sync_fetch_and_and(x, NULL))
+#include "EthernetSync.h"
 
 EthernetClient::EthernetClient() {
 	_connected = false;
@@ -20,6 +11,7 @@ EthernetClient::EthernetClient() {
 	cs->mode = true;
 	cs->cpcb = NULL;
 	cs->p = NULL;
+	cs->unacked = 0;
 }
 
 EthernetClient::EthernetClient(struct client *c) {
@@ -28,6 +20,7 @@ EthernetClient::EthernetClient(struct client *c) {
 		cs = &client_state;
 		cs->cpcb = NULL;
 		cs->p = NULL;
+		cs->unacked = 0;
 		return;
 	}
 	_connected = true;
@@ -38,7 +31,8 @@ EthernetClient::EthernetClient(struct client *c) {
 err_t EthernetClient::do_poll(void *arg, struct tcp_pcb *cpcb) {
 	EthernetClient *client = static_cast<EthernetClient*>(arg);
 
-	if (client->_connected) {
+	/* client is NULL once stop() has let go of the connection */
+	if (client && client->_connected) {
 		if (cpcb->keep_cnt_sent++ > 4) {
 			cpcb->keep_cnt_sent = 0;
 			/* Stop polling */
@@ -65,7 +59,7 @@ err_t EthernetClient::do_poll(void *arg, struct tcp_pcb *cpcb) {
 		tcp_poll(cpcb, do_poll, 4);
 	}
 
-	if (client->cs->cpcb == cpcb) /* cs may be already re-used by another connection */
+	if (client && client->cs->cpcb == cpcb) /* cs may be already re-used by another connection */
 	{
 		client->cs->cpcb = 0;
 		client->cs->port = 0;
@@ -77,6 +71,13 @@ err_t EthernetClient::do_poll(void *arg, struct tcp_pcb *cpcb) {
 void EthernetClient::do_err(void * arg, err_t err) {
 	EthernetClient *client = static_cast<EthernetClient*>(arg);
 
+	if (!client)
+		return;
+
+	/* The stack has freed the pcb, and what was queued on it, by now */
+	client->cs->cpcb = NULL;
+	client->cs->unacked = 0;
+
 	if (client->_connected) {
 		client->_connected = false;
 		return;
@@ -121,6 +122,15 @@ err_t EthernetClient::do_recv(void *arg, struct tcp_pcb *cpcb, struct pbuf *p,
 	return ERR_OK;
 }
 
+err_t EthernetClient::do_sent(void *arg, struct tcp_pcb *cpcb, u16_t len) {
+	EthernetClient *client = static_cast<EthernetClient*>(arg);
+	struct client *cs = client->cs;
+
+	cs->unacked = cs->unacked > len ? cs->unacked - len : 0;
+
+	return ERR_OK;
+}
+
 void EthernetClient::do_dns(const char *name, struct ip_addr *ipaddr,
 		void *arg) {
 	ip_addr_t *result = (ip_addr_t *) arg;
@@ -157,21 +167,30 @@ int EthernetClient::connect(IPAddress ip, uint16_t port) {
 int EthernetClient::connect(IPAddress ip, uint16_t port, unsigned long timeout) {
 	ip_addr_t dest;
 	dest.addr = ip;
+	INT_PROTECT_INIT(oldLevel);
+
+	/* protect the code from preemption of the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
 
 	cs->cpcb = tcp_new();
 	cs->read = 0;
 	cs->p = NULL;
+	cs->unacked = 0;
 
 	if (cs->cpcb == NULL) {
+		INT_UNPROTECT(oldLevel);
 		return false;
 	}
 
 	tcp_arg((tcp_pcb*)cs->cpcb, this);
 	tcp_recv((tcp_pcb*)cs->cpcb, do_recv);
+	tcp_sent((tcp_pcb*)cs->cpcb, do_sent);
 	tcp_err((tcp_pcb*)cs->cpcb, do_err);
 
 	uint8_t val = tcp_connect((tcp_pcb *)cs->cpcb, &dest, port, do_connected);
 
+	INT_UNPROTECT(oldLevel);
+
 	if (val != ERR_OK) {
 		return false;
 	}
@@ -184,18 +203,25 @@ int EthernetClient::connect(IPAddress ip, uint16_t port, unsigned long timeout)
 		unsigned long now = millis();
 		delay(10);
 		if (now - then > timeout) {
-			tcp_close((tcp_pcb*)cs->cpcb);
+			INT_PROTECT(oldLevel);
+			if (cs->cpcb)
+				tcp_close((tcp_pcb*)cs->cpcb);
 			cs->cpcb = NULL;
+			INT_UNPROTECT(oldLevel);
 			return false;
 		}
 	}
 
-	if (cs->cpcb->state != ESTABLISHED) {
+	INT_PROTECT(oldLevel);
+
+	if (!cs->cpcb || cs->cpcb->state != ESTABLISHED) {
 		_connected = false;
+	} else {
+		/* Poll to determine if the peer is still alive */
+		tcp_poll((tcp_pcb*)cs->cpcb, do_poll, 10);
 	}
 
-	/* Poll to determine if the peer is still alive */
-	tcp_poll((tcp_pcb*)cs->cpcb, do_poll, 10);
+	INT_UNPROTECT(oldLevel);
 	return _connected;
 }
 
@@ -204,40 +230,62 @@ size_t EthernetClient::write(uint8_t b) {
 }
 
 size_t EthernetClient::write(const uint8_t *buf, size_t size) {
-	uint32_t i = 0, inc = 0;
-	boolean stuffed_buffer = false;
+	return send(buf, size, TCP_WRITE_FLAG_COPY);
+}
 
-	struct tcp_pcb * cpcb = (tcp_pcb*)cs->cpcb; /* cs->cpcb may change to NULL during interrupt servicing */
+size_t EthernetClient::writeNoCopy(const uint8_t *buf, size_t size) {
+	return send(buf, size, 0);
+}
 
-	if (!cpcb)
-		return 0;
+size_t EthernetClient::send(const uint8_t *buf, size_t size, uint8_t flags) {
+	size_t i = 0;
+	INT_PROTECT_INIT(oldLevel);
 
-	// Attempt to write in 1024-byte increments.
 	while (i < size) {
-		inc = (size - i) < 1024 ? size - i : 1024;
-		err_t err = tcp_write(cpcb, buf + i, inc, TCP_WRITE_FLAG_COPY);
-		if (err != ERR_MEM) {
-			// Keep enqueueing the lwIP buffer until it's full...
+		/* protect the code from preemption of the ethernet interrupt servicing */
+		INT_PROTECT(oldLevel);
+
+		/* cs->cpcb may change to NULL during interrupt servicing */
+		struct tcp_pcb * cpcb = (tcp_pcb*)cs->cpcb;
+		if (!cpcb) {
+			INT_UNPROTECT(oldLevel);
+			break;
+		}
+
+		/* As much as the send buffer takes in one go */
+		uint32_t inflight = cs->unacked;
+		size_t inc = size - i < tcp_sndbuf(cpcb) ? size - i : tcp_sndbuf(cpcb);
+		err_t err = ERR_MEM;
+		if (inc)
+			err = tcp_write(cpcb, buf + i, inc,
+					flags | (i + inc < size ? TCP_WRITE_FLAG_MORE : 0));
+		if (err == ERR_OK) {
 			i += inc;
-			stuffed_buffer = false;
-		} else {
-			if (!stuffed_buffer) {
-				// Buffer full; force output
-				if (cs->mode)
-					tcp_output(cpcb);
-				stuffed_buffer = true;
-			} else {
-				delay(1); // else wait a little bit for lwIP to flush its buffers
-			}
+			cs->unacked += inc;
 		}
-	}
-	// flush any remaining queue contents
-	if (!stuffed_buffer) {
-		if (cs->mode)
+		/* Send what is queued when done, or when the buffer is full; a
+		 * server's reply would otherwise wait for the next delayed ACK */
+		if (err != ERR_OK || i == size)
 			tcp_output(cpcb);
+
+		INT_UNPROTECT(oldLevel);
+
+		if (err != ERR_OK && err != ERR_MEM)
+			break;
+		if (err == ERR_MEM) {
+			/* Room is made as the peer acknowledges what is in flight */
+			if (!inflight)
+				delay(1);
+			while (cs->unacked == inflight && inflight && cs->cpcb)
+				;
+		}
 	}
 
-	return size;
+	return i;
+}
+
+size_t EthernetClient::unacked() {
+	return cs->cpcb ? cs->unacked : 0;
 }
 
 int EthernetClient::available() {
@@ -251,69 +299,101 @@ int EthernetClient::port() {
 	return cs->port;
 }
 
-int EthernetClient::readLocked() {
-	INT_PROTECT_INIT(oldLevel);
-
-	/* protect the code from preemption of the ethernet interrupt servicing */
-	INT_PROTECT(oldLevel);
-
-	if (!available()) {
-		INT_UNPROTECT(oldLevel);
-		return -1;
-	}
-
-	uint8_t *buf = (uint8_t *) cs->p->payload;
-	uint8_t b = buf[cs->read];
-	cs->read++;
-
-	/* Indicate data was received only if still connected */
-	if (cs->cpcb) {
-		tcp_recved((tcp_pcb*)cs->cpcb, cs->read);
-	}
-
-	/* Read any data still in the buffer regardless of connection state */
-	if ((cs->read == cs->p->len) && cs->p->next) {
+/*
+ * Releases n bytes of the received data: frees the buffers read to their
+ * end and opens the window by as much, with one tcp_recved(). Must be
+ * called with interrupts masked.
+ */
+size_t EthernetClient::consumeLocked(size_t n) {
+	struct pbuf * p = (pbuf*)cs->p;
+	size_t done = 0;
+
+	while (p) {
+		size_t left = p->len - cs->read;
+
+		if (n - done < left) {
+			cs->read += n - done;
+			done = n;
+			break;
+		}
+		done += left;
 		cs->read = 0;
-		struct pbuf * q = (pbuf*)cs->p;
-		cs->p = cs->p->next;
+		struct pbuf * q = p;
+		p = p->next;
 		/* Increase ref count on p->next
 		 * 1->3->1->etc */
-		pbuf_ref((pbuf*)cs->p);
-		/* Free p which decreases ref count of the chain
+		if (p)
+			pbuf_ref(p);
+		/* Free q which decreases ref count of the chain
 		 * and frees up to p->next in this case
 		 * ...->1->1->etc */
 		pbuf_free(q);
-	} else if (cs->read == cs->p->len) {
-		cs->read = 0;
-		pbuf_free((pbuf*)cs->p);
-		cs->p = NULL;
 	}
+	cs->p = p;
 
-	INT_UNPROTECT(oldLevel);
+	/* Indicate data was received only if still connected */
+	for (size_t left = done; left && cs->cpcb; ) {
+		u16_t len = left < 0xFFFF ? left : 0xFFFF;
+		tcp_recved((tcp_pcb*)cs->cpcb, len);
+		left -= len;
+	}
 
-	return b;
+	return done;
 }
 
 int EthernetClient::read() {
-	return readLocked();
+	uint8_t b;
+
+	return read(&b, 1) == 1 ? b : -1;
 }
 
 int EthernetClient::read(uint8_t *buf, size_t size) {
-	uint16_t i;
-	int b;
+	INT_PROTECT_INIT(oldLevel);
+
+	/* protect the code from preemption of the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
 
-	if (available() <= 0)
+	if (!available()) {
+		INT_UNPROTECT(oldLevel);
 		return -1;
+	}
 
-	/* TODO: Replace lazy method with optimized on */
-	for (i = 0; i < size; i++) {
-		b = read();
-		if (b == -1)
-			break;
-		buf[i] = b;
+	/* Read any data still in the buffer regardless of connection state */
+	size_t n = pbuf_copy_partial((pbuf*)cs->p, buf,
+			size < 0xFFFF ? size : 0xFFFF, cs->read);
+	consumeLocked(n);
+
+	INT_UNPROTECT(oldLevel);
+
+	return n;
+}
+
+size_t EthernetClient::peekSegment(const uint8_t **data) {
+	INT_PROTECT_INIT(oldLevel);
+	size_t n = 0;
+
+	/* protect code from preemption of the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
+
+	/* Step over buffers left empty */
+	consumeLocked(0);
+	if (cs->p) {
+		*data = (const uint8_t *)cs->p->payload + cs->read;
+		n = cs->p->len - cs->read;
 	}
 
-	return i;
+	INT_UNPROTECT(oldLevel);
+
+	return n;
+}
+
+void EthernetClient::consume(size_t n) {
+	INT_PROTECT_INIT(oldLevel);
+
+	/* protect code from preemption of the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
+	consumeLocked(n);
+	INT_UNPROTECT(oldLevel);
 }
 
 int EthernetClient::peek() {
@@ -328,6 +408,7 @@ int EthernetClient::peek() {
 		return -1;
 	}
 
+	consumeLocked(0);
 	uint8_t *buf = (uint8_t *) cs->p->payload;
 	b = buf[cs->read];
 
@@ -340,10 +421,7 @@ void EthernetClient::flush() {
 	INT_PROTECT_INIT(oldLevel);
 	/* protect code from preemption of the ethernet interrupt servicing */
 	INT_PROTECT(oldLevel);
-	if (available()) {
-		cs->read = cs->p->tot_len;
-		tcp_recved((tcp_pcb*)cs->cpcb, 0);
-	}
+	consumeLocked(available());
 	INT_UNPROTECT(oldLevel);
 }
 
@@ -360,14 +438,23 @@ void EthernetClient::stop() {
 	struct pbuf * p_copy = (pbuf *) SYNC_FETCH_AND_NULL(&cs->p);
 	_connected = false;
 	cs->port = 0;
+	cs->unacked = 0;
+
+	if (p_copy) {
+		if (cpcb_copy)
+			tcp_recved(cpcb_copy, p_copy->tot_len - cs->read);
+		pbuf_free(p_copy);
+	}
+	cs->read = 0;
 
 	if (cpcb_copy) {
+		/* The connection may outlive this client while it closes;
+		 * what still comes in on it is dropped by the stack */
+		tcp_arg(cpcb_copy, NULL);
+		tcp_recv(cpcb_copy, NULL);
 		tcp_err(cpcb_copy, NULL);
-
-		if (p_copy) {
-			tcp_recved(cpcb_copy, p_copy->tot_len);
-			pbuf_free(p_copy);
-		}
+		tcp_sent(cpcb_copy, NULL);
+		tcp_poll(cpcb_copy, NULL, 0);
 
 		err = tcp_close(cpcb_copy);
 
@@ -31,8 +31,29 @@ public:
 	virtual void stop();
 	virtual uint8_t connected();
 	virtual operator bool();
+
+	/*
+	 * Zero-copy reading: peekSegment() points data at the received bytes
+	 * that are contiguous in the stack's buffer and returns how many
+	 * there are; they stay put until consume() releases them. consume(n)
+	 * releases n bytes, across as many buffers as they span.
+	 */
+	size_t peekSegment(const uint8_t **data);
+	void consume(size_t n);
+
+	/*
+	 * Writes buf without copying it into the stack. The stack sends from
+	 * buf until the peer has acknowledged it, so buf must stay unchanged
+	 * until unacked() is back to 0; a client stopped before then goes on
+	 * sending what was queued while it closes.
+	 */
+	size_t writeNoCopy(const uint8_t *buf, size_t size);
+	/* Bytes written and not yet acknowledged by the peer */
+	size_t unacked();
+
 	static err_t do_connected(void *arg, struct tcp_pcb *pcb, err_t err);
 	static err_t do_recv(void *arg, struct tcp_pcb *cpcb, struct pbuf *p, err_t err);
+	static err_t do_sent(void *arg, struct tcp_pcb *cpcb, u16_t len);
 	static err_t do_poll(void *arg, struct tcp_pcb *cpcb);
 	static void do_err(void * arg, err_t err);
 	static void do_dns(const char *name, struct ip_addr *ipaddr, void *arg);
@@ -44,6 +65,7 @@ private:
 	volatile bool _connected;
 	struct client *cs;
 
-	int readLocked();
+	size_t consumeLocked(size_t n);
+	size_t send(const uint8_t *buf, size_t size, uint8_t flags);
 };
 #endif
@@ -1,9 +1,7 @@
 #include "Ethernet.h"
 #include "EthernetClient.h"
 #include "EthernetServer.h"
-
-/* SYNC_FETCH_AND_NULL: atomic{ tmp=*x; *x=NULL; return tmp; } */
-#define SYNC_FETCH_AND_NULL(x)   (__sync_fetch_and_and(x, NULL))
+#include "EthernetSync.h"
 
 EthernetServer::EthernetServer(uint16_t port) {
 	_port = port;
@@ -72,6 +70,19 @@ void EthernetServer::do_close(void *arg, struct tcp_pcb *cpcb) {
 }
 
 err_t EthernetServer::did_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+	EthernetServer *server = static_cast<EthernetServer*>(arg);
+
+	uint8_t i;
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (server->clients[i].port == pcb->remote_port)
+			break;
+	}
+	if (i >= MAX_CLIENTS)
+		return ERR_OK;
+
+	struct client * cs = &server->clients[i];
+	cs->unacked = cs->unacked > len ? cs->unacked - len : 0;
+
 	return ERR_OK;
 }
 
@@ -146,11 +157,16 @@ err_t EthernetServer::do_accept(void *arg, struct tcp_pcb *cpcb, err_t err) {
 }
 
 void EthernetServer::begin() {
+	INT_PROTECT_INIT(oldLevel);
+
+	/* protect the code from preemption of the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
 	spcb = tcp_new();
 	tcp_bind(spcb, IP_ADDR_ANY, _port);
 	spcb = tcp_listen(spcb);
 	tcp_arg(spcb, this);
 	tcp_accept(spcb, do_accept);
+	INT_UNPROTECT(oldLevel);
 }
 
 EthernetClient EthernetServer::available() {
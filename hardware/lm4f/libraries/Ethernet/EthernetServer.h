@@ -20,6 +20,8 @@ struct client {
 	volatile bool connected;
 	uint16_t read;
 	bool mode;
+	/* Bytes written and not yet acknowledged by the peer */
+	volatile uint32_t unacked;
 };
 
 class EthernetClient;
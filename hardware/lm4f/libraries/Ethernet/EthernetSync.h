@@ -0,0 +1,14 @@
+#ifndef ethernetsync_h
+#define ethernetsync_h
+
+#include "driverlib/interrupt.h"
+
+/* directives for disabling and enabling interrupts */
+#define INT_PROTECT_INIT(x)    int x = 0
+#define INT_PROTECT(x)         x=IntMasterDisable()
+#define INT_UNPROTECT(x)       do{if(!x)IntMasterEnable();}while(0)
+
+/* SYNC_FETCH_AND_NULL: atomic{ tmp=*x; *x=NULL; return tmp; } */
+#define SYNC_FETCH_AND_NULL(x)   (__sync_fetch_and_and(x, NULL))
+
+#endif
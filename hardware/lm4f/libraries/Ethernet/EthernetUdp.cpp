@@ -1,10 +1,12 @@
 #include "EthernetUdp.h"
 #include "lwip/udp.h"
 #include <lwip/dns.h>
+#include "EthernetSync.h"
 
 EthernetUDP::EthernetUDP() {
 	_read = 0;
 	front = 0;
+	rear = 0;
 	count = 0;
 	_p = NULL;
 }
@@ -39,14 +41,22 @@ void EthernetUDP::do_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p, struc
 
 uint8_t EthernetUDP::begin(uint16_t port)
 {
+	INT_PROTECT_INIT(oldLevel);
+
 	_port = port;
+
+	/* protect the code from preemption of the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
 	_pcb = udp_new();
 	err_t err = udp_bind(_pcb, IP_ADDR_ANY, port);
 
-	if(err == ERR_USE)
+	if(err == ERR_USE) {
+		INT_UNPROTECT(oldLevel);
 		return 0;
+	}
 
 	udp_recv(_pcb, do_recv, this);
+	INT_UNPROTECT(oldLevel);
 	return 1;
 }
 
@@ -60,7 +70,11 @@ int EthernetUDP::available()
 
 void EthernetUDP::stop()
 {
+	INT_PROTECT_INIT(oldLevel);
+
+	INT_PROTECT(oldLevel);
 	udp_remove(_pcb);
+	INT_UNPROTECT(oldLevel);
 }
 
 void EthernetUDP::do_dns(const char *name, struct ip_addr *ipaddr, void *arg)
@@ -105,6 +119,7 @@ int EthernetUDP::beginPacket(IPAddress ip, uint16_t port)
 
 int EthernetUDP::endPacket()
 {
+	INT_PROTECT_INIT(oldLevel);
 	ip_addr_t dest;
 	dest.addr = _sendToIP;
 
@@ -112,7 +127,9 @@ int EthernetUDP::endPacket()
 	pbuf_realloc(_sendTop, _write);
 
 	/* Send the buffer to the remote host */
+	INT_PROTECT(oldLevel);
 	err_t err = udp_sendto(_pcb, _sendTop, &dest, _sendToPort);
+	INT_UNPROTECT(oldLevel);
 
 	/* udp_sendto is blocking and the pbuf is
 	 * no longer needed so free it */
@@ -143,8 +160,23 @@ size_t EthernetUDP::write(const uint8_t *buffer, size_t size)
 	if(size > avail)
 		size = avail;
 
-	/* Copy buffer into the pbuf */
-	pbuf_take(_sendTop, buffer, size);
+	/* Copy buffer into the pbuf, after what was written to it before */
+	struct pbuf *q = _sendTop;
+	uint16_t offset = _write;
+	size_t done = 0;
+
+	while (offset >= q->len) {
+		offset -= q->len;
+		q = q->next;
+	}
+	while (done < size) {
+		uint16_t n = q->len - offset < size - done ? q->len - offset : size - done;
+
+		memcpy((uint8_t *)q->payload + offset, buffer + done, n);
+		done += n;
+		offset = 0;
+		q = q->next;
+	}
 
 	_write += size;
 
@@ -153,6 +185,8 @@ size_t EthernetUDP::write(const uint8_t *buffer, size_t size)
 
 int EthernetUDP::parsePacket()
 {
+	INT_PROTECT_INIT(oldLevel);
+
 	_read = 0;
 
 	/* Discard the current packet */
@@ -169,6 +203,9 @@ int EthernetUDP::parsePacket()
 		return 0;
 	}
 
+	/* protect the queue from the ethernet interrupt servicing */
+	INT_PROTECT(oldLevel);
+
 	/* Take the next packet from the front of the queue */
 	_p = packets[front].p;
 	_remoteIP = packets[front].remoteIP;
@@ -184,6 +221,8 @@ int EthernetUDP::parsePacket()
 	if(front == UDP_RX_MAX_PACKETS)
 		front = 0;
 
+	INT_UNPROTECT(oldLevel);
+
 	/* Return the total len of the queue */
 	return _p->tot_len;
 }
@@ -32,13 +32,15 @@
 #ifndef __CC_H__
 #define __CC_H__
 
+#include <stdint.h>
+
 typedef unsigned    char    u8_t;
 typedef signed      char    s8_t;
 typedef unsigned    short   u16_t;
 typedef signed      short   s16_t;
-typedef unsigned    long    u32_t;
-typedef signed      long    s32_t;
-typedef u32_t               mem_ptr_t;
+typedef uint32_t            u32_t;
+typedef int32_t             s32_t;
+typedef uintptr_t           mem_ptr_t;
 typedef u8_t                sys_prot_t;
 
 #ifndef BYTE_ORDER
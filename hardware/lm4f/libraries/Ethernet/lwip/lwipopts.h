@@ -33,6 +33,13 @@
 #ifndef __LWIPOPTS_H__
 #define __LWIPOPTS_H__
 
+//*****************************************************************************
+//
+// The memory, pool and TCP sizes below may be given on the command line, to
+// try others without editing this file; the host build has profiles of them.
+//
+//*****************************************************************************
+
 //*****************************************************************************
 //
 // ---------- Stellaris / lwIP Port Options ----------
@@ -67,7 +74,9 @@
 //*****************************************************************************
 //#define MEM_LIBC_MALLOC                 0
 #define MEM_ALIGNMENT                   4           // default is 1
+#ifndef MEM_SIZE
 #define MEM_SIZE                        (64 * 1024)  // default is 1600
+#endif
 //#define MEMP_OVERFLOW_CHECK             0
 //#define MEMP_SANITY_CHECK               0
 //#define MEM_USE_POOLS                   0
@@ -78,12 +87,18 @@
 // ---------- Internal Memory Pool Sizes ----------
 //
 //*****************************************************************************
+#ifndef MEMP_NUM_PBUF
 #define MEMP_NUM_PBUF                     48    // Default 16
+#endif
 //#define MEMP_NUM_RAW_PCB                4
 //#define MEMP_NUM_UDP_PCB                4
+#ifndef MEMP_NUM_TCP_PCB
 #define MEMP_NUM_TCP_PCB                  16    // Default 5
+#endif
 //#define MEMP_NUM_TCP_PCB_LISTEN         8
+#ifndef MEMP_NUM_TCP_SEG
 #define MEMP_NUM_TCP_SEG                  32  // Default 16
+#endif
 //#define MEMP_NUM_REASSDATA              5
 //#define MEMP_NUM_ARP_QUEUE              30
 //#define MEMP_NUM_IGMP_GROUP             8
@@ -92,7 +107,9 @@
 //#define MEMP_NUM_NETCONN                4
 //#define MEMP_NUM_TCPIP_MSG_API          8
 //#define MEMP_NUM_TCPIP_MSG_INPKT        8
+#ifndef PBUF_POOL_SIZE
 #define PBUF_POOL_SIZE                    48    // Default 16
+#endif
 
 //*****************************************************************************
 //
@@ -214,14 +231,20 @@
 //*****************************************************************************
 #define LWIP_TCP                        1
 //#define TCP_TTL                         (IP_DEFAULT_TTL)
+#ifndef TCP_WND
 #define TCP_WND                         4096   // default is 2048
+#endif
 //#define TCP_MAXRTX                      12
 //#define TCP_SYNMAXRTX                   6
 //#define TCP_QUEUE_OOSEQ                 1
+#ifndef TCP_MSS
 #define TCP_MSS                        1500        // default is 128
+#endif
 //#define TCP_CALCULATE_EFF_SEND_MSS      1
+#ifndef TCP_SND_BUF
 #define TCP_SND_BUF                     (6 * TCP_MSS)
                                                     // default is 256
+#endif
 //#define TCP_SND_QUEUELEN                (4 * (TCP_SND_BUF/TCP_MSS))
 //#define TCP_SNDLOWAT                    (TCP_SND_BUF/2)
 //#define TCP_LISTEN_BACKLOG              0
@@ -241,8 +264,10 @@
 //
 //*****************************************************************************
 #define PBUF_LINK_HLEN                  16          // default is 14
+#ifndef PBUF_POOL_BUFSIZE
 #define PBUF_POOL_BUFSIZE               512
                                                     // default is LWIP_MEM_ALIGN_SIZE(TCP_MSS+40+PBUF_LINK_HLEN)
+#endif
 #define ETH_PAD_SIZE                    0           // default is 0
 
 //*****************************************************************************
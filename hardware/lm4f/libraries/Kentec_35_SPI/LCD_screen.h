@@ -108,6 +108,9 @@ protected:
     virtual void _getRawTouch(uint16_t &x0, uint16_t &y0, uint16_t &z0) =0;
     virtual void _setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) =0;
     virtual void _writeData88(uint8_t dataHigh8, uint8_t dataLow8) =0;
+    virtual void _writeDataBuffer(const uint16_t * data16, uint32_t count);
+    void         _fillArea(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t colour);
+    void         _circleOctants(int16_t x0, int16_t y0, int16_t x1, int16_t x2, int16_t y, uint16_t colour);
     void         _displayTarget(uint16_t x0, uint16_t y0, uint16_t colour);
     void         _swap(int16_t &a, int16_t &b);
     void         _swap(uint16_t &a, uint16_t &b);
@@ -410,6 +410,54 @@ void Screen_K35_SPI::_writeData88(uint8_t dataHigh8, uint8_t dataLow8)
 #endif
 }
 
+//*****************************************************************************
+//
+// Writes count pixels in one transaction, from data16 or, without it, all of
+// colour.  Where SPI can, they go out a buffer at a time.
+//
+//*****************************************************************************
+void Screen_K35_SPI::_writePixels(const uint16_t * data16, uint16_t colour, uint32_t count)
+{
+#if (GPIO_MODE == GPIO_FAST)
+    HWREG(LCD_DC_BASE + GPIO_O_DATA + (LCD_DC_PIN << 2)) = LCD_DC_PIN;          // HIGH = data
+    HWREG(LCD_CS_BASE + GPIO_O_DATA + (LCD_CS_PIN << 2)) = 0;                   // CS LOW
+#else
+    digitalWrite(_pinScreenDataCommand, HIGH);                                  // HIGH = data
+    digitalWrite(_pinScreenChipSelect, LOW);                                    // CS LOW
+#endif
+
+#ifdef SPI_HAS_TRANSFER_BUF
+    uint8_t buffer[64];
+    while (count > 0) {
+        uint32_t n = (count < sizeof(buffer)/2) ? count : sizeof(buffer)/2;
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t pixel = data16 ? *data16++ : colour;
+            buffer[2*i]   = highByte(pixel);
+            buffer[2*i+1] = lowByte(pixel);
+        }
+        SPI.transfer(buffer, 2*n);
+        count -= n;
+    }
+#else
+    for (; count > 0; count--) {
+        uint16_t pixel = data16 ? *data16++ : colour;
+        SPI.transfer(highByte(pixel));
+        SPI.transfer(lowByte(pixel));
+    }
+#endif
+
+#if (GPIO_MODE == GPIO_FAST)
+    HWREG(LCD_CS_BASE + GPIO_O_DATA + (LCD_CS_PIN << 2)) = LCD_CS_PIN;          // CS HIGH
+#else
+    digitalWrite(_pinScreenChipSelect, HIGH);                                   // CS HIGH
+#endif
+}
+
+void Screen_K35_SPI::_writeDataBuffer(const uint16_t * data16, uint32_t count)
+{
+    _writePixels(data16, 0, count);
+}
+
 //*****************************************************************************
 //
 // Writes a command to the SSD2119.  This function implements the basic GPIO
@@ -512,13 +560,8 @@ void Screen_K35_SPI::_fastFill(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y
     if (x1 > x2) _swap(x1, x2);
     if (y1 > y2) _swap(y1, y2);
     
-    uint8_t highColour = highByte(colour);
-    uint8_t lowColour  = lowByte(colour);
-    
     _setWindow(x1, y1, x2, y2);
-    for (uint32_t t=(uint32_t)(y2-y1+1)*(x2-x1+1); t>0; t--) {
-        _writeData88(highColour, lowColour);
-    }
+    _writePixels(NULL, colour, (uint32_t)(y2-y1+1)*(x2-x1+1));
 }
 
 // Touch
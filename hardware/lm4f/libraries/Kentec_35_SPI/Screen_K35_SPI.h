@@ -109,6 +109,7 @@ private:
     
     // Write and Read
     void _writeData88(uint8_t dataHigh8, uint8_t dataLow8); // compulsory;
+    void _writeDataBuffer(const uint16_t * data16, uint32_t count);
     
 	// Touch
     void _getRawTouch(uint16_t &x0, uint16_t &y0, uint16_t &z0); // compulsory
@@ -118,6 +119,7 @@ private:
     void _writeRegister(uint8_t command8, uint16_t data16);
     void _writeCommand16(uint16_t command16);
     void _writeData16(uint16_t data16);
+    void _writePixels(const uint16_t * data16, uint16_t colour, uint32_t count);
     
     void _setCursor(uint16_t x1, uint16_t y1);
 
@@ -21,6 +21,7 @@
 
 #define SSIBASE g_ulSSIBase[SSIModule]
 #define NOT_ACTIVE 0xA
+#define SSI_FIFO_DEPTH 8
 
 /* variants
    stellarpad - LM4F120H5QR, TM4C123GH6PM, aka TARGET_IS_BLIZZARD_RB1
@@ -145,6 +146,18 @@ static const unsigned long g_ulSSIPins[] = {
 #endif
 };
 
+static inline uint32_t reverseByte(uint32_t data) {
+#if defined(__arm__)
+	asm("rbit %0, %1" : "=r" (data) : "r" (data));	// reverse order of 32 bits 
+	asm("rev %0, %1" : "=r" (data) : "r" (data));	// reverse order of bytes to get original bits into lowest byte 
+#else
+	data = ((data & 0xF0) >> 4) | ((data & 0x0F) << 4);
+	data = ((data & 0xCC) >> 2) | ((data & 0x33) << 2);
+	data = ((data & 0xAA) >> 1) | ((data & 0x55) << 1);
+#endif
+	return data;
+}
+
 SPIClass::SPIClass(void) {
 	SSIModule = NOT_ACTIVE;
 	SSIBitOrder = MSBFIRST;
@@ -156,7 +169,7 @@ SPIClass::SPIClass(uint8_t module) {
 }
   
 void SPIClass::begin() {
-	unsigned long initialData = 0;
+	uint32_t initialData = 0;
 
     if(SSIModule == NOT_ACTIVE) {
         SSIModule = BOOST_PACK_SPI;
@@ -230,26 +243,48 @@ void SPIClass::setClockDivider(uint8_t divider){
 }
 
 uint8_t SPIClass::transfer(uint8_t data) {
-	unsigned long rxtxData;
+	uint32_t rxtxData;
 
 	rxtxData = data;
-	if(SSIBitOrder == LSBFIRST) {
-		asm("rbit %0, %1" : "=r" (rxtxData) : "r" (rxtxData));	// reverse order of 32 bits 
-		asm("rev %0, %1" : "=r" (rxtxData) : "r" (rxtxData));	// reverse order of bytes to get original bits into lowest byte 
-	}
+	if(SSIBitOrder == LSBFIRST)
+		rxtxData = reverseByte(rxtxData);
 	ROM_SSIDataPut(SSIBASE, (uint8_t) rxtxData);
 
 	while(ROM_SSIBusy(SSIBASE));
 
 	ROM_SSIDataGet(SSIBASE, &rxtxData);
-	if(SSIBitOrder == LSBFIRST) {
-		asm("rbit %0, %1" : "=r" (rxtxData) : "r" (rxtxData));	// reverse order of 32 bits 
-		asm("rev %0, %1" : "=r" (rxtxData) : "r" (rxtxData));	// reverse order of bytes to get original bits into lowest byte 
-	}
+	if(SSIBitOrder == LSBFIRST)
+		rxtxData = reverseByte(rxtxData);
 
 	return (uint8_t) rxtxData;
 }
 
+/*
+ * Frames are queued up to the depth of the RX FIFO ahead of the one read
+ * back, so the bus shifts them back to back instead of idling while each
+ * byte is waited for and collected
+ */
+void SPIClass::transfer(void *buf, size_t count) {
+	uint8_t *out = (uint8_t *) buf;
+	uint8_t *in = out;
+	uint8_t *end = out + count;
+	uint32_t rxData;
+
+	while(in < end) {
+		while(out < end && out - in < SSI_FIFO_DEPTH) {
+			if(SSIBitOrder == LSBFIRST)
+				ROM_SSIDataPut(SSIBASE, (uint8_t) reverseByte(*out));
+			else
+				ROM_SSIDataPut(SSIBASE, *out);
+			out++;
+		}
+		ROM_SSIDataGet(SSIBASE, &rxData);
+		if(SSIBitOrder == LSBFIRST)
+			rxData = reverseByte(rxData);
+		*in++ = (uint8_t) rxData;
+	}
+}
+
 void SPIClass::setModule(uint8_t module) {
 	SSIModule = module;
 	begin();
@@ -29,6 +29,9 @@
 
 #define BOOST_PACK_SPI 2
 
+// transfer(buf, count) exchanges a whole buffer in place
+#define SPI_HAS_TRANSFER_BUF 1
+
 #define MSBFIRST 1
 #define LSBFIRST 0
 
@@ -54,6 +57,7 @@ public:
   void setClockDivider(uint8_t);
 
   uint8_t transfer(uint8_t);
+  void transfer(void *, size_t);
 
   //Stellarpad-specific functions
   void setModule(uint8_t);
@@ -73,36 +73,13 @@
 #endif
 #define UCAxIV        UCA0IV
 
-#define SERIAL_BUFFER_SIZE 16
-
-struct ring_buffer
-{
-	unsigned char buffer[SERIAL_BUFFER_SIZE];
-	volatile unsigned int head;
-	volatile unsigned int tail;
-};
-
-ring_buffer rx_buffer  =  { { 0 }, 0, 0 };
-ring_buffer tx_buffer  =  { { 0 }, 0, 0 };
+ring_buffer rx_buffer;
+ring_buffer tx_buffer;
 #ifdef SERIAL1_AVAILABLE
-ring_buffer rx_buffer1  =  { { 0 }, 0, 0 };
-ring_buffer tx_buffer1  =  { { 0 }, 0, 0 };
+ring_buffer rx_buffer1;
+ring_buffer tx_buffer1;
 #endif
 
-inline void store_char(unsigned char c, ring_buffer *buffer)
-{
-	unsigned int i = (unsigned int)(buffer->head + 1) % SERIAL_BUFFER_SIZE;
-
-	// if we should be storing the received character into the location
-	// just before the tail (meaning that the head would advance to the
-	// current location of the tail), we're about to overflow the buffer
-	// and so we don't write the character or advance the head.
-	if (i != buffer->tail) {
-		buffer->buffer[buffer->head] = c;
-		buffer->head = i;
-	}
-}
-
 void serialEvent() __attribute__((weak));
 void serialEvent() {}
 #ifdef SERIAL1_AVAILABLE
@@ -185,53 +162,37 @@ void HardwareSerial::begin(unsigned long baud)
 void HardwareSerial::end()
 {
 	// wait for transmission of outgoing data
-	while (_tx_buffer->head != _tx_buffer->tail);
+	while (!_tx_buffer->empty());
 
-	_rx_buffer->head = _rx_buffer->tail;
+	_rx_buffer->clear();
 }
 
 int HardwareSerial::available(void)
 {
-	return (unsigned int)(SERIAL_BUFFER_SIZE + _rx_buffer->head - _rx_buffer->tail) % SERIAL_BUFFER_SIZE;
+	return _rx_buffer->available();
 }
 
 int HardwareSerial::peek(void)
 {
-	if (_rx_buffer->head == _rx_buffer->tail) {
-		return -1;
-	} else {
-		return _rx_buffer->buffer[_rx_buffer->tail];
-	}
+	return _rx_buffer->peek();
 }
 
 int HardwareSerial::read(void)
 {
-	// if the head isn't ahead of the tail, we don't have any characters
-	if (_rx_buffer->head == _rx_buffer->tail) {
-		return -1;
-	} else {
-		unsigned char c = _rx_buffer->buffer[_rx_buffer->tail];
-		_rx_buffer->tail = (unsigned int)(_rx_buffer->tail + 1) % SERIAL_BUFFER_SIZE;
-		return c;
-	}
+	return _rx_buffer->pop();
 }
 
 void HardwareSerial::flush()
 {
-	while (_tx_buffer->head != _tx_buffer->tail);
+	while (!_tx_buffer->empty());
 }
 
 size_t HardwareSerial::write(uint8_t c)
 {
-	unsigned int i = (_tx_buffer->head + 1) % SERIAL_BUFFER_SIZE;
-	
 	// If the output buffer is full, there's nothing for it other than to
 	// wait for the interrupt handler to empty it a bit
 	// ???: return 0 here instead?
-	while (i == _tx_buffer->tail);
-	
-	_tx_buffer->buffer[_tx_buffer->head] = c;
-	_tx_buffer->head = i;
+	while (!_tx_buffer->push(c));
 
 #if defined(__MSP430_HAS_USCI_A0__) || defined(__MSP430_HAS_USCI_A1__) || defined(__MSP430_HAS_EUSCI_A0__) || defined(__MSP430_HAS_EUSCI_A1__)
 	*(&(UCAxIE) + uartOffset) |= UCTXIE;
@@ -255,7 +216,8 @@ void uart_rx_isr(uint8_t offset)
 	ring_buffer *rx_buffer_ptr = &rx_buffer;
 #endif
 	unsigned char c = *(&(UCAxRXBUF) + offset);
-	store_char(c, rx_buffer_ptr);
+	// if the buffer is full the character is dropped
+	rx_buffer_ptr->push(c);
 }
 
 void uart_tx_isr(uint8_t offset)
@@ -266,7 +228,7 @@ void uart_tx_isr(uint8_t offset)
 #else
 	ring_buffer *tx_buffer_ptr = &tx_buffer;
 #endif
-	if (tx_buffer_ptr->head == tx_buffer_ptr->tail) {
+	if (tx_buffer_ptr->empty()) {
 		// Buffer empty, so disable interrupts
 #if defined(__MSP430_HAS_USCI_A0__) || defined(__MSP430_HAS_USCI_A1__) || defined(__MSP430_HAS_EUSCI_A0__) || defined(__MSP430_HAS_EUSCI_A1__)
 		*(&(UCAxIE) + offset) &= ~UCTXIE;
@@ -277,9 +239,7 @@ void uart_tx_isr(uint8_t offset)
 		return;
 	}
 
-	unsigned char c = tx_buffer_ptr->buffer[tx_buffer_ptr->tail];
-	tx_buffer_ptr->tail = (tx_buffer_ptr->tail + 1) % SERIAL_BUFFER_SIZE;
-	*(&(UCAxTXBUF) + offset) = c;
+	*(&(UCAxTXBUF) + offset) = tx_buffer_ptr->pop();
 }
 // Preinstantiate Objects //////////////////////////////////////////////////////
 
@@ -32,8 +32,11 @@
 #if defined(__MSP430_HAS_USCI__) || defined(__MSP430_HAS_USCI_A0__) || defined(__MSP430_HAS_USCI_A1__) || defined(__MSP430_HAS_EUSCI_A0__) || defined(__MSP430_HAS_EUSCI_A1__)
 #include <inttypes.h>
 #include <Stream.h>
+#include "RingBuffer.h"
 
-struct ring_buffer;
+#define SERIAL_BUFFER_SIZE 16
+
+typedef RingBuffer<SERIAL_BUFFER_SIZE> ring_buffer;
 
 class HardwareSerial : public Stream
 {
@@ -32,8 +32,6 @@
 #include "Energia.h"
 #include "TimerSerial.h"
 
-#define SERIAL_BUFFER_SIZE 16
-
 #ifndef TIMERA0_VECTOR
  #define TIMERA0_VECTOR TIMER0_A0_VECTOR
 #endif /* TIMER0_A0_VECTOR */
@@ -42,13 +40,6 @@
  #define TIMERA1_VECTOR TIMER0_A1_VECTOR
 #endif /* TIMERA1_VECTOR */
 
-struct ring_buffer_ts
-{
-    volatile unsigned int head;
-    volatile unsigned int tail;
-    unsigned char buffer[SERIAL_BUFFER_SIZE];
-};
-
 /**
  * uint8x2_t - optimized structure storage for ISR. Fits our static variables in one register
  *             This tweak allows the ISR to use one less register saving a push and pop
@@ -122,23 +113,12 @@ void TimerSerial::end()
 
 int TimerSerial::read()
 {
-    register uint16_t temp_tail=rx_buffer.tail;
-
-    if (rx_buffer.head != temp_tail) {
-        uint8_t c = rx_buffer.buffer[temp_tail++];
-        rx_buffer.tail = temp_tail % SERIAL_BUFFER_SIZE;
-        return c;
-    }
-    else {
-        return -1;
-    }
+    return rx_buffer.pop();
 }
 
 int TimerSerial::available()
 {
-    unsigned cnt = (rx_buffer.head - rx_buffer.tail) % SERIAL_BUFFER_SIZE;
-
-    return cnt;
+    return rx_buffer.available();
 }
 
 void TimerSerial::flush()
@@ -150,14 +130,7 @@ void TimerSerial::flush()
 
 int TimerSerial::peek()
 {
-    register uint16_t temp_tail=rx_buffer.tail;
-
-    if (rx_buffer.head != temp_tail) {
-        return rx_buffer.buffer[temp_tail];
-    }
-    else {
-        return -1;
-    }
+    return rx_buffer.peek();
 }
 
 size_t TimerSerial::write(uint8_t c)
@@ -223,15 +196,8 @@ static void TimerSerial__TxIsr(void)
     }
 }
 
-#define store_rxchar(c) { \
-    register unsigned int next_head;\
-    next_head = rx_buffer.head;\
-    rx_buffer.buffer[next_head++]=c; \
-    next_head %= SERIAL_BUFFER_SIZE; \
-    if ( next_head != rx_buffer.tail ) { \
-        rx_buffer.head = next_head; \
-    } \
-}
+// a character arriving to a full buffer is dropped
+#define store_rxchar(c) rx_buffer.push(c)
 
 #ifndef TIMER0_A1_VECTOR
 #define TIMER0_A1_VECTOR TIMERA1_VECTOR
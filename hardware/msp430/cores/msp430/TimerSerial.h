@@ -26,6 +26,7 @@
 
 #include <inttypes.h>
 #include <Stream.h>
+#include "RingBuffer.h"
 
 #define TX_PIN BIT1	// TXD on P1.1
 #define RX_PIN BIT2	// RXD on P1.2
@@ -39,9 +40,12 @@
 #endif
 #endif
 
+#define TIMERSERIAL_BUFFER_SIZE 16
+
+typedef RingBuffer<TIMERSERIAL_BUFFER_SIZE> ring_buffer_ts;
+
 #if defined(__MSP430G2231__)
  #define NEEDS_BUFF_PTR 1 // sadly, the g2231 seems to have a problem if we don't use the original structure
- struct ring_buffer_ts; // forward declaration
 #else
  #define NEEDS_BUFF_PTR 0 // everything else is happy to run fully optimized
 #endif
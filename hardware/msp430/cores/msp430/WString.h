@@ -41,6 +41,16 @@ class __FlashStringHelper;
 // result objects are assumed to be writable by subsequent concatenations.
 class StringSumHelper;
 
+// Strings shorter than this are kept inside the String object itself and
+// need no heap allocation.
+#ifndef STRING_SSO_SIZE
+#if defined(__MSP430__) || defined(__TMS320C2000__)
+#define STRING_SSO_SIZE 8
+#else
+#define STRING_SSO_SIZE 16
+#endif
+#endif
+
 // The string class
 class String
 {
@@ -63,6 +73,9 @@ public:
 	String(String &&rval);
 	String(StringSumHelper &&rval);
 	#endif
+	// takes over the buffer of a concatenation result, which is a
+	// temporary, instead of copying it
+	String(StringSumHelper &rval);
 	explicit String(char c);
 	explicit String(unsigned char, unsigned char base=10);
 	explicit String(int, unsigned char base=10);
@@ -90,6 +103,7 @@ public:
 	String & operator = (String &&rval);
 	String & operator = (StringSumHelper &&rval);
 	#endif
+	String & operator = (StringSumHelper &rval);
 
 	// concatenate (works w/ built-in types)
 	
@@ -188,9 +202,10 @@ public:
 	float toFloat(void) const;
 
 protected:
-	char *buffer;	        // the actual char array
+	char *buffer;	        // the actual char array, sso or on the heap
 	unsigned int capacity;  // the array length minus one (for the '\0')
 	unsigned int len;       // the String length (not counting the '\0')
+	char sso[STRING_SSO_SIZE]; // storage for short strings
 protected:
 	void init(void);
 	void invalidate(void);
@@ -200,15 +215,16 @@ protected:
 	// copy and move
 	String & copy(const char *cstr, unsigned int length);
 	String & copy(const __FlashStringHelper *pstr, unsigned int length);
-	#ifdef __GXX_EXPERIMENTAL_CXX0X__
 	void move(String &rhs);
-	#endif
 };
 
 class StringSumHelper : public String
 {
 public:
 	StringSumHelper(const String &s) : String(s) {}
+	#ifdef __GXX_EXPERIMENTAL_CXX0X__
+	StringSumHelper(String &&s) : String(static_cast<String &&>(s)) {}
+	#endif
 	StringSumHelper(const char *p) : String(p) {}
 	StringSumHelper(char c) : String(c) {}
 	StringSumHelper(unsigned char num) : String(num) {}
@@ -100,215 +100,55 @@ void LCD_screen_font::gText(uint16_t x0, uint16_t y0,
                             uint8_t ix, uint8_t iy)
 {
     uint8_t c;
-    uint8_t line, line1, line2, line3;
-    uint16_t x, y;
-    uint8_t i, j, k;
+    uint8_t width  = fontSizeX();
+    uint8_t height = fontSizeY();
+    uint8_t bands  = (height + 7) / 8;      // bytes per column of a character
+    uint8_t i, j, k, b;
+    if (width == 0) return;
     if ((ix > 1) || (iy > 1) || !_fontSolid) {
-        if ((_fontSize == 0) && ((ix > 1) || (iy > 1))) {
-            bool oldPenSolid = _penSolid;
-            setPenSolid(true);
-            for (k=0; k<s.length(); k++) {
-                x = x0 + 6 * k * ix;
-                y = y0;
-                c = s.charAt(k)-' ';
-                for ( i=0; i<6; i++ ) {
-                    line = _getCharacter(c, i);
-                    for ( j = 0; j<8; j++) {
-                        if (bitRead(line, j)) rectangle(x+i*ix, y+j*iy, x+i*ix+ix-1, y+j*iy+iy-1, textColour);
-                        else if (_fontSolid)  rectangle(x+i*ix, y+j*iy, x+i*ix+ix-1, y+j*iy+iy-1, backColour);
-                    }
-                }
-            }
-            setPenSolid(oldPenSolid);
-        } else {
-#if (MAX_FONT_SIZE > 0)
-            if (_fontSize == 0) {
-                for (k=0; k<s.length(); k++) {
-                    c = s.charAt(k)-' ';
-                    for (i=0; i<6; i++) {
-                        line = _getCharacter(c, i);
-                        for (j=0; j<8; j++)
-                            if (bitRead(line, j)) point(x0 + 6*k + i, y0 + j, textColour);
-                            else if (_fontSolid)  point(x0 + 6*k + i, y0 + j, backColour);
-                    }
-                }
-            }
-#if (MAX_FONT_SIZE > 1)
-            else if (_fontSize == 1) {
-                for (k=0; k<s.length(); k++) {
-                    c = s.charAt(k)-' ';
-                    for (i=0; i<8; i++) {
-                        line = _getCharacter(c, 2*i);
-                        line1 =_getCharacter(c, 2*i+1);
-                        for (j=0; j<8; j++) {
-                            if (bitRead(line, j)) point(x0 + 8*k + i, y0 + j, textColour);
-                            else if (_fontSolid)  point(x0 + 8*k + i, y0 + j, backColour);
-                            if (bitRead(line1, j))  point(x0 + 8*k + i, y0 +8 + j, textColour);
-                            else if ((_fontSolid) && (j<4)) point(x0 + 8*k + i, y0 +8 + j, backColour);
-                        }
-                    }
-                }
-            }
-#if (MAX_FONT_SIZE > 2)
-            else if (_fontSize == 2) {
-                for (k=0; k<s.length(); k++) {
-                    c = s.charAt(k)-' ';
-                    for (i=0; i<12; i++) {
-                        line = _getCharacter(c, 2*i);
-                        line1 =_getCharacter(c, 2*i+1);
-                        for (j=0; j<8; j++) {
-                            if (bitRead(line, j))  point(x0 + 12*k + i, y0 + j,    textColour);
-                            else if (_fontSolid)   point(x0 + 12*k + i, y0 + j,    backColour);
-                            if (bitRead(line1, j)) point(x0 + 12*k + i, y0 +8 + j, textColour);
-                            else if (_fontSolid)   point(x0 + 12*k + i, y0 +8 + j, backColour);
-                        }
-                    }
-                }
-            }
-#if (MAX_FONT_SIZE > 3)
-            else if (_fontSize == 3) {
-                for (k=0; k<s.length(); k++) {
-                    c = s.charAt(k)-' ';
-                    for (i=0; i<16; i++) {
-                        line  =_getCharacter(c, 3*i);
-                        line1 =_getCharacter(c, 3*i+1);
-                        line2 =_getCharacter(c, 3*i+2);
-                        for (j=0; j<8; j++) {
-                            if (bitRead(line, j))  point(x0 + 16*k + i, y0 + j,     textColour);
-                            else if (_fontSolid)   point(x0 + 16*k + i, y0 + j,     backColour);
-                            if (bitRead(line1, j)) point(x0 + 16*k + i, y0 +8 + j,  textColour);
-                            else if (_fontSolid)   point(x0 + 16*k + i, y0 +8 + j,  backColour);
-                            if (bitRead(line2, j)) point(x0 + 16*k + i, y0 +16 + j, textColour);
-                            else if (_fontSolid)   point(x0 + 16*k + i, y0 +16 + j, backColour);
-                        }
-                    }
-                }
-            }
-#endif
-#endif
-#endif
-#endif
+        // only the smallest font scales
+        if (_fontSize > 0) {
+            ix = 1;
+            iy = 1;
         }
-    } else {
-        uint8_t c;
-        uint8_t line, line1;
-        uint16_t x, y;
-        uint8_t i, j, k;
-        uint8_t highTextColour = highByte(textColour);
-        uint8_t lowTextColour = lowByte(textColour);
-        uint8_t highBackColour = highByte(backColour);
-        uint8_t lowBackColour = lowByte(backColour);
-#if (MAX_FONT_SIZE > 0)
-        if (_fontSize == 0) {
-            for (k=0; k<s.length(); k++) {
-                c = s.charAt(k)-' ';
-                _setWindow(x0 +fontSizeX()*k, y0, x0 +fontSizeX()*(k+1)-1, y0+fontSizeY()-1);
-                for (j=0; j<8; j++) {
-                    for (i=0; i<6; i++) {
-                        line = _getCharacter(c, i);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
+        for (k=0; k<s.length(); k++) {
+            c = s.charAt(k)-' ';
+            for (i=0; i<width; i++) {
+                int16_t x = x0 + (width*k + i)*ix;
+                uint32_t column = 0;
+                for (b=0; b<bands; b++) column |= (uint32_t)_getCharacter(c, bands*i + b) << (8*b);
+                // runs of text, or background, down the column
+                j = 0;
+                while (j < 8*bands) {
+                    uint8_t start = j;
+                    bool text = bitRead(column, j);
+                    while ((j < 8*bands) && (bitRead(column, j) == text)) j++;
+                    if (text) {
+                        _fillArea(x, y0 + start*iy, x+ix-1, y0 + j*iy-1, textColour);
+                    } else if (_fontSolid && (start < height)) {
+                        _fillArea(x, y0 + start*iy, x+ix-1, y0 + ((j < height) ? j : height)*iy-1, backColour);
                     }
                 }
             }
         }
-#if (MAX_FONT_SIZE > 1)
-        else if (_fontSize == 1) {
-            for (k=0; k<s.length(); k++) {
-                c = s.charAt(k)-' ';
-                _setWindow(x0 +fontSizeX()*k, y0, x0 +fontSizeX()*(k+1)-1, y0+fontSizeY()-1);
-                for (j=0; j<8; j++) {
-                    for (i=0; i<8; i++) {
-                        line = _getCharacter(c, 2*i);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
-                    }
-                }
-                for (j=0; j<4; j++) {
-                    for (i=0; i<8; i++) {
-                        line = _getCharacter(c, 2*i+1);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
-                    }
-                }
-            }
-        }
-#if (MAX_FONT_SIZE > 2)
-        else if (_fontSize == 2) {
-            for (k=0; k<s.length(); k++) {
-                c = s.charAt(k)-' ';
-                _setWindow(x0 +fontSizeX()*k, y0, x0 +fontSizeX()*(k+1)-1, y0+fontSizeY()-1);
-                for (j=0; j<8; j++) {
-                    for (i=0; i<12; i++) {
-                        line = _getCharacter(c, 2*i);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
-                    }
-                }
-                for (j=0; j<8; j++) {
-                    for (i=0; i<12; i++) {
-                        line = _getCharacter(c, 2*i+1);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
-                    }
-                }
-            }
-        }
-#if (MAX_FONT_SIZE > 3)
-        else if (_fontSize == 3) {
-            for (k=0; k<s.length(); k++) {
-                c = s.charAt(k)-' ';
-                _setWindow(x0 +fontSizeX()*k, y0, x0 +fontSizeX()*(k+1)-1, y0+fontSizeY()-1);
-                for (j=0; j<8; j++) {
-                    for (i=0; i<16; i++) {
-                        line = _getCharacter(c, 3*i);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
-                    }
-                }
-                for (j=0; j<8; j++) {
-                    for (i=0; i<16; i++) {
-                        line = _getCharacter(c, 3*i+1);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
-                    }
-                }
-                for (j=0; j<8; j++) {
-                    for (i=0; i<16; i++) {
-                        line = _getCharacter(c, 3*i+2);
-                        if (bitRead(line, j)) {
-                            _writeData88(highTextColour, lowTextColour);
-                        } else {
-                            _writeData88(highBackColour, lowBackColour);
-                        }
+    } else {
+        // one window a character, streamed a line at a time: a band of 8
+        // lines would take 272 bytes of stack, too many for a G2's RAM
+        uint16_t pixels[16];
+        uint8_t lines[16];
+        for (k=0; k<s.length(); k++) {
+            c = s.charAt(k)-' ';
+            _setWindow(x0 + width*k, y0, x0 + width*(k+1)-1, y0+height-1);
+            for (b=0; b<bands; b++) {
+                uint8_t rows = (height - 8*b < 8) ? height - 8*b : 8;
+                for (i=0; i<width; i++) lines[i] = _getCharacter(c, bands*i + b);
+                for (j=0; j<rows; j++) {
+                    for (i=0; i<width; i++) {
+                        pixels[i] = bitRead(lines[i], j) ? textColour : backColour;
                     }
+                    _writeDataBuffer(pixels, width);
                 }
             }
         }
-#endif
-#endif
-#endif
-#endif
     }
 }
@@ -104,12 +104,12 @@ void LCD_screen::circle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t colo
     int16_t x = 0;
     int16_t y = radius;
     if (_penSolid == false) {
-        point(x0, y0+radius, colour);
-        point(x0, y0-radius, colour);
-        point(x0+radius, y0, colour);
-        point(x0-radius, y0, colour);
+        // the points with the same y make a span in each octant
+        int16_t xs = x;
         while (x<y) {
             if (f >= 0) {
+                _circleOctants(x0, y0, xs, x, y, colour);
+                xs = x + 1;
                 y--;
                 ddF_y += 2;
                 f += ddF_y;
@@ -117,15 +117,8 @@ void LCD_screen::circle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t colo
             x++;
             ddF_x += 2;
             f += ddF_x;
-            point(x0 + x, y0 + y, colour);
-            point(x0 - x, y0 + y, colour);
-            point(x0 + x, y0 - y, colour);
-            point(x0 - x, y0 - y, colour);
-            point(x0 + y, y0 + x, colour);
-            point(x0 - y, y0 + x, colour);
-            point(x0 + y, y0 - x, colour);
-            point(x0 - y, y0 - x, colour);
         }
+        _circleOctants(x0, y0, xs, x, y, colour);
     } else {
         while (x<y) {
             if (f >= 0) {
@@ -173,12 +166,17 @@ void LCD_screen::line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16
         int16_t dy = abs(wy2 - wy1);
         int16_t err = dx / 2;
         int16_t ystep;
+        int16_t start = wx1;
         if (wy1 < wy2) ystep = 1;
         else ystep = -1;
         for (; wx1<=wx2; wx1++) {
-            if (flag) _setPoint(wy1, wx1, colour);
-            else _setPoint(wx1, wy1, colour);
             err -= dy;
+            // the points before a step of y make a span
+            if ((err < 0) || (wx1 == wx2)) {
+                if (flag) _fillArea(wy1, start, wy1, wx1, colour);
+                else _fillArea(start, wy1, wx1, wy1, colour);
+                start = wx1 + 1;
+            }
             if (err < 0) {
                 wy1 += ystep;
                 err += dx;
@@ -377,6 +375,37 @@ void LCD_screen::copyArea(uint16_t x0, uint16_t y0, uint16_t dx, uint16_t dy, ui
 void LCD_screen::pasteArea(uint16_t x0, uint16_t y0, uint16_t dx, uint16_t dy, uint32_t &address, bool option)
 {
 }
+void LCD_screen::_writeDataBuffer(const uint16_t * data16, uint32_t count)
+{
+    for (; count > 0; count--, data16++) {
+        _writeData88(highByte(*data16), lowByte(*data16));
+    }
+}
+void LCD_screen::_fillArea(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t colour)
+{
+    int16_t xmax = (int16_t)screenSizeX()-1;
+    int16_t ymax = (int16_t)screenSizeY()-1;
+    if (x1 > x2) _swap(x1, x2);
+    if (y1 > y2) _swap(y1, y2);
+    if ((x2 < 0) || (y2 < 0) || (x1 > xmax) || (y1 > ymax)) return;
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > xmax) x2 = xmax;
+    if (y2 > ymax) y2 = ymax;
+    if ((x1 == x2) && (y1 == y2)) _setPoint(x1, y1, colour);
+    else _fastFill(x1, y1, x2, y2, colour);
+}
+void LCD_screen::_circleOctants(int16_t x0, int16_t y0, int16_t x1, int16_t x2, int16_t y, uint16_t colour)
+{
+    _fillArea(x0 + x1, y0 + y, x0 + x2, y0 + y, colour);
+    _fillArea(x0 - x2, y0 + y, x0 - x1, y0 + y, colour);
+    _fillArea(x0 + x1, y0 - y, x0 + x2, y0 - y, colour);
+    _fillArea(x0 - x2, y0 - y, x0 - x1, y0 - y, colour);
+    _fillArea(x0 + y, y0 + x1, x0 + y, y0 + x2, colour);
+    _fillArea(x0 - y, y0 + x1, x0 - y, y0 + x2, colour);
+    _fillArea(x0 + y, y0 - x2, x0 + y, y0 - x1, colour);
+    _fillArea(x0 - y, y0 - x2, x0 - y, y0 - x1, colour);
+}
 void LCD_screen::_displayTarget(uint16_t x0, uint16_t y0, uint16_t colour)
 {
     setPenSolid(false);
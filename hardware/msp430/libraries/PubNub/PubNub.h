@@ -161,6 +161,27 @@ public:
 	 * @return string Stream-ish object with reply message or NULL on error. */
 	PubNub_BASE_CLIENT *history(const char *channel, int limit = 10, int timeout = 310);
 
+	/**
+	 * History, parsed as it arrives
+	 *
+	 * Receive the last N messages like above, but read the reply here
+	 * with an aJsonPullParser instead of returning the client, calling
+	 * back for each JSON event in it. Match the parser's path against
+	 * "[*]" for the messages or e.g. "[*].text" for a field of each.
+	 * Memory use does not depend on the length of the reply.
+	 * Include aJSON.h to use this.
+	 *
+	 * @param string channel required channel name.
+	 * @param callback required, called with the parser, the event
+	 * and context.
+	 * @param context optional, passed to callback as is.
+	 * @param int limit optional number of messages to retrieve.
+	 * @param string timeout optional timeout in seconds.
+	 * @return boolean whether the whole reply was received. */
+	template <class Parser>
+	bool history(const char *channel, void (*callback)(Parser *parser, int event, void *context),
+			void *context = NULL, int limit = 10, int timeout = 310);
+
 private:
 	enum PubNub_BH _request_bh(PubNub_BASE_CLIENT &client, unsigned long t_start, int timeout, char qparsep);
 
@@ -172,6 +193,23 @@ private:
 	PubSubClient subscribe_client;
 };
 
+/* Only instantiated by sketches that use it, so that PubNub does not
+ * need aJson otherwise. */
+template <class Parser>
+bool PubNub::history(const char *channel, void (*callback)(Parser *parser, int event, void *context),
+		void *context, int limit, int timeout)
+{
+	PubNub_BASE_CLIENT *client = history(channel, limit, timeout);
+	if (!client)
+		return false;
+
+	typename Parser::ClientStream stream(client);
+	Parser parser(&stream);
+	parser.parse(callback, context);
+	client->stop();
+	return parser.complete();
+}
+
 extern class PubNub PubNub;
 
 #endif
@@ -87,9 +87,7 @@ const int XMIT_START_ADJUSTMENT = 5;
 // Statics
 //
 SoftwareSerial *SoftwareSerial::active_object = 0;
-char SoftwareSerial::_receive_buffer[_SS_MAX_RX_BUFF]; 
-volatile uint8_t SoftwareSerial::_receive_buffer_tail = 0;
-volatile uint8_t SoftwareSerial::_receive_buffer_head = 0;
+RingBuffer<_SS_MAX_RX_BUFF> SoftwareSerial::_receive_buffer;
 
 
 //
@@ -117,7 +115,7 @@ bool SoftwareSerial::listen() {
     _buffer_overflow = false;
     uint8_t oldSR = __read_status_register();
     noInterrupts();
-    _receive_buffer_head = _receive_buffer_tail = 0;
+    _receive_buffer.clear();
     active_object = this;
     __write_status_register(oldSR);
     return true;
@@ -157,14 +155,8 @@ void SoftwareSerial::recv()
     if (_inverse_logic)
       d = ~d;
 
-    // if buffer full, set the overflow flag and return
-    if ((_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF != _receive_buffer_head) 
-    {
-      // save new data in buffer: tail points to where byte goes
-      _receive_buffer[_receive_buffer_tail] = d; // save new byte
-      _receive_buffer_tail = (_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF;
-    } 
-    else 
+    // save new data in buffer; if it is full, set the overflow flag
+    if (!_receive_buffer.push(d))
     {
       _buffer_overflow = true;
     }
@@ -285,14 +277,8 @@ int SoftwareSerial::read()
   if (!isListening())
     return -1;
 
-  // Empty buffer?
-  if (_receive_buffer_head == _receive_buffer_tail)
-    return -1;
-
-  // Read from "head"
-  uint8_t d = _receive_buffer[_receive_buffer_head]; // grab next byte
-  _receive_buffer_head = (_receive_buffer_head + 1) % _SS_MAX_RX_BUFF;
-  return d;
+  // Next byte, or -1 if the buffer is empty
+  return _receive_buffer.pop();
 }
 
 int SoftwareSerial::available()
@@ -300,7 +286,7 @@ int SoftwareSerial::available()
   if (!isListening())
     return 0;
 
-  return (_receive_buffer_tail + _SS_MAX_RX_BUFF - _receive_buffer_head) % _SS_MAX_RX_BUFF;
+  return _receive_buffer.available();
 }
 
 size_t SoftwareSerial::write(uint8_t b)
@@ -362,7 +348,7 @@ void SoftwareSerial::flush()
 
   uint8_t oldSR = __read_status_register();
   noInterrupts();
-  _receive_buffer_head = _receive_buffer_tail = 0;
+  _receive_buffer.clear();
   __write_status_register(oldSR);
 }
 
@@ -371,11 +357,7 @@ int SoftwareSerial::peek()
   if (!isListening())
     return -1;
 
-  // Empty buffer?
-  if (_receive_buffer_head == _receive_buffer_tail)
-    return -1;
-
-  // Read from "head"
-  return _receive_buffer[_receive_buffer_head];
+  // Next byte, or -1 if the buffer is empty
+  return _receive_buffer.peek();
 }
 
@@ -36,6 +36,7 @@ SoftwareSerial.h (formerly NewSoftSerial.h) -
 
 #include <inttypes.h>
 #include <Stream.h>
+#include <RingBuffer.h>
 
 /******************************************************************************
  * Definitions
@@ -64,9 +65,7 @@ uint16_t _inverse_logic:
   1;
 
   // static data
-  static char _receive_buffer[_SS_MAX_RX_BUFF]; 
-  static volatile uint8_t _receive_buffer_tail;
-  static volatile uint8_t _receive_buffer_head;
+  static RingBuffer<_SS_MAX_RX_BUFF> _receive_buffer;
   static SoftwareSerial *active_object;
 
   // private methods
@@ -88,7 +88,7 @@ size_t EthernetClient::write(const uint8_t *buf, size_t size) {
 
 int EthernetClient::available() {
   if (_sock != MAX_SOCK_NUM)
-    return W5100.getRXReceivedSize(_sock);
+    return recvAvailable(_sock);
   return 0;
 }
 
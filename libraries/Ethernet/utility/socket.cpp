@@ -1,8 +1,56 @@
+#include <string.h>
+
 #include "w5100.h"
 #include "socket.h"
 
 static uint16_t local_port;
 
+// Bytes taken from a socket's receive buffer on the chip ahead of recv(),
+// so that reading a byte or a few at a time is served from RAM instead of
+// costing a size check, a RECV command and a dozen SPI frames each.
+// Emptied whenever the socket is closed, and so whenever it is opened.
+#ifndef SOCK_RX_CACHE
+#define SOCK_RX_CACHE 64
+#endif
+
+static struct {
+  uint8_t data[SOCK_RX_CACHE];
+  uint16_t head;
+  uint16_t len;
+} rx_cache[MAX_SOCK_NUM];
+
+/**
+ * @brief	Fills the socket's empty receive cache from the len bytes the chip holds, as many as fit.
+ * @return	the number of bytes cached.
+ */
+static uint16_t rx_fill(SOCKET s, uint16_t len)
+{
+  if (len > SOCK_RX_CACHE)
+    len = SOCK_RX_CACHE;
+  if (len > 0)
+  {
+    W5100.recv_data_processing(s, rx_cache[s].data, len);
+    W5100.execCmdSn(s, Sock_RECV);
+  }
+  rx_cache[s].head = 0;
+  rx_cache[s].len = len;
+  return len;
+}
+
+/**
+ * @brief	Copies up to len bytes out of the socket's receive cache.
+ * @return	the number of bytes copied.
+ */
+static int16_t rx_take(SOCKET s, uint8_t *buf, int16_t len)
+{
+  if (len > (int16_t)rx_cache[s].len)
+    len = rx_cache[s].len;
+  memcpy(buf, rx_cache[s].data + rx_cache[s].head, len);
+  rx_cache[s].head += len;
+  rx_cache[s].len -= len;
+  return len;
+}
+
 /**
  * @brief	This Socket function initialize the channel in perticular mode, and set the port and wait for W5100 done it.
  * @return 	1 for success else 0.
@@ -35,6 +83,7 @@ uint8_t socket(SOCKET s, uint8_t protocol, uint16_t port, uint8_t flag)
  */
 void close(SOCKET s)
 {
+  rx_cache[s].len = 0;
   W5100.execCmdSn(s, Sock_CLOSE);
   W5100.writeSnIR(s, 0xFF);
 }
@@ -145,6 +194,10 @@ uint16_t send(SOCKET s, const uint8_t * buf, uint16_t len)
  */
 int16_t recv(SOCKET s, uint8_t *buf, int16_t len)
 {
+  // Whatever is cached comes first, without asking the chip
+  if (rx_cache[s].len > 0)
+    return rx_take(s, buf, len);
+
   // Check how much data is available
   int16_t ret = W5100.getRXReceivedSize(s);
   if ( ret == 0 )
@@ -162,13 +215,16 @@ int16_t recv(SOCKET s, uint8_t *buf, int16_t len)
       ret = -1;
     }
   }
-  else if (ret > len)
+  else if (len < SOCK_RX_CACHE)
   {
-    ret = len;
+    // A short read takes what fits in the cache, for the next ones to use
+    rx_fill(s, ret);
+    ret = rx_take(s, buf, len);
   }
-
-  if ( ret > 0 )
+  else
   {
+    if (ret > len)
+      ret = len;
     W5100.recv_data_processing(s, buf, ret);
     W5100.execCmdSn(s, Sock_RECV);
   }
@@ -176,6 +232,15 @@ int16_t recv(SOCKET s, uint8_t *buf, int16_t len)
 }
 
 
+/**
+ * @brief	Returns the number of bytes recv() can return: those cached and those still on the chip
+ */
+uint16_t recvAvailable(SOCKET s)
+{
+  return rx_cache[s].len + W5100.getRXReceivedSize(s);
+}
+
+
 /**
  * @brief	Returns the first byte in the receive queue (no checking)
  * 		
@@ -183,8 +248,12 @@ int16_t recv(SOCKET s, uint8_t *buf, int16_t len)
  */
 uint16_t peek(SOCKET s, uint8_t *buf)
 {
-  W5100.recv_data_processing(s, buf, 1, 1);
-
+  if (rx_cache[s].len == 0 && rx_fill(s, W5100.getRXReceivedSize(s)) == 0)
+  {
+    W5100.recv_data_processing(s, buf, 1, 1);
+    return 1;
+  }
+  *buf = rx_cache[s].data[rx_cache[s].head];
   return 1;
 }
 
@@ -16,6 +16,10 @@
 // W5100 controller instance
 W5100Class W5100;
 
+#if !defined(__AVR__) && defined(pinDataWrite)
+PinHandle W5100Class::ss;
+#endif
+
 #define TX_RX_MAX_BUF_SIZE 2048
 #define TX_BUF 0x1100
 #define RX_BUF (TX_BUF + TX_RX_MAX_BUF_SIZE)
@@ -112,7 +116,7 @@ void W5100Class::read_data(SOCKET s, volatile uint8_t *src, volatile uint8_t *ds
   uint16_t src_mask;
   uint16_t src_ptr;
 
-  src_mask = (uint16_t)src & RMASK;
+  src_mask = (uint16_t)(uintptr_t)src & RMASK;
   src_ptr = RBASE[s] + src_mask;
 
   if( (src_mask + len) > RSIZE ) 
@@ -138,8 +142,29 @@ uint8_t W5100Class::write(uint16_t _addr, uint8_t _data)
   return 1;
 }
 
+// The W5100 moves one byte per SPI frame of an opcode, the address and
+// the data, with the chip deselected between frames; unlike the W5200 and
+// W5500 it has no sequential mode that would stream a buffer after a
+// single header. The buffer loops therefore only keep the frames back to
+// back: where the SPI library can exchange a buffer the four bytes of a
+// frame go out as one burst through the FIFO, instead of four round trips.
 uint16_t W5100Class::write(uint16_t _addr, const uint8_t *_buf, uint16_t _len)
 {
+#ifdef SPI_HAS_TRANSFER_BUF
+  uint8_t frame[4];
+
+  for (uint16_t i=0; i<_len; i++)
+  {
+    frame[0] = 0xF0;
+    frame[1] = _addr >> 8;
+    frame[2] = _addr & 0xFF;
+    frame[3] = _buf[i];
+    setSS();
+    SPI.transfer(frame, 4);
+    resetSS();
+    _addr++;
+  }
+#else
   for (uint16_t i=0; i<_len; i++)
   {
     setSS();    
@@ -150,6 +175,7 @@ uint16_t W5100Class::write(uint16_t _addr, const uint8_t *_buf, uint16_t _len)
     SPI.transfer(_buf[i]);
     resetSS();
   }
+#endif
   return _len;
 }
 
@@ -166,6 +192,22 @@ uint8_t W5100Class::read(uint16_t _addr)
 
 uint16_t W5100Class::read(uint16_t _addr, uint8_t *_buf, uint16_t _len)
 {
+#ifdef SPI_HAS_TRANSFER_BUF
+  uint8_t frame[4];
+
+  for (uint16_t i=0; i<_len; i++)
+  {
+    frame[0] = 0x0F;
+    frame[1] = _addr >> 8;
+    frame[2] = _addr & 0xFF;
+    frame[3] = 0;
+    setSS();
+    SPI.transfer(frame, 4);
+    resetSS();
+    _buf[i] = frame[3];
+    _addr++;
+  }
+#else
   for (uint16_t i=0; i<_len; i++)
   {
     setSS();
@@ -176,6 +218,7 @@ uint16_t W5100Class::read(uint16_t _addr, uint8_t *_buf, uint16_t _len)
     _buf[i] = SPI.transfer(0);
     resetSS();
   }
+#endif
   return _len;
 }
 
@@ -15,6 +15,19 @@
 
 #define MAX_SOCK_NUM 4
 
+// Chip select for the cores that do not have the AVR's fixed one: the
+// variant's SS, or on the lm4f LaunchPads the FSS pin of the default SPI
+// module. Define W5100_SS to use another pin.
+#if !defined(W5100_SS) && !defined(__AVR__)
+#if defined(TARGET_IS_BLIZZARD_RB1)
+#define W5100_SS PB_5
+#elif defined(TARGET_IS_SNOWFLAKE_RA0)
+#define W5100_SS PD_2
+#else
+#define W5100_SS SS
+#endif
+#endif
+
 typedef uint8_t SOCKET;
 
 #define IDM_OR  0x8000
@@ -331,10 +344,20 @@ private:
   inline static void initSS()    { DDRB  |=  _BV(0); };
   inline static void setSS()     { PORTB &= ~_BV(0); };
   inline static void resetSS()   { PORTB |=  _BV(0); }; 
-#else
+#elif defined(__AVR__)
   inline static void initSS()    { DDRB  |=  _BV(2); };
   inline static void setSS()     { PORTB &= ~_BV(2); };
   inline static void resetSS()   { PORTB |=  _BV(2); };
+#elif defined(pinDataWrite)
+  // Cores with pin handles select the chip with a single store
+  static PinHandle ss;
+  inline static void initSS()    { pinMode(W5100_SS, OUTPUT); ss = pinHandle(W5100_SS); fastWrite(ss, HIGH); };
+  inline static void setSS()     { fastWrite(ss, LOW); };
+  inline static void resetSS()   { fastWrite(ss, HIGH); };
+#else
+  inline static void initSS()    { pinMode(W5100_SS, OUTPUT); digitalWrite(W5100_SS, HIGH); };
+  inline static void setSS()     { digitalWrite(W5100_SS, LOW); };
+  inline static void resetSS()   { digitalWrite(W5100_SS, HIGH); };
 #endif
 
 };
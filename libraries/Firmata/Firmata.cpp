@@ -26,20 +26,44 @@ extern "C" {
 //* Support Functions
 //******************************************************************************
 
+/* Output goes through reportBuffer, written out when a message is complete
+ * or, between startReport() and endReport(), when the report is. */
+void FirmataClass::put(byte c)
+{
+  if (reportLength == sizeof(reportBuffer))
+    flushReport();
+  reportBuffer[reportLength++] = c;
+}
+
+// a message is complete
+void FirmataClass::sent(void)
+{
+  if (!reporting)
+    flushReport();
+}
+
+void FirmataClass::flushReport(void)
+{
+  if (reportLength) {
+    FirmataSerial->write(reportBuffer, reportLength);
+    reportLength = 0;
+  }
+}
+
 void FirmataClass::sendValueAsTwo7bitBytes(int value)
 {
-  FirmataSerial->write(value & B01111111); // LSB
-  FirmataSerial->write(value >> 7 & B01111111); // MSB
+  put(value & B01111111); // LSB
+  put(value >> 7 & B01111111); // MSB
 }
 
 void FirmataClass::startSysex(void)
 {
-  FirmataSerial->write(START_SYSEX);
+  put(START_SYSEX);
 }
 
 void FirmataClass::endSysex(void)
 {
-  FirmataSerial->write(END_SYSEX);
+  put(END_SYSEX);
 }
 
 //******************************************************************************
@@ -50,6 +74,16 @@ FirmataClass::FirmataClass()
 {
   firmwareVersionCount = 0;
   firmwareVersionVector = 0;
+  reportLength = 0;
+  reporting = false;
+  currentAnalogCallback = NULL;
+  currentDigitalCallback = NULL;
+  currentReportAnalogCallback = NULL;
+  currentReportDigitalCallback = NULL;
+  currentPinModeCallback = NULL;
+  currentSystemResetCallback = NULL;
+  currentStringCallback = NULL;
+  currentSysexCallback = NULL;
   systemReset();
 }
 
@@ -85,9 +119,10 @@ void FirmataClass::begin(Stream &s)
 
 // output the protocol version message to the serial port
 void FirmataClass::printVersion(void) {
-  FirmataSerial->write(REPORT_VERSION);
-  FirmataSerial->write(FIRMATA_MAJOR_VERSION);
-  FirmataSerial->write(FIRMATA_MINOR_VERSION);
+  put(REPORT_VERSION);
+  put(FIRMATA_MAJOR_VERSION);
+  put(FIRMATA_MINOR_VERSION);
+  sent();
 }
 
 void FirmataClass::blinkVersion(void)
@@ -106,35 +141,36 @@ void FirmataClass::printFirmwareVersion(void)
 
   if(firmwareVersionCount) { // make sure that the name has been set before reporting
     startSysex();
-    FirmataSerial->write(REPORT_FIRMWARE);
-    FirmataSerial->write(firmwareVersionVector[0]); // major version number
-    FirmataSerial->write(firmwareVersionVector[1]); // minor version number
+    put(REPORT_FIRMWARE);
+    put(firmwareVersionVector[0]); // major version number
+    put(firmwareVersionVector[1]); // minor version number
     for(i=2; i<firmwareVersionCount; ++i) {
       sendValueAsTwo7bitBytes(firmwareVersionVector[i]);
     }
     endSysex();
+    sent();
   }
 }
 
 void FirmataClass::setFirmwareNameAndVersion(const char *name, byte major, byte minor)
 {
   const char *filename;
-  char *extension;
+  const char *extension;
 
   // parse out ".cpp" and "applet/" that comes from using __FILE__
   extension = strstr(name, ".cpp");
-  filename = strrchr(name, '/') + 1; //points to slash, +1 gets to start of filename
+  filename = strrchr(name, '/'); //points to slash, +1 gets to start of filename
+  filename = filename ? filename + 1 : name;
   // add two bytes for version numbers
-  if(extension && filename) {
+  if(extension && extension > filename) {
     firmwareVersionCount = extension - filename + 2;
   } else {
-    firmwareVersionCount = strlen(name) + 2;
-    filename = name;
+    firmwareVersionCount = strlen(filename) + 2;
   }
 
   free(firmwareVersionVector);
 
-  firmwareVersionVector = (byte *) malloc(firmwareVersionCount);
+  firmwareVersionVector = (byte *) malloc(firmwareVersionCount + 1);
   firmwareVersionVector[firmwareVersionCount] = 0;
   firmwareVersionVector[0] = major;
   firmwareVersionVector[1] = minor;
@@ -161,6 +197,25 @@ int FirmataClass::available(void)
 }
 
 
+// process everything the stream has, a chunk at a time and without a call
+// to available() for each byte; returns the number of bytes processed
+int FirmataClass::processAvailable(void)
+{
+  byte chunk[MAX_DATA_BYTES];
+  int total = 0;
+  int n;
+
+  while((n = FirmataSerial->available()) > 0) {
+    if(n > (int)sizeof(chunk))
+      n = sizeof(chunk);
+    for(int i = 0; i < n; i++)
+      chunk[i] = FirmataSerial->read();
+    processInput(chunk, n);
+    total += n;
+  }
+  return total;
+}
+
 void FirmataClass::processSysexMessage(void)
 {
   switch(storedInputData[0]) { //first byte in buffer is command
@@ -169,8 +224,9 @@ void FirmataClass::processSysexMessage(void)
     break;
   case STRING_DATA:
     if(currentStringCallback) {
+      // two bytes for each character
+      char buffer[MAX_DATA_BYTES / 2 + 1];
       byte bufferLength = (sysexBytesRead - 1) / 2;
-      char *buffer = (char*)malloc(bufferLength * sizeof(char));
       byte i = 1;
       byte j = 0;
       while(j < bufferLength) {
@@ -180,6 +236,7 @@ void FirmataClass::processSysexMessage(void)
         i++;
         j++;
       }
+      buffer[j] = 0;
       (*currentStringCallback)(buffer);
     }
     break;
@@ -189,89 +246,130 @@ void FirmataClass::processSysexMessage(void)
   }
 }
 
+// a message with all of its data bytes stored
+void FirmataClass::processMessage(void)
+{
+  switch(executeMultiByteCommand) {
+  case ANALOG_MESSAGE:
+    if(currentAnalogCallback) {
+      (*currentAnalogCallback)(multiByteChannel,
+                               (storedInputData[0] << 7)
+                               + storedInputData[1]);
+    }
+    break;
+  case DIGITAL_MESSAGE:
+    if(currentDigitalCallback) {
+      (*currentDigitalCallback)(multiByteChannel,
+                                (storedInputData[0] << 7)
+                                + storedInputData[1]);
+    }
+    break;
+  case SET_PIN_MODE:
+    if(currentPinModeCallback)
+      (*currentPinModeCallback)(storedInputData[1], storedInputData[0]);
+    break;
+  case REPORT_ANALOG:
+    if(currentReportAnalogCallback)
+      (*currentReportAnalogCallback)(multiByteChannel,storedInputData[0]);
+    break;
+  case REPORT_DIGITAL:
+    if(currentReportDigitalCallback)
+      (*currentReportDigitalCallback)(multiByteChannel,storedInputData[0]);
+    break;
+  }
+  executeMultiByteCommand = 0;
+}
+
+// data bytes after each command below 0xF0, by its top four bits
+static const byte channelDataBytes[8] = {
+  0, // 0x80
+  2, // DIGITAL_MESSAGE
+  0, // 0xA0
+  0, // 0xB0
+  1, // REPORT_ANALOG
+  1, // REPORT_DIGITAL
+  2, // ANALOG_MESSAGE
+  0  // 0xF0, not a channel command
+};
+
+// a byte of 0x80 or more outside a Sysex message
+void FirmataClass::processCommand(byte inputData)
+{
+  if(inputData < 0xF0) {
+    // remove channel info from command byte
+    byte command = inputData & 0xF0;
+    multiByteChannel = inputData & 0x0F;
+    waitForData = channelDataBytes[(command >> 4) & 0x07];
+    executeMultiByteCommand = waitForData ? command : 0;
+    return;
+  }
+  // commands in the 0xF* range don't use channel data
+  switch(inputData) {
+  case SET_PIN_MODE:
+    waitForData = 2; // two data bytes needed
+    executeMultiByteCommand = inputData;
+    break;
+  case START_SYSEX:
+    parsingSysex = true;
+    sysexOverflow = false;
+    sysexBytesRead = 0;
+    break;
+  case SYSTEM_RESET:
+    systemReset();
+    break;
+  case REPORT_VERSION:
+    printVersion();
+    break;
+  }
+}
+
 void FirmataClass::processInput(void)
 {
   int inputData = FirmataSerial->read(); // this is 'int' to handle -1 when no data
-  int command;
-    
-  // TODO make sure it handles -1 properly
-  
-  if (parsingSysex) {
-    if(inputData == END_SYSEX) {
-      //stop sysex byte      
+
+  if(inputData >= 0) {
+    byte b = inputData;
+    processInput(&b, 1);
+  }
+}
+
+// process bytes received; a message may be split anywhere between calls
+void FirmataClass::processInput(const byte *data, size_t length)
+{
+  const byte *end = data + length;
+
+  while(data != end) {
+    if(parsingSysex) {
+      // the data up to END_SYSEX at once, as much as storedInputData takes
+      const byte *stop = (const byte *)memchr(data, END_SYSEX, end - data);
+      size_t n = (stop ? stop : end) - data;
+
+      if(n > (size_t)(MAX_DATA_BYTES - sysexBytesRead)) {
+        n = MAX_DATA_BYTES - sysexBytesRead;
+        sysexOverflow = true;
+      }
+      memcpy(storedInputData + sysexBytesRead, data, n);
+      sysexBytesRead += n;
+      if(!stop)
+        break;
+      data = stop + 1;
       parsingSysex = false;
-      //fire off handler function
-      processSysexMessage();
-    } else {
-      //normal data byte - add to buffer
-      storedInputData[sysexBytesRead] = inputData;
-      sysexBytesRead++;
+      // a message too long for storedInputData is dropped
+      if(!sysexOverflow && sysexBytesRead > 0)
+        processSysexMessage();
+      continue;
     }
-  } else if( (waitForData > 0) && (inputData < 128) ) {  
-    waitForData--;
-    storedInputData[waitForData] = inputData;
-    if( (waitForData==0) && executeMultiByteCommand ) { // got the whole message
-      switch(executeMultiByteCommand) {
-      case ANALOG_MESSAGE:
-        if(currentAnalogCallback) {
-          (*currentAnalogCallback)(multiByteChannel,
-                                   (storedInputData[0] << 7)
-                                   + storedInputData[1]);
-        }
-        break;
-      case DIGITAL_MESSAGE:
-        if(currentDigitalCallback) {
-          (*currentDigitalCallback)(multiByteChannel,
-                                    (storedInputData[0] << 7)
-                                    + storedInputData[1]);
-        }
-        break;
-      case SET_PIN_MODE:
-        if(currentPinModeCallback)
-          (*currentPinModeCallback)(storedInputData[1], storedInputData[0]);
-        break;
-      case REPORT_ANALOG:
-        if(currentReportAnalogCallback)
-          (*currentReportAnalogCallback)(multiByteChannel,storedInputData[0]);
-        break;
-      case REPORT_DIGITAL:
-        if(currentReportDigitalCallback)
-          (*currentReportDigitalCallback)(multiByteChannel,storedInputData[0]);
-        break;
+    byte inputData = *data++;
+    if(inputData < 128) {
+      // data bytes without a command before them are ignored
+      if(waitForData > 0) {
+        waitForData--;
+        storedInputData[waitForData] = inputData;
+        if(waitForData == 0 && executeMultiByteCommand) // got the whole message
+          processMessage();
       }
-      executeMultiByteCommand = 0;
-    }	
-  } else {
-    // remove channel info from command byte if less than 0xF0
-    if(inputData < 0xF0) {
-      command = inputData & 0xF0;
-      multiByteChannel = inputData & 0x0F;
     } else {
-      command = inputData;
-      // commands in the 0xF* range don't use channel data
-    }
-    switch (command) {
-    case ANALOG_MESSAGE:
-    case DIGITAL_MESSAGE:
-    case SET_PIN_MODE:
-      waitForData = 2; // two data bytes needed
-      executeMultiByteCommand = command;
-      break;
-    case REPORT_ANALOG:
-    case REPORT_DIGITAL:
-      waitForData = 1; // two data bytes needed
-      executeMultiByteCommand = command;
-      break;
-    case START_SYSEX:
-      parsingSysex = true;
-      sysexBytesRead = 0;
-      break;
-    case SYSTEM_RESET:
-      systemReset();
-      break;
-    case REPORT_VERSION:
-      Firmata.printVersion();
-      break;
+      processCommand(inputData);
     }
   }
 }
@@ -283,8 +381,9 @@ void FirmataClass::processInput(void)
 void FirmataClass::sendAnalog(byte pin, int value) 
 {
   // pin can only be 0-15, so chop higher bits
-  FirmataSerial->write(ANALOG_MESSAGE | (pin & 0xF));
+  put(ANALOG_MESSAGE | (pin & 0xF));
   sendValueAsTwo7bitBytes(value);
+  sent();
 }
 
 // send a single digital pin in a digital message
@@ -314,9 +413,10 @@ void FirmataClass::sendDigital(byte pin, int value)
 // send an 8-bit port in a single digital message (protocol v2)
 void FirmataClass::sendDigitalPort(byte portNumber, int portData)
 {
-  FirmataSerial->write(DIGITAL_MESSAGE | (portNumber & 0xF));
-  FirmataSerial->write((byte)portData % 128); // Tx bits 0-6
-  FirmataSerial->write(portData >> 7);  // Tx bits 7-13
+  put(DIGITAL_MESSAGE | (portNumber & 0xF));
+  put((byte)portData % 128); // Tx bits 0-6
+  put(portData >> 7);  // Tx bits 7-13
+  sent();
 }
 
 
@@ -324,11 +424,12 @@ void FirmataClass::sendSysex(byte command, byte bytec, byte* bytev)
 {
   byte i;
   startSysex();
-  FirmataSerial->write(command);
+  put(command);
   for(i=0; i<bytec; i++) {
     sendValueAsTwo7bitBytes(bytev[i]);        
   }
   endSysex();
+  sent();
 }
 
 void FirmataClass::sendString(byte command, const char* string) 
@@ -346,7 +447,20 @@ void FirmataClass::sendString(const char* string)
 // expose the write method
 void FirmataClass::write(byte c)
 {
-  FirmataSerial->write(c);
+  put(c);
+  sent();
+}
+
+// collect the messages sent until endReport(), to be written together
+void FirmataClass::startReport(void)
+{
+  reporting = true;
+}
+
+void FirmataClass::endReport(void)
+{
+  reporting = false;
+  flushReport();
 }
 
 
@@ -432,6 +546,7 @@ void FirmataClass::systemReset(void)
   }
 
   parsingSysex = false;
+  sysexOverflow = false;
   sysexBytesRead = 0;
 
   if(currentSystemResetCallback)
@@ -23,7 +23,13 @@
 #define FIRMATA_MINOR_VERSION   3 // for backwards compatible changes
 #define FIRMATA_BUGFIX_VERSION  6 // for bugfix releases
 
-#define MAX_DATA_BYTES 32 // max number of data bytes in non-Sysex messages
+#define MAX_DATA_BYTES 32 // max number of data bytes in a message, Sysex included
+
+// bytes collected between startReport() and endReport() before a write
+#define FIRMATA_REPORT_BYTES 64
+#if FIRMATA_REPORT_BYTES > 255
+#error FIRMATA_REPORT_BYTES must fit the byte reportLength
+#endif
 
 // message command bytes (128-255/0x80-0xFF)
 #define DIGITAL_MESSAGE         0x90 // send data for a digital pin
@@ -102,6 +108,8 @@ public:
 /* serial receive handling */
     int available(void);
     void processInput(void);
+    void processInput(const byte *data, size_t length);
+    int processAvailable(void);
 /* serial send handling */
     void sendAnalog(byte pin, int value);
     void sendDigital(byte pin, int value); // TODO implement this
@@ -110,6 +118,8 @@ public:
     void sendString(byte command, const char* string);
     void sendSysex(byte command, byte bytec, byte* bytev);
     void write(byte c);
+    void startReport(void);
+    void endReport(void);
 /* attach & detach callback functions to messages */
     void attach(byte command, callbackFunction newFunction);
     void attach(byte command, systemResetCallbackFunction newFunction);
@@ -129,7 +139,12 @@ private:
     byte storedInputData[MAX_DATA_BYTES]; // multi-byte data
 /* sysex */
     boolean parsingSysex;
+    boolean sysexOverflow; // too long for storedInputData, dropped at END_SYSEX
     int sysexBytesRead;
+/* output, one write per message or per report */
+    byte reportBuffer[FIRMATA_REPORT_BYTES];
+    byte reportLength;
+    boolean reporting;
 /* callback functions */
     callbackFunction currentAnalogCallback;
     callbackFunction currentDigitalCallback;
@@ -141,12 +156,17 @@ private:
     sysexCallbackFunction currentSysexCallback;
 
 /* private methods ------------------------------ */
+    void processCommand(byte command);
+    void processMessage(void);
     void processSysexMessage(void);
     void systemReset(void);
     void strobeBlinkPin(int count, int onInterval, int offInterval);
     void sendValueAsTwo7bitBytes(int value);
     void startSysex(void);
     void endSysex(void);
+    void put(byte c);
+    void sent(void);
+    void flushReport(void);
 };
 
 extern FirmataClass Firmata;
@@ -21,6 +21,7 @@
 //  Unchanged #include <OneMsTaskTimer.h>
 //
 
+#include <string.h>
 #include <Energia.h>
 #include "LCD_SharpBoosterPack_SPI.h"
 #include "SPI.h"
@@ -54,6 +55,25 @@ static const uint8_t P_DISP = 5;
 
 unsigned char DisplayBuffer[LCD_VERTICAL_MAX][LCD_HORIZONTAL_MAX/8];
 
+// Lines changed since the last flush(), a bit per line; flush() only
+// sends those
+static uint8_t DirtyLines[LCD_VERTICAL_MAX/8];
+#define SET_LINE_DIRTY(y)   (DirtyLines[(y) >> 3] |= 1 << ((y) & 7))
+#define IS_LINE_DIRTY(y)    (DirtyLines[(y) >> 3] & (1 << ((y) & 7)))
+
+// Line addresses as the display takes them, LSB first: line y is
+// reverse(y + 1)
+static const uint8_t lineAddress[LCD_VERTICAL_MAX] = {
+    0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30,
+    0xB0, 0x70, 0xF0, 0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8, 0x18,
+    0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8, 0x04, 0x84, 0x44, 0xC4, 0x24,
+    0xA4, 0x64, 0xE4, 0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4, 0x0C,
+    0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC, 0x1C, 0x9C, 0x5C, 0xDC, 0x3C,
+    0xBC, 0x7C, 0xFC, 0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2, 0x12,
+    0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2, 0x0A, 0x8A, 0x4A, 0xCA, 0x2A,
+    0xAA, 0x6A, 0xEA, 0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA, 0x06,
+};
+
 unsigned char VCOMbit = 0x40;
 #define SHARP_VCOM_TOGGLE_BIT               0x40
 
@@ -110,6 +130,7 @@ void LCD_SharpBoosterPack_SPI::reverseFlush()
             DisplayBuffer[i][j] = 0xff ^ DisplayBuffer[i][j];
         }
     }
+    memset(DirtyLines, 0xff, sizeof(DirtyLines));
     flush();
 }
 
@@ -141,10 +162,21 @@ void LCD_SharpBoosterPack_SPI::setXY(uint8_t x, uint8_t y, uint8_t  ulValue)
             break;
     }
 
+    // off the screen, as text running past the bottom is
+    if ((x0 >= LCD_HORIZONTAL_MAX) || (y0 >= LCD_VERTICAL_MAX)) return;
+
     if (_reverse) ulValue = (ulValue == 0);
-    
-    if (ulValue != 0)   DisplayBuffer[y0][x0>>3] &= ~(0x80 >> (x0 & 0x7));
-    else                DisplayBuffer[y0][x0>>3] |=  (0x80 >> (x0 & 0x7));
+
+    uint8_t ucData = DisplayBuffer[y0][x0>>3];
+    if (ulValue != 0)   ucData &= ~(0x80 >> (x0 & 0x7));
+    else                ucData |=  (0x80 >> (x0 & 0x7));
+
+    // only a pixel that changes makes its line dirty
+    if (ucData != DisplayBuffer[y0][x0>>3])
+    {
+        DisplayBuffer[y0][x0>>3] = ucData;
+        SET_LINE_DIRTY(y0);
+    }
 }
 
 void LCD_SharpBoosterPack_SPI::begin() {
@@ -201,13 +233,21 @@ void LCD_SharpBoosterPack_SPI::clear() {
   SendToggleVCOMCommand(); // send toggle if required
 
   clearBuffer();
-  
+
+  // the screen is white now: only a reversed buffer differs from it
+  memset(DirtyLines, _reverse ? 0xff : 0x00, sizeof(DirtyLines));
 }
 
 void LCD_SharpBoosterPack_SPI::clearBuffer() {
+    uint8_t ucFill = _reverse ? 0x00 : 0xff;
+
     for (uint8_t i = 0; i< LCD_VERTICAL_MAX; i++)
         for (uint8_t j = 0; j< (LCD_HORIZONTAL_MAX>>3); j++)
-            DisplayBuffer[i][j] = _reverse ? 0x00 : 0xff;
+            if (DisplayBuffer[i][j] != ucFill)
+            {
+                DisplayBuffer[i][j] = ucFill;
+                SET_LINE_DIRTY(i);
+            }
 }
 
 void LCD_SharpBoosterPack_SPI::setFont(tNumOfFontsType font) {
@@ -300,6 +340,7 @@ size_t LCD_SharpBoosterPack_SPI::write(uint8_t c) {
 		}
 		textx += 1;  // spacing
 	}
+	return 1;
 }
 
 void LCD_SharpBoosterPack_SPI::setCharXY(uint8_t x, uint8_t y) {
@@ -338,51 +379,63 @@ void LCD_SharpBoosterPack_SPI::drawImage(const uint8_t * image, uint8_t x,uint8_
     }
 }
 
-const uint8_t referse_data[] = {0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
-uint8_t reverse(uint8_t x)
+//*****************************************************************************
+// flush
+// Send the lines changed since the last flush to the display, with one
+// multiple line write: the command, then the address, data and trailer of
+// each dirty line, and a last trailer. Nothing is sent when no line
+// changed, but the VCOM toggle each flush makes is.
+//
+//*****************************************************************************
+void LCD_SharpBoosterPack_SPI::flush (void)
 {
-  uint8_t b = 0;
-  
-  b  = referse_data[x & 0xF]<<4;
-  b |= referse_data[(x & 0xF0)>>4];
-  return b;
-}
+    uint8_t dirty = 0;
 
+    for (uint8_t i = 0; i < sizeof(DirtyLines); i++)
+        dirty |= DirtyLines[i];
 
-void LCD_SharpBoosterPack_SPI::flush (void)
-{
-    unsigned char *pucData = &DisplayBuffer[0][0];
-    long xi =0;
-    long xj = 0;
-    //image update mode(1X000000b)
-    unsigned char command = SHARP_LCD_CMD_WRITE_LINE;
-
-    // set flag to indicate command transmit is running
-    flagSendToggleVCOMCommand |= SHARP_SEND_COMMAND_RUNNING;
-    //COM inversion bit
-    command |= VCOMbit;
-    // Set P2.4 High for CS
-    digitalWrite(_pinChipSelect, HIGH);
-
-    SPI.transfer((char)command);
-    for(xj=0; xj<LCD_VERTICAL_MAX; xj++)
+    if (dirty)
     {
-        SPI.transfer((char)reverse(xj + 1));
+        //image update mode(1X000000b)
+        unsigned char command = SHARP_LCD_CMD_WRITE_LINE;
+
+        // set flag to indicate command transmit is running
+        flagSendToggleVCOMCommand |= SHARP_SEND_COMMAND_RUNNING;
+        //COM inversion bit
+        command |= VCOMbit;
+        // Set P2.4 High for CS
+        digitalWrite(_pinChipSelect, HIGH);
 
-        for(xi=0; xi<(LCD_HORIZONTAL_MAX>>3); xi++)
+        SPI.transfer((char)command);
+        for (uint8_t y = 0; y < LCD_VERTICAL_MAX; y++)
         {
-            SPI.transfer((char)*(pucData++));
+            if (!IS_LINE_DIRTY(y)) continue;
+
+#ifdef SPI_HAS_TRANSFER_BUF
+            // address, data and trailer, as one transfer
+            uint8_t frame[(LCD_HORIZONTAL_MAX>>3) + 2];
+
+            frame[0] = lineAddress[y];
+            memcpy(frame + 1, DisplayBuffer[y], LCD_HORIZONTAL_MAX>>3);
+            frame[sizeof(frame) - 1] = SHARP_LCD_TRAILER_BYTE;
+            SPI.transfer(frame, sizeof(frame));
+#else
+            SPI.transfer((char)lineAddress[y]);
+            for (uint8_t x = 0; x < (LCD_HORIZONTAL_MAX>>3); x++)
+                SPI.transfer((char)DisplayBuffer[y][x]);
+            SPI.transfer((char)SHARP_LCD_TRAILER_BYTE);
+#endif
         }
-        SPI.transfer(SHARP_LCD_TRAILER_BYTE);
-    }
 
-    SPI.transfer((char)SHARP_LCD_TRAILER_BYTE);
-	delayMicroseconds(10);
+        SPI.transfer((char)SHARP_LCD_TRAILER_BYTE);
+        delayMicroseconds(10);
 
-    // Set P2.4 Low for CS
-    digitalWrite(_pinChipSelect, LOW);
-    // clear flag to indicate command transmit is free
-    flagSendToggleVCOMCommand &= ~SHARP_SEND_COMMAND_RUNNING;  
+        // Set P2.4 Low for CS
+        digitalWrite(_pinChipSelect, LOW);
+        memset(DirtyLines, 0, sizeof(DirtyLines));
+        // clear flag to indicate command transmit is free
+        flagSendToggleVCOMCommand &= ~SHARP_SEND_COMMAND_RUNNING;
+    }
     SendToggleVCOMCommand(); // send toggle if required
 }
 
@@ -121,7 +121,13 @@ public:
     void text(uint8_t x, uint8_t y, String s);
     void text(uint8_t x, uint8_t y, String s, tLCDWrapType wrap);
     void text(uint8_t x, uint8_t y, uint8_t c) ;
+
+    ///
+    /// @brief	Display the buffer
+    /// @note   Only the lines changed since the last flush are sent.
+    ///
     void flush();
+
     void setCharXY(uint8_t x, uint8_t y);
     void drawImage(const uint8_t * image, uint8_t x,uint8_t y);
 
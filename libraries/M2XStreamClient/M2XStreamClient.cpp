@@ -36,6 +36,83 @@ M2XStreamClient::M2XStreamClient(Client* client,
 int M2XStreamClient::listStreamValues(const char* deviceId, const char* streamName,
                                       const char* query,
                                       aJsonObject **out) {
+  int status = requestStreamValues(deviceId, streamName, query);
+  if (status == 200) {
+    parseJsonBody(out);
+  }
+
+  if (status != E_NOCONNECTION) {
+    close();
+  }
+  return status;
+}
+
+// State of listStreamValues between parser events: the data point
+// being read so far
+struct stream_value_reader {
+  stream_value_read_callback callback;
+  void* context;
+  int index;
+  char at[32];
+  aJsonObject value;
+  char text[aJson_TEXT_SIZE];
+};
+
+static void read_stream_value(aJsonPullParser* parser, int event,
+                              void* context) {
+  stream_value_reader* reader = (stream_value_reader*) context;
+
+  if (event == aJson_StartObject && parser->matches("values[*]")) {
+    reader->at[0] = '\0';
+    reader->value.type = aJson_NULL;
+  } else if (event == aJson_Value &&
+             parser->matches("values[*].timestamp")) {
+    aJsonObject* at = parser->value();
+    if (at->type == aJson_String) {
+      strncpy(reader->at, at->valuestring, sizeof(reader->at) - 1);
+      reader->at[sizeof(reader->at) - 1] = '\0';
+    }
+  } else if (event == aJson_Value && parser->matches("values[*].value")) {
+    reader->value = *parser->value();
+    if (reader->value.type == aJson_String) {
+      strcpy(reader->text, reader->value.valuestring);
+      reader->value.valuestring = reader->text;
+    }
+  } else if (event == aJson_EndObject && parser->matches("values[*]")) {
+    reader->callback(reader->at, &reader->value, reader->index++,
+                     reader->context);
+  }
+}
+
+int M2XStreamClient::listStreamValues(const char* deviceId, const char* streamName,
+                                      stream_value_read_callback callback,
+                                      void* context, const char* query) {
+  int status = requestStreamValues(deviceId, streamName, query);
+  int err = (status == 200) ? skipHttpHeader() : E_OK;
+  if (err != E_OK) {
+    status = err;
+  } else if (status == 200) {
+    stream_value_reader reader;
+    memset(&reader, 0, sizeof(reader));
+    reader.callback = callback;
+    reader.context = context;
+
+    aJsonStream stream(_client);
+    aJsonPullParser parser(&stream);
+    if (parser.parse(read_stream_value, &reader) != aJson_End) {
+      status = E_JSON_INVALID;
+    }
+  }
+
+  if (status != E_NOCONNECTION) {
+    close();
+  }
+  return status;
+}
+
+int M2XStreamClient::requestStreamValues(const char* deviceId,
+                                         const char* streamName,
+                                         const char* query) {
   if (_client->connect(_host, _port)) {
     DBGLN("%s", "Connected to M2X server!");
     _client->print("GET /v2/devices/");
@@ -57,13 +134,7 @@ int M2XStreamClient::listStreamValues(const char* deviceId, const char* streamNa
     DBGLN("%s", "ERROR: Cannot connect to M2X server!");
     return E_NOCONNECTION;
   }
-  int status = readStatusCode(false);
-  if (status == 200) {
-    parseJsonBody(out);
-  }
-
-  close();
-  return status;
+  return readStatusCode(false);
 }
 
 int M2XStreamClient::readLocation(const char* deviceId, aJsonObject **out) {
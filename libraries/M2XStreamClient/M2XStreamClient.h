@@ -52,6 +52,15 @@ static const int E_NOTREACHABLE = -3;
 static const int E_INVALID = -4;
 static const int E_JSON_INVALID = -5;
 
+// Called by listStreamValues for each data point: its timestamp, its
+// value (an aJson_Int, aJson_Float or aJson_String item), its index in
+// the list and the context passed to listStreamValues. Neither pointer
+// is valid after the callback returns.
+typedef void (*stream_value_read_callback)(const char* at,
+                                           aJsonObject* value,
+                                           int index,
+                                           void* context);
+
 class M2XStreamClient {
 public:
   static const char* kDefaultM2XHost;
@@ -91,6 +100,14 @@ public:
                         const char* names[], const int counts[],
                         const char* ats[], T values[]);
 
+  // Fetch values for a particular data stream as one aJson tree, which
+  // the caller deletes with aJson.deleteItem(). The whole response has
+  // to fit in memory. The HTTP status code will be returned, and the
+  // content is only parsed when the status code is 200.
+  int listStreamValues(const char* deviceId, const char* streamName,
+                       const char* query,
+                       aJsonObject **out);
+
   // Fetch values for a particular data stream. Since memory is
   // very limited on a board, we cannot parse and get all the
   // data points in memory. Instead, we use callbacks here: whenever
@@ -102,10 +119,11 @@ public:
   // each time we get a data point.
   // For each data point, the callback will be called once. The HTTP
   // status code will be returned. And the content is only parsed when
-  // the status code is 200.
+  // the status code is 200; E_JSON_INVALID is returned if it turns out
+  // to be malformed.
   int listStreamValues(const char* deviceId, const char* streamName,
-                       const char* query,
-                       aJsonObject **out);
+                       stream_value_read_callback callback, void* context,
+                       const char* query = NULL);
 
   // Update datasource location
   // NOTE: On an Arduino Uno and other ATMEGA based boards, double has
@@ -154,6 +172,10 @@ private:
   int _port;
   NullPrint _null_print;
 
+  // Sends the request for a stream's values and returns the HTTP
+  // status code, leaving the connection open
+  int requestStreamValues(const char* deviceId, const char* streamName,
+                          const char* query);
   // Writes the HTTP header part for updating a stream value
   void writePutHeader(const char* deviceId,
                       const char* streamName,
@@ -19,6 +19,7 @@
 
 #include "FP.h"
 #include "MQTTPacket.h"
+#include "TopicTrie.h"
 #include "stdio.h"
 #include "MQTTLogging.h"
 
@@ -28,6 +29,10 @@
 #if !defined(MQTTCLIENT_QOS2)
     #define MQTTCLIENT_QOS2 0
 #endif
+// topic levels per subscription to allow room for: a trie node each, shared prefixes counted once
+#if !defined(MQTTCLIENT_TOPIC_LEVELS)
+    #define MQTTCLIENT_TOPIC_LEVELS 4
+#endif
 
 namespace MQTT
 {
@@ -154,7 +159,8 @@ public:
     int publish(const char* topicName, void* payload, size_t payloadlen, unsigned short& id, enum QoS qos = QOS1, bool retained = false);
 
     /** MQTT Subscribe - send an MQTT subscribe packet and wait for the suback
-     *  @param topicFilter - a topic pattern which can include wildcards
+     *  @param topicFilter - a topic pattern which can include wildcards; it is not copied, so must stay valid
+     *      until it is unsubscribed
      *  @param qos - the MQTT QoS to subscribe at
      *  @param mh - the callback function to be invoked when a message is received for this subscription
      *  @return success code -
@@ -199,7 +205,6 @@ private:
     int readPacket(Timer& timer);
     int sendPacket(int length, Timer& timer);
     int deliverMessage(MQTTString& topicName, Message& message);
-    bool isTopicMatched(char* topicFilter, MQTTString& topicName);
 
     Network& ipstack;
     unsigned long command_timeout_ms;
@@ -214,11 +219,8 @@ private:
 
     PacketId packetid;
 
-    struct MessageHandlers
-    {
-        const char* topicFilter;
-        FP<void, MessageData&> fp;
-    } messageHandlers[MAX_MESSAGE_HANDLERS];      // Message handlers are indexed by subscription topic
+    FP<void, MessageData&> messageHandlers[MAX_MESSAGE_HANDLERS];      // Message handlers are indexed by trie slot
+    TopicTrie<MAX_MESSAGE_HANDLERS, MAX_MESSAGE_HANDLERS * MQTTCLIENT_TOPIC_LEVELS + 1> topicFilters;
 
     FP<void, MessageData&> defaultMessageHandler;
 
@@ -252,8 +254,6 @@ MQTT::Client<Network, Timer, a, MAX_MESSAGE_HANDLERS>::Client(Network& network,
     last_sent = Timer();
     last_received = Timer();
     ping_outstanding = false;
-    for (int i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
-        messageHandlers[i].topicFilter = 0;
     this->command_timeout_ms = command_timeout_ms;
     isconnected = false;
 
@@ -397,56 +397,21 @@ exit:
 }
 
 
-// assume topic filter and name is in correct format
-// # can only be at end
-// + and # can only be next to separator
-template<class Network, class Timer, int a, int b>
-bool MQTT::Client<Network, Timer, a, b>::isTopicMatched(char* topicFilter, MQTTString& topicName)
-{
-    char* curf = topicFilter;
-    char* curn = topicName.lenstring.data;
-    char* curn_end = curn + topicName.lenstring.len;
-
-    while (*curf && curn < curn_end)
-    {
-        if (*curn == '/' && *curf != '/')
-            break;
-        if (*curf != '+' && *curf != '#' && *curf != *curn)
-            break;
-        if (*curf == '+')
-        {   // skip until we meet the next separator, or end of string
-            char* nextpos = curn + 1;
-            while (nextpos < curn_end && *nextpos != '/')
-                nextpos = ++curn + 1;
-        }
-        else if (*curf == '#')
-            curn = curn_end - 1;    // skip until end of string
-        curf++;
-        curn++;
-    };
-
-    return (curn == curn_end) && (*curf == '\0');
-}
-
-
-
 template<class Network, class Timer, int a, int MAX_MESSAGE_HANDLERS>
 int MQTT::Client<Network, Timer, a, MAX_MESSAGE_HANDLERS>::deliverMessage(MQTTString& topicName, Message& message)
 {
     int rc = FAILURE;
+    short matched[MAX_MESSAGE_HANDLERS];
 
-    // we have to find the right message handler - indexed by topic
-    for (int i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
+    // one walk down the topic levels finds every subscription that matches
+    int count = topicFilters.match(topicName, matched);
+    for (int i = 0; i < count; ++i)
     {
-        if (messageHandlers[i].topicFilter != 0 && (MQTTPacket_equals(&topicName, (char*)messageHandlers[i].topicFilter) ||
-                isTopicMatched((char*)messageHandlers[i].topicFilter, topicName)))
+        if (messageHandlers[matched[i]].attached())
         {
-            if (messageHandlers[i].fp.attached())
-            {
-                MessageData md(topicName, message);
-                messageHandlers[i].fp(md);
-                rc = SUCCESS;
-            }
+            MessageData md(topicName, message);
+            messageHandlers[matched[i]](md);
+            rc = SUCCESS;
         }
     }
 
@@ -701,15 +666,11 @@ int MQTT::Client<Network, Timer, MAX_MQTT_PACKET_SIZE, MAX_MESSAGE_HANDLERS>::su
             rc = grantedQoS; // 0, 1, 2 or 0x80
         if (rc != 0x80)
         {
-            for (int i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
+            int slot = topicFilters.add(topicFilter);
+            if (slot >= 0)
             {
-                if (messageHandlers[i].topicFilter == 0)
-                {
-                    messageHandlers[i].topicFilter = topicFilter;
-                    messageHandlers[i].fp.attach(messageHandler);
-                    rc = 0;
-                    break;
-                }
+                messageHandlers[slot].attach(messageHandler);
+                rc = 0;
             }
         }
     }
@@ -743,7 +704,12 @@ int MQTT::Client<Network, Timer, MAX_MQTT_PACKET_SIZE, MAX_MESSAGE_HANDLERS>::un
     {
         unsigned short mypacketid;  // should be the same as the packetid above
         if (MQTTDeserialize_unsuback(&mypacketid, readbuf, MAX_MQTT_PACKET_SIZE) == 1)
+        {
+            int slot = topicFilters.remove(topicFilter);
+            if (slot >= 0)
+                messageHandlers[slot].detach();
             rc = 0;
+        }
     }
     else
         rc = FAILURE;
@@ -0,0 +1,382 @@
+/*******************************************************************************
+ * Copyright (c) 2014 IBM Corp.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ *   http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Ian Craggs - initial API and implementation and/or initial documentation
+ *******************************************************************************/
+
+#if !defined(TOPICTRIE_H)
+#define TOPICTRIE_H
+
+#include <string.h>
+#include "MQTTPacket.h"
+
+namespace MQTT
+{
+
+
+/**
+ * @class TopicTrie
+ * @brief the subscribed topic filters, one trie node per topic level
+ *
+ * Finding the filters a topic matches is a single walk down the levels of the topic, whatever the number of
+ * filters. Nodes point into the filter strings rather than copying them, so a filter must stay valid for as
+ * long as it is in the trie - as MQTT::Client::subscribe already requires.
+ * @param MAX_FILTERS the number of filters, each known by its slot number 0 .. MAX_FILTERS - 1
+ * @param MAX_NODES the number of distinct filter levels, shared prefixes counted once
+ */
+template<int MAX_FILTERS, int MAX_NODES>
+class TopicTrie
+{
+
+public:
+
+    TopicTrie()
+    {
+        for (int i = 0; i < MAX_FILTERS; ++i)
+            filters[i] = 0;
+        for (int i = 0; i < MAX_NODES; ++i)
+            nodes[i].level = 0;
+        freeNodes = MAX_NODES - 1;
+        initNode(0, "", 0); // the root, above the first level
+    }
+
+    /** Add a topic filter
+     *  @param filter - a topic filter, which can include wildcards
+     *  @return the slot number of the filter, or -1 if there is no room for it
+     */
+    int add(const char* filter);
+
+    /** Remove a topic filter added before
+     *  @param filter - the same text as was added
+     *  @return the slot number the filter had, or -1 if it was not found; a filter added more than once
+     *      is removed once per call
+     */
+    int remove(const char* filter);
+
+    /** Find the filters a topic name matches
+     *  @param topicName - the topic of a received message
+     *  @param slots - filled in with the slot numbers of the filters matched, MAX_FILTERS at most
+     *  @return the number of filters matched
+     */
+    int match(MQTTString& topicName, short* slots);
+
+    /** The filter in a slot, 0 if the slot is free
+     */
+    const char* filter(int slot)
+    {
+        return filters[slot];
+    }
+
+private:
+
+    struct Node
+    {
+        const char* level;  // in the filter that added the node, 0 if the node is free
+        unsigned short len;
+        short next;         // the next child of the same parent
+        short child;        // the first child for a level of its own
+        short plus;         // the child for +
+        short exact;        // filters that end here ...
+        short all;          // ... and those that end in # here, chained through nextFilter
+    };
+
+    void initNode(short n, const char* level, int len);
+    short newNode(const char* level, int len);
+    short findChild(short n, const char* level, int len);
+    int removeFrom(short n, const char* level, const char* filter);
+    int takeFilter(short* chain, const char* filter);
+    const char* findLevel(const char* level, int len);
+    void collect(short chain, short* slots, int& count);
+    void walk(short n, const char* level, const char* end, short* slots, int& count);
+
+    static const char* levelEnd(const char* level)
+    {
+        while (*level && *level != '/')
+            ++level;
+        return level;
+    }
+
+    Node nodes[MAX_NODES];
+    short freeNodes;
+    const char* filters[MAX_FILTERS];
+    short nextFilter[MAX_FILTERS];
+
+};
+
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+void MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::initNode(short n, const char* level, int len)
+{
+    nodes[n].level = level;
+    nodes[n].len = len;
+    nodes[n].next = nodes[n].child = nodes[n].plus = -1;
+    nodes[n].exact = nodes[n].all = -1;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+short MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::newNode(const char* level, int len)
+{
+    for (short n = 1; n < MAX_NODES; ++n)
+    {
+        if (nodes[n].level == 0)
+        {
+            initNode(n, level, len);
+            --freeNodes;
+            return n;
+        }
+    }
+    return -1;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+short MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::findChild(short n, const char* level, int len)
+{
+    if (len == 1 && *level == '+')
+        return nodes[n].plus;
+    for (short c = nodes[n].child; c >= 0; c = nodes[c].next)
+    {
+        if (nodes[c].len == len && memcmp(nodes[c].level, level, len) == 0)
+            return c;
+    }
+    return -1;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+int MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::add(const char* filter)
+{
+    int slot = -1;
+    for (int i = 0; i < MAX_FILTERS; ++i)
+    {
+        if (filters[i] == 0)
+        {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0)
+        return -1;
+
+    // count the levels the trie does not have yet, so that a filter is either added whole or not at all
+    short n = 0;
+    int missing = 0;
+    for (const char* level = filter; ; level++)
+    {
+        const char* end = levelEnd(level);
+        if (end - level == 1 && *level == '#')
+            break;
+        if (n >= 0)
+            n = findChild(n, level, end - level);
+        if (n < 0)
+            ++missing;
+        if (*end == '\0')
+            break;
+        level = end;
+    }
+    if (missing > freeNodes)
+        return -1;
+
+    short* chain;
+    n = 0;
+    for (const char* level = filter; ; level++)
+    {
+        const char* end = levelEnd(level);
+        int len = end - level;
+        if (len == 1 && *level == '#')
+        {
+            chain = &nodes[n].all; // anything after # is ignored
+            break;
+        }
+        short c = findChild(n, level, len);
+        if (c < 0)
+        {
+            c = newNode(level, len);
+            if (len == 1 && *level == '+')
+                nodes[n].plus = c;
+            else
+            {
+                nodes[c].next = nodes[n].child;
+                nodes[n].child = c;
+            }
+        }
+        n = c;
+        if (*end == '\0')
+        {
+            chain = &nodes[n].exact;
+            break;
+        }
+        level = end;
+    }
+
+    // at the end of the chain, so that matches come in the order filters were added
+    while (*chain >= 0)
+        chain = &nextFilter[*chain];
+    *chain = slot;
+    nextFilter[slot] = -1;
+    filters[slot] = filter;
+    return slot;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+int MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::takeFilter(short* chain, const char* filter)
+{
+    for (; *chain >= 0; chain = &nextFilter[*chain])
+    {
+        int slot = *chain;
+        if (strcmp(filters[slot], filter) == 0)
+        {
+            *chain = nextFilter[slot];
+            return slot;
+        }
+    }
+    return -1;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+int MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::removeFrom(short n, const char* level, const char* filter)
+{
+    const char* end = levelEnd(level);
+    int len = end - level;
+    if (len == 1 && *level == '#')
+        return takeFilter(&nodes[n].all, filter);
+
+    short c = findChild(n, level, len);
+    if (c < 0)
+        return -1;
+    int slot = (*end == '\0') ? takeFilter(&nodes[c].exact, filter) : removeFrom(c, end + 1, filter);
+
+    // drop a node nothing is left below
+    Node& child = nodes[c];
+    if (slot >= 0 && child.child < 0 && child.plus < 0 && child.exact < 0 && child.all < 0)
+    {
+        if (nodes[n].plus == c)
+            nodes[n].plus = -1;
+        else
+        {
+            short* link = &nodes[n].child;
+            while (*link != c)
+                link = &nodes[*link].next;
+            *link = child.next;
+        }
+        child.level = 0;
+        ++freeNodes;
+    }
+    return slot;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+int MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::remove(const char* filter)
+{
+    int slot = removeFrom(0, filter, filter);
+    if (slot < 0)
+        return -1;
+    const char* gone = filters[slot];
+    const char* goneEnd = gone + strlen(gone);
+    filters[slot] = 0;
+
+    // the filter's owner may free it now: levels other filters share must point into one of those
+    for (short n = 1; n < MAX_NODES; ++n)
+    {
+        if (nodes[n].level >= gone && nodes[n].level <= goneEnd)
+            nodes[n].level = findLevel(nodes[n].level, nodes[n].len);
+    }
+    return slot;
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+const char* MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::findLevel(const char* level, int len)
+{
+    for (int i = 0; i < MAX_FILTERS; ++i)
+    {
+        for (const char* l = filters[i]; l; l++)
+        {
+            const char* end = levelEnd(l);
+            if (end - l == len && memcmp(l, level, len) == 0)
+                return l;
+            if (*end == '\0')
+                break;
+            l = end;
+        }
+    }
+    return level; // not reached: a node is only kept while a filter goes through it
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+void MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::collect(short chain, short* slots, int& count)
+{
+    for (; chain >= 0; chain = nextFilter[chain])
+        slots[count++] = chain;
+}
+
+
+// level is where the next topic level starts, or end + 1 when there are no more
+template<int MAX_FILTERS, int MAX_NODES>
+void MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::walk(short n, const char* level, const char* end, short* slots, int& count)
+{
+    // wildcards at the first level do not match topics that start with $
+    bool wild = n != 0 || level >= end || *level != '$';
+
+    if (wild)
+        collect(nodes[n].all, slots, count); // # matches the parent level too
+    if (level > end)
+    {
+        collect(nodes[n].exact, slots, count);
+        return;
+    }
+
+    const char* next = level;
+    while (next < end && *next != '/')
+        ++next;
+    int len = next - level;
+    for (short c = nodes[n].child; c >= 0; c = nodes[c].next)
+    {
+        if (nodes[c].len == len && memcmp(nodes[c].level, level, len) == 0)
+        {
+            walk(c, next + 1, end, slots, count);
+            break;
+        }
+    }
+    if (wild && nodes[n].plus >= 0)
+        walk(nodes[n].plus, next + 1, end, slots, count);
+}
+
+
+template<int MAX_FILTERS, int MAX_NODES>
+int MQTT::TopicTrie<MAX_FILTERS, MAX_NODES>::match(MQTTString& topicName, short* slots)
+{
+    const char* topic = topicName.cstring;
+    int len;
+    if (topic)
+        len = strlen(topic);
+    else
+    {
+        topic = topicName.lenstring.data;
+        len = topicName.lenstring.len;
+    }
+
+    int count = 0;
+    walk(0, topic, topic + len, slots, count);
+    return count;
+}
+
+
+#endif
@@ -8,23 +8,54 @@
 #include <string.h>
 
 PubSubClient::PubSubClient(Client& client) {
-   this->_client = &client;
+   init(client);
 }
 
 PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, void (*callback)(char*,uint8_t*,unsigned int), Client& client) {
-   this->_client = &client;
+   init(client);
    this->callback = callback;
    this->ip = ip;
    this->port = port;
 }
 
 PubSubClient::PubSubClient(char* domain, uint16_t port, void (*callback)(char*,uint8_t*,unsigned int), Client& client) {
-   this->_client = &client;
+   init(client);
    this->callback = callback;
    this->domain = domain;
    this->port = port;
 }
 
+void PubSubClient::init(Client& client) {
+   this->_client = &client;
+   this->buffer = defaultBuffer;
+   this->bufferSize = MQTT_MAX_PACKET_SIZE;
+   this->callback = NULL;
+   this->chunkCallback = NULL;
+   this->ip = NULL;
+   this->domain = NULL;
+   this->port = 0;
+   this->nextMsgId = 1;
+   this->lastInActivity = this->lastOutActivity = 0;
+   this->pingOutstanding = false;
+   this->rxState = RX_HEADER;
+}
+
+// Use buf for packets in both directions instead of the built-in buffer.
+// Call it before connect(); NULL goes back to the built-in one.
+void PubSubClient::setBuffer(uint8_t* buf, uint16_t size) {
+   if (buf == NULL) {
+      buf = defaultBuffer;
+      size = MQTT_MAX_PACKET_SIZE;
+   }
+   this->buffer = buf;
+   this->bufferSize = size;
+}
+
+// Without a chunk callback a PUBLISH too big for the buffer is dropped
+void PubSubClient::setChunkCallback(MQTTChunkCallback chunkCallback) {
+   this->chunkCallback = chunkCallback;
+}
+
 boolean PubSubClient::connect(char *id) {
    return connect(id,NULL,NULL,0,0,0,0);
 }
@@ -49,6 +80,7 @@ boolean PubSubClient::connect(char *id, char *user, char *pass, char* willTopic,
       }
       if (result) {
          nextMsgId = 1;
+         rxState = RX_HEADER;
          uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p',MQTTPROTOCOLVERSION};
          // Leave room in the buffer for header and variable length field
          uint16_t length = 5;
@@ -93,19 +125,21 @@ boolean PubSubClient::connect(char *id, char *user, char *pass, char* willTopic,
          
          lastInActivity = lastOutActivity = millis();
          
-         while (!_client->available()) {
-            unsigned long t = millis();
-            if (t-lastInActivity > MQTT_KEEPALIVE*1000UL) {
-               _client->stop();
-               return false;
+         while (millis() - lastInActivity <= MQTT_KEEPALIVE*1000UL && _client->connected()) {
+            int budget = _client->available();
+            while (budget > 0) {
+               if (readPacket(budget) == MQTTCONNACK) {
+                  if (rxLength == 2 && buffer[1] == 0) {
+                     lastInActivity = millis();
+                     pingOutstanding = false;
+                     return true;
+                  }
+                  budget = -1;
+               }
+            }
+            if (budget < 0) {
+               break;
             }
-         }
-         uint16_t len = readPacket();
-         
-         if (len == 4 && buffer[3] == 0) {
-            lastInActivity = millis();
-            pingOutstanding = false;
-            return true;
          }
       }
       _client->stop();
@@ -113,79 +147,180 @@ boolean PubSubClient::connect(char *id, char *user, char *pass, char* willTopic,
    return false;
 }
 
-uint8_t PubSubClient::readByte() {
-   while(!_client->available()) {
-      Serial.println(".");
+// Takes the packet coming in as far as the budget of bytes the client
+// already has allows, reading as many at a time as it can and never waiting
+// for more. Returns the type of a packet that is now complete in the buffer,
+// its remaining length in rxLength, or 0. An oversized PUBLISH goes to
+// chunkCallback a bufferful at a time and any other oversized packet is
+// read and dropped.
+uint8_t PubSubClient::readPacket(int& budget) {
+   while (budget > 0) {
+      if (rxState == RX_HEADER || rxState == RX_LENGTH) {
+         int c = _client->read();
+         if (c < 0) {
+            budget = 0;
+            return 0;
+         }
+         budget--;
+         if (rxState == RX_HEADER) {
+            rxHeader = c;
+            rxLength = 0;
+            rxShift = 0;
+            rxState = RX_LENGTH;
+            continue;
+         }
+         rxLength |= (uint32_t)(c & 127) << rxShift;
+         rxShift += 7;
+         if (c & 128) {
+            if (rxShift == 28) {
+               // More than four length bytes: the stream can't be trusted
+               _client->stop();
+               rxState = RX_HEADER;
+               budget = 0;
+               return 0;
+            }
+            continue;
+         }
+         rxPos = 0;
+         rxRemaining = rxLength;
+         if (rxLength <= bufferSize) {
+            rxState = RX_BODY;
+         } else if ((rxHeader & 0xF0) == MQTTPUBLISH && chunkCallback) {
+            rxState = RX_TOPIC;
+            rxNeed = 2;
+         } else {
+            rxState = RX_SKIP;
+         }
+         if (rxRemaining == 0) {
+            rxState = RX_HEADER;
+            return rxHeader & 0xF0;
+         }
+         continue;
+      }
+
+      uint8_t* dst = buffer + rxPos;
+      uint32_t want = rxRemaining;
+      if (rxState == RX_TOPIC) {
+         want = rxNeed - rxPos;
+      } else if (rxState == RX_PAYLOAD && want > (uint32_t)(bufferSize - rxPos)) {
+         want = bufferSize - rxPos;
+      } else if (rxState == RX_SKIP) {
+         dst = buffer;
+         if (want > bufferSize) {
+            want = bufferSize;
+         }
+      }
+      if (want > (uint32_t)budget) {
+         want = budget;
+      }
+      int got = _client->read(dst, want);
+      if (got <= 0) {
+         budget = 0;
+         return 0;
+      }
+      budget -= got;
+      rxRemaining -= got;
+      if (rxState != RX_SKIP) {
+         rxPos += got;
+      }
+
+      if (rxState == RX_BODY) {
+         if (rxRemaining == 0) {
+            rxState = RX_HEADER;
+            return rxHeader & 0xF0;
+         }
+      } else if (rxState == RX_TOPIC) {
+         if (rxPos < rxNeed) {
+            continue;
+         }
+         if (rxNeed == 2) {
+            // The topic, and the message id above QoS 0, come before the payload
+            uint32_t need = 2 + (buffer[0]<<8) + buffer[1];
+            if (rxHeader & 0x06) {
+               need += 2;
+            }
+            // Room for the topic's terminator and some payload is needed too
+            if (need + 2 > bufferSize || need >= rxLength) {
+               rxState = RX_SKIP;
+            } else {
+               rxNeed = need;
+            }
+         } else {
+            rxPos = rxNeed = topicInPlace() + 1;
+            rxOffset = 0;
+            rxState = RX_PAYLOAD;
+         }
+      } else if (rxState == RX_PAYLOAD) {
+         if (rxPos == bufferSize || rxRemaining == 0) {
+            unsigned int len = rxPos - rxNeed;
+            // The piece is handed over, so a publish() from the callback
+            // has the buffer after the topic rather than no room at all
+            rxPos = rxNeed;
+            chunkCallback((char*)buffer, buffer+rxNeed, len, rxOffset, rxOffset+len+rxRemaining);
+            rxOffset += len;
+            if (rxRemaining == 0) {
+               rxState = RX_HEADER;
+            }
+         }
+      } else if (rxRemaining == 0) {
+         rxState = RX_HEADER;
+      }
    }
-   return _client->read();
+   return 0;
 }
 
-uint16_t PubSubClient::readPacket() {
-   uint16_t len = 0;
-   buffer[len++] = readByte();
-   uint8_t multiplier = 1;
-   uint16_t length = 0;
-   uint8_t digit = 0;
-   do {
-      digit = readByte();
-      buffer[len++] = digit;
-      length += (digit & 127) * multiplier;
-      multiplier *= 128;
-   } while ((digit & 128) != 0);
-   
-   for (uint16_t i = 0;i<length;i++)
-   {
-      if (len < MQTT_MAX_PACKET_SIZE) {
-         buffer[len++] = readByte();
-      } else {
-         readByte();
-         len = 0; // This will cause the packet to be ignored.
+// Moves the topic of the PUBLISH in the buffer over its length bytes and
+// terminates it there, where the callbacks are given it. Returns its length.
+uint16_t PubSubClient::topicInPlace() {
+   uint16_t tl = (buffer[0]<<8) + buffer[1];
+   memmove(buffer, buffer+2, tl);
+   buffer[tl] = 0;
+   return tl;
+}
+
+void PubSubClient::handlePacket(uint8_t type) {
+   if (type == MQTTPUBLISH) {
+      uint32_t start = 2 + ((buffer[0]<<8) + buffer[1]);
+      if (rxHeader & 0x06) {
+         start += 2; // the message id, which isn't acknowledged
+      }
+      if (callback && start <= rxLength) {
+         topicInPlace();
+         callback((char*)buffer, buffer+start, rxLength-start);
       }
+   } else if (type == MQTTPINGREQ) {
+      uint8_t packet[2] = {MQTTPINGRESP,0};
+      _client->write(packet,2);
+   } else if (type == MQTTPINGRESP) {
+      pingOutstanding = false;
    }
-
-   return len;
 }
 
 boolean PubSubClient::poll() {
    if (connected()) {
       unsigned long t = millis();
+      // Only what has already arrived is read, so poll() returns however
+      // fast packets keep coming
+      int budget = _client->available();
+      if (budget > 0) {
+         lastInActivity = t;
+      }
       if ((t - lastInActivity > MQTT_KEEPALIVE * 1000UL) || (t - lastOutActivity > MQTT_KEEPALIVE * 1000UL)) {
          if (pingOutstanding) {
             _client->stop();
             return false;
          } else {
-            buffer[0] = MQTTPINGREQ;
-            buffer[1] = 0;
-            _client->write(buffer,2);
+            uint8_t packet[2] = {MQTTPINGREQ,0};
+            _client->write(packet,2);
             lastOutActivity = t;
             lastInActivity = t;
             pingOutstanding = true;
          }
       }
-      if (_client->available()) {
-         uint16_t len = readPacket();
-         if (len > 0) {
-            lastInActivity = t;
-            uint8_t type = buffer[0]&0xF0;
-            if (type == MQTTPUBLISH) {
-               if (callback) {
-                  uint16_t tl = (buffer[2]<<8)+buffer[3];
-                  char topic[tl+1];
-                  for (uint16_t i=0;i<tl;i++) {
-                     topic[i] = buffer[4+i];
-                  }
-                  topic[tl] = 0;
-                  // ignore msgID - only support QoS 0 subs
-                  uint8_t *payload = buffer+4+tl;
-                  callback(topic,payload,len-4-tl);
-               }
-            } else if (type == MQTTPINGREQ) {
-               buffer[0] = MQTTPINGRESP;
-               buffer[1] = 0;
-               _client->write(buffer,2);
-            } else if (type == MQTTPINGRESP) {
-               pingOutstanding = false;
-            }
+      while (budget > 0) {
+         uint8_t type = readPacket(budget);
+         if (type) {
+            handlePacket(type);
          }
       }
       return true;
@@ -203,18 +338,25 @@ boolean PubSubClient::publish(char* topic, uint8_t* payload, unsigned int plengt
 
 boolean PubSubClient::publish(char* topic, uint8_t* payload, unsigned int plength, boolean retained) {
    if (connected()) {
+      uint16_t room;
+      uint8_t* buf = txBuffer(room);
+      size_t tlen = strlen(topic);
+      if (7UL + tlen + plength > room) {
+         return false;
+      }
+      // The topic and payload may be the ones a callback was given, in the
+      // buffer: the payload goes to its place first, so the topic cannot
+      // overwrite it.
+      memmove(buf+7+tlen,payload,plength);
       // Leave room in the buffer for header and variable length field
       uint16_t length = 5;
-      length = writeString(topic,buffer,length);
-      uint16_t i;
-      for (i=0;i<plength;i++) {
-         buffer[length++] = payload[i];
-      }
+      length = writeString(topic,buf,length);
+      length += plength;
       uint8_t header = MQTTPUBLISH;
       if (retained) {
          header |= 1;
       }
-      return write(header,buffer,length-5);
+      return write(header,buf,length-5);
    }
    return false;
 }
@@ -222,7 +364,7 @@ boolean PubSubClient::publish(char* topic, uint8_t* payload, unsigned int plengt
 boolean PubSubClient::publish_P(char* topic, uint8_t* payload, unsigned int plength, boolean retained) {
    uint8_t llen = 0;
    uint8_t digit;
-   int rc;
+   int rc = 0;
    uint16_t tlen;
    int pos = 0;
    int i;
@@ -234,12 +376,17 @@ boolean PubSubClient::publish_P(char* topic, uint8_t* payload, unsigned int plen
    }
    
    tlen = strlen(topic);
+   uint16_t room;
+   uint8_t* buf = txBuffer(room);
+   if (tlen + 7U > room) {
+      return false;
+   }
    
    header = MQTTPUBLISH;
    if (retained) {
       header |= 1;
    }
-   buffer[pos++] = header;
+   buf[pos++] = header;
    len = plength + 2 + tlen;
    do {
       digit = len % 128;
@@ -247,13 +394,13 @@ boolean PubSubClient::publish_P(char* topic, uint8_t* payload, unsigned int plen
       if (len > 0) {
          digit |= 0x80;
       }
-      buffer[pos++] = digit;
+      buf[pos++] = digit;
       llen++;
    } while(len>0);
    
-   pos = writeString(topic,buffer,pos);
+   pos = writeString(topic,buf,pos);
    
-   rc += _client->write(buffer,pos);
+   rc += _client->write(buf,pos);
    
    for (i=0;i<plength;i++) {
       rc += _client->write(*payload + i);
@@ -268,8 +415,8 @@ boolean PubSubClient::write(uint8_t header, uint8_t* buf, uint16_t length) {
    uint8_t llen = 0;
    uint8_t digit;
    uint8_t pos = 0;
-   uint8_t rc;
-   uint8_t len = length;
+   size_t rc;
+   uint16_t len = length;
    do {
       digit = len % 128;
       len = len / 128;
@@ -293,40 +440,51 @@ boolean PubSubClient::write(uint8_t header, uint8_t* buf, uint16_t length) {
 
 boolean PubSubClient::subscribe(char* topic) {
    if (connected()) {
+      uint16_t room;
+      uint8_t* buf = txBuffer(room);
+      if (10UL + strlen(topic) > room) {
+         return false;
+      }
       // Leave room in the buffer for header and variable length field
       uint16_t length = 7;
       nextMsgId++;
       if (nextMsgId == 0) {
          nextMsgId = 1;
       }
-      buffer[0] = (nextMsgId >> 8);
-      buffer[1] = (nextMsgId & 0xFF);
-      length = writeString(topic, buffer,length);
-      buffer[length++] = 0; // Only do QoS 0 subs
-      return write(MQTTSUBSCRIBE|MQTTQOS1,buffer,length-5);
+      buf[5] = (nextMsgId >> 8);
+      buf[6] = (nextMsgId & 0xFF);
+      length = writeString(topic, buf,length);
+      buf[length++] = 0; // Only do QoS 0 subs
+      return write(MQTTSUBSCRIBE|MQTTQOS1,buf,length-5);
    }
    return false;
 }
 
 void PubSubClient::disconnect() {
-   buffer[0] = MQTTDISCONNECT;
-   buffer[1] = 0;
-   _client->write(buffer,2);
+   uint8_t packet[2] = {MQTTDISCONNECT,0};
+   _client->write(packet,2);
    _client->stop();
    lastInActivity = lastOutActivity = millis();
 }
 
 uint16_t PubSubClient::writeString(char* string, uint8_t* buf, uint16_t pos) {
-   char* idp = string;
-   uint16_t i = 0;
-   pos += 2;
-   while (*idp) {
-      buf[pos++] = *idp++;
-      i++;
+   // The string may be a topic a callback was given, in the buffer
+   uint16_t i = strlen(string);
+   memmove(buf+pos+2,string,i);
+   buf[pos++] = (i >> 8);
+   buf[pos++] = (i & 0xFF);
+   return pos+i;
+}
+
+// Where an outgoing packet can be put together: the whole buffer, or what
+// is left of it after a packet that is still coming in
+uint8_t* PubSubClient::txBuffer(uint16_t& room) {
+   uint16_t used = 0;
+   if (rxState != RX_HEADER && rxState != RX_LENGTH && rxState != RX_SKIP) {
+      used = rxPos;
    }
-   buf[pos-i-2] = (i >> 8);
-   buf[pos-i-1] = (i & 0xFF);
-   return pos;
+   room = bufferSize - used;
+   return buffer + used;
 }
 
 
@@ -10,7 +10,8 @@
 #include <Arduino.h>
 #include "Client.h"
 
-// MQTT_MAX_PACKET_SIZE : Maximum packet size
+// MQTT_MAX_PACKET_SIZE : Size of the built-in packet buffer. setBuffer()
+// can hand the client a bigger one instead.
 #define MQTT_MAX_PACKET_SIZE 128
 
 // MQTT_KEEPALIVE : keepAlive interval in Seconds
@@ -37,17 +38,45 @@
 #define MQTTQOS1        (1 << 1)
 #define MQTTQOS2        (2 << 1)
 
+// Called with a PUBLISH too big for the buffer, one piece of the payload at
+// a time: topic, piece, its length, its offset in the payload, payload length.
+// A publish() from it has the buffer after the topic, over the piece.
+typedef void (*MQTTChunkCallback)(char*,uint8_t*,unsigned int,unsigned long,unsigned long);
+
 class PubSubClient {
 private:
+   // Where the packet coming in has got to
+   enum {
+      RX_HEADER,     // waiting for the fixed header byte
+      RX_LENGTH,     // in the remaining length
+      RX_BODY,       // reading the packet into the buffer
+      RX_TOPIC,      // reading the topic of a PUBLISH too big for the buffer
+      RX_PAYLOAD,    // passing its payload to chunkCallback
+      RX_SKIP        // dropping a packet too big for the buffer
+   };
    Client* _client;
-   uint8_t buffer[MQTT_MAX_PACKET_SIZE];
+   uint8_t defaultBuffer[MQTT_MAX_PACKET_SIZE];
+   uint8_t* buffer;
+   uint16_t bufferSize;
    uint16_t nextMsgId;
    unsigned long lastOutActivity;
    unsigned long lastInActivity;
    bool pingOutstanding;
    void (*callback)(char*,uint8_t*,unsigned int);
-   uint16_t readPacket();
-   uint8_t readByte();
+   MQTTChunkCallback chunkCallback;
+   uint8_t rxState;
+   uint8_t rxHeader;
+   uint8_t rxShift;
+   uint16_t rxPos;
+   uint16_t rxNeed;
+   uint32_t rxLength;
+   uint32_t rxRemaining;
+   uint32_t rxOffset;
+   void init(Client& client);
+   uint8_t readPacket(int& budget);
+   void handlePacket(uint8_t type);
+   uint16_t topicInPlace();
+   uint8_t* txBuffer(uint16_t& room);
    boolean write(uint8_t header, uint8_t* buf, uint16_t length);
    uint16_t writeString(char* string, uint8_t* buf, uint16_t pos);
    uint8_t *ip;
@@ -68,6 +97,8 @@ public:
    boolean publish_P(char *, uint8_t *, unsigned int, boolean);
    boolean subscribe(char *);
    boolean poll();
+   void setBuffer(uint8_t *, uint16_t);
+   void setChunkCallback(MQTTChunkCallback);
    boolean connected();
 };
 
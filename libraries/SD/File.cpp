@@ -130,8 +130,12 @@ uint32_t File::size() {
 
 void File::close() {
   if (_file) {
+    // the log buffers from SD.openLog(), if any
+    sd_log_t *log = _file->logBuffers();
+
     _file->close();
     free(_file); 
+    free(log);
     _file = 0;
 
     /* for debugging file open/close leaks
@@ -142,6 +146,16 @@ void File::close() {
   }
 }
 
+boolean File::drainLog() {
+  return _file && _file->logDrain();
+}
+
+uint32_t File::lostRecords() {
+  if (_file && _file->logBuffers())
+    return _file->logBuffers()->lost;
+  return 0;
+}
+
 File::operator bool() {
   if (_file) 
     return  _file->isOpen();
@@ -469,6 +469,47 @@ File SDClass::open(const char *filepath, uint8_t mode) {
 }
 
 
+File SDClass::openLog(const char *filepath, uint32_t size,
+                      boolean deferred) {
+  /*
+
+     Create the supplied file path as a log of up to `size` bytes.
+
+     Any file of the same name is removed first. The clusters are
+     allocated in one piece, and records written to the returned file
+     go to the card a block at a time; see `SdFile::logBegin()`.
+
+   */
+
+  int pathidx;
+  SdFile parentdir = getParentDir(filepath, &pathidx);
+
+  filepath += pathidx;
+  if (! filepath[0] || ! parentdir.isOpen())
+    return File();
+
+  // the root directory is used as it is, as in `open`
+  SdFile *dir = parentdir.isRoot() ? &root : &parentdir;
+  SdFile file;
+  sd_log_t *log = (sd_log_t *)malloc(sizeof(sd_log_t));
+  boolean ok = false;
+
+  if (log) {
+    SdFile::remove(dir, filepath);
+    ok = file.createContiguous(dir, filepath, size) &&
+         file.logBegin(log, deferred);
+  }
+  if (! parentdir.isRoot())
+    parentdir.close();
+  if (! ok) {
+    if (file.isOpen())
+      file.remove();
+    free(log);
+    return File();
+  }
+  return File(file, filepath);
+}
+
 /*
 File SDClass::open(char *filepath, uint8_t mode) {
   //
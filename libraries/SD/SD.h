@@ -46,6 +46,12 @@ public:
   operator bool();
   char * name();
 
+  // For a log opened with SD.openLog(): write the full buffers to the
+  // card, which a deferred log leaves to this, and the records the log
+  // could not take.
+  boolean drainLog(void);
+  uint32_t lostRecords(void);
+
   boolean isDirectory(void);
   File openNextFile(uint8_t mode = O_RDONLY);
   void rewindDirectory(void);
@@ -73,6 +79,13 @@ public:
   // Note that currently only one file can be open at a time.
   File open(const char *filename, uint8_t mode = FILE_READ);
 
+  // Create the specified file, replacing any with the name, as a log of
+  // up to size bytes in one piece, written a block at a time with no
+  // FAT or directory updates until flush() or close(). A deferred log's
+  // write() only buffers, for records written by an interrupt handler;
+  // the main program then calls drainLog(). See SdFile::logBegin().
+  File openLog(const char *filename, uint32_t size, boolean deferred = false);
+
   // Methods to determine if the requested file path exists.
   boolean exists(char *filepath);
 
@@ -20,6 +20,7 @@
  by Tom Igoe
  */
  // include the SD library:
+#include <SPI.h>
 #include <SD.h>
 
 // set up variables using the SD utility library functions:
@@ -20,6 +20,7 @@
  	 
  */
 
+#include <SPI.h>
 #include <SD.h>
 
 // On the Ethernet Shield, CS is pin 4. Note that even if it's not
@@ -17,6 +17,7 @@
  This example code is in the public domain.
  	 
  */
+#include <SPI.h>
 #include <SD.h>
 
 File myFile;
@@ -20,7 +20,22 @@
 #include <Arduino.h>
 #include "Sd2Card.h"
 //------------------------------------------------------------------------------
-#ifndef SOFTWARE_SPI
+#if !defined(__AVR__)
+// functions for other boards, through the SPI hooks
+#include "SdSpi.h"
+/** Send a byte to the card */
+static inline void spiSend(uint8_t b) {sdSpiSend(b);}
+/** Receive a byte from the card */
+static inline uint8_t spiRec(void) {return sdSpiRec();}
+/** Send n bytes to the card */
+static inline void spiSendBlock(const uint8_t* src, uint16_t n) {
+  sdSpiSendBlock(src, n);
+}
+/** Receive n bytes from the card, or skip them if dst is null */
+static inline void spiRecBlock(uint8_t* dst, uint16_t n) {
+  sdSpiRecBlock(dst, n);
+}
+#elif !defined(SOFTWARE_SPI)
 // functions for hardware SPI
 /** Send a byte to the card */
 static void spiSend(uint8_t b) {
@@ -32,6 +47,40 @@ static  uint8_t spiRec(void) {
   spiSend(0XFF);
   return SPDR;
 }
+/** Send n bytes to the card */
+static void spiSendBlock(const uint8_t* src, uint16_t n) {
+  if (n == 0) return;
+  // start first spi transfer
+  SPDR = src[0];
+  for (uint16_t i = 1; i < n; i++) {
+    while (!(SPSR & (1 << SPIF)));
+    SPDR = src[i];
+  }
+  // wait for last data byte
+  while (!(SPSR & (1 << SPIF)));
+}
+/** Receive n bytes from the card, or skip them if dst is null */
+static void spiRecBlock(uint8_t* dst, uint16_t n) {
+  if (n == 0) return;
+  // start first spi transfer
+  SPDR = 0XFF;
+  n--;
+  if (dst) {
+    for (uint16_t i = 0; i < n; i++) {
+      while (!(SPSR & (1 << SPIF)));
+      dst[i] = SPDR;
+      SPDR = 0XFF;
+    }
+  } else {
+    for (uint16_t i = 0; i < n; i++) {
+      while (!(SPSR & (1 << SPIF)));
+      SPDR = 0XFF;
+    }
+  }
+  // wait for last byte
+  while (!(SPSR & (1 << SPIF)));
+  if (dst) dst[n] = SPDR;
+}
 #else  // SOFTWARE_SPI
 //------------------------------------------------------------------------------
 /** nop to tune soft SPI timing */
@@ -86,6 +135,19 @@ void spiSend(uint8_t data) {
   // enable interrupts
   sei();
 }
+//------------------------------------------------------------------------------
+/** Soft SPI send of n bytes */
+static void spiSendBlock(const uint8_t* src, uint16_t n) {
+  for (uint16_t i = 0; i < n; i++) spiSend(src[i]);
+}
+//------------------------------------------------------------------------------
+/** Soft SPI receive of n bytes, or skip them if dst is null */
+static void spiRecBlock(uint8_t* dst, uint16_t n) {
+  for (uint16_t i = 0; i < n; i++) {
+    uint8_t b = spiRec();
+    if (dst) dst[i] = b;
+  }
+}
 #endif  // SOFTWARE_SPI
 //------------------------------------------------------------------------------
 // send command and return error code.  Return zero for OK
@@ -93,11 +155,17 @@ uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   // end read if in partialBlockRead mode
   readEnd();
 
+  // a multiple block read must be stopped before any other command
+  if (inMultiRead_ && cmd != CMD12) readStop();
+
+  // and a multiple block write with the stop token
+  if (inMultiWrite_) writeStop();
+
   // select card
   chipSelectLow();
 
-  // wait up to 300 ms if busy
-  waitNotBusy(300);
+  // wait up to 300 ms if busy, but not while data is still coming for CMD12
+  if (cmd != CMD12) waitNotBusy(300);
 
   // send command
   spiSend(cmd | 0x40);
@@ -111,6 +179,9 @@ uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   if (cmd == CMD8) crc = 0X87;  // correct crc for CMD8 with arg 0X1AA
   spiSend(crc);
 
+  // skip the stuff byte that follows CMD12
+  if (cmd == CMD12) spiRec();
+
   // wait for response
   for (uint8_t i = 0; ((status_ = spiRec()) & 0X80) && i != 0XFF; i++);
   return status_;
@@ -211,20 +282,31 @@ uint8_t Sd2Card::eraseSingleBlockEnable(void) {
  * can be determined by calling errorCode() and errorData().
  */
 uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
-  errorCode_ = inBlock_ = partialBlockRead_ = type_ = 0;
+  errorCode_ = inBlock_ = inMultiRead_ = inMultiWrite_ = 0;
+  partialBlockRead_ = type_ = 0;
   chipSelectPin_ = chipSelectPin;
   // 16-bit init start time allows over a minute
   uint16_t t0 = (uint16_t)millis();
   uint32_t arg;
 
+#if !defined(__AVR__)
+  if (chipSelectPin_ == SD_NO_SS_PIN) {
+    error(SD_CARD_ERROR_CHIP_SELECT);
+    return false;
+  }
+#endif  // __AVR__
   // set pin modes
   pinMode(chipSelectPin_, OUTPUT);
   chipSelectHigh();
+#if !defined(__AVR__)
+  sdSpiBegin();
+#else  // __AVR__
   pinMode(SPI_MISO_PIN, INPUT);
   pinMode(SPI_MOSI_PIN, OUTPUT);
   pinMode(SPI_SCK_PIN, OUTPUT);
+#endif  // __AVR__
 
-#ifndef SOFTWARE_SPI
+#if defined(__AVR__) && !defined(SOFTWARE_SPI)
   // SS must be in output mode even it is not chip select
   pinMode(SS_PIN, OUTPUT);
   digitalWrite(SS_PIN, HIGH); // disable any SPI device using hardware SS pin
@@ -232,7 +314,7 @@ uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
   SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR1) | (1 << SPR0);
   // clear double speed
   SPSR &= ~(1 << SPI2X);
-#endif  // SOFTWARE_SPI
+#endif  // __AVR__ && !SOFTWARE_SPI
 
   // must supply min of 74 clock cycles with CS high.
   for (uint8_t i = 0; i < 10; i++) spiSend(0XFF);
@@ -334,7 +416,6 @@ uint8_t Sd2Card::readBlock(uint32_t block, uint8_t* dst) {
  */
 uint8_t Sd2Card::readData(uint32_t block,
         uint16_t offset, uint16_t count, uint8_t* dst) {
-  uint16_t n;
   if (count == 0) return true;
   if ((count + offset) > 512) {
     goto fail;
@@ -354,37 +435,13 @@ uint8_t Sd2Card::readData(uint32_t block,
     inBlock_ = 1;
   }
 
-#ifdef OPTIMIZE_HARDWARE_SPI
-  // start first spi transfer
-  SPDR = 0XFF;
-
   // skip data before offset
-  for (;offset_ < offset; offset_++) {
-    while (!(SPSR & (1 << SPIF)));
-    SPDR = 0XFF;
+  if (offset_ < offset) {
+    spiRecBlock(0, offset - offset_);
+    offset_ = offset;
   }
   // transfer data
-  n = count - 1;
-  for (uint16_t i = 0; i < n; i++) {
-    while (!(SPSR & (1 << SPIF)));
-    dst[i] = SPDR;
-    SPDR = 0XFF;
-  }
-  // wait for last byte
-  while (!(SPSR & (1 << SPIF)));
-  dst[n] = SPDR;
-
-#else  // OPTIMIZE_HARDWARE_SPI
-
-  // skip data before offset
-  for (;offset_ < offset; offset_++) {
-    spiRec();
-  }
-  // transfer data
-  for (uint16_t i = 0; i < count; i++) {
-    dst[i] = spiRec();
-  }
-#endif  // OPTIMIZE_HARDWARE_SPI
+  spiRecBlock(dst, count);
 
   offset_ += count;
   if (!partialBlockRead_ || offset_ >= 512) {
@@ -401,19 +458,8 @@ uint8_t Sd2Card::readData(uint32_t block,
 /** Skip remaining data in a block when in partial block read mode. */
 void Sd2Card::readEnd(void) {
   if (inBlock_) {
-      // skip data and crc
-#ifdef OPTIMIZE_HARDWARE_SPI
-    // optimize skip for hardware
-    SPDR = 0XFF;
-    while (offset_++ < 513) {
-      while (!(SPSR & (1 << SPIF)));
-      SPDR = 0XFF;
-    }
-    // wait for last crc byte
-    while (!(SPSR & (1 << SPIF)));
-#else  // OPTIMIZE_HARDWARE_SPI
-    while (offset_++ < 514) spiRec();
-#endif  // OPTIMIZE_HARDWARE_SPI
+    // skip data and crc
+    spiRecBlock(0, 514 - offset_);
     chipSelectHigh();
     inBlock_ = 0;
   }
@@ -428,7 +474,7 @@ uint8_t Sd2Card::readRegister(uint8_t cmd, void* buf) {
   }
   if (!waitStartBlock()) goto fail;
   // transfer data
-  for (uint16_t i = 0; i < 16; i++) dst[i] = spiRec();
+  spiRecBlock(dst, 16);
   spiRec();  // get first crc byte
   spiRec();  // get second crc byte
   chipSelectHigh();
@@ -439,6 +485,75 @@ uint8_t Sd2Card::readRegister(uint8_t cmd, void* buf) {
   return false;
 }
 //------------------------------------------------------------------------------
+/**
+ * Read one data block in a multiple block read sequence
+ *
+ * \param[out] dst Pointer to the location for the 512 byte block.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+uint8_t Sd2Card::readData(uint8_t* dst) {
+  if (!inMultiRead_) {
+    error(SD_CARD_ERROR_READ);
+    return false;
+  }
+  chipSelectLow();
+  if (!waitStartBlock()) return false;
+  // transfer data
+  spiRecBlock(dst, 512);
+  // discard crc
+  spiRec();
+  spiRec();
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Start a read multiple blocks sequence.
+ *
+ * \param[in] blockNumber Address of first block in sequence.
+ *
+ * \note This function is used with readData() and readStop()
+ * for optimized multiple block reads. The card sends blocks one after
+ * another with no command in between; any other command ends the
+ * sequence with readStop() first.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+uint8_t Sd2Card::readStart(uint32_t blockNumber) {
+  // use address if not SDHC card
+  if (type()!= SD_CARD_TYPE_SDHC) blockNumber <<= 9;
+  if (cardCommand(CMD18, blockNumber)) {
+    error(SD_CARD_ERROR_CMD18);
+    goto fail;
+  }
+  inMultiRead_ = 1;
+  return true;
+
+ fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
+/** End a read multiple blocks sequence.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+uint8_t Sd2Card::readStop(void) {
+  inMultiRead_ = 0;
+  if (cardCommand(CMD12, 0)) {
+    error(SD_CARD_ERROR_CMD12);
+    goto fail;
+  }
+  chipSelectHigh();
+  return true;
+
+ fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
 /**
  * Set the SPI clock rate.
  *
@@ -456,6 +571,9 @@ uint8_t Sd2Card::setSckRate(uint8_t sckRateID) {
     error(SD_CARD_ERROR_SCK_RATE);
     return false;
   }
+#if !defined(__AVR__)
+  sdSpiSetSckRate(sckRateID);
+#else  // __AVR__
   // see avr processor datasheet for SPI register bit definitions
   if ((sckRateID & 1) || sckRateID == 6) {
     SPSR &= ~(1 << SPI2X);
@@ -465,6 +583,7 @@ uint8_t Sd2Card::setSckRate(uint8_t sckRateID) {
   SPCR &= ~((1 <<SPR1) | (1 << SPR0));
   SPCR |= (sckRateID & 4 ? (1 << SPR1) : 0)
     | (sckRateID & 2 ? (1 << SPR0) : 0);
+#endif  // __AVR__
   return true;
 }
 //------------------------------------------------------------------------------
@@ -541,41 +660,34 @@ uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src) {
   return false;
 }
 //------------------------------------------------------------------------------
-/** Write one data block in a multiple block write sequence */
+/**
+ * Write one data block in a multiple block write sequence
+ *
+ * The card is deselected after the block, so the bus is free for
+ * other devices until the next one.
+ */
 uint8_t Sd2Card::writeData(const uint8_t* src) {
+  if (!inMultiWrite_) {
+    error(SD_CARD_ERROR_WRITE_MULTIPLE);
+    return false;
+  }
+  chipSelectLow();
   // wait for previous write to finish
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
     error(SD_CARD_ERROR_WRITE_MULTIPLE);
     chipSelectHigh();
     return false;
   }
-  return writeData(WRITE_MULTIPLE_TOKEN, src);
+  if (!writeData(WRITE_MULTIPLE_TOKEN, src)) return false;
+  block_++;
+  chipSelectHigh();
+  return true;
 }
 //------------------------------------------------------------------------------
 // send one block of data for write block or write multiple blocks
 uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
-#ifdef OPTIMIZE_HARDWARE_SPI
-
-  // send data - optimized loop
-  SPDR = token;
-
-  // send two byte per iteration
-  for (uint16_t i = 0; i < 512; i += 2) {
-    while (!(SPSR & (1 << SPIF)));
-    SPDR = src[i];
-    while (!(SPSR & (1 << SPIF)));
-    SPDR = src[i+1];
-  }
-
-  // wait for last data byte
-  while (!(SPSR & (1 << SPIF)));
-
-#else  // OPTIMIZE_HARDWARE_SPI
   spiSend(token);
-  for (uint16_t i = 0; i < 512; i++) {
-    spiSend(src[i]);
-  }
-#endif  // OPTIMIZE_HARDWARE_SPI
+  spiSendBlock(src, 512);
   spiSend(0xff);  // dummy crc
   spiSend(0xff);  // dummy crc
 
@@ -594,7 +706,8 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
  * \param[in] eraseCount The number of blocks to be pre-erased.
  *
  * \note This function is used with writeData() and writeStop()
- * for optimized multiple block writes.
+ * for optimized multiple block writes. Any other command ends the
+ * sequence with writeStop() first.
  *
  * \return The value one, true, is returned for success and
  * the value zero, false, is returned for failure.
@@ -618,6 +731,9 @@ uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
     error(SD_CARD_ERROR_CMD25);
     goto fail;
   }
+  block_ = type() != SD_CARD_TYPE_SDHC ? blockNumber >> 9 : blockNumber;
+  inMultiWrite_ = 1;
+  chipSelectHigh();
   return true;
 
  fail:
@@ -631,6 +747,8 @@ uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
  * the value zero, false, is returned for failure.
  */
 uint8_t Sd2Card::writeStop(void) {
+  inMultiWrite_ = 0;
+  chipSelectLow();
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
   spiSend(STOP_TRAN_TOKEN);
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
@@ -58,6 +58,7 @@ uint8_t const SPI_QUARTER_SPEED = 2;
  */
 /** The default chip select pin for the SD card is SS. */
 uint8_t const  SD_CHIP_SELECT_PIN = SS_PIN;
+#if defined(__AVR__)
 // The following three pins must not be redefined for hardware SPI.
 /** SPI Master Out Slave In pin */
 uint8_t const  SPI_MOSI_PIN = MOSI_PIN;
@@ -65,8 +66,7 @@ uint8_t const  SPI_MOSI_PIN = MOSI_PIN;
 uint8_t const  SPI_MISO_PIN = MISO_PIN;
 /** SPI Clock pin */
 uint8_t const  SPI_SCK_PIN = SCK_PIN;
-/** optimize loops for hardware SPI */
-#define OPTIMIZE_HARDWARE_SPI
+#endif  // __AVR__
 
 #else  // SOFTWARE_SPI
 // define software SPI pins so Mega can use unmodified GPS Shield
@@ -136,6 +136,12 @@ uint8_t const SD_CARD_ERROR_WRITE_PROGRAMMING = 0X14;
 uint8_t const SD_CARD_ERROR_WRITE_TIMEOUT = 0X15;
 /** incorrect rate selected */
 uint8_t const SD_CARD_ERROR_SCK_RATE = 0X16;
+/** card returned an error response for CMD12 (stop a multiple block read) */
+uint8_t const SD_CARD_ERROR_CMD12 = 0X17;
+/** card returned an error response for CMD18 (read multiple blocks) */
+uint8_t const SD_CARD_ERROR_CMD18 = 0X18;
+/** no chip select pin given, and the board has no default */
+uint8_t const SD_CARD_ERROR_CHIP_SELECT = 0X19;
 //------------------------------------------------------------------------------
 // card types
 /** Standard capacity V1 SD card */
@@ -152,7 +158,8 @@ uint8_t const SD_CARD_TYPE_SDHC = 3;
 class Sd2Card {
  public:
   /** Construct an instance of Sd2Card. */
-  Sd2Card(void) : errorCode_(0), inBlock_(0), partialBlockRead_(0), type_(0) {}
+  Sd2Card(void) : errorCode_(0), inBlock_(0), inMultiRead_(0),
+    inMultiWrite_(0), partialBlockRead_(0), type_(0) {}
   uint32_t cardSize(void);
   uint8_t erase(uint32_t firstBlock, uint32_t lastBlock);
   uint8_t eraseSingleBlockEnable(void);
@@ -178,12 +185,22 @@ class Sd2Card {
     return init(sckRateID, SD_CHIP_SELECT_PIN);
   }
   uint8_t init(uint8_t sckRateID, uint8_t chipSelectPin);
+  /**
+   * \return The block the next writeData() call writes, or 0XFFFFFFFF
+   * if no multiple block write is going.
+   */
+  uint32_t multiWriteBlock(void) const {
+    return inMultiWrite_ ? block_ : 0XFFFFFFFF;
+  }
   void partialBlockRead(uint8_t value);
   /** Returns the current value, true or false, for partial block read. */
   uint8_t partialBlockRead(void) const {return partialBlockRead_;}
   uint8_t readBlock(uint32_t block, uint8_t* dst);
   uint8_t readData(uint32_t block,
           uint16_t offset, uint16_t count, uint8_t* dst);
+  uint8_t readData(uint8_t* dst);
+  uint8_t readStart(uint32_t blockNumber);
+  uint8_t readStop(void);
   /**
    * Read a cards CID register. The CID contains card identification
    * information such as Manufacturer ID, Product name, Product serial
@@ -210,6 +227,8 @@ class Sd2Card {
   uint8_t chipSelectPin_;
   uint8_t errorCode_;
   uint8_t inBlock_;
+  uint8_t inMultiRead_;
+  uint8_t inMultiWrite_;
   uint16_t offset_;
   uint8_t partialBlockRead_;
   uint8_t status_;
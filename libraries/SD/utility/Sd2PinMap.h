@@ -20,6 +20,7 @@
 // Warning this file was generated by a program.
 #ifndef Sd2PinMap_h
 #define Sd2PinMap_h
+#if defined(__AVR__)
 #include <avr/io.h>
 
 //------------------------------------------------------------------------------
@@ -350,4 +351,24 @@ static inline __attribute__((always_inline))
     badPinNumber();
   }
 }
+#else  // __AVR__
+//------------------------------------------------------------------------------
+// Other boards reach the card through the hooks in SdSpi.h, which look after
+// the SPI pins themselves; only chip select is left to Sd2Card.
+/** SS_PIN value for a board whose pin map has no SPI chip select */
+uint8_t const SD_NO_SS_PIN = 0XFF;
+#if defined(SD_SS_PIN)
+/** Chip select used when none is given, from SD_SS_PIN */
+uint8_t const SS_PIN = SD_SS_PIN;
+#elif defined(__MSP430__)
+/** Chip select used when none is given, SS of the board's pin map */
+uint8_t const SS_PIN = SS;
+#else  // SD_SS_PIN
+/**
+ * The pin map has no SS, so there is no default chip select: init() fails
+ * unless it is given one, or SD_SS_PIN is defined.
+ */
+uint8_t const SS_PIN = SD_NO_SS_PIN;
+#endif  // SD_SS_PIN
+#endif  // __AVR__
 #endif  // Sd2PinMap_h
@@ -33,6 +33,18 @@
  */
 #define ALLOW_DEPRECATED_FUNCTIONS 1
 //------------------------------------------------------------------------------
+/**
+ * Number of 512 byte blocks in the SdVolume cache.  With one block a FAT,
+ * a directory and a data block evict each other on every file append.
+ */
+#ifndef SD_CACHE_BLOCKS
+#if defined(__AVR__) || defined(__MSP430__)
+#define SD_CACHE_BLOCKS 1
+#else  // defined(__AVR__) || defined(__MSP430__)
+#define SD_CACHE_BLOCKS 4
+#endif  // defined(__AVR__) || defined(__MSP430__)
+#endif  // SD_CACHE_BLOCKS
+//------------------------------------------------------------------------------
 // forward declaration since SdVolume is used in SdFile
 class SdVolume;
 //==============================================================================
@@ -128,6 +140,56 @@ uint16_t const FAT_DEFAULT_DATE = ((2000 - 1980) << 9) | (1 << 5) | 1;
 /** Default time for file timestamp is 1 am */
 uint16_t const FAT_DEFAULT_TIME = (1 << 11);
 //------------------------------------------------------------------------------
+/**
+ * \struct fatExtent
+ * \brief An entry in a file's extent map, a run of contiguous clusters.
+ *
+ * The run starts at \a cluster, which is cluster \a index of the file
+ * counting from zero, and ends where the next entry in the map starts.
+ */
+struct fatExtent {
+           /** index in the file of the first cluster of the run */
+  uint32_t index;
+           /** first cluster of the run */
+  uint32_t cluster;
+};
+/** Type name for fatExtent */
+typedef struct fatExtent fat_extent_t;
+//------------------------------------------------------------------------------
+/**
+ * \struct sdLog
+ * \brief The pair of block buffers for a file written by SdFile::logBegin().
+ *
+ * Records go into buf[current] while the other buffer, once full, goes
+ * to the card. Only write() and sync() should change the fields.
+ */
+struct sdLog {
+                    /** the two buffers */
+  uint8_t           buf[2][512];
+                    /** nonzero while buf[i] is full and not yet written */
+  volatile uint8_t  full[2];
+                    /** index of the buffer taking records */
+  volatile uint8_t  current;
+                    /** index of the next buffer for the card */
+  uint8_t           sending;
+                    /** nonzero while buffers are being written */
+  volatile uint8_t  writing;
+                    /** nonzero if write() leaves the card to logDrain() */
+  uint8_t           deferred;
+                    /** bytes in buf[current] */
+  volatile uint16_t fill;
+                    /** block for buf[sending] */
+  uint32_t          block;
+                    /** first block of the file */
+  uint32_t          bgnBlock;
+                    /** last block of the file */
+  uint32_t          endBlock;
+                    /** records not written because both buffers were full */
+  volatile uint32_t lost;
+};
+/** Type name for sdLog */
+typedef struct sdLog sd_log_t;
+//------------------------------------------------------------------------------
 /**
  * \class SdFile
  * \brief Access FAT16 and FAT32 files on SD and SDHC cards.
@@ -135,7 +197,7 @@ uint16_t const FAT_DEFAULT_TIME = (1 << 11);
 class SdFile : public Print {
  public:
   /** Create an instance of SdFile. */
-  SdFile(void) : type_(FAT_FILE_TYPE_CLOSED) {}
+  SdFile(void) : type_(FAT_FILE_TYPE_CLOSED), map_(0), log_(0) {}
   /**
    * writeError is set to true if an error occurs during a write().
    * Set writeError to false before calling print() and/or write() and check
@@ -151,6 +213,8 @@ class SdFile : public Print {
   }
   uint8_t close(void);
   uint8_t contiguousRange(uint32_t* bgnBlock, uint32_t* endBlock);
+  uint8_t contiguousRange(uint16_t extent,
+          uint32_t* bgnBlock, uint32_t* endBlock);
   uint8_t createContiguous(SdFile* dirFile,
           const char* fileName, uint32_t size);
   /** \return The current cluster number for a file or directory. */
@@ -202,6 +266,10 @@ class SdFile : public Print {
   /** \return Index of this file's directory in the block dirBlock. */
   uint8_t dirIndex(void) const {return dirIndex_;}
   static void dirName(const dir_t& dir, char* name);
+  /** \return The number of entries in the extent map, zero if there is
+   * no map or it has not been built yet.
+   */
+  uint16_t extentCount(void) const {return map_ ? mapCount_ : 0;}
   /** \return The total number of bytes in a file or directory. */
   uint32_t fileSize(void) const {return fileSize_;}
   /** \return The first cluster number for a file or directory. */
@@ -218,6 +286,11 @@ class SdFile : public Print {
   uint8_t isRoot(void) const {
     return type_ == FAT_FILE_TYPE_ROOT16 || type_ == FAT_FILE_TYPE_ROOT32;
   }
+  uint8_t logBegin(sd_log_t* log, uint8_t deferred = false);
+  /** \return The log buffers given to logBegin(), or NULL. */
+  sd_log_t* logBuffers(void) const {return log_;}
+  uint8_t logDrain(void);
+
   void ls(uint8_t flags = 0, uint8_t indent = 0);
   uint8_t makeDir(SdFile* dir, const char* dirName);
   uint8_t open(SdFile* dirFile, uint16_t index, uint8_t oflag);
@@ -258,6 +331,7 @@ class SdFile : public Print {
    */
   uint8_t seekEnd(void) {return seekSet(fileSize_);}
   uint8_t seekSet(uint32_t pos);
+  uint8_t setExtentMap(fat_extent_t* map, uint16_t size);
   /**
    * Use unbuffered reads to access this file.  Used with Wave
    * Shield ISR.  Used with Sd2Card::partialBlockRead() in WaveRP.
@@ -369,14 +443,17 @@ class SdFile : public Print {
   // should be 0XF
   static uint8_t const F_OFLAG = (O_ACCMODE | O_APPEND | O_SYNC);
   // available bits
-  static uint8_t const F_UNUSED = 0X30;
+  static uint8_t const F_UNUSED = 0X20;
+  // extent map has been built and reaches the end of the cluster chain
+  static uint8_t const F_FILE_MAP_COMPLETE = 0X10;
   // use unbuffered SD read
   static uint8_t const F_FILE_UNBUFFERED_READ = 0X40;
   // sync of directory entry required
   static uint8_t const F_FILE_DIR_DIRTY = 0X80;
 
 // make sure F_OFLAG is ok
-#if ((F_UNUSED | F_FILE_UNBUFFERED_READ | F_FILE_DIR_DIRTY) & F_OFLAG)
+#if ((F_UNUSED | F_FILE_MAP_COMPLETE | F_FILE_UNBUFFERED_READ \
+  | F_FILE_DIR_DIRTY) & F_OFLAG)
 #error flags_ bits conflict
 #endif  // flags_ bits
 
@@ -390,11 +467,24 @@ class SdFile : public Print {
   uint32_t  fileSize_;      // file size in bytes
   uint32_t  firstCluster_;  // first cluster of file
   SdVolume* vol_;           // volume where file is located
+  fat_extent_t* map_;       // extent map supplied by setExtentMap() or NULL
+  uint16_t  mapSize_;       // entries in map_
+  uint16_t  mapCount_;      // entries in use, zero until the map is built
+  uint32_t  mapClusters_;   // clusters of the file the map covers
+  sd_log_t* log_;           // buffers supplied by logBegin() or NULL
 
   // private functions
   uint8_t addCluster(void);
   uint8_t addDirCluster(void);
   dir_t* cacheDirEntry(uint8_t action);
+  uint8_t logSend(void);
+  uint8_t logSync(void);
+  size_t logWrite(const uint8_t* src, uint16_t nbyte);
+
+  uint8_t mapAdd(uint32_t cluster);
+  uint8_t mapBuild(void);
+  uint8_t mapCluster(uint32_t index, uint32_t* cluster);
+
   static void (*dateTime_)(uint16_t* date, uint16_t* time);
   static uint8_t make83Name(const char* str, uint8_t* name);
   uint8_t openCachedEntry(uint8_t cacheIndex, uint8_t oflags);
@@ -433,8 +523,8 @@ class SdVolume {
    */
   static uint8_t* cacheClear(void) {
     cacheFlush();
-    cacheBlockNumber_ = 0XFFFFFFFF;
-    return cacheBuffer_.data;
+    cacheInvalidate();
+    return cacheBuffer_->data;
   }
   /**
    * Initialize a FAT volume.  Try partition one first then try super
@@ -494,12 +584,35 @@ class SdVolume {
   static uint8_t const CACHE_FOR_READ = 0;
   // value for action argument in cacheRawBlock to indicate cache dirty
   static uint8_t const CACHE_FOR_WRITE = 1;
+  // cache status bit, block is in the FAT and the mirror FAT needs it too
+  static uint8_t const CACHE_STATUS_MIRROR_FAT = 2;
+  // action option, don't read the block from the card if it isn't cached
+  static uint8_t const CACHE_OPTION_NO_READ = 4;
+  // action for a block that will be written before it is read
+  static uint8_t const CACHE_RESERVE_FOR_WRITE =
+                         CACHE_FOR_WRITE | CACHE_OPTION_NO_READ;
+  // action priorities, a directory or FAT block is evicted later than data
+  static uint8_t const CACHE_PRIORITY_DIR = 0X10;
+  static uint8_t const CACHE_PRIORITY_FAT = 0X20;
+  static uint8_t const CACHE_PRIORITY_MASK = 0X30;
+  // FAT blocks whose mirror cacheFlush() writes, past that it is written
+  // when the block is
+  static uint8_t const CACHE_MIRROR_BLOCKS = 8;
 
-  static cache_t cacheBuffer_;        // 512 byte cache for device blocks
-  static uint32_t cacheBlockNumber_;  // Logical number of block in the cache
+  static cache_t cacheBlocks_[SD_CACHE_BLOCKS];  // 512 byte caches for blocks
+  static uint32_t cacheBlockNumber_[SD_CACHE_BLOCKS];  // Logical numbers
+  static uint8_t cacheStatus_[SD_CACHE_BLOCKS];  // dirty, mirror and priority
+  static uint32_t cacheUsed_[SD_CACHE_BLOCKS];   // cacheClock_ at last use
+  static uint32_t cacheClock_;        // counts uses of cached blocks
+  static uint8_t cacheCurrent_;       // index of block last cached
+  static cache_t* cacheBuffer_;       // the block last cached
   static Sd2Card* sdCard_;            // Sd2Card object for cache
-  static uint8_t cacheDirty_;         // cacheFlush() will write block if true
-  static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+#if SD_CACHE_BLOCKS > 1
+  static uint32_t cacheMirror_[CACHE_MIRROR_BLOCKS];  // FAT blocks the
+                                                      // mirror lacks
+  static uint8_t cacheMirrorCount_;   // entries used in cacheMirror_
+#endif  // SD_CACHE_BLOCKS > 1
+  static uint32_t cacheMirrorOffset_;  // mirror FAT block minus FAT block
 //
   uint32_t allocSearchStart_;   // start cluster for alloc search
   uint8_t blocksPerCluster_;    // cluster size in blocks
@@ -520,10 +633,20 @@ class SdVolume {
            return dataStartBlock_ + ((cluster - 2) << clusterSizeShift_);}
   uint32_t blockNumber(uint32_t cluster, uint32_t position) const {
            return clusterStartBlock(cluster) + blockOfCluster(position);}
+  static uint32_t cacheBlockNumber(void) {
+    return cacheBlockNumber_[cacheCurrent_];
+  }
+  static int8_t cacheFind(uint32_t blockNumber);
   static uint8_t cacheFlush(void);
+  static void cacheInvalidate(void);
+  static void cacheInvalidate(uint32_t blockNumber);
   static uint8_t cacheRawBlock(uint32_t blockNumber, uint8_t action);
-  static void cacheSetDirty(void) {cacheDirty_ |= CACHE_FOR_WRITE;}
+  static void cacheSetDirty(void) {
+    cacheStatus_[cacheCurrent_] |= CACHE_FOR_WRITE;
+  }
+  static uint8_t cacheWriteBack(uint8_t index);
   static uint8_t cacheZeroBlock(uint32_t blockNumber);
+
   uint8_t chainSize(uint32_t beginCluster, uint32_t* size) const;
   uint8_t fatGet(uint32_t cluster, uint32_t* value) const;
   uint8_t fatPut(uint32_t cluster, uint32_t value);
@@ -540,6 +663,9 @@ class SdVolume {
     uint16_t count, uint8_t* dst) {
       return sdCard_->readData(block, offset, count, dst);
   }
+  uint8_t readData(uint8_t* dst) {return sdCard_->readData(dst);}
+  uint8_t readStart(uint32_t block) {return sdCard_->readStart(block);}
+  uint8_t readStop(void) {return sdCard_->readStop();}
   uint8_t writeBlock(uint32_t block, const uint8_t* dst) {
     return sdCard_->writeBlock(block, dst);
   }
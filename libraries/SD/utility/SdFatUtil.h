@@ -33,6 +33,7 @@
 #define NOINLINE __attribute__((noinline,unused))
 #define UNUSEDOK __attribute__((unused))
 //------------------------------------------------------------------------------
+#if defined(__AVR__)
 /** Return the number of bytes currently free in RAM. */
 static UNUSEDOK int FreeRam(void) {
   extern int  __bss_end;
@@ -49,6 +50,7 @@ static UNUSEDOK int FreeRam(void) {
   }
   return free_memory;
 }
+#endif  // __AVR__
 //------------------------------------------------------------------------------
 /**
  * %Print a string in flash memory to the serial port.
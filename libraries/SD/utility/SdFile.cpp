@@ -38,6 +38,10 @@ uint8_t SdFile::addCluster() {
     firstCluster_ = curCluster_;
     flags_ |= F_FILE_DIR_DIRTY;
   }
+  // keep a complete extent map complete
+  if (map_ && (flags_ & F_FILE_MAP_COMPLETE)) {
+    if (!mapAdd(curCluster_)) flags_ &= ~F_FILE_MAP_COMPLETE;
+  }
   return true;
 }
 //------------------------------------------------------------------------------
@@ -59,8 +63,9 @@ uint8_t SdFile::addDirCluster(void) {
 // cache a file's directory entry
 // return pointer to cached entry or null for failure
 dir_t* SdFile::cacheDirEntry(uint8_t action) {
+  action |= SdVolume::CACHE_PRIORITY_DIR;
   if (!SdVolume::cacheRawBlock(dirBlock_, action)) return NULL;
-  return SdVolume::cacheBuffer_.dir + dirIndex_;
+  return SdVolume::cacheBuffer_->dir + dirIndex_;
 }
 //------------------------------------------------------------------------------
 /**
@@ -73,6 +78,16 @@ dir_t* SdFile::cacheDirEntry(uint8_t action) {
  */
 uint8_t SdFile::close(void) {
   if (!sync())return false;
+  if (log_) {
+    // give back the clusters past the last record, following the chain
+    // from the start since the log kept no current cluster
+    uint32_t length = fileSize_;
+    fileSize_ = (log_->endBlock - log_->bgnBlock + 1) << 9;
+    log_ = 0;
+    rewind();
+
+    if (!truncate(length)) return false;
+  }
   type_ = FAT_FILE_TYPE_CLOSED;
   return true;
 }
@@ -108,6 +123,62 @@ uint8_t SdFile::contiguousRange(uint32_t* bgnBlock, uint32_t* endBlock) {
   }
 }
 //------------------------------------------------------------------------------
+/**
+ * Return the raw block range of one extent of a file, a run of contiguous
+ * clusters.  Calling this for \a extent zero, one, and so on until it fails
+ * gives the layout of a file in any number of pieces.
+ *
+ * \param[in] extent The index of the extent, zero for the first.
+ * \param[out] bgnBlock the first block address for the extent.
+ * \param[out] endBlock the last  block address for the extent.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ * Reasons for failure include the file has fewer extents, the file has
+ * zero length or an I/O error occurred.
+ *
+ * The extent map is used if setExtentMap() has been called and the map
+ * reaches the end of the extent, otherwise the FAT is followed.
+ */
+uint8_t SdFile::contiguousRange(uint16_t extent,
+        uint32_t* bgnBlock, uint32_t* endBlock) {
+  // error if no blocks
+  if (firstCluster_ == 0) return false;
+
+  if (map_ && (mapCount_ || (flags_ & F_FILE_MAP_COMPLETE) || mapBuild())) {
+    if (extent + 1 < mapCount_ ||
+      (extent + 1 == mapCount_ && (flags_ & F_FILE_MAP_COMPLETE))) {
+      uint32_t end = extent + 1 < mapCount_ ?
+                       map_[extent + 1].index : mapClusters_;
+      uint32_t last = map_[extent].cluster + end - map_[extent].index - 1;
+      *bgnBlock = vol_->clusterStartBlock(map_[extent].cluster);
+      *endBlock = vol_->clusterStartBlock(last) + vol_->blocksPerCluster_ - 1;
+      return true;
+    }
+    if (flags_ & F_FILE_MAP_COMPLETE) return false;
+  }
+  uint32_t bgn = firstCluster_;
+  for (uint32_t c = firstCluster_; ; ) {
+    uint32_t next;
+    if (!vol_->fatGet(c, &next)) return false;
+
+    // check for end of extent
+    if (next != (c + 1)) {
+      if (extent == 0) {
+        *bgnBlock = vol_->clusterStartBlock(bgn);
+        *endBlock = vol_->clusterStartBlock(c)
+                    + vol_->blocksPerCluster_ - 1;
+        return true;
+      }
+      // error if not enough extents
+      if (vol_->isEOC(next)) return false;
+      extent--;
+      bgn = next;
+    }
+    c = next;
+  }
+}
+//------------------------------------------------------------------------------
 /**
  * Create and open a new contiguous file of a specified size.
  *
@@ -185,6 +256,173 @@ void SdFile::dirName(const dir_t& dir, char* name) {
   name[j] = 0;
 }
 //------------------------------------------------------------------------------
+/**
+ * Write the file from here on as a log of records, through a pair of
+ * block buffers.
+ *
+ * The file must be contiguous, made by createContiguous(), and open for
+ * write. write() then copies each record into a buffer, and each full
+ * buffer goes to the card as the next block of one multiple block write,
+ * so neither the FAT nor the directory entry is touched until sync() or
+ * close(). A record that does not fit in the free buffers or the file
+ * is counted in log->lost and not written; write() returns zero for it.
+ *
+ * With \a deferred set, write() only fills the buffers, and the main
+ * program writes the full ones with logDrain(). That is the way for
+ * records written by an interrupt handler, which then goes on taking
+ * records in one buffer while the card takes the other.
+ *
+ * close() gives back the clusters past the last record.
+ *
+ * \param[in] log The buffers, which must stay until the file is closed.
+ * \param[in] deferred Leave the card to logDrain().
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ * Reasons for failure include the file is not contiguous, not open for
+ * write or an I/O error.
+ */
+uint8_t SdFile::logBegin(sd_log_t* log, uint8_t deferred) {
+  uint32_t bgnBlock;
+  uint32_t endBlock;
+
+  if (!isFile() || !(flags_ & O_WRITE)) return false;
+  if (!contiguousRange(&bgnBlock, &endBlock)) return false;
+
+  // no block of the file may be left in the cache to be written later
+  if (!SdVolume::cacheFlush()) return false;
+  SdVolume::cacheInvalidate();
+
+  log->full[0] = log->full[1] = 0;
+  log->current = log->sending = 0;
+  log->writing = 0;
+  log->deferred = deferred;
+  log->fill = 0;
+  log->block = log->bgnBlock = bgnBlock;
+  log->endBlock = endBlock;
+  log->lost = 0;
+  log_ = log;
+
+  // the file is empty until the first sync()
+  curCluster_ = 0;
+  curPosition_ = 0;
+  fileSize_ = 0;
+  flags_ |= F_FILE_DIR_DIRTY;
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * Write the full log buffers of a file written by logBegin() to the card,
+ * unless a call this one interrupted is doing that already.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ * Reasons for failure include the file is not a log or an I/O error.
+ */
+uint8_t SdFile::logDrain(void) {
+  sd_log_t* log = log_;
+  if (!log) return false;
+
+  // a call interrupting this one between the test and the set writes the
+  // buffers itself, and is done before this one goes on
+  while (!log->writing) {
+    log->writing = 1;
+    uint8_t ok = logSend();
+    log->writing = 0;
+    if (!ok) return false;
+
+    // a buffer filled by an interrupt after the last look
+    if (!log->full[log->sending]) break;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// Write the full log buffers to the card in the order they filled, going
+// on with the multiple block write the last one started if nothing else
+// has used the card since
+uint8_t SdFile::logSend(void) {
+  Sd2Card* card = vol_->sdCard();
+  sd_log_t* log = log_;
+
+  while (log->full[log->sending]) {
+    if (card->multiWriteBlock() != log->block) {
+      uint32_t count = log->endBlock - log->block + 1;
+      if (!card->writeStart(log->block, count)) return false;
+    }
+    if (!card->writeData(log->buf[log->sending])) return false;
+    log->full[log->sending] = 0;
+    log->sending ^= 1;
+
+    // stop at the end of the file
+    if (log->block++ == log->endBlock && !card->writeStop()) return false;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// Write the log buffers and the records in the one being filled, and
+// make the records so far the file's size
+uint8_t SdFile::logSync(void) {
+  sd_log_t* log = log_;
+  uint32_t size = curPosition_;
+  uint16_t fill = size & 0X1FF;
+
+  log->writing = 1;
+  if (!logSend()) goto fail;
+  if (fill) {
+    // the partial block, padded with zeros, written again when it fills
+    uint8_t* buf = log->buf[log->current];
+    memset(buf + fill, 0, 512 - fill);
+    SdVolume::cacheInvalidate(log->block);
+    if (!vol_->writeBlock(log->block, buf)) goto fail;
+  }
+  log->writing = 0;
+  fileSize_ = size;
+  flags_ |= F_FILE_DIR_DIRTY;
+  return true;
+
+ fail:
+  log->writing = 0;
+  return false;
+}
+//------------------------------------------------------------------------------
+// Copy a record into the log buffers, then write the full ones unless
+// that is left to logDrain()
+size_t SdFile::logWrite(const uint8_t* src, uint16_t nbyte) {
+  sd_log_t* log = log_;
+  uint8_t cur = log->current;
+  uint32_t space = 0;
+
+  if (!log->full[cur]) {
+    space = 512 - log->fill;
+    if (!log->full[cur ^ 1]) space += 512;
+  }
+  if (nbyte > space ||
+    curPosition_ + nbyte > (log->endBlock - log->bgnBlock + 1) << 9) {
+    log->lost++;
+    return 0;
+  }
+  for (uint16_t n = nbyte; n > 0; ) {
+    uint16_t fill = log->fill;
+    uint16_t m = 512 - fill < n ? 512 - fill : n;
+    memcpy(log->buf[cur] + fill, src, m);
+    src += m;
+    n -= m;
+    curPosition_ += m;
+    if ((fill += m) == 512) {
+      log->full[cur] = 1;
+      cur ^= 1;
+      log->current = cur;
+      fill = 0;
+    }
+    log->fill = fill;
+  }
+  if (!log->deferred && !logDrain()) {
+    setWriteError();
+    return 0;
+  }
+  return nbyte;
+}
+//------------------------------------------------------------------------------
 /** List directory contents to Serial.
  *
  * \param[in] flags The inclusive OR of
@@ -311,10 +549,12 @@ uint8_t SdFile::makeDir(SdFile* dir, const char* dirName) {
 
   // cache block for '.'  and '..'
   uint32_t block = vol_->clusterStartBlock(firstCluster_);
-  if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_WRITE)) return false;
-
+  if (!SdVolume::cacheRawBlock(block,
+        SdVolume::CACHE_FOR_WRITE | SdVolume::CACHE_PRIORITY_DIR)) {
+    return false;
+  }
   // copy '.' to block
-  memcpy(&SdVolume::cacheBuffer_.dir[0], &d, sizeof(d));
+  memcpy(&SdVolume::cacheBuffer_->dir[0], &d, sizeof(d));
 
   // make entry for '..'
   d.name[1] = '.';
@@ -326,7 +566,7 @@ uint8_t SdFile::makeDir(SdFile* dir, const char* dirName) {
     d.firstClusterHigh = dir->firstCluster_ >> 16;
   }
   // copy '..' to block
-  memcpy(&SdVolume::cacheBuffer_.dir[1], &d, sizeof(d));
+  memcpy(&SdVolume::cacheBuffer_->dir[1], &d, sizeof(d));
 
   // set position after '..'
   curPosition_ = 2 * sizeof(d);
@@ -335,6 +575,69 @@ uint8_t SdFile::makeDir(SdFile* dir, const char* dirName) {
   return SdVolume::cacheFlush();
 }
 //------------------------------------------------------------------------------
+// Add cluster, the next of the file, to the end of the extent map.
+// Return false if it starts a new extent and the map is full.
+uint8_t SdFile::mapAdd(uint32_t cluster) {
+  if (mapCount_) {
+    fat_extent_t* e = &map_[mapCount_ - 1];
+    if (cluster == e->cluster + mapClusters_ - e->index) {
+      mapClusters_++;
+      return true;
+    }
+  }
+  if (mapCount_ == mapSize_) return false;
+  map_[mapCount_].index = mapClusters_++;
+  map_[mapCount_].cluster = cluster;
+  mapCount_++;
+  return true;
+}
+//------------------------------------------------------------------------------
+// Follow the cluster chain into the extent map, as far as the map has room
+uint8_t SdFile::mapBuild(void) {
+  mapCount_ = 0;
+  mapClusters_ = 0;
+  flags_ &= ~F_FILE_MAP_COMPLETE;
+  for (uint32_t c = firstCluster_; c != 0; ) {
+    // a full map covers the start of the file
+    if (!mapAdd(c)) return true;
+    if (!vol_->fatGet(c, &c)) return false;
+    if (vol_->isEOC(c)) break;
+  }
+  flags_ |= F_FILE_MAP_COMPLETE;
+  return true;
+}
+//------------------------------------------------------------------------------
+// Find cluster number index of the file with the extent map, following
+// the FAT from the end of the map if the map doesn't reach it
+uint8_t SdFile::mapCluster(uint32_t index, uint32_t* cluster) {
+  if (!mapCount_ && !(flags_ & F_FILE_MAP_COMPLETE)) {
+    if (!mapBuild()) return false;
+  }
+  if (index >= mapClusters_) {
+    if ((flags_ & F_FILE_MAP_COMPLETE) || mapCount_ == 0) return false;
+    fat_extent_t* e = &map_[mapCount_ - 1];
+    uint32_t c = e->cluster + mapClusters_ - 1 - e->index;
+    for (uint32_t n = index - mapClusters_ + 1; n; n--) {
+      if (!vol_->fatGet(c, &c)) return false;
+    }
+    *cluster = c;
+    return true;
+  }
+  // last entry with e->index <= index
+  uint16_t lo = 0;
+  uint16_t hi = mapCount_ - 1;
+  while (lo < hi) {
+    uint16_t mid = (lo + hi + 1) / 2;
+    if (map_[mid].index <= index) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  *cluster = map_[lo].cluster + index - map_[lo].index;
+  return true;
+}
+//------------------------------------------------------------------------------
 /**
  * Open a file or directory by name.
  *
@@ -406,7 +709,7 @@ uint8_t SdFile::open(SdFile* dirFile, const char* fileName, uint8_t oflag) {
       if (!emptyFound) {
         emptyFound = true;
         dirIndex_ = index;
-        dirBlock_ = SdVolume::cacheBlockNumber_;
+        dirBlock_ = SdVolume::cacheBlockNumber();
       }
       // done if no entries follow
       if (p->name[0] == DIR_NAME_FREE) break;
@@ -433,7 +736,7 @@ uint8_t SdFile::open(SdFile* dirFile, const char* fileName, uint8_t oflag) {
 
     // use first entry in cluster
     dirIndex_ = 0;
-    p = SdVolume::cacheBuffer_.dir;
+    p = SdVolume::cacheBuffer_->dir;
   }
   // initialize as empty file
   memset(p, 0, sizeof(dir_t));
@@ -501,7 +804,7 @@ uint8_t SdFile::open(SdFile* dirFile, uint16_t index, uint8_t oflag) {
 // open a cached directory entry. Assumes vol_ is initializes
 uint8_t SdFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   // location of entry in cache
-  dir_t* p = SdVolume::cacheBuffer_.dir + dirIndex;
+  dir_t* p = SdVolume::cacheBuffer_->dir + dirIndex;
 
   // write or truncate is an error for a directory or read-only file
   if (p->attributes & (DIR_ATT_READ_ONLY | DIR_ATT_DIRECTORY)) {
@@ -509,7 +812,7 @@ uint8_t SdFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   }
   // remember location of directory entry on SD
   dirIndex_ = dirIndex;
-  dirBlock_ = SdVolume::cacheBlockNumber_;
+  dirBlock_ = SdVolume::cacheBlockNumber();
 
   // copy first cluster number for directory fields
   firstCluster_ = (uint32_t)p->firstClusterHigh << 16;
@@ -532,6 +835,10 @@ uint8_t SdFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   curCluster_ = 0;
   curPosition_ = 0;
 
+  // no extent map until setExtentMap(), not a log until logBegin()
+  map_ = 0;
+  log_ = 0;
+
   // truncate file to zero length if requested
   if (oflag & O_TRUNC) return truncate(0);
   return true;
@@ -571,6 +878,10 @@ uint8_t SdFile::openRoot(SdVolume* vol) {
   curCluster_ = 0;
   curPosition_ = 0;
 
+  // no extent map until setExtentMap(), not a log
+  map_ = 0;
+  log_ = 0;
+
   // root has no directory entry
   dirBlock_ = 0;
   dirIndex_ = 0;
@@ -689,18 +1000,55 @@ int16_t SdFile::read(void* buf, uint16_t nbyte) {
     }
     uint16_t n = toRead;
 
+    // stream two or more whole blocks from contiguous clusters with one
+    // multiple block read rather than a command per block
+    if (offset == 0 && toRead >= 1024 && type_ != FAT_FILE_TYPE_ROOT16) {
+      uint16_t want = toRead >> 9;
+      uint8_t blockOfCluster = vol_->blockOfCluster(curPosition_);
+      uint32_t count = vol_->blocksPerCluster() - blockOfCluster;
+      uint32_t last = curCluster_;
+      while (count < want) {
+        uint32_t next;
+        if (!vol_->fatGet(last, &next)) return -1;
+        if (next != last + 1) break;
+        last = next;
+        count += vol_->blocksPerCluster();
+      }
+      if (count > want) count = want;
+      if (count > 1) {
+        // the card must have any changes to these blocks waiting in the cache
+        for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+          if (SdVolume::cacheBlockNumber_[i] - block < count) {
+            if (!SdVolume::cacheWriteBack(i)) return -1;
+          }
+        }
+
+        if (!vol_->readStart(block)) return -1;
+        for (uint16_t i = 0; i < count; i++, dst += 512) {
+          if (!vol_->readData(dst)) return -1;
+        }
+        if (!vol_->readStop()) return -1;
+        // leave curCluster_ on the cluster of the last block read
+        curCluster_ += (blockOfCluster + count - 1) >> vol_->clusterSizeShift();
+        curPosition_ += count << 9;
+        toRead -= count << 9;
+        continue;
+      }
+    }
+
     // amount to be read from current block
     if (n > (512 - offset)) n = 512 - offset;
 
     // no buffering needed if n == 512 or user requests no buffering
-    if ((unbufferedRead() || n == 512) &&
-      block != SdVolume::cacheBlockNumber_) {
+    if ((unbufferedRead() || n == 512) && SdVolume::cacheFind(block) < 0) {
       if (!vol_->readData(block, offset, n, dst)) return -1;
       dst += n;
     } else {
-      // read block to cache and copy data to caller
-      if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_READ)) return -1;
-      uint8_t* src = SdVolume::cacheBuffer_.data + offset;
+      // read block to cache and copy data to caller, directory blocks
+      // with their priority
+      uint8_t action = isDir() ? SdVolume::CACHE_PRIORITY_DIR : 0;
+      if (!SdVolume::cacheRawBlock(block, action)) return -1;
+      uint8_t* src = SdVolume::cacheBuffer_->data + offset;
       uint8_t* end = src + n;
       while (src != end) *dst++ = *src++;
     }
@@ -754,7 +1102,7 @@ dir_t* SdFile::readDirCache(void) {
   curPosition_ += 31;
 
   // return pointer to entry
-  return (SdVolume::cacheBuffer_.dir + i);
+  return (SdVolume::cacheBuffer_->dir + i);
 }
 //------------------------------------------------------------------------------
 /**
@@ -931,6 +1279,12 @@ uint8_t SdFile::seekSet(uint32_t pos) {
   uint32_t nCur = (curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9);
   uint32_t nNew = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
 
+  if (map_) {
+    // binary search of the extent map
+    if (!mapCluster(nNew, &curCluster_)) return false;
+    curPosition_ = pos;
+    return true;
+  }
   if (nNew < nCur || curPosition_ == 0) {
     // must follow chain from first cluster
     curCluster_ = firstCluster_;
@@ -945,6 +1299,35 @@ uint8_t SdFile::seekSet(uint32_t pos) {
   return true;
 }
 //------------------------------------------------------------------------------
+/**
+ * Give a file an extent map, a list of the runs of contiguous clusters
+ * it is made of, so seekSet() finds a cluster with a binary search of the
+ * map rather than by following the FAT from the start of the file.
+ *
+ * The map is built by the first seek that needs it.  If the file has more
+ * than \a size extents the map covers the first \a size and the FAT is
+ * followed from the end of the map for the rest.  Clusters added by write()
+ * are added to the map; truncate() has it built again.
+ *
+ * \param[in] map Space for the map, which must last until the file is
+ * closed.  Each entry takes 8 bytes.
+ *
+ * \param[in] size The number of entries in \a map.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ * Reasons for failure include the file is not open, is a FAT16 root
+ * directory or \a size is zero.
+ */
+uint8_t SdFile::setExtentMap(fat_extent_t* map, uint16_t size) {
+  if (!isOpen() || type_ == FAT_FILE_TYPE_ROOT16 || size == 0) return false;
+  map_ = map;
+  mapSize_ = size;
+  mapCount_ = 0;
+  flags_ &= ~F_FILE_MAP_COMPLETE;
+  return true;
+}
+//------------------------------------------------------------------------------
 /**
  * The sync() call causes all modified data and directory fields
  * to be written to the storage device.
@@ -958,6 +1341,8 @@ uint8_t SdFile::sync(void) {
   // only allow open files and directories
   if (!isOpen()) return false;
 
+  if (log_ && !logSync()) return false;
+
   if (flags_ & F_FILE_DIR_DIRTY) {
     dir_t* d = cacheDirEntry(SdVolume::CACHE_FOR_WRITE);
     if (!d) return false;
@@ -1096,6 +1481,10 @@ uint8_t SdFile::truncate(uint32_t length) {
   }
   fileSize_ = length;
 
+  // build the extent map again for the shorter chain
+  mapCount_ = 0;
+  flags_ &= ~F_FILE_MAP_COMPLETE;
+
   // need to update directory entry
   flags_ |= F_FILE_DIR_DIRTY;
 
@@ -1109,7 +1498,8 @@ uint8_t SdFile::truncate(uint32_t length) {
  * Write data to an open file.
  *
  * \note Data is moved to the cache but may not be written to the
- * storage device until sync() is called.
+ * storage device until sync() is called. After logBegin() it goes to
+ * the log buffers instead.
  *
  * \param[in] buf Pointer to the location of the data to be written.
  *
@@ -1131,6 +1521,9 @@ size_t SdFile::write(const void* buf, uint16_t nbyte) {
   // error if not a normal file or is read-only
   if (!isFile() || !(flags_ & O_WRITE)) goto writeErrorReturn;
 
+  // records for the log buffers
+  if (log_) return logWrite(src, nbyte);
+
   // seek to end of file if append flag
   if ((flags_ & O_APPEND) && curPosition_ != fileSize_) {
     if (!seekEnd()) goto writeErrorReturn;
@@ -1170,24 +1563,23 @@ size_t SdFile::write(const void* buf, uint16_t nbyte) {
     if (n == 512) {
       // full block - don't need to use cache
       // invalidate cache if block is in cache
-      if (SdVolume::cacheBlockNumber_ == block) {
-        SdVolume::cacheBlockNumber_ = 0XFFFFFFFF;
-      }
+      SdVolume::cacheInvalidate(block);
       if (!vol_->writeBlock(block, src)) goto writeErrorReturn;
       src += 512;
     } else {
       if (blockOffset == 0 && curPosition_ >= fileSize_) {
         // start of new block don't need to read into cache
-        if (!SdVolume::cacheFlush()) goto writeErrorReturn;
-        SdVolume::cacheBlockNumber_ = block;
-        SdVolume::cacheSetDirty();
+        if (!SdVolume::cacheRawBlock(block,
+              SdVolume::CACHE_RESERVE_FOR_WRITE)) {
+          goto writeErrorReturn;
+        }
       } else {
         // rewrite part of block
         if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_WRITE)) {
           goto writeErrorReturn;
         }
       }
-      uint8_t* dst = SdVolume::cacheBuffer_.data + blockOffset;
+      uint8_t* dst = SdVolume::cacheBuffer_->data + blockOffset;
       uint8_t* end = dst + n;
       while (dst != end) *dst++ = *src++;
     }
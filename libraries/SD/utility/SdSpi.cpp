@@ -0,0 +1,78 @@
+/* Arduino Sd2Card Library
+ * Copyright (C) 2009 by William Greiman
+ *
+ * This file is part of the Arduino Sd2Card Library
+ *
+ * This Library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Arduino Sd2Card Library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#if !defined(__AVR__)
+#include <SPI.h>
+#include "SdSpi.h"
+//------------------------------------------------------------------------------
+// The clock the SPI_CLOCK_DIVn settings divide: the CC3200 SPI library
+// divides its MAX_BITRATE, the others the CPU clock
+#if defined(MAX_BITRATE)
+#define SD_SPI_CLOCK MAX_BITRATE
+#else  // MAX_BITRATE
+#define SD_SPI_CLOCK F_CPU
+#endif  // MAX_BITRATE
+/** Fastest SCK an SD card takes in SPI mode */
+#define SD_SCK_MAX 25000000UL
+#ifdef SPI_CLOCK_DIV2
+// What each core takes for the divisors, register fields on some
+static const uint8_t sckDivider[] = {
+  SPI_CLOCK_DIV2, SPI_CLOCK_DIV4, SPI_CLOCK_DIV8, SPI_CLOCK_DIV16,
+  SPI_CLOCK_DIV32, SPI_CLOCK_DIV64, SPI_CLOCK_DIV128
+};
+#endif  // SPI_CLOCK_DIV2
+//------------------------------------------------------------------------------
+// SPI hooks for the Energia SPI library
+void sdSpiBegin(void) {
+  SPI.begin();
+  SPI.setBitOrder(MSBFIRST);
+  SPI.setDataMode(SPI_MODE0);
+  sdSpiSetSckRate(6);
+}
+//------------------------------------------------------------------------------
+void sdSpiSetSckRate(uint8_t sckRateID) {
+#ifdef SPI_CLOCK_DIV2
+  // slow down a rate the card can't take
+  while (sckRateID < 6 && ((unsigned long)SD_SPI_CLOCK >> (sckRateID + 1)) > SD_SCK_MAX) {
+    sckRateID++;
+  }
+  SPI.setClockDivider(sckDivider[sckRateID]);
+#endif  // SPI_CLOCK_DIV2
+}
+//------------------------------------------------------------------------------
+void sdSpiSend(uint8_t b) {
+  SPI.transfer(b);
+}
+//------------------------------------------------------------------------------
+uint8_t sdSpiRec(void) {
+  return SPI.transfer(0XFF);
+}
+//------------------------------------------------------------------------------
+void sdSpiSendBlock(const uint8_t* src, uint16_t n) {
+  for (uint16_t i = 0; i < n; i++) SPI.transfer(src[i]);
+}
+//------------------------------------------------------------------------------
+void sdSpiRecBlock(uint8_t* dst, uint16_t n) {
+  if (dst) {
+    for (uint16_t i = 0; i < n; i++) dst[i] = SPI.transfer(0XFF);
+  } else {
+    for (uint16_t i = 0; i < n; i++) SPI.transfer(0XFF);
+  }
+}
+#endif  // __AVR__
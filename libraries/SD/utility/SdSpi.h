@@ -0,0 +1,51 @@
+/* Arduino Sd2Card Library
+ * Copyright (C) 2009 by William Greiman
+ *
+ * This file is part of the Arduino Sd2Card Library
+ *
+ * This Library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Arduino Sd2Card Library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef SdSpi_h
+#define SdSpi_h
+/**
+ * \file
+ * SPI hooks for boards without the AVR SPI registers
+ *
+ * Sd2Card drives the SPI registers itself on AVR processors. Everywhere
+ * else it goes through these functions. SdSpi.cpp has them for the SPI
+ * library; a port with a faster way to move a block, a FIFO or DMA, can
+ * supply its own in place of that file. The block functions move the 512
+ * byte data blocks, so that is where the time goes.
+ */
+#include <Arduino.h>
+/** Set up the SPI port for the card, at a slow clock for initialization. */
+void sdSpiBegin(void);
+/**
+ * Set the SPI clock to F_CPU/pow(2, 1 + sckRateID), or the nearest the
+ * port can do below that, and no faster than the 25 MHz a card takes.
+ */
+void sdSpiSetSckRate(uint8_t sckRateID);
+/** Send a byte to the card. */
+void sdSpiSend(uint8_t b);
+/** Receive a byte from the card, sending 0XFF. */
+uint8_t sdSpiRec(void);
+/** Send n bytes to the card. */
+void sdSpiSendBlock(const uint8_t* src, uint16_t n);
+/**
+ * Receive n bytes from the card, sending 0XFF for each. A null dst
+ * skips them.
+ */
+void sdSpiRecBlock(uint8_t* dst, uint16_t n);
+#endif  // SdSpi_h
@@ -20,12 +20,26 @@
 #include <SdFat.h>
 //------------------------------------------------------------------------------
 // raw block cache
-// init cacheBlockNumber_to invalid SD block number
-uint32_t SdVolume::cacheBlockNumber_ = 0XFFFFFFFF;
-cache_t  SdVolume::cacheBuffer_;     // 512 byte cache for Sd2Card
+cache_t  SdVolume::cacheBlocks_[SD_CACHE_BLOCKS];  // 512 byte caches
+// block numbers are made invalid by init()
+uint32_t SdVolume::cacheBlockNumber_[SD_CACHE_BLOCKS];
+
+uint8_t  SdVolume::cacheStatus_[SD_CACHE_BLOCKS];  // all clean
+uint32_t SdVolume::cacheUsed_[SD_CACHE_BLOCKS];    // cacheClock_ at last use
+uint32_t SdVolume::cacheClock_ = 0;   // counts uses of cached blocks
+uint8_t  SdVolume::cacheCurrent_ = 0;  // index of block last cached
+cache_t* SdVolume::cacheBuffer_ = SdVolume::cacheBlocks_;  // block last cached
 Sd2Card* SdVolume::sdCard_;          // pointer to SD card object
-uint8_t  SdVolume::cacheDirty_ = 0;  // cacheFlush() will write block if true
-uint32_t SdVolume::cacheMirrorBlock_ = 0;  // mirror  block for second FAT
+#if SD_CACHE_BLOCKS > 1
+uint32_t SdVolume::cacheMirror_[CACHE_MIRROR_BLOCKS];
+uint8_t  SdVolume::cacheMirrorCount_ = 0;  // mirror FAT up to date
+#endif  // SD_CACHE_BLOCKS > 1
+uint32_t SdVolume::cacheMirrorOffset_ = 0;  // blocks from FAT to mirror FAT
+
+// uses of the cache a directory or FAT block counts as used after it was
+// when the least recently used block is chosen for eviction
+static uint8_t const CACHE_KEEP_DIR = 16;
+static uint8_t const CACHE_KEEP_FAT = 32;
 //------------------------------------------------------------------------------
 // find a contiguous group of clusters
 uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
@@ -96,43 +110,151 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t* curCluster) {
   return true;
 }
 //------------------------------------------------------------------------------
+// return the index of blockNumber in the cache or -1 if it isn't cached
+int8_t SdVolume::cacheFind(uint32_t blockNumber) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (cacheBlockNumber_[i] == blockNumber) return i;
+  }
+  return -1;
+}
+//------------------------------------------------------------------------------
+// Write all dirty blocks, then the changed FAT blocks to the mirror FAT.
+// The block last cached is still the current block on return.
 uint8_t SdVolume::cacheFlush(void) {
-  if (cacheDirty_) {
-    if (!sdCard_->writeBlock(cacheBlockNumber_, cacheBuffer_.data)) {
-      return false;
-    }
-    // mirror FAT tables
-    if (cacheMirrorBlock_) {
-      if (!sdCard_->writeBlock(cacheMirrorBlock_, cacheBuffer_.data)) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (!cacheWriteBack(i)) return false;
+  }
+#if SD_CACHE_BLOCKS > 1
+  if (cacheMirrorCount_ == 0) return true;
+
+  uint32_t current = cacheBlockNumber();
+  uint8_t priority = cacheStatus_[cacheCurrent_] & CACHE_PRIORITY_MASK;
+  for (uint8_t n = 0; n < cacheMirrorCount_; n++) {
+    uint32_t lba = cacheMirror_[n];
+    // read back a FAT block that has been evicted since it was written
+    int8_t i = cacheFind(lba);
+    if (i < 0) {
+      if (!cacheRawBlock(lba, CACHE_FOR_READ | CACHE_PRIORITY_FAT)) {
         return false;
       }
-      cacheMirrorBlock_ = 0;
+      i = cacheCurrent_;
+    }
+    if (!sdCard_->writeBlock(lba + cacheMirrorOffset_, cacheBlocks_[i].data)) {
+      return false;
     }
-    cacheDirty_ = 0;
   }
+  cacheMirrorCount_ = 0;
+  if (current == 0XFFFFFFFF) return true;
+  return cacheRawBlock(current, CACHE_FOR_READ | priority);
+#else  // SD_CACHE_BLOCKS > 1
   return true;
+#endif  // SD_CACHE_BLOCKS > 1
+}
+//------------------------------------------------------------------------------
+// drop all blocks from the cache without writing them
+void SdVolume::cacheInvalidate(void) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    cacheBlockNumber_[i] = 0XFFFFFFFF;
+    cacheStatus_[i] = 0;
+  }
+#if SD_CACHE_BLOCKS > 1
+  cacheMirrorCount_ = 0;
+#endif  // SD_CACHE_BLOCKS > 1
+}
+//------------------------------------------------------------------------------
+// drop blockNumber from the cache, it is about to be written directly
+void SdVolume::cacheInvalidate(uint32_t blockNumber) {
+  int8_t i = cacheFind(blockNumber);
+  if (i >= 0) {
+    cacheBlockNumber_[i] = 0XFFFFFFFF;
+    cacheStatus_[i] = 0;
+  }
 }
 //------------------------------------------------------------------------------
+// Make blockNumber the current block, reading it into the least recently
+// used cache block if it isn't cached.  Directory and FAT blocks count as
+// used later than they were so they outlast the data blocks between them.
 uint8_t SdVolume::cacheRawBlock(uint32_t blockNumber, uint8_t action) {
-  if (cacheBlockNumber_ != blockNumber) {
-    if (!cacheFlush()) return false;
-    if (!sdCard_->readBlock(blockNumber, cacheBuffer_.data)) return false;
-    cacheBlockNumber_ = blockNumber;
+  int8_t i = cacheFind(blockNumber);
+  if (i < 0) {
+    uint32_t oldest = 0;
+    i = 0;
+    for (uint8_t j = 0; j < SD_CACHE_BLOCKS; j++) {
+      if (cacheBlockNumber_[j] == 0XFFFFFFFF) {
+        i = j;
+        break;
+      }
+      uint32_t age = cacheClock_ - cacheUsed_[j];
+      uint8_t keep = 0;
+      if (cacheStatus_[j] & CACHE_PRIORITY_FAT) {
+        keep = CACHE_KEEP_FAT;
+      } else if (cacheStatus_[j] & CACHE_PRIORITY_DIR) {
+        keep = CACHE_KEEP_DIR;
+      }
+      age = age > keep ? age - keep : 0;
+      if (age >= oldest) {
+        oldest = age;
+        i = j;
+      }
+    }
+    if (!cacheWriteBack(i)) return false;
+    cacheBlockNumber_[i] = 0XFFFFFFFF;
+    if (!(action & CACHE_OPTION_NO_READ)) {
+      if (!sdCard_->readBlock(blockNumber, cacheBlocks_[i].data)) return false;
+    }
+    cacheBlockNumber_[i] = blockNumber;
+    cacheStatus_[i] = 0;
   }
-  cacheDirty_ |= action;
+  cacheStatus_[i] &= ~CACHE_PRIORITY_MASK;
+  cacheStatus_[i] |= action & (CACHE_FOR_WRITE | CACHE_PRIORITY_MASK);
+  cacheUsed_[i] = ++cacheClock_;
+  cacheCurrent_ = i;
+  cacheBuffer_ = &cacheBlocks_[i];
   return true;
 }
 //------------------------------------------------------------------------------
-// cache a zero block for blockNumber
-uint8_t SdVolume::cacheZeroBlock(uint32_t blockNumber) {
-  if (!cacheFlush()) return false;
+// Write a cache block to the card if it is dirty.  A FAT block's mirror is
+// left for cacheFlush() so a FAT block evicted many times between syncs
+// is only written to the mirror FAT once.  Only the blocks that changed
+// are listed, and once CACHE_MIRROR_BLOCKS are the mirror of any other
+// is written with it, as it always is with a single cache block, so a
+// sync never reads back more than that many.
+uint8_t SdVolume::cacheWriteBack(uint8_t index) {
+  if (cacheStatus_[index] & CACHE_FOR_WRITE) {
+    uint32_t lba = cacheBlockNumber_[index];
+    if (!sdCard_->writeBlock(lba, cacheBlocks_[index].data)) return false;
+    if (cacheStatus_[index] & CACHE_STATUS_MIRROR_FAT) {
+      uint8_t later = false;
+#if SD_CACHE_BLOCKS > 1
+      for (uint8_t n = 0; n < cacheMirrorCount_ && !later; n++) {
+        later = cacheMirror_[n] == lba;
+      }
+      if (!later && cacheMirrorCount_ < CACHE_MIRROR_BLOCKS) {
+        cacheMirror_[cacheMirrorCount_++] = lba;
+        later = true;
+      }
+#endif  // SD_CACHE_BLOCKS > 1
+      if (!later) {
+        lba += cacheMirrorOffset_;
+        if (!sdCard_->writeBlock(lba, cacheBlocks_[index].data)) return false;
+      }
+    }
 
-  // loop take less flash than memset(cacheBuffer_.data, 0, 512);
+    cacheStatus_[index] &= ~(CACHE_FOR_WRITE | CACHE_STATUS_MIRROR_FAT);
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+// cache a zero block for blockNumber in a new directory cluster
+uint8_t SdVolume::cacheZeroBlock(uint32_t blockNumber) {
+  if (!cacheRawBlock(blockNumber,
+                     CACHE_RESERVE_FOR_WRITE | CACHE_PRIORITY_DIR)) {
+    return false;
+  }
+  // loop take less flash than memset(cacheBuffer_->data, 0, 512);
   for (uint16_t i = 0; i < 512; i++) {
-    cacheBuffer_.data[i] = 0;
+    cacheBuffer_->data[i] = 0;
   }
-  cacheBlockNumber_ = blockNumber;
-  cacheSetDirty();
   return true;
 }
 //------------------------------------------------------------------------------
@@ -152,13 +274,11 @@ uint8_t SdVolume::fatGet(uint32_t cluster, uint32_t* value) const {
   if (cluster > (clusterCount_ + 1)) return false;
   uint32_t lba = fatStartBlock_;
   lba += fatType_ == 16 ? cluster >> 8 : cluster >> 7;
-  if (lba != cacheBlockNumber_) {
-    if (!cacheRawBlock(lba, CACHE_FOR_READ)) return false;
-  }
+  if (!cacheRawBlock(lba, CACHE_FOR_READ | CACHE_PRIORITY_FAT)) return false;
   if (fatType_ == 16) {
-    *value = cacheBuffer_.fat16[cluster & 0XFF];
+    *value = cacheBuffer_->fat16[cluster & 0XFF];
   } else {
-    *value = cacheBuffer_.fat32[cluster & 0X7F] & FAT32MASK;
+    *value = cacheBuffer_->fat32[cluster & 0X7F] & FAT32MASK;
   }
   return true;
 }
@@ -175,19 +295,19 @@ uint8_t SdVolume::fatPut(uint32_t cluster, uint32_t value) {
   uint32_t lba = fatStartBlock_;
   lba += fatType_ == 16 ? cluster >> 8 : cluster >> 7;
 
-  if (lba != cacheBlockNumber_) {
-    if (!cacheRawBlock(lba, CACHE_FOR_READ)) return false;
-  }
+  if (!cacheRawBlock(lba, CACHE_FOR_WRITE | CACHE_PRIORITY_FAT)) return false;
+
   // store entry
   if (fatType_ == 16) {
-    cacheBuffer_.fat16[cluster & 0XFF] = value;
+    cacheBuffer_->fat16[cluster & 0XFF] = value;
   } else {
-    cacheBuffer_.fat32[cluster & 0X7F] = value;
+    cacheBuffer_->fat32[cluster & 0X7F] = value;
+  }
+  // mirror second FAT when the block is flushed
+  if (fatCount_ > 1) {
+    cacheStatus_[cacheCurrent_] |= CACHE_STATUS_MIRROR_FAT;
+    cacheMirrorOffset_ = blocksPerFat_;
   }
-  cacheSetDirty();
-
-  // mirror second FAT
-  if (fatCount_ > 1) cacheMirrorBlock_ = lba + blocksPerFat_;
   return true;
 }
 //------------------------------------------------------------------------------
@@ -227,12 +347,14 @@ uint8_t SdVolume::freeChain(uint32_t cluster) {
 uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
   uint32_t volumeStartBlock = 0;
   sdCard_ = dev;
+  // the card may have been changed, so nothing in the cache is kept
+  cacheInvalidate();
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
   if (part) {
     if (part > 4)return false;
     if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) return false;
-    part_t* p = &cacheBuffer_.mbr.part[part-1];
+    part_t* p = &cacheBuffer_->mbr.part[part-1];
     if ((p->boot & 0X7F) !=0  ||
       p->totalSectors < 100 ||
       p->firstSector == 0) {
@@ -242,7 +364,8 @@ uint8_t SdVolume::init(Sd2Card* dev, uint8_t part) {
     volumeStartBlock = p->firstSector;
   }
   if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) return false;
-  bpb_t* bpb = &cacheBuffer_.fbs.bpb;
+  bpb_t* bpb = &cacheBuffer_->fbs.bpb;
+
   if (bpb->bytesPerSector != 512 ||
     bpb->fatCount == 0 ||
     bpb->reservedSectorCount == 0 ||
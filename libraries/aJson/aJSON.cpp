@@ -31,6 +31,7 @@
  * Includes
  ******************************************************************************/
 
+#include <stddef.h>
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
@@ -53,6 +54,48 @@
 //how much digits after . for float
 #define FLOAT_PRECISION 5
 
+//alignment of nodes in an arena: the padding the compiler puts in front
+//of an aJsonObject that follows a char
+struct aJsonArenaAlign
+{
+  char c;
+  aJsonObject item;
+};
+#define ARENA_ALIGN offsetof(aJsonArenaAlign, item)
+
+//the index of an array or object parsed into an arena, which has to do
+//without: there is nothing to free an index with when the arena is reset
+#define NO_INDEX ((aJsonIndex*) 1)
+
+//lookup index of an array or object: its items in order, and for objects
+//a hash table of their names after that, holding 1 + the item number, 0
+//for a free slot
+struct aJsonIndex
+{
+  aJsonObject *first; //the child list the index was built for
+  unsigned int size;
+  unsigned int mask; //hash table slots - 1, objects only
+  aJsonObject *item[1];
+};
+#define INDEX_SLOTS(index) ((unsigned short*) &(index)->item[(index)->size])
+
+void*
+aJsonArena::allocate(size_t size, size_t align)
+{
+  //align the address, the caller's buffer may start anywhere
+  size_t start = top + (-(size_t) (buffer + top) & (align - 1));
+  if (start > capacity || size > capacity - start)
+    {
+      return NULL;
+    }
+  top = start + size;
+  if (top > high)
+    {
+      high = top;
+    }
+  return buffer + start;
+}
+
 
 bool
 aJsonStream::available()
@@ -185,6 +228,21 @@ aJsonClass::newItem()
   return node;
 }
 
+// Nodes of a tree parsed into an arena are carved out of it.
+aJsonObject*
+aJsonStream::newItem()
+{
+  if (arena == NULL)
+    {
+      return aJsonClass::newItem();
+    }
+  aJsonObject* node = (aJsonObject*) arena->allocate(sizeof(aJsonObject),
+      ARENA_ALIGN);
+  if (node)
+    memset(node, 0, sizeof(aJsonObject));
+  return node;
+}
+
 // Delete a aJsonObject structure.
 void
 aJsonClass::deleteItem(aJsonObject *c)
@@ -201,6 +259,11 @@ aJsonClass::deleteItem(aJsonObject *c)
         {
           free(c->valuestring);
         }
+      if ((c->type & ~aJson_IsReference) == aJson_Array
+          || (c->type & ~aJson_IsReference) == aJson_Object)
+        {
+          dropIndex(c);
+        }
       if (c->name)
         {
           free(c->name);
@@ -354,7 +417,20 @@ aJsonStream::parseString(aJsonObject *item)
     }
   item->type = aJson_String;
   //allocate a buffer & track how long it is and how much we have read
-  string_buffer* buffer = stringBufferCreate();
+  //in an arena the string is decoded in place at its free end
+  string_buffer arena_buffer;
+  string_buffer* buffer;
+  if (arena)
+    {
+      buffer = &arena_buffer;
+      buffer->string = arena->buffer + arena->top;
+      buffer->memory = arena->capacity - arena->top;
+      buffer->string_length = 0;
+    }
+  else
+    {
+      buffer = stringBufferCreate();
+    }
   if (buffer == NULL)
     {
       //unable to allocate the string
@@ -363,7 +439,8 @@ aJsonStream::parseString(aJsonObject *item)
   in = this->getch();
   if (in == EOF)
     {
-      stringBufferFree(buffer);
+      if (!arena)
+        stringBufferFree(buffer);
       return EOF;
     }
   while (in != EOF)
@@ -379,7 +456,8 @@ aJsonStream::parseString(aJsonObject *item)
               in = this->getch();
               if (in == EOF)
                 {
-                  stringBufferFree(buffer);
+                  if (!arena)
+                    stringBufferFree(buffer);
                   return EOF;
                 }
               switch (in)
@@ -416,11 +494,24 @@ aJsonStream::parseString(aJsonObject *item)
           in = this->getch();
           if (in == EOF)
             {
-              stringBufferFree(buffer);
+              if (!arena)
+                stringBufferFree(buffer);
               return EOF;
             }
         }
       //the string ends here
+      if (arena)
+        {
+          //a full arena drops characters, and the 0 needs a byte too
+          if (buffer->string_length >= buffer->memory)
+            {
+              return EOF;
+            }
+          buffer->string[buffer->string_length] = 0;
+          item->valuestring = (char*) arena->allocate(
+              buffer->string_length + 1, 1);
+          return 0;
+        }
       item->valuestring = stringBufferToString(buffer);
       return 0;
     }
@@ -546,19 +637,404 @@ aJsonClass::parse(aJsonStream* stream, char** filter)
     {
       return NULL;
     }
-  aJsonObject *c = newItem();
+  aJsonObject *c = stream->newItem();
   if (!c)
     return NULL; /* memory fail */
 
   stream->skip();
   if (stream->parseValue(c, filter) == EOF)
     {
-      deleteItem(c);
+      //a failed parse into an arena is undone by the caller
+      if (stream->arena == NULL)
+        deleteItem(c);
       return NULL;
     }
   return c;
 }
 
+// Parse an object into an arena - the heap is never touched.
+aJsonObject*
+aJsonClass::parse(char *value, aJsonArena& arena)
+{
+  aJsonStringStream stringStream(value, NULL);
+  return parse(&stringStream, arena);
+}
+
+// Parse an object into an arena - the heap is never touched.
+aJsonObject*
+aJsonClass::parse(aJsonStream* stream, aJsonArena& arena, char** filter)
+{
+  if (stream == NULL)
+    {
+      return NULL;
+    }
+  //on failure give back whatever the partial tree took
+  size_t mark = arena.top;
+  stream->arena = &arena;
+  aJsonObject *c = parse(stream, filter);
+  stream->arena = NULL;
+  if (c == NULL)
+    {
+      arena.top = mark;
+    }
+  return c;
+}
+
+// States of the pull parser
+enum
+{
+  PULL_VALUE, // a value comes next
+  PULL_FIRST, // the first member of an object or array, or its end
+  PULL_NEXT, // a comma and the next member, or the end
+  PULL_END, // the top level value is complete
+  PULL_ERROR
+};
+
+aJsonPullParser::aJsonPullParser(aJsonStream *stream_) :
+  stream(stream_), state(PULL_VALUE), depth(0), arrays(0), cut(0), path_len(0)
+{
+  memset(&item, 0, sizeof(item));
+  path_buf[0] = 0;
+  text[0] = 0;
+}
+
+// The next character that is not white space
+int
+aJsonPullParser::nextChar()
+{
+  int in;
+  do
+    {
+      in = stream->getch();
+    }
+  while (in != EOF && in <= 32);
+  return in;
+}
+
+// Decode a string into text, the opening quote already read. Returns EOF
+// if it is malformed, 1 if it had to be cut short to fit, otherwise 0.
+int
+aJsonPullParser::readString()
+{
+  unsigned int len = 0;
+  bool full = false;
+  int in;
+  while ((in = stream->getch()) != '\"')
+    {
+      //one character, up to three bytes of UTF-8
+      char bytes[3];
+      int n = 1;
+      if (in == EOF)
+        {
+          return EOF;
+        }
+      bytes[0] = in;
+      if (in == '\\')
+        {
+          in = stream->getch();
+          switch (in)
+            {
+          case EOF:
+            return EOF;
+          case 'b':
+            bytes[0] = '\b';
+            break;
+          case 'f':
+            bytes[0] = '\f';
+            break;
+          case 'n':
+            bytes[0] = '\n';
+            break;
+          case 'r':
+            bytes[0] = '\r';
+            break;
+          case 't':
+            bytes[0] = '\t';
+            break;
+          case 'u':
+            {
+              unsigned int code = 0;
+              for (int i = 0; i < 4; i++)
+                {
+                  int digit = stream->getch();
+                  if (digit >= '0' && digit <= '9')
+                    digit -= '0';
+                  else if ((digit | 0x20) >= 'a' && (digit | 0x20) <= 'f')
+                    digit = (digit | 0x20) - 'a' + 10;
+                  else
+                    return EOF;
+                  code = (code << 4) | digit;
+                }
+              if (code < 0x80)
+                {
+                  bytes[0] = code;
+                }
+              else if (code < 0x800)
+                {
+                  bytes[0] = 0xc0 | (code >> 6);
+                  bytes[1] = 0x80 | (code & 0x3f);
+                  n = 2;
+                }
+              else
+                {
+                  bytes[0] = 0xe0 | (code >> 12);
+                  bytes[1] = 0x80 | ((code >> 6) & 0x3f);
+                  bytes[2] = 0x80 | (code & 0x3f);
+                  n = 3;
+                }
+              break;
+            }
+          default:
+            //\\, \" and \/, and whatever we do not understand
+            bytes[0] = in;
+            break;
+            }
+        }
+      //keep whole characters only
+      if (full || len + n >= sizeof(text))
+        {
+          full = true;
+          continue;
+        }
+      memcpy(text + len, bytes, n);
+      len += n;
+    }
+  text[len] = 0;
+  return full ? 1 : 0;
+}
+
+// Open an object or array
+bool
+aJsonPullParser::push(bool array)
+{
+  if (depth == aJson_MAX_DEPTH)
+    {
+      return false;
+    }
+  level[depth] = path_len;
+  count[depth] = 0;
+  if (array)
+    arrays |= 1UL << depth;
+  else
+    arrays &= ~(1UL << depth);
+  depth++;
+  return true;
+}
+
+// Close the innermost object or array with ch, if it matches
+int
+aJsonPullParser::pop(int ch)
+{
+  bool array = (arrays >> (depth - 1)) & 1;
+  if (ch != (array ? ']' : '}'))
+    {
+      return aJson_Error;
+    }
+  depth--;
+  //back to the path of the object or array itself
+  path_len = level[depth];
+  path_buf[path_len] = 0;
+  if (cut > depth)
+    {
+      cut = 0;
+    }
+  return array ? aJson_EndArray : aJson_EndObject;
+}
+
+// Point the path at the next member of the innermost object or array:
+// [n] for arrays, the key in text for objects
+void
+aJsonPullParser::member(bool whole)
+{
+  if (cut && cut < depth)
+    {
+      return; //the path is cut further out already
+    }
+  unsigned int len = level[depth - 1];
+  char number[14];
+  const char *segment = text;
+  if ((arrays >> (depth - 1)) & 1)
+    {
+      char *digits = number + sizeof(number);
+      unsigned long n = count[depth - 1];
+      *--digits = 0;
+      *--digits = ']';
+      do
+        {
+          *--digits = '0' + n % 10;
+          n /= 10;
+        }
+      while (n);
+      *--digits = '[';
+      segment = digits;
+    }
+  else if (len > 0)
+    {
+      path_buf[len++] = '.';
+    }
+  size_t n = strlen(segment);
+  if (!whole || len + n >= sizeof(path_buf))
+    {
+      cut = depth;
+      path_len = level[depth - 1];
+      path_buf[path_len] = 0;
+      return;
+    }
+  memcpy(path_buf + len, segment, n + 1);
+  path_len = len + n;
+  cut = 0;
+}
+
+int
+aJsonPullParser::next()
+{
+  int in, event;
+  for (;;)
+    {
+      switch (state)
+        {
+      case PULL_VALUE:
+        in = nextChar();
+        if (in == '{' || in == '[')
+          {
+            if (!push(in == '['))
+              {
+                break;
+              }
+            state = PULL_FIRST;
+            return in == '[' ? aJson_StartArray : aJson_StartObject;
+          }
+        if (in == '\"')
+          {
+            if (readString() == EOF)
+              {
+                break;
+              }
+            item.type = aJson_String;
+            item.valuestring = text;
+          }
+        else
+          {
+            if (in == EOF)
+              {
+                break;
+              }
+            //numbers, true, false and null as the tree parser reads them
+            stream->ungetch(in);
+            if (stream->parseValue(&item, NULL) == EOF)
+              {
+                break;
+              }
+          }
+        state = depth ? PULL_NEXT : PULL_END;
+        return aJson_Value;
+
+      case PULL_FIRST:
+      case PULL_NEXT:
+        in = nextChar();
+        if (in == ']' || in == '}')
+          {
+            event = pop(in);
+            if (event == aJson_Error)
+              {
+                break;
+              }
+            state = depth ? PULL_NEXT : PULL_END;
+            return event;
+          }
+        if (state == PULL_NEXT)
+          {
+            if (in != ',')
+              {
+                break;
+              }
+            count[depth - 1]++;
+            in = nextChar();
+          }
+        state = PULL_VALUE;
+        if ((arrays >> (depth - 1)) & 1)
+          {
+            //array elements have no key, go on to the value
+            stream->ungetch(in);
+            member(true);
+            continue;
+          }
+        if (in != '\"' || (event = readString()) == EOF || nextChar() != ':')
+          {
+            break;
+          }
+        member(event == 0);
+        return aJson_Key;
+
+      case PULL_END:
+        return aJson_End;
+        }
+      //malformed, or nested too deep
+      state = PULL_ERROR;
+      return aJson_Error;
+    }
+}
+
+int
+aJsonPullParser::parse(aJsonEventCallback callback, void *context)
+{
+  int event;
+  while ((event = next()) > aJson_End)
+    {
+      callback(this, event, context);
+    }
+  return event;
+}
+
+bool
+aJsonPullParser::complete()
+{
+  return state == PULL_END;
+}
+
+const char*
+aJsonPullParser::path()
+{
+  return cut ? NULL : path_buf;
+}
+
+// Compare a path with a pattern in which * stands for any run of
+// characters within one key or index
+static bool
+matchPath(const char *pattern, const char *path)
+{
+  while (*pattern)
+    {
+      if (*pattern == '*')
+        {
+          pattern++;
+          for (;;)
+            {
+              if (matchPath(pattern, path))
+                {
+                  return true;
+                }
+              if (*path == 0 || *path == '.' || *path == '[' || *path == ']')
+                {
+                  return false;
+                }
+              path++;
+            }
+        }
+      if (*pattern++ != *path++)
+        {
+          return false;
+        }
+    }
+  return *path == 0;
+}
+
+bool
+aJsonPullParser::matches(const char *pattern)
+{
+  return !cut && matchPath(pattern, path_buf);
+}
+
 // Render a aJsonObject item/entity/structure to text.
 int
 aJsonClass::print(aJsonObject* item, aJsonStream* stream)
@@ -717,6 +1193,10 @@ aJsonStream::parseArray(aJsonObject *item, char** filter)
     }
 
   item->type = aJson_Array;
+  if (arena)
+    {
+      item->index = NO_INDEX;
+    }
   this->skip();
   in = this->getch();
   //check for empty array
@@ -730,7 +1210,7 @@ aJsonStream::parseArray(aJsonObject *item, char** filter)
   char first = -1;
   while ((first) || (in == ','))
     {
-      aJsonObject *new_item = aJsonClass::newItem();
+      aJsonObject *new_item = this->newItem();
       if (new_item == NULL)
         {
           return EOF; // memory fail
@@ -811,6 +1291,10 @@ aJsonStream::parseObject(aJsonObject *item, char** filter)
     }
 
   item->type = aJson_Object;
+  if (arena)
+    {
+      item->index = NO_INDEX;
+    }
   this->skip();
   //check for an empty object
   in = this->getch();
@@ -825,7 +1309,7 @@ aJsonStream::parseObject(aJsonObject *item, char** filter)
   char first = -1;
   while ((first) || (in == ','))
     {
-      aJsonObject* new_item = aJsonClass::newItem();
+      aJsonObject* new_item = this->newItem();
       if (new_item == NULL)
         {
           return EOF; // memory fail
@@ -920,32 +1404,167 @@ aJsonStream::printObject(aJsonObject *item)
 }
 
 // Get Array size/item / object item.
-unsigned char
+unsigned int
 aJsonClass::getArraySize(aJsonObject *array)
 {
+  aJsonIndex *index = findIndex(array);
+  if (index)
+    return index->size;
   aJsonObject *c = array->child;
-  unsigned char i = 0;
+  unsigned int i = 0;
   while (c)
     i++, c = c->next;
   return i;
 }
 aJsonObject*
-aJsonClass::getArrayItem(aJsonObject *array, unsigned char item)
+aJsonClass::getArrayItem(aJsonObject *array, unsigned int item)
+{
+  return findItem(array, item, true);
+}
+// Use an index if the array has one, or if build, make one if it is worth it.
+aJsonObject*
+aJsonClass::findItem(aJsonObject *array, unsigned int item, bool build)
 {
+  aJsonIndex *index = findIndex(array);
+  if (!index && build && item >= aJson_INDEX_MIN && aJson_INDEX_MIN)
+    index = buildIndex(array);
+  if (index)
+    return item < index->size ? index->item[item] : NULL;
   aJsonObject *c = array->child;
   while (c && item > 0)
     item--, c = c->next;
   return c;
 }
+
+// Case insensitive, as the names are compared with strcasecmp().
+static unsigned int
+hashName(const char *name)
+{
+  unsigned int hash = 2166136261u;
+  while (*name)
+    hash = (hash ^ (unsigned char) tolower(*name++)) * 16777619u;
+  return hash;
+}
+
 aJsonObject*
 aJsonClass::getObjectItem(aJsonObject *object, const char *string)
 {
+  return findItem(object, string, true);
+}
+aJsonObject*
+aJsonClass::findItem(aJsonObject *object, const char *string, bool build)
+{
+  aJsonIndex *index = findIndex(object);
+  if (index && index->mask)
+    {
+      unsigned short *slot = INDEX_SLOTS(index);
+      unsigned int h = hashName(string) & index->mask;
+      for (; slot[h]; h = (h + 1) & index->mask)
+        {
+          aJsonObject *c = index->item[slot[h] - 1];
+          if (!strcasecmp(c->name, string))
+            return c;
+        }
+      return NULL;
+    }
   aJsonObject *c = object->child;
+  unsigned int i = 0;
   while (c && strcasecmp(c->name, string))
-    c = c->next;
+    i++, c = c->next;
+  if (!index && build && i >= aJson_INDEX_MIN && aJson_INDEX_MIN)
+    buildIndex(object);
   return c;
 }
 
+// The index of an array or object, NULL if it has none or the one it had
+// is out of date. Only the ends of the list are checked, the first item
+// and the last one's next; a change by hand in between needs dropIndex().
+aJsonIndex*
+aJsonClass::findIndex(aJsonObject *container)
+{
+  if (container->type != aJson_Array && container->type != aJson_Object)
+    return NULL;
+  aJsonIndex *index = container->index;
+  if (!index || index == NO_INDEX)
+    return NULL;
+  if (index->first != container->child || index->item[index->size - 1]->next)
+    {
+      dropIndex(container);
+      return NULL;
+    }
+  return index;
+}
+
+// Index an array or object that has aJson_INDEX_MIN items or more. An
+// object with more than 65534 items, or one that there is no memory for,
+// is searched as before.
+aJsonIndex*
+aJsonClass::buildIndex(aJsonObject *container)
+{
+  if (container->type != aJson_Array && container->type != aJson_Object)
+    return NULL;
+  if (container->index == NO_INDEX || !aJson_INDEX_MIN)
+    return NULL;
+  unsigned int size = 0;
+  aJsonObject *c;
+  for (c = container->child; c; c = c->next)
+    size++;
+  if (size < aJson_INDEX_MIN)
+    return NULL;
+  unsigned int slots = 0;
+  if (container->type == aJson_Object)
+    {
+      if (size > 65534)
+        return NULL;
+      // at most half full
+      for (slots = 4; slots < 2 * size; slots *= 2)
+        ;
+    }
+  dropIndex(container);
+  aJsonIndex *index = (aJsonIndex*) malloc(sizeof(aJsonIndex) + (size - 1)
+      * sizeof(aJsonObject*) + slots * sizeof(unsigned short));
+  if (!index)
+    return NULL;
+  index->first = container->child;
+  index->size = size;
+  index->mask = slots ? slots - 1 : 0;
+  unsigned int i = 0;
+  for (c = container->child; c; c = c->next)
+    index->item[i++] = c;
+  if (slots)
+    {
+      unsigned short *slot = INDEX_SLOTS(index);
+      memset(slot, 0, slots * sizeof(unsigned short));
+      for (i = 0; i < size; i++)
+        {
+          c = index->item[i];
+          if (!c->name)
+            continue;
+          // the first of several items with the same name is the one found
+          unsigned int h = hashName(c->name) & index->mask;
+          while (slot[h] && strcasecmp(index->item[slot[h] - 1]->name, c->name))
+            h = (h + 1) & index->mask;
+          if (!slot[h])
+            slot[h] = i + 1;
+        }
+    }
+  container->index = index;
+  return index;
+}
+
+void
+aJsonClass::dropIndex(aJsonObject *container)
+{
+  if ((container->type & ~aJson_IsReference) != aJson_Array
+      && (container->type & ~aJson_IsReference) != aJson_Object)
+    return;
+  if (container->index && container->index != NO_INDEX)
+    {
+      free(container->index);
+      container->index = NULL;
+    }
+}
+
 // Utility for array list handling.
 void
 aJsonClass::suffixObject(aJsonObject *prev, aJsonObject *item)
@@ -961,6 +1580,9 @@ aJsonClass::createReference(aJsonObject *item)
   if (!ref)
     return 0;
   memcpy(ref, item, sizeof(aJsonObject));
+  if ((ref->type == aJson_Array || ref->type == aJson_Object)
+      && ref->index != NO_INDEX)
+    ref->index = 0;
   ref->name = 0;
   ref->type |= aJson_IsReference;
   ref->next = ref->prev = 0;
@@ -980,9 +1602,13 @@ aJsonClass::addItemToArray(aJsonObject *array, aJsonObject *item)
     }
   else
     {
+      aJsonIndex *index = findIndex(array);
+      if (index)
+        c = index->item[index->size - 1];
       while (c && c->next)
         c = c->next;
       suffixObject(c, item);
+      dropIndex(array);
     }
 }
 void
@@ -1009,13 +1635,17 @@ aJsonClass::addItemReferenceToObject(aJsonObject *object, const char *string,
 }
 
 aJsonObject*
-aJsonClass::detachItemFromArray(aJsonObject *array, unsigned char which)
+aJsonClass::detachItemFromArray(aJsonObject *array, unsigned int which)
+{
+  return detachItem(array, findItem(array, which, false));
+}
+// Unlink item c, if any, from array/object.
+aJsonObject*
+aJsonClass::detachItem(aJsonObject *array, aJsonObject *c)
 {
-  aJsonObject *c = array->child;
-  while (c && which > 0)
-    c = c->next, which--;
   if (!c)
     return 0;
+  dropIndex(array);
   if (c->prev)
     c->prev->next = c->next;
   if (c->next)
@@ -1026,20 +1656,14 @@ aJsonClass::detachItemFromArray(aJsonObject *array, unsigned char which)
   return c;
 }
 void
-aJsonClass::deleteItemFromArray(aJsonObject *array, unsigned char which)
+aJsonClass::deleteItemFromArray(aJsonObject *array, unsigned int which)
 {
   deleteItem(detachItemFromArray(array, which));
 }
 aJsonObject*
 aJsonClass::detachItemFromObject(aJsonObject *object, const char *string)
 {
-  unsigned char i = 0;
-  aJsonObject *c = object->child;
-  while (c && strcasecmp(c->name, string))
-    i++, c = c->next;
-  if (c)
-    return detachItemFromArray(object, i);
-  return 0;
+  return detachItem(object, findItem(object, string, false));
 }
 void
 aJsonClass::deleteItemFromObject(aJsonObject *object, const char *string)
@@ -1049,14 +1673,19 @@ aJsonClass::deleteItemFromObject(aJsonObject *object, const char *string)
 
 // Replace array/object items with new ones.
 void
-aJsonClass::replaceItemInArray(aJsonObject *array, unsigned char which,
+aJsonClass::replaceItemInArray(aJsonObject *array, unsigned int which,
+    aJsonObject *newitem)
+{
+  replaceItem(array, findItem(array, which, false), newitem);
+}
+// Put newitem in the place of item c, if any, and delete c.
+void
+aJsonClass::replaceItem(aJsonObject *array, aJsonObject *c,
     aJsonObject *newitem)
 {
-  aJsonObject *c = array->child;
-  while (c && which > 0)
-    c = c->next, which--;
   if (!c)
     return;
+  dropIndex(array);
   newitem->next = c->next;
   newitem->prev = c->prev;
   if (newitem->next)
@@ -1072,14 +1701,11 @@ void
 aJsonClass::replaceItemInObject(aJsonObject *object, const char *string,
     aJsonObject *newitem)
 {
-  unsigned char i = 0;
-  aJsonObject *c = object->child;
-  while (c && strcasecmp(c->name, string))
-    i++, c = c->next;
+  aJsonObject *c = findItem(object, string, false);
   if (c)
     {
       newitem->name = strdup(string);
-      replaceItemInArray(object, i, newitem);
+      replaceItem(object, c, newitem);
     }
 }
 